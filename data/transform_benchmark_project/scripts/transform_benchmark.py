@@ -0,0 +1,79 @@
+# -*- coding: utf-8 -*-
+
+# Compares animating scene nodes one property access at a time against
+# updating them through a TransformGroup buffer with numpy.
+# Runs FRAMES frames of both and prints the average script time per frame.
+
+import math
+import time
+
+N_NODES = 2000
+FRAMES = 500
+
+camera = game.scene.createSceneNode("camera")
+camera.position = Vector3(0, 20, 80)
+cam = game.scene.createCamera("camera")
+camera.attachObject(cam)
+game.player.camera = "camera"
+
+game.mesh_manager.createCube("benchmark_cube")
+
+nodes = []
+for i in range(N_NODES):
+	node = game.scene.createSceneNode("benchmark_node_%d" % i)
+	node.attachObject(game.scene.createEntity("benchmark_ent_%d" % i, "benchmark_cube", True))
+	node.position = Vector3((i % 50)*1.5 - 37, 0, -(i // 50)*1.5)
+	nodes.append(node)
+
+group = TransformGroup()
+for node in nodes :
+	group.add(node)
+
+try :
+	import numpy
+except ImportError :
+	numpy = None
+	print("transform_benchmark : numpy not found, only running per node updates.")
+
+class TransformBenchmark :
+	def __init__(self) :
+		self.frame = 0
+		self.per_node_time = 0.0
+		self.bulk_time = 0.0
+		self.rows = None
+		if numpy :
+			self.rows = numpy.asarray(group)
+			self.base_y = self.rows[:, 1].copy()
+			self.phase = numpy.arange(len(group))*0.1
+
+	def per_node(self, t) :
+		for i, node in enumerate(nodes) :
+			p = node.position
+			node.position = Vector3(p.x, math.sin(t + i*0.1), p.z)
+
+	def bulk(self, t) :
+		group.read()
+		self.rows[:, 1] = self.base_y + numpy.sin(t + self.phase)
+		group.write()
+
+	def progress(self, t) :
+		if self.frame > 2*FRAMES :
+			return
+
+		start = time.time()
+		if self.frame < FRAMES :
+			self.per_node(self.frame*0.05)
+			self.per_node_time += time.time() - start
+		elif self.rows is not None and self.frame < 2*FRAMES :
+			self.bulk(self.frame*0.05)
+			self.bulk_time += time.time() - start
+
+		self.frame += 1
+		if self.frame == 2*FRAMES :
+			print("transform_benchmark : %d nodes" % N_NODES)
+			print("Per node update : %.3f ms/frame" % (self.per_node_time/FRAMES*1000))
+			if self.rows is not None :
+				print("TransformGroup update : %.3f ms/frame" % (self.bulk_time/FRAMES*1000))
+
+benchmark = TransformBenchmark()
+game.event_manager.frame_trigger.add_listener(benchmark.progress)
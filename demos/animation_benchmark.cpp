@@ -0,0 +1,260 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file animation_benchmark.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Microbenchmark for the kinematic animation graph update.
+ *
+ *	Builds a machine model the same way KinematicWorld does, every body
+ *	is a Node connected to it's parent with a Link, and animates
+ *	a fraction of the links every frame like the constraints do.
+ *
+ *	Compares the forward pass over the transformation storage
+ *	(Graph::_update) against a recursive traversal through the Node and
+ *	Link pointers that calculates the same world transformations, which
+ *	is how the graph used to be updated. Also times copying the cached
+ *	world transformations out like KinematicWorld::step does.
+ *
+ *	Links can be split into independent machines which are animated and
+ *	updated in parallel the same way KinematicWorld steps it's islands.
+ *	The same model is run serially and in parallel and the results are
+ *	checked to be identical.
+ *
+ *	Example, 10k links in 16 machines
+ *	animation_benchmark --links 10000 --branching 2 --machines 16
+ */
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <vector>
+
+#include "animation/animation.hpp"
+
+#include "base/chrono.hpp"
+#include "base/report.hpp"
+#include "base/thread_pool.hpp"
+
+#include <boost/bind.hpp>
+
+namespace po = boost::program_options;
+
+namespace
+{
+
+/// Reference implementation, walks the graph through the shared pointers
+void
+recursive_update(vl::animation::NodeRefPtr node, vl::Transform const &parent_t,
+	std::vector<vl::Transform> &out)
+{
+	vl::Transform wt = parent_t*node->getTransform();
+	out.push_back(wt);
+
+	for(size_t i = 0; i < node->getNChildren(); ++i)
+	{
+		vl::animation::LinkRefPtr link = node->getChild(i);
+		vl::animation::NodeRefPtr child = link->getChild();
+		if(child)
+		{ recursive_update(child, wt*link->getTransform(), out); }
+	}
+}
+
+struct Model
+{
+	vl::animation::GraphRefPtr graph;
+	std::vector<vl::animation::NodeRefPtr> nodes;
+	/// Links of every machine
+	std::vector< std::vector<vl::animation::LinkRefPtr> > machines;
+};
+
+/// Every machine is a breadth first tree of links under the graph root.
+/// Links are offset from their parent and rotated by the animation.
+void
+build_model(Model &model, size_t n_links, size_t branching, size_t n_machines)
+{
+	model.graph.reset(new vl::animation::Graph);
+	model.nodes.push_back(model.graph->getRoot());
+	model.machines.resize(n_machines);
+	for(size_t m = 0; m < n_machines; ++m)
+	{
+		size_t n = n_links/n_machines + (m < n_links%n_machines ? 1 : 0);
+		std::vector<vl::animation::NodeRefPtr> nodes;
+		nodes.push_back(model.graph->getRoot());
+		for(size_t i = 0; i < n; ++i)
+		{
+			vl::animation::NodeRefPtr parent = nodes.at(i == 0 ? 0 : (i-1)/branching + 1);
+			vl::animation::LinkRefPtr link = model.graph->createLink(
+				vl::Transform(Ogre::Vector3(0.1*(i%branching) + m, 0.5, 0)));
+			vl::animation::NodeRefPtr node = model.graph->createNode(
+				vl::Transform(Ogre::Vector3(0, 0.5, 0)));
+			link->setParent(parent);
+			link->setChild(node);
+			link->setInitialState();
+
+			nodes.push_back(node);
+			model.nodes.push_back(node);
+			model.machines.at(m).push_back(link);
+		}
+	}
+}
+
+/// Does the same work per link as the hinge constraints
+void
+animate_machines(Model *model, size_t begin, size_t end, size_t frame, double animated)
+{
+	for(size_t m = begin; m < end; ++m)
+	{
+		std::vector<vl::animation::LinkRefPtr> &links = model->machines[m];
+		size_t n_animated = size_t(animated*links.size());
+		for(size_t i = 0; i < n_animated; ++i)
+		{
+			links[i]->setOrientation(Ogre::Quaternion(
+				Ogre::Radian(0.001*(frame+i)), Ogre::Vector3::UNIT_Z));
+		}
+	}
+}
+
+void
+run_frame(Model &model, vl::ThreadPool *pool, size_t frame, double animated,
+	vl::Report<vl::time> &report, std::string const &suffix)
+{
+	vl::chrono timer;
+	if(pool)
+	{
+		std::vector<vl::ThreadPool::Task> tasks;
+		for(size_t m = 0; m < model.machines.size(); ++m)
+		{ tasks.push_back(boost::bind(&animate_machines, &model, m, m+1, frame, animated)); }
+		pool->run(tasks);
+	}
+	else
+	{ animate_machines(&model, 0, model.machines.size(), frame, animated); }
+	report["Animate" + suffix].push(timer.elapsed());
+
+	timer.reset();
+	model.graph->_update(pool);
+	report["Graph update" + suffix].push(timer.elapsed());
+}
+
+}	// unamed namespace
+
+int main(int argc, char **argv)
+{
+	size_t n_links = 10000;
+	size_t branching = 2;
+	size_t n_frames = 1000;
+	double animated = 1.0;
+	size_t n_machines = 1;
+	size_t n_threads = 0;
+
+	try
+	{
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h", "produce help message")
+			("links,l", po::value<size_t>(&n_links), "number of links in the machine")
+			("branching,b", po::value<size_t>(&branching), "maximum number of child links per node")
+			("animated,a", po::value<double>(&animated), "fraction of links animated every frame")
+			("frames,f", po::value<size_t>(&n_frames), "number of frames to run")
+			("machines,m", po::value<size_t>(&n_machines), "number of independent machines")
+			("threads,t", po::value<size_t>(&n_threads), "number of threads, zero for hardware threads")
+		;
+
+		po::variables_map vm;
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		po::notify(vm);
+
+		if(vm.count("help"))
+		{
+			std::cout << desc << std::endl;
+			return 0;
+		}
+
+		if(n_frames == 0)
+		{ n_frames = 1; }
+		if(branching == 0)
+		{ branching = 1; }
+
+		if(n_machines == 0)
+		{ n_machines = 1; }
+
+		Model model;
+		build_model(model, n_links, branching, n_machines);
+		Model parallel_model;
+		build_model(parallel_model, n_links, branching, n_machines);
+
+		vl::ThreadPool pool(n_threads);
+
+		std::cout << "Benchmarking animation graph with " << model.graph->size()
+			<< " nodes in " << n_machines << " machines, " << animated*100
+			<< "% of links animated for " << n_frames << " frames using "
+			<< pool.getNThreads() << " threads." << std::endl;
+
+		vl::Report<vl::time> report;
+		std::vector<vl::Transform> reference;
+		std::vector<vl::Transform> copied(model.nodes.size());
+		reference.reserve(model.nodes.size());
+		vl::time serial_time;
+		vl::time parallel_time;
+		for(size_t f = 0; f < n_frames; ++f)
+		{
+			vl::chrono timer;
+			run_frame(model, 0, f, animated, report, "");
+			serial_time += timer.elapsed();
+
+			timer.reset();
+			for(size_t i = 0; i < model.nodes.size(); ++i)
+			{ copied[i] = model.nodes[i]->_getCachedWorldTransform(); }
+			report["Copy world transforms"].push(timer.elapsed());
+
+			timer.reset();
+			reference.clear();
+			recursive_update(model.graph->getRoot(), vl::Transform(), reference);
+			report["Recursive reference"].push(timer.elapsed());
+
+			timer.reset();
+			run_frame(parallel_model, &pool, f, animated, report, " (parallel)");
+			parallel_time += timer.elapsed();
+		}
+		report.finish();
+
+		// Verify the cache against walking the parents of every node
+		// and the parallel results against the serial ones
+		double max_error = 0;
+		size_t n_different = 0;
+		for(size_t i = 0; i < model.nodes.size(); ++i)
+		{
+			vl::Transform t = model.nodes[i]->_getCachedWorldTransform();
+			double error = (t.position - model.nodes[i]->getWorldTransform().position).length();
+			if(error > max_error)
+			{ max_error = error; }
+
+			if(t != parallel_model.nodes[i]->_getCachedWorldTransform())
+			{ ++n_different; }
+		}
+
+		std::cout << report << std::endl
+			<< "Islands : " << model.graph->getStorage()->getNIslands() << std::endl
+			<< "Serial frame : " << serial_time/n_frames << std::endl
+			<< "Parallel frame : " << parallel_time/n_frames << std::endl
+			<< "Speedup : " << double(serial_time)/double(parallel_time) << std::endl
+			<< "Maximum position difference : " << max_error << std::endl
+			<< "Nodes differing between serial and parallel : " << n_different << std::endl;
+	}
+	catch(std::exception const &e)
+	{
+		std::cerr << "Exception : " << e.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,695 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file frame_benchmark.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Headless frame loop benchmark for the Master to Slave distribution.
+ *
+ *	Runs the scene graph part of Master::render without a GPU.
+ *	Master side animates real SceneNodes and packs them with
+ *	Session::packDirtyObjects, splits the update into message parts and
+ *	sends them to N slaves either in-process or over UDP loopback.
+ *	Slaves reassemble the message, create their objects the way
+ *	Renderer::_create_objects does and unpack the updates into their own
+ *	SceneNodes the way Renderer::_syncData does. Rendering is replaced with
+ *	a null renderer that only updates the Ogre scene graph, slaves use an
+ *	Ogre SceneManager without a render system.
+ *
+ *	Renderer, Server and Client themselves are not used because they need
+ *	a window and the Master/Slave state machine, the code paths here are
+ *	the same ones they call.
+ *
+ *	Scene generation uses a fixed seed and animation uses a fixed time step
+ *	so two runs with the same parameters produce exactly the same traffic,
+ *	the checksums printed at the end can be used to verify that and
+ *	that the slaves match the master.
+ *
+ *	Reports frames per second, per stage times, bytes on the wire and
+ *	heap allocations per frame. Allocations are counted with
+ *	AllocationTracker so HydraMain needs to be built with
+ *	HYDRA_TRACK_ALLOCATIONS for them.
+ *
+ *	Example, 5000 nodes, 20% animated, two slaves over loopback
+ *	frame_benchmark --nodes 5000 --animated 0.2 --slaves 2 --loopback
+ */
+
+#include <boost/asio.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <OGRE/OgreRoot.h>
+
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+#include "scene_manager.hpp"
+#include "scene_node.hpp"
+#include "ogre_root.hpp"
+
+#include "cluster/session.hpp"
+#include "cluster/message.hpp"
+
+// Necessary for timing
+#include "base/chrono.hpp"
+// Necessary for the stage report
+#include "base/report.hpp"
+// Necessary for counting allocations
+#include "base/allocation_tracker.hpp"
+#include "base/frame_arena.hpp"
+
+namespace po = boost::program_options;
+namespace asio = boost::asio;
+
+using asio::ip::udp;
+
+/// -------------------------- Generated scene -------------------------------
+namespace
+{
+
+/// Linear congruential generator, we don't want to depend on the
+/// implementation of std::rand for deterministic scenes.
+class Random
+{
+public :
+	Random(uint32_t seed)
+		: _state(seed)
+	{}
+
+	uint32_t next(void)
+	{
+		_state = _state*1664525u + 1013904223u;
+		return _state;
+	}
+
+	/// @return random number in range [0, 1)
+	vl::scalar uniform(void)
+	{ return vl::scalar(next() >> 8)/vl::scalar(1 << 24); }
+
+private :
+	uint32_t _state;
+};
+
+/// @brief order independent checksum of the scene graph
+double
+scene_checksum(vl::SceneManager const &scene)
+{
+	double sum = 0;
+	vl::SceneNodeList const &nodes = scene.getSceneNodeList();
+	for(size_t i = 0; i < nodes.size(); ++i)
+	{
+		vl::Transform const &t = nodes.at(i)->getTransform();
+		sum += t.position.x + t.position.y + t.position.z
+			+ t.quaternion.w + t.quaternion.x + t.quaternion.y + t.quaternion.z;
+	}
+	return sum;
+}
+
+/// @brief allocations of the current frame over all subsystems
+size_t
+frame_allocations(vl::AllocationTracker const &tracker)
+{
+	size_t n = 0;
+	for(size_t i = 0; i < vl::AS_SIZE; ++i)
+	{ n += tracker.getFrameCount(vl::ALLOC_SUBSYSTEM(i)).allocations; }
+	return n;
+}
+
+struct Options
+{
+	Options(void)
+		: n_nodes(1000)
+		, branching(4)
+		, animated(0.1)
+		, n_frames(1000)
+		, n_slaves(1)
+		, loopback(false)
+		, port(4699)
+		, seed(42)
+		, warm_up(10)
+	{}
+
+	size_t n_nodes;
+	size_t branching;
+	double animated;
+	size_t n_frames;
+	size_t n_slaves;
+	bool loopback;
+	uint16_t port;
+	uint32_t seed;
+	/// Frames before the master is expected not to allocate
+	size_t warm_up;
+};
+
+/// Statistics collected over the whole run
+struct Statistics
+{
+	Statistics(void)
+		: bytes(0), parts(0), objects(0)
+		, master_allocations(0), slave_allocations(0)
+		, steady_frames(0), steady_allocations(0)
+	{}
+
+	uint64_t bytes;
+	uint64_t parts;
+	uint64_t objects;
+	/// Allocations done by the master stages, animate, pack and send
+	uint64_t master_allocations;
+	/// Allocations done by the slave stages, receive, unpack and render
+	uint64_t slave_allocations;
+	/// Frames after the warm-up and the master allocations in them
+	uint64_t steady_frames;
+	uint64_t steady_allocations;
+};
+
+/// @class BenchmarkMaster
+/// @brief Owns the generated scene and packs the updates
+class BenchmarkMaster
+{
+public :
+	BenchmarkMaster(Options const &opt)
+		: _scene(&_session, vl::MeshManagerRefPtr())
+		, _rand(opt.seed)
+		, _frame(0)
+	{
+		_generate(opt);
+	}
+
+	/// @brief animate the selected nodes with a fixed time step
+	void animate(void)
+	{
+		++_frame;
+		vl::scalar t = vl::scalar(_frame)/60;
+		for(size_t i = 0; i < _animated.size(); ++i)
+		{
+			vl::SceneNodePtr node = _nodes.at(_animated.at(i));
+			vl::Transform trans(node->getTransform());
+			trans.position.y = std::sin(t + i);
+			trans.quaternion = Ogre::Quaternion(Ogre::Radian(t), Ogre::Vector3::UNIT_Y);
+			node->setTransform(trans);
+		}
+	}
+
+	/// @brief same as Master::_createMsgCreate
+	void createMsgCreate(vl::cluster::Message &msg)
+	{
+		msg.reset(vl::cluster::MSG_SG_CREATE, _frame, vl::time());
+		msg.write(_session.getNewObjects().size());
+		for(size_t i = 0; i < _session.getNewObjects().size(); ++i)
+		{
+			msg.write(_session.getNewObjects().at(i).first);
+			msg.write(_session.getNewObjects().at(i).second->getID());
+		}
+		_session.clearNewObjects();
+	}
+
+	/// @brief whole scene the way a new slave receives it
+	void createMsgInit(vl::cluster::Message &msg)
+	{
+		msg.reset(vl::cluster::MSG_SG_INIT, _frame, vl::time());
+		_session.packAllObjects(msg);
+	}
+
+	/// @brief same as Master::_sendUpdates
+	/// @return number of objects packed
+	size_t packUpdate(vl::cluster::Message &msg)
+	{
+		msg.reset(vl::cluster::MSG_SG_UPDATE, _frame, vl::time());
+		return _session.packDirtyObjects(msg);
+	}
+
+	double checksum(void) const
+	{ return scene_checksum(_scene); }
+
+	size_t getNNodes(void) const
+	{ return _nodes.size(); }
+
+	size_t getNAnimated(void) const
+	{ return _animated.size(); }
+
+private :
+	void _generate(Options const &opt)
+	{
+		_nodes.reserve(opt.n_nodes);
+		for(size_t i = 0; i < opt.n_nodes; ++i)
+		{
+			std::stringstream ss;
+			ss << "node_" << i;
+			// Breadth first tree so parents are always created before children
+			vl::SceneNodePtr parent = (i > 0)
+				? _nodes.at((i-1)/opt.branching) : _scene.getRootSceneNode();
+			vl::SceneNodePtr node = parent->createChildSceneNode(ss.str());
+			node->setTransform(vl::Transform(Ogre::Vector3(
+				_rand.uniform()*10, _rand.uniform()*10, _rand.uniform()*10)));
+			_nodes.push_back(node);
+
+			if(_rand.uniform() < opt.animated)
+			{ _animated.push_back(i); }
+		}
+	}
+
+	vl::Session _session;
+	vl::SceneManager _scene;
+
+	Random _rand;
+	uint32_t _frame;
+
+	std::vector<vl::SceneNodePtr> _nodes;
+	std::vector<size_t> _animated;
+
+};	// class BenchmarkMaster
+
+/// @class BenchmarkSlave
+/// @brief Receives updates into a slave SceneManager and runs the null renderer
+class BenchmarkSlave
+{
+public :
+	BenchmarkSlave(Ogre::Root *root, std::string const &name)
+		: _root(root)
+		, _name(name)
+		, _scene(0)
+	{}
+
+	~BenchmarkSlave(void)
+	{
+		delete _scene;
+	}
+
+	/// @brief create mapped objects from MSG_SG_CREATE
+	/// same as Renderer::_create_objects for the scene graph objects
+	void createObjects(vl::cluster::Message &msg)
+	{
+		size_t n_objects;
+		msg.read(n_objects);
+		// Sorted by id so the SceneManager is created before the nodes
+		std::map<uint64_t, vl::OBJ_TYPE> objects;
+		for(size_t i = 0; i < n_objects; ++i)
+		{
+			vl::OBJ_TYPE type;
+			uint64_t id;
+			msg.read(type);
+			msg.read(id);
+			objects[id] = type;
+		}
+
+		for(std::map<uint64_t, vl::OBJ_TYPE>::const_iterator iter = objects.begin();
+			iter != objects.end(); ++iter)
+		{
+			if(iter->second == vl::OBJ_SCENE_MANAGER)
+			{
+				if(_scene)
+				{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("SceneManager already created.")); }
+				Ogre::SceneManager *sm = _root->createSceneManager(Ogre::ST_GENERIC, _name);
+				_scene = new vl::SceneManager(&_session, iter->first, sm, vl::MeshManagerRefPtr());
+				// Sky, fog and shadows need resources and a render system
+				_ignored.push_back(iter->first);
+			}
+			else if(iter->second == vl::OBJ_SCENE_NODE)
+			{
+				if(!_scene)
+				{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("SceneNode before SceneManager.")); }
+				_scene->_createSceneNode(iter->first);
+			}
+			else if(iter->second >= vl::OBJ_MOVABLE && _scene)
+			{ _scene->_createMovableObject(iter->second, iter->first); }
+			else
+			{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Unsupported distributed object type.")); }
+		}
+	}
+
+	/// @brief same as Renderer::updateScene and Renderer::_syncData
+	/// @return number of objects unpacked
+	size_t updateScene(vl::cluster::Message &msg)
+	{
+		size_t n_objects = 0;
+		while( msg.size() > 0 )
+		{
+			vl::cluster::ObjectData data;
+			data.copyFromMessage(&msg);
+			if(std::find(_ignored.begin(), _ignored.end(), data.getId()) != _ignored.end())
+			{ continue; }
+
+			vl::cluster::ByteDataStream stream = data.getStream();
+			vl::Distributed *obj = _session.findMappedObject(data.getId());
+			if(obj)
+			{
+				obj->unpack(stream);
+				++n_objects;
+			}
+		}
+
+		return n_objects;
+	}
+
+	/// @brief null renderer, update the Ogre scene graph
+	void draw(void)
+	{
+		_scene->getNative()->getRootSceneNode()->_update(true, false);
+	}
+
+	double checksum(void) const
+	{ return _scene ? scene_checksum(*_scene) : 0; }
+
+	/// @brief add a received part, returns true when a message is complete
+	bool receivePart(std::vector<char> const &buf, vl::cluster::Message &msg)
+	{
+		vl::cluster::MessagePart part(buf);
+		std::vector<vl::cluster::MessagePart> &parts = _partial[part.id];
+		parts.push_back(part);
+		if(parts.size() == part.parts)
+		{
+			msg = vl::cluster::Message(parts);
+			_partial.erase(part.id);
+			return true;
+		}
+		return false;
+	}
+
+private :
+	Ogre::Root *_root;
+	std::string _name;
+
+	vl::Session _session;
+	vl::SceneManager *_scene;
+
+	std::vector<uint64_t> _ignored;
+
+	std::map<uint64_t, std::vector<vl::cluster::MessagePart> > _partial;
+
+};	// class BenchmarkSlave
+
+/// @class Transport
+/// @brief Delivers the message parts from the master to the slaves
+class Transport
+{
+public :
+	Transport(Options const &opt, std::vector<BenchmarkSlave *> const &slaves,
+			vl::AllocationTracker const &tracker)
+		: _slaves(slaves)
+		, _loopback(opt.loopback)
+		, _tracker(tracker)
+		, _socket(_io_service, udp::endpoint(udp::v4(), 0))
+		, _buffer(vl::cluster::MTU_SIZE)
+	{
+		if(_loopback)
+		{
+			for(size_t i = 0; i < _slaves.size(); ++i)
+			{
+				udp::endpoint endpoint(asio::ip::address_v4::loopback(), opt.port+i);
+				udp::socket *sock = new udp::socket(_io_service, endpoint);
+				_slave_sockets.push_back(sock);
+				_slave_endpoints.push_back(endpoint);
+			}
+		}
+	}
+
+	~Transport(void)
+	{
+		for(size_t i = 0; i < _slave_sockets.size(); ++i)
+		{ delete _slave_sockets.at(i); }
+	}
+
+	/// @brief split, send and deliver a message to every slave
+	/// Slaves receive each part right after it's sent so the socket buffers
+	/// never overflow and no parts are lost.
+	/// @param received messages reassembled by the slaves, one per slave
+	/// @param receive_time time used by the slaves for receiving
+	/// @param receive_allocations allocations done by the slaves for receiving
+	void send(vl::cluster::Message const &msg, std::vector<vl::cluster::Message> &received,
+		Statistics &stats, vl::time &receive_time, size_t &receive_allocations)
+	{
+		received.resize(_slaves.size());
+
+		msg.createParts(_parts);
+		vl::chrono timer;
+		for(size_t i = 0; i < _parts.size(); ++i)
+		{
+			_parts.at(i).dump(_buffer);
+			for(size_t j = 0; j < _slaves.size(); ++j)
+			{
+				stats.bytes += _buffer.size();
+				++stats.parts;
+
+				if(_loopback)
+				{ _socket.send_to(asio::buffer(_buffer), _slave_endpoints.at(j)); }
+
+				timer.reset();
+				size_t allocs = frame_allocations(_tracker);
+				{
+					vl::AllocationScope scope(vl::AS_NETWORK);
+					if(_loopback)
+					{
+						_recv_buffer.resize(vl::cluster::MTU_SIZE);
+						udp::endpoint sender;
+						size_t n = _slave_sockets.at(j)->receive_from(asio::buffer(_recv_buffer), sender);
+						_recv_buffer.resize(n);
+						_slaves.at(j)->receivePart(_recv_buffer, received.at(j));
+					}
+					else
+					{ _slaves.at(j)->receivePart(_buffer, received.at(j)); }
+				}
+				receive_allocations += frame_allocations(_tracker) - allocs;
+				receive_time += timer.elapsed();
+			}
+		}
+	}
+
+private :
+	std::vector<BenchmarkSlave *> _slaves;
+	bool _loopback;
+
+	vl::AllocationTracker const &_tracker;
+
+	asio::io_service _io_service;
+	udp::socket _socket;
+	std::vector<udp::socket *> _slave_sockets;
+	std::vector<udp::endpoint> _slave_endpoints;
+
+	std::vector<vl::cluster::MessagePart> _parts;
+	std::vector<char> _buffer;
+	std::vector<char> _recv_buffer;
+
+};	// class Transport
+
+/// @class Frame
+/// @brief buffers reused over the frames like Master does
+struct Frame
+{
+	vl::cluster::Message update;
+	std::vector<vl::cluster::Message> received;
+};
+
+void
+run_frame(BenchmarkMaster &master, std::vector<BenchmarkSlave *> &slaves,
+	Transport &transport, Frame &frame, vl::AllocationTracker &tracker,
+	vl::Report<vl::time> &report, Statistics &stats, bool warm)
+{
+	vl::chrono frame_timer;
+	vl::chrono timer;
+
+	{
+		vl::AllocationScope scope(vl::AS_SCENE_GRAPH);
+		master.animate();
+	}
+	report["Animate"].push(timer.elapsed());
+
+	timer.reset();
+	{
+		vl::AllocationScope scope(vl::AS_NETWORK);
+		stats.objects += master.packUpdate(frame.update);
+	}
+	report["Pack updates"].push(timer.elapsed());
+
+	timer.reset();
+	vl::time receive_time;
+	size_t receive_allocations = 0;
+	{
+		vl::AllocationScope scope(vl::AS_NETWORK);
+		transport.send(frame.update, frame.received, stats, receive_time, receive_allocations);
+	}
+	report["Send"].push(timer.elapsed() - receive_time);
+	report["Receive"].push(receive_time);
+
+	size_t master_allocations = frame_allocations(tracker) - receive_allocations;
+
+	timer.reset();
+	{
+		vl::AllocationScope scope(vl::AS_SCENE_GRAPH);
+		for(size_t i = 0; i < slaves.size(); ++i)
+		{ slaves.at(i)->updateScene(frame.received.at(i)); }
+	}
+	report["Unpack"].push(timer.elapsed());
+
+	timer.reset();
+	{
+		vl::AllocationScope scope(vl::AS_RENDERING);
+		for(size_t i = 0; i < slaves.size(); ++i)
+		{ slaves.at(i)->draw(); }
+	}
+	report["Null render"].push(timer.elapsed());
+
+	stats.master_allocations += master_allocations;
+	stats.slave_allocations += frame_allocations(tracker) - master_allocations;
+	if(warm)
+	{
+		++stats.steady_frames;
+		stats.steady_allocations += master_allocations;
+	}
+
+	// Same as the end of Master and Slave frames
+	tracker.finishFrame();
+	vl::FrameArena::frame().reset();
+
+	report["Frame"].push(frame_timer.elapsed());
+}
+
+}	// unnamed namespace
+
+int main(int argc, char **argv)
+{
+	Options opt;
+	try
+	{
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h", "produce help message")
+			("nodes,n", po::value<size_t>(&opt.n_nodes), "number of generated nodes")
+			("branching,b", po::value<size_t>(&opt.branching), "children per node in the generated tree")
+			("animated,a", po::value<double>(&opt.animated), "fraction of nodes animated every frame [0, 1]")
+			("frames,f", po::value<size_t>(&opt.n_frames), "number of frames to run")
+			("slaves,s", po::value<size_t>(&opt.n_slaves), "number of slaves")
+			("loopback,l", "send the messages over UDP loopback instead of in-process")
+			("port,p", po::value<uint16_t>(&opt.port), "first port used for the loopback slaves")
+			("seed", po::value<uint32_t>(&opt.seed), "seed for the scene generation")
+			("warm-up,w", po::value<size_t>(&opt.warm_up), "frames before the allocations are expected to stop")
+		;
+
+		po::variables_map vm;
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		po::notify(vm);
+
+		if(vm.count("help"))
+		{
+			std::cout << desc << std::endl;
+			return 0;
+		}
+
+		opt.loopback = vm.count("loopback") > 0;
+
+		if(opt.branching == 0)
+		{ opt.branching = 1; }
+
+		std::cout << "Generating " << opt.n_nodes << " nodes with "
+			<< opt.animated*100 << "% animated for " << opt.n_slaves << " slaves "
+			<< (opt.loopback ? "over UDP loopback." : "in-process.") << std::endl;
+
+		// Slaves share the Ogre Root, every slave creates its own SceneManager
+		vl::ogre::Root root(vl::config::LL_LOW);
+
+		BenchmarkMaster master(opt);
+
+		std::vector<BenchmarkSlave *> slaves;
+		for(size_t i = 0; i < opt.n_slaves; ++i)
+		{
+			std::stringstream ss;
+			ss << "slave_" << i;
+			slaves.push_back(new BenchmarkSlave(root.getNative(), ss.str()));
+		}
+
+		vl::AllocationTracker tracker;
+		Transport transport(opt, slaves, tracker);
+
+		/// Initialisation, same as what the slaves receive from the Master
+		/// when they connect: MSG_SG_CREATE followed by MSG_SG_INIT
+		vl::chrono init_timer;
+		Statistics init_stats;
+		vl::time receive_time;
+		size_t receive_allocations = 0;
+		std::vector<vl::cluster::Message> received;
+
+		vl::cluster::Message create;
+		master.createMsgCreate(create);
+		transport.send(create, received, init_stats, receive_time, receive_allocations);
+		for(size_t i = 0; i < slaves.size(); ++i)
+		{ slaves.at(i)->createObjects(received.at(i)); }
+
+		vl::cluster::Message init;
+		master.createMsgInit(init);
+		transport.send(init, received, init_stats, receive_time, receive_allocations);
+		for(size_t i = 0; i < slaves.size(); ++i)
+		{ slaves.at(i)->updateScene(received.at(i)); }
+
+		std::cout << "Init took " << init_timer.elapsed() << " sending "
+			<< init_stats.bytes << " bytes in " << init_stats.parts << " parts." << std::endl;
+
+		/// Main loop
+		vl::Report<vl::time> report;
+		Statistics stats;
+		Frame frame;
+		tracker.setEnabled(true);
+		vl::chrono run_timer;
+		for(size_t i = 0; i < opt.n_frames; ++i)
+		{
+			run_frame(master, slaves, transport, frame, tracker, report, stats,
+				i >= opt.warm_up);
+		}
+		vl::time run_time = run_timer.elapsed();
+		tracker.setEnabled(false);
+		report.finish();
+		tracker.getReport().finish();
+
+		double seconds = double(run_time);
+		double n_frames = double(opt.n_frames > 0 ? opt.n_frames : 1);
+
+		std::cout << std::endl << "Stage times (avarage per frame)" << std::endl
+			<< report << std::endl;
+
+		std::cout << std::fixed << std::setprecision(2)
+			<< "Frames : " << opt.n_frames << " in " << run_time << std::endl
+			<< "FPS : " << (seconds > 0 ? n_frames/seconds : 0) << std::endl
+			<< "Animated nodes : " << master.getNAnimated() << " / " << master.getNNodes() << std::endl
+			<< "Objects packed per frame : " << stats.objects/n_frames << std::endl
+			<< "Bytes on the wire per frame : " << stats.bytes/n_frames << std::endl
+			<< "Parts per frame : " << stats.parts/n_frames << std::endl;
+
+		if(vl::AllocationTracker::isAvailable())
+		{
+			std::cout << "Master allocations per frame : " << stats.master_allocations/n_frames << std::endl
+				<< "Slave allocations per frame : " << stats.slave_allocations/n_frames << std::endl
+				<< "Master allocations after " << opt.warm_up << " warm-up frames : "
+				<< stats.steady_allocations << " in " << stats.steady_frames << " frames" << std::endl
+				<< std::endl << "Allocations (avarage per frame)" << std::endl
+				<< tracker.getReport() << std::endl;
+		}
+		else
+		{ std::cout << "Allocations not counted, build with HYDRA_TRACK_ALLOCATIONS." << std::endl; }
+
+		std::cout << std::setprecision(6)
+			<< "Master checksum : " << master.checksum() << std::endl;
+		for(size_t i = 0; i < slaves.size(); ++i)
+		{ std::cout << "Slave " << i << " checksum : " << slaves.at(i)->checksum() << std::endl; }
+
+		for(size_t i = 0; i < slaves.size(); ++i)
+		{ delete slaves.at(i); }
+	}
+	catch(std::exception const &e)
+	{
+		std::cerr << "Exception : " << e.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file mapping_benchmark.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Microbenchmark for the automatic collision barrier to visual mappings
+ *	in SceneManager::_step.
+ *
+ *	Generates a rig of kinematic chains with a collision barrier (cb_*)
+ *	hierarchy and a separate visual hierarchy, maps them with
+ *	SceneManager::mapCollisionBarriers and compares the batched update
+ *	against copying the world transformations one mapping at a time.
+ *
+ *	Runs on a master SceneManager so no rendering system is needed.
+ */
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <sstream>
+
+#include "scene_manager.hpp"
+#include "scene_node.hpp"
+
+#include "cluster/session.hpp"
+
+#include "base/chrono.hpp"
+
+namespace po = boost::program_options;
+
+int main(int argc, char **argv)
+{
+	size_t n_chains = 500;
+	size_t depth = 8;
+	size_t n_frames = 1000;
+
+	try
+	{
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h", "produce help message")
+			("chains,c", po::value<size_t>(&n_chains), "number of kinematic chains")
+			("depth,d", po::value<size_t>(&depth), "links per chain")
+			("frames,f", po::value<size_t>(&n_frames), "number of frames to run")
+		;
+
+		po::variables_map vm;
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		po::notify(vm);
+
+		if(vm.count("help"))
+		{
+			std::cout << desc << std::endl;
+			return 0;
+		}
+
+		if(n_frames == 0)
+		{ n_frames = 1; }
+
+		vl::Session session;
+		vl::SceneManager scene(&session, vl::MeshManagerRefPtr());
+
+		std::vector< std::pair<vl::SceneNodePtr, vl::SceneNodePtr> > mappings;
+		std::vector<vl::SceneNodePtr> chain_roots;
+		for(size_t i = 0; i < n_chains; ++i)
+		{
+			vl::SceneNodePtr cb_parent = scene.getRootSceneNode();
+			vl::SceneNodePtr vis_parent = scene.getRootSceneNode();
+			for(size_t j = 0; j < depth; ++j)
+			{
+				std::stringstream ss;
+				ss << "link_" << i << "_" << j;
+				vl::SceneNodePtr cb = cb_parent->createChildSceneNode("cb_" + ss.str());
+				vl::SceneNodePtr vis = vis_parent->createChildSceneNode(ss.str());
+				cb->setTransform(vl::Transform(Ogre::Vector3(0, 0.5, 1),
+					Ogre::Quaternion(Ogre::Degree(10), Ogre::Vector3::UNIT_X)));
+				vis->setTransform(vl::Transform(Ogre::Vector3(0, 0, 1)));
+
+				if(j == 0)
+				{ chain_roots.push_back(cb); }
+
+				mappings.push_back(std::make_pair(cb, vis));
+				cb_parent = cb;
+				vis_parent = vis;
+			}
+		}
+
+		scene.mapCollisionBarriers();
+
+		std::cout << "Benchmarking " << mappings.size() << " mappings in "
+			<< n_chains << " chains for " << n_frames << " frames." << std::endl;
+
+		vl::time reference_time;
+		vl::time batched_time;
+		double max_error = 0;
+		for(size_t f = 0; f < n_frames; ++f)
+		{
+			Ogre::Quaternion q(Ogre::Radian(0.01*f), Ogre::Vector3::UNIT_Z);
+			for(size_t i = 0; i < chain_roots.size(); ++i)
+			{ chain_roots.at(i)->setOrientation(q); }
+
+			// Reference, what SceneManager::_step used to do
+			vl::chrono timer;
+			for(size_t i = 0; i < mappings.size(); ++i)
+			{ mappings.at(i).second->setWorldTransform(mappings.at(i).first->getWorldTransform()); }
+			reference_time += timer.elapsed();
+
+			std::vector<vl::Transform> reference(mappings.size());
+			for(size_t i = 0; i < mappings.size(); ++i)
+			{ reference.at(i) = mappings.at(i).second->getWorldTransform(); }
+
+			timer.reset();
+			scene._step(vl::time());
+			batched_time += timer.elapsed();
+
+			for(size_t i = 0; i < mappings.size(); ++i)
+			{
+				vl::Transform t = mappings.at(i).second->getWorldTransform();
+				double error = (t.position - reference.at(i).position).length();
+				if(error > max_error)
+				{ max_error = error; }
+			}
+		}
+
+		std::cout << "Per mapping copy : " << reference_time/n_frames << " per frame." << std::endl
+			<< "Batched update : " << batched_time/n_frames << " per frame." << std::endl
+			<< "Maximum position difference : " << max_error << std::endl;
+	}
+	catch(std::exception const &e)
+	{
+		std::cerr << "Exception : " << e.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
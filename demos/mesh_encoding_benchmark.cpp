@@ -0,0 +1,236 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file mesh_encoding_benchmark.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Decode throughput of the mesh file encodings.
+ *
+ *	Creates a grid mesh with position, normal and uv in the vertex fetch
+ *	order the optimizer produces and measures decoding of the quantized
+ *	streams, decompressing raw and quantized vertices and decompressing
+ *	the indices. Throughput is in decoded MB/s so it can be compared
+ *	against the disk read speed, memcpy of the decoded data is reported
+ *	as the upper limit.
+ *
+ *	Example, 1M vertices decoded 20 times
+ *	mesh_encoding_benchmark --grid 1000 --iterations 20
+ */
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstring>
+
+#include "mesh_encoding.hpp"
+#include "base/chrono.hpp"
+
+namespace po = boost::program_options;
+
+namespace
+{
+
+struct Vertex
+{
+	float position[3];
+	float normal[3];
+	float uv[2];
+};
+
+std::vector<Vertex> create_grid(size_t n)
+{
+	std::vector<Vertex> vertices(n*n);
+	for(size_t i = 0; i < n; ++i)
+	{
+		for(size_t j = 0; j < n; ++j)
+		{
+			float u = float(i)/(n-1);
+			float v = float(j)/(n-1);
+			Vertex &vert = vertices.at(i*n + j);
+			vert.position[0] = 100.0f*u;
+			vert.position[1] = 100.0f*v;
+			vert.position[2] = 5.0f*std::sin(u*20.0f)*std::cos(v*15.0f);
+			float nx = -std::cos(u*20.0f)*std::cos(v*15.0f);
+			float ny = 0.75f*std::sin(u*20.0f)*std::sin(v*15.0f);
+			float len = std::sqrt(nx*nx + ny*ny + 1.0f);
+			vert.normal[0] = nx/len;
+			vert.normal[1] = ny/len;
+			vert.normal[2] = 1.0f/len;
+			vert.uv[0] = u;
+			vert.uv[1] = 1.0f - v;
+		}
+	}
+	return vertices;
+}
+
+std::vector<uint32_t> create_indices(size_t n)
+{
+	std::vector<uint32_t> indices;
+	indices.reserve((n-1)*(n-1)*6);
+	for(uint32_t i = 0; i+1 < n; ++i)
+	{
+		for(uint32_t j = 0; j+1 < n; ++j)
+		{
+			uint32_t a = uint32_t(i*n + j);
+			indices.push_back(a);
+			indices.push_back(a+1);
+			indices.push_back(uint32_t(a+n));
+			indices.push_back(a+1);
+			indices.push_back(uint32_t(a+n+1));
+			indices.push_back(uint32_t(a+n));
+		}
+	}
+	return indices;
+}
+
+void print_result(std::string const &name, size_t encoded, size_t decoded,
+	vl::time const &t, size_t iterations)
+{
+	double seconds = double(t)/iterations;
+	std::cout << name << " : " << encoded/1024 << " kB -> " << decoded/1024 << " kB, "
+		<< t/iterations << " per decode, "
+		<< (seconds > 0 ? decoded/seconds/(1024*1024) : 0) << " MB/s" << std::endl;
+}
+
+}	// unamed namespace
+
+int main(int argc, char **argv)
+{
+	size_t grid = 500;
+	size_t iterations = 20;
+
+	try
+	{
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h", "produce help message")
+			("grid,g", po::value<size_t>(&grid), "vertices per side of the grid")
+			("iterations,i", po::value<size_t>(&iterations), "number of times to decode")
+		;
+
+		po::variables_map vm;
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		po::notify(vm);
+
+		if(vm.count("help"))
+		{
+			std::cout << desc << std::endl;
+			return 0;
+		}
+
+		if(grid < 2)
+		{ grid = 2; }
+		if(iterations == 0)
+		{ iterations = 1; }
+
+		std::vector<Vertex> vertices = create_grid(grid);
+		std::vector<uint32_t> indices = create_indices(grid);
+		size_t n = vertices.size();
+		uint8_t const *src = (uint8_t const *)&vertices[0];
+		size_t vertex_bytes = n*sizeof(Vertex);
+		size_t index_bytes = indices.size()*sizeof(uint32_t);
+
+		std::cout << "Decoding " << n << " vertices and " << indices.size()/3
+			<< " triangles " << iterations << " times." << std::endl;
+
+		std::vector<Vertex> decoded(n);
+		uint8_t *dst = (uint8_t *)&decoded[0];
+		vl::chrono timer;
+		bool valid = true;
+
+		// Upper limit
+		timer.reset();
+		for(size_t i = 0; i < iterations; ++i)
+		{ ::memcpy(dst, src, vertex_bytes); }
+		print_result("memcpy", vertex_bytes, vertex_bytes, timer.elapsed(), iterations);
+
+		// Quantized streams
+		vl::VertexStream streams[3] = {
+			vl::VertexStream(0, 12, vl::VSE_POSITION_UNORM16),
+			vl::VertexStream(12, 12, vl::VSE_NORMAL_OCT16),
+			vl::VertexStream(24, 8, vl::VSE_HALF) };
+		std::vector<uint8_t> quantized[3];
+		size_t quantized_bytes = 0;
+		for(size_t s = 0; s < 3; ++s)
+		{
+			vl::encode_vertex_stream(streams[s], src, sizeof(Vertex), n, quantized[s]);
+			quantized_bytes += quantized[s].size();
+		}
+
+		timer.reset();
+		for(size_t i = 0; i < iterations; ++i)
+		{
+			for(size_t s = 0; s < 3; ++s)
+			{ vl::decode_vertex_stream(streams[s], &quantized[s][0], dst, sizeof(Vertex), n); }
+		}
+		print_result("Quantized", quantized_bytes, vertex_bytes, timer.elapsed(), iterations);
+
+		// Lossless vertices
+		std::vector<uint8_t> compressed;
+		vl::compress_vertex_stream(src, n, sizeof(Vertex), compressed);
+		timer.reset();
+		for(size_t i = 0; i < iterations; ++i)
+		{ vl::decompress_vertex_stream(&compressed[0], compressed.size(), n, sizeof(Vertex), dst); }
+		print_result("Compressed", compressed.size(), vertex_bytes, timer.elapsed(), iterations);
+		if(::memcmp(dst, src, vertex_bytes) != 0)
+		{ valid = false; }
+
+		// Compact, quantized and compressed streams
+		std::vector<uint8_t> compact[3];
+		size_t compact_bytes = 0;
+		for(size_t s = 0; s < 3; ++s)
+		{
+			vl::compress_vertex_stream(&quantized[s][0], n, streams[s].getEncodedSize(), compact[s]);
+			compact_bytes += compact[s].size();
+		}
+
+		std::vector<uint8_t> buffer(n*sizeof(Vertex));
+		timer.reset();
+		for(size_t i = 0; i < iterations; ++i)
+		{
+			for(size_t s = 0; s < 3; ++s)
+			{
+				vl::decompress_vertex_stream(&compact[s][0], compact[s].size(), n,
+					streams[s].getEncodedSize(), &buffer[0]);
+				vl::decode_vertex_stream(streams[s], &buffer[0], dst, sizeof(Vertex), n);
+			}
+		}
+		print_result("Compact", compact_bytes, vertex_bytes, timer.elapsed(), iterations);
+
+		// Indices
+		std::vector<uint32_t> decoded_indices(indices.size());
+		vl::compress_index_stream(&indices[0], indices.size(), compressed);
+		timer.reset();
+		for(size_t i = 0; i < iterations; ++i)
+		{
+			vl::decompress_index_stream(&compressed[0], compressed.size(),
+				decoded_indices.size(), &decoded_indices[0]);
+		}
+		print_result("Indices", compressed.size(), index_bytes, timer.elapsed(), iterations);
+		if(decoded_indices != indices)
+		{ valid = false; }
+
+		std::cout << "Lossless decoding " << (valid ? "valid" : "INVALID") << std::endl;
+
+		if(!valid)
+		{ return -1; }
+	}
+	catch(std::exception const &e)
+	{
+		std::cerr << "Exception : " << e.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,159 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file scene_graph_benchmark.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Stress test for SceneNodes with a large number of childs.
+ *
+ *	Creates two parents holding all the childs, moves a number of
+ *	childs between them every frame and packs the update the way Master
+ *	does. Reports the time spent in reparenting and packing, and the update
+ *	size compared to sending the whole child lists of the changed parents.
+ *
+ *	Runs on a master SceneManager so no rendering system is needed.
+ */
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <sstream>
+
+#include "scene_manager.hpp"
+#include "scene_node.hpp"
+
+#include "cluster/session.hpp"
+#include "cluster/message.hpp"
+
+#include "base/chrono.hpp"
+
+namespace po = boost::program_options;
+
+int main(int argc, char **argv)
+{
+	size_t n_childs = 10000;
+	size_t n_moves = 100;
+	size_t n_frames = 100;
+
+	try
+	{
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h", "produce help message")
+			("childs,c", po::value<size_t>(&n_childs), "number of childs")
+			("moves,m", po::value<size_t>(&n_moves), "childs moved to the other parent per frame")
+			("frames,f", po::value<size_t>(&n_frames), "number of frames to run")
+		;
+
+		po::variables_map vm;
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		po::notify(vm);
+
+		if(vm.count("help"))
+		{
+			std::cout << desc << std::endl;
+			return 0;
+		}
+
+		if(n_childs == 0)
+		{ n_childs = 1; }
+		if(n_frames == 0)
+		{ n_frames = 1; }
+
+		vl::Session session;
+		vl::SceneManager scene(&session, vl::MeshManagerRefPtr());
+
+		vl::SceneNodePtr parent_a = scene.getRootSceneNode()->createChildSceneNode("parent_a");
+		vl::SceneNodePtr parent_b = scene.getRootSceneNode()->createChildSceneNode("parent_b");
+
+		vl::chrono timer;
+		std::vector<vl::SceneNodePtr> childs;
+		childs.reserve(n_childs);
+		for(size_t i = 0; i < n_childs; ++i)
+		{
+			std::stringstream ss;
+			ss << "child_" << i;
+			childs.push_back(parent_a->createChildSceneNode(ss.str()));
+		}
+		vl::time create_time = timer.elapsed();
+
+		// Initial state, whole lists
+		vl::cluster::Message msg;
+		timer.reset();
+		session.packDirtyObjects(msg);
+		vl::time init_pack_time = timer.elapsed();
+		size_t init_size = msg.size();
+
+		std::cout << "Benchmarking " << n_childs << " childs moving " << n_moves
+			<< " childs per frame for " << n_frames << " frames." << std::endl;
+
+		vl::time move_time;
+		vl::time pack_time;
+		size_t update_bytes = 0;
+		size_t full_list_bytes = 0;
+		for(size_t f = 0; f < n_frames; ++f)
+		{
+			timer.reset();
+			for(size_t i = 0; i < n_moves; ++i)
+			{
+				vl::SceneNodePtr child = childs.at((f*n_moves + i) % childs.size());
+				if(child->getParent() == parent_a)
+				{ parent_b->addChild(child); }
+				else
+				{ parent_a->addChild(child); }
+			}
+			move_time += timer.elapsed();
+
+			msg.clear();
+			timer.reset();
+			session.packDirtyObjects(msg);
+			pack_time += timer.elapsed();
+
+			update_bytes += msg.size();
+			// What the changed parents would send with the whole lists
+			full_list_bytes += (parent_a->getChilds().size() + parent_b->getChilds().size())
+				*sizeof(uint64_t);
+		}
+
+		bool valid = parent_a->getChilds().size() + parent_b->getChilds().size() == childs.size();
+		for(size_t i = 0; i < childs.size(); ++i)
+		{
+			vl::SceneNodePtr parent = childs.at(i)->getParent();
+			if(!parent || !parent->hasChild(childs.at(i)))
+			{ valid = false; }
+		}
+
+		timer.reset();
+		parent_a->removeAllChildren();
+		parent_b->removeAllChildren();
+		vl::time remove_time = timer.elapsed();
+
+		std::cout << "Creating childs : " << create_time << std::endl
+			<< "Initial state : " << init_size << " bytes packed in " << init_pack_time << std::endl
+			<< "Moving childs : " << move_time/n_frames << " per frame." << std::endl
+			<< "Packing updates : " << pack_time/n_frames << " per frame." << std::endl
+			<< "Update size : " << update_bytes/n_frames << " bytes per frame." << std::endl
+			<< "Whole child lists : " << full_list_bytes/n_frames << " bytes per frame." << std::endl
+			<< "Removing all childs : " << remove_time << std::endl
+			<< "Hierarchy " << (valid ? "valid" : "INVALID") << std::endl;
+
+		if(!valid)
+		{ return -1; }
+	}
+	catch(std::exception const &e)
+	{
+		std::cerr << "Exception : " << e.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
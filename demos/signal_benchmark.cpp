@@ -0,0 +1,209 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file signal_benchmark.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Microbenchmark for the signals used on the frame thread.
+ *
+ *	Measures the cost of a single emit with different number of slots
+ *	for boost::signal and vl::Signal.
+ *
+ *	Also runs a tracker frame, every tracker sensor emits a transformation
+ *	through it's TransformActionTrigger and the listeners copy it to a scene
+ *	node and a kinematic body which forwards it to a rigid body like
+ *	KinematicWorld does.
+ *
+ *	Example, 128 tracker sensors
+ *	signal_benchmark --emits 1000000 --trackers 128 --frames 10000
+ */
+
+#include <boost/program_options.hpp>
+#include <boost/signal.hpp>
+#include <boost/bind.hpp>
+
+#include <iostream>
+#include <vector>
+
+#include "base/signal.hpp"
+#include "base/chrono.hpp"
+
+namespace po = boost::program_options;
+
+namespace
+{
+
+/// Same size as vl::Transform without depending on Ogre
+struct Transform
+{
+	Transform(void)
+		: x(0), y(0), z(0), qw(1), qx(0), qy(0), qz(0)
+	{}
+
+	float x, y, z;
+	float qw, qx, qy, qz;
+};
+
+struct Counter
+{
+	Counter(void) : n(0) {}
+
+	void increment(int i)
+	{ n += i; }
+
+	size_t n;
+};
+
+struct Node
+{
+	void setTransform(Transform const &t)
+	{ transform = t; }
+
+	Transform transform;
+};
+
+/// Kinematic body forwarding the transformation to a rigid body
+template<typename SignalT>
+struct Body
+{
+	void setTransform(Transform const &t)
+	{
+		transform = t;
+		transformed(t);
+	}
+
+	Transform transform;
+	SignalT transformed;
+};
+
+template<typename SignalT>
+vl::time
+time_emits(size_t n_slots, size_t n_emits, Counter &counter)
+{
+	SignalT signal;
+	for(size_t i = 0; i < n_slots; ++i)
+	{ signal.connect(boost::bind(&Counter::increment, &counter, _1)); }
+
+	vl::chrono timer;
+	for(size_t i = 0; i < n_emits; ++i)
+	{ signal(1); }
+
+	return timer.elapsed();
+}
+
+template<typename SignalT>
+vl::time
+time_tracker_frames(size_t n_trackers, size_t n_frames)
+{
+	std::vector<SignalT *> triggers(n_trackers);
+	std::vector<Node> nodes(n_trackers);
+	std::vector<Node> rigid_bodies(n_trackers);
+	std::vector<Body<SignalT> *> bodies(n_trackers);
+	for(size_t i = 0; i < n_trackers; ++i)
+	{
+		triggers[i] = new SignalT;
+		bodies[i] = new Body<SignalT>;
+		triggers[i]->connect(boost::bind(&Node::setTransform, &nodes[i], _1));
+		triggers[i]->connect(boost::bind(&Body<SignalT>::setTransform, bodies[i], _1));
+		bodies[i]->transformed.connect(boost::bind(&Node::setTransform, &rigid_bodies[i], _1));
+	}
+
+	Transform t;
+	vl::chrono timer;
+	for(size_t f = 0; f < n_frames; ++f)
+	{
+		for(size_t i = 0; i < n_trackers; ++i)
+		{
+			t.x = float(f);
+			(*triggers[i])(t);
+		}
+	}
+	vl::time elapsed = timer.elapsed();
+
+	for(size_t i = 0; i < n_trackers; ++i)
+	{
+		delete triggers[i];
+		delete bodies[i];
+	}
+
+	return elapsed;
+}
+
+}	// unamed namespace
+
+int main(int argc, char **argv)
+{
+	size_t n_emits = 1000000;
+	size_t n_trackers = 128;
+	size_t n_frames = 10000;
+
+	try
+	{
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h", "produce help message")
+			("emits,e", po::value<size_t>(&n_emits), "number of emits per slot count")
+			("trackers,t", po::value<size_t>(&n_trackers), "number of tracker sensors")
+			("frames,f", po::value<size_t>(&n_frames), "number of tracker frames")
+		;
+
+		po::variables_map vm;
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		po::notify(vm);
+
+		if(vm.count("help"))
+		{
+			std::cout << desc << std::endl;
+			return 0;
+		}
+
+		if(n_emits == 0)
+		{ n_emits = 1; }
+		if(n_frames == 0)
+		{ n_frames = 1; }
+
+		typedef boost::signal<void (int)> BoostIntSignal;
+		typedef vl::Signal<void (int)> IntSignal;
+
+		std::cout << "Emit cost over " << n_emits << " emits." << std::endl;
+		size_t const slot_counts[] = { 0, 1, 4 };
+		Counter counter;
+		for(size_t i = 0; i < sizeof(slot_counts)/sizeof(size_t); ++i)
+		{
+			size_t n = slot_counts[i];
+			double boost_ns = double(time_emits<BoostIntSignal>(n, n_emits, counter))*1e9/n_emits;
+			double vl_ns = double(time_emits<IntSignal>(n, n_emits, counter))*1e9/n_emits;
+			std::cout << n << " slots : boost::signal " << boost_ns << "ns, vl::Signal "
+				<< vl_ns << "ns" << std::endl;
+		}
+
+		typedef boost::signal<void (Transform const &)> BoostTransformSignal;
+		typedef vl::Signal<void (Transform const &)> TransformSignal;
+
+		vl::time boost_frames = time_tracker_frames<BoostTransformSignal>(n_trackers, n_frames);
+		vl::time vl_frames = time_tracker_frames<TransformSignal>(n_trackers, n_frames);
+		std::cout << std::endl << "Tracker frame with " << n_trackers << " sensors over "
+			<< n_frames << " frames." << std::endl
+			<< "boost::signal : " << boost_frames/n_frames << std::endl
+			<< "vl::Signal : " << vl_frames/n_frames << std::endl
+			<< "Speedup : " << double(boost_frames)/double(vl_frames) << std::endl
+			// Keeps the emits from being optimised away
+			<< "Slot calls : " << counter.n << std::endl;
+	}
+	catch(std::exception const &e)
+	{
+		std::cerr << "Exception : " << e.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,177 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file timer_benchmark.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Microbenchmark for the TimeTrigger scheduling.
+ *
+ *	Creates a large number of continuous timers with random intervals and
+ *	runs the frame loop with a fixed frame time. Compares updating every
+ *	timer every frame, which is how EventManager used to update the
+ *	TimeTriggers, against advancing a TimerWheel where only the due timers
+ *	are touched. Both fire the same number of times.
+ *
+ *	Example, 10k timers between 10ms and 10s at 60Hz
+ *	timer_benchmark --timers 10000 --min 10 --max 10000 --frame 16
+ */
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+#include "base/timer_wheel.hpp"
+#include "base/chrono.hpp"
+#include "base/report.hpp"
+
+namespace po = boost::program_options;
+
+namespace
+{
+
+/// Same as the old TimeTrigger::update
+struct LinearTimer
+{
+	LinearTimer(vl::time const &t)
+		: interval(t), n_fired(0)
+	{}
+
+	void update(vl::time const &elapsed_time)
+	{
+		time += elapsed_time;
+		if(time >= interval)
+		{
+			++n_fired;
+			time = vl::time();
+		}
+	}
+
+	vl::time interval;
+	vl::time time;
+	size_t n_fired;
+};
+
+struct WheelTimer : public vl::TimerWheelEntry
+{
+	WheelTimer(vl::TimerWheel *w, vl::time const &t)
+		: wheel(w), interval(vl::to_microseconds(t)), n_fired(0)
+	{ wheel->schedule(this, interval); }
+
+	virtual void _timeout(void)
+	{
+		++n_fired;
+		wheel->schedule(this, wheel->getTime() + interval);
+	}
+
+	vl::TimerWheel *wheel;
+	uint64_t interval;
+	size_t n_fired;
+};
+
+}	// unamed namespace
+
+int main(int argc, char **argv)
+{
+	size_t n_timers = 10000;
+	size_t min_interval = 10;
+	size_t max_interval = 10000;
+	size_t frame_time = 16;
+	size_t n_frames = 10000;
+
+	try
+	{
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h", "produce help message")
+			("timers,t", po::value<size_t>(&n_timers), "number of timers")
+			("min", po::value<size_t>(&min_interval), "minimum timer interval in ms")
+			("max", po::value<size_t>(&max_interval), "maximum timer interval in ms")
+			("frame", po::value<size_t>(&frame_time), "frame time in ms")
+			("frames,f", po::value<size_t>(&n_frames), "number of frames to run")
+		;
+
+		po::variables_map vm;
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		po::notify(vm);
+
+		if(vm.count("help"))
+		{
+			std::cout << desc << std::endl;
+			return 0;
+		}
+
+		if(n_frames == 0)
+		{ n_frames = 1; }
+		if(max_interval < min_interval)
+		{ max_interval = min_interval; }
+
+		vl::TimerWheel wheel;
+		std::vector<LinearTimer> linear;
+		std::vector<WheelTimer *> wheeled;
+		linear.reserve(n_timers);
+		wheeled.reserve(n_timers);
+		std::srand(0);
+		for(size_t i = 0; i < n_timers; ++i)
+		{
+			size_t ms = min_interval + std::rand()%(max_interval - min_interval + 1);
+			vl::time t(ms/1000, 1000*(ms%1000));
+			linear.push_back(LinearTimer(t));
+			wheeled.push_back(new WheelTimer(&wheel, t));
+		}
+
+		std::cout << "Benchmarking " << n_timers << " timers between " << min_interval
+			<< "ms and " << max_interval << "ms for " << n_frames << " frames of "
+			<< frame_time << "ms." << std::endl;
+
+		vl::Report<vl::time> report;
+		vl::time elapsed(frame_time/1000, 1000*(frame_time%1000));
+		vl::time now;
+		size_t n_wheel_fired = 0;
+		for(size_t f = 0; f < n_frames; ++f)
+		{
+			vl::chrono timer;
+			for(size_t i = 0; i < linear.size(); ++i)
+			{ linear[i].update(elapsed); }
+			report["Linear update"].push(timer.elapsed());
+
+			now += elapsed;
+			timer.reset();
+			n_wheel_fired += wheel.advance(vl::to_microseconds(now));
+			report["Timer wheel"].push(timer.elapsed());
+		}
+		report.finish();
+
+		size_t n_linear_fired = 0;
+		size_t n_different = 0;
+		for(size_t i = 0; i < n_timers; ++i)
+		{
+			n_linear_fired += linear[i].n_fired;
+			if(linear[i].n_fired != wheeled[i]->n_fired)
+			{ ++n_different; }
+			delete wheeled[i];
+		}
+
+		std::cout << report << std::endl
+			<< "Fired linear : " << n_linear_fired << std::endl
+			<< "Fired wheel : " << n_wheel_fired << std::endl
+			<< "Timers differing : " << n_different << std::endl;
+	}
+	catch(std::exception const &e)
+	{
+		std::cerr << "Exception : " << e.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
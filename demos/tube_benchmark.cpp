@@ -0,0 +1,249 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file tube_benchmark.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Benchmark for the tube solvers.
+ *
+ *	Hangs a hose between two static bodies above a ground box and
+ *	simulates it with the rigid body chain and with the rod solver
+ *	in separate worlds. Reports the step time and how much the tube
+ *	stretches under it's own weight.
+ *
+ *	Also compares the per frame replication of drawing the tube with
+ *	a SceneNode and Entity per element against a single TubeMesh.
+ *
+ *	Runs without a GameManager so no rendering system is needed.
+ */
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <cmath>
+
+#include "physics/physics_world.hpp"
+#include "physics/rigid_body.hpp"
+#include "physics/shapes.hpp"
+#include "physics/tube.hpp"
+
+#include "scene_manager.hpp"
+#include "scene_node.hpp"
+#include "tube_mesh.hpp"
+
+#include "cluster/session.hpp"
+#include "cluster/message.hpp"
+
+#include "base/chrono.hpp"
+
+namespace po = boost::program_options;
+
+namespace
+{
+
+struct BenchmarkResult
+{
+	BenchmarkResult(void)
+		: max_stretch(0), final_stretch(0)
+	{}
+
+	vl::time step_time;
+	vl::scalar max_stretch;
+	vl::scalar final_stretch;
+};
+
+BenchmarkResult run(vl::physics::TUBE_SOLVER solver, vl::scalar length,
+	vl::scalar element_size, uint32_t iterations, size_t n_frames)
+{
+	vl::physics::WorldRefPtr world = vl::physics::World::create(0);
+
+	// Ground a bit below the lowest point of the hose
+	vl::physics::CollisionShapeRefPtr ground_shape
+		= vl::physics::BoxShape::create(Ogre::Vector3(100, 1, 100));
+	world->createRigidBody("ground", 0,
+		world->createMotionState(vl::Transform(Ogre::Vector3(0, -0.5, 0))), ground_shape);
+
+	// Ends are 3/4 of the length apart
+	vl::physics::CollisionShapeRefPtr end_shape = vl::physics::SphereShape::create(0.1);
+	vl::scalar height = length/2;
+	vl::physics::Tube::ConstructionInfo info;
+	info.start_body = world->createRigidBody("start", 0,
+		world->createMotionState(vl::Transform(Ogre::Vector3(0, height, 0))), end_shape);
+	info.end_body = world->createRigidBody("end", 0,
+		world->createMotionState(vl::Transform(Ogre::Vector3(length*0.75, height, 0))), end_shape);
+	info.length = length;
+	info.radius = 0.05;
+	info.mass_per_meter = 2;
+	info.element_size = element_size;
+	info.solver = solver;
+	info.solver_iterations = iterations;
+
+	vl::physics::TubeRefPtr tube = world->createTubeEx(info);
+	tube->create();
+
+	BenchmarkResult res;
+	for(size_t i = 0; i < n_frames; ++i)
+	{
+		vl::chrono timer;
+		world->step(vl::time(1.0/60));
+		world->finishStep();
+		res.step_time += timer.elapsed();
+
+		res.final_stretch = tube->getStretch();
+		if(res.final_stretch > res.max_stretch)
+		{ res.max_stretch = res.final_stretch; }
+	}
+	res.step_time = res.step_time/n_frames;
+
+	return res;
+}
+
+void print(std::string const &name, BenchmarkResult const &res)
+{
+	std::cout << name << " : step " << res.step_time
+		<< " : stretch " << res.final_stretch*100 << "% (max "
+		<< res.max_stretch*100 << "%)" << std::endl;
+}
+
+/// Positions of a tube swinging around
+void swing(std::vector<vl::Transform> &frames, vl::scalar length, size_t frame)
+{
+	Ogre::Quaternion q(Ogre::Radian(0.01*frame), Ogre::Vector3::UNIT_X);
+	for(size_t i = 0; i < frames.size(); ++i)
+	{
+		frames.at(i).position = q*Ogre::Vector3(0, 0, length*i/frames.size());
+		frames.at(i).quaternion = q;
+	}
+}
+
+size_t pack_frame(vl::Session &session, size_t &n_objects)
+{
+	vl::cluster::Message msg(vl::cluster::MSG_SG_UPDATE, 0, vl::time());
+	n_objects = session.packDirtyObjects(msg);
+	return msg.size();
+}
+
+void compare_replication(size_t n_elements, vl::scalar length, size_t n_frames)
+{
+	std::vector<vl::Transform> frames(n_elements+1);
+
+	// Node and Entity per element
+	size_t element_bytes = 0;
+	size_t element_objects = 0;
+	{
+		vl::Session session;
+		vl::SceneManager scene(&session, vl::MeshManagerRefPtr());
+		std::vector<vl::SceneNodePtr> nodes;
+		for(size_t i = 0; i < n_elements; ++i)
+		{
+			std::stringstream name;
+			name << "tube_element_" << i;
+			vl::SceneNodePtr node = scene.getRootSceneNode()->createChildSceneNode(name.str());
+			node->attachObject(scene.createEntity(name.str(), "tube_element.mesh"));
+			nodes.push_back(node);
+		}
+		// Creation is not part of the per frame update
+		pack_frame(session, element_objects);
+
+		for(size_t f = 0; f < n_frames; ++f)
+		{
+			swing(frames, length, f);
+			for(size_t i = 0; i < nodes.size(); ++i)
+			{ nodes.at(i)->setWorldTransform(frames.at(i)); }
+
+			size_t n_objects = 0;
+			element_bytes += pack_frame(session, n_objects);
+			element_objects += n_objects;
+		}
+	}
+
+	// Single TubeMesh
+	size_t mesh_bytes = 0;
+	size_t mesh_objects = 0;
+	{
+		vl::Session session;
+		vl::SceneManager scene(&session, vl::MeshManagerRefPtr());
+		vl::SceneNodePtr node = scene.getRootSceneNode()->createChildSceneNode("tube");
+		vl::TubeMeshPtr mesh = scene.createDynamicTubeMesh("tube", "BaseWhite");
+		node->attachObject(mesh);
+		pack_frame(session, mesh_objects);
+		mesh_objects = 0;
+
+		for(size_t f = 0; f < n_frames; ++f)
+		{
+			swing(frames, length, f);
+			mesh->setFrames(frames);
+
+			size_t n_objects = 0;
+			mesh_bytes += pack_frame(session, n_objects);
+			mesh_objects += n_objects;
+		}
+	}
+
+	std::cout << "Node per element : " << n_elements << " batches : "
+		<< element_objects/n_frames << " objects and "
+		<< element_bytes/n_frames << " bytes per frame." << std::endl
+		<< "Tube mesh : 1 batch : " << mesh_objects/n_frames << " objects and "
+		<< mesh_bytes/n_frames << " bytes per frame." << std::endl;
+}
+
+}	// unamed namespace
+
+int main(int argc, char **argv)
+{
+	vl::scalar length = 20;
+	vl::scalar element_size = 0.1;
+	uint32_t iterations = 8;
+	size_t n_frames = 600;
+
+	try
+	{
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h", "produce help message")
+			("length,l", po::value<vl::scalar>(&length), "length of the tube in meters")
+			("element_size,e", po::value<vl::scalar>(&element_size), "length of a tube element")
+			("iterations,i", po::value<uint32_t>(&iterations), "rod solver iterations")
+			("frames,f", po::value<size_t>(&n_frames), "number of frames to run")
+		;
+
+		po::variables_map vm;
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		po::notify(vm);
+
+		if(vm.count("help"))
+		{
+			std::cout << desc << std::endl;
+			return 0;
+		}
+
+		if(n_frames == 0)
+		{ n_frames = 1; }
+
+		std::cout << "Benchmarking a " << length << "m tube with "
+			<< std::ceil(length/element_size) << " elements for "
+			<< n_frames << " frames." << std::endl;
+
+		print("Rigid body chain", run(vl::physics::TS_RIGID_BODIES, length, element_size, iterations, n_frames));
+		print("Rod solver", run(vl::physics::TS_ROD, length, element_size, iterations, n_frames));
+
+		compare_replication(std::ceil(length/element_size), length, n_frames);
+	}
+	catch(std::exception const &e)
+	{
+		std::cerr << "Exception : " << e.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
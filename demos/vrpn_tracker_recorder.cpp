@@ -2,6 +2,7 @@
  *	@date 2011-04
  *
  *	@update 2011-07 - Extended for recording large sequenzes of VRPN data
+ *	@update 2014-06 - Added binary recording of every sample at full rate
  */
 
 /// @todo add tracker element with time support
@@ -9,6 +10,10 @@
 #include "base/chrono.hpp"
 #include "base/sleep.hpp"
 
+// Binary recording format
+#include "input/recording.hpp"
+#include "math/conversion.hpp"
+
 #include <vrpn_Tracker.h>
 #include <quat.h>
 
@@ -27,6 +32,7 @@ struct options
 {
 	options(void)
 		: file("default.log")
+		, binary(false)
 	{}
 
 	bool parseOptions( int argc, char **argv )
@@ -38,6 +44,7 @@ struct options
 			("file,f", po::value<std::string>(&file)->default_value("vrpn_record.log"), "file to log")
 			("samples,s", po::value<int>(&samples)->default_value(0), "Samples to gather before exiting. Use zero for inifinite.")
 			("frequenzy", po::value<double>(&frequenzy)->default_value(60.0), "The frequenzy which to gather samples. Valid values greater than zero.")
+			("binary,b", "Write every sample at full rate to a binary recording that can be replayed with Hydra. Frequenzy is only used for polling.")
 		;
 
 		// Parse command line
@@ -72,6 +79,8 @@ struct options
 			frequenzy = vm["frequenzy"].as<double>();
 		}
 
+		binary = vm.count("binary") > 0;
+
 		// Needs to be greater than zero
 		frequenzy = frequenzy > 0 ? frequenzy : 1.0;
 
@@ -82,6 +91,7 @@ struct options
 	std::string file;
 	int samples;
 	double frequenzy;
+	bool binary;
 };
 
 struct sensor_elem
@@ -151,6 +161,17 @@ void VRPN_CALLBACK handle_tracker(void *userdata, const vrpn_TRACKERCB t)
 	d->add_sensor_data(t.sensor, t.pos, t.quat);
 }
 
+/// @brief VRPN callback handler for binary recording
+/// Every sample is written as it arrives so the recording is full rate.
+void VRPN_CALLBACK handle_tracker_binary(void *userdata, const vrpn_TRACKERCB t)
+{
+	assert(userdata);
+	vl::RecordingWriter *rec = (vl::RecordingWriter *)userdata;
+
+	vl::Transform trans(vl::math::convert_vec(t.pos), vl::math::convert_quat(t.quat));
+	rec->writeTracker(0, (uint16_t)t.sensor, trans);
+}
+
 void mainloop(vrpn_Tracker_Remote *tkr, uint32_t sleep_time)
 {
 	// Purge all of the old reports
@@ -159,6 +180,26 @@ void mainloop(vrpn_Tracker_Remote *tkr, uint32_t sleep_time)
 	vl::msleep(sleep_time);
 }
 
+int record_binary(vrpn_Tracker_Remote *tkr, options const &opt, uint32_t sleep_time)
+{
+	vl::RecordingWriter rec(opt.file);
+	tkr->register_change_handler((void *)&rec, handle_tracker_binary);
+
+	// Samples is the number of records in binary mode
+	while(opt.samples <= 0 || rec.getNRecords() < (uint64_t)opt.samples)
+	{
+		mainloop(tkr, sleep_time);
+	}
+
+	tkr->unregister_change_handler((void *)&rec, handle_tracker_binary);
+	rec.close();
+
+	std::cout << "Wrote " << rec.getNRecords() << " samples, "
+		<< rec.getBytesWritten() << " bytes." << std::endl;
+
+	return 0;
+}
+
 int main(int argc, char **argv)
 {
 	options opt;
@@ -181,6 +222,21 @@ int main(int argc, char **argv)
 	std::cout << "Connecting to tracker " << opt.tracker << std::endl;
 	vrpn_Tracker_Remote* tkr = new vrpn_Tracker_Remote(opt.tracker.c_str());
 
+	// Sleep time in milliseconds
+	uint32_t sleep_time = 1;
+	double st = (double)(1000)/opt.frequenzy;
+	if(st < 0)
+	{ std::cerr << "ERROR: can not sleep negative time!" << std::endl; }
+	else
+	{ sleep_time = (uint32_t)st; }
+
+	if(opt.binary)
+	{
+		int ret = record_binary(tkr, opt, sleep_time);
+		delete tkr;
+		return ret;
+	}
+
 	// Set up the tracker callback handler
 	data d;
 	tkr->register_change_handler((void *)&d, handle_tracker);
@@ -202,14 +258,6 @@ int main(int argc, char **argv)
 
 	g_timer.reset();
 
-	// Sleep time in milliseconds
-	uint32_t sleep_time = 1;
-	double st = (double)(1000)/opt.frequenzy;
-	if(st < 0)
-	{ std::cerr << "ERROR: can not sleep negative time!" << std::endl; }
-	else
-	{ sleep_time = (uint32_t)st; }
-
 	if(opt.samples > 0)
 	{
 		int count = 0;
@@ -474,9 +474,19 @@ BOOST_PYTHON_MODULE(pyogre)
 		.def(self_ns::str(self_ns::self))
 	;
 
+	class_<vl::MeshEncodingSettings>("MeshEncodingSettings")
+		.def_readwrite("quantize_positions", &vl::MeshEncodingSettings::quantize_positions)
+		.def_readwrite("quantize_normals", &vl::MeshEncodingSettings::quantize_normals)
+		.def_readwrite("half_texcoords", &vl::MeshEncodingSettings::half_texcoords)
+		.def_readwrite("compress", &vl::MeshEncodingSettings::compress)
+		.def("compact", &vl::MeshEncodingSettings::compact)
+		.staticmethod("compact")
+	;
+
 	class_<vl::MeshSerializer, boost::noncopyable>("MeshSerializer")
 		.def("createMesh", &vl::MeshSerializer::createMesh)
 		.def("writeMesh", &vl::MeshSerializer::writeMesh)
+		.add_property("encoding", make_function( &vl::MeshSerializer::getEncoding, return_value_policy<copy_const_reference>() ), &vl::MeshSerializer::setEncoding )
 	;
 
 }
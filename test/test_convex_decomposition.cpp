@@ -0,0 +1,276 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file test/test_convex_decomposition.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE convex_decomposition
+
+#include <boost/test/unit_test.hpp>
+
+/// tested functions
+#include "physics/convex_decomposition.hpp"
+/// Reading the mesh positions
+#include "mesh_optimizer.hpp"
+
+#include "base/filesystem.hpp"
+
+#include <limits>
+#include <iostream>
+#include <algorithm>
+
+namespace
+{
+
+std::vector<Ogre::Vector3>
+create_box_points(Ogre::Vector3 const &min, Ogre::Vector3 const &max)
+{
+	std::vector<Ogre::Vector3> points;
+	for(size_t i = 0; i < 8; ++i)
+	{
+		points.push_back(Ogre::Vector3(i & 1 ? max.x : min.x,
+			i & 2 ? max.y : min.y, i & 4 ? max.z : min.z));
+	}
+	return points;
+}
+
+/// @brief how deep the point is inside the hull
+/// negative if the point is outside
+Ogre::Real
+hull_depth(std::vector<Ogre::Vector3> const &points, std::vector<uint32_t> const &triangles,
+	Ogre::Vector3 const &p)
+{
+	Ogre::Real depth = std::numeric_limits<Ogre::Real>::max();
+	for(size_t i = 0; i+2 < triangles.size(); i += 3)
+	{
+		Ogre::Vector3 const &a = points[triangles[i]];
+		Ogre::Vector3 n = (points[triangles[i+1]] - a).crossProduct(points[triangles[i+2]] - a);
+		n.normalise();
+		depth = std::min(depth, n.dotProduct(a - p));
+	}
+	return depth;
+}
+
+/// @brief hull is closed, every edge is shared by two triangles in opposite directions
+bool
+hull_closed(std::vector<uint32_t> const &triangles)
+{
+	std::vector< std::pair<uint32_t, uint32_t> > edges;
+	for(size_t i = 0; i+2 < triangles.size(); i += 3)
+	{
+		for(size_t k = 0; k < 3; ++k)
+		{ edges.push_back(std::make_pair(triangles[i+k], triangles[i+(k+1)%3])); }
+	}
+	std::sort(edges.begin(), edges.end());
+	if(std::adjacent_find(edges.begin(), edges.end()) != edges.end())
+	{ return false; }
+	for(size_t i = 0; i < edges.size(); ++i)
+	{
+		if(!std::binary_search(edges.begin(), edges.end(), std::make_pair(edges[i].second, edges[i].first)))
+		{ return false; }
+	}
+	return true;
+}
+
+/// L shaped prism in a single SubMesh using shared geometry,
+/// the missing corner is [1, 2] x [1, 2]
+struct LShapeFixture
+{
+	LShapeFixture(void)
+		: mesh("l_shape")
+	{
+		// Outline counter clockwise seen from +z
+		Ogre::Real const outline[6][2] = { {0, 0}, {2, 0}, {2, 1}, {1, 1}, {1, 2}, {0, 2} };
+		std::vector<Ogre::Vector3> positions;
+		for(size_t i = 0; i < 6; ++i)
+		{
+			positions.push_back(Ogre::Vector3(outline[i][0], outline[i][1], 0));
+			positions.push_back(Ogre::Vector3(outline[i][0], outline[i][1], 1));
+		}
+
+		vl::SubMesh *sm = mesh.createSubMesh();
+		// Caps as two convex quads
+		uint32_t const quads[2][4] = { {0, 1, 2, 3}, {0, 3, 4, 5} };
+		for(size_t i = 0; i < 2; ++i)
+		{
+			uint32_t const *q = quads[i];
+			sm->addFace(2*q[0], 2*q[2], 2*q[1]);
+			sm->addFace(2*q[0], 2*q[3], 2*q[2]);
+			sm->addFace(2*q[0]+1, 2*q[1]+1, 2*q[2]+1);
+			sm->addFace(2*q[0]+1, 2*q[2]+1, 2*q[3]+1);
+		}
+		// Walls
+		for(uint32_t i = 0; i < 6; ++i)
+		{
+			uint32_t j = (i+1) % 6;
+			sm->addFace(2*i, 2*j, 2*j+1);
+			sm->addFace(2*i, 2*j+1, 2*i+1);
+		}
+
+		mesh.sharedVertexData = new vl::VertexData;
+		mesh.sharedVertexData->vertexDeclaration.addElement(0, 0, Ogre::VET_FLOAT3, Ogre::VES_POSITION);
+		vl::VertexBufferRefPtr buf = vl::VertexBuffer::create(3*sizeof(float), positions.size());
+		for(size_t i = 0; i < positions.size(); ++i)
+		{
+			float pos[3] = { positions[i].x, positions[i].y, positions[i].z };
+			buf->write(i*sizeof(pos), pos, sizeof(pos));
+		}
+		mesh.sharedVertexData->setBinding(0, buf);
+	}
+
+	~LShapeFixture(void)
+	{ delete mesh.sharedVertexData; }
+
+	vl::Mesh mesh;
+};
+
+}	// unamed namespace
+
+BOOST_AUTO_TEST_CASE(convex_hull_cube)
+{
+	std::vector<Ogre::Vector3> points = create_box_points(Ogre::Vector3(-1, -1, -1), Ogre::Vector3(1, 1, 1));
+	// Interior point is not part of the hull
+	points.push_back(Ogre::Vector3(0.25, -0.5, 0));
+
+	std::vector<uint32_t> triangles;
+	BOOST_REQUIRE(vl::physics::compute_convex_hull(points, triangles));
+	BOOST_CHECK_EQUAL(triangles.size(), 12*3u);
+	BOOST_CHECK(hull_closed(triangles));
+	BOOST_CHECK(std::find(triangles.begin(), triangles.end(), 8u) == triangles.end());
+
+	// Counter clockwise from outside, so all the points are behind the faces
+	for(size_t i = 0; i < points.size(); ++i)
+	{ BOOST_CHECK_GE(hull_depth(points, triangles, points[i]), -1e-5); }
+	BOOST_CHECK_CLOSE(hull_depth(points, triangles, Ogre::Vector3::ZERO), 1.0f, 1e-3);
+	BOOST_CHECK_LT(hull_depth(points, triangles, Ogre::Vector3(1.5, 0, 0)), 0);
+}
+
+BOOST_AUTO_TEST_CASE(convex_hull_tetrahedron)
+{
+	std::vector<Ogre::Vector3> points;
+	points.push_back(Ogre::Vector3(0, 0, 0));
+	points.push_back(Ogre::Vector3(1, 0, 0));
+	points.push_back(Ogre::Vector3(0, 1, 0));
+	points.push_back(Ogre::Vector3(0, 0, 1));
+
+	std::vector<uint32_t> triangles;
+	BOOST_REQUIRE(vl::physics::compute_convex_hull(points, triangles));
+	BOOST_CHECK_EQUAL(triangles.size(), 4*3u);
+	BOOST_CHECK(hull_closed(triangles));
+
+	Ogre::Vector3 centre(0.25, 0.25, 0.25);
+	BOOST_CHECK_GT(hull_depth(points, triangles, centre), 0);
+	BOOST_CHECK_LT(hull_depth(points, triangles, Ogre::Vector3(1, 1, 1)), 0);
+}
+
+BOOST_AUTO_TEST_CASE(convex_hull_degenerate)
+{
+	std::vector<uint32_t> triangles;
+	std::vector<Ogre::Vector3> points;
+	BOOST_CHECK(!vl::physics::compute_convex_hull(points, triangles));
+
+	points.push_back(Ogre::Vector3(0, 0, 0));
+	points.push_back(Ogre::Vector3(1, 0, 0));
+	points.push_back(Ogre::Vector3(0, 1, 0));
+	BOOST_CHECK(!vl::physics::compute_convex_hull(points, triangles));
+	BOOST_CHECK(triangles.empty());
+
+	// Coplanar
+	points.push_back(Ogre::Vector3(1, 1, 0));
+	points.push_back(Ogre::Vector3(0.5, 2, 0));
+	BOOST_CHECK(!vl::physics::compute_convex_hull(points, triangles));
+	BOOST_CHECK(triangles.empty());
+
+	// Collinear
+	points.clear();
+	for(size_t i = 0; i < 5; ++i)
+	{ points.push_back(Ogre::Vector3(float(i), 2.0f*i, -float(i))); }
+	BOOST_CHECK(!vl::physics::compute_convex_hull(points, triangles));
+	BOOST_CHECK(triangles.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(decompose_l_shape, LShapeFixture)
+{
+	vl::physics::ConvexDecompositionSettings settings;
+	vl::physics::ConvexDecomposition decomposition;
+	vl::physics::decompose_convex(mesh, settings, decomposition);
+
+	BOOST_CHECK_EQUAL(decomposition.hash, vl::physics::hash_convex_decomposition(mesh, settings));
+	for(size_t i = 0; i < decomposition.hulls.size(); ++i){ std::cerr << "hull " << i << ":"; for(size_t j=0;j<decomposition.hulls[i].size();++j) std::cerr << " (" << decomposition.hulls[i][j].x << "," << decomposition.hulls[i][j].y << "," << decomposition.hulls[i][j].z << ")"; std::cerr << std::endl;}
+	BOOST_REQUIRE_GT(decomposition.hulls.size(), 1u);
+	BOOST_CHECK_LE(decomposition.hulls.size(), settings.max_hulls);
+
+	// bounding box diagonal is 3
+	Ogre::Real max_concavity = settings.max_concavity*3;
+	// Cell size of the vertex clustering
+	Ogre::Real tolerance = 2.0f/settings.resolution;
+
+	std::vector< std::vector<uint32_t> > hull_triangles(decomposition.hulls.size());
+	for(size_t i = 0; i < decomposition.hulls.size(); ++i)
+	{
+		BOOST_CHECK_LE(decomposition.hulls[i].size(), settings.max_hull_vertices);
+		BOOST_REQUIRE(vl::physics::compute_convex_hull(decomposition.hulls[i], hull_triangles[i]));
+	}
+
+	// Missing corner is not filled by any of the hulls
+	Ogre::Vector3 corner(1.75, 1.75, 0.5);
+	for(size_t i = 0; i < decomposition.hulls.size(); ++i)
+	{ BOOST_CHECK_LE(hull_depth(decomposition.hulls[i], hull_triangles[i], corner), max_concavity); }
+
+	// Every vertex of the mesh is covered by a hull
+	std::vector<Ogre::Vector3> positions;
+	BOOST_REQUIRE(vl::read_positions(*mesh.sharedVertexData, positions));
+	for(size_t j = 0; j < positions.size(); ++j)
+	{
+		Ogre::Real depth = -std::numeric_limits<Ogre::Real>::max();
+		for(size_t i = 0; i < decomposition.hulls.size(); ++i)
+		{ depth = std::max(depth, hull_depth(decomposition.hulls[i], hull_triangles[i], positions[j])); }
+		BOOST_CHECK_GE(depth, -tolerance);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(decompose_empty)
+{
+	vl::Mesh mesh("empty");
+	vl::physics::ConvexDecomposition decomposition;
+	vl::physics::decompose_convex(mesh, vl::physics::ConvexDecompositionSettings(), decomposition);
+	BOOST_CHECK(decomposition.hulls.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(cache_round_trip, LShapeFixture)
+{
+	vl::physics::ConvexDecomposition decomposition;
+	vl::physics::decompose_convex(mesh, vl::physics::ConvexDecompositionSettings(), decomposition);
+
+	fs::path file = fs::temp_directory_path() / fs::unique_path("%%%%-%%%%-%%%%.hulls");
+	BOOST_REQUIRE(vl::physics::write_convex_decomposition(file.string(), decomposition));
+
+	vl::physics::ConvexDecomposition read;
+	BOOST_CHECK(vl::physics::read_convex_decomposition(file.string(), read));
+	BOOST_CHECK_EQUAL(read.hash, decomposition.hash);
+	BOOST_REQUIRE_EQUAL(read.hulls.size(), decomposition.hulls.size());
+	for(size_t i = 0; i < read.hulls.size(); ++i)
+	{ BOOST_CHECK(read.hulls[i] == decomposition.hulls[i]); }
+
+	// Truncated file is not a valid cache
+	fs::resize_file(file, fs::file_size(file) - 1);
+	vl::physics::ConvexDecomposition truncated;
+	BOOST_CHECK(!vl::physics::read_convex_decomposition(file.string(), truncated));
+	BOOST_CHECK(truncated.hulls.empty());
+
+	fs::remove(file);
+	BOOST_CHECK(!vl::physics::read_convex_decomposition(file.string(), truncated));
+
+	BOOST_CHECK_EQUAL(vl::physics::get_convex_decomposition_cache("models/box.mesh"), "models/box.hulls");
+}
@@ -0,0 +1,163 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file test/test_frame_allocations.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Steady state frames of the master scene graph distribution must not
+ *	allocate. Runs the same steps as Master for the scene graph:
+ *	transforms are changed, dirty objects packed to the reused update
+ *	message, the message split into the reused parts and dumped to the
+ *	reused send buffer.
+ *
+ *	Allocations are only counted when HydraMain is built with
+ *	HYDRA_TRACK_ALLOCATIONS, otherwise only the frame loop is run.
+ */
+
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE frame_allocations
+
+#include <boost/test/unit_test.hpp>
+
+/// tested class
+#include "base/allocation_tracker.hpp"
+#include "base/frame_arena.hpp"
+
+#include "scene_manager.hpp"
+#include "scene_node.hpp"
+
+#include "cluster/session.hpp"
+#include "cluster/message.hpp"
+
+#include <sstream>
+#include <cmath>
+
+namespace
+{
+
+size_t const N_NODES = 200;
+size_t const N_WARM_UP = 10;
+size_t const N_FRAMES = 100;
+
+struct MasterFixture
+{
+	MasterFixture(void)
+		: scene(&session, vl::MeshManagerRefPtr())
+		, frame(0)
+	{
+		for(size_t i = 0; i < N_NODES; ++i)
+		{
+			std::stringstream ss;
+			ss << "node_" << i;
+			vl::SceneNodePtr parent = nodes.empty()
+				? scene.getRootSceneNode() : nodes.at(i/4);
+			nodes.push_back(parent->createChildSceneNode(ss.str()));
+		}
+		session.clearNewObjects();
+	}
+
+	/// @brief same steps as Master::_createMsgUpdate and Server::sendUpdate
+	void runFrame(void)
+	{
+		++frame;
+		{
+			vl::AllocationScope scope(vl::AS_SCENE_GRAPH);
+			for(size_t i = 0; i < nodes.size(); i += 2)
+			{
+				vl::Transform t(nodes.at(i)->getTransform());
+				t.position.y = std::sin(vl::scalar(frame + i));
+				nodes.at(i)->setTransform(t);
+			}
+		}
+
+		{
+			vl::AllocationScope scope(vl::AS_NETWORK);
+			update.reset(vl::cluster::MSG_SG_UPDATE, frame, vl::time());
+			session.packDirtyObjects(update);
+			update.createParts(parts);
+			for(size_t i = 0; i < parts.size(); ++i)
+			{ parts.at(i).dump(buffer); }
+		}
+	}
+
+	void finishFrame(vl::AllocationTracker &tracker)
+	{
+		tracker.finishFrame();
+		vl::FrameArena::frame().reset();
+	}
+
+	vl::Session session;
+	vl::SceneManager scene;
+	std::vector<vl::SceneNodePtr> nodes;
+
+	uint32_t frame;
+	vl::cluster::Message update;
+	std::vector<vl::cluster::MessagePart> parts;
+	std::vector<char> buffer;
+};
+
+size_t
+frame_allocations(vl::AllocationTracker const &tracker)
+{
+	size_t n = 0;
+	for(size_t i = 0; i < vl::AS_SIZE; ++i)
+	{ n += tracker.getFrameCount(vl::ALLOC_SUBSYSTEM(i)).allocations; }
+	return n;
+}
+
+}	// unamed namespace
+
+BOOST_FIXTURE_TEST_CASE(master_update_no_allocations, MasterFixture)
+{
+	vl::AllocationTracker tracker;
+	tracker.setEnabled(true);
+
+	for(size_t i = 0; i < N_WARM_UP; ++i)
+	{
+		runFrame();
+		finishFrame(tracker);
+	}
+
+	if(!vl::AllocationTracker::isAvailable())
+	{ BOOST_TEST_MESSAGE("Allocations not counted, build with HYDRA_TRACK_ALLOCATIONS."); }
+
+	for(size_t i = 0; i < N_FRAMES; ++i)
+	{
+		runFrame();
+		BOOST_CHECK(update.size() > 0);
+		BOOST_CHECK_EQUAL(frame_allocations(tracker), 0u);
+		finishFrame(tracker);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(frame_arena_reused, MasterFixture)
+{
+	vl::AllocationTracker tracker;
+	tracker.setEnabled(true);
+
+	for(size_t i = 0; i < N_WARM_UP; ++i)
+	{
+		runFrame();
+		finishFrame(tracker);
+	}
+
+	size_t n_blocks = vl::FrameArena::frame().getNHeapAllocations();
+	for(size_t i = 0; i < N_FRAMES; ++i)
+	{
+		runFrame();
+		finishFrame(tracker);
+	}
+	BOOST_CHECK_EQUAL(vl::FrameArena::frame().getNHeapAllocations(), n_blocks);
+	BOOST_CHECK_EQUAL(vl::FrameArena::frame().getUsed(), 0u);
+}
@@ -0,0 +1,95 @@
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE frame_arena
+
+#include <boost/test/unit_test.hpp>
+
+/// tested class
+#include "base/frame_arena.hpp"
+
+#include <vector>
+#include <stdint.h>
+
+BOOST_AUTO_TEST_CASE(allocate_and_reset)
+{
+	vl::FrameArena arena(1024);
+	BOOST_CHECK_EQUAL(arena.getNHeapAllocations(), 1u);
+
+	void *a = arena.allocate(10);
+	void *b = arena.allocate(1);
+	BOOST_CHECK(a != b);
+	BOOST_CHECK_EQUAL((size_t)a % vl::FrameArena::ALIGNMENT, 0u);
+	BOOST_CHECK_EQUAL((size_t)b % vl::FrameArena::ALIGNMENT, 0u);
+	BOOST_CHECK_EQUAL(arena.getUsed(), 2*vl::FrameArena::ALIGNMENT);
+
+	arena.reset();
+	BOOST_CHECK_EQUAL(arena.getUsed(), 0u);
+	// Memory is reused after reset
+	BOOST_CHECK_EQUAL(arena.allocate(10), a);
+	BOOST_CHECK_EQUAL(arena.getNHeapAllocations(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(grow_to_fit_frame)
+{
+	vl::FrameArena arena(1024);
+
+	// Overflows the first block
+	for(size_t i = 0; i < 10; ++i)
+	{ arena.allocate(512); }
+	BOOST_CHECK(arena.getNHeapAllocations() > 1);
+	BOOST_CHECK_EQUAL(arena.getUsed(), 10*512u);
+
+	// Blocks are merged on reset so the same frame fits in one block
+	arena.reset();
+	size_t n_allocations = arena.getNHeapAllocations();
+	BOOST_CHECK(arena.getCapacity() >= 10*512u);
+
+	for(size_t frame = 0; frame < 5; ++frame)
+	{
+		for(size_t i = 0; i < 10; ++i)
+		{ arena.allocate(512); }
+		arena.reset();
+	}
+	BOOST_CHECK_EQUAL(arena.getNHeapAllocations(), n_allocations);
+}
+
+BOOST_AUTO_TEST_CASE(large_allocation)
+{
+	vl::FrameArena arena(64);
+
+	char *mem = (char *)arena.allocate(10000);
+	// Writable through the whole range
+	mem[0] = 1;
+	mem[9999] = 2;
+	BOOST_CHECK(arena.getCapacity() >= 10000u + 64u);
+}
+
+BOOST_AUTO_TEST_CASE(container_allocator)
+{
+	vl::FrameArena arena(1024);
+	typedef std::vector<uint64_t, vl::ArenaAllocator<uint64_t> > IDList;
+
+	{
+		IDList ids((vl::ArenaAllocator<uint64_t>(arena)));
+		for(uint64_t i = 0; i < 1000; ++i)
+		{ ids.push_back(i); }
+
+		BOOST_CHECK_EQUAL(ids.size(), 1000u);
+		BOOST_CHECK_EQUAL(ids.back(), 999u);
+		BOOST_CHECK(arena.getUsed() >= 1000*sizeof(uint64_t));
+	}
+
+	arena.reset();
+	size_t n_allocations = arena.getNHeapAllocations();
+
+	// Steady state frames don't allocate from the heap
+	for(size_t frame = 0; frame < 5; ++frame)
+	{
+		IDList ids((vl::ArenaAllocator<uint64_t>(arena)));
+		for(uint64_t i = 0; i < 1000; ++i)
+		{ ids.push_back(i); }
+		arena.reset();
+	}
+	BOOST_CHECK_EQUAL(arena.getNHeapAllocations(), n_allocations);
+}
@@ -0,0 +1,116 @@
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE mesh_cache
+
+#include <boost/test/unit_test.hpp>
+
+/// tested class
+#include "cluster/mesh_cache.hpp"
+
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+
+struct CacheFixture
+{
+	CacheFixture(void)
+		: dir(fs::temp_directory_path() / fs::unique_path("hydra_mesh_cache_%%%%%%"))
+	{}
+
+	~CacheFixture(void)
+	{ fs::remove_all(dir); }
+
+	fs::path dir;
+};
+
+char const MESH_DATA[] = "serialized mesh data";
+
+}	// unamed namespace
+
+BOOST_FIXTURE_TEST_CASE(store_and_load, CacheFixture)
+{
+	vl::cluster::MeshCache cache(dir.string());
+	BOOST_CHECK_EQUAL(cache.getHash("box.mesh"), 0u);
+
+	cache.store("box.mesh", 0x1234, MESH_DATA, sizeof(MESH_DATA));
+	BOOST_CHECK_EQUAL(cache.getHash("box.mesh"), 0x1234u);
+	BOOST_CHECK_EQUAL(cache.getMisses(), 1u);
+
+	std::vector<char> data;
+	BOOST_REQUIRE(cache.load(0x1234, data));
+	BOOST_REQUIRE_EQUAL(data.size(), sizeof(MESH_DATA));
+	BOOST_CHECK(std::memcmp(&data[0], MESH_DATA, sizeof(MESH_DATA)) == 0);
+	BOOST_CHECK_EQUAL(cache.getHits(), 1u);
+	BOOST_CHECK_EQUAL(cache.getBytesSaved(), sizeof(MESH_DATA));
+
+	BOOST_CHECK(!cache.load(0x4321, data));
+}
+
+BOOST_FIXTURE_TEST_CASE(index_is_persistent, CacheFixture)
+{
+	{
+		vl::cluster::MeshCache cache(dir.string());
+		cache.store("hose element.mesh", 0xffffffff00000001ULL, MESH_DATA, sizeof(MESH_DATA));
+		cache.store("box.mesh", 0x10, MESH_DATA, sizeof(MESH_DATA));
+		cache.remove("box.mesh");
+	}
+
+	vl::cluster::MeshCache cache(dir.string());
+	BOOST_CHECK_EQUAL(cache.getHash("hose element.mesh"), 0xffffffff00000001ULL);
+	BOOST_CHECK_EQUAL(cache.getHash("box.mesh"), 0u);
+
+	std::vector<char> data;
+	BOOST_CHECK(cache.load(0xffffffff00000001ULL, data));
+}
+
+BOOST_FIXTURE_TEST_CASE(corrupted_file_is_a_miss, CacheFixture)
+{
+	vl::cluster::MeshCache cache(dir.string());
+	cache.store("box.mesh", 0x1234, MESH_DATA, sizeof(MESH_DATA));
+
+	fs::path file;
+	for(fs::directory_iterator iter(dir); iter != fs::directory_iterator(); ++iter)
+	{
+		BOOST_CHECK(iter->path().extension() != ".tmp");
+		if(iter->path().extension() == ".mesh_data")
+		{ file = iter->path(); }
+	}
+	BOOST_REQUIRE(!file.empty());
+
+	// Truncated
+	fs::resize_file(file, fs::file_size(file) - 1);
+	std::vector<char> data;
+	BOOST_CHECK(!cache.load(0x1234, data));
+
+	// Same length with different data
+	cache.store("box.mesh", 0x1234, MESH_DATA, sizeof(MESH_DATA));
+	{
+		std::fstream f(file.string().c_str(), std::ios::binary | std::ios::in | std::ios::out);
+		f.seekp(-2, std::ios::end);
+		f.put('x');
+	}
+	BOOST_CHECK(!cache.load(0x1234, data));
+
+	// File for another hash
+	fs::path other = dir / "0000000000004321.mesh_data";
+	fs::copy_file(file, other);
+	BOOST_CHECK(!cache.load(0x4321, data));
+
+	BOOST_CHECK_EQUAL(cache.getHits(), 0u);
+}
+
+BOOST_FIXTURE_TEST_CASE(index_written_on_request, CacheFixture)
+{
+	vl::cluster::MeshCache cache(dir.string());
+	cache.store("box.mesh", 0x10, MESH_DATA, sizeof(MESH_DATA));
+	BOOST_CHECK(!fs::exists(dir / "index"));
+
+	cache.writeIndex();
+	BOOST_CHECK(fs::exists(dir / "index"));
+
+	vl::cluster::MeshCache other(dir.string());
+	BOOST_CHECK_EQUAL(other.getHash("box.mesh"), 0x10u);
+}
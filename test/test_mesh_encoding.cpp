@@ -0,0 +1,208 @@
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE mesh_encoding
+
+#include <boost/test/unit_test.hpp>
+
+/// tested functions
+#include "mesh_encoding.hpp"
+
+#include "base/exceptions.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+
+namespace
+{
+
+/// Interleaved test vertex, position, normal and uv
+struct Vertex
+{
+	float position[3];
+	float normal[3];
+	float uv[2];
+};
+
+std::vector<Vertex> create_grid(size_t n)
+{
+	std::vector<Vertex> vertices;
+	for(size_t i = 0; i < n; ++i)
+	{
+		for(size_t j = 0; j < n; ++j)
+		{
+			float u = float(i)/(n-1);
+			float v = float(j)/(n-1);
+			float z = std::sin(u*6.0f)*std::cos(v*4.0f);
+
+			Vertex vert;
+			vert.position[0] = 10.0f*u - 3.0f;
+			vert.position[1] = 5.0f*v;
+			vert.position[2] = z;
+			float nx = -6.0f*std::cos(u*6.0f)*std::cos(v*4.0f)/10.0f;
+			float ny = 4.0f*std::sin(u*6.0f)*std::sin(v*4.0f)/5.0f;
+			float len = std::sqrt(nx*nx + ny*ny + 1.0f);
+			vert.normal[0] = nx/len;
+			vert.normal[1] = ny/len;
+			vert.normal[2] = (i%2 ? -1.0f : 1.0f)/len;
+			vert.uv[0] = u;
+			vert.uv[1] = 1.0f - v;
+			vertices.push_back(vert);
+		}
+	}
+	return vertices;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( half_float )
+{
+	float values[] = { 0.0f, -0.0f, 1.0f, -2.5f, 0.333333f, 65504.0f, 6.1035156e-05f, 5.9604645e-08f };
+	for(size_t i = 0; i < sizeof(values)/sizeof(values[0]); ++i)
+	{
+		float f = vl::half_to_float(vl::float_to_half(values[i]));
+		BOOST_CHECK_CLOSE(f + 1.0f, values[i] + 1.0f, 0.1);
+	}
+
+	// All half values that are not NaN convert back exactly
+	for(uint32_t h = 0; h < 0x10000; ++h)
+	{
+		if((h & 0x7c00) == 0x7c00 && (h & 0x3ff))
+		{ continue; }
+		BOOST_CHECK_EQUAL(vl::float_to_half(vl::half_to_float((uint16_t)h)), h);
+	}
+
+	BOOST_CHECK_EQUAL(vl::float_to_half(1e10f), 0x7c00);
+}
+
+BOOST_AUTO_TEST_CASE( octahedral_normals )
+{
+	std::vector<Vertex> vertices = create_grid(64);
+	for(size_t i = 0; i < vertices.size(); ++i)
+	{
+		int16_t q[2];
+		vl::encode_octahedral(vertices[i].normal, q);
+		float n[3];
+		vl::decode_octahedral(q, n);
+
+		// About 0.005 degree precision
+		for(size_t j = 0; j < 3; ++j)
+		{ BOOST_CHECK_SMALL(n[j] - vertices[i].normal[j], 1e-4f); }
+	}
+}
+
+BOOST_AUTO_TEST_CASE( quantized_vertex_streams )
+{
+	std::vector<Vertex> vertices = create_grid(50);
+	uint8_t const *src = (uint8_t const *)&vertices[0];
+	size_t n = vertices.size();
+
+	std::vector<Vertex> decoded(n);
+	uint8_t *dst = (uint8_t *)&decoded[0];
+
+	vl::VertexStream streams[3] = {
+		vl::VertexStream(0, 12, vl::VSE_POSITION_UNORM16),
+		vl::VertexStream(12, 12, vl::VSE_NORMAL_OCT16),
+		vl::VertexStream(24, 8, vl::VSE_HALF) };
+
+	size_t encoded_size = 0;
+	for(size_t i = 0; i < 3; ++i)
+	{
+		std::vector<uint8_t> data;
+		vl::encode_vertex_stream(streams[i], src, sizeof(Vertex), n, data);
+		BOOST_REQUIRE_EQUAL(data.size(), n*streams[i].getEncodedSize());
+		encoded_size += data.size();
+		vl::decode_vertex_stream(streams[i], &data[0], dst, sizeof(Vertex), n);
+	}
+	BOOST_CHECK_EQUAL(encoded_size, n*14);
+
+	for(size_t i = 0; i < n; ++i)
+	{
+		// Bounding box is 10 x 5 x 2
+		BOOST_CHECK_SMALL(decoded[i].position[0] - vertices[i].position[0], 10.0f/65535);
+		BOOST_CHECK_SMALL(decoded[i].position[1] - vertices[i].position[1], 5.0f/65535);
+		BOOST_CHECK_SMALL(decoded[i].position[2] - vertices[i].position[2], 2.0f/65535);
+		for(size_t j = 0; j < 3; ++j)
+		{ BOOST_CHECK_SMALL(decoded[i].normal[j] - vertices[i].normal[j], 1e-3f); }
+		for(size_t j = 0; j < 2; ++j)
+		{ BOOST_CHECK_SMALL(decoded[i].uv[j] - vertices[i].uv[j], 1e-3f); }
+	}
+}
+
+BOOST_AUTO_TEST_CASE( vertex_compression_lossless )
+{
+	std::vector<Vertex> vertices = create_grid(101);
+	uint8_t const *src = (uint8_t const *)&vertices[0];
+	size_t n = vertices.size();
+
+	std::vector<uint8_t> compressed;
+	vl::compress_vertex_stream(src, n, sizeof(Vertex), compressed);
+
+	std::vector<Vertex> decoded(n);
+	vl::decompress_vertex_stream(&compressed[0], compressed.size(), n, sizeof(Vertex), (uint8_t *)&decoded[0]);
+	BOOST_CHECK(::memcmp(&decoded[0], src, n*sizeof(Vertex)) == 0);
+	BOOST_CHECK_LT(compressed.size(), n*sizeof(Vertex)*3/4);
+
+	// Quantized data compresses too
+	vl::VertexStream position(0, 12, vl::VSE_POSITION_UNORM16);
+	std::vector<uint8_t> quantized;
+	vl::encode_vertex_stream(position, src, sizeof(Vertex), n, quantized);
+	vl::compress_vertex_stream(&quantized[0], n, position.getEncodedSize(), compressed);
+	BOOST_CHECK_LT(compressed.size(), quantized.size()*3/4);
+
+	std::vector<uint8_t> decompressed(quantized.size());
+	vl::decompress_vertex_stream(&compressed[0], compressed.size(), n, position.getEncodedSize(), &decompressed[0]);
+	BOOST_CHECK(decompressed == quantized);
+
+	// Sizes that are not multiples of the group size and random data
+	for(size_t count = 0; count < 40; ++count)
+	{
+		std::vector<uint8_t> data(count*3);
+		for(size_t i = 0; i < data.size(); ++i)
+		{ data[i] = (uint8_t)(std::rand() >> (i%8)); }
+
+		vl::compress_vertex_stream(data.empty() ? 0 : &data[0], count, 3, compressed);
+		std::vector<uint8_t> out(data.size());
+		vl::decompress_vertex_stream(&compressed[0], compressed.size(), count, 3, out.empty() ? 0 : &out[0]);
+		BOOST_CHECK(out == data);
+	}
+
+	// Truncated data is detected
+	vl::compress_vertex_stream(src, n, sizeof(Vertex), compressed);
+	BOOST_CHECK_THROW(vl::decompress_vertex_stream(&compressed[0], compressed.size()/2, n, sizeof(Vertex), (uint8_t *)&decoded[0]), vl::exception);
+}
+
+BOOST_AUTO_TEST_CASE( index_compression_lossless )
+{
+	// Triangle list for a grid
+	size_t const N = 100;
+	std::vector<uint32_t> indices;
+	for(uint32_t i = 0; i+1 < N; ++i)
+	{
+		for(uint32_t j = 0; j+1 < N; ++j)
+		{
+			uint32_t a = i*N + j;
+			indices.push_back(a);
+			indices.push_back(a+1);
+			indices.push_back(a+N);
+			indices.push_back(a+1);
+			indices.push_back(a+N+1);
+			indices.push_back(a+N);
+		}
+	}
+	// Large jumps both ways
+	indices.push_back(0xffffffff);
+	indices.push_back(0);
+	indices.push_back(0x80000000);
+
+	std::vector<uint8_t> compressed;
+	vl::compress_index_stream(&indices[0], indices.size(), compressed);
+	BOOST_CHECK_LT(compressed.size(), indices.size()*sizeof(uint32_t)/2);
+
+	std::vector<uint32_t> decoded(indices.size());
+	vl::decompress_index_stream(&compressed[0], compressed.size(), decoded.size(), &decoded[0]);
+	BOOST_CHECK(decoded == indices);
+
+	BOOST_CHECK_THROW(vl::decompress_index_stream(&compressed[0], compressed.size()-1, decoded.size(), &decoded[0]), vl::exception);
+}
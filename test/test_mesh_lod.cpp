@@ -0,0 +1,195 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file test/test_mesh_lod.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE mesh_lod
+
+#include <boost/test/unit_test.hpp>
+
+/// tested functions
+#include "mesh_lod.hpp"
+
+#include "base/exceptions.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+size_t const GRID_SIZE = 20;
+
+/// Open grid of GRID_SIZE x GRID_SIZE quads, counter clockwise from +z
+struct GridFixture
+{
+	GridFixture(void)
+	{
+		size_t n = GRID_SIZE;
+		for(size_t i = 0; i <= n; ++i)
+		{
+			for(size_t j = 0; j <= n; ++j)
+			{
+				Ogre::Real h = 0.5f*std::sin(0.3f*i)*std::cos(0.4f*j);
+				positions.push_back(Ogre::Vector3(Ogre::Real(i), Ogre::Real(j), h));
+			}
+		}
+
+		for(uint32_t i = 0; i < n; ++i)
+		{
+			for(uint32_t j = 0; j < n; ++j)
+			{
+				uint32_t a = uint32_t(i*(n+1) + j);
+				uint32_t b = uint32_t(a + n + 1);
+				uint32_t const quad[6] = { a, b, b+1, a, b+1, a+1 };
+				indices.insert(indices.end(), quad, quad+6);
+			}
+		}
+	}
+
+	/// @brief both vertices are on the same side of the grid
+	bool onSameSide(uint32_t a, uint32_t b) const
+	{
+		Ogre::Vector3 const &p = positions.at(a);
+		Ogre::Vector3 const &q = positions.at(b);
+		return (p.x == 0 && q.x == 0) || (p.y == 0 && q.y == 0)
+			|| (p.x == GRID_SIZE && q.x == GRID_SIZE) || (p.y == GRID_SIZE && q.y == GRID_SIZE);
+	}
+
+	Ogre::Vector3 normal(std::vector<uint32_t> const &tris, size_t i) const
+	{
+		Ogre::Vector3 const &a = positions.at(tris.at(i));
+		return (positions.at(tris.at(i+1)) - a).crossProduct(positions.at(tris.at(i+2)) - a);
+	}
+
+	std::vector<Ogre::Vector3> positions;
+	std::vector<uint32_t> indices;
+};
+
+vl::VertexData *
+create_vertex_data(std::vector<Ogre::Vector3> const &positions)
+{
+	vl::VertexData *data = new vl::VertexData;
+	data->vertexDeclaration.addElement(0, 0, Ogre::VET_FLOAT3, Ogre::VES_POSITION);
+	vl::VertexBufferRefPtr buf = vl::VertexBuffer::create(3*sizeof(float), positions.size());
+	for(size_t i = 0; i < positions.size(); ++i)
+	{
+		float pos[3] = { positions[i].x, positions[i].y, positions[i].z };
+		buf->write(i*sizeof(pos), pos, sizeof(pos));
+	}
+	data->setBinding(0, buf);
+	return data;
+}
+
+}	// unamed namespace
+
+BOOST_FIXTURE_TEST_CASE(simplify_target_count, GridFixture)
+{
+	size_t target = indices.size()/4;
+	std::vector<uint32_t> out = vl::simplify_triangles(indices, positions, target);
+
+	BOOST_CHECK_EQUAL(out.size() % 3, 0u);
+	BOOST_CHECK_LE(out.size(), target);
+	BOOST_CHECK_GT(out.size(), 0u);
+	for(size_t i = 0; i < out.size(); i += 3)
+	{
+		BOOST_CHECK_LT(out[i], positions.size());
+		BOOST_CHECK(out[i] != out[i+1] && out[i+1] != out[i+2] && out[i] != out[i+2]);
+	}
+
+	// Nothing to remove
+	std::vector<uint32_t> same = vl::simplify_triangles(indices, positions, indices.size());
+	BOOST_CHECK_EQUAL(same.size(), indices.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(simplify_no_flipped_faces, GridFixture)
+{
+	std::vector<uint32_t> out = vl::simplify_triangles(indices, positions, indices.size()/10);
+	BOOST_REQUIRE(!out.empty());
+
+	// Height field faces up everywhere so a collapse must not turn a face over
+	for(size_t i = 0; i < out.size(); i += 3)
+	{ BOOST_CHECK_GT(normal(out, i).z, 0); }
+}
+
+BOOST_FIXTURE_TEST_CASE(simplify_preserves_borders, GridFixture)
+{
+	std::vector<uint32_t> out = vl::simplify_triangles(indices, positions, indices.size()/10);
+	BOOST_REQUIRE(!out.empty());
+
+	std::vector< std::pair<uint32_t, uint32_t> > edges;
+	for(size_t i = 0; i < out.size(); i += 3)
+	{
+		for(size_t k = 0; k < 3; ++k)
+		{ edges.push_back(std::make_pair(out[i+k], out[i+(k+1)%3])); }
+	}
+	std::sort(edges.begin(), edges.end());
+
+	// Open edges are only along the sides of the grid
+	for(size_t i = 0; i < edges.size(); ++i)
+	{
+		uint32_t a = edges[i].first;
+		uint32_t b = edges[i].second;
+		if(!std::binary_search(edges.begin(), edges.end(), std::make_pair(b, a)))
+		{ BOOST_CHECK(onSameSide(a, b)); }
+	}
+
+	// Corners are kept
+	uint32_t const n = GRID_SIZE;
+	uint32_t const corners[4] = { 0, n, n*(n+1), (n+1)*(n+1)-1 };
+	for(size_t i = 0; i < 4; ++i)
+	{ BOOST_CHECK(std::find(out.begin(), out.end(), corners[i]) != out.end()); }
+}
+
+BOOST_FIXTURE_TEST_CASE(simplify_max_error, GridFixture)
+{
+	// Bumps are higher than the error so only a little can be removed
+	std::vector<uint32_t> limited = vl::simplify_triangles(indices, positions, 0, 0.01);
+	std::vector<uint32_t> unlimited = vl::simplify_triangles(indices, positions, indices.size()/10);
+	BOOST_CHECK_GT(limited.size(), unlimited.size());
+	BOOST_CHECK_LE(limited.size(), indices.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(generate_levels, GridFixture)
+{
+	vl::Mesh mesh("grid");
+	mesh.sharedVertexData = create_vertex_data(positions);
+	vl::SubMesh *sm = mesh.createSubMesh();
+	for(size_t i = 0; i < indices.size(); i += 3)
+	{ sm->addFace(indices[i], indices[i+1], indices[i+2]); }
+
+	vl::MeshLodSettings settings;
+	vl::generate_lod_levels(mesh, settings);
+
+	BOOST_CHECK_EQUAL(mesh.getLodStrategy(), settings.strategy);
+	BOOST_REQUIRE_EQUAL(sm->lodIndexData.size(), settings.reductions.size());
+	size_t prev = sm->indexData.indexCount();
+	for(size_t l = 0; l < sm->lodIndexData.size(); ++l)
+	{
+		size_t count = sm->lodIndexData.at(l).indexCount();
+		BOOST_CHECK_LE(count, size_t(settings.reductions.at(l)*indices.size()/3)*3);
+		BOOST_CHECK_LT(count, prev);
+		prev = count;
+	}
+
+	// Generating again replaces the levels
+	vl::generate_lod_levels(mesh, settings);
+	BOOST_CHECK_EQUAL(sm->lodIndexData.size(), settings.reductions.size());
+
+	settings.screen_sizes.pop_back();
+	BOOST_CHECK_THROW(vl::generate_lod_levels(mesh, settings), vl::invalid_param);
+
+	delete mesh.sharedVertexData;
+}
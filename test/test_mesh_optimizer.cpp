@@ -0,0 +1,439 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file test/test_mesh_optimizer.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE mesh_optimizer
+
+#include <boost/test/unit_test.hpp>
+
+/// tested functions
+#include "mesh_optimizer.hpp"
+
+#include "base/exceptions.hpp"
+
+#include <algorithm>
+
+namespace
+{
+
+size_t const GRID_SIZE = 20;
+
+/// Triangle as the positions of its corners, for comparing triangles
+/// after the vertices have been remapped
+typedef std::vector<float> TriangleKey;
+
+vl::VertexData *
+create_vertex_data(std::vector<Ogre::Vector3> const &positions)
+{
+	vl::VertexData *data = new vl::VertexData;
+	data->vertexDeclaration.addElement(0, 0, Ogre::VET_FLOAT3, Ogre::VES_POSITION);
+	vl::VertexBufferRefPtr buf = vl::VertexBuffer::create(3*sizeof(float), positions.size());
+	for(size_t i = 0; i < positions.size(); ++i)
+	{
+		float pos[3] = { positions[i].x, positions[i].y, positions[i].z };
+		buf->write(i*sizeof(pos), pos, sizeof(pos));
+	}
+	data->setBinding(0, buf);
+	return data;
+}
+
+/// Heights are exact in float so that the weld tolerance doesn't split them
+Ogre::Vector3
+grid_position(size_t i, size_t j)
+{ return Ogre::Vector3(float(i), float(j), 0.25f*float((i*j) % 4)); }
+
+/// Mesh with a single SubMesh using shared geometry
+struct MeshFixture
+{
+	MeshFixture(void)
+		: mesh("test")
+	{
+		sub_mesh = mesh.createSubMesh();
+	}
+
+	~MeshFixture(void)
+	{ delete mesh.sharedVertexData; }
+
+	/// @brief create a bumpy grid of GRID_SIZE x GRID_SIZE quads
+	/// @param weld false gives every triangle its own vertices
+	/// @param jitter moves the duplicated vertices at most this much
+	/// Triangles are in a scrambled order so that there is something to optimize.
+	void createGrid(bool weld, float jitter = 0)
+	{
+		size_t n = GRID_SIZE;
+		std::vector<Ogre::Vector3> positions;
+		std::vector<uint32_t> indices;
+		for(size_t i = 0; i < n; ++i)
+		{
+			for(size_t j = 0; j < n; ++j)
+			{
+				size_t quad[4][2] = { {i, j}, {i+1, j}, {i+1, j+1}, {i, j+1} };
+				size_t corners[6] = { 0, 1, 2, 0, 2, 3 };
+				for(size_t k = 0; k < 6; ++k)
+				{
+					size_t const *c = quad[corners[k]];
+					if(weld)
+					{ indices.push_back(uint32_t(c[0]*(n+1) + c[1])); }
+					else
+					{
+						Ogre::Vector3 pos = grid_position(c[0], c[1]);
+						if(jitter > 0)
+						{
+							float d = jitter*((positions.size()%3) - 1.0f);
+							pos += Ogre::Vector3(d, -d, d);
+						}
+						positions.push_back(pos);
+						indices.push_back(uint32_t(positions.size()-1));
+					}
+				}
+			}
+		}
+
+		if(weld)
+		{
+			for(size_t i = 0; i <= n; ++i)
+			{
+				for(size_t j = 0; j <= n; ++j)
+				{ positions.push_back(grid_position(i, j)); }
+			}
+		}
+
+		// Stride is coprime with the number of triangles so every one is used
+		size_t n_tris = indices.size()/3;
+		for(size_t k = 0; k < n_tris; ++k)
+		{
+			size_t t = (k*97) % n_tris;
+			sub_mesh->addFace(indices[3*t], indices[3*t+1], indices[3*t+2]);
+		}
+
+		mesh.sharedVertexData = create_vertex_data(positions);
+	}
+
+	std::vector<uint32_t> const &indices(void) const
+	{ return sub_mesh->indexData.getVec(); }
+
+	size_t vertexCount(void) const
+	{ return mesh.sharedVertexData->getVertexCount(); }
+
+	/// @brief all indices are in range and form whole triangles
+	bool indicesValid(void) const
+	{
+		if(indices().size() % 3 != 0)
+		{ return false; }
+		for(size_t i = 0; i < indices().size(); ++i)
+		{
+			if(indices()[i] >= vertexCount())
+			{ return false; }
+		}
+		return true;
+	}
+
+	/// @return triangles in the current order
+	std::vector<TriangleKey> triangles(void) const
+	{
+		std::vector<Ogre::Vector3> positions;
+		vl::read_positions(*mesh.sharedVertexData, positions);
+
+		std::vector<TriangleKey> tris;
+		for(size_t i = 0; i+2 < indices().size(); i += 3)
+		{
+			TriangleKey key;
+			for(size_t k = 0; k < 3; ++k)
+			{
+				Ogre::Vector3 const &p = positions.at(indices()[i+k]);
+				key.push_back(p.x);
+				key.push_back(p.y);
+				key.push_back(p.z);
+			}
+			tris.push_back(key);
+		}
+		return tris;
+	}
+
+	std::vector<TriangleKey> sortedTriangles(void) const
+	{
+		std::vector<TriangleKey> tris = triangles();
+		std::sort(tris.begin(), tris.end());
+		return tris;
+	}
+
+	vl::Mesh mesh;
+	vl::SubMesh *sub_mesh;
+};
+
+vl::MeshOptimizerSettings
+no_passes(void)
+{
+	vl::MeshOptimizerSettings settings;
+	settings.weld_vertices = false;
+	settings.optimize_vertex_cache = false;
+	settings.optimize_overdraw = false;
+	settings.optimize_vertex_fetch = false;
+	return settings;
+}
+
+}	// unamed namespace
+
+BOOST_FIXTURE_TEST_CASE(weld_removes_duplicates, MeshFixture)
+{
+	createGrid(false);
+	std::vector<TriangleKey> tris = triangles();
+
+	vl::MeshOptimizerSettings settings = no_passes();
+	settings.weld_vertices = true;
+	vl::MeshOptimizerReport report = vl::optimize_mesh(mesh, settings);
+
+	BOOST_CHECK_EQUAL(report.vertices_before, 6*GRID_SIZE*GRID_SIZE);
+	BOOST_CHECK_EQUAL(report.vertices_after, (GRID_SIZE+1)*(GRID_SIZE+1));
+	BOOST_CHECK_EQUAL(report.triangles_after, report.triangles_before);
+	BOOST_CHECK_LT(report.bytes_after, report.bytes_before);
+	BOOST_CHECK(indicesValid());
+	// Welding doesn't change the triangle order
+	BOOST_CHECK(triangles() == tris);
+}
+
+BOOST_FIXTURE_TEST_CASE(weld_tolerance, MeshFixture)
+{
+	createGrid(false, 1e-4f);
+
+	vl::MeshOptimizerSettings settings = no_passes();
+	settings.weld_vertices = true;
+	vl::MeshOptimizerReport report = vl::optimize_mesh(mesh, settings);
+	// Only exact duplicates are welded without a tolerance
+	BOOST_CHECK_GT(report.vertices_after, (GRID_SIZE+1)*(GRID_SIZE+1));
+	BOOST_CHECK(indicesValid());
+
+	settings.weld_tolerance = 1e-2f;
+	report = vl::optimize_mesh(mesh, settings);
+	BOOST_CHECK_EQUAL(report.vertices_after, (GRID_SIZE+1)*(GRID_SIZE+1));
+	BOOST_CHECK_EQUAL(report.triangles_after, 2*GRID_SIZE*GRID_SIZE);
+	BOOST_CHECK(indicesValid());
+}
+
+BOOST_FIXTURE_TEST_CASE(weld_removes_degenerate_triangles, MeshFixture)
+{
+	createGrid(true);
+	// Degenerate by index
+	sub_mesh->addFace(0, 0, 1);
+	sub_mesh->addFace(2, 3, 3);
+
+	vl::MeshOptimizerSettings settings = no_passes();
+	settings.weld_vertices = true;
+	vl::MeshOptimizerReport report = vl::optimize_mesh(mesh, settings);
+	BOOST_CHECK_EQUAL(report.triangles_before, 2*GRID_SIZE*GRID_SIZE + 2);
+	BOOST_CHECK_EQUAL(report.triangles_after, 2*GRID_SIZE*GRID_SIZE);
+	BOOST_CHECK(indicesValid());
+}
+
+BOOST_FIXTURE_TEST_CASE(weld_removes_collapsed_triangles, MeshFixture)
+{
+	createGrid(false);
+	// Vertices 0 and 3 are the first corner of the first quad and 2 and 4
+	// the third, separate vertices at the same position collapse when welded
+	sub_mesh->addFace(0, 3, 1);
+	sub_mesh->addFace(2, 4, 5);
+
+	vl::MeshOptimizerSettings settings = no_passes();
+	settings.weld_vertices = true;
+	vl::MeshOptimizerReport report = vl::optimize_mesh(mesh, settings);
+	BOOST_CHECK_EQUAL(report.triangles_after, 2*GRID_SIZE*GRID_SIZE);
+	BOOST_CHECK(indicesValid());
+}
+
+BOOST_FIXTURE_TEST_CASE(vertex_cache, MeshFixture)
+{
+	createGrid(true);
+	std::vector<TriangleKey> tris = sortedTriangles();
+
+	vl::MeshOptimizerSettings settings = no_passes();
+	settings.optimize_vertex_cache = true;
+	vl::MeshOptimizerReport report = vl::optimize_mesh(mesh, settings);
+
+	BOOST_CHECK_EQUAL(report.vertices_after, report.vertices_before);
+	BOOST_CHECK_EQUAL(report.triangles_after, report.triangles_before);
+	BOOST_CHECK_LT(report.acmr_after, report.acmr_before);
+	BOOST_CHECK_CLOSE(report.acmr_after, vl::calculate_acmr(mesh, settings.cache_size), 1e-6);
+	BOOST_CHECK(indicesValid());
+	BOOST_CHECK(sortedTriangles() == tris);
+
+	// Optimizing again doesn't make it worse
+	double acmr = report.acmr_after;
+	report = vl::optimize_mesh(mesh, settings);
+	BOOST_CHECK_LE(report.acmr_after, acmr);
+	BOOST_CHECK(indicesValid());
+}
+
+BOOST_AUTO_TEST_CASE(vertex_cache_degenerate_and_empty)
+{
+	std::vector<uint32_t> indices;
+	vl::optimize_vertex_cache(indices, 0);
+	BOOST_CHECK(indices.empty());
+	BOOST_CHECK_EQUAL(vl::calculate_acmr(indices, 16), 0);
+
+	// Degenerate triangles are kept as they are, welding removes them
+	uint32_t tris[] = { 0, 1, 2, 2, 2, 3, 1, 3, 2, 4, 4, 4 };
+	indices.assign(tris, tris + sizeof(tris)/sizeof(tris[0]));
+	vl::optimize_vertex_cache(indices, 5);
+	BOOST_REQUIRE_EQUAL(indices.size(), sizeof(tris)/sizeof(tris[0]));
+	BOOST_CHECK(*std::max_element(indices.begin(), indices.end()) < 5);
+	std::vector<uint32_t> sorted(indices);
+	std::vector<uint32_t> expected(tris, tris + sizeof(tris)/sizeof(tris[0]));
+	std::sort(sorted.begin(), sorted.end());
+	std::sort(expected.begin(), expected.end());
+	BOOST_CHECK(sorted == expected);
+}
+
+BOOST_FIXTURE_TEST_CASE(overdraw, MeshFixture)
+{
+	createGrid(true);
+	std::vector<TriangleKey> tris = sortedTriangles();
+
+	vl::MeshOptimizerSettings settings = no_passes();
+	settings.optimize_vertex_cache = true;
+	settings.optimize_overdraw = true;
+	vl::MeshOptimizerReport report = vl::optimize_mesh(mesh, settings);
+
+	BOOST_CHECK_EQUAL(report.triangles_after, report.triangles_before);
+	BOOST_CHECK_LT(report.acmr_after, report.acmr_before);
+	BOOST_CHECK(indicesValid());
+	BOOST_CHECK(sortedTriangles() == tris);
+}
+
+BOOST_FIXTURE_TEST_CASE(overdraw_without_positions, MeshFixture)
+{
+	createGrid(true);
+	mesh.sharedVertexData->vertexDeclaration.getElements().clear();
+	std::vector<uint32_t> before = indices();
+
+	vl::MeshOptimizerSettings settings = no_passes();
+	settings.optimize_overdraw = true;
+	vl::optimize_mesh(mesh, settings);
+	BOOST_CHECK(indices() == before);
+}
+
+BOOST_FIXTURE_TEST_CASE(vertex_fetch, MeshFixture)
+{
+	createGrid(true);
+	std::vector<TriangleKey> tris = triangles();
+
+	vl::MeshOptimizerSettings settings = no_passes();
+	settings.optimize_vertex_fetch = true;
+	vl::MeshOptimizerReport report = vl::optimize_mesh(mesh, settings);
+
+	BOOST_CHECK_EQUAL(report.vertices_after, report.vertices_before);
+	BOOST_CHECK_CLOSE(report.acmr_after, report.acmr_before, 1e-6);
+	BOOST_CHECK(indicesValid());
+	BOOST_CHECK(triangles() == tris);
+
+	// Vertices are in the order they are first used
+	uint32_t next = 0;
+	for(size_t i = 0; i < indices().size(); ++i)
+	{
+		BOOST_REQUIRE_LE(indices()[i], next);
+		if(indices()[i] == next)
+		{ ++next; }
+	}
+	BOOST_CHECK_EQUAL(next, vertexCount());
+}
+
+BOOST_FIXTURE_TEST_CASE(vertex_fetch_removes_unused, MeshFixture)
+{
+	createGrid(true);
+	// Drop the triangles using the first corner
+	std::vector<uint32_t> &i = sub_mesh->indexData.getVec();
+	std::vector<uint32_t> kept;
+	for(size_t t = 0; t+2 < i.size(); t += 3)
+	{
+		if(i[t] != 0 && i[t+1] != 0 && i[t+2] != 0)
+		{ kept.insert(kept.end(), i.begin()+t, i.begin()+t+3); }
+	}
+	i.swap(kept);
+	std::vector<TriangleKey> tris = triangles();
+
+	vl::MeshOptimizerSettings settings = no_passes();
+	settings.optimize_vertex_fetch = true;
+	vl::MeshOptimizerReport report = vl::optimize_mesh(mesh, settings);
+
+	BOOST_CHECK_LT(report.vertices_after, report.vertices_before);
+	BOOST_CHECK_EQUAL(*std::max_element(indices().begin(), indices().end())+1, vertexCount());
+	BOOST_CHECK(indicesValid());
+	BOOST_CHECK(triangles() == tris);
+}
+
+BOOST_FIXTURE_TEST_CASE(all_passes, MeshFixture)
+{
+	createGrid(false);
+	std::vector<TriangleKey> tris = sortedTriangles();
+
+	vl::MeshOptimizerReport report = vl::optimize_mesh(mesh);
+
+	BOOST_CHECK_EQUAL(report.vertices_after, (GRID_SIZE+1)*(GRID_SIZE+1));
+	BOOST_CHECK_EQUAL(report.triangles_after, report.triangles_before);
+	BOOST_CHECK_LE(report.acmr_after, report.acmr_before);
+	BOOST_CHECK_LT(report.bytes_after, report.bytes_before);
+	BOOST_CHECK(indicesValid());
+	BOOST_CHECK(sortedTriangles() == tris);
+}
+
+BOOST_AUTO_TEST_CASE(empty_meshes)
+{
+	// No SubMeshes
+	vl::Mesh mesh("empty");
+	vl::MeshOptimizerReport report = vl::optimize_mesh(mesh);
+	BOOST_CHECK_EQUAL(report.vertices_after, 0u);
+	BOOST_CHECK_EQUAL(report.triangles_after, 0u);
+	BOOST_CHECK_EQUAL(report.acmr_after, 0);
+
+	// SubMesh without indices and with no vertices
+	vl::SubMesh *sm = mesh.createSubMesh();
+	sm->useSharedGeometry = false;
+	sm->vertexData = create_vertex_data(std::vector<Ogre::Vector3>());
+	BOOST_CHECK_NO_THROW(report = vl::optimize_mesh(mesh));
+	BOOST_CHECK_EQUAL(report.triangles_after, 0u);
+	BOOST_CHECK_EQUAL(report.acmr_after, 0);
+
+	// Vertices but no indices, all of them are unused
+	std::vector<Ogre::Vector3> positions(3, Ogre::Vector3::UNIT_X);
+	delete sm->vertexData;
+	sm->vertexData = create_vertex_data(positions);
+	BOOST_CHECK_NO_THROW(report = vl::optimize_mesh(mesh));
+	BOOST_CHECK_EQUAL(report.vertices_after, 0u);
+	BOOST_CHECK(sm->indexData.getVec().empty());
+
+	delete sm->vertexData;
+}
+
+BOOST_FIXTURE_TEST_CASE(all_degenerate, MeshFixture)
+{
+	std::vector<Ogre::Vector3> positions(4, Ogre::Vector3::UNIT_Y);
+	mesh.sharedVertexData = create_vertex_data(positions);
+	sub_mesh->addFace(0, 1, 2);
+	sub_mesh->addFace(1, 2, 3);
+
+	vl::MeshOptimizerReport report;
+	BOOST_CHECK_NO_THROW(report = vl::optimize_mesh(mesh));
+	BOOST_CHECK_EQUAL(report.triangles_after, 0u);
+	BOOST_CHECK_EQUAL(report.vertices_after, 0u);
+	BOOST_CHECK_EQUAL(report.acmr_after, 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(index_out_of_range, MeshFixture)
+{
+	createGrid(true);
+	sub_mesh->addFace(0, 1, uint32_t(vertexCount()));
+
+	BOOST_CHECK_THROW(vl::optimize_mesh(mesh), vl::bad_index);
+}
@@ -0,0 +1,145 @@
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE recording
+
+#include <boost/test/unit_test.hpp>
+
+/// tested class
+#include "input/recording.hpp"
+
+#include <cstdio>
+
+namespace
+{
+
+vl::Record create_tracker_record(uint32_t i)
+{
+	vl::Record rec;
+	rec.type = vl::RT_TRACKER;
+	rec.time = vl::time(i/1000, (i%1000)*1000);
+	rec.tracker = i%3;
+	rec.sensor = i%5;
+	// Values that are not exactly representable so we test bit exactness
+	rec.transform.position = Ogre::Vector3(i*0.1f, -(float)i/3.0f, 1.0f/(i+1));
+	rec.transform.quaternion = Ogre::Quaternion(Ogre::Radian(i*0.01f), Ogre::Vector3::UNIT_Y);
+	return rec;
+}
+
+vl::Record create_can_record(uint32_t i)
+{
+	vl::Record rec;
+	rec.type = vl::RT_CAN;
+	rec.time = vl::time(i/1000, (i%1000)*1000);
+	rec.can_id = 0x380 + i%4;
+	rec.can_length = 8;
+	for(uint8_t j = 0; j < 8; ++j)
+	{ rec.can_data[j] = (uint8_t)(i+j); }
+	return rec;
+}
+
+std::string const FILE_NAME("test_recording.hrec");
+
+}
+
+BOOST_AUTO_TEST_CASE( write_read_bit_exact )
+{
+	size_t const N = 20000;
+	{
+		// Small chunks so we get many of them
+		vl::RecordingWriter writer(FILE_NAME, 4096);
+		for(uint32_t i = 0; i < N; ++i)
+		{
+			if(i%7 == 0)
+			{ writer.write(create_can_record(i)); }
+			else
+			{ writer.write(create_tracker_record(i)); }
+		}
+		BOOST_CHECK_EQUAL( writer.getNRecords(), N );
+	}
+
+	vl::RecordingReader reader(FILE_NAME);
+	BOOST_CHECK( !reader.isIndexRecovered() );
+	BOOST_CHECK_GT( reader.getNChunks(), 1u );
+	BOOST_CHECK_EQUAL( reader.getNRecords(), N );
+
+	vl::Record rec;
+	for(uint32_t i = 0; i < N; ++i)
+	{
+		BOOST_REQUIRE( reader.next(rec) );
+		if(i%7 == 0)
+		{
+			vl::Record ref = create_can_record(i);
+			BOOST_CHECK_EQUAL( rec.type, vl::RT_CAN );
+			BOOST_CHECK_EQUAL( rec.can_id, ref.can_id );
+			BOOST_CHECK( ::memcmp(rec.can_data, ref.can_data, 8) == 0 );
+		}
+		else
+		{
+			vl::Record ref = create_tracker_record(i);
+			BOOST_CHECK_EQUAL( rec.type, vl::RT_TRACKER );
+			BOOST_CHECK_EQUAL( rec.time, ref.time );
+			BOOST_CHECK_EQUAL( rec.sensor, ref.sensor );
+			BOOST_CHECK( ::memcmp(&rec.transform.position, &ref.transform.position, sizeof(Ogre::Vector3)) == 0 );
+			BOOST_CHECK( ::memcmp(&rec.transform.quaternion, &ref.transform.quaternion, sizeof(Ogre::Quaternion)) == 0 );
+		}
+	}
+	BOOST_CHECK( !reader.next(rec) );
+
+	std::remove(FILE_NAME.c_str());
+}
+
+BOOST_AUTO_TEST_CASE( seek )
+{
+	size_t const N = 10000;
+	{
+		vl::RecordingWriter writer(FILE_NAME, 1024);
+		for(uint32_t i = 0; i < N; ++i)
+		{ writer.write(create_tracker_record(i)); }
+	}
+
+	vl::RecordingReader reader(FILE_NAME);
+
+	vl::Record rec;
+	reader.seek(vl::time(5, 500000));
+	BOOST_REQUIRE( reader.next(rec) );
+	BOOST_CHECK_EQUAL( rec.time, vl::time(5, 500000) );
+
+	// Between samples
+	reader.seek(vl::time(2, 1500));
+	BOOST_REQUIRE( reader.next(rec) );
+	BOOST_CHECK_EQUAL( rec.time, vl::time(2, 2000) );
+
+	reader.rewind();
+	BOOST_REQUIRE( reader.next(rec) );
+	BOOST_CHECK_EQUAL( rec.time, vl::time() );
+
+	reader.seek(vl::time(100, 0));
+	BOOST_CHECK( !reader.next(rec) );
+
+	std::remove(FILE_NAME.c_str());
+}
+
+BOOST_AUTO_TEST_CASE( recover_missing_index )
+{
+	size_t const N = 5000;
+	{
+		vl::RecordingWriter writer(FILE_NAME, 1024);
+		for(uint32_t i = 0; i < N; ++i)
+		{ writer.write(create_tracker_record(i)); }
+		// Simulate a crash by writing the chunks but not the index
+		writer.flush();
+
+		// Copy the file before the writer is closed
+		std::ifstream src(FILE_NAME.c_str(), std::ios::binary);
+		std::ofstream dst("test_recording_crash.hrec", std::ios::binary);
+		dst << src.rdbuf();
+	}
+
+	vl::RecordingReader reader("test_recording_crash.hrec");
+	BOOST_CHECK( reader.isIndexRecovered() );
+	BOOST_CHECK_EQUAL( reader.getNRecords(), N );
+
+	std::remove(FILE_NAME.c_str());
+	std::remove("test_recording_crash.hrec");
+}
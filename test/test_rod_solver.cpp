@@ -0,0 +1,109 @@
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE rod_solver
+
+#include <boost/test/unit_test.hpp>
+
+/// tested functions
+#include "physics/rod_solver.hpp"
+
+#include "base/exceptions.hpp"
+
+namespace
+{
+
+/// Infinite ground plane at y = 0
+class PlaneCollider : public vl::physics::RodCollider
+{
+public :
+	virtual bool sweepSphere(Ogre::Vector3 const &from, Ogre::Vector3 const &to,
+		vl::scalar radius, vl::physics::RodContact &contact)
+	{
+		if(to.y >= radius)
+		{ return false; }
+
+		contact.fraction = from.y > radius ? (from.y - radius)/(from.y - to.y) : 0;
+		Ogre::Vector3 center = from + (to - from)*contact.fraction;
+		contact.point = Ogre::Vector3(center.x, 0, center.z);
+		contact.normal = Ogre::Vector3::UNIT_Y;
+		return true;
+	}
+};
+
+std::vector<Ogre::Vector3> create_line(Ogre::Vector3 const &start, Ogre::Vector3 const &end, size_t n)
+{
+	std::vector<Ogre::Vector3> positions;
+	for(size_t i = 0; i < n; ++i)
+	{ positions.push_back(start + (end - start)*(vl::scalar(i)/(n-1))); }
+	return positions;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( hanging_rod_does_not_stretch )
+{
+	// 20 m long heavy hose with 200 elements
+	std::vector<Ogre::Vector3> positions = create_line(Ogre::Vector3(0, 10, 0), Ogre::Vector3(20, 10, 0), 201);
+	vl::physics::RodSolver rod(positions, 1.0, 0.05);
+	rod.pin(0, positions.front());
+	rod.pin(200, Ogre::Vector3(10, 10, 0));
+	BOOST_CHECK(rod.isPinned(0));
+	BOOST_CHECK(!rod.isPinned(100));
+
+	for(size_t i = 0; i < 600; ++i)
+	{ rod.step(1.0/60); }
+
+	BOOST_CHECK_SMALL(rod.getStretch(), vl::scalar(0.01));
+	// Pins don't move
+	BOOST_CHECK_EQUAL(rod.getPositions().front(), positions.front());
+	// Hangs down from the pins
+	BOOST_CHECK_LT(rod.getPositions().at(100).y, 10 - 5);
+}
+
+BOOST_AUTO_TEST_CASE( bending_limit )
+{
+	std::vector<Ogre::Vector3> positions = create_line(Ogre::Vector3(0, 10, 0), Ogre::Vector3(5, 10, 0), 51);
+	vl::physics::RodSolver rod(positions, 1.0, 0.05);
+	vl::physics::RodParameters params;
+	params.max_bending_angle = 0.05;
+	params.iterations = 20;
+	rod.setParameters(params);
+	rod.pin(0, positions.front());
+	rod.pin(1, positions.at(1));
+
+	for(size_t i = 0; i < 120; ++i)
+	{ rod.step(1.0/60); }
+
+	// Cantilever can bend at most 50 x 0.05 rad
+	std::vector<Ogre::Vector3> const &x = rod.getPositions();
+	Ogre::Vector3 dir = x.back() - x.at(x.size()-2);
+	vl::scalar angle = std::acos(dir.normalisedCopy().dotProduct(Ogre::Vector3::UNIT_X));
+	BOOST_CHECK_LT(angle, 50*0.05*1.1);
+	BOOST_CHECK_GT(x.back().y, 10 - 5);
+}
+
+BOOST_AUTO_TEST_CASE( rod_collides_with_ground )
+{
+	std::vector<Ogre::Vector3> positions = create_line(Ogre::Vector3(0, 2, 0), Ogre::Vector3(5, 2, 0), 51);
+	vl::physics::RodSolver rod(positions, 1.0, 0.05);
+	PlaneCollider ground;
+	rod.setCollider(&ground);
+
+	for(size_t i = 0; i < 300; ++i)
+	{ rod.step(1.0/60); }
+
+	BOOST_CHECK_GT(rod.getNContacts(), 40u);
+	for(size_t i = 0; i < rod.getNParticles(); ++i)
+	{
+		BOOST_CHECK_GT(rod.getPositions().at(i).y, 0.05*0.99);
+		BOOST_CHECK_LT(rod.getPositions().at(i).y, 0.1);
+	}
+	BOOST_CHECK_SMALL(rod.getStretch(), vl::scalar(0.01));
+}
+
+BOOST_AUTO_TEST_CASE( invalid_rod )
+{
+	std::vector<Ogre::Vector3> positions(1, Ogre::Vector3::ZERO);
+	BOOST_CHECK_THROW(vl::physics::RodSolver(positions, 1.0, 0.1), vl::invalid_param);
+}
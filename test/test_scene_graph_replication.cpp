@@ -0,0 +1,273 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file test/test_scene_graph_replication.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Replication of the SceneNode child lists from master to a slave.
+ *
+ *	Child lists are sent as changes since the last update, so a slave
+ *	is only correct if it applies every update after its initial state.
+ *	Tests a slave joining in the middle of a session, the updates made
+ *	while it's initialising are queued and applied after the initial
+ *	state the same way Server keeps them for initialising clients.
+ *
+ *	Slave uses an Ogre SceneManager without a render system.
+ */
+
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE scene_graph_replication
+
+#include <boost/test/unit_test.hpp>
+
+#include <OGRE/OgreRoot.h>
+
+/// tested class
+#include "scene_node.hpp"
+#include "scene_manager.hpp"
+
+#include "cluster/session.hpp"
+#include "cluster/message.hpp"
+
+#include <sstream>
+#include <algorithm>
+
+namespace
+{
+
+/// Ogre Root is a singleton so it's shared by all the tests
+struct OgreFixture
+{
+	OgreFixture(void)
+		: root(new Ogre::Root("", "", ""))
+	{}
+
+	~OgreFixture(void)
+	{ delete root; }
+
+	Ogre::Root *root;
+};
+
+BOOST_GLOBAL_FIXTURE(OgreFixture);
+
+struct Master
+{
+	Master(size_t n_childs)
+		: scene(&session, vl::MeshManagerRefPtr())
+		, frame(0)
+	{
+		parent_a = scene.getRootSceneNode()->createChildSceneNode("parent_a");
+		parent_b = scene.getRootSceneNode()->createChildSceneNode("parent_b");
+		childs.reserve(n_childs);
+		for(size_t i = 0; i < n_childs; ++i)
+		{
+			std::stringstream ss;
+			ss << "child_" << i;
+			childs.push_back(parent_a->createChildSceneNode(ss.str()));
+		}
+	}
+
+	/// @brief move childs to the other parent
+	void move(size_t first, size_t n)
+	{
+		for(size_t i = 0; i < n; ++i)
+		{
+			vl::SceneNodePtr child = childs.at((first + i) % childs.size());
+			if(child->getParent() == parent_a)
+			{ parent_b->addChild(child); }
+			else
+			{ parent_a->addChild(child); }
+		}
+	}
+
+	/// @brief same as Master::_createMsgUpdate
+	vl::cluster::Message update(void)
+	{
+		vl::cluster::Message msg(vl::cluster::MSG_SG_UPDATE, ++frame, vl::time());
+		session.packDirtyObjects(msg);
+		return msg;
+	}
+
+	/// @brief same as Master::createMsgInit
+	vl::cluster::Message init(void) const
+	{
+		vl::cluster::Message msg(vl::cluster::MSG_SG_INIT, frame, vl::time());
+		session.packAllObjects(msg);
+		return msg;
+	}
+
+	vl::Session session;
+	vl::SceneManager scene;
+
+	vl::SceneNodePtr parent_a;
+	vl::SceneNodePtr parent_b;
+	std::vector<vl::SceneNodePtr> childs;
+
+	uint32_t frame;
+};
+
+/// @brief slave created from the master objects like Renderer::_create_objects
+struct Slave
+{
+	Slave(Master const &master)
+		: scene(0)
+		, scene_id(master.scene.getID())
+	{
+		Ogre::SceneManager *og_sm = Ogre::Root::getSingleton()
+			.createSceneManager(Ogre::ST_GENERIC);
+		scene = new vl::SceneManager(&session, scene_id, og_sm, vl::MeshManagerRefPtr());
+
+		vl::Session::CreatedObjectsList const &objects = master.session.getNewObjects();
+		for(size_t i = 0; i < objects.size(); ++i)
+		{
+			uint64_t id = objects.at(i).second->getID();
+			if(objects.at(i).first == vl::OBJ_SCENE_NODE)
+			{ scene->_createSceneNode(id); }
+			else if(objects.at(i).first >= vl::OBJ_MOVABLE)
+			{
+				scene->_createMovableObject(objects.at(i).first, id);
+				ignored.push_back(id);
+			}
+		}
+	}
+
+	~Slave(void)
+	{ delete scene; }
+
+	/// @brief same as Renderer::updateScene, only SceneNodes are updated
+	void apply(vl::cluster::Message msg)
+	{
+		while(msg.size() > 0)
+		{
+			vl::cluster::ObjectData data;
+			data.copyFromMessage(&msg);
+			if(data.getId() == scene_id
+				|| std::find(ignored.begin(), ignored.end(), data.getId()) != ignored.end())
+			{ continue; }
+
+			vl::Distributed *obj = session.findMappedObject(data.getId());
+			BOOST_REQUIRE(obj);
+			vl::cluster::ByteDataStream stream = data.getStream();
+			obj->unpack(stream);
+		}
+	}
+
+	vl::Session session;
+	vl::SceneManager *scene;
+	uint64_t scene_id;
+	std::vector<uint64_t> ignored;
+};
+
+/// @brief compare the hierarchy of the slave to the master
+bool
+same_hierarchy(Master const &master, Slave const &slave)
+{
+	vl::SceneNodeList const &nodes = master.scene.getSceneNodeList();
+	for(size_t i = 0; i < nodes.size(); ++i)
+	{
+		vl::SceneNodePtr node = slave.scene->getSceneNodeID(nodes.at(i)->getID());
+		if(!node)
+		{ return false; }
+
+		if(node->getChilds().size() != nodes.at(i)->getChilds().size())
+		{ return false; }
+
+		vl::SceneNodePtr parent = nodes.at(i)->getParent();
+		if(bool(parent) != bool(node->getParent()))
+		{ return false; }
+		if(parent && parent->getID() != node->getParent()->getID())
+		{ return false; }
+	}
+
+	return true;
+}
+
+}	// unamed namespace
+
+BOOST_AUTO_TEST_CASE(updates_after_init)
+{
+	Master master(100);
+	Slave slave(master);
+	slave.apply(master.init());
+	master.update();
+
+	for(size_t f = 0; f < 20; ++f)
+	{
+		master.move(f*7, 13);
+		slave.apply(master.update());
+		BOOST_CHECK(same_hierarchy(master, slave));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(moved_back_in_same_frame)
+{
+	Master master(10);
+	Slave slave(master);
+	slave.apply(master.init());
+	master.update();
+
+	// Moved to b and back to a, only the last change is sent
+	master.move(0, 5);
+	master.move(0, 5);
+	slave.apply(master.update());
+	BOOST_CHECK(same_hierarchy(master, slave));
+	BOOST_CHECK_EQUAL(slave.scene->getSceneNodeID(master.parent_a->getID())->getChilds().size(), 10u);
+}
+
+/// Slave joins in the middle of a session and the scene graph is changed
+/// while it's initialising.
+BOOST_AUTO_TEST_CASE(join_mid_session)
+{
+	size_t const n_childs = 10000;
+	size_t const n_moves = 100;
+
+	Master master(n_childs);
+	// Session running before the slave joins
+	for(size_t f = 0; f < 10; ++f)
+	{
+		master.move(f*n_moves, n_moves);
+		master.update();
+	}
+
+	Slave slave(master);
+	vl::cluster::Message init = master.init();
+
+	// Updates while the slave is receiving the initial state
+	std::vector<vl::cluster::Message> queued;
+	for(size_t f = 10; f < 20; ++f)
+	{
+		master.move(f*n_moves, n_moves);
+		queued.push_back(master.update());
+	}
+
+	slave.apply(init);
+	for(size_t i = 0; i < queued.size(); ++i)
+	{ slave.apply(queued.at(i)); }
+	BOOST_CHECK(same_hierarchy(master, slave));
+
+	// Normal updates, the changes are much smaller than the child lists
+	size_t full_list_bytes = n_childs*sizeof(uint64_t);
+	for(size_t f = 20; f < 30; ++f)
+	{
+		master.move(f*n_moves, n_moves);
+		vl::cluster::Message msg = master.update();
+		BOOST_CHECK(msg.size() < full_list_bytes/4);
+		slave.apply(msg);
+	}
+	BOOST_CHECK(same_hierarchy(master, slave));
+
+	size_t n_a = slave.scene->getSceneNodeID(master.parent_a->getID())->getChilds().size();
+	size_t n_b = slave.scene->getSceneNodeID(master.parent_b->getID())->getChilds().size();
+	BOOST_CHECK_EQUAL(n_a + n_b, n_childs);
+}
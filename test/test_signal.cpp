@@ -0,0 +1,98 @@
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE signal
+
+#include <boost/test/unit_test.hpp>
+
+/// tested class
+#include "base/signal.hpp"
+
+#include <boost/bind.hpp>
+
+#include <vector>
+
+namespace
+{
+
+typedef vl::Signal<void (int)> IntSignal;
+
+struct Recorder
+{
+	void record(int id, int value)
+	{ calls.push_back(std::make_pair(id, value)); }
+
+	std::vector< std::pair<int, int> > calls;
+};
+
+struct Disconnecter
+{
+	Disconnecter(IntSignal *s)
+		: signal(s), id(0), n_called(0)
+	{}
+
+	void operator()(int)
+	{
+		++n_called;
+		signal->disconnect(id);
+	}
+
+	IntSignal *signal;
+	IntSignal::connection id;
+	size_t n_called;
+};
+
+void connect_new(IntSignal *signal, Recorder *rec, int)
+{ signal->connect(boost::bind(&Recorder::record, rec, 2, _1)); }
+
+}	// unamed namespace
+
+BOOST_AUTO_TEST_CASE(emit_in_connection_order)
+{
+	IntSignal signal;
+	Recorder rec;
+	BOOST_CHECK(signal.empty());
+
+	signal.connect(boost::bind(&Recorder::record, &rec, 0, _1));
+	IntSignal::connection c = signal.connect(boost::bind(&Recorder::record, &rec, 1, _1));
+	BOOST_CHECK_EQUAL(signal.num_slots(), 2u);
+
+	signal(5);
+	BOOST_REQUIRE_EQUAL(rec.calls.size(), 2u);
+	BOOST_CHECK_EQUAL(rec.calls.at(0).first, 0);
+	BOOST_CHECK_EQUAL(rec.calls.at(1).first, 1);
+	BOOST_CHECK_EQUAL(rec.calls.at(1).second, 5);
+
+	signal.disconnect(c);
+	signal(6);
+	BOOST_CHECK_EQUAL(rec.calls.size(), 3u);
+
+	signal.disconnect_all_slots();
+	BOOST_CHECK(signal.empty());
+	signal(7);
+	BOOST_CHECK_EQUAL(rec.calls.size(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(modify_while_emitting)
+{
+	IntSignal signal;
+	Recorder rec;
+
+	// Slot removing itself is called only once
+	Disconnecter d(&signal);
+	d.id = signal.connect(boost::ref(d));
+	signal.connect(boost::bind(&Recorder::record, &rec, 1, _1));
+	signal(1);
+	signal(2);
+	BOOST_CHECK_EQUAL(d.n_called, 1u);
+	BOOST_CHECK_EQUAL(rec.calls.size(), 2u);
+	BOOST_CHECK_EQUAL(signal.num_slots(), 1u);
+
+	// Slots connected while emitting are called from the next emit
+	signal.connect(boost::bind(&connect_new, &signal, &rec, _1));
+	signal(3);
+	BOOST_CHECK_EQUAL(rec.calls.size(), 3u);
+	BOOST_CHECK_EQUAL(signal.num_slots(), 3u);
+	signal(4);
+	BOOST_CHECK_EQUAL(rec.calls.back().first, 2);
+}
@@ -0,0 +1,127 @@
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE timer_wheel
+
+#include <boost/test/unit_test.hpp>
+
+/// tested class
+#include "base/timer_wheel.hpp"
+
+#include <vector>
+#include <cstdlib>
+
+namespace
+{
+
+struct CountingTimer : public vl::TimerWheelEntry
+{
+	CountingTimer(void)
+		: n_expired(0), expired_at(0), wheel(0), interval(0)
+	{}
+
+	virtual void _timeout(void)
+	{
+		++n_expired;
+		expired_at = wheel->getTime();
+		if(interval > 0)
+		{ wheel->schedule(this, wheel->getTime() + interval); }
+	}
+
+	size_t n_expired;
+	uint64_t expired_at;
+
+	/// Rescheduled with this interval if set
+	vl::TimerWheel *wheel;
+	uint64_t interval;
+};
+
+}	// unamed namespace
+
+BOOST_AUTO_TEST_CASE(expire_and_cancel)
+{
+	vl::TimerWheel wheel;
+	CountingTimer a, b;
+	a.wheel = &wheel;
+	b.wheel = &wheel;
+
+	wheel.schedule(&a, 5000);
+	wheel.schedule(&b, 5000);
+	BOOST_CHECK_EQUAL(wheel.size(), 2u);
+
+	b.cancel();
+	BOOST_CHECK(!b.isScheduled());
+	BOOST_CHECK_EQUAL(wheel.size(), 1u);
+
+	BOOST_CHECK_EQUAL(wheel.advance(4999), 0u);
+	BOOST_CHECK_EQUAL(wheel.advance(5000), 1u);
+	BOOST_CHECK_EQUAL(a.n_expired, 1u);
+	BOOST_CHECK_EQUAL(b.n_expired, 0u);
+	BOOST_CHECK_EQUAL(wheel.size(), 0u);
+
+	// Destroyed entries remove themselves
+	{
+		CountingTimer c;
+		wheel.schedule(&c, 6000);
+		BOOST_CHECK_EQUAL(wheel.size(), 1u);
+	}
+	BOOST_CHECK_EQUAL(wheel.size(), 0u);
+	BOOST_CHECK_EQUAL(wheel.advance(7000), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(reschedule_from_callback)
+{
+	vl::TimerWheel wheel;
+	CountingTimer t;
+	t.wheel = &wheel;
+	// Zero interval expires once per advance not once per tick
+	t.interval = 0;
+	wheel.schedule(&t, 0);
+
+	wheel.advance(16000);
+	BOOST_CHECK_EQUAL(t.n_expired, 1u);
+
+	t.interval = 1;
+	wheel.schedule(&t, 16000);
+	for(size_t i = 0; i < 10; ++i)
+	{ wheel.advance(16000 + (i+1)*16000); }
+	BOOST_CHECK_EQUAL(t.n_expired, 11u);
+}
+
+BOOST_AUTO_TEST_CASE(matches_linear_scan)
+{
+	std::srand(7);
+
+	vl::TimerWheel wheel;
+	size_t const N = 2000;
+	std::vector<CountingTimer> timers(N);
+	std::vector<uint64_t> due(N);
+	for(size_t i = 0; i < N; ++i)
+	{
+		// From sub millisecond to a few minutes so all the levels are used
+		due.at(i) = uint64_t(std::rand() % 200000)*uint64_t(std::rand() % 1000 + 1);
+		timers.at(i).wheel = &wheel;
+		wheel.schedule(&timers.at(i), due.at(i));
+	}
+
+	// Frame lengths longer than the tick expire exactly on the first
+	// advance after the due time
+	uint64_t now = 0;
+	while(wheel.size() > 0)
+	{
+		uint64_t prev = now;
+		now += 1000 + std::rand() % 50000;
+		wheel.advance(now);
+
+		for(size_t i = 0; i < N; ++i)
+		{
+			if(due.at(i) > prev && due.at(i) <= now)
+			{
+				BOOST_CHECK_EQUAL(timers.at(i).n_expired, 1u);
+				BOOST_CHECK_EQUAL(timers.at(i).expired_at, now);
+			}
+			else if(due.at(i) > now)
+			{ BOOST_CHECK_EQUAL(timers.at(i).n_expired, 0u); }
+		}
+	}
+}
@@ -0,0 +1,123 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file test/test_transform_group.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+#ifdef VL_UNIX
+#define BOOST_TEST_DYN_LINK
+#endif
+#define BOOST_TEST_MODULE transform_group
+
+#include <boost/test/unit_test.hpp>
+
+/// tested class
+#include "transform_group.hpp"
+
+#include "scene_node.hpp"
+#include "scene_manager.hpp"
+
+#include "cluster/session.hpp"
+
+namespace
+{
+
+/// Master SceneManager, doesn't need a rendering system
+struct SceneFixture
+{
+	SceneFixture(void)
+		: scene(&session, vl::MeshManagerRefPtr())
+	{
+		a = scene.getRootSceneNode()->createChildSceneNode("a");
+		b = scene.getRootSceneNode()->createChildSceneNode("b");
+		c = scene.getRootSceneNode()->createChildSceneNode("c");
+		a->setPosition(Ogre::Vector3(1, 0, 0));
+		b->setPosition(Ogre::Vector3(2, 0, 0));
+		c->setPosition(Ogre::Vector3(3, 0, 0));
+	}
+
+	vl::Session session;
+	vl::SceneManager scene;
+	vl::SceneNodePtr a;
+	vl::SceneNodePtr b;
+	vl::SceneNodePtr c;
+};
+
+}	// unamed namespace
+
+BOOST_FIXTURE_TEST_CASE(read_and_write, SceneFixture)
+{
+	vl::TransformGroup group;
+	group.addObject(a);
+	group.addObject(b);
+	BOOST_REQUIRE_EQUAL(group.getNObjects(), 2u);
+
+	group.read();
+	BOOST_CHECK_EQUAL(group.getData()[vl::TransformGroup::ROW_SIZE], 2);
+
+	group.getData()[0] = 5;
+	group.write();
+	BOOST_CHECK_EQUAL(a->getPosition(), Ogre::Vector3(5, 0, 0));
+	BOOST_CHECK_EQUAL(b->getPosition(), Ogre::Vector3(2, 0, 0));
+}
+
+BOOST_FIXTURE_TEST_CASE(destroyed_node_is_removed, SceneFixture)
+{
+	vl::TransformGroup group;
+	group.addObject(a);
+	group.addObject(b);
+	group.addObject(c);
+
+	scene.destroySceneNode(b);
+	BOOST_REQUIRE_EQUAL(group.getNObjects(), 2u);
+	BOOST_CHECK_EQUAL(group.getObject(0), a);
+	BOOST_CHECK_EQUAL(group.getObject(1), c);
+
+	group.read();
+	BOOST_CHECK_EQUAL(group.getData()[vl::TransformGroup::ROW_SIZE], 3);
+}
+
+BOOST_FIXTURE_TEST_CASE(destroyed_while_exported, SceneFixture)
+{
+	vl::TransformGroup group;
+	group.addObject(a);
+	group.addObject(b);
+
+	// Row is kept while the buffer is in use
+	group._addExport();
+	scene.destroySceneNode(a);
+	BOOST_REQUIRE_EQUAL(group.getNObjects(), 2u);
+	BOOST_CHECK(!group.getObject(0));
+
+	group.getData()[0] = 5;
+	group.getData()[vl::TransformGroup::ROW_SIZE] = 6;
+	group.write();
+	group.read();
+	BOOST_CHECK_EQUAL(b->getPosition(), Ogre::Vector3(6, 0, 0));
+	group._removeExport();
+
+	// and erased when the group is resized
+	group.addObject(c);
+	BOOST_REQUIRE_EQUAL(group.getNObjects(), 2u);
+	BOOST_CHECK_EQUAL(group.getObject(0), b);
+	BOOST_CHECK_EQUAL(group.getObject(1), c);
+}
+
+BOOST_FIXTURE_TEST_CASE(group_destroyed_before_node, SceneFixture)
+{
+	{
+		vl::TransformGroup group;
+		group.addObject(a);
+	}
+
+	// Would use the destroyed group if it was still registered
+	scene.destroySceneNode(a);
+}
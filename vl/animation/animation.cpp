@@ -55,14 +55,22 @@ vl::animation::operator<<(std::ostream &os, vl::animation::Graph const &g)
 
 /// ---------------------------------- Node ----------------------------------
 
-vl::animation::Node::Node(vl::Transform const &initial_transform)
+vl::animation::Node::Node(vl::Transform const &initial_transform,
+	vl::animation::TransformStorageRefPtr storage)
 	: _parent()
 	, _next_child(0)
-	, _transform(initial_transform)
-{}
+	, _storage(storage)
+{
+	if(!_storage)
+	{ _storage.reset(new TransformStorage); }
+
+	_handle = _storage->allocate(initial_transform);
+}
 
 vl::animation::Node::~Node(void)
-{}
+{
+	_storage->release(_handle);
+}
 
 bool
 vl::animation::Node::isLeaf(void) const
@@ -111,26 +119,22 @@ vl::animation::Node::getChild(size_t i) const
 	return LinkRefPtr();
 }
 
-vl::Transform const &
+vl::Transform
 vl::animation::Node::getTransform(void) const
-{ return _transform; }
+{ return _storage->getTransform(_handle); }
 
 void
 vl::animation::Node::setTransform(Transform const &t)
 {
 	// @todo should we check if we need to update transform?
-	_transformation_dirty = true;
-	_transform = t;
+	_storage->setTransform(_handle, t);
 }
 
 vl::Transform
 vl::animation::Node::getWorldTransform(void) const
 {
-	// Nodes don't need to have parents
-	if(_parent.lock())
-	{ return _parent.lock()->getWorldTransform()*_transform; }
-	
-	return _transform;
+	// Storage has the same hierarchy as the Nodes and Links
+	return _storage->getWorldTransform(_handle);
 }
 
 void
@@ -191,10 +195,12 @@ vl::animation::Node::setParent(LinkRefPtr link)
 
 	if(link)
 	{
+		_setStorage(link->_getStorage());
 		link->_setChild(shared_from_this());
 	}
 
 	_parent = link;
+	_storage->setParent(_handle, link ? link->_getHandle() : TransformStorage::INVALID_HANDLE);
 	setWorldTransform(wt);
 }
 
@@ -255,31 +261,41 @@ vl::animation::Node::_removeChild(LinkRefPtr link)
 }
 
 void
-vl::animation::Node::_updateCachedTransform(vl::Transform const &parent_t, bool parent_dirty)
+vl::animation::Node::_setStorage(vl::animation::TransformStorageRefPtr storage)
 {
-	bool dirty = (parent_dirty || _transformation_dirty);
-	if(dirty)
-	{
-		_wt_cached = parent_t * _transform;
+	assert(storage);
+	if(_storage == storage)
+	{ return; }
 
-		_transformation_dirty = false;
-	}
+	TransformStorage::Handle h = storage->allocate(getTransform());
+	_storage->release(_handle);
+	_storage = storage;
+	_handle = h;
 
 	for(LinkList::iterator iter = _childs.begin(); iter != _childs.end(); ++iter)
 	{
-		(*iter)->_updateCachedTransform(_wt_cached, dirty);
+		(*iter)->_setStorage(_storage);
+		_storage->setParent((*iter)->_getHandle(), _handle);
 	}
 }
 
 
 /// ---------------------------------- Link ----------------------------------
-vl::animation::Link::Link(Transform const &t)
-	: _transform(t)
+vl::animation::Link::Link(Transform const &t, vl::animation::TransformStorageRefPtr storage)
+	: _storage(storage)
 	, _initial_transform(t)
-{}
+	, _prev_transform(t)
+{
+	if(!_storage)
+	{ _storage.reset(new TransformStorage); }
+
+	_handle = _storage->allocate(t);
+}
 
 vl::animation::Link::~Link(void)
-{}
+{
+	_storage->release(_handle);
+}
 
 vl::animation::NodeRefPtr
 vl::animation::Link::getParent(void) const
@@ -298,10 +314,12 @@ vl::animation::Link::setParent(NodeRefPtr parent)
 
 	if(parent)
 	{
+		_setStorage(parent->_getStorage());
 		parent->_addChild(shared_from_this());
 	}
 
 	_parent = parent;
+	_storage->setParent(_handle, parent ? parent->_getHandle() : TransformStorage::INVALID_HANDLE);
 
 	setWorldTransform(wt);
 }
@@ -332,18 +350,17 @@ vl::animation::Link::_setChild(NodeRefPtr child)
 	_child = child;
 }
 
-vl::Transform const &
+vl::Transform
 vl::animation::Link::getTransform(void) const
-{ return _transform; }
+{ return _storage->getTransform(_handle); }
 
 void
 vl::animation::Link::setTransform(Transform const &t, bool preserve_child_transforms)
 {
 	// @todo should we check if we need to update Transform or not?
-	_transformation_dirty = true;
 
 	// save the last state
-	_prev_transform = _transform;
+	_prev_transform = getTransform();
 
 	if(preserve_child_transforms && _child)
 	{
@@ -351,11 +368,11 @@ vl::animation::Link::setTransform(Transform const &t, bool preserve_child_transf
 		/// this is because changing the link will change the world transformation
 		/// of the child node.
 		Transform wt(_child->getWorldTransform());
-		_transform = t;
+		_storage->setTransform(_handle, t);
 		_child->setWorldTransform(wt);
 	}
 	else
-	{ _transform = t; }
+	{ _storage->setTransform(_handle, t); }
 }
 
 void
@@ -369,10 +386,8 @@ vl::animation::Link::setPosition(Ogre::Vector3 const &v, bool preserve_child_tra
 vl::Transform
 vl::animation::Link::getWorldTransform(void) const
 {
-	if(!_parent.expired())
-	{ return _parent.lock()->getWorldTransform()*_transform; }
-
-	return _transform;
+	// Storage has the same hierarchy as the Nodes and Links
+	return _storage->getWorldTransform(_handle);
 }
 
 void
@@ -405,8 +420,7 @@ void
 vl::animation::Link::popLastTransform(void)
 {
 	// @todo should we check if we need to update transform?
-	_transformation_dirty = true;
-	_transform = _prev_transform;
+	_storage->setTransform(_handle, _prev_transform);
 
 	// Update parents
 	if(_parent.lock())
@@ -416,9 +430,9 @@ vl::animation::Link::popLastTransform(void)
 void 
 vl::animation::Link::setInitialState(void)
 {
-	_transformation_dirty = true;
-	_initial_transform = _transform;
-	_prev_transform = _transform;
+	_initial_transform = getTransform();
+	_prev_transform = _initial_transform;
+	_storage->setTransform(_handle, _initial_transform);
 }
 
 void
@@ -434,31 +448,47 @@ vl::animation::Link::size(void) const
 }
 
 void
-vl::animation::Link::_updateCachedTransform(vl::Transform const &parent_t, bool parent_dirty)
+vl::animation::Link::_setStorage(vl::animation::TransformStorageRefPtr storage)
 {
-	bool dirty = (parent_dirty || _transformation_dirty);
-	if(dirty)
-	{
-		// @todo add collision flag based selection of either
-		// _transform or _prev_transform
-		_wt_cached = parent_t * _transform;
+	assert(storage);
+	if(_storage == storage)
+	{ return; }
 
-		_transformation_dirty = false;
-	}
+	TransformStorage::Handle h = storage->allocate(getTransform());
+	_storage->release(_handle);
+	_storage = storage;
+	_handle = h;
 
 	if(_child)
-	{ _child->_updateCachedTransform(_wt_cached, dirty); }
+	{
+		_child->_setStorage(_storage);
+		_storage->setParent(_child->_getHandle(), _handle);
+	}
 }
 
 
 /// ---------------------------------- Graph ---------------------------------
 vl::animation::Graph::Graph(void)
-	: _root(new Node(Transform()))
-{}
+	: _storage(new TransformStorage)
+{
+	_root.reset(new Node(Transform(), _storage));
+}
 
 vl::animation::Graph::~Graph(void)
 {}
 
+vl::animation::NodeRefPtr
+vl::animation::Graph::createNode(vl::Transform const &initial_transform)
+{
+	return NodeRefPtr(new Node(initial_transform, _storage));
+}
+
+vl::animation::LinkRefPtr
+vl::animation::Graph::createLink(vl::Transform const &t)
+{
+	return LinkRefPtr(new Link(t, _storage));
+}
+
 size_t
 vl::animation::Graph::size(void) const
 {
@@ -469,11 +499,13 @@ vl::animation::Graph::size(void) const
 }
 
 void
-vl::animation::Graph::_update(void)
+vl::animation::Graph::_update(vl::ThreadPool *pool)
 {
-	assert(_root);
+	assert(_storage);
 	/// Update the cached transformations of all children
-	_root->_updateCachedTransform(vl::Transform(), false);
+	/// Also updates Nodes and Links that have been removed from the graph
+	/// but still alive, they are cheap and avoid tracking the membership.
+	_storage->update(pool);
 }
 
 /// @brief push a transform to the transformation stack
@@ -14,6 +14,10 @@
 
 /*
  *	Internal Kinematic animation implementation. Defined in a separate namespace.
+ *
+ *	Nodes and Links are thin facades over the TransformStorage of the Graph,
+ *	their transformations are stored in contiguous arrays indexed by
+ *	a handle so that the whole graph can be updated in one pass.
  */
 
 #ifndef HYDRA_ANIMATION_HPP
@@ -23,6 +27,8 @@
 
 #include "math/transform.hpp"
 
+#include "transform_storage.hpp"
+
 #include <boost/weak_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/enable_shared_from_this.hpp>
@@ -58,6 +64,8 @@ typedef boost::weak_ptr<Graph> GraphWeakPtr;
 ///
 /// Nodes don't support collision detection only Links do.
 /// Supports dirties in Transformations and caching of the World transformation.
+/// Transformations are stored in a TransformStorage, a Node attached to a Link
+/// in another storage is moved to that storage with all of it's children.
 ///
 /// @todo add cache of Collision detection to the node
 /// Best would probably to use a transformation list and indices
@@ -76,7 +84,10 @@ public :
 	typedef std::vector<LinkWeakPtr> LinkWeakList;
 
 	/// @brief Constructor
-	Node(vl::Transform const &initial_transform);
+	/// @param storage where the transformation is stored, if NULL the node
+	/// creates a storage of it's own.
+	Node(vl::Transform const &initial_transform,
+		TransformStorageRefPtr storage = TransformStorageRefPtr());
 
 	/// @brief Destructor
 	~Node(void);
@@ -124,7 +135,8 @@ public :
 	/// @return Transformation of the Node in local coordinates
 	/// Only const version is provided because we need to manage the old
 	/// transformations for collision detection.
-	Transform const &getTransform(void) const;
+	/// Returns a copy, the storage slots move when the hierarchy changes.
+	Transform getTransform(void) const;
 
 	/// @brief set the local transformation
 	/// @param t a new Transformation for the Node in local coordinates
@@ -167,13 +179,21 @@ public :
 	void _removeChild(LinkRefPtr link);
 
 	/// @internal
-	/// @brief Update the cached transformation
-	void _updateCachedTransform(vl::Transform const &parent_t, bool parent_dirty);
+	/// Get the cached transformation from the last Graph update
+	vl::Transform _getCachedWorldTransform(void) const
+	{ return _storage->getCachedWorldTransform(_handle); }
+
+	/// @internal
+	TransformStorageRefPtr const &_getStorage(void) const
+	{ return _storage; }
+
+	/// @internal
+	TransformStorage::Handle _getHandle(void) const
+	{ return _handle; }
 
 	/// @internal
-	/// Get the last cached transformation
-	vl::Transform const &_getCachedWorldTransform(void) const
-	{ return _wt_cached; }
+	/// @brief move this node and all of it's children to another storage
+	void _setStorage(TransformStorageRefPtr storage);
 
 private :
 
@@ -181,12 +201,8 @@ private :
 	LinkList _childs;
 	size_t _next_child;
 
-	Transform _transform;
-	
-	/// Internal states
-	bool _transformation_dirty;
-
-	vl::Transform _wt_cached;
+	TransformStorageRefPtr _storage;
+	TransformStorage::Handle _handle;
 
 };	// class Node
 
@@ -201,7 +217,10 @@ class Link : public boost::enable_shared_from_this<Link>
 public :
 	/// @brief constructor
 	/// @param t Transformation where the link starts
-	Link(Transform const &t = Transform());
+	/// @param storage where the transformation is stored, if NULL the link
+	/// creates a storage of it's own.
+	Link(Transform const &t = Transform(),
+		TransformStorageRefPtr storage = TransformStorageRefPtr());
 
 	/// @brief destructor
 	~Link(void);
@@ -220,7 +239,8 @@ public :
 	/// @return Transformation of the Link in local coordinates
 	/// Only const version is provided because we need to manage the old
 	/// transformations for collision detection.
-	Transform const &getTransform(void) const;
+	/// Returns a copy, the storage slots move when the hierarchy changes.
+	Transform getTransform(void) const;
 
 	/// @brief set the local transformation
 	/// @param t a new Transformation for the Link in local coordinates
@@ -267,31 +287,38 @@ public :
 	void _setChild(NodeRefPtr child);
 
 	/// @internal
-	void _updateCachedTransform(vl::Transform const &parent_t, bool parent_dirty);
+	/// Get the cached transformation from the last Graph update
+	vl::Transform _getCachedWorldTransform(void) const
+	{ return _storage->getCachedWorldTransform(_handle); }
+
+	/// @internal
+	TransformStorageRefPtr const &_getStorage(void) const
+	{ return _storage; }
 
 	/// @internal
-	/// Get the last cached transformation
-	vl::Transform const &_getCachedWorldTransform(void) const
-	{ return _wt_cached; }
+	TransformStorage::Handle _getHandle(void) const
+	{ return _handle; }
+
+	/// @internal
+	/// @brief move this link and the child to another storage
+	void _setStorage(TransformStorageRefPtr storage);
 
 private :
 	NodeWeakPtr _parent;
 	NodeRefPtr _child;
 
-	Transform _transform;
+	TransformStorageRefPtr _storage;
+	TransformStorage::Handle _handle;
+
 	Transform _initial_transform;
 
 	Transform _prev_transform;
 
-	/// Internal states
-	bool _transformation_dirty;
-
-	vl::Transform _wt_cached;
-
 };	// class Link
 
 /// @class Graph
 /// @brief A graph containing all the animation Nodes and Links
+/// Owns the TransformStorage of all the Nodes and Links in it.
 class Graph
 {
 public :
@@ -308,12 +335,26 @@ public :
 	NodeRefPtr getRoot(void) const
 	{ return _root; }
 
+	/// @brief create a Node that uses the storage of this graph
+	/// The Node is not linked to the graph.
+	NodeRefPtr createNode(Transform const &initial_transform);
+
+	/// @brief create a Link that uses the storage of this graph
+	/// The Link is not linked to the graph.
+	LinkRefPtr createLink(Transform const &t = Transform());
+
+	TransformStorageRefPtr const &getStorage(void) const
+	{ return _storage; }
+
 	/// @brief calculate the size of the graph
 	/// Number of Nodes connected to the Graph (including root node)
 	/// Minimum size is one because root node exists always.
 	size_t size(void) const;
 
-	void _update(void);
+	/// @brief update the cached world transformations of all Nodes and Links
+	/// in the storage with a single pass
+	/// @param pool if not NULL independent subtrees are updated in parallel
+	void _update(ThreadPool *pool = 0);
 
 	/// @todo Transformation Stack is not in use for the moment
 
@@ -324,6 +365,8 @@ public :
 	void _popTransform(void);
 
 private :
+	TransformStorageRefPtr _storage;
+
 	NodeRefPtr _root;
 
 };	// class Graph
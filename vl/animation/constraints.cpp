@@ -417,7 +417,7 @@ vl::HingeConstraint::getHingeAngle(void) const
 	if(!_link)
 	{ return Ogre::Radian(0); }
 
-	Ogre::Quaternion const &current_q = _link->getTransform().quaternion;
+	Ogre::Quaternion current_q = _link->getTransform().quaternion;
 	Ogre::Quaternion const &init_q =_link->getInitialTransform().quaternion;
 
 	Ogre::Quaternion q = init_q.Inverse()*current_q;
@@ -27,6 +27,10 @@
 
 #include "constraints.hpp"
 
+#include <boost/bind.hpp>
+
+#include <map>
+
 // Necessary for collision detection
 #include "game_manager.hpp"
 #include "physics/physics_world.hpp"
@@ -62,6 +66,9 @@ vl::operator<<(std::ostream &os, vl::KinematicBodyList const &bodies)
 vl::KinematicWorld::KinematicWorld(GameManager *man)
 	: _collision_detection_on(false)
 	, _graph(new animation::Graph)
+	, _islands_dirty(true)
+	, _islands_version(0)
+	, _pool(new ThreadPool(1))
 	, _game(man)
 {
 }
@@ -79,7 +86,7 @@ vl::KinematicWorld::step(vl::time const &t)
 	_progress_constraints(t);
 
 	// Update all the nodes
-	_graph->_update();
+	_graph->_update(_pool.get());
 
 	/// Copy transformations to Motion states
 	for(KinematicBodyList::iterator iter = _bodies.begin();
@@ -110,6 +117,7 @@ vl::KinematicWorld::removeAll(void)
 	// Because these are ref counted we let the destructor handle them.
 	//ConstraintList _constraints;
 	_constraints.clear();
+	_islands_dirty = true;
 
 	// Removing bodies should remove the animation::Nodes completely
 	// Because these are ref counted we let the destructor handle them.
@@ -250,6 +258,7 @@ vl::KinematicWorld::removeKinematicBody(vl::KinematicBodyRefPtr body)
 	if(iter != _bodies.end())
 	{
 		_bodies.erase(iter);
+		_islands_dirty = true;
 	}
 }
 
@@ -306,6 +315,7 @@ vl::KinematicWorld::removeConstraint(ConstraintRefPtr constraint)
 		if(*iter == constraint)
 		{
 			_constraints.erase(iter);
+			_islands_dirty = true;
 			// @todo remove the link and Node also from the map and graph
 			// at the moment they are in the destructor which is not good
 			break;
@@ -352,6 +362,17 @@ vl::KinematicWorld::getBodies(void) const
 	return _bodies;
 }
 
+void
+vl::KinematicWorld::setNThreads(size_t n)
+{
+	if(n == 0 || n != _pool->getNThreads())
+	{ _pool.reset(new ThreadPool(n)); }
+}
+
+size_t
+vl::KinematicWorld::getNThreads(void) const
+{ return _pool->getNThreads(); }
+
 void
 vl::KinematicWorld::enableCollisionDetection(bool enable)
 {
@@ -518,13 +539,14 @@ vl::KinematicWorld::_addConstraint(vl::ConstraintRefPtr constraint)
 	child->setInitialState();
 
 	_constraints.push_back(constraint);
+	_islands_dirty = true;
 }
 
 vl::animation::NodeRefPtr
 vl::KinematicWorld::_createNode(vl::Transform const &initial_transform)
 {
-	animation::NodeRefPtr node(new animation::Node(initial_transform));
-	animation::LinkRefPtr link(new animation::Link);
+	animation::NodeRefPtr node = _graph->createNode(initial_transform);
+	animation::LinkRefPtr link = _graph->createLink();
 	link->setParent(_graph->getRoot());
 	link->setChild(node);
 
@@ -534,14 +556,80 @@ vl::KinematicWorld::_createNode(vl::Transform const &initial_transform)
 void
 vl::KinematicWorld::_progress_constraints(vl::time const &t)
 {
+	if(_islands_dirty || _islands_version != _graph->getStorage()->getTopologyVersion())
+	{ _build_islands(); }
+
 	// First phase
 	/// Progress the constraints
-	for(ConstraintList::iterator iter = _constraints.begin();
-		iter != _constraints.end(); ++iter)
-	{ 
-		(*iter)->_solve(t);
+	/// Islands don't share any links so they can be solved in parallel
+	if(_pool->getNThreads() > 1 && _islands.size() > 1)
+	{
+		// Combine small islands so that the tasks have enough work
+		size_t task_size = _constraints.size()/(4*_pool->getNThreads()) + 1;
+		std::vector<ThreadPool::Task> tasks;
+		size_t begin = 0;
+		size_t n = 0;
+		for(size_t i = 0; i < _islands.size(); ++i)
+		{
+			n += _islands.at(i).size();
+			if(n >= task_size || i == _islands.size()-1)
+			{
+				tasks.push_back(boost::bind(&KinematicWorld::_solve_islands, this, begin, i+1, t));
+				begin = i+1;
+				n = 0;
+			}
+		}
+		_pool->run(tasks);
 	}
+	else
+	{ _solve_islands(0, _islands.size(), t); }
 
 	/// Second phase needs an IK solver using the Jacobian to progress
 	/// the constraints... not implemented yet.
 }
+
+void
+vl::KinematicWorld::_build_islands(void)
+{
+	_islands.clear();
+
+	// Every body has a node under the root until it's constrained to
+	// an another body, so the top most node below the root identifies
+	// the kinematic chain.
+	animation::NodeRefPtr root = _graph->getRoot();
+	std::map<animation::Node *, size_t> indices;
+	for(ConstraintList::iterator iter = _constraints.begin();
+		iter != _constraints.end(); ++iter)
+	{
+		animation::NodeRefPtr node;
+		if((*iter)->_getLink())
+		{ node = (*iter)->_getLink()->getParent(); }
+
+		while(node && node->getParent() && node->getParent()->getParent()
+			&& node->getParent()->getParent() != root)
+		{ node = node->getParent()->getParent(); }
+
+		std::map<animation::Node *, size_t>::iterator island = indices.find(node.get());
+		if(island == indices.end())
+		{
+			island = indices.insert(std::make_pair(node.get(), _islands.size())).first;
+			_islands.push_back(std::vector<Constraint *>());
+		}
+
+		_islands.at(island->second).push_back(iter->get());
+	}
+
+	_islands_dirty = false;
+	_islands_version = _graph->getStorage()->getTopologyVersion();
+}
+
+void
+vl::KinematicWorld::_solve_islands(size_t begin, size_t end, vl::time const &t)
+{
+	for(size_t i = begin; i < end; ++i)
+	{
+		std::vector<Constraint *> &island = _islands[i];
+		for(size_t j = 0; j < island.size(); ++j)
+		{ island[j]->_solve(t); }
+	}
+}
@@ -117,6 +117,20 @@ public :
 	bool isCollisionDetectionEnabled(void) const
 	{ return _collision_detection_on; }
 
+	/// @brief set the number of threads used for independent kinematic chains
+	/// @param n number of threads, zero uses the number of hardware threads
+	/// and one disables threading.
+	/// Islands are independent so the results are same as with one thread.
+	/// Defaults to one, GameManager sets it from multicore.kinematic_threads.
+	void setNThreads(size_t n);
+
+	size_t getNThreads(void) const;
+
+	/// @brief number of independent kinematic chains (islands)
+	/// Valid after the world has been stepped.
+	size_t getNIslands(void) const
+	{ return _islands.size(); }
+
 	friend std::ostream &operator<<(std::ostream &os, KinematicWorld const &world);
 
 private :
@@ -134,6 +148,12 @@ private :
 
 	void _progress_constraints(vl::time const &t);
 
+	/// @brief partition the constraints to islands based on the graph
+	void _build_islands(void);
+
+	/// @brief solve constraints in islands [begin, end)
+	void _solve_islands(size_t begin, size_t end, vl::time const &t);
+
 	void _create_collision_body(KinematicBodyRefPtr body);
 
 	bool _collision_detection_on;
@@ -143,6 +163,15 @@ private :
 
 	animation::GraphRefPtr _graph;
 
+	/// Constraints grouped by the top most body below the graph root,
+	/// rebuild when constraints are added or removed or links reparented.
+	std::vector< std::vector<Constraint *> > _islands;
+	bool _islands_dirty;
+	/// Graph topology version the islands were built from
+	uint32_t _islands_version;
+
+	boost::scoped_ptr<ThreadPool> _pool;
+
 	GameManager *_game;
 
 };	// class KinematicWorld
@@ -0,0 +1,296 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file animation/transform_storage.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/*
+ *	Internal Kinematic animation implementation. Defined in a separate namespace.
+ */
+#include "transform_storage.hpp"
+
+#include "base/exceptions.hpp"
+
+#include <boost/bind.hpp>
+
+#include <algorithm>
+
+vl::animation::TransformStorage::TransformStorage(void)
+	: _n_roots(0)
+	, _n_dead(0)
+	, _topology_dirty(false)
+	, _topology_version(0)
+{}
+
+vl::animation::TransformStorage::Handle
+vl::animation::TransformStorage::allocate(vl::Transform const &t)
+{
+	Handle h;
+	if(!_free_handles.empty())
+	{
+		h = _free_handles.back();
+		_free_handles.pop_back();
+	}
+	else
+	{
+		h = Handle(_slots.size());
+		_slots.push_back(0);
+	}
+
+	_slots[h] = uint32_t(_local.size());
+	_local.push_back(t);
+	_world.push_back(t);
+	_parent.push_back(-1);
+	_dirty.push_back(1);
+	_handles.push_back(h);
+	_topology_dirty = true;
+
+	return h;
+}
+
+void
+vl::animation::TransformStorage::release(Handle h)
+{
+	assert(h < _slots.size());
+
+	uint32_t s = _slots[h];
+	assert(_handles[s] == h);
+
+	// Children still pointing to the slot are detached by the next rebuild,
+	// until then dead parents are ignored.
+	_handles[s] = INVALID_HANDLE;
+	_parent[s] = -1;
+	_dirty[s] = 0;
+	_free_handles.push_back(h);
+	++_n_dead;
+	_topology_dirty = true;
+	++_topology_version;
+}
+
+void
+vl::animation::TransformStorage::setParent(Handle h, Handle parent)
+{
+	uint32_t s = _slots[h];
+	int32_t p = (parent == INVALID_HANDLE ? -1 : int32_t(_slots[parent]));
+
+	if(_parent[s] == p)
+	{ return; }
+
+	_parent[s] = p;
+	_dirty[s] = 1;
+	_topology_dirty = true;
+	++_topology_version;
+}
+
+vl::animation::TransformStorage::Handle
+vl::animation::TransformStorage::getParent(Handle h) const
+{
+	int32_t p = _parent[_slots[h]];
+	// Released slots have INVALID_HANDLE
+	return (p < 0 ? INVALID_HANDLE : _handles[p]);
+}
+
+vl::Transform
+vl::animation::TransformStorage::getWorldTransform(Handle h) const
+{
+	int32_t s = int32_t(_slots[h]);
+	vl::Transform wt(_local[s]);
+	for(int32_t p = _parent[s]; p >= 0 && _handles[p] != INVALID_HANDLE; p = _parent[p])
+	{ wt = _local[p]*wt; }
+
+	return wt;
+}
+
+void
+vl::animation::TransformStorage::update(vl::ThreadPool *pool)
+{
+	if(_topology_dirty)
+	{ _rebuild(); }
+
+	// Roots first because all the islands depend on them
+	_update_range(0, _n_roots);
+
+	size_t n = _local.size();
+	if(pool && pool->getNThreads() > 1 && _islands.size() > 1)
+	{
+		// Combine small islands so the tasks have enough work,
+		// few tasks per thread so stealing can balance the load.
+		size_t task_size = (n - _n_roots)/(4*pool->getNThreads()) + 1;
+		std::vector<ThreadPool::Task> tasks;
+		size_t begin = _n_roots;
+		for(size_t i = 0; i < _islands.size(); ++i)
+		{
+			size_t end = _islands.at(i);
+			if(end - begin >= task_size || i == _islands.size()-1)
+			{
+				tasks.push_back(boost::bind(&TransformStorage::_update_range, this, begin, end));
+				begin = end;
+			}
+		}
+		pool->run(tasks);
+	}
+	else
+	{ _update_range(_n_roots, n); }
+
+	std::fill(_dirty.begin(), _dirty.end(), 0);
+}
+
+void
+vl::animation::TransformStorage::_update_range(size_t begin, size_t end)
+{
+	for(size_t i = begin; i < end; ++i)
+	{
+		int32_t p = _parent[i];
+		if(p < 0)
+		{
+			if(_dirty[i])
+			{ _world[i] = _local[i]; }
+		}
+		else
+		{
+			// Parents are always updated first, dirty flags are cleared
+			// only after the pass so they propagate down the hierarchy.
+			if(_dirty[p])
+			{ _dirty[i] = 1; }
+			if(_dirty[i])
+			{ _world[i] = _world[p]*_local[i]; }
+		}
+	}
+}
+
+namespace
+{
+
+/// Sorting key for the slots
+struct SlotOrder
+{
+	/// slot of the island root, 0 for roots so they are first
+	uint32_t island;
+	uint32_t depth;
+	uint32_t slot;
+
+	bool operator<(SlotOrder const &other) const
+	{
+		if(island != other.island)
+		{ return island < other.island; }
+		if(depth != other.depth)
+		{ return depth < other.depth; }
+		return slot < other.slot;
+	}
+};
+
+}	// unamed namespace
+
+void
+vl::animation::TransformStorage::_rebuild(void)
+{
+	size_t n = _local.size();
+
+	// Children of released slots are detached
+	for(size_t i = 0; i < n; ++i)
+	{
+		int32_t p = _parent[i];
+		if(p >= 0 && _handles[p] == INVALID_HANDLE)
+		{
+			_parent[i] = -1;
+			_dirty[i] = 1;
+		}
+	}
+
+	// Depth and island of every live slot. Islands are the subtrees
+	// starting from the children of the roots, they don't depend on each
+	// other so they can be updated in parallel. Sorting by island and depth
+	// gives a topological order with every island in a contiguous range.
+	// Depths are memoized so long chains are only walked once.
+	uint32_t const UNKNOWN = 0xFFFFFFFF;
+	std::vector<uint32_t> depth(n, UNKNOWN);
+	std::vector<uint32_t> island(n, 0);
+	std::vector<uint32_t> path;
+	for(size_t i = 0; i < n; ++i)
+	{
+		if(_handles[i] == INVALID_HANDLE || depth[i] != UNKNOWN)
+		{ continue; }
+
+		path.clear();
+		int32_t p = int32_t(i);
+		while(p >= 0 && depth[p] == UNKNOWN)
+		{
+			path.push_back(uint32_t(p));
+			if(path.size() > n)
+			{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Cycle in animation graph.")); }
+			p = _parent[p];
+		}
+
+		uint32_t d = (p < 0 ? 0 : depth[p]+1);
+		for(std::vector<uint32_t>::reverse_iterator iter = path.rbegin();
+			iter != path.rend(); ++iter)
+		{
+			uint32_t s = *iter;
+			depth[s] = d;
+			if(d == 1)
+			{ island[s] = s+1; }
+			else if(d > 1)
+			{ island[s] = island[_parent[s]]; }
+			++d;
+		}
+	}
+
+	std::vector<SlotOrder> order;
+	order.reserve(n - _n_dead);
+	for(size_t i = 0; i < n; ++i)
+	{
+		if(_handles[i] != INVALID_HANDLE)
+		{
+			SlotOrder o = { island[i], depth[i], uint32_t(i) };
+			order.push_back(o);
+		}
+	}
+	std::sort(order.begin(), order.end());
+
+	size_t n_live = order.size();
+	std::vector<int32_t> new_slot(n, -1);
+	for(size_t i = 0; i < n_live; ++i)
+	{ new_slot[order[i].slot] = int32_t(i); }
+
+	std::vector<vl::Transform> local(n_live);
+	std::vector<vl::Transform> world(n_live);
+	std::vector<int32_t> parent(n_live);
+	std::vector<uint8_t> dirty(n_live);
+	std::vector<Handle> handles(n_live);
+	_n_roots = 0;
+	_islands.clear();
+	for(size_t s = 0; s < n_live; ++s)
+	{
+		uint32_t i = order[s].slot;
+
+		local[s] = _local[i];
+		world[s] = _world[i];
+		parent[s] = (_parent[i] < 0 ? -1 : new_slot[_parent[i]]);
+		dirty[s] = _dirty[i];
+		handles[s] = _handles[i];
+		_slots[_handles[i]] = uint32_t(s);
+
+		if(order[s].island == 0)
+		{ ++_n_roots; }
+		// Store the end of the island
+		else if(s+1 == n_live || order[s+1].island != order[s].island)
+		{ _islands.push_back(uint32_t(s+1)); }
+	}
+
+	_local.swap(local);
+	_world.swap(world);
+	_parent.swap(parent);
+	_dirty.swap(dirty);
+	_handles.swap(handles);
+
+	_n_dead = 0;
+	_topology_dirty = false;
+}
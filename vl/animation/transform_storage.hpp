@@ -0,0 +1,153 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file animation/transform_storage.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/*
+ *	Internal Kinematic animation implementation. Defined in a separate namespace.
+ *
+ *	Structure of arrays storage for the animation graph transformations.
+ *	Every Node and Link owns a handle to a slot in the storage, handles
+ *	are stable but slots are reordered when the topology changes so that
+ *	parents are always before their children. This allows updating the
+ *	world transformations of the whole graph in one forward pass over
+ *	contiguous arrays.
+ *
+ *	Slots are grouped into islands, subtrees starting from the children of
+ *	the root slots. Islands don't depend on each other so they can be
+ *	updated in parallel with the same results as the serial update.
+ */
+
+#ifndef HYDRA_ANIMATION_TRANSFORM_STORAGE_HPP
+#define HYDRA_ANIMATION_TRANSFORM_STORAGE_HPP
+
+#include <vector>
+
+#include "math/transform.hpp"
+
+#include "base/thread_pool.hpp"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+
+namespace vl
+{
+
+namespace animation
+{
+
+class TransformStorage;
+
+typedef boost::shared_ptr<TransformStorage> TransformStorageRefPtr;
+
+class TransformStorage
+{
+public :
+	typedef uint32_t Handle;
+
+	static const Handle INVALID_HANDLE = 0xFFFFFFFF;
+
+	TransformStorage(void);
+
+	/// @brief allocate a new slot without a parent
+	/// @param t local transformation for the slot
+	/// @return handle that stays valid until released
+	Handle allocate(vl::Transform const &t);
+
+	/// @brief release a slot
+	/// Children of the slot are detached on the next update.
+	void release(Handle h);
+
+	/// @brief set the parent of a slot
+	/// @param parent INVALID_HANDLE to detach
+	void setParent(Handle h, Handle parent);
+
+	/// @return parent handle or INVALID_HANDLE if the slot has no parent
+	Handle getParent(Handle h) const;
+
+	/// @brief get local transformation
+	/// Returned by value because slots are reordered by allocate and by
+	/// an update after release or setParent.
+	vl::Transform getTransform(Handle h) const
+	{ return _local[_slots[h]]; }
+
+	/// @brief set local transformation and mark the slot dirty
+	void setTransform(Handle h, vl::Transform const &t)
+	{
+		uint32_t s = _slots[h];
+		_local[s] = t;
+		_dirty[s] = 1;
+	}
+
+	/// @brief calculate the current world transformation by walking the parents
+	/// Does not use or modify the cache.
+	vl::Transform getWorldTransform(Handle h) const;
+
+	/// @brief get the world transformation calculated by the last update
+	/// Returned by value for the same reason as getTransform.
+	vl::Transform getCachedWorldTransform(Handle h) const
+	{ return _world[_slots[h]]; }
+
+	/// @brief update cached world transformations of all dirty slots and
+	/// their descendants
+	/// @param pool if not NULL islands are updated in parallel
+	void update(ThreadPool *pool = 0);
+
+	/// @brief number of live slots
+	size_t size(void) const
+	{ return _local.size() - _n_dead; }
+
+	/// @brief number of independent subtrees, valid after update
+	size_t getNIslands(void) const
+	{ return _islands.size(); }
+
+	/// @brief changes every time a slot is reparented or released
+	/// For caching data that depends on the hierarchy.
+	uint32_t getTopologyVersion(void) const
+	{ return _topology_version; }
+
+private :
+	/// @brief sort slots topologically by islands and remove released slots
+	void _rebuild(void);
+
+	void _update_range(size_t begin, size_t end);
+
+	/// Indexed by handle, slot of the handle
+	std::vector<uint32_t> _slots;
+	std::vector<Handle> _free_handles;
+
+	/// Indexed by slot
+	std::vector<vl::Transform> _local;
+	std::vector<vl::Transform> _world;
+	/// slot of the parent, always smaller than the slot after rebuild
+	std::vector<int32_t> _parent;
+	std::vector<uint8_t> _dirty;
+	/// handle owning the slot, INVALID_HANDLE for released slots
+	std::vector<Handle> _handles;
+
+	/// Roots are in slots [0, _n_roots)
+	size_t _n_roots;
+	/// End slot of every island, islands start after the roots
+	std::vector<uint32_t> _islands;
+
+	size_t _n_dead;
+
+	bool _topology_dirty;
+	uint32_t _topology_version;
+
+};	// class TransformStorage
+
+}	// namespace animation
+
+}	// namespace vl
+
+#endif	// HYDRA_ANIMATION_TRANSFORM_STORAGE_HPP
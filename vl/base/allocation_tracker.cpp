@@ -0,0 +1,203 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file base/allocation_tracker.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+// Interface
+#include "allocation_tracker.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#if defined _MSC_VER
+#	define HYDRA_THREAD_LOCAL __declspec(thread)
+#else
+#	define HYDRA_THREAD_LOCAL __thread
+#endif
+
+namespace
+{
+
+/// The counters are used from operator new so they can't allocate,
+/// plain arrays only written by the tracked thread.
+HYDRA_THREAD_LOCAL bool tracked_thread = false;
+HYDRA_THREAD_LOCAL vl::ALLOC_SUBSYSTEM current_subsystem = vl::AS_OTHER;
+
+size_t frame_allocations[vl::AS_SIZE];
+size_t frame_bytes[vl::AS_SIZE];
+
+#ifdef HYDRA_TRACK_ALLOCATIONS
+inline void
+count_allocation(size_t bytes)
+{
+	if(tracked_thread)
+	{
+		++frame_allocations[current_subsystem];
+		frame_bytes[current_subsystem] += bytes;
+	}
+}
+
+inline void *
+tracked_malloc(size_t bytes)
+{
+	count_allocation(bytes);
+	void *mem = std::malloc(bytes == 0 ? 1 : bytes);
+	if(!mem)
+	{ throw std::bad_alloc(); }
+	return mem;
+}
+#endif
+
+}	// unamed namespace
+
+#ifdef HYDRA_TRACK_ALLOCATIONS
+
+// With shared libraries on Windows the replacement only covers HydraMain.
+#if __cplusplus >= 201103L
+#	define HYDRA_NEW_THROW
+#else
+#	define HYDRA_NEW_THROW throw(std::bad_alloc)
+#endif
+
+void *
+operator new(std::size_t bytes) HYDRA_NEW_THROW
+{ return tracked_malloc(bytes); }
+
+void *
+operator new[](std::size_t bytes) HYDRA_NEW_THROW
+{ return tracked_malloc(bytes); }
+
+void
+operator delete(void *mem) throw()
+{ std::free(mem); }
+
+void
+operator delete[](void *mem) throw()
+{ std::free(mem); }
+
+#endif	// HYDRA_TRACK_ALLOCATIONS
+
+char const *
+vl::getSubsystemName(vl::ALLOC_SUBSYSTEM sub)
+{
+	switch(sub)
+	{
+	case AS_OTHER :
+		return "Other";
+	case AS_EVENTS :
+		return "Events";
+	case AS_PYTHON :
+		return "Python";
+	case AS_SCENE_GRAPH :
+		return "Scene graph";
+	case AS_PHYSICS :
+		return "Physics";
+	case AS_NETWORK :
+		return "Network";
+	case AS_RENDERING :
+		return "Rendering";
+	default :
+		return "Unknown";
+	}
+}
+
+/// --------------------------- AllocationTracker ----------------------------
+vl::AllocationTracker::AllocationTracker(void)
+	: _enabled(false)
+{
+	for(size_t i = 0; i < AS_SIZE; ++i)
+	{
+		std::string name(getSubsystemName(ALLOC_SUBSYSTEM(i)));
+		_allocations[i] = &_report[name + " allocations"];
+		_bytes[i] = &_report[name + " bytes"];
+	}
+}
+
+vl::AllocationTracker::~AllocationTracker(void)
+{
+	setEnabled(false);
+}
+
+void
+vl::AllocationTracker::setEnabled(bool enable)
+{
+	if(_enabled == enable)
+	{ return; }
+
+	_enabled = enable;
+	tracked_thread = enable;
+	for(size_t i = 0; i < AS_SIZE; ++i)
+	{
+		frame_allocations[i] = 0;
+		frame_bytes[i] = 0;
+	}
+}
+
+bool
+vl::AllocationTracker::isAvailable(void)
+{
+#ifdef HYDRA_TRACK_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+vl::AllocationCount
+vl::AllocationTracker::getFrameCount(vl::ALLOC_SUBSYSTEM sub) const
+{
+	AllocationCount count;
+	count.allocations = frame_allocations[sub];
+	count.bytes = frame_bytes[sub];
+	return count;
+}
+
+vl::AllocationCount
+vl::AllocationTracker::finishFrame(void)
+{
+	AllocationCount total;
+	if(!_enabled)
+	{ return total; }
+
+	// Copy first, pushing to the report can allocate
+	size_t allocations[AS_SIZE];
+	size_t bytes[AS_SIZE];
+	for(size_t i = 0; i < AS_SIZE; ++i)
+	{
+		allocations[i] = frame_allocations[i];
+		bytes[i] = frame_bytes[i];
+		frame_allocations[i] = 0;
+		frame_bytes[i] = 0;
+	}
+
+	for(size_t i = 0; i < AS_SIZE; ++i)
+	{
+		_allocations[i]->push(allocations[i]);
+		_bytes[i]->push(bytes[i]);
+		total.allocations += allocations[i];
+		total.bytes += bytes[i];
+	}
+
+	return total;
+}
+
+/// ---------------------------- AllocationScope -----------------------------
+vl::AllocationScope::AllocationScope(vl::ALLOC_SUBSYSTEM sub)
+	: _previous(current_subsystem)
+{
+	current_subsystem = sub;
+}
+
+vl::AllocationScope::~AllocationScope(void)
+{
+	current_subsystem = _previous;
+}
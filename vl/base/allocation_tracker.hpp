@@ -0,0 +1,122 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file base/allocation_tracker.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/*
+ *	Counts the heap allocations of the frame thread.
+ *
+ *	Allocations are counted by replacing the global operator new, which
+ *	is only done when built with HYDRA_TRACK_ALLOCATIONS. Without it the
+ *	tracker is available but the counts stay zero.
+ *
+ *	Allocations are attributed to the subsystem of the innermost
+ *	AllocationScope, the counts of a frame are pushed to a Report with
+ *	finishFrame. Only the thread that enabled the tracker is counted.
+ */
+
+#ifndef HYDRA_BASE_ALLOCATION_TRACKER_HPP
+#define HYDRA_BASE_ALLOCATION_TRACKER_HPP
+
+#include <cstddef>
+
+#include "report.hpp"
+
+namespace vl
+{
+
+enum ALLOC_SUBSYSTEM
+{
+	AS_OTHER,
+	AS_EVENTS,
+	AS_PYTHON,
+	AS_SCENE_GRAPH,
+	AS_PHYSICS,
+	AS_NETWORK,
+	AS_RENDERING,
+	AS_SIZE,	// Keep as a last element used to determine size
+};
+
+char const *getSubsystemName(ALLOC_SUBSYSTEM sub);
+
+struct AllocationCount
+{
+	AllocationCount(void)
+		: allocations(0), bytes(0)
+	{}
+
+	size_t allocations;
+	size_t bytes;
+};
+
+class AllocationTracker
+{
+public :
+	AllocationTracker(void);
+
+	~AllocationTracker(void);
+
+	/// @brief start or stop counting the allocations of the calling thread
+	void setEnabled(bool enable);
+
+	bool isEnabled(void) const
+	{ return _enabled; }
+
+	/// @brief are allocations counted in this build
+	static bool isAvailable(void);
+
+	/// @brief counts since the last finishFrame
+	AllocationCount getFrameCount(ALLOC_SUBSYSTEM sub) const;
+
+	/// @brief push the counts of the frame to the report and restart counting
+	/// @return total of the frame
+	AllocationCount finishFrame(void);
+
+	/// Average allocations and bytes per frame for every subsystem
+	vl::Report<size_t> &getReport(void)
+	{ return _report; }
+
+private :
+	AllocationTracker(AllocationTracker const &);
+	AllocationTracker &operator=(AllocationTracker const &);
+
+	bool _enabled;
+
+	/// Resolved once so finishFrame doesn't allocate strings
+	vl::Number<size_t> *_allocations[AS_SIZE];
+	vl::Number<size_t> *_bytes[AS_SIZE];
+
+	vl::Report<size_t> _report;
+
+};	// class AllocationTracker
+
+/// @class AllocationScope
+/// @brief attribute the allocations of the calling thread to a subsystem
+/// till the scope is destroyed
+class AllocationScope
+{
+public :
+	AllocationScope(ALLOC_SUBSYSTEM sub);
+
+	~AllocationScope(void);
+
+private :
+	AllocationScope(AllocationScope const &);
+	AllocationScope &operator=(AllocationScope const &);
+
+	ALLOC_SUBSYSTEM _previous;
+
+};	// class AllocationScope
+
+}	// namespace vl
+
+#endif	// HYDRA_BASE_ALLOCATION_TRACKER_HPP
@@ -0,0 +1,118 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file base/frame_arena.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+// Interface
+#include "frame_arena.hpp"
+
+#include <cstdlib>
+
+namespace
+{
+
+size_t
+align(size_t bytes)
+{
+	return (bytes + vl::FrameArena::ALIGNMENT - 1) & ~(vl::FrameArena::ALIGNMENT - 1);
+}
+
+}	// unamed namespace
+
+/// ------------------------------ Public ------------------------------------
+vl::FrameArena::FrameArena(size_t block_size)
+	: _offset(0)
+	, _used_full(0)
+	, _n_heap_allocations(0)
+{
+	_addBlock(block_size);
+}
+
+vl::FrameArena::~FrameArena(void)
+{
+	for(size_t i = 0; i < _blocks.size(); ++i)
+	{ std::free(_blocks[i].data); }
+}
+
+void *
+vl::FrameArena::allocate(size_t bytes)
+{
+	bytes = align(bytes == 0 ? 1 : bytes);
+
+	if(_offset + bytes > _blocks.back().size)
+	{
+		_used_full += _offset;
+		// Double the size so a frame needs only a few blocks
+		size_t size = _blocks.back().size*2;
+		_addBlock(size > bytes ? size : bytes);
+		_offset = 0;
+	}
+
+	void *mem = _blocks.back().data + _offset;
+	_offset += bytes;
+	return mem;
+}
+
+void
+vl::FrameArena::reset(void)
+{
+	if(_blocks.size() > 1)
+	{
+		// Replace with a block that fits the whole frame
+		size_t size = getCapacity();
+		for(size_t i = 0; i < _blocks.size(); ++i)
+		{ std::free(_blocks[i].data); }
+		_blocks.clear();
+		_addBlock(size);
+	}
+
+	_offset = 0;
+	_used_full = 0;
+}
+
+size_t
+vl::FrameArena::getUsed(void) const
+{
+	return _used_full + _offset;
+}
+
+size_t
+vl::FrameArena::getCapacity(void) const
+{
+	size_t size = 0;
+	for(size_t i = 0; i < _blocks.size(); ++i)
+	{ size += _blocks[i].size; }
+	return size;
+}
+
+vl::FrameArena &
+vl::FrameArena::frame(void)
+{
+	static FrameArena arena;
+	return arena;
+}
+
+/// ------------------------------ Private -----------------------------------
+void
+vl::FrameArena::_addBlock(size_t size)
+{
+	Block block;
+	block.size = align(size == 0 ? 1 : size);
+	// malloc is aligned for any primitive type
+	block.data = (char *)std::malloc(block.size);
+	if(!block.data)
+	{ throw std::bad_alloc(); }
+
+	// Blocks are rarely added, the vector keeps its capacity on reset
+	_blocks.push_back(block);
+	++_n_heap_allocations;
+}
@@ -0,0 +1,156 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file base/frame_arena.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/*
+ *	Linear allocator for temporaries that live at most one frame.
+ *
+ *	Allocations are bumped from a block and never freed individually,
+ *	the whole arena is released with reset at the end of the frame.
+ *	If a frame needs more than one block they are replaced with a single
+ *	block big enough for the whole frame on reset, so after the first
+ *	frames the arena doesn't allocate from the heap.
+ *
+ *	ArenaAllocator can be used with the standard containers, e.g.
+ *	std::vector<uint64_t, vl::ArenaAllocator<uint64_t> > for temporary
+ *	ID lists. Containers using the arena must not outlive the frame.
+ *
+ *	Not thread safe, the frame arena is only used from the frame thread.
+ */
+
+#ifndef HYDRA_BASE_FRAME_ARENA_HPP
+#define HYDRA_BASE_FRAME_ARENA_HPP
+
+#include <cstddef>
+#include <vector>
+#include <new>
+
+#include <boost/noncopyable.hpp>
+
+namespace vl
+{
+
+class FrameArena : boost::noncopyable
+{
+public :
+	/// Alignment of all allocations, enough for any primitive type
+	static size_t const ALIGNMENT = 16;
+
+	/// @param block_size size of the first block in bytes
+	FrameArena(size_t block_size = 64*1024);
+
+	~FrameArena(void);
+
+	/// @brief allocate memory that is valid till the next reset
+	void *allocate(size_t bytes);
+
+	/// @brief release everything allocated since the last reset
+	void reset(void);
+
+	/// @brief bytes allocated since the last reset
+	size_t getUsed(void) const;
+
+	/// @brief total size of the blocks
+	size_t getCapacity(void) const;
+
+	/// @brief number of blocks allocated from the heap since construction
+	size_t getNHeapAllocations(void) const
+	{ return _n_heap_allocations; }
+
+	/// @brief arena used for the frame temporaries, reset by the frame loop
+	static FrameArena &frame(void);
+
+private :
+	struct Block
+	{
+		char *data;
+		size_t size;
+	};
+
+	void _addBlock(size_t size);
+
+	std::vector<Block> _blocks;
+
+	/// Position in the last block
+	size_t _offset;
+
+	/// Bytes used in the blocks before the last one
+	size_t _used_full;
+
+	size_t _n_heap_allocations;
+
+};	// class FrameArena
+
+/// @class ArenaAllocator
+/// @brief standard allocator using a FrameArena, deallocate does nothing
+template<typename T>
+class ArenaAllocator
+{
+public :
+	typedef T value_type;
+	typedef T *pointer;
+	typedef T const *const_pointer;
+	typedef T &reference;
+	typedef T const &const_reference;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	template<typename U>
+	struct rebind
+	{ typedef ArenaAllocator<U> other; };
+
+	ArenaAllocator(FrameArena &arena = FrameArena::frame())
+		: _arena(&arena)
+	{}
+
+	template<typename U>
+	ArenaAllocator(ArenaAllocator<U> const &other)
+		: _arena(other._arena)
+	{}
+
+	pointer address(reference x) const
+	{ return &x; }
+
+	const_pointer address(const_reference x) const
+	{ return &x; }
+
+	pointer allocate(size_type n, void const * = 0)
+	{ return (pointer)_arena->allocate(n*sizeof(T)); }
+
+	void deallocate(pointer, size_type)
+	{}
+
+	size_type max_size(void) const
+	{ return size_type(-1)/sizeof(T); }
+
+	void construct(pointer p, T const &val)
+	{ new ((void *)p) T(val); }
+
+	void destroy(pointer p)
+	{ p->~T(); }
+
+	template<typename U>
+	bool operator==(ArenaAllocator<U> const &other) const
+	{ return _arena == other._arena; }
+
+	template<typename U>
+	bool operator!=(ArenaAllocator<U> const &other) const
+	{ return _arena != other._arena; }
+
+	FrameArena *_arena;
+
+};	// class ArenaAllocator
+
+}	// namespace vl
+
+#endif	// HYDRA_BASE_FRAME_ARENA_HPP
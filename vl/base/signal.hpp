@@ -0,0 +1,263 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file base/signal.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Lightweight single threaded signal.
+ *
+ *	Replacement for boost::signal on the frame thread. Slots are
+ *	boost::functions stored in a vector, emitting calls them in connection
+ *	order without locking or allocating.
+ *
+ *	Slots can be connected and disconnected from a slot while the signal
+ *	is emitted, new slots are called from the next emit and disconnected
+ *	ones are removed when the emit has finished.
+ *
+ *	Not thread safe, all calls need to be made from the same thread.
+ *	Connecting from a restricted thread throws, see base/thread_check.hpp.
+ *	Only void return type is supported.
+ */
+
+#ifndef HYDRA_BASE_SIGNAL_HPP
+#define HYDRA_BASE_SIGNAL_HPP
+
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+
+#include "thread_check.hpp"
+
+#include <vector>
+#include <cstddef>
+
+namespace vl
+{
+
+/// @brief storage and connection management shared by all signals
+template<typename Signature>
+class SignalBase : public boost::noncopyable
+{
+public :
+	typedef boost::function<Signature> slot_type;
+	/// Identifier for disconnecting a slot
+	typedef size_t connection;
+
+	SignalBase(void)
+		: _next_id(1), _emitting(0), _n_disconnected(0)
+	{}
+
+	connection connect(slot_type const &slot)
+	{
+		vl::checkFrameThread("Listeners");
+
+		Slot s(slot, _next_id++);
+		if(_emitting > 0)
+		{ _pending.push_back(s); }
+		else
+		{
+			// Listeners are usually added in batches
+			if(_slots.capacity() == 0)
+			{ _slots.reserve(4); }
+			_slots.push_back(s);
+		}
+		return s.id;
+	}
+
+	void disconnect(connection id)
+	{
+		vl::checkFrameThread("Listeners");
+
+		for(size_t i = 0; i < _slots.size(); ++i)
+		{
+			if(_slots[i].id == id)
+			{ _remove(i); return; }
+		}
+		for(size_t i = 0; i < _pending.size(); ++i)
+		{
+			if(_pending[i].id == id)
+			{ _pending.erase(_pending.begin() + i); return; }
+		}
+	}
+
+	void disconnect_all_slots(void)
+	{
+		vl::checkFrameThread("Listeners");
+
+		if(_emitting > 0)
+		{
+			for(size_t i = 0; i < _slots.size(); ++i)
+			{ _remove(i); }
+		}
+		else
+		{ _slots.clear(); }
+		_pending.clear();
+	}
+
+	bool empty(void) const
+	{ return num_slots() == 0; }
+
+	size_t num_slots(void) const
+	{ return _slots.size() + _pending.size() - _n_disconnected; }
+
+protected :
+	struct Slot
+	{
+		Slot(slot_type const &f, connection i)
+			: function(f), id(i)
+		{}
+
+		slot_type function;
+		connection id;
+	};
+
+	/// Keeps the slot vector stable while emitting even if a slot throws
+	class EmitGuard
+	{
+	public :
+		EmitGuard(SignalBase &signal)
+			: _signal(signal)
+		{ ++_signal._emitting; }
+
+		~EmitGuard(void)
+		{
+			if(--_signal._emitting == 0)
+			{ _signal._finish_emit(); }
+		}
+
+	private :
+		SignalBase &_signal;
+	};
+
+	std::vector<Slot> _slots;
+
+private :
+	void _remove(size_t i)
+	{
+		if(_emitting > 0)
+		{
+			// Removed after the emit so the slot being called is not destroyed
+			if(_slots[i].id != 0)
+			{
+				_slots[i].id = 0;
+				++_n_disconnected;
+			}
+		}
+		else
+		{ _slots.erase(_slots.begin() + i); }
+	}
+
+	void _finish_emit(void)
+	{
+		if(_n_disconnected > 0)
+		{
+			size_t j = 0;
+			for(size_t i = 0; i < _slots.size(); ++i)
+			{
+				if(_slots[i].id != 0)
+				{
+					if(i != j)
+					{ _slots[j] = _slots[i]; }
+					++j;
+				}
+			}
+			_slots.resize(j, Slot(slot_type(), 0));
+			_n_disconnected = 0;
+		}
+
+		if(!_pending.empty())
+		{
+			_slots.insert(_slots.end(), _pending.begin(), _pending.end());
+			_pending.clear();
+		}
+	}
+
+	std::vector<Slot> _pending;
+
+	connection _next_id;
+	size_t _emitting;
+	size_t _n_disconnected;
+
+};	// class SignalBase
+
+template<typename Signature>
+class Signal;
+
+template<>
+class Signal<void ()> : public SignalBase<void ()>
+{
+public :
+	void operator()(void)
+	{
+		EmitGuard guard(*this);
+		size_t n = _slots.size();
+		for(size_t i = 0; i < n; ++i)
+		{
+			if(_slots[i].id != 0)
+			{ _slots[i].function(); }
+		}
+	}
+};
+
+template<typename A1>
+class Signal<void (A1)> : public SignalBase<void (A1)>
+{
+	typedef SignalBase<void (A1)> Base;
+public :
+	void operator()(A1 a1)
+	{
+		typename Base::EmitGuard guard(*this);
+		size_t n = this->_slots.size();
+		for(size_t i = 0; i < n; ++i)
+		{
+			if(this->_slots[i].id != 0)
+			{ this->_slots[i].function(a1); }
+		}
+	}
+};
+
+template<typename A1, typename A2>
+class Signal<void (A1, A2)> : public SignalBase<void (A1, A2)>
+{
+	typedef SignalBase<void (A1, A2)> Base;
+public :
+	void operator()(A1 a1, A2 a2)
+	{
+		typename Base::EmitGuard guard(*this);
+		size_t n = this->_slots.size();
+		for(size_t i = 0; i < n; ++i)
+		{
+			if(this->_slots[i].id != 0)
+			{ this->_slots[i].function(a1, a2); }
+		}
+	}
+};
+
+template<typename A1, typename A2, typename A3>
+class Signal<void (A1, A2, A3)> : public SignalBase<void (A1, A2, A3)>
+{
+	typedef SignalBase<void (A1, A2, A3)> Base;
+public :
+	void operator()(A1 a1, A2 a2, A3 a3)
+	{
+		typename Base::EmitGuard guard(*this);
+		size_t n = this->_slots.size();
+		for(size_t i = 0; i < n; ++i)
+		{
+			if(this->_slots[i].id != 0)
+			{ this->_slots[i].function(a1, a2, a3); }
+		}
+	}
+};
+
+}	// namespace vl
+
+#endif	// HYDRA_BASE_SIGNAL_HPP
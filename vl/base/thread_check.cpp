@@ -0,0 +1,33 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file base/thread_check.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+// Interface
+#include "thread_check.hpp"
+
+#include "exceptions.hpp"
+
+vl::ThreadCheck &
+vl::_frameThreadCheck(void)
+{
+	static ThreadCheck check = 0;
+	return check;
+}
+
+void
+vl::_throwNotFrameThread(char const *what)
+{
+	std::string msg(what);
+	msg += " can only be modified from the frame thread.";
+	BOOST_THROW_EXCEPTION(vl::exception() << vl::desc(msg));
+}
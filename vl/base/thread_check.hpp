@@ -0,0 +1,55 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file base/thread_check.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/*
+ *	Check for threads that are not allowed to modify the engine objects.
+ *
+ *	Scene, physics and events are only modified from the frame thread.
+ *	Threads that share the engine objects but must not modify them,
+ *	e.g. Python task workers, install a check that the objects call
+ *	before modifications. Without a check every thread is allowed.
+ */
+
+#ifndef HYDRA_BASE_THREAD_CHECK_HPP
+#define HYDRA_BASE_THREAD_CHECK_HPP
+
+#include "defines.hpp"
+
+namespace vl
+{
+
+/// @return true if the calling thread is allowed to modify the objects
+typedef bool (*ThreadCheck)(void);
+
+/// @internal
+/// @brief the installed check, zero if there is none
+/// Needs to be set before the restricted threads are started.
+HYDRA_API ThreadCheck &_frameThreadCheck(void);
+
+/// @internal
+HYDRA_API void _throwNotFrameThread(char const *what);
+
+/// @brief throws if the calling thread is not allowed to modify the objects
+/// @param what the objects modified, used in the error message
+inline void
+checkFrameThread(char const *what)
+{
+	ThreadCheck check = _frameThreadCheck();
+	if(check && !check())
+	{ _throwNotFrameThread(what); }
+}
+
+}	// namespace vl
+
+#endif	// HYDRA_BASE_THREAD_CHECK_HPP
@@ -0,0 +1,177 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file base/thread_pool.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+#include "thread_pool.hpp"
+
+#include <boost/bind.hpp>
+
+vl::ThreadPool::ThreadPool(size_t n_threads)
+	: _batch(0)
+	, _pending(0)
+	, _quit(false)
+{
+	if(n_threads == 0)
+	{ n_threads = boost::thread::hardware_concurrency(); }
+	if(n_threads == 0)
+	{ n_threads = 1; }
+
+	for(size_t i = 0; i < n_threads; ++i)
+	{ _queues.push_back(new Queue); }
+
+	// Calling thread is the last one
+	for(size_t i = 0; i < n_threads-1; ++i)
+	{ _workers.create_thread(boost::bind(&ThreadPool::_worker_main, this, i)); }
+}
+
+vl::ThreadPool::~ThreadPool(void)
+{
+	{
+		boost::lock_guard<boost::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_work_cond.notify_all();
+	_workers.join_all();
+
+	for(size_t i = 0; i < _queues.size(); ++i)
+	{ delete _queues.at(i); }
+}
+
+void
+vl::ThreadPool::run(std::vector<Task> const &tasks)
+{
+	if(tasks.empty())
+	{ return; }
+
+	// No reason to wake up the workers
+	if(_queues.size() == 1 || tasks.size() == 1)
+	{
+		for(size_t i = 0; i < tasks.size(); ++i)
+		{ tasks.at(i)(); }
+		return;
+	}
+
+	// Pending needs to be set before the tasks are queued because workers
+	// still finishing the previous batch might pick them up immediately.
+	{
+		boost::lock_guard<boost::mutex> lock(_mutex);
+		_pending = tasks.size();
+	}
+
+	for(size_t i = 0; i < tasks.size(); ++i)
+	{
+		Queue *q = _queues.at(i % _queues.size());
+		boost::lock_guard<boost::mutex> lock(q->mutex);
+		q->tasks.push_back(&tasks.at(i));
+	}
+
+	{
+		boost::lock_guard<boost::mutex> lock(_mutex);
+		++_batch;
+	}
+	_work_cond.notify_all();
+
+	size_t index = _queues.size()-1;
+	while(Task const *task = _pop(index))
+	{ _execute(task); }
+
+	boost::exception_ptr error;
+	{
+		boost::unique_lock<boost::mutex> lock(_mutex);
+		while(_pending != 0)
+		{ _done_cond.wait(lock); }
+		error = _error;
+		_error = boost::exception_ptr();
+	}
+
+	if(error)
+	{ boost::rethrow_exception(error); }
+}
+
+void
+vl::ThreadPool::_worker_main(size_t index)
+{
+	size_t batch = 0;
+	while(true)
+	{
+		{
+			boost::unique_lock<boost::mutex> lock(_mutex);
+			while(!_quit && _batch == batch)
+			{ _work_cond.wait(lock); }
+
+			if(_quit)
+			{ return; }
+
+			batch = _batch;
+		}
+
+		while(Task const *task = _pop(index))
+		{ _execute(task); }
+	}
+}
+
+vl::ThreadPool::Task const *
+vl::ThreadPool::_pop(size_t index)
+{
+	// Own queue from the back
+	{
+		Queue *q = _queues.at(index);
+		boost::lock_guard<boost::mutex> lock(q->mutex);
+		if(!q->tasks.empty())
+		{
+			Task const *task = q->tasks.back();
+			q->tasks.pop_back();
+			return task;
+		}
+	}
+
+	// Steal from the front of the others
+	for(size_t i = 1; i < _queues.size(); ++i)
+	{
+		Queue *q = _queues.at((index + i) % _queues.size());
+		boost::lock_guard<boost::mutex> lock(q->mutex);
+		if(!q->tasks.empty())
+		{
+			Task const *task = q->tasks.front();
+			q->tasks.pop_front();
+			return task;
+		}
+	}
+
+	return 0;
+}
+
+void
+vl::ThreadPool::_execute(Task const *task)
+{
+	try
+	{
+		(*task)();
+	}
+	catch(...)
+	{
+		boost::lock_guard<boost::mutex> lock(_mutex);
+		if(!_error)
+		{ _error = boost::current_exception(); }
+	}
+
+	bool done = false;
+	{
+		boost::lock_guard<boost::mutex> lock(_mutex);
+		--_pending;
+		done = (_pending == 0);
+	}
+
+	if(done)
+	{ _done_cond.notify_all(); }
+}
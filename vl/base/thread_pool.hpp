@@ -0,0 +1,102 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file base/thread_pool.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/*
+ *	Fork-join thread pool with work stealing.
+ *
+ *	Tasks are submitted in batches with run which returns when all the
+ *	tasks in the batch have been executed. Every worker has it's own queue,
+ *	tasks are distributed to the queues round robin and idle workers steal
+ *	from the others. The calling thread works on the batch too, so a pool
+ *	with one thread executes everything in the caller.
+ *
+ *	Meant for coarse tasks, e.g. independent kinematic chains, queues are
+ *	protected by mutexes.
+ */
+
+#ifndef HYDRA_BASE_THREAD_POOL_HPP
+#define HYDRA_BASE_THREAD_POOL_HPP
+
+#include <vector>
+#include <deque>
+
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace vl
+{
+
+class ThreadPool : boost::noncopyable
+{
+public :
+	typedef boost::function<void (void)> Task;
+
+	/// @brief constructor
+	/// @param n_threads number of threads including the calling thread
+	/// zero uses the number of hardware threads.
+	ThreadPool(size_t n_threads = 0);
+
+	/// @brief destructor, waits for the workers to exit
+	~ThreadPool(void);
+
+	/// @brief number of threads executing tasks including the caller
+	size_t getNThreads(void) const
+	{ return _queues.size(); }
+
+	/// @brief execute all tasks and wait for them to finish
+	/// Order of execution is not defined.
+	/// If any of the tasks throws the first exception is rethrown
+	/// after all the tasks have finished.
+	void run(std::vector<Task> const &tasks);
+
+private :
+	struct Queue
+	{
+		boost::mutex mutex;
+		std::deque<Task const *> tasks;
+	};
+
+	void _worker_main(size_t index);
+
+	/// @brief pop from own queue or steal from others
+	/// @return NULL if there is no tasks left
+	Task const *_pop(size_t index);
+
+	void _execute(Task const *task);
+
+	/// One per thread, last one is for the calling thread
+	std::vector<Queue *> _queues;
+
+	boost::thread_group _workers;
+
+	boost::mutex _mutex;
+	boost::condition_variable _work_cond;
+	boost::condition_variable _done_cond;
+
+	/// Incremented for every batch so sleeping workers know there is new work
+	size_t _batch;
+	size_t _pending;
+	bool _quit;
+
+	boost::exception_ptr _error;
+
+};	// class ThreadPool
+
+}	// namespace vl
+
+#endif	// HYDRA_BASE_THREAD_POOL_HPP
@@ -0,0 +1,230 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file base/timer_wheel.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+// Interface
+#include "timer_wheel.hpp"
+
+#include <cassert>
+
+namespace
+{
+
+/// Circular list head
+void init_head(vl::TimerLink &head)
+{
+	head.prev = &head;
+	head.next = &head;
+}
+
+void push_back(vl::TimerLink &head, vl::TimerLink *link)
+{
+	link->prev = head.prev;
+	link->next = &head;
+	head.prev->next = link;
+	head.prev = link;
+}
+
+/// @brief move all the links from one list to another, from is left empty
+void splice(vl::TimerLink &from, vl::TimerLink &to)
+{
+	init_head(to);
+	if(from.next != &from)
+	{
+		to.next = from.next;
+		to.prev = from.prev;
+		to.next->prev = &to;
+		to.prev->next = &to;
+		init_head(from);
+	}
+}
+
+}	// unamed namespace
+
+/// ---------------------------- TimerLink -----------------------------------
+void
+vl::TimerLink::unlink(void)
+{
+	if(next)
+	{
+		prev->next = next;
+		next->prev = prev;
+		prev = 0;
+		next = 0;
+	}
+}
+
+/// ---------------------------- TimerWheelEntry -----------------------------
+vl::TimerWheelEntry::~TimerWheelEntry(void)
+{
+	cancel();
+}
+
+void
+vl::TimerWheelEntry::cancel(void)
+{
+	if(linked())
+	{
+		unlink();
+		assert(_wheel);
+		_wheel->_removed();
+	}
+}
+
+/// ---------------------------- TimerWheel ----------------------------------
+vl::TimerWheel::TimerWheel(uint64_t resolution)
+	: _resolution(resolution)
+	, _now(0)
+	, _tick(0)
+	, _size(0)
+	, _advancing(false)
+{
+	assert(_resolution > 0);
+
+	for(size_t l = 0; l < LEVELS; ++l)
+	{
+		for(size_t i = 0; i < SLOTS; ++i)
+		{ init_head(_slots[l][i]); }
+	}
+	init_head(_deferred);
+}
+
+vl::TimerWheel::~TimerWheel(void)
+{
+	// Entries can outlive the wheel
+	for(size_t l = 0; l < LEVELS; ++l)
+	{
+		for(size_t i = 0; i < SLOTS; ++i)
+		{
+			while(_slots[l][i].next != &_slots[l][i])
+			{ static_cast<TimerWheelEntry *>(_slots[l][i].next)->cancel(); }
+		}
+	}
+
+	while(_deferred.next != &_deferred)
+	{ static_cast<TimerWheelEntry *>(_deferred.next)->cancel(); }
+}
+
+void
+vl::TimerWheel::schedule(vl::TimerWheelEntry *entry, uint64_t due)
+{
+	assert(entry);
+
+	entry->cancel();
+	entry->_wheel = this;
+	entry->_due = due;
+	++_size;
+
+	if(_advancing)
+	{ push_back(_deferred, entry); }
+	else
+	{ _insert(entry); }
+}
+
+size_t
+vl::TimerWheel::advance(uint64_t now)
+{
+	assert(!_advancing);
+	if(now < _now)
+	{ return 0; }
+
+	_now = now;
+	_advancing = true;
+
+	size_t n_expired = 0;
+	uint64_t target = now/_resolution;
+	while(_tick <= target)
+	{
+		size_t index = _tick & SLOT_MASK;
+		// Wrapped around so the next higher level slot is moved down
+		if(index == 0)
+		{
+			for(size_t l = 1; l < LEVELS && _cascade(l) == 0; ++l)
+			{}
+		}
+
+		TimerLink list;
+		splice(_slots[0][index], list);
+		++_tick;
+
+		// Callbacks can cancel any entry in the list
+		while(list.next != &list)
+		{
+			TimerWheelEntry *entry = static_cast<TimerWheelEntry *>(list.next);
+			if(entry->_due <= now)
+			{
+				entry->cancel();
+				entry->_timeout();
+				++n_expired;
+			}
+			// Due later in this tick, moved to the next one
+			else
+			{
+				entry->unlink();
+				_insert(entry);
+			}
+		}
+	}
+
+	_advancing = false;
+
+	TimerLink list;
+	splice(_deferred, list);
+	while(list.next != &list)
+	{
+		TimerWheelEntry *entry = static_cast<TimerWheelEntry *>(list.next);
+		entry->unlink();
+		_insert(entry);
+	}
+
+	return n_expired;
+}
+
+/// ---------------------------- Private -------------------------------------
+void
+vl::TimerWheel::_insert(vl::TimerWheelEntry *entry)
+{
+	uint64_t tick = entry->_due/_resolution;
+	if(tick < _tick)
+	{ tick = _tick; }
+
+	uint64_t delta = tick - _tick;
+	size_t level = 0;
+	while(level+1 < LEVELS && delta >= (uint64_t(1) << ((level+1)*SLOT_BITS)))
+	{ ++level; }
+
+	// Further than the wheel can hold, it's cascaded again till it's due
+	uint64_t const max_delta = (uint64_t(1) << (LEVELS*SLOT_BITS)) - 1;
+	if(delta > max_delta)
+	{ tick = _tick + max_delta; }
+
+	size_t index = (tick >> (level*SLOT_BITS)) & SLOT_MASK;
+	push_back(_slots[level][index], entry);
+}
+
+size_t
+vl::TimerWheel::_cascade(size_t level)
+{
+	size_t index = (_tick >> (level*SLOT_BITS)) & SLOT_MASK;
+
+	TimerLink list;
+	splice(_slots[level][index], list);
+	while(list.next != &list)
+	{
+		TimerWheelEntry *entry = static_cast<TimerWheelEntry *>(list.next);
+		entry->unlink();
+		_insert(entry);
+	}
+
+	return index;
+}
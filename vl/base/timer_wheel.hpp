@@ -0,0 +1,156 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file base/timer_wheel.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Hierarchical timer wheel.
+ *
+ *	Timers are kept in four levels of 256 slots, a timer is in the level
+ *	that has the resolution for its remaining time and it's moved to the
+ *	lower levels as the time gets closer. Scheduling and cancelling are
+ *	constant time operations on intrusive lists and advancing the wheel
+ *	only touches the slots for the ticks that have passed.
+ *
+ *	Times are in microseconds, the tick is 1ms by default. Timers expire
+ *	on the first advance where they are due, with at most one tick delay.
+ */
+
+#ifndef HYDRA_BASE_TIMER_WHEEL_HPP
+#define HYDRA_BASE_TIMER_WHEEL_HPP
+
+#include <stdint.h>
+#include <cstddef>
+
+#include "time.hpp"
+
+namespace vl
+{
+
+class TimerWheel;
+
+/// @brief convert time to the microseconds used by the TimerWheel
+inline uint64_t to_microseconds(vl::time const &t)
+{ return uint64_t(t.sec)*1000000 + t.usec; }
+
+/// Intrusive doubly linked list node used for the slots
+struct TimerLink
+{
+	TimerLink(void)
+		: prev(0), next(0)
+	{}
+
+	bool linked(void) const
+	{ return next != 0; }
+
+	void unlink(void);
+
+	TimerLink *prev;
+	TimerLink *next;
+};
+
+/// @brief base class for objects scheduled in a TimerWheel
+class TimerWheelEntry : public TimerLink
+{
+public :
+	TimerWheelEntry(void)
+		: _wheel(0), _due(0)
+	{}
+
+	/// Cancels the timer
+	virtual ~TimerWheelEntry(void);
+
+	bool isScheduled(void) const
+	{ return linked(); }
+
+	/// @brief time the entry expires in microseconds, only valid when scheduled
+	uint64_t getDueTime(void) const
+	{ return _due; }
+
+	/// @brief remove the entry from the wheel, does nothing if not scheduled
+	void cancel(void);
+
+protected :
+	/// @brief called from TimerWheel::advance when the time is due
+	/// Entry is not scheduled anymore when this is called so it can be
+	/// rescheduled from here.
+	virtual void _timeout(void) = 0;
+
+private :
+	friend class TimerWheel;
+
+	TimerWheel *_wheel;
+	uint64_t _due;
+
+};	// class TimerWheelEntry
+
+class TimerWheel
+{
+public :
+	/// @param resolution length of a tick in microseconds
+	TimerWheel(uint64_t resolution = 1000);
+
+	/// Cancels all the scheduled entries
+	~TimerWheel(void);
+
+	/// @brief schedule an entry to expire at due time
+	/// Already scheduled entries are moved, due times in the past expire
+	/// on the next advance. Entries scheduled from expire callbacks
+	/// are not expired in the same advance.
+	void schedule(TimerWheelEntry *entry, uint64_t due);
+
+	/// @brief move the time forward and expire all entries that are due
+	/// @param now current time in microseconds, never decreases
+	/// @return number of expired entries
+	size_t advance(uint64_t now);
+
+	/// @brief time of the last advance
+	uint64_t getTime(void) const
+	{ return _now; }
+
+	/// @brief number of scheduled entries
+	size_t size(void) const
+	{ return _size; }
+
+	/// @internal called when an entry is cancelled
+	void _removed(void)
+	{ --_size; }
+
+private :
+	void _insert(TimerWheelEntry *entry);
+
+	/// @brief move the entries from a slot to the lower levels
+	/// @return the slot index
+	size_t _cascade(size_t level);
+
+	static size_t const LEVELS = 4;
+	static size_t const SLOT_BITS = 8;
+	static size_t const SLOTS = 1 << SLOT_BITS;
+	static size_t const SLOT_MASK = SLOTS - 1;
+
+	TimerLink _slots[LEVELS][SLOTS];
+
+	/// Entries scheduled while advancing, inserted after it
+	TimerLink _deferred;
+
+	uint64_t _resolution;
+	uint64_t _now;
+	/// Next tick to process
+	uint64_t _tick;
+	size_t _size;
+	bool _advancing;
+
+};	// class TimerWheel
+
+}	// namespace vl
+
+#endif	// HYDRA_BASE_TIMER_WHEEL_HPP
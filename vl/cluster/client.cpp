@@ -46,11 +46,7 @@ vl::cluster::SlaveMeshLoaderCallback::loadMesh(std::string const &fileName, vl::
 	}
 	assert(cb);
 
-	/// @todo fix time and frame parameters
-	Message reg_msg(MSG_REG_RESOURCE, 0, vl::time());
-	reg_msg.write(RES_MESH);
-	reg_msg.write(fileName);
-	owner->sendMessage(reg_msg);
+	owner->requestMesh(fileName);
 }
 
 vl::cluster::ClientMessageCallback::ClientMessageCallback(Client *c)
@@ -74,11 +70,8 @@ vl::cluster::ResourceMessageCallback::messageReceived(MessageRefPtr msg)
 
 	if(type == RES_MESH)
 	{
-		vl::MeshRefPtr mesh(new vl::Mesh(name));
-		stream >> (*mesh);
-
-		assert(client && client->getMeshManager());
-		client->getMeshManager()->meshLoaded(name, mesh);
+		assert(client);
+		client->_meshReceived(name, msg);
 	}
 	else
 	{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Unknow Resource type.")); }
@@ -86,12 +79,15 @@ vl::cluster::ResourceMessageCallback::messageReceived(MessageRefPtr msg)
 
 /// ------------------------------ Client -------------------------------------
 vl::cluster::Client::Client( char const *hostname, uint16_t port,
-							 vl::RendererUniquePtr rend )
+							 vl::RendererUniquePtr rend, std::string const &mesh_cache_dir )
 	: _io_service()
 	, _socket( _io_service )
 	, _master()
 	, _state()
 	, _renderer(rend)
+	, _n_mesh_requests(0)
+	, _n_init_received(0)
+	, _init_bytes(0)
 {
 	std::cout << "vl::cluster::Client::Client : Connecting to host "
 		<< hostname << " at port " << port << "." << std::endl;
@@ -104,6 +100,16 @@ vl::cluster::Client::Client( char const *hostname, uint16_t port,
 	_renderer->setMeshManager(mesh_man);
 	addMessageCallback(MSG_RESOURCE, new ResourceMessageCallback(this));
 
+	if(!mesh_cache_dir.empty())
+	{
+		try
+		{ _mesh_cache.reset(new MeshCache(mesh_cache_dir)); }
+		catch(fs::filesystem_error const &e)
+		{
+			std::cout << vl::CRITICAL << "Mesh cache disabled : " << e.what() << std::endl;
+		}
+	}
+
 	std::stringstream ss;
 	ss << port;
 	boost::udp::resolver resolver( _io_service );
@@ -183,13 +189,12 @@ vl::cluster::Client::mainloop(void)
 void
 vl::cluster::Client::sendMessage(vl::cluster::Message const &msg)
 {
-	std::vector<char> buf;
-	std::vector<MessagePart> parts = msg.createParts();
+	msg.createParts(_send_parts);
 
-	for(size_t i = 0; i < parts.size(); ++i)
+	for(size_t i = 0; i < _send_parts.size(); ++i)
 	{
-		parts.at(i).dump(buf);
-		_socket.send_to(boost::asio::buffer(buf), _master);
+		_send_parts.at(i).dump(_send_buf);
+		_socket.send_to(boost::asio::buffer(_send_buf), _master);
 	}
 }
 
@@ -287,20 +292,7 @@ vl::cluster::Client::_handle_message(vl::cluster::Message &msg)
 
 		case vl::cluster::MSG_SG_INIT :
 		{
-			std::clog << "vl::cluster::Client::_handleMessage : "
-					<< "MSG_SG_INIT received." << std::endl;
-			assert(!_state.has_init);
-			
-			uint32_t frame = msg.getFrame();
-			_renderer->updateScene(msg);
-
-			_state.has_init = true;
-			_state.update_frame = frame;
-
-			// request rendering messages when initialised
-			_state.wants_render = true;
-			Message reply(MSG_REG_RENDERING, frame, vl::time());
-			sendMessage(reply);
+			_handle_init_chunk(msg);
 		}
 		break;
 
@@ -488,6 +480,64 @@ vl::cluster::Client::_send_ack(vl::cluster::MSG_TYPES type)
 	sendMessage(msg);
 }
 
+void
+vl::cluster::Client::_handle_init_chunk(vl::cluster::Message &msg)
+{
+	uint32_t chunk;
+	uint32_t n_chunks;
+	msg.read(chunk);
+	msg.read(n_chunks);
+
+	if(_init_received.empty())
+	{
+		std::clog << "vl::cluster::Client::_handleMessage : "
+				<< "MSG_SG_INIT received in " << n_chunks << " chunks." << std::endl;
+		_init_received.resize(n_chunks, false);
+		_init_timer.reset();
+	}
+
+	// Duplicates are only acked, the ack for them was lost
+	if(!_state.has_init && chunk < _init_received.size() && !_init_received.at(chunk))
+	{
+		_init_bytes += msg.size();
+
+		// Objects are created as soon as their chunk arrives, data for
+		// objects not yet created is saved by the Renderer
+		_renderer->updateScene(msg);
+
+		_init_received.at(chunk) = true;
+		++_n_init_received;
+
+		if(_n_init_received % 10 == 0 || _n_init_received == n_chunks)
+		{
+			std::clog << "Scene graph : " << _n_init_received << "/" << n_chunks
+				<< " chunks received." << std::endl;
+		}
+	}
+
+	Message ack(MSG_ACK, 0, vl::time());
+	ack.write(MSG_SG_INIT);
+	ack.write(chunk);
+	sendMessage(ack);
+
+	if(!_state.has_init && _n_init_received == _init_received.size())
+	{
+		double t = _init_timer.elapsed();
+		std::clog << "Scene graph received : " << _init_bytes/1024 << " kbytes in "
+			<< t << " s (" << (t > 0 ? _init_bytes/1024/t : 0) << " kbytes/s)." << std::endl;
+		_init_report["Scene graph kbytes"].set_result(_init_bytes/1024);
+
+		uint32_t frame = msg.getFrame();
+		_state.has_init = true;
+		_state.update_frame = frame;
+
+		// request rendering messages when initialised
+		_state.wants_render = true;
+		Message reply(MSG_REG_RENDERING, frame, vl::time());
+		sendMessage(reply);
+	}
+}
+
 void 
 vl::cluster::Client::addMessageCallback(MSG_TYPES type, ClientMessageCallback *cb)
 {
@@ -501,6 +551,71 @@ vl::MeshManagerRefPtr
 vl::cluster::Client::getMeshManager(void) const
 { return _renderer->getMeshManager(); }
 
+void
+vl::cluster::Client::requestMesh(std::string const &name)
+{
+	uint64_t hash = _mesh_cache ? _mesh_cache->getHash(name) : 0;
+
+	/// @todo fix time and frame parameters
+	Message reg_msg(MSG_REG_RESOURCE, 0, vl::time());
+	reg_msg.write(RES_MESH);
+	reg_msg.write(name);
+	reg_msg.write(hash);
+	sendMessage(reg_msg);
+
+	++_n_mesh_requests;
+}
+
+void
+vl::cluster::Client::_meshReceived(std::string const &name, MessageRefPtr msg)
+{
+	assert(_n_mesh_requests > 0);
+	--_n_mesh_requests;
+
+	uint64_t hash;
+	bool has_data;
+	msg->read(hash);
+	msg->read(has_data);
+
+	if(has_data)
+	{
+		if(_mesh_cache && msg->size() > 0)
+		{ _mesh_cache->store(name, hash, &(*msg)[0], msg->size()); }
+	}
+	else
+	{
+		std::vector<char> data;
+		if(!_mesh_cache || !_mesh_cache->load(hash, data))
+		{
+			// Cached file has been removed, request the data
+			std::cout << vl::CRITICAL << "Mesh " << name << " missing from the cache." << std::endl;
+			if(_mesh_cache)
+			{ _mesh_cache->remove(name); }
+			requestMesh(name);
+			return;
+		}
+		msg->write(&data[0], data.size());
+	}
+
+	vl::MeshRefPtr mesh(new vl::Mesh(name));
+	MessageDataStream stream = msg->getStream();
+	stream >> (*mesh);
+
+	assert(getMeshManager());
+	getMeshManager()->meshLoaded(name, mesh);
+
+	// Index is written once all the meshes requested so far have been loaded
+	if(_mesh_cache && _n_mesh_requests == 0)
+	{
+		_mesh_cache->writeIndex();
+
+		_init_report["Mesh cache hits"].set_result(_mesh_cache->getHits());
+		_init_report["Mesh cache misses"].set_result(_mesh_cache->getMisses());
+		_init_report["Mesh cache kbytes saved"].set_result(_mesh_cache->getBytesSaved()/1024);
+		std::clog << _init_report << std::flush;
+	}
+}
+
 vl::cluster::MessageRefPtr 
 vl::cluster::Client::_receive(void)
 {
@@ -513,10 +628,10 @@ vl::cluster::Client::_receive(void)
 	/// we are using newer messages instead of the older.
 	while(_socket.available() && !msg)
 	{
-		std::vector<char> recv_buf(_socket.available());
+		_recv_buf.resize(_socket.available());
 		boost::system::error_code error;
 
-		size_t n = _socket.receive_from( boost::asio::buffer(recv_buf),
+		size_t n = _socket.receive_from( boost::asio::buffer(_recv_buf),
 				_master, 0, error );
 
 		/// @TODO when these do happen?
@@ -541,7 +656,7 @@ vl::cluster::Client::_receive(void)
 
 		if( n > 0 )
 		{
-			MessagePart part(recv_buf);
+			MessagePart part(_recv_buf);
 			// @todo send id and part number also
 			_send_ack(part.type);
 			if(part.parts == 1)
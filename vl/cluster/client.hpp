@@ -27,6 +27,11 @@
 #include "typedefs.hpp"
 
 #include "base/chrono.hpp"
+#include "base/report.hpp"
+
+#include "mesh_cache.hpp"
+
+#include <boost/scoped_ptr.hpp>
 /// Necessary for the MeshLoader callback base
 #include "mesh_manager.hpp"
 
@@ -81,7 +86,9 @@ struct ResourceMessageCallback : public ClientMessageCallback
 class Client
 {
 public:
-	Client( char const *hostname, uint16_t port, vl::RendererUniquePtr rend );
+	/// @param mesh_cache_dir where received meshes are stored, empty disables the cache
+	Client( char const *hostname, uint16_t port, vl::RendererUniquePtr rend,
+		std::string const &mesh_cache_dir = std::string() );
 
 	virtual ~Client(void);
 
@@ -109,12 +116,27 @@ public:
 
 	vl::MeshManagerRefPtr getMeshManager(void) const;
 
+	/// @brief ask the master for a mesh
+	/// Sends the hash of the cached version so the data is only sent if it has changed.
+	void requestMesh(std::string const &name);
+
+	/// @internal
+	/// @brief called from the MSG_RESOURCE callback, rest of the msg is the mesh
+	void _meshReceived(std::string const &name, MessageRefPtr msg);
+
+	/// @brief scene graph and mesh cache numbers of the initialisation
+	vl::Report<size_t> const &getInitReport(void) const
+	{ return _init_report; }
+
 private :
 	void _handle_message(vl::cluster::Message &msg);
 
 	/// @todo ACKs should send the message id and the part number also
 	void _send_ack(vl::cluster::MSG_TYPES);
 
+	/// @brief apply a MSG_SG_INIT chunk and ack it
+	void _handle_init_chunk(vl::cluster::Message &msg);
+
 	/// @todo replace with ref ptrs
 	/// @brief receives one message from the Master
 	MessageRefPtr _receive(void);
@@ -125,6 +147,11 @@ private :
 
 	boost::udp::endpoint _master;
 
+	/// Datagram buffers reused so sending and receiving doesn't allocate
+	std::vector<char> _recv_buf;
+	std::vector<char> _send_buf;
+	std::vector<MessagePart> _send_parts;
+
 	// Frame update message map
 	// @todo should use ref ptr, but we need to modify all the messages for that
 	std::map<uint32_t, Message> _update_messages;
@@ -141,6 +168,17 @@ private :
 
 	std::map<MSG_TYPES, ClientMessageCallback *> _msg_callbacks;
 
+	boost::scoped_ptr<MeshCache> _mesh_cache;
+	size_t _n_mesh_requests;
+
+	/// Init chunks already applied, master resends the ones it has no ack for
+	std::vector<bool> _init_received;
+	size_t _n_init_received;
+	size_t _init_bytes;
+	vl::chrono _init_timer;
+
+	vl::Report<size_t> _init_report;
+
 };	// class Client
 
 }	// namespace cluster
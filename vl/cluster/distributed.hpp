@@ -18,6 +18,8 @@
 
 #include "cluster/message.hpp"
 
+#include "base/thread_check.hpp"
+
 namespace vl
 {
 
@@ -78,7 +80,10 @@ public :
 	/// @brief Clears all dirty bits
 	/// Needs to be public because this is called from Session
 	void clearDirty( void )
-	{ _dirtyBits = DIRTY_NONE; }
+	{
+		_dirtyBits = DIRTY_NONE;
+		dirtiesCleared();
+	}
 
 	enum DirtyBits
 	{
@@ -90,7 +95,11 @@ public :
 protected:
 	/// @brief set a dirty flag
 	void setDirty( uint64_t const bits )
-	{ _dirtyBits |= bits; }
+	{
+		vl::checkFrameThread("Distributed objects");
+
+		_dirtyBits |= bits;
+	}
 
 	/// @brief update a variable and set dirty flag
 	template<typename T> void update_variable(T &val, T const &new_val, uint64_t dirty)
@@ -106,6 +115,10 @@ private :
 	/// @brief Recalculate member dirties if necessary
 	virtual void recaluclateDirties(void) {}
 
+	/// @brief Called after the dirties have been packed and cleared
+	/// for releasing state that is only needed till the next update
+	virtual void dirtiesCleared(void) {}
+
 	virtual void serialize( cluster::ByteStream &msg, const uint64_t dirtyBits ) const = 0;
 
 	virtual void deserialize( cluster::ByteStream &msg, const uint64_t dirtyBits ) = 0;
@@ -0,0 +1,221 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file cluster/mesh_cache.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+// Interface
+#include "mesh_cache.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+
+namespace
+{
+
+std::string const INDEX_FILE("index");
+
+/// Written before the data in every mesh file
+struct FileHeader
+{
+	uint64_t hash;
+	uint64_t size;
+	uint64_t checksum;
+};
+
+/// FNV-1a of the data, the mesh hash is calculated from the mesh
+/// so it can't be checked without deserializing
+uint64_t
+calculate_checksum(char const *data, size_t size)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for(size_t i = 0; i < size; ++i)
+	{
+		hash ^= uint8_t(data[i]);
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+}	// unamed namespace
+
+/// ------------------------------ Public ------------------------------------
+vl::cluster::MeshCache::MeshCache(std::string const &dir)
+	: _dir(dir)
+	, _index_dirty(false)
+	, _hits(0)
+	, _misses(0)
+	, _bytes_saved(0)
+{
+	if(!fs::exists(_dir))
+	{ fs::create_directories(_dir); }
+
+	_read_index();
+}
+
+vl::cluster::MeshCache::~MeshCache(void)
+{
+	writeIndex();
+}
+
+uint64_t
+vl::cluster::MeshCache::getHash(std::string const &name) const
+{
+	std::map<std::string, uint64_t>::const_iterator iter = _index.find(name);
+	if(iter != _index.end())
+	{ return iter->second; }
+
+	return 0;
+}
+
+bool
+vl::cluster::MeshCache::load(uint64_t hash, std::vector<char> &data)
+{
+	fs::path file = _get_file(hash);
+	std::ifstream ifs(file.string().c_str(), std::ios::binary);
+	if(!ifs)
+	{ return false; }
+
+	ifs.seekg(0, std::ios::end);
+	std::streamoff file_size = ifs.tellg();
+	ifs.seekg(0, std::ios::beg);
+
+	FileHeader header;
+	if(file_size < std::streamoff(sizeof(header))
+		|| !ifs.read(reinterpret_cast<char *>(&header), sizeof(header))
+		|| header.hash != hash
+		|| header.size == 0
+		|| std::streamoff(header.size) != file_size - std::streamoff(sizeof(header)))
+	{
+		std::clog << "MeshCache : " << file << " is corrupted." << std::endl;
+		return false;
+	}
+
+	data.resize(header.size);
+	ifs.read(&data[0], header.size);
+	if(!ifs || calculate_checksum(&data[0], data.size()) != header.checksum)
+	{
+		std::clog << "MeshCache : " << file << " is corrupted." << std::endl;
+		data.clear();
+		return false;
+	}
+
+	++_hits;
+	_bytes_saved += header.size;
+
+	return true;
+}
+
+void
+vl::cluster::MeshCache::store(std::string const &name, uint64_t hash, char const *data, size_t size)
+{
+	++_misses;
+
+	FileHeader header;
+	header.hash = hash;
+	header.size = size;
+	header.checksum = calculate_checksum(data, size);
+
+	// Renamed when complete so the file is never partially written
+	fs::path file = _get_file(hash);
+	fs::path tmp = file;
+	tmp += ".tmp";
+	{
+		std::ofstream ofs(tmp.string().c_str(), std::ios::binary);
+		ofs.write(reinterpret_cast<char const *>(&header), sizeof(header));
+		ofs.write(data, size);
+		ofs.close();
+		if(!ofs)
+		{
+			std::clog << "MeshCache : failed to write " << name << " to the cache." << std::endl;
+			boost::system::error_code ec;
+			fs::remove(tmp, ec);
+			return;
+		}
+	}
+
+	boost::system::error_code ec;
+	fs::rename(tmp, file, ec);
+	if(ec)
+	{
+		std::clog << "MeshCache : failed to write " << name << " to the cache : "
+			<< ec.message() << std::endl;
+		fs::remove(tmp, ec);
+		return;
+	}
+
+	_index[name] = hash;
+	_index_dirty = true;
+}
+
+void
+vl::cluster::MeshCache::remove(std::string const &name)
+{
+	if(_index.erase(name) > 0)
+	{ _index_dirty = true; }
+}
+
+void
+vl::cluster::MeshCache::writeIndex(void)
+{
+	if(!_index_dirty)
+	{ return; }
+
+	// Written completely every time, there is only one line per mesh
+	fs::path file = _dir / INDEX_FILE;
+	fs::path tmp = file;
+	tmp += ".tmp";
+	{
+		std::ofstream ofs(tmp.string().c_str());
+		for(std::map<std::string, uint64_t>::const_iterator iter = _index.begin();
+			iter != _index.end(); ++iter)
+		{ ofs << std::hex << iter->second << " " << iter->first << "\n"; }
+		ofs.close();
+		if(!ofs)
+		{
+			std::clog << "MeshCache : failed to write the index." << std::endl;
+			return;
+		}
+	}
+
+	boost::system::error_code ec;
+	fs::rename(tmp, file, ec);
+	if(ec)
+	{
+		std::clog << "MeshCache : failed to write the index : " << ec.message() << std::endl;
+		return;
+	}
+
+	_index_dirty = false;
+}
+
+/// ------------------------------ Private -----------------------------------
+fs::path
+vl::cluster::MeshCache::_get_file(uint64_t hash) const
+{
+	std::stringstream ss;
+	ss << std::hex << std::setw(16) << std::setfill('0') << hash << ".mesh_data";
+	return _dir / ss.str();
+}
+
+void
+vl::cluster::MeshCache::_read_index(void)
+{
+	std::ifstream ifs((_dir / INDEX_FILE).string().c_str());
+
+	// Lines are [hash name], names can have spaces
+	uint64_t hash;
+	std::string name;
+	while(ifs >> std::hex >> hash && std::getline(ifs >> std::ws, name))
+	{ _index[name] = hash; }
+}
@@ -0,0 +1,102 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file cluster/mesh_cache.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Persistent mesh cache for rendering slaves.
+ *
+ *	Meshes are stored in the same serialized form they are sent in
+ *	MSG_RESOURCE, one file per content hash. An index file maps the mesh
+ *	names to the hash of the last received version so the slave can tell
+ *	the master which version it already has. The master only sends the
+ *	mesh data if the hash doesn't match.
+ *
+ *	Data files are written to a temporary file and renamed in place and
+ *	start with the hash, length and checksum of the data, so a file left
+ *	by a crash or a partial write is a miss instead of a broken mesh.
+ *	The index is written with writeIndex, or when the cache is destroyed.
+ */
+
+#ifndef HYDRA_CLUSTER_MESH_CACHE_HPP
+#define HYDRA_CLUSTER_MESH_CACHE_HPP
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "base/filesystem.hpp"
+
+namespace vl
+{
+
+namespace cluster
+{
+
+class MeshCache
+{
+public :
+	/// @param dir directory for the cache, created if it doesn't exist
+	MeshCache(std::string const &dir);
+
+	~MeshCache(void);
+
+	/// @brief hash of the cached version of a mesh
+	/// @return 0 if the mesh is not in the cache
+	uint64_t getHash(std::string const &name) const;
+
+	/// @brief read the serialized mesh with a hash
+	/// @return false if the file is missing, unreadable or doesn't match the hash
+	bool load(uint64_t hash, std::vector<char> &data);
+
+	/// @brief write a serialized mesh and add it to the index
+	void store(std::string const &name, uint64_t hash, char const *data, size_t size);
+
+	/// @brief remove a mesh from the index, the data file is left in place
+	void remove(std::string const &name);
+
+	/// @brief write the index if it has changed
+	void writeIndex(void);
+
+	size_t getHits(void) const
+	{ return _hits; }
+
+	size_t getMisses(void) const
+	{ return _misses; }
+
+	/// @brief size of the mesh data not sent because of the cache
+	uint64_t getBytesSaved(void) const
+	{ return _bytes_saved; }
+
+private :
+	fs::path _get_file(uint64_t hash) const;
+
+	void _read_index(void);
+
+	fs::path _dir;
+
+	std::map<std::string, uint64_t> _index;
+	bool _index_dirty;
+
+	size_t _hits;
+	size_t _misses;
+	uint64_t _bytes_saved;
+
+};	// class MeshCache
+
+}	// namespace cluster
+
+}	// namespace vl
+
+#endif	// HYDRA_CLUSTER_MESH_CACHE_HPP
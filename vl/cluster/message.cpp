@@ -211,17 +211,30 @@ vl::cluster::Message::_assemble(void)
 
 std::vector<vl::cluster::MessagePart> 
 vl::cluster::Message::createParts(void) const
+{
+	std::vector<vl::cluster::MessagePart> parts;
+	createParts(parts);
+	return parts;
+}
+
+void
+vl::cluster::Message::createParts(std::vector<vl::cluster::MessagePart> &parts) const
 {
 	size_t bytes = sizeof(_frame)+sizeof(_timestamp)+sizeof(size_type)+_data.size();
 	uint16_t n_parts = bytes/MSG_PART_SIZE;
 	n_parts += bytes%MSG_PART_SIZE ? 1 : 0;
 
-	std::vector<vl::cluster::MessagePart> parts;
+	// Parts from the previous message keep their data buffers
+	parts.resize(n_parts);
 
 	size_type msg_offset = 0;
 	for(uint16_t i = 0; i < n_parts; ++i)
 	{
-		MessagePart part(_type, _id, n_parts, i);
+		MessagePart &part = parts.at(i);
+		part.type = _type;
+		part.id = _id;
+		part.parts = n_parts;
+		part.part = i;
 		uint16_t part_offset = 0;
 		
 		/// Calculate part data size
@@ -265,11 +278,7 @@ vl::cluster::Message::createParts(void) const
 			::memcpy(&part.data[0]+part_offset, &_data[0]+msg_offset, data_size);
 		}
 		msg_offset += data_size;
-
-		parts.push_back(part);
 	}
-
-	return parts;
 }
 
 vl::cluster::Message::Message( vl::cluster::MSG_TYPES type, uint32_t frame, vl::time const &timestamp )
@@ -295,6 +304,17 @@ vl::cluster::Message::clear( void )
 	_data.clear();
 }
 
+void
+vl::cluster::Message::reset(vl::cluster::MSG_TYPES type, uint32_t frame, vl::time const &timestamp)
+{
+	_type = type;
+	_id = generateID();
+	_frame = frame;
+	_timestamp = timestamp;
+	_parts.clear();
+	_data.clear();
+}
+
 vl::msg_size
 vl::cluster::Message::read( char *mem, vl::msg_size size )
 {
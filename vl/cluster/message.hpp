@@ -265,6 +265,10 @@ const uint16_t MSG_HEADER_SIZE = 4+8+2+2;
 const uint16_t MSG_PART_SIZE = 
 	MTU_SIZE - (MSG_HEADER_SIZE+UDP_HEADER_SIZE+IP_HEADER_SIZE);
 
+/// Size of a single MSG_SG_INIT chunk, each chunk is acked and resent
+/// separately so losing a part only resends this much data.
+const uint32_t INIT_CHUNK_SIZE = 64*1024;
+
 /*	Constant size message 
  *	[HEADER | DATA]
  *	Header:
@@ -347,6 +351,9 @@ public :
 
 	std::vector<MessagePart> createParts(void) const;
 
+	/// @brief split the message to parts reusing the memory of the parts
+	void createParts(std::vector<MessagePart> &parts) const;
+
 	/// @brief is this message whole or is there a piece missing
 	bool partial(void) const;
 
@@ -372,6 +379,9 @@ public :
 
 	void clear(void);
 
+	/// @brief start a new message keeping the allocated memory
+	void reset(MSG_TYPES type, uint32_t frame, vl::time const &timestamp);
+
 	/// Read an arbitary type from message data, this never reads the header or size
 	template<typename T>
 	msg_size read( T &obj );
@@ -524,6 +534,13 @@ public :
 	void setId( uint64_t id )
 	{ _id = id; }
 
+	/// @brief start a new object keeping the allocated memory
+	void reset( uint64_t id )
+	{
+		_id = id;
+		_data.clear();
+	}
+
 	virtual void read( char *mem, msg_size size );
 
 	virtual void write( char const *mem, msg_size size );
@@ -46,6 +46,8 @@ enum OBJ_TYPE
 	OBJ_CAMERA,
 	OBJ_MOVABLE_TEXT,
 	OBJ_RAY_OBJECT,
+	OBJ_TUBE_MESH,
+	OBJ_INSTANCE_GROUP,
 };
 
 }	// namespace vl
@@ -19,6 +19,17 @@
 // Necessary for blocking functions
 #include "base/sleep.hpp"
 
+namespace
+{
+
+/// How many init chunks are sent without receiving an ack
+size_t const INIT_CHUNKS_IN_FLIGHT = 8;
+
+/// Init chunks that have not been acked in this time are resent
+vl::time const INIT_RESEND_TIME(0, 500000);
+
+}	// unamed namespace
+
 /// Server::Client
 void
 vl::cluster::Server::ClientFSM::_do_rest(void)
@@ -160,18 +171,18 @@ vl::cluster::Server::poll(void)
 	// Better to use multiple sockets, one for each client
 	while( _socket.available() )
 	{
-		std::vector<char> recv_buf( _socket.available() );
+		_recv_buf.resize( _socket.available() );
 		boost::udp::endpoint remote_endpoint;
 		boost::system::error_code error;
 
 		// TODO we should check that all the bytes are read
-		_socket.receive_from( boost::asio::buffer(recv_buf),
+		_socket.receive_from( boost::asio::buffer(_recv_buf),
 			remote_endpoint, 0, error );
 
 		if (error && error != boost::asio::error::message_size)
 		{ throw boost::system::system_error(error); }
 
-		MessagePart part(recv_buf);
+		MessagePart part(_recv_buf);
 
 		/// Create new clients for everyone who isn't already present
 		Client *cl_ptr = _find_client_ptr(remote_endpoint);
@@ -197,6 +208,13 @@ vl::cluster::Server::poll(void)
 		}
 	}
 
+	// Resend init chunks that have been lost
+	for(ClientList::iterator iter = _clients.begin(); iter != _clients.end(); ++iter)
+	{
+		if((*iter)->init.active())
+		{ _sendInitChunks(**iter); }
+	}
+
 	// Check for dead clients
 	// Timeout if one of the client is taking too long to respond at all
 	// @todo we should really use a separate alive socket for this
@@ -292,10 +310,46 @@ vl::cluster::Server::sendMessage(Message const &msg)
 	}
 }
 
+void
+vl::cluster::Server::sendInit(std::vector<Message> const &chunks)
+{
+	assert(!chunks.empty());
+
+	Client *client = 0;
+	for(size_t i = 0; i < _requested_msgs.size(); ++i)
+	{
+		if(_requested_msgs.at(i).second == MSG_SG_INIT)
+		{
+			client = _requested_msgs.at(i).first;
+			_requested_msgs.erase(_requested_msgs.begin()+i);
+			break;
+		}
+	}
+	assert(client);
+
+	// Updates after the snapshot are needed when the client starts rendering
+	client->update_frame = chunks.front().getFrame();
+
+	InitTransfer &init = client->init;
+	init = InitTransfer();
+	init.chunks = chunks;
+	init.acked.resize(chunks.size(), false);
+	init.sent.resize(chunks.size(), vl::time());
+	for(size_t i = 0; i < chunks.size(); ++i)
+	{ init.bytes += chunks.at(i).size(); }
+
+	std::clog << "Sending scene graph to " << client->address << " in "
+		<< chunks.size() << " chunks." << std::endl;
+
+	_sendInitChunks(*client);
+}
+
 void
 vl::cluster::Server::sendUpdate( vl::cluster::Message const &msg )
 {
 	_msg_updates.push_back(msg);
+
+	_trimUpdates();
 }
 
 void
@@ -575,6 +629,7 @@ vl::cluster::Server::_handle_message(vl::cluster::Message &msg, Client &client)
 		case vl::cluster::MSG_REQ_SG_UPDATE :
 		{
 			// create events for all update messages that are newer than the client has
+			client.update_frame = msg.getFrame();
 			
 			std::vector<Message> update_msgs;
 			for(std::vector<Message>::const_reverse_iterator iter = _msg_updates.rbegin();
@@ -652,11 +707,13 @@ vl::cluster::Server::_handle_message(vl::cluster::Message &msg, Client &client)
 			std::clog << "vl::cluster::MSG_REG_RESOURCE message received." << std::endl;
 			RESOURCE_TYPE type;
 			std::string name;
+			uint64_t hash;
 			msg.read(type);
 			msg.read(name);
+			msg.read(hash);
 			assert(!_request_message_signal.empty());
 			_requested_msgs.push_back(std::make_pair(&client, MSG_RESOURCE));
-			_request_message_signal(RequestedMessage(MSG_RESOURCE, name, type));
+			_request_message_signal(RequestedMessage(MSG_RESOURCE, name, type, hash));
 		}
 		break;
 
@@ -779,8 +836,7 @@ void
 vl::cluster::Server::_sendMessage(Client &client, vl::cluster::Message const &msg)
 {
 	/// @todo remove the copying that is needed both createParts and dump
-	std::vector<char> buf;
-	std::vector<MessagePart> parts = msg.createParts();
+	msg.createParts(_send_parts);
 	
 	/// Modify state
 	if(msg.getType() == MSG_ENVIRONMENT)
@@ -788,16 +844,60 @@ vl::cluster::Server::_sendMessage(Client &client, vl::cluster::Message const &ms
 		client.environment_sent_time.reset();
 	}
 
-	for(size_t i = 0; i < parts.size(); ++i)
+	for(size_t i = 0; i < _send_parts.size(); ++i)
 	{
-		parts.at(i).dump(buf);
-		_socket.send_to(boost::asio::buffer(buf), client.address);
+		_send_parts.at(i).dump(_send_buf);
+		_socket.send_to(boost::asio::buffer(_send_buf), client.address);
 		/// @todo we should add them to a sent stack, and verify the sending with ack
 	}
 }
 
 void
-vl::cluster::Server::_handle_ack(Client &client, vl::cluster::MSG_TYPES ack_to,  vl::cluster::Message const &msg)
+vl::cluster::Server::_sendInitChunks(Client &client)
+{
+	InitTransfer &init = client.init;
+	vl::time now = _internal_clock.elapsed();
+
+	size_t in_flight = 0;
+	for(size_t i = 0; i < init.chunks.size() && in_flight < INIT_CHUNKS_IN_FLIGHT; ++i)
+	{
+		if(init.acked.at(i))
+		{ continue; }
+
+		bool sent = init.sent.at(i) != vl::time();
+		if(!sent || now - init.sent.at(i) > INIT_RESEND_TIME)
+		{
+			if(sent)
+			{ ++init.n_resent; }
+
+			_sendMessage(client, init.chunks.at(i));
+			init.sent.at(i) = now;
+		}
+		++in_flight;
+	}
+}
+
+void
+vl::cluster::Server::_trimUpdates(void)
+{
+	int64_t oldest = -1;
+	for(ClientList::const_iterator iter = _clients.begin(); iter != _clients.end(); ++iter)
+	{
+		if((*iter)->update_frame >= 0 && (oldest < 0 || (*iter)->update_frame < oldest))
+		{ oldest = (*iter)->update_frame; }
+	}
+
+	// Without clients receiving updates none of them are needed,
+	// new clients get the scene graph first.
+	std::vector<Message>::iterator last = _msg_updates.begin();
+	while(last != _msg_updates.end() && (oldest < 0 || int64_t(last->getFrame()) <= oldest))
+	{ ++last; }
+
+	_msg_updates.erase(_msg_updates.begin(), last);
+}
+
+void
+vl::cluster::Server::_handle_ack(Client &client, vl::cluster::MSG_TYPES ack_to,  vl::cluster::Message &msg)
 {
 	switch( ack_to )
 	{
@@ -828,10 +928,37 @@ vl::cluster::Server::_handle_ack(Client &client, vl::cluster::MSG_TYPES ack_to,
 
 		case vl::cluster::MSG_SG_INIT :
 		{
-			std::clog << "Received an ACK for vl::cluster::MSG_SG_INIT" << std::endl;
+			// Every received part is acked without data, only the chunk
+			// acks sent after the chunk has been applied are used.
+			InitTransfer &init = client.init;
+			if(msg.size() == 0 || !init.active())
+			{ break; }
+
+			uint32_t chunk;
+			msg.read(chunk);
+			if(chunk >= init.chunks.size() || init.acked.at(chunk))
+			{ break; }
+
+			init.acked.at(chunk) = true;
+			++init.n_acked;
+
+			if(init.n_acked < init.chunks.size())
+			{
+				_sendInitChunks(client);
+				break;
+			}
+
+			double t = init.timer.elapsed();
+			std::clog << "Scene graph sent to " << client.address << " in "
+				<< init.chunks.size() << " chunks : " << init.bytes/1024 << " kbytes in "
+				<< t << " s (" << (t > 0 ? init.bytes/1024/t : 0) << " kbytes/s) : "
+				<< init.n_resent << " chunks resent." << std::endl;
+			client.init = InitTransfer();
+
 			// @todo is this correct event for this? and do we need separate loaded?
 			client.process_event(event::graph_loaded());
 		}
+		break;
 
 		case vl::cluster::MSG_SG_UPDATE :
 		{
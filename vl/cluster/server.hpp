@@ -70,17 +70,41 @@ typedef vl::msm::back::state_machine<ServerFSM_> ServerFSM;
 struct RequestedMessage
 {
 	RequestedMessage(MSG_TYPES type_)
-		: type(type_)
+		: type(type_), hash(0)
 	{}
 
-	RequestedMessage(MSG_TYPES type_, std::string const &name_, RESOURCE_TYPE res_type_)
-		: type(type_), name(name_), res_type(res_type_)
+	RequestedMessage(MSG_TYPES type_, std::string const &name_, RESOURCE_TYPE res_type_, uint64_t hash_ = 0)
+		: type(type_), name(name_), res_type(res_type_), hash(hash_)
 	{}
 
 	MSG_TYPES type;
 	// extra data only useful for resource messages
 	std::string name;
 	RESOURCE_TYPE res_type;
+	// hash of the version the client has cached, 0 if none
+	uint64_t hash;
+};
+
+/// @brief scene graph snapshot being sent to a client
+/// Chunks are sent a few at a time and resent till they are acked.
+struct InitTransfer
+{
+	InitTransfer(void)
+		: n_acked(0), n_resent(0), bytes(0)
+	{}
+
+	bool active(void) const
+	{ return !chunks.empty(); }
+
+	std::vector<Message> chunks;
+	std::vector<bool> acked;
+	/// Server clock time when the chunk was last sent, zero if not sent yet
+	std::vector<vl::time> sent;
+
+	size_t n_acked;
+	size_t n_resent;
+	size_t bytes;
+	vl::chrono timer;
 };
 
 class Server : public LogReceiver
@@ -99,6 +123,7 @@ public:
 			, environment_sent_time(vl::time(10, 0))
 			, last_alive()
 			, create_frame(-1)
+			, update_frame(-1)
 			, ignore_updates(false)
 		{}
 		
@@ -136,9 +161,16 @@ public:
 		// Last received create message
 		int64_t create_frame;
 
+		/// Last update the client has, -1 if it doesn't receive updates.
+		/// Set to the frame of the scene graph when it's sent so the
+		/// updates made while the client is initialising are kept for it.
+		int64_t update_frame;
+
 		bool ignore_updates;
 		vl::time ignore_expires;
 
+		InitTransfer init;
+
 		/// Data
 	private :
 		bool _rendering_enabled;
@@ -230,6 +262,11 @@ public:
 	/// in correct order.
 	void sendMessage(Message const &msg);
 
+	/// @brief send the scene graph snapshot to the client that requested it
+	/// Chunks are created with Master::createInitChunks, the client is ready
+	/// for rendering when all of them have been acked.
+	void sendInit(std::vector<Message> const &chunks);
+
 	int addRequestMessageListener(RequestMessage::slot_type const &slot)
 	{ _request_message_signal.connect(slot); return 1; }
 
@@ -326,7 +363,13 @@ private :
 
 	void _sendMessage(Server::Client &client, vl::cluster::Message const &msg);
 
-	void _handle_ack(Server::Client &client, MSG_TYPES ack_to, vl::cluster::Message const &msg);
+	/// @brief send init chunks that are not in flight or have not been acked in time
+	void _sendInitChunks(Server::Client &client);
+
+	/// @brief remove the update messages every client already has
+	void _trimUpdates(void);
+
+	void _handle_ack(Server::Client &client, MSG_TYPES ack_to, vl::cluster::Message &msg);
 
 	/// @brief Blocks till all the client state machines have a given flag
 	/// these flags for now are used to distinguis the different phases
@@ -339,6 +382,11 @@ private :
 	boost::asio::io_service _io_service;
 	boost::udp::socket _socket;
 
+	/// Datagram buffers reused so sending and receiving doesn't allocate
+	std::vector<char> _recv_buf;
+	std::vector<char> _send_buf;
+	std::vector<MessagePart> _send_parts;
+
 	ClientList _clients;
 
 	std::deque<Message> _messages;
@@ -350,7 +398,8 @@ private :
 	///
 	/// Create MSGs, per frame
 	std::vector<Message> _msg_creates;
-	/// Update MSGs, per frame
+	/// Update MSGs, per frame, kept till every client has them
+	/// because the updates are deltas.
 	std::vector<Message> _msg_updates;
 
 	uint32_t _n_log_messages;
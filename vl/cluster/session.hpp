@@ -133,6 +133,71 @@ public :
 	DistributedObjectList const &getRegistedObjects(void) const
 	{ return _registered_objects; }
 
+	/// @brief pack all dirty registered objects to a message
+	/// Master only, clears the dirties of the packed objects.
+	/// @return number of objects packed
+	size_t packDirtyObjects(cluster::Message &msg)
+	{
+		size_t n_packed = 0;
+		DistributedObjectList::iterator iter;
+		for( iter = _registered_objects.begin(); iter != _registered_objects.end();
+			++iter )
+		{
+			if( (*iter)->isDirty() )
+			{
+				assert( (*iter)->getID() != vl::ID_UNDEFINED );
+				// Reusing the buffer, this is done for every frame
+				_pack_data.reset( (*iter)->getID() );
+				vl::cluster::ByteDataStream stream = _pack_data.getStream();
+				(*iter)->pack(stream);
+				_pack_data.copyToMessage(&msg);
+				/// Clear dirty because this update has been applied
+				(*iter)->clearDirty();
+				++n_packed;
+			}
+		}
+
+		return n_packed;
+	}
+
+	/// @brief pack all registered objects with all dirties to a message
+	/// Master only, used for initialisation messages so dirties are not cleared.
+	void packAllObjects(cluster::Message &msg) const
+	{
+		DistributedObjectList::const_iterator iter;
+		for( iter = _registered_objects.begin(); iter != _registered_objects.end();
+			++iter )
+		{
+			assert( (*iter)->getID() != vl::ID_UNDEFINED );
+			vl::cluster::ObjectData data( (*iter)->getID() );
+			vl::cluster::ByteDataStream stream = data.getStream();
+			(*iter)->pack( stream, vl::Distributed::DIRTY_ALL );
+			data.copyToMessage(&msg);
+		}
+	}
+
+	/// @brief pack all registered objects to messages of about chunk_size bytes
+	/// Objects are not divided between messages, so a large object can exceed it.
+	/// Registration order is kept so managers are in the first messages.
+	/// At least one message is always created.
+	void packAllObjects(std::vector<cluster::Message> &msgs, size_t chunk_size) const
+	{
+		msgs.push_back(cluster::Message());
+		DistributedObjectList::const_iterator iter;
+		for( iter = _registered_objects.begin(); iter != _registered_objects.end();
+			++iter )
+		{
+			if(msgs.back().size() >= chunk_size)
+			{ msgs.push_back(cluster::Message()); }
+
+			assert( (*iter)->getID() != vl::ID_UNDEFINED );
+			vl::cluster::ObjectData data( (*iter)->getID() );
+			vl::cluster::ByteDataStream stream = data.getStream();
+			(*iter)->pack( stream, vl::Distributed::DIRTY_ALL );
+			data.copyToMessage(&msgs.back());
+		}
+	}
+
 private :
 	/// @brief Implementation for master side object registering
 	void _registerObject(vl::Distributed *obj, OBJ_TYPE type)
@@ -167,6 +232,9 @@ protected :
 	/// Mapped data
 	DistributedObjectList _mapped_objects;
 
+	/// Buffer for packing the dirty objects
+	cluster::ObjectData _pack_data;
+
 };	// class Session
 
 /// Global
@@ -70,6 +70,8 @@ struct ImporterSettings
 		, handle_duplicates(HDN_RENAME)
 		, remove_duplicate_materials(false)
 		, remove_duplicate_meshes(false)
+		, optimize_meshes(false)
+		, generate_lods(false)
 	{}
 
 	SHADING shading;
@@ -91,6 +93,14 @@ struct ImporterSettings
 	// @todo not implemented
 	bool remove_duplicate_meshes;
 
+	/// @brief welds and reorders the mesh data for the vertex cache
+	/// uses the default MeshOptimizerSettings
+	bool optimize_meshes;
+
+	/// @brief generates simplified LOD levels for the meshes
+	/// uses the default MeshLodSettings
+	bool generate_lods;
+
 };	// struct ImporterSettings
 
 
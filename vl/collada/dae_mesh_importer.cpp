@@ -29,6 +29,9 @@
 
 /// Necessary because we create meshes here
 #include "mesh_manager.hpp"
+/// Necessary for optimizing imported meshes
+#include "mesh_optimizer.hpp"
+#include "mesh_lod.hpp"
 
 /// Necessary for typedefs
 #include "dae_importer.hpp"
@@ -177,10 +180,24 @@ vl::dae::MeshImporter::read(COLLADAFW::Mesh const *mesh, ImporterSettings const
 	}
 	*/
 
+	if(settings.optimize_meshes)
+	{
+		vl::MeshOptimizerReport report = vl::optimize_mesh(*_mesh);
+		std::clog << "Optimized mesh " << _mesh->getName() << " : " << report << std::endl;
+	}
+
 	_mesh->calculateBounds();
 
 	std::clog << "Mesh bounds = " << _mesh->getBounds() << std::endl;
 
+	// LOD generation needs the bounds
+	if(settings.generate_lods)
+	{
+		vl::generate_lod_levels(*_mesh);
+		std::clog << "Mesh " << _mesh->getName() << " has " 
+			<< _mesh->getNumLodLevels() << " LOD levels." << std::endl;
+	}
+
 	/// @todo clean up all the stored values so we can be run again
 
 	return true;
@@ -18,6 +18,7 @@
 
 #include "scene_manager.hpp"
 #include "scene_node.hpp"
+#include "instance_group.hpp"
 // Necessary for loading meshes with the new interface
 #include "mesh_manager.hpp"
 #include "mesh_ogre.hpp"
@@ -82,6 +83,9 @@ vl::Entity::Entity(vl::SceneManagerPtr creator)
 
 vl::Entity::~Entity(void)
 {
+	if(_instance_group)
+	{ _instance_group->_removeEntity(this); }
+
 	if(_ogre_object)
 	{
 		assert(_creator->getNative());
@@ -106,6 +110,8 @@ vl::Entity::setMaterialName(std::string const &name)
 	{
 		setDirty(DIRTY_MATERIAL);
 		_material_name = name;
+		// Might belong to a different group now
+		_creator->_notifyInstancingChanged();
 	}
 }
 
@@ -116,9 +122,17 @@ vl::Entity::setInstanced(bool enable)
 	{
 		setDirty(DIRTY_INSTANCED);
 		_is_instanced = enable;
+		_creator->_notifyInstancingChanged();
 	}
 }
 
+void
+vl::Entity::_setInstanceGroup(vl::InstanceGroupPtr group)
+{
+	_instance_group = group;
+	update_variable(_grouped, bool(group), DIRTY_INSTANCE_GROUP);
+}
+
 void 
 vl::Entity::meshLoaded(vl::MeshRefPtr mesh)
 {
@@ -126,6 +140,14 @@ vl::Entity::meshLoaded(vl::MeshRefPtr mesh)
 
 	_mesh = mesh;
 
+	// Grouped while the mesh was loading
+	if(_grouped)
+	{
+		delete _loader_cb;
+		_loader_cb = 0;
+		return;
+	}
+
 	if(!Ogre::MeshManager::getSingleton().resourceExists(_mesh_name))
 	{
 		Ogre::MeshPtr og_mesh = vl::create_ogre_mesh(_mesh_name, mesh);
@@ -205,6 +227,11 @@ vl::Entity::doSerialize( vl::cluster::ByteStream &msg, const uint64_t dirtyBits
 	{
 		msg << _is_instanced;
 	}
+
+	if( DIRTY_INSTANCE_GROUP & dirtyBits )
+	{
+		msg << _grouped;
+	}
 }
 
 void 
@@ -242,6 +269,27 @@ vl::Entity::doDeserialize( vl::cluster::ByteStream &msg, const uint64_t dirtyBit
 		// For now we don't support changing from not instanced to instanced entities
 		assert(!_ogre_object);
 	}
+
+	if( DIRTY_INSTANCE_GROUP & dirtyBits )
+	{
+		msg >> _grouped;
+		if(_grouped && _ogre_object)
+		{
+			_creator->getNative()->destroyMovableObject(_ogre_object);
+			_ogre_object = 0;
+		}
+		// Removed from a group after the entity was created, newly created
+		// entities are handled by MovableObject
+		else if(!_grouped && !_ogre_object && !(DIRTY_NAME & dirtyBits))
+		{
+			_doCreateNative();
+			if(_ogre_object)
+			{
+				_ogre_object->setVisible(_visible);
+				_ogre_object->setVisibilityFlags(1);
+			}
+		}
+	}
 }
 
 bool
@@ -250,6 +298,10 @@ vl::Entity::_doCreateNative(void)
 	if( _ogre_object )
 	{ return true; }
 
+	// Drawn by an InstanceGroup
+	if( _grouped )
+	{ return true; }
+
 	assert( _creator );
 	assert( _creator->getNative() );
 	assert( !_name.empty() );
@@ -332,6 +384,7 @@ vl::Entity::_finishCreateNative(void)
 	if(_parent && !_ogre_object->isAttached())
 	{
 		_parent->getNative()->attachObject(_ogre_object);
+		_parent->_notifyStaticChanged();
 	}
 
 	return true;
@@ -343,6 +396,8 @@ vl::Entity::_clear(void)
 	_cast_shadows = true;
 	_use_new_mesh_manager = false;
 	_is_instanced = false;
+	_instance_group = 0;
+	_grouped = false;
 	_ogre_object = 0;
 	_loader_cb = 0;
 }
@@ -83,6 +83,14 @@ public :
 	bool isInstanced(void) const
 	{ return _is_instanced; }
 
+	/// @brief group this entity is drawn with, NULL if it's drawn separately
+	/// Groups are managed by the SceneManager.
+	InstanceGroupPtr getInstanceGroup(void) const
+	{ return _instance_group; }
+
+	/// @internal used by InstanceGroup
+	void _setInstanceGroup(InstanceGroupPtr group);
+
 	virtual vl::MovableObjectPtr clone(std::string const &append_to_name) const;
 
 	enum DirtyBits
@@ -91,7 +99,8 @@ public :
 		DIRTY_CAST_SHADOWS = vl::MovableObject::DIRTY_CUSTOM << 1,
 		DIRTY_MATERIAL = vl::MovableObject::DIRTY_CUSTOM << 2,
 		DIRTY_INSTANCED = vl::MovableObject::DIRTY_CUSTOM << 3,
-		DIRTY_CUSTOM = vl::MovableObject::DIRTY_CUSTOM << 4,
+		DIRTY_INSTANCE_GROUP = vl::MovableObject::DIRTY_CUSTOM << 4,
+		DIRTY_CUSTOM = vl::MovableObject::DIRTY_CUSTOM << 5,
 	};
 
 	/// Internal
@@ -131,6 +140,11 @@ private :
 
 	bool _is_instanced;
 
+	/// Master only
+	InstanceGroupPtr _instance_group;
+	/// Renderers don't create the entity if it's drawn by a group
+	bool _grouped;
+
 	Ogre::MovableObject *_ogre_object;
 
 	// Save the loader pointer so it can be destroyed when not needed anymore
@@ -18,6 +18,7 @@
 /// Base stuff
 #include "base/exceptions.hpp"
 #include "base/string_utils.hpp"
+#include "base/thread_check.hpp"
 #include "logger.hpp"
 
 /// Helpers
@@ -28,19 +29,46 @@
 #include "input/tracker.hpp"
 #include "input/tracker_serializer.hpp"
 #include "input/pcan.hpp"
+#include "input/recording.hpp"
+#include "input/recording_player.hpp"
 
 /// Necessary for file loading
 #include "resource_manager.hpp"
 
+#include <boost/bind.hpp>
+
+#include <algorithm>
+
+namespace
+{
+
+/// OIS key codes are below 256 and the modifiers use bits 1-4
+size_t const N_KEY_CODES = 256;
+size_t const N_KEY_MODS = 16;
+
+inline size_t
+key_index(OIS::KeyCode kc, std::bitset<8> mod)
+{
+	assert(size_t(kc) < N_KEY_CODES);
+	return size_t(kc)*N_KEY_MODS + ((mod.to_ulong() >> 1) & (N_KEY_MODS-1));
+}
+
+}	// unamed namespace
+
 vl::EventManager::EventManager(ResourceManager *res_man)
-	: _frame_trigger(0)
+	: _key_table(N_KEY_CODES*N_KEY_MODS, 0)
+	, _key_best_table(N_KEY_CODES*N_KEY_MODS, 0)
+	, _frame_trigger(0)
 	, _key_modifiers(KEY_MOD_NONE)
+	, _injecting_can(false)
 	, _trackers(new vl::Clients(this))
 	, _resource_manager(res_man)
 {}
 
 vl::EventManager::~EventManager( void )
 {
+	stopRecording();
+
 	removeTriggers();
 
 	// Cleanup objects created from environment config
@@ -56,6 +84,8 @@ vl::EventManager::~EventManager( void )
 vl::TrackerTrigger *
 vl::EventManager::createTrackerTrigger( std::string const &name )
 {
+	vl::checkFrameThread("Event triggers");
+
 	vl::TrackerTrigger *trigger = _findTrackerTrigger( name );
 	if( !trigger )
 	{
@@ -86,6 +116,8 @@ vl::EventManager::hasTrackerTrigger(const std::string& name)
 vl::KeyTrigger *
 vl::EventManager::createKeyTrigger(OIS::KeyCode kc, KEY_MOD mod)
 {
+	vl::checkFrameThread("Event triggers");
+
 	vl::KeyTrigger *trigger = _find_key_trigger(kc, std::bitset<8>(mod));
 
 	if( !trigger )
@@ -95,6 +127,8 @@ vl::EventManager::createKeyTrigger(OIS::KeyCode kc, KEY_MOD mod)
 		trigger->setModifiers(mod);
 
 		_key_triggers.push_back(trigger);
+		_key_table.at(key_index(kc, std::bitset<8>(mod))) = trigger;
+		_update_best_matches(kc);
 	}
 
 	return trigger;
@@ -194,6 +228,8 @@ vl::EventManager::keyReleased(OIS::KeyCode kc)
 vl::MouseTrigger*
 vl::EventManager::createMouseTrigger(void)
 {
+	vl::checkFrameThread("Event triggers");
+
 	vl::MouseTrigger *trigger = new vl::MouseTrigger();
 	_mouse_triggers.push_back(trigger);
 	return trigger;
@@ -202,6 +238,8 @@ vl::EventManager::createMouseTrigger(void)
 void
 vl::EventManager::destroyMouseTrigger(vl::MouseTrigger *trigger)
 {
+	vl::checkFrameThread("Event triggers");
+
 	std::vector<vl::MouseTrigger *>::iterator iter 
 		= std::find(_mouse_triggers.begin(), _mouse_triggers.end(), trigger);
 
@@ -213,23 +251,38 @@ vl::EventManager::destroyMouseTrigger(vl::MouseTrigger *trigger)
 }
 
 vl::JoystickTrigger*
-vl::EventManager::createJoystickTrigger(void)
+vl::EventManager::createJoystickTrigger(int dev_id, int index)
 {
-	vl::JoystickTrigger *trigger = new vl::JoystickTrigger();
-	_joystick_triggers.push_back(trigger);
+	vl::checkFrameThread("Event triggers");
+
+	vl::JoystickTrigger *trigger = new vl::JoystickTrigger(dev_id, index);
+	_joystick_triggers[std::make_pair(dev_id, index)].push_back(trigger);
 	return trigger;
 }
 
 void
 vl::EventManager::destroyJoystickTrigger(vl::JoystickTrigger *trigger)
 {
+	vl::checkFrameThread("Event triggers");
+
+	if(!trigger)
+	{ return; }
+
+	JoystickTriggerMap::iterator list_iter = _joystick_triggers.find(
+		std::make_pair(trigger->getDevice(), trigger->getIndex()));
+	if(list_iter == _joystick_triggers.end())
+	{ return; }
+
+	std::vector<vl::JoystickTrigger *> &list = list_iter->second;
 	std::vector<vl::JoystickTrigger *>::iterator iter 
-		= std::find(_joystick_triggers.begin(), _joystick_triggers.end(), trigger);
+		= std::find(list.begin(), list.end(), trigger);
 
-	if(iter != _joystick_triggers.end())
+	if(iter != list.end())
 	{
 		delete *iter;
-		_joystick_triggers.erase(iter);
+		list.erase(iter);
+		if(list.empty())
+		{ _joystick_triggers.erase(list_iter); }
 	}
 }
 
@@ -271,9 +324,56 @@ vl::EventManager::mouseMoved(vl::MouseEvent const &evt)
 
 void vl::EventManager::updateGameJoystick(vl::JoystickEvent const& evt, int index)
 {
-	for(std::vector< vl::JoystickTrigger* >::iterator iter = _joystick_triggers.begin(); iter != _joystick_triggers.end(); ++iter)
+	if(_recorder)
+	{ _recorder->writeJoystick(index, evt); }
+
+	_update_joystick_triggers(evt, index);
+}
+
+void
+vl::EventManager::_injectJoystickEvent(vl::JoystickEvent const &evt, int index)
+{
+	_update_joystick_triggers(evt, index);
+}
+
+void
+vl::EventManager::_injectCANMessage(vl::CANMsg const &msg)
+{
+	_can_signal(msg);
+
+	// Scripts listening to the device directly, only if it has been created
+	if(_pcan)
+	{
+		_injecting_can = true;
+		_pcan->injectMessage(msg);
+		_injecting_can = false;
+	}
+}
+
+void
+vl::EventManager::_update_joystick_triggers(vl::JoystickEvent const &evt, int index)
+{
+	// Specific triggers first, keys are skipped if they are the same
+	// as a previous one which happens with ANY device or index.
+	int const dev_id = evt.info.dev_id;
+	std::pair<int, int> const keys[4] = {
+		std::make_pair(dev_id, index),
+		std::make_pair(dev_id, int(JoystickTrigger::ANY)),
+		std::make_pair(int(JoystickTrigger::ANY), index),
+		std::make_pair(int(JoystickTrigger::ANY), int(JoystickTrigger::ANY)) };
+
+	for(size_t k = 0; k < 4; ++k)
 	{
-		(*iter)->update(evt, index);
+		if(std::find(keys, keys+k, keys[k]) != keys+k)
+		{ continue; }
+
+		JoystickTriggerMap::iterator list_iter = _joystick_triggers.find(keys[k]);
+		if(list_iter == _joystick_triggers.end())
+		{ continue; }
+
+		std::vector<vl::JoystickTrigger *> const &list = list_iter->second;
+		for(size_t i = 0; i < list.size(); ++i)
+		{ list[i]->update(evt, index); }
 	}
 	//std::clog << "update funktio, event_manager.cpp: " << std::endl << evt;
 }
@@ -291,22 +391,20 @@ vl::EventManager::getFrameTrigger( void )
 vl::TimeTrigger *
 vl::EventManager::createTimeTrigger(void)
 {
-	vl::TimeTrigger *trigger = new TimeTrigger;
-	_time_triggers.push_back(trigger);
+	vl::checkFrameThread("Event triggers");
+
+	vl::TimeTrigger *trigger = new TimeTrigger(&_timer_wheel);
+	_time_triggers.insert(trigger);
 	return trigger;
 }
 
 void
 vl::EventManager::destroyTimeTrigger(vl::TimeTrigger *trigger)
 {
-	std::vector<TimeTrigger *>::iterator iter 
-		= std::find(_time_triggers.begin(), _time_triggers.end(), trigger);
+	vl::checkFrameThread("Event triggers");
 
-	if(iter != _time_triggers.end())
-	{
-		delete *iter;
-		_time_triggers.erase(iter);
-	}
+	if(_time_triggers.erase(trigger) > 0)
+	{ delete trigger; }
 }
 
 vl::PCANRefPtr
@@ -315,6 +413,9 @@ vl::EventManager::getPCAN(void)
 	if(!_pcan)
 	{
 		_pcan.reset(new PCAN());
+		// Listener is always added because recording can be started
+		// after the PCAN has been created.
+		_pcan->addListener(boost::bind(&EventManager::_can_message, this, _1));
 	}
 
 	return _pcan;
@@ -323,6 +424,8 @@ vl::EventManager::getPCAN(void)
 vl::vrpn_analog_client_ref_ptr
 vl::EventManager::createAnalogClient(std::string const &name)
 {
+	vl::checkFrameThread("Event triggers");
+
 	vrpn_analog_client_ref_ptr client;
 	std::map<std::string, vrpn_analog_client_ref_ptr>::iterator iter
 		= _analog_clients.find(name);
@@ -343,6 +446,8 @@ vl::EventManager::createAnalogClient(std::string const &name)
 void
 vl::EventManager::removeTriggers(void)
 {
+	vl::checkFrameThread("Event triggers");
+
 	// We don't destroy tracker triggers because this function is ment
 	// to use when reloading or reseting python context
 	// and tracker triggers are created from environment config.
@@ -353,11 +458,13 @@ vl::EventManager::removeTriggers(void)
 		delete *iter;
 	}
 	_key_triggers.clear();
+	std::fill(_key_table.begin(), _key_table.end(), (vl::KeyTrigger *)0);
+	std::fill(_key_best_table.begin(), _key_best_table.end(), (vl::KeyTrigger *)0);
 
 	delete _frame_trigger;
 	_frame_trigger = 0;
 
-	for(std::vector<TimeTrigger *>::iterator iter = _time_triggers.begin();
+	for(std::set<TimeTrigger *>::iterator iter = _time_triggers.begin();
 		iter != _time_triggers.end(); ++iter)
 	{
 		delete *iter;
@@ -371,15 +478,78 @@ vl::EventManager::removeTriggers(void)
 	}
 	_mouse_triggers.clear();
 
-	for(std::vector< JoystickTrigger* >::iterator iter = _joystick_triggers.begin();
+	for(JoystickTriggerMap::iterator iter = _joystick_triggers.begin();
 		iter != _joystick_triggers.end(); ++iter)
 	{
-		delete *iter;
+		for(size_t i = 0; i < iter->second.size(); ++i)
+		{ delete iter->second.at(i); }
 	}
 	_joystick_triggers.clear();
 
 }
 
+void
+vl::EventManager::startRecording(std::string const &file)
+{
+	vl::checkFrameThread("Event triggers");
+
+	stopRecording();
+
+	std::cout << vl::TRACE << "Starting input recording to " << file << std::endl;
+
+	_recorder.reset(new RecordingWriter(file));
+
+	for(size_t i = 0; i < _trackers->getNTrackers(); ++i)
+	{ _trackers->getTrackerPtr(i)->setRecorder(_recorder.get(), (uint16_t)i); }
+}
+
+void
+vl::EventManager::stopRecording(void)
+{
+	vl::checkFrameThread("Event triggers");
+
+	if(!_recorder)
+	{ return; }
+
+	for(size_t i = 0; i < _trackers->getNTrackers(); ++i)
+	{ _trackers->getTrackerPtr(i)->setRecorder(0, 0); }
+
+	_recorder->close();
+	std::cout << vl::TRACE << "Input recording " << _recorder->getFile() << " stopped : "
+		<< _recorder->getNRecords() << " records, " << _recorder->getBytesWritten()
+		<< " bytes." << std::endl;
+
+	_recorder.reset();
+}
+
+vl::RecordingPlayerRefPtr
+vl::EventManager::playRecording(std::string const &name)
+{
+	vl::checkFrameThread("Event triggers");
+
+	assert(_resource_manager);
+
+	// Recordings are streamed from the file so we only need the path
+	std::string path;
+	if(!_resource_manager->findResource(name, path))
+	{ BOOST_THROW_EXCEPTION(vl::missing_resource() << vl::resource_name(name)); }
+
+	RecordingPlayerRefPtr player = getRecordingPlayer();
+	player->open(path);
+	player->play();
+
+	return player;
+}
+
+vl::RecordingPlayerRefPtr
+vl::EventManager::getRecordingPlayer(void)
+{
+	if(!_player)
+	{ _player.reset(new RecordingPlayer(this)); }
+
+	return _player;
+}
+
 void
 vl::EventManager::mainloop(vl::time const &elapsed_time)
 {
@@ -399,6 +569,11 @@ vl::EventManager::mainloop(vl::time const &elapsed_time)
 	{
 		_trackers->getTrackerPtr(i)->mainloop();
 	}
+
+	// Replayed events are injected after the real devices so that they
+	// override the live data for this frame.
+	if(_player)
+	{ _player->mainloop(elapsed_time); }
 	
 	// Process analog tracking devices
 	for(std::map<std::string, vrpn_analog_client_ref_ptr>::iterator iter = _analog_clients.begin(); 
@@ -410,11 +585,7 @@ vl::EventManager::mainloop(vl::time const &elapsed_time)
 	if(_pcan)
 	{ _pcan->mainloop(); }
 
-	for(std::vector<TimeTrigger *>::iterator iter = _time_triggers.begin();
-		iter != _time_triggers.end(); ++iter)
-	{
-		(*iter)->update(elapsed_time);
-	}
+	_timer_wheel.advance(_timer_wheel.getTime() + vl::to_microseconds(elapsed_time));
 
 	if(_frame_trigger)
 	{ _frame_trigger->update(elapsed_time); }
@@ -464,21 +635,27 @@ vl::EventManager::_findTrackerTrigger(const std::string& name)
 vl::KeyTrigger *
 vl::EventManager::_find_key_trigger(OIS::KeyCode kc, std::bitset<8> mod)
 {
-	for( size_t i = 0; i < _key_triggers.size(); ++i )
-	{
-		vl::KeyTrigger *trigger = _key_triggers.at(i);
-		assert(trigger);
+	return _key_table.at(key_index(kc, mod));
+}
 
-		// exact match
-		if( trigger->getKey() == kc && std::bitset<8>(trigger->getModifiers()) == mod )
-		{ return trigger; }
-	}
+vl::KeyTrigger *
+vl::EventManager::_find_best_match(OIS::KeyCode kc, std::bitset<8> mod)
+{
+	return _key_best_table.at(key_index(kc, mod));
+}
 
-	return 0;
+void
+vl::EventManager::_update_best_matches(OIS::KeyCode kc)
+{
+	for(size_t i = 0; i < N_KEY_MODS; ++i)
+	{
+		std::bitset<8> mod(i << 1);
+		_key_best_table.at(key_index(kc, mod)) = _search_best_match(kc, mod);
+	}
 }
 
 vl::KeyTrigger *
-vl::EventManager::_find_best_match(OIS::KeyCode kc, std::bitset<8> mod)
+vl::EventManager::_search_best_match(OIS::KeyCode kc, std::bitset<8> mod)
 {
 	/// Find all the KeyTriggers with matchin keycode
 	std::vector<KeyTrigger *> matching_kc;
@@ -549,6 +726,19 @@ vl::EventManager::_keyUp( OIS::KeyCode kc )
 	return false;
 }
 
+void
+vl::EventManager::_can_message(vl::CANMsg const &msg)
+{
+	// Already passed to the listeners by _injectCANMessage
+	if(_injecting_can)
+	{ return; }
+
+	if(_recorder)
+	{ _recorder->writeCAN(msg.id, msg.length, (uint8_t const *)&msg.data[0]); }
+
+	_can_signal(msg);
+}
+
 void 
 vl::EventManager::_update_key_modifers(std::bitset<8> new_mod)
 {
@@ -20,6 +20,8 @@
 #include "defines.hpp"
 
 #include <vector>
+#include <set>
+#include <map>
 
 #include "trigger.hpp"
 
@@ -29,12 +31,17 @@
 
 #include "input/mouse_event.hpp"
 
+#include "base/signal.hpp"
+
 
 namespace vl
 {
 
+struct CANMsg;
+
 class HYDRA_API EventManager
 {
+	typedef vl::Signal<void (CANMsg const &)> CANMessageSignal;
 public :
 	/// @brief Constructor
 	/// @param res_man ResourceManager used for FileLoading
@@ -85,7 +92,13 @@ public :
 	vl::MouseTrigger *createMouseTrigger(void);
 	void destroyMouseTrigger(vl::MouseTrigger *trigger);
 
-	vl::JoystickTrigger *createJoystickTrigger(void);
+	/// @brief create a trigger for joystick events
+	/// @param dev_id only events from this device, JoystickTrigger::ANY for all
+	/// @param index only events for this button, axis or pov
+	/// Events are dispatched only to the triggers matching them so the cost
+	/// doesn't depend on the number of triggers for other inputs.
+	vl::JoystickTrigger *createJoystickTrigger(int dev_id = JoystickTrigger::ANY,
+		int index = JoystickTrigger::ANY);
 	void destroyJoystickTrigger(vl::JoystickTrigger *trigger);
 	
 	void mouseMoved(vl::MouseEvent const &evt);
@@ -107,6 +120,11 @@ public :
 
 	PCANRefPtr getPCAN(void);
 
+	/// @brief listen to CAN messages from the bus and from replayed recordings
+	/// Unlike PCAN listeners these don't need the device.
+	int addCANListener(CANMessageSignal::slot_type const &slot)
+	{ _can_signal.connect(slot); return 1; }
+
 	vl::ClientsRefPtr getTrackerClients(void)
 	{ return _trackers; }
 
@@ -119,6 +137,40 @@ public :
 	/// @brief remove all triggers
 	void removeTriggers(void);
 
+	/// Recording
+
+	/// @brief start recording all tracker, joystick and CAN events
+	/// @param file path of the binary recording, overwritten if exists
+	/// Stops the previous recording if one is active.
+	/// Trackers added while recording are recorded as well.
+	void startRecording(std::string const &file);
+
+	/// @brief stop recording and write the recording index
+	void stopRecording(void);
+
+	bool isRecording(void) const
+	{ return _recorder != 0; }
+
+	RecordingWriterRefPtr getRecorder(void)
+	{ return _recorder; }
+
+	/// @brief open a recording and start replaying it
+	/// @param name recording file name, searched from resource paths
+	/// @return the player which can be used to control the playback
+	RecordingPlayerRefPtr playRecording(std::string const &name);
+
+	/// @brief get the recording player, creates one if necessary
+	RecordingPlayerRefPtr getRecordingPlayer(void);
+
+	/// @internal
+	/// @brief pass a replayed joystick event to the triggers without recording it
+	void _injectJoystickEvent(vl::JoystickEvent const &evt, int index);
+
+	/// @internal
+	/// @brief pass a replayed CAN message to the listeners without recording it
+	/// Works without the PCAN device.
+	void _injectCANMessage(CANMsg const &msg);
+
 
 	/// File Loaders
 
@@ -132,19 +184,36 @@ private :
 
 	vl::KeyTrigger *_find_best_match(OIS::KeyCode kc, std::bitset<8> mod);
 
+	/// @brief search all the triggers for the one closest to the modifiers
+	vl::KeyTrigger *_search_best_match(OIS::KeyCode kc, std::bitset<8> mod);
+
+	/// @brief update the best match table for a key code
+	void _update_best_matches(OIS::KeyCode kc);
+
 	bool _keyDown( OIS::KeyCode kc );
 
 	bool _keyUp( OIS::KeyCode kc );
 
 	void _update_key_modifers(std::bitset<8> new_mod);
 
+	void _update_joystick_triggers(vl::JoystickEvent const &evt, int index);
+
+	/// Callback for PCAN messages, records and forwards them
+	void _can_message(CANMsg const &msg);
+
 /// Data
 private :
 	std::vector<vl::TrackerTrigger *> _tracker_triggers;
 	std::vector<vl::KeyTrigger *> _key_triggers;
+	/// Key triggers indexed by key code and modifiers, exact matches and
+	/// best matches for every modifier combination
+	std::vector<vl::KeyTrigger *> _key_table;
+	std::vector<vl::KeyTrigger *> _key_best_table;
 	// @warning: added due mouse support and raycast picker testing:
 	std::vector<vl::MouseTrigger *> _mouse_triggers;
-	std::vector< vl::JoystickTrigger* > _joystick_triggers;
+	/// Joystick triggers by device and index
+	typedef std::map<std::pair<int, int>, std::vector<vl::JoystickTrigger *> > JoystickTriggerMap;
+	JoystickTriggerMap _joystick_triggers;
 
 	vl::FrameTrigger *_frame_trigger;
 
@@ -152,15 +221,25 @@ private :
 
 	std::vector<OIS::KeyCode> _keys_down;
 
-	std::vector<TimeTrigger *> _time_triggers;
+	/// Time triggers are scheduled in the wheel so only the due ones are
+	/// touched every frame
+	std::set<TimeTrigger *> _time_triggers;
+	vl::TimerWheel _timer_wheel;
 
 	PCANRefPtr _pcan;
+	CANMessageSignal _can_signal;
+	/// Replayed messages are passed to the PCAN listeners without recording
+	bool _injecting_can;
 
 
 	/// Tracking
 	vl::ClientsRefPtr _trackers;
 	/// name client map
 	std::map<std::string, vrpn_analog_client_ref_ptr> _analog_clients;
+
+	/// Recording
+	RecordingWriterRefPtr _recorder;
+	RecordingPlayerRefPtr _player;
 	
 	/// Resources
 	ResourceManager *_resource_manager;
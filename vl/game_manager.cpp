@@ -34,6 +34,8 @@
 
 // Physics
 #include "physics/physics_world.hpp"
+// Necessary for BVH statistics
+#include "physics/shapes.hpp"
 
 /// Move to FileManager
 /// File Loaders
@@ -77,9 +79,15 @@ vl::GameManager::GameManager(vl::Session *session, vl::Logger *logger, vl::Progr
 	{ BOOST_THROW_EXCEPTION(vl::null_pointer()); }
 
 	_kinematic_world.reset(new vl::KinematicWorld(this));
+	_kinematic_world->setNThreads(opt.kinematic_threads);
 
 	_mesh_manager.reset(new MeshManager(new MasterMeshLoaderCallback(_resource_manager)));
 	_python = new vl::PythonContextImpl( this );
+	_python->getProfiler().setEnabled(opt.debug.python_profiler);
+	_python->getProfiler().setFrameBudget(vl::time(opt.debug.python_frame_budget/1000));
+
+	// Constructed in the frame thread
+	_allocation_tracker.setEnabled(opt.debug.allocation_tracking);
 
 	_material_manager.reset(new MaterialManager(_session));
 
@@ -128,7 +136,16 @@ vl::GameManager::step(void)
 	/// they belong to more than just one category or an ALL category.
 
 	// Process input devices
-	getEventManager()->mainloop(getDeltaTime());
+	{
+		vl::AllocationScope alloc_scope(vl::AS_EVENTS);
+		getEventManager()->mainloop(getDeltaTime());
+	}
+
+	// Results from the Python tasks finished since the last step
+	{
+		vl::AllocationScope alloc_scope(vl::AS_PYTHON);
+		_python->getTasks().processCompleted();
+	}
 
 
 	if(_eye_tracker)
@@ -139,15 +156,21 @@ vl::GameManager::step(void)
 
 	if(isPlaying())
 	{	
+		vl::AllocationScope alloc_scope(vl::AS_SCENE_GRAPH);
+
 		vl::chrono c;
 		_kinematic_world->step(getDeltaTime());
 		_rendering_report[PT_KINEMATICS].push(c.elapsed());
 
 		if( _physics_world )
 		{
+			vl::AllocationScope physics_scope(vl::AS_PHYSICS);
 			c.reset();
 			_physics_world->step(getDeltaTime());
-			_rendering_report[PT_PHYSICS].push(c.elapsed());
+			// Includes waiting for the threaded step of the last frame
+			_rendering_report[PT_PHYSICS].push(c.elapsed() + _physics_wait);
+			_rendering_report[PT_PHYSICS_THREAD].push(_physics_world->getStepTime());
+			_physics_wait = vl::time();
 		}
 
 		c.reset();
@@ -161,9 +184,24 @@ vl::GameManager::step(void)
 
 	_cad_importer->mainloop();
 
+	// Includes scripts and commands executed since the last step
+	_rendering_report[PT_PYTHON].push(_python->getProfiler().finishFrame());
+
 	_fire_step_end();
 }
 
+vl::PythonProfiler &
+vl::GameManager::getPythonProfiler(void)
+{
+	return getPython()->getProfiler();
+}
+
+vl::PythonTaskQueue &
+vl::GameManager::getPythonTasks(void)
+{
+	return getPython()->getTasks();
+}
+
 vl::GameObjectRefPtr
 vl::GameManager::createGameObject(std::string const &name)
 {
@@ -216,6 +254,17 @@ vl::GameManager::enablePhysics( bool enable )
 	}
 }
 
+void
+vl::GameManager::finishPhysicsStep(void)
+{
+	if(_physics_world)
+	{
+		vl::chrono c;
+		_physics_world->finishStep();
+		_physics_wait += c.elapsed();
+	}
+}
+
 bool
 vl::GameManager::isQuited(void) const
 {
@@ -499,6 +548,7 @@ vl::GameManager::loadScene(vl::config::SceneInfo const &scene_info, LOADER_FLAGS
 				// we could use runtime for changing settings but there is no such functionality yet.
 				//settings.handle_duplicates = vl::dae::ImporterSettings::HDN_USE_ORIGINAL;
 				//settings.remove_duplicate_materials = true;
+				settings.generate_lods = _options.collada_generate_lods;
 				vl::dae::Managers man;
 				man.material = _material_manager;
 				man.scene = _scene_manager;
@@ -638,6 +688,7 @@ vl::GameManager::_do_init(init const &evt)
 	if(!ov)
 	{ BOOST_THROW_EXCEPTION(vl::exception()); }
 	ov->setRenderingReport(&_rendering_report);
+	ov->setPythonReport(&_python->getProfiler().getReport());
 	ov->setVisible(_options.debug.overlay);
 	ov->setShowAdvanced(_options.debug.overlay_advanced);
 
@@ -676,6 +727,8 @@ vl::GameManager::_do_load(vl::load const &evt)
 	if(!_global_project.empty() || !_loaded_project.empty())
 	{ BOOST_THROW_EXCEPTION(vl::exception()); }
 
+	physics::StaticTriangleMeshShape::getBvhStatistics() = physics::BvhStatistics();
+
 	std::clog << "Loading Global " << evt.global << std::endl;
 	_loadGlobal(evt.global);
 
@@ -702,6 +755,13 @@ vl::GameManager::_do_load(vl::load const &evt)
 	/// Run the python scripts
 	getPython()->autoRunScripts();
 
+	// Collision meshes are created by the scripts
+	physics::BvhStatistics const &bvh = physics::StaticTriangleMeshShape::getBvhStatistics();
+	if(bvh.n_built > 0)
+	{ _init_report["Building collision BVHs"].push(bvh.build_time); }
+	if(bvh.n_loaded > 0)
+	{ _init_report["Loading cached collision BVHs"].push(bvh.load_time); }
+
 	_loaded_signal();
 }
 
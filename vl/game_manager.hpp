@@ -55,6 +55,8 @@
 #include "program_options.hpp"
 
 #include "profiler_report.hpp"
+
+#include "base/allocation_tracker.hpp"
 // Necessary for LOADER_FLAGS
 #include "flags.hpp"
 // Necessary for EyeTracker
@@ -168,6 +170,13 @@ public :
 	vl::Report<vl::time> &getInitReport(void)
 	{ return _init_report; }
 
+	vl::PythonProfiler &getPythonProfiler(void);
+
+	vl::PythonTaskQueue &getPythonTasks(void);
+
+	vl::AllocationTracker &getAllocationTracker(void)
+	{ return _allocation_tracker; }
+
 	/// @brief Step the simulation forward
 	void step(void);
 
@@ -213,6 +222,11 @@ public :
 	bool isPhysicsEnabled(void)
 	{ return(_physics_world != 0); }
 
+	/// @brief wait for threaded physics to finish the step started in this frame
+	/// Needs to be called before anything else than rendering accesses
+	/// the physics bodies.
+	void finishPhysicsStep(void);
+
 	RazerHydraRefPtr getRazerHydra(void)
 	{ return _razer_hydra; }
 
@@ -456,6 +470,8 @@ private :
 	vl::ProfilerReport _rendering_report;
 	vl::Report<vl::time> _init_report;
 
+	vl::AllocationTracker _allocation_tracker;
+
 	vl::Logger *_logger;
 
 	/// Timers
@@ -466,6 +482,8 @@ private :
 
 	/// Physics
 	physics::WorldRefPtr _physics_world;
+	/// Time the frame waited for threaded physics
+	vl::time _physics_wait;
 
 	/// Non physics constraints
 	KinematicWorldRefPtr _kinematic_world;
@@ -18,10 +18,21 @@
 
 #include "gui.hpp"
 
+#include <algorithm>
+
+namespace
+{
+
+/// Number of the slowest Python zones shown
+size_t const N_PYTHON_ZONES = 8;
+
+}	// unamed namespace
+
 vl::gui::PerformanceOverlay::PerformanceOverlay(vl::gui::GUI *creator)
 	: vl::gui::Window(creator)
 	, _init_report(0)
 	, _rendering_report(0)
+	, _python_report(0)
 	, _show_advanced(false)
 	, _font(CONSOLE_FONT_INDEX)
 	, _fps(0)
@@ -30,6 +41,7 @@ vl::gui::PerformanceOverlay::PerformanceOverlay(vl::gui::GUI *creator)
 	, _advanced_layer(0)
 	, _advanced_caption(0)
 	, _advance_text(0)
+	, _python_text(0)
 	, _basic_layer(0)
 	, _basic_decoration(0)
 	, _basic_text(0)
@@ -127,6 +139,9 @@ vl::gui::PerformanceOverlay::_window_resetted(void)
 	_rendering_line->position(line_x_start, y + 22);
 	_rendering_line->position(line_x_end, y + 22);
 	_rendering_line->end();
+	// Python, runs inside the other parts of the frame so no line for it
+	y += 24;
+	_python_text = _advanced_layer->createMarkupText(_font,  x, y, "");
 
 	// Extra text displyu for extra ordinary stuff
 	y = mScreen->getHeight()/4*3;
@@ -232,6 +247,14 @@ vl::gui::PerformanceOverlay::recaluclateDirties(void)
 
 		_init_report->_clearDirty();
 	}
+
+	if(_python_report)
+	{
+		if(_python_report->isDirty())
+		{ setDirty(DIRTY_PYTHON_REPORT); }
+
+		_python_report->_clearDirty();
+	}
 }
 
 // Serializing the report
@@ -259,6 +282,14 @@ vl::gui::PerformanceOverlay::doSerialize(vl::cluster::ByteStream &msg, const uin
 		else
 		{ msg << size_t(0); }
 	}
+
+	if(DIRTY_PYTHON_REPORT & dirtyBits)
+	{
+		if(_python_report)
+		{ msg << *_python_report; }
+		else
+		{ msg << size_t(0); }
+	}
 }
 
 void
@@ -308,7 +339,12 @@ vl::gui::PerformanceOverlay::doDeserialize(vl::cluster::ByteStream &msg, const u
 			{
 				ss.str("");
 				p_physics = physics_time/frame_time;
-				ss << "Physics time " << physics_time << "    %3" << 100*p_physics << "%%" << "%R";
+				ss << "Physics time " << physics_time << "    %3" << 100*p_physics << "%%";
+				// Threaded physics are simulated in parallel with the frame
+				vl::time thread_time = (*_rendering_report)[PT_PHYSICS_THREAD].result();
+				if(thread_time > physics_time)
+				{ ss << "  simulation " << thread_time; }
+				ss << "%R";
 				_physics_text->text(ss.str());
 			}
 			else
@@ -324,6 +360,16 @@ vl::gui::PerformanceOverlay::doDeserialize(vl::cluster::ByteStream &msg, const u
 			}
 			else
 			{ _collisions_text->text(""); }
+			// Python
+			vl::time python_time = (*_rendering_report)[PT_PYTHON].result();
+			if(python_time != vl::time())
+			{
+				ss.str("");
+				ss << "Python time " << python_time << "    %3" << 100*(python_time/frame_time) << "%%" << "%R";
+				_python_text->text(ss.str());
+			}
+			else
+			{ _python_text->text(""); }
 			// Rendering
 			ss.str("");
 			vl::time rend_time = (*_rendering_report)[PT_RENDERING].result();
@@ -377,6 +423,38 @@ vl::gui::PerformanceOverlay::doDeserialize(vl::cluster::ByteStream &msg, const u
 		// @todo add widget for this
 	}
 
+	if(DIRTY_PYTHON_REPORT & dirtyBits)
+	{
+		// Replaced so zones removed on the master are removed here
+		if(!_python_report)
+		{ _python_report = new Report<vl::time>; }
+		else
+		{ *_python_report = Report<vl::time>(); }
+		msg >> *_python_report;
+		_update_python_text();
+	}
+}
+
+void
+vl::gui::PerformanceOverlay::_update_python_text(void)
+{
+	if(!_advance_text || !_python_report)
+	{ return; }
+
+	// Slowest zones first
+	std::vector< std::pair<vl::time, std::string> > zones;
+	std::map< std::string, Number<vl::time> >::const_iterator iter;
+	for(iter = _python_report->begin(); iter != _python_report->end(); ++iter)
+	{
+		if(iter->second.result() != vl::time())
+		{ zones.push_back(std::make_pair(iter->second.result(), iter->first)); }
+	}
+	std::sort(zones.rbegin(), zones.rend());
+
+	std::stringstream ss;
+	for(size_t i = 0; i < zones.size() && i < N_PYTHON_ZONES; ++i)
+	{ ss << zones[i].second << " : " << zones[i].first << "\n"; }
+	_advance_text->text(ss.str());
 }
 
 template<>
@@ -65,6 +65,16 @@ public :
 	ProfilerReport *getRenderingReport(void)
 	{ return _rendering_report; }
 
+	/// Python zones from the PythonProfiler, the slowest are listed
+	void setPythonReport(Report<vl::time> *report)
+	{
+		setDirty(DIRTY_PYTHON_REPORT);
+		_python_report = report;
+	}
+
+	Report<vl::time> *getPythonReport(void)
+	{ return _python_report; }
+
 	void setShowAdvanced(bool show)
 	{
 		if(_show_advanced != show)
@@ -82,6 +92,7 @@ public :
 		DIRTY_SHOW_ADVANCED = Window::DIRTY_CUSTOM << 0,
 		DIRTY_RENDERING_REPORT = Window::DIRTY_CUSTOM << 1,
 		DIRTY_INIT_REPORT = Window::DIRTY_CUSTOM << 2,
+		DIRTY_PYTHON_REPORT = Window::DIRTY_CUSTOM << 3,
 	};
 
 	// Renderer specific stats (updated by the Renderer)
@@ -112,10 +123,13 @@ private :
 	// Dirty update
 	void _dirty_update(void);
 
+	void _update_python_text(void);
+
 private :
 	// From master
 	Report<vl::time> *_init_report;
 	ProfilerReport *_rendering_report;
+	Report<vl::time> *_python_report;
 
 	// From local renderer
 	vl::scalar _fps;
@@ -147,6 +161,8 @@ private :
 	// Rendering
 	Gorilla::LineList *_rendering_line;
 	Gorilla::MarkupText *_rendering_text;
+	// Python scripts
+	Gorilla::MarkupText *_python_text;
 
 	// CPU usage
 	Gorilla::MarkupText *_cpu_text;
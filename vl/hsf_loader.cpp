@@ -518,6 +518,18 @@ vl::HSFLoader::processNode(rapidxml::xml_node<> *xml_node)
 	}
 
 	assert(collision_detection == node->isCollisionDetectionEnabled());
+
+	// Set after the children so the geometry is baked only once
+	if(vl::getAttrib(xml_node, "static", false))
+	{
+		if(dynamic || kinematic)
+		{
+			std::clog << "Warning : GameObject " << name << " is "
+				<< physics_engine_name << " ignoring static." << std::endl;
+		}
+		else
+		{ node->getGraphicsNode()->setStatic(true); }
+	}
 }
 
 void
@@ -621,6 +633,9 @@ vl::HSFLoader::processChildNode(rapidxml::xml_node<> *xml_node, vl::SceneNodePtr
 		processCamera(pElement, node);
 		pElement = pElement->next_sibling("camera");
 	}
+
+	if(vl::getAttrib(xml_node, "static", false))
+	{ node->setStatic(true); }
 }
 
 void
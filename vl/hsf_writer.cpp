@@ -129,6 +129,9 @@ vl::HSFWriter::writeNode(rapidxml::xml_node<> *xml_node, GameObjectRefPtr obj)
 	char *type = _doc.allocate_string(physics_type.c_str());
 	xml_node->append_attribute(_doc.allocate_attribute("physics_type", type));
 
+	if(obj->getGraphicsNode()->isStatic())
+	{ xml_node->append_attribute(_doc.allocate_attribute("static", "true")); }
+
 	// Write dynamics
 	rapidxml::xml_node<> *xml_body = _doc.allocate_node(rapidxml::node_element, "body");
 	xml_node->append_node(xml_body);
@@ -22,7 +22,7 @@
 
 #include <stdint.h>
 
-#include <boost/signal.hpp>
+#include "base/signal.hpp"
 
 /// Using the c interface for PCAN
 /// @todo this is problematic we really don't want to include Windows.h
@@ -96,7 +96,7 @@ std::ostream &operator<<(std::ostream &os, CANMsg const &msg)
 /// @todo we could also make it dynamic with the dll (sample in the PCAN c++ builder)
 class PCAN : public InputDevice
 {
-	typedef boost::signal<void (CANMsg const &)> NewMessageSignal;
+	typedef vl::Signal<void (CANMsg const &)> NewMessageSignal;
 public :
 	/// Create a pcan listener
 	PCAN(void);
@@ -112,6 +112,11 @@ public :
 	int addListener(NewMessageSignal::slot_type const &slot) 
 	{ _signal.connect(slot); return 1; }
 
+	/// @brief pass a message to the listeners as if it was read from the bus
+	/// Used for replaying recorded CAN traffic.
+	void injectMessage(CANMsg const &msg)
+	{ _signal(msg); }
+
 private :
 	/// Disallow copy
 	PCAN(PCAN const &other);
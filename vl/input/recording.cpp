@@ -0,0 +1,581 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file input/recording.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+// Interface
+#include "recording.hpp"
+
+#include "base/exceptions.hpp"
+
+// Necessary for std::upper_bound
+#include <algorithm>
+
+namespace
+{
+
+char const FILE_MAGIC[4] = { 'H', 'R', 'E', 'C' };
+char const CHUNK_MAGIC[4] = { 'H', 'R', 'C', 'K' };
+char const INDEX_MAGIC[4] = { 'H', 'R', 'I', 'X' };
+char const FOOTER_MAGIC[4] = { 'H', 'R', 'E', 'N' };
+
+/// magic + version + reserved
+size_t const FILE_HEADER_SIZE = 4 + 2 + 2;
+/// magic + records + data size + first time + last time
+size_t const CHUNK_HEADER_SIZE = 4 + 4 + 4 + 8 + 8;
+/// index offset + magic
+size_t const FOOTER_SIZE = 8 + 4;
+/// type + time + payload size
+size_t const RECORD_HEADER_SIZE = 1 + 8 + 2;
+
+template<typename T>
+void write_pod(std::ostream &os, T const &t)
+{ os.write((char const *)&t, sizeof(t)); }
+
+template<typename T>
+bool read_pod(std::istream &is, T &t)
+{
+	is.read((char *)&t, sizeof(t));
+	return is.gcount() == sizeof(t);
+}
+
+void write_time(std::ostream &os, vl::time const &t)
+{
+	write_pod(os, t.sec);
+	write_pod(os, t.usec);
+}
+
+bool read_time(std::istream &is, vl::time &t)
+{
+	return read_pod(is, t.sec) && read_pod(is, t.usec);
+}
+
+bool check_magic(char const *read, char const *magic)
+{
+	return ::memcmp(read, magic, 4) == 0;
+}
+
+/// Comparison for searching the chunk that contains a time
+struct chunk_last_less
+{
+	bool operator()(vl::time const &t, vl::RecordingChunkInfo const &info) const
+	{ return t < info.last; }
+};
+
+}	// unamed namespace
+
+/// ------------------------------ Global ------------------------------------
+std::ostream &
+vl::operator<<(std::ostream &os, vl::Record const &rec)
+{
+	os << "Record at " << rec.time << " : ";
+	switch(rec.type)
+	{
+	case RT_TRACKER :
+		os << "tracker " << rec.tracker << " sensor " << rec.sensor
+			<< " : " << rec.transform;
+		break;
+	case RT_JOYSTICK :
+		os << "joystick " << rec.joystick;
+		break;
+	case RT_CAN :
+		os << "CAN msg 0x" << std::hex << rec.can_id << std::dec
+			<< " length " << (int)rec.can_length;
+		break;
+	default :
+		os << "undefined";
+	}
+
+	return os;
+}
+
+/// ------------------------------ RecordBuffer ------------------------------
+void
+vl::RecordBuffer::read(char *mem, msg_size size)
+{
+	if(_pos + size > _data.size())
+	{ BOOST_THROW_EXCEPTION(vl::short_message()); }
+
+	::memcpy(mem, &_data[_pos], size);
+	_pos += size;
+}
+
+void
+vl::RecordBuffer::write(char const *mem, msg_size size)
+{
+	size_t index = _data.size();
+	_data.resize(index + size);
+	::memcpy(&_data[index], mem, size);
+}
+
+void
+vl::RecordBuffer::skip(size_t bytes)
+{
+	if(_pos + bytes > _data.size())
+	{ BOOST_THROW_EXCEPTION(vl::short_message()); }
+
+	_pos += bytes;
+}
+
+void
+vl::RecordBuffer::seek(size_t pos)
+{
+	if(pos > _data.size())
+	{ BOOST_THROW_EXCEPTION(vl::short_message()); }
+
+	_pos = pos;
+}
+
+/// ------------------------------ RecordingWriter ---------------------------
+vl::RecordingWriter::RecordingWriter(std::string const &file, uint32_t chunk_size)
+	: _filename(file)
+	, _chunk_size(chunk_size)
+	, _record_start(0)
+	, _n_records(0)
+	, _bytes_written(0)
+{
+	_file.open(file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if(!_file.is_open())
+	{ BOOST_THROW_EXCEPTION(vl::file_error() << vl::file_name(file)); }
+
+	_file.write(FILE_MAGIC, 4);
+	write_pod(_file, RECORDING_VERSION);
+	write_pod(_file, uint16_t(0));
+	_bytes_written = FILE_HEADER_SIZE;
+
+	// Reserve the whole chunk so we don't reallocate when recording
+	_chunk.data().reserve(_chunk_size + 512);
+
+	_timer.reset();
+}
+
+vl::RecordingWriter::~RecordingWriter(void)
+{
+	// Never throw from destructor
+	try
+	{ close(); }
+	catch(...)
+	{ std::cout << "Exception in RecordingWriter::close." << std::endl; }
+}
+
+void
+vl::RecordingWriter::writeTracker(uint16_t tracker, uint16_t sensor, vl::Transform const &t)
+{
+	_begin_record(RT_TRACKER, _timer.elapsed());
+	_chunk << tracker << sensor << t.position << t.quaternion;
+	_end_record();
+}
+
+void
+vl::RecordingWriter::writeJoystick(int32_t joystick, vl::JoystickEvent const &evt)
+{
+	_begin_record(RT_JOYSTICK, _timer.elapsed());
+	_chunk << joystick << evt;
+	_end_record();
+}
+
+void
+vl::RecordingWriter::writeCAN(uint32_t id, uint8_t length, uint8_t const data[8])
+{
+	_begin_record(RT_CAN, _timer.elapsed());
+	_chunk << id << length;
+	_chunk.write((char const *)data, 8);
+	_end_record();
+}
+
+void
+vl::RecordingWriter::write(vl::Record const &rec)
+{
+	switch(rec.type)
+	{
+	case RT_TRACKER :
+		_begin_record(rec.type, rec.time);
+		_chunk << rec.tracker << rec.sensor << rec.transform.position << rec.transform.quaternion;
+		_end_record();
+		break;
+	case RT_JOYSTICK :
+		_begin_record(rec.type, rec.time);
+		_chunk << rec.joystick << rec.joystick_event;
+		_end_record();
+		break;
+	case RT_CAN :
+		_begin_record(rec.type, rec.time);
+		_chunk << rec.can_id << rec.can_length;
+		_chunk.write((char const *)rec.can_data, 8);
+		_end_record();
+		break;
+	default :
+		BOOST_THROW_EXCEPTION(vl::invalid_param() << vl::desc("Undefined record type"));
+	}
+}
+
+void
+vl::RecordingWriter::flush(void)
+{
+	if(!_file.is_open() || _chunk_info.records == 0)
+	{ return; }
+
+	_chunk_info.offset = _bytes_written;
+
+	_file.write(CHUNK_MAGIC, 4);
+	write_pod(_file, _chunk_info.records);
+	write_pod(_file, uint32_t(_chunk.size()));
+	write_time(_file, _chunk_info.first);
+	write_time(_file, _chunk_info.last);
+	_file.write(&_chunk.data()[0], _chunk.size());
+	_file.flush();
+
+	_bytes_written += CHUNK_HEADER_SIZE + _chunk.size();
+
+	_index.push_back(_chunk_info);
+
+	_chunk.clear();
+	_chunk_info = RecordingChunkInfo();
+}
+
+void
+vl::RecordingWriter::close(void)
+{
+	if(!_file.is_open())
+	{ return; }
+
+	flush();
+
+	uint64_t index_offset = _bytes_written;
+	_file.write(INDEX_MAGIC, 4);
+	write_pod(_file, uint32_t(_index.size()));
+	for(size_t i = 0; i < _index.size(); ++i)
+	{
+		RecordingChunkInfo const &info = _index.at(i);
+		write_pod(_file, info.offset);
+		write_time(_file, info.first);
+		write_time(_file, info.last);
+		write_pod(_file, info.records);
+	}
+
+	write_pod(_file, index_offset);
+	_file.write(FOOTER_MAGIC, 4);
+
+	_file.close();
+}
+
+void
+vl::RecordingWriter::_begin_record(RECORD_TYPE type, vl::time const &t)
+{
+	if(!_file.is_open())
+	{ BOOST_THROW_EXCEPTION(vl::file_error() << vl::file_name(_filename) << vl::desc("Recording is closed")); }
+
+	if(_chunk_info.records == 0)
+	{ _chunk_info.first = t; }
+	else if(t < _chunk_info.last)
+	{ BOOST_THROW_EXCEPTION(vl::invalid_param() << vl::desc("Records need to be written in time order")); }
+
+	_chunk_info.last = t;
+
+	_record_start = _chunk.size();
+	_chunk << uint8_t(type) << t.sec << t.usec;
+	// Place holder for the payload size
+	_chunk << uint16_t(0);
+}
+
+void
+vl::RecordingWriter::_end_record(void)
+{
+	size_t payload = _chunk.size() - _record_start - RECORD_HEADER_SIZE;
+	if(payload > 0xFFFF)
+	{ BOOST_THROW_EXCEPTION(vl::long_message()); }
+
+	uint16_t payload_size = uint16_t(payload);
+	::memcpy(&_chunk.data()[_record_start + RECORD_HEADER_SIZE - 2], &payload_size, 2);
+
+	++_chunk_info.records;
+	++_n_records;
+
+	if(_chunk.size() >= _chunk_size)
+	{ flush(); }
+}
+
+/// ------------------------------ RecordingReader ---------------------------
+vl::RecordingReader::RecordingReader(std::string const &file)
+	: _filename(file)
+	, _recovered(false)
+	, _current_chunk(0)
+{
+	_file.open(file.c_str(), std::ios::in | std::ios::binary);
+	if(!_file.is_open())
+	{ BOOST_THROW_EXCEPTION(vl::missing_file() << vl::file_name(file)); }
+
+	_read_header();
+
+	if(!_read_index())
+	{
+		std::cout << "Recording " << file << " has no index, rebuilding it." << std::endl;
+		_scan_index();
+		_recovered = true;
+	}
+
+	rewind();
+}
+
+vl::RecordingReader::~RecordingReader(void)
+{}
+
+bool
+vl::RecordingReader::next(vl::Record &rec)
+{
+	while(_current_chunk < _index.size())
+	{
+		if(_read_record(rec))
+		{ return true; }
+
+		++_current_chunk;
+		if(_current_chunk < _index.size())
+		{ _load_chunk(_current_chunk); }
+	}
+
+	return false;
+}
+
+void
+vl::RecordingReader::seek(vl::time const &t)
+{
+	// First chunk that has records equal or later than t
+	std::vector<RecordingChunkInfo>::const_iterator iter
+		= std::upper_bound(_index.begin(), _index.end(), t, chunk_last_less());
+	// upper_bound gives us the first chunk with last > t,
+	// but the previous one could end exactly at t
+	while(iter != _index.begin() && !((iter-1)->last < t))
+	{ --iter; }
+
+	_current_chunk = iter - _index.begin();
+	_chunk.clear();
+	if(_current_chunk >= _index.size())
+	{ return; }
+
+	_load_chunk(_current_chunk);
+
+	// Skip the records that are before t
+	while(!_chunk.eof())
+	{
+		size_t pos = _chunk.tell();
+		uint8_t type;
+		vl::time rec_time;
+		uint16_t payload;
+		_chunk >> type >> rec_time.sec >> rec_time.usec >> payload;
+		if(!(rec_time < t))
+		{
+			// Rewind to the start of the record
+			_chunk.seek(pos);
+			return;
+		}
+		_chunk.skip(payload);
+	}
+
+	// Only possible if the index is out of sync with the chunk
+	++_current_chunk;
+	if(_current_chunk < _index.size())
+	{ _load_chunk(_current_chunk); }
+}
+
+vl::time
+vl::RecordingReader::getLength(void) const
+{
+	if(_index.empty())
+	{ return vl::time(); }
+
+	return _index.back().last;
+}
+
+uint64_t
+vl::RecordingReader::getNRecords(void) const
+{
+	uint64_t n = 0;
+	for(size_t i = 0; i < _index.size(); ++i)
+	{ n += _index.at(i).records; }
+
+	return n;
+}
+
+void
+vl::RecordingReader::_read_header(void)
+{
+	char magic[4];
+	uint16_t version = 0;
+	uint16_t reserved = 0;
+	_file.read(magic, 4);
+	if(_file.gcount() != 4 || !check_magic(magic, FILE_MAGIC)
+		|| !read_pod(_file, version) || !read_pod(_file, reserved))
+	{
+		BOOST_THROW_EXCEPTION(vl::parsing_error() << vl::file_name(_filename)
+			<< vl::desc("Not a Hydra recording"));
+	}
+
+	if(version > RECORDING_VERSION)
+	{
+		BOOST_THROW_EXCEPTION(vl::parsing_error() << vl::file_name(_filename)
+			<< vl::desc("Unsupported recording version " + vl::to_string(version)));
+	}
+}
+
+bool
+vl::RecordingReader::_read_index(void)
+{
+	_file.clear();
+	_file.seekg(0, std::ios::end);
+	uint64_t file_size = (uint64_t)_file.tellg();
+	if(file_size < FILE_HEADER_SIZE + FOOTER_SIZE)
+	{ return false; }
+
+	_file.seekg(file_size - FOOTER_SIZE, std::ios::beg);
+	uint64_t index_offset = 0;
+	char magic[4];
+	if(!read_pod(_file, index_offset))
+	{ return false; }
+	_file.read(magic, 4);
+	if(_file.gcount() != 4 || !check_magic(magic, FOOTER_MAGIC))
+	{ return false; }
+
+	if(index_offset < FILE_HEADER_SIZE || index_offset >= file_size)
+	{ return false; }
+
+	_file.seekg(index_offset, std::ios::beg);
+	_file.read(magic, 4);
+	uint32_t n_chunks = 0;
+	if(_file.gcount() != 4 || !check_magic(magic, INDEX_MAGIC) || !read_pod(_file, n_chunks))
+	{ return false; }
+
+	std::vector<RecordingChunkInfo> index(n_chunks);
+	for(size_t i = 0; i < index.size(); ++i)
+	{
+		RecordingChunkInfo &info = index.at(i);
+		if(!read_pod(_file, info.offset) || !read_time(_file, info.first)
+			|| !read_time(_file, info.last) || !read_pod(_file, info.records))
+		{ return false; }
+	}
+
+	_index.swap(index);
+	return true;
+}
+
+void
+vl::RecordingReader::_scan_index(void)
+{
+	_index.clear();
+
+	_file.clear();
+	_file.seekg(0, std::ios::end);
+	uint64_t file_size = (uint64_t)_file.tellg();
+
+	uint64_t offset = FILE_HEADER_SIZE;
+	while(offset + CHUNK_HEADER_SIZE <= file_size)
+	{
+		_file.seekg(offset, std::ios::beg);
+
+		RecordingChunkInfo info;
+		info.offset = offset;
+
+		char magic[4];
+		uint32_t data_size = 0;
+		_file.read(magic, 4);
+		if(_file.gcount() != 4 || !check_magic(magic, CHUNK_MAGIC))
+		{ break; }
+
+		if(!read_pod(_file, info.records) || !read_pod(_file, data_size)
+			|| !read_time(_file, info.first) || !read_time(_file, info.last))
+		{ break; }
+
+		// Discard partially written chunks
+		offset += CHUNK_HEADER_SIZE + data_size;
+		if(offset > file_size)
+		{ break; }
+
+		_index.push_back(info);
+	}
+
+	_file.clear();
+}
+
+void
+vl::RecordingReader::_load_chunk(size_t index)
+{
+	RecordingChunkInfo const &info = _index.at(index);
+
+	_file.clear();
+	_file.seekg(info.offset, std::ios::beg);
+
+	char magic[4];
+	uint32_t records = 0;
+	uint32_t data_size = 0;
+	vl::time first, last;
+	_file.read(magic, 4);
+	if(_file.gcount() != 4 || !check_magic(magic, CHUNK_MAGIC)
+		|| !read_pod(_file, records) || !read_pod(_file, data_size)
+		|| !read_time(_file, first) || !read_time(_file, last))
+	{
+		BOOST_THROW_EXCEPTION(vl::parsing_error() << vl::file_name(_filename)
+			<< vl::desc("Corrupted chunk header"));
+	}
+
+	_chunk.clear();
+	_chunk.data().resize(data_size);
+	if(data_size > 0)
+	{
+		_file.read(&_chunk.data()[0], data_size);
+		if((uint32_t)_file.gcount() != data_size)
+		{
+			BOOST_THROW_EXCEPTION(vl::parsing_error() << vl::file_name(_filename)
+				<< vl::desc("Truncated chunk"));
+		}
+	}
+}
+
+bool
+vl::RecordingReader::_read_record(vl::Record &rec)
+{
+	if(_chunk.eof())
+	{ return false; }
+
+	uint8_t type;
+	uint16_t payload;
+	_chunk >> type >> rec.time.sec >> rec.time.usec >> payload;
+	size_t payload_start = _chunk.tell();
+
+	rec.type = (RECORD_TYPE)type;
+	switch(rec.type)
+	{
+	case RT_TRACKER :
+		_chunk >> rec.tracker >> rec.sensor >> rec.transform.position >> rec.transform.quaternion;
+		break;
+	case RT_JOYSTICK :
+		_chunk >> rec.joystick >> rec.joystick_event;
+		break;
+	case RT_CAN :
+		_chunk >> rec.can_id >> rec.can_length;
+		_chunk.read((char *)rec.can_data, 8);
+		break;
+	default :
+		// Unknown records from newer versions are skipped
+		rec.type = RT_UNDEFINED;
+		break;
+	}
+
+	// Use the stored size so that unknown payloads can be skipped
+	size_t read = _chunk.tell() - payload_start;
+	if(read > payload)
+	{
+		BOOST_THROW_EXCEPTION(vl::parsing_error() << vl::file_name(_filename)
+			<< vl::desc("Record payload overflow"));
+	}
+	_chunk.skip(payload - read);
+
+	return true;
+}
@@ -0,0 +1,329 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file input/recording.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Binary input recording format.
+ *
+ *	Used for capturing full rate tracker, joystick and CAN streams for long
+ *	sessions and replaying them back into the EventManager.
+ *
+ *	File layout (native endian, all sizes in bytes)
+ *	[FILE_HEADER | CHUNK* | INDEX | FOOTER]
+ *
+ *	FILE_HEADER
+ *	[MAGIC "HREC" | VERSION (16bit) | RESERVED (16bit)]
+ *
+ *	CHUNK
+ *	[MAGIC "HRCK" | RECORDS (32bit) | DATA_SIZE (32bit) | FIRST_TIME | LAST_TIME | DATA]
+ *	where DATA is RECORDS times
+ *	[TYPE (8bit) | TIME | PAYLOAD_SIZE (16bit) | PAYLOAD]
+ *
+ *	INDEX
+ *	[MAGIC "HRIX" | CHUNKS (32bit) | [N | OFFSET (64bit) | FIRST_TIME | LAST_TIME | RECORDS (32bit)]]
+ *
+ *	FOOTER
+ *	[INDEX_OFFSET (64bit) | MAGIC "HREN"]
+ *
+ *	Times are stored as vl::time (seconds, microseconds) since the start of
+ *	the recording.
+ *
+ *	The file is append only, chunks are written as complete units so if the
+ *	program dies before the index is written all but the last chunk can still
+ *	be recovered. Reader rebuilds the index by scanning the chunk headers
+ *	if the footer is missing.
+ *
+ *	Reader only ever keeps one chunk in memory so recordings of arbitary
+ *	length can be played back.
+ */
+
+#ifndef HYDRA_INPUT_RECORDING_HPP
+#define HYDRA_INPUT_RECORDING_HPP
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "base/time.hpp"
+#include "base/chrono.hpp"
+
+// Necessary for vl::Transform
+#include "math/transform.hpp"
+// Necessary for JoystickEvent and ByteStream
+#include "joystick_event.hpp"
+
+namespace vl
+{
+
+/// Version of the recording format written by RecordingWriter
+const uint16_t RECORDING_VERSION = 1;
+
+/// Default size of a chunk before it's flushed to disk
+const uint32_t RECORDING_CHUNK_SIZE = 64*1024;
+
+enum RECORD_TYPE
+{
+	RT_UNDEFINED = 0,
+	RT_TRACKER,
+	RT_JOYSTICK,
+	RT_CAN,
+};
+
+/// @struct Record
+/// @brief a single recorded input event
+/// Only the fields corresponding to the type are valid.
+struct Record
+{
+	Record(void)
+		: type(RT_UNDEFINED)
+		, tracker(0)
+		, sensor(0)
+		, joystick(0)
+		, can_id(0)
+		, can_length(0)
+	{
+		for(size_t i = 0; i < 8; ++i)
+		{ can_data[i] = 0; }
+	}
+
+	RECORD_TYPE type;
+	vl::time time;
+
+	/// RT_TRACKER
+	/// tracker is the index of the tracker in the tracker Clients
+	uint16_t tracker;
+	uint16_t sensor;
+	vl::Transform transform;
+
+	/// RT_JOYSTICK
+	int32_t joystick;
+	vl::JoystickEvent joystick_event;
+
+	/// RT_CAN
+	uint32_t can_id;
+	uint8_t can_length;
+	uint8_t can_data[8];
+};
+
+std::ostream &operator<<(std::ostream &os, Record const &rec);
+
+/// @struct RecordingChunkInfo
+/// @brief index entry for a chunk
+struct RecordingChunkInfo
+{
+	RecordingChunkInfo(void)
+		: offset(0), records(0)
+	{}
+
+	uint64_t offset;
+	vl::time first;
+	vl::time last;
+	uint32_t records;
+};
+
+/// @class RecordBuffer
+/// @brief memory buffer that can be used with the cluster serialisation operators
+class RecordBuffer : public cluster::ByteStream
+{
+public :
+	RecordBuffer(void)
+		: _pos(0)
+	{}
+
+	virtual void read(char *mem, msg_size size);
+
+	virtual void write(char const *mem, msg_size size);
+
+	void clear(void)
+	{
+		_data.clear();
+		_pos = 0;
+	}
+
+	/// @brief position of the read head
+	size_t tell(void) const
+	{ return _pos; }
+
+	/// @brief skip bytes from reading
+	void skip(size_t bytes);
+
+	/// @brief move the read head to an absolute position
+	void seek(size_t pos);
+
+	bool eof(void) const
+	{ return _pos >= _data.size(); }
+
+	size_t size(void) const
+	{ return _data.size(); }
+
+	std::vector<char> &data(void)
+	{ return _data; }
+
+	std::vector<char> const &data(void) const
+	{ return _data; }
+
+private :
+	std::vector<char> _data;
+	size_t _pos;
+
+};	// class RecordBuffer
+
+/// @class RecordingWriter
+/// @brief Appends input events to a binary recording
+/// Timestamps are taken from the writer's own clock which is started when
+/// the file is opened.
+class RecordingWriter
+{
+public :
+	/// @param file path of the file to create, existing file is overwritten
+	/// @param chunk_size size in bytes after which the chunk is flushed
+	/// @throw vl::file_error if the file can not be opened for writing
+	RecordingWriter(std::string const &file, uint32_t chunk_size = RECORDING_CHUNK_SIZE);
+
+	/// Closes the file if it's still open
+	~RecordingWriter(void);
+
+	void writeTracker(uint16_t tracker, uint16_t sensor, vl::Transform const &t);
+
+	void writeJoystick(int32_t joystick, vl::JoystickEvent const &evt);
+
+	void writeCAN(uint32_t id, uint8_t length, uint8_t const data[8]);
+
+	/// @brief write a fully constructed record, timestamp is taken from the record
+	/// Records need to be written in time order.
+	void write(Record const &rec);
+
+	/// @brief flush the current chunk to disk
+	void flush(void);
+
+	/// @brief flush and write the index, no more records can be written after this
+	void close(void);
+
+	bool isOpen(void) const
+	{ return _file.is_open(); }
+
+	std::string const &getFile(void) const
+	{ return _filename; }
+
+	/// @brief time since the recording was started
+	vl::time getTime(void) const
+	{ return _timer.elapsed(); }
+
+	uint64_t getNRecords(void) const
+	{ return _n_records; }
+
+	uint64_t getBytesWritten(void) const
+	{ return _bytes_written; }
+
+private :
+	/// Non copyable
+	RecordingWriter(RecordingWriter const &);
+	RecordingWriter &operator=(RecordingWriter const &);
+
+	void _begin_record(RECORD_TYPE type, vl::time const &t);
+	void _end_record(void);
+
+	std::string _filename;
+	std::ofstream _file;
+
+	uint32_t _chunk_size;
+
+	RecordBuffer _chunk;
+	RecordingChunkInfo _chunk_info;
+	size_t _record_start;
+
+	std::vector<RecordingChunkInfo> _index;
+
+	vl::chrono _timer;
+
+	uint64_t _n_records;
+	uint64_t _bytes_written;
+
+};	// class RecordingWriter
+
+/// @class RecordingReader
+/// @brief Streaming reader for binary recordings
+/// Only one chunk is kept in memory at any time.
+class RecordingReader
+{
+public :
+	/// @throw vl::missing_file if the file can not be opened
+	/// @throw vl::parsing_error if the file is not a valid recording
+	RecordingReader(std::string const &file);
+
+	~RecordingReader(void);
+
+	/// @brief read the next record
+	/// @return true if a record was read, false if the end of recording was reached
+	bool next(Record &rec);
+
+	/// @brief move the read head to the first record with time equal or greater than t
+	void seek(vl::time const &t);
+
+	/// @brief move the read head to the start of the recording
+	void rewind(void)
+	{ seek(vl::time()); }
+
+	/// @brief timestamp of the last record in the file
+	vl::time getLength(void) const;
+
+	uint64_t getNRecords(void) const;
+
+	size_t getNChunks(void) const
+	{ return _index.size(); }
+
+	std::vector<RecordingChunkInfo> const &getIndex(void) const
+	{ return _index; }
+
+	std::string const &getFile(void) const
+	{ return _filename; }
+
+	/// @brief was the index read from the file or rebuild by scanning
+	bool isIndexRecovered(void) const
+	{ return _recovered; }
+
+private :
+	/// Non copyable
+	RecordingReader(RecordingReader const &);
+	RecordingReader &operator=(RecordingReader const &);
+
+	void _read_header(void);
+
+	/// @return true if a valid index was found from the footer
+	bool _read_index(void);
+
+	/// @brief build the index by scanning the chunk headers
+	void _scan_index(void);
+
+	/// @brief load a chunk into memory
+	void _load_chunk(size_t index);
+
+	bool _read_record(Record &rec);
+
+	std::string _filename;
+	std::ifstream _file;
+
+	std::vector<RecordingChunkInfo> _index;
+	bool _recovered;
+
+	/// Current chunk index, equal to _index.size() when at the end
+	size_t _current_chunk;
+	RecordBuffer _chunk;
+
+};	// class RecordingReader
+
+}	// namespace vl
+
+#endif	// HYDRA_INPUT_RECORDING_HPP
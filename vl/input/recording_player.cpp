@@ -0,0 +1,152 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file input/recording_player.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+// Interface
+#include "recording_player.hpp"
+
+#include "event_manager.hpp"
+
+#include "tracker.hpp"
+// Necessary for CANMsg
+#include "pcan.hpp"
+
+#include "base/exceptions.hpp"
+#include "logger.hpp"
+
+vl::RecordingPlayer::RecordingPlayer(EventManagerPtr event_manager)
+	: _event_manager(event_manager)
+	, _has_next(false)
+	, _playing(false)
+	, _looping(false)
+	, _n_injected(0)
+{
+	if(!_event_manager)
+	{ BOOST_THROW_EXCEPTION(vl::null_pointer()); }
+}
+
+vl::RecordingPlayer::~RecordingPlayer(void)
+{}
+
+void
+vl::RecordingPlayer::open(std::string const &file)
+{
+	std::cout << vl::TRACE << "Opening recording " << file << " for playback." << std::endl;
+
+	close();
+
+	_reader.reset(new RecordingReader(file));
+	_has_next = _reader->next(_next);
+
+	std::cout << "Recording has " << _reader->getNRecords() << " records in "
+		<< _reader->getNChunks() << " chunks, length " << _reader->getLength()
+		<< std::endl;
+}
+
+void
+vl::RecordingPlayer::close(void)
+{
+	_reader.reset();
+	_has_next = false;
+	_playing = false;
+	_time = vl::time();
+	_n_injected = 0;
+}
+
+void
+vl::RecordingPlayer::stop(void)
+{
+	_playing = false;
+	seek(vl::time());
+}
+
+void
+vl::RecordingPlayer::seek(vl::time const &t)
+{
+	_time = t;
+	if(_reader)
+	{
+		_reader->seek(t);
+		_has_next = _reader->next(_next);
+	}
+}
+
+vl::time
+vl::RecordingPlayer::getLength(void) const
+{
+	if(_reader)
+	{ return _reader->getLength(); }
+
+	return vl::time();
+}
+
+void
+vl::RecordingPlayer::mainloop(vl::time const &elapsed_time)
+{
+	if(!_reader || !_playing)
+	{ return; }
+
+	if(_fixed_step != vl::time())
+	{ _time += _fixed_step; }
+	else
+	{ _time += elapsed_time; }
+
+	while(_has_next && _next.time <= _time)
+	{
+		_inject(_next);
+		_has_next = _reader->next(_next);
+	}
+
+	if(!_has_next)
+	{
+		if(_looping)
+		{ seek(vl::time()); }
+		else
+		{ _playing = false; }
+	}
+}
+
+void
+vl::RecordingPlayer::_inject(vl::Record const &rec)
+{
+	switch(rec.type)
+	{
+	case RT_TRACKER :
+	{
+		vl::ClientsRefPtr clients = _event_manager->getTrackerClients();
+		// Silently ignore trackers that are not configured
+		// so recordings can be played with reduced tracking configurations.
+		if(rec.tracker < clients->getNTrackers())
+		{
+			TrackerRefPtr tracker = clients->getTrackerPtr(rec.tracker);
+			if(rec.sensor < tracker->getNSensors())
+			{ tracker->getSensor(rec.sensor).update(rec.transform); }
+		}
+	}
+	break;
+
+	case RT_JOYSTICK :
+		_event_manager->_injectJoystickEvent(rec.joystick_event, rec.joystick);
+		break;
+
+	case RT_CAN :
+		_event_manager->_injectCANMessage(CANMsg(rec.can_id, rec.can_data, rec.can_length));
+		break;
+
+	default :
+		// Unknown records are skipped
+		return;
+	}
+
+	++_n_injected;
+}
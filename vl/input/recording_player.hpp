@@ -0,0 +1,127 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file input/recording_player.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Replay driver for binary input recordings.
+ *
+ *	Injects recorded events into the EventManager at their original
+ *	timestamps. Playback time is advanced from the EventManager mainloop
+ *	either with the frame time or with a fixed step per frame.
+ *	Fixed step makes the replay deterministic, the same events are injected
+ *	on the same frame regardless of the real frame rate, which is what we
+ *	want for regression and performance runs.
+ */
+
+#ifndef HYDRA_INPUT_RECORDING_PLAYER_HPP
+#define HYDRA_INPUT_RECORDING_PLAYER_HPP
+
+#include "recording.hpp"
+
+#include "typedefs.hpp"
+
+#include <boost/scoped_ptr.hpp>
+
+namespace vl
+{
+
+class RecordingPlayer
+{
+public :
+	RecordingPlayer(EventManagerPtr event_manager);
+
+	~RecordingPlayer(void);
+
+	/// @brief open a recording for playback, closes the previous one
+	/// @param file full path to the recording
+	/// Does not start the playback
+	void open(std::string const &file);
+
+	void close(void);
+
+	bool isOpen(void) const
+	{ return _reader.get() != 0; }
+
+	void play(void)
+	{ _playing = true; }
+
+	void pause(void)
+	{ _playing = false; }
+
+	/// @brief pause and rewind to start
+	void stop(void);
+
+	bool isPlaying(void) const
+	{ return _playing; }
+
+	/// @brief move the playback to a time
+	/// Events between the current time and t are not injected.
+	void seek(vl::time const &t);
+
+	/// @brief current playback time
+	vl::time const &getTime(void) const
+	{ return _time; }
+
+	/// @brief length of the opened recording
+	vl::time getLength(void) const;
+
+	void setLooping(bool loop)
+	{ _looping = loop; }
+
+	bool isLooping(void) const
+	{ return _looping; }
+
+	/// @brief use fixed step instead of frame time
+	/// @param step time to advance per frame, zero disables fixed stepping
+	void setFixedStep(vl::time const &step)
+	{ _fixed_step = step; }
+
+	vl::time const &getFixedStep(void) const
+	{ return _fixed_step; }
+
+	/// @brief number of events injected since open
+	uint64_t getNInjected(void) const
+	{ return _n_injected; }
+
+	/// @brief advance playback and inject all events that are due
+	/// called from EventManager::mainloop
+	void mainloop(vl::time const &elapsed_time);
+
+private :
+	/// Non copyable
+	RecordingPlayer(RecordingPlayer const &);
+	RecordingPlayer &operator=(RecordingPlayer const &);
+
+	void _inject(Record const &rec);
+
+	EventManagerPtr _event_manager;
+
+	boost::scoped_ptr<RecordingReader> _reader;
+
+	/// Next record to be injected, valid if _has_next is true
+	Record _next;
+	bool _has_next;
+
+	vl::time _time;
+	vl::time _fixed_step;
+
+	bool _playing;
+	bool _looping;
+
+	uint64_t _n_injected;
+
+};	// class RecordingPlayer
+
+}	// namespace vl
+
+#endif	// HYDRA_INPUT_RECORDING_PLAYER_HPP
@@ -26,6 +26,11 @@
 
 #include "tracker.hpp"
 
+// Necessary for recording sensor updates
+#include "recording.hpp"
+// Necessary for attaching new trackers to an active recording
+#include "event_manager.hpp"
+
 /// ------------------------------ Global ------------------------------------
 std::ostream &
 vl::operator<<(std::ostream &os, vl::TrackerSensor const &s)
@@ -145,6 +150,8 @@ vl::Tracker::Tracker(std::string const &trackerName)
 	, _sign(Ogre::Vector3::UNIT_SCALE)
 	, _neutral_position(Ogre::Vector3::ZERO)
 	, _neutral_quaternion(Ogre::Quaternion::IDENTITY)
+	, _recorder(0)
+	, _recorder_id(0)
 {}
 
 void
@@ -166,3 +173,21 @@ vl::Tracker::setNSensors(size_t size)
 {
 	_sensors.resize(size);
 }
+
+void
+vl::Tracker::_record(size_t sensor, vl::Transform const &t)
+{
+	if(_recorder)
+	{ _recorder->writeTracker(_recorder_id, (uint16_t)sensor, t); }
+}
+
+/// ------------------------------ Clients -----------------------------------
+void
+vl::Clients::addTracker(TrackerRefPtr tracker)
+{
+	_trackers.push_back(tracker);
+
+	// Recordings refer to trackers by index so the new one is simply appended
+	if(_event_manager && _event_manager->isRecording())
+	{ tracker->setRecorder(_event_manager->getRecorder().get(), (uint16_t)(_trackers.size()-1)); }
+}
@@ -152,11 +152,23 @@ public :
 
 	void setNeutralOrientation(Ogre::Quaternion const &q)
 	{ _neutral_quaternion = q; }
+
+	/// @brief set the recording where all the sensor updates are written
+	/// @param rec recording, NULL to stop recording
+	/// @param id identifier for this tracker in the recording
+	void setRecorder(RecordingWriter *rec, uint16_t id)
+	{
+		_recorder = rec;
+		_recorder_id = id;
+	}
 	
 protected :
 	/// Protected constructor so that user needs to call create
 	Tracker(std::string const &trackerName);
 
+	/// @brief write a sensor update to the recording if one is set
+	void _record(size_t sensor, vl::Transform const &t);
+
 	std::string _name;
 
 	std::vector<TrackerSensor> _sensors;
@@ -166,6 +178,9 @@ protected :
 	Ogre::Vector3 _sign;
 	Ogre::Vector3 _neutral_position;
 	Ogre::Quaternion _neutral_quaternion;
+
+	RecordingWriter *_recorder;
+	uint16_t _recorder_id;
 };	// class Tracker
 
 
@@ -176,8 +191,9 @@ public :
 		: _event_manager(event_manager )
 	{}
 
-	void addTracker( TrackerRefPtr tracker )
-	{ _trackers.push_back( tracker ); }
+	/// @brief add a tracker
+	/// If the EventManager is recording the tracker is recorded also.
+	void addTracker( TrackerRefPtr tracker );
 
 	Tracker const &getTracker(size_t index) const
 	{ return *_trackers.at(index); }
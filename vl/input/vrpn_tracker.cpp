@@ -126,6 +126,7 @@ vl::vrpnTracker::update( vrpn_TRACKERCB const t )
 		
 		if(trans.isValid())
 		{
+			_record(t.sensor, trans);
 			sensor.update( trans );
 		}
 	}
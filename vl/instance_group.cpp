@@ -0,0 +1,393 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file instance_group.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+// Interface
+#include "instance_group.hpp"
+
+#include "entity.hpp"
+#include "scene_node.hpp"
+#include "scene_manager.hpp"
+
+#include "cluster/message.hpp"
+
+#include <OGRE/OgreSceneManager.h>
+#include <OGRE/OgreInstanceManager.h>
+#include <OGRE/OgreInstancedEntity.h>
+#include <OGRE/OgreInstanceBatch.h>
+#include <OGRE/OgreEntity.h>
+#include <OGRE/OgreMeshManager.h>
+#include <OGRE/OgreSubMesh.h>
+#include <OGRE/OgreMaterialManager.h>
+#include <OGRE/OgreTechnique.h>
+#include <OGRE/OgreTextureUnitState.h>
+
+#include <algorithm>
+
+namespace
+{
+
+/// Same as for instanced Entities
+uint32_t const INSTANCES_PER_BATCH = 80;
+
+/// Has the HWBasic instancing shaders
+char const *INSTANCED_BASE_MATERIAL = "Instancing/HWBasic/generated";
+
+/// @brief create an instanced variant of a material
+/// Uses the colours and the first texture of the first pass.
+/// @return false if either of the materials doesn't exist
+bool
+create_instanced_material(std::string const &material, std::string const &instanced)
+{
+	Ogre::MaterialManager &man = Ogre::MaterialManager::getSingleton();
+	Ogre::ResourcePtr base_res = man.getByName(INSTANCED_BASE_MATERIAL);
+	Ogre::ResourcePtr mat_res = man.getByName(material);
+	if(base_res.isNull() || mat_res.isNull())
+	{ return false; }
+
+	Ogre::Material *mat = static_cast<Ogre::Material *>(mat_res.get());
+	mat->load();
+	if(mat->getNumTechniques() == 0 || mat->getTechnique(0)->getNumPasses() == 0)
+	{ return false; }
+	Ogre::Pass *pass = mat->getTechnique(0)->getPass(0);
+
+	Ogre::MaterialPtr instanced_mat = static_cast<Ogre::Material *>(base_res.get())->clone(instanced);
+	instanced_mat->setAmbient(pass->getAmbient());
+	instanced_mat->setDiffuse(pass->getDiffuse());
+	instanced_mat->setSpecular(pass->getSpecular());
+	instanced_mat->setShininess(pass->getShininess());
+
+	for(unsigned short i = 0; i < pass->getNumTextureUnitStates(); ++i)
+	{
+		Ogre::TextureUnitState *tu = pass->getTextureUnitState(i);
+		if(tu->getContentType() == Ogre::TextureUnitState::CONTENT_NAMED
+			&& !tu->getTextureName().empty())
+		{
+			Ogre::AliasTextureNamePairList alias_list;
+			alias_list["DiffuseMap"] = tu->getTextureName();
+			instanced_mat->applyTextureAliases(alias_list);
+			break;
+		}
+	}
+
+	instanced_mat->load();
+	return true;
+}
+
+Ogre::Vector3
+get_world_scale(vl::SceneNodePtr node)
+{
+	Ogre::Vector3 scale = node->getScale();
+	while(node->getInheritScale() && node->getParent())
+	{
+		node = node->getParent();
+		scale *= node->getScale();
+	}
+
+	return scale;
+}
+
+}	// unamed namespace
+
+/// ----------------------------- Public -------------------------------------
+vl::InstanceGroup::InstanceGroup(std::string const &name, std::string const &mesh_name,
+		std::string const &material_name, vl::SceneManagerPtr creator, bool dynamic)
+	: MovableObject(name, creator, dynamic)
+{
+	_clear();
+	_mesh_name = mesh_name;
+	_material_name = material_name;
+}
+
+vl::InstanceGroup::InstanceGroup(vl::SceneManagerPtr creator)
+	: MovableObject(creator)
+{ _clear(); }
+
+vl::InstanceGroup::~InstanceGroup(void)
+{
+	// Members are drawn separately again
+	for(size_t i = 0; i < _entities.size(); ++i)
+	{ _entities.at(i)->_setInstanceGroup(0); }
+
+	_destroyInstances();
+}
+
+void
+vl::InstanceGroup::setEntities(vl::EntityList const &entities)
+{
+	for(size_t i = 0; i < _entities.size(); ++i)
+	{
+		if(std::find(entities.begin(), entities.end(), _entities.at(i)) == entities.end())
+		{ _entities.at(i)->_setInstanceGroup(0); }
+	}
+
+	_entities = entities;
+	for(size_t i = 0; i < _entities.size(); ++i)
+	{ _entities.at(i)->_setInstanceGroup(this); }
+
+	_update();
+}
+
+void
+vl::InstanceGroup::_removeEntity(vl::EntityPtr ent)
+{
+	vl::EntityList::iterator iter = std::find(_entities.begin(), _entities.end(), ent);
+	if(iter != _entities.end())
+	{
+		ent->_setInstanceGroup(0);
+		_entities.erase(iter);
+	}
+}
+
+void
+vl::InstanceGroup::_update(void)
+{
+	std::vector<vl::Transform> transforms;
+	std::vector<Ogre::Vector3> scales;
+	transforms.reserve(_entities.size());
+	scales.reserve(_entities.size());
+
+	for(size_t i = 0; i < _entities.size(); ++i)
+	{
+		vl::EntityPtr ent = _entities[i];
+		vl::SceneNodePtr node = ent->getParent();
+		if(!node || !ent->getVisible())
+		{ continue; }
+
+		transforms.push_back(node->getWorldTransform()
+			*vl::Transform(ent->getPosition(), ent->getOrientation()));
+		scales.push_back(get_world_scale(node));
+	}
+
+	// Static groups are not sent
+	update_variable(_transforms, transforms, DIRTY_TRANSFORMS);
+	update_variable(_scales, scales, DIRTY_SCALES);
+}
+
+/// ----------------------------- Private ------------------------------------
+bool
+vl::InstanceGroup::_doCreateNative(void)
+{
+	assert(_creator);
+	assert(_creator->getNative());
+
+	if(_instance_manager || _use_entities)
+	{ return true; }
+
+	Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().load(_mesh_name,
+		Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+
+	// Hardware instancing needs a material with the instancing vertex shader
+	// and independent geometry
+	std::string base_material = _material_name;
+	if(base_material.empty() && mesh->getNumSubMeshes() > 0)
+	{ base_material = mesh->getSubMesh(0)->getMaterialName(); }
+	std::string material = base_material + "/instanced";
+
+	// Imported materials don't have the variant, generated for every material
+	// only once as the groups share them
+	bool has_material = Ogre::MaterialManager::getSingleton().resourceExists(material);
+	if(mesh->getNumSubMeshes() == 1 && !has_material)
+	{ has_material = create_instanced_material(base_material, material); }
+
+	if(mesh->getNumSubMeshes() == 1 && has_material)
+	{
+		_instance_manager = _creator->getNative()->createInstanceManager("instance_group/" + _name,
+			_mesh_name, Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME,
+			Ogre::InstanceManager::HWInstancingBasic, INSTANCES_PER_BATCH);
+		_material_name = material;
+	}
+	else
+	{
+		std::clog << "InstanceGroup : " << _name << " : can't instance "
+			<< _mesh_name << " with " << base_material << " using separate entities." << std::endl;
+		_use_entities = true;
+	}
+
+	_updateInstances();
+
+	return true;
+}
+
+void
+vl::InstanceGroup::doSerialize(vl::cluster::ByteStream &msg, const uint64_t dirtyBits) const
+{
+	if(dirtyBits & DIRTY_PARAMS)
+	{
+		msg << _mesh_name << _material_name;
+	}
+
+	// Written as single blocks, the transforms are sent every frame
+	// any of the members moves
+	if(dirtyBits & DIRTY_TRANSFORMS)
+	{
+		uint32_t size = _transforms.size();
+		msg << size;
+		if(size > 0)
+		{ msg.write((char const *)&_transforms[0], (vl::msg_size)(sizeof(vl::Transform)*size)); }
+	}
+
+	if(dirtyBits & DIRTY_SCALES)
+	{
+		uint32_t size = _scales.size();
+		msg << size;
+		if(size > 0)
+		{ msg.write((char const *)&_scales[0], (vl::msg_size)(sizeof(Ogre::Vector3)*size)); }
+	}
+}
+
+void
+vl::InstanceGroup::doDeserialize(vl::cluster::ByteStream &msg, const uint64_t dirtyBits)
+{
+	if(dirtyBits & DIRTY_PARAMS)
+	{
+		msg >> _mesh_name >> _material_name;
+		// Mesh doesn't change for a group
+		assert(!_instance_manager && !_use_entities);
+	}
+
+	bool dirty = false;
+	if(dirtyBits & DIRTY_TRANSFORMS)
+	{
+		uint32_t size;
+		msg >> size;
+		_transforms.resize(size);
+		if(size > 0)
+		{ msg.read((char *)&_transforms[0], (vl::msg_size)(sizeof(vl::Transform)*size)); }
+		dirty = true;
+	}
+
+	if(dirtyBits & DIRTY_SCALES)
+	{
+		uint32_t size;
+		msg >> size;
+		_scales.resize(size);
+		if(size > 0)
+		{ msg.read((char *)&_scales[0], (vl::msg_size)(sizeof(Ogre::Vector3)*size)); }
+		dirty = true;
+	}
+
+	if(dirtyBits & DIRTY_VISIBLE)
+	{ dirty = true; }
+
+	if(dirty)
+	{ _updateInstances(); }
+}
+
+void
+vl::InstanceGroup::_clear(void)
+{
+	_instance_manager = 0;
+	_use_entities = false;
+}
+
+void
+vl::InstanceGroup::_updateInstances(void)
+{
+	if(!_instance_manager && !_use_entities)
+	{ return; }
+
+	Ogre::SceneManager *og_sm = _creator->getNative();
+	size_t n = _transforms.size();
+
+	if(_instance_manager)
+	{
+		bool created = _instances.size() < n;
+		while(_instances.size() < n)
+		{ _instances.push_back(_instance_manager->createInstancedEntity(_material_name)); }
+		while(_instances.size() > n)
+		{
+			og_sm->destroyInstancedEntity(_instances.back());
+			_instances.pop_back();
+		}
+
+		for(size_t i = 0; i < n; ++i)
+		{
+			Ogre::InstancedEntity *inst = _instances[i];
+			inst->setPosition(_transforms[i].position);
+			inst->setOrientation(_transforms[i].quaternion);
+			if(i < _scales.size())
+			{ inst->setScale(_scales[i]); }
+			inst->setVisible(_visible);
+		}
+
+		// Same as MovableObject, only the lights are in the second pass
+		if(created)
+		{
+			Ogre::InstanceManager::InstanceBatchMapIterator iter
+				= _instance_manager->getInstanceBatchMapIterator();
+			while(iter.hasMoreElements())
+			{
+				Ogre::InstanceManager::InstanceBatchIterator batches
+					= _instance_manager->getInstanceBatchIterator(iter.peekNextKey());
+				while(batches.hasMoreElements())
+				{ batches.getNext()->setVisibilityFlags(1); }
+				iter.moveNext();
+			}
+		}
+	}
+	else
+	{
+		while(_ogre_entities.size() < n)
+		{
+			Ogre::Entity *ent = og_sm->createEntity(_mesh_name);
+			if(!_material_name.empty())
+			{ ent->setMaterialName(_material_name); }
+			ent->setVisibilityFlags(1);
+			Ogre::SceneNode *node = og_sm->getRootSceneNode()->createChildSceneNode();
+			node->attachObject(ent);
+			_ogre_entities.push_back(ent);
+			_ogre_nodes.push_back(node);
+		}
+		while(_ogre_entities.size() > n)
+		{
+			og_sm->destroyEntity(_ogre_entities.back());
+			og_sm->destroySceneNode(_ogre_nodes.back());
+			_ogre_entities.pop_back();
+			_ogre_nodes.pop_back();
+		}
+
+		for(size_t i = 0; i < n; ++i)
+		{
+			Ogre::SceneNode *node = _ogre_nodes[i];
+			node->setPosition(_transforms[i].position);
+			node->setOrientation(_transforms[i].quaternion);
+			if(i < _scales.size())
+			{ node->setScale(_scales[i]); }
+			_ogre_entities[i]->setVisible(_visible);
+		}
+	}
+}
+
+void
+vl::InstanceGroup::_destroyInstances(void)
+{
+	if(!_creator || !_creator->getNative())
+	{ return; }
+
+	Ogre::SceneManager *og_sm = _creator->getNative();
+
+	// Destroys all the instances also
+	if(_instance_manager)
+	{ og_sm->destroyInstanceManager(_instance_manager); }
+	_instance_manager = 0;
+	_instances.clear();
+
+	for(size_t i = 0; i < _ogre_entities.size(); ++i)
+	{
+		og_sm->destroyEntity(_ogre_entities[i]);
+		og_sm->destroySceneNode(_ogre_nodes[i]);
+	}
+	_ogre_entities.clear();
+	_ogre_nodes.clear();
+}
@@ -0,0 +1,151 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file instance_group.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Entities that share a mesh and a material drawn as hardware instances.
+ *
+ *	Groups are created by the SceneManager when auto instancing is enabled,
+ *	they are not meant to be created from user code. The member Entities
+ *	stay in the scene graph on the master so they can be moved, hidden and
+ *	picked as before, but renderers don't create them. Instead the group
+ *	collects the world transformations of the visible members every frame
+ *	and distributes them as a single block.
+ *
+ *	Renderers use the material with "/instanced" postfix if one exists,
+ *	if not it's generated from Instancing/HWBasic/generated with the
+ *	colours and the first texture of the material. Only meshes with one
+ *	sub mesh can be instanced, otherwise a normal Ogre Entity is created
+ *	for every instance, which still has the compact distribution but no
+ *	reduction in batches.
+ */
+
+#ifndef HYDRA_INSTANCE_GROUP_HPP
+#define HYDRA_INSTANCE_GROUP_HPP
+
+/// Base class
+#include "movable_object.hpp"
+
+#include "math/types.hpp"
+#include "math/transform.hpp"
+
+#include <vector>
+
+namespace Ogre
+{
+	class InstanceManager;
+	class InstancedEntity;
+	class Entity;
+	class SceneNode;
+}
+
+namespace vl
+{
+
+class HYDRA_API InstanceGroup : public vl::MovableObject
+{
+public :
+	/// @brief Master constructor
+	/// Should not be called from user code, use SceneManager to create these
+	InstanceGroup(std::string const &name, std::string const &mesh_name,
+		std::string const &material_name, vl::SceneManagerPtr creator, bool dynamic);
+
+	/// @brief Slave constructor
+	InstanceGroup(vl::SceneManagerPtr creator);
+
+	virtual ~InstanceGroup(void);
+
+	std::string const &getMeshName(void) const
+	{ return _mesh_name; }
+
+	std::string const &getMaterialName(void) const
+	{ return _material_name; }
+
+	/// @brief replace the members of the group
+	/// Entities removed from the group are drawn separately again.
+	void setEntities(vl::EntityList const &entities);
+
+	vl::EntityList const &getEntities(void) const
+	{ return _entities; }
+
+	/// @internal called when a member is destroyed
+	void _removeEntity(vl::EntityPtr ent);
+
+	/// @brief number of instances drawn, hidden members are not drawn
+	size_t getNInstances(void) const
+	{ return _transforms.size(); }
+
+	/// @internal
+	/// @brief copy the world transformations of the members
+	/// Only distributed if any of them has changed.
+	void _update(void);
+
+	/// Virtual overrides
+	/// Instances are not attached to a SceneNode so there is no native
+	virtual Ogre::MovableObject *getNative(void) const
+	{ return 0; }
+
+	virtual std::string getTypeName(void) const
+	{ return "InstanceGroup"; }
+
+	/// Groups are managed by the SceneManager so they can't be cloned
+	virtual MovableObjectPtr clone(std::string const &append_to_name) const
+	{ return 0; }
+
+	enum DirtyBits
+	{
+		DIRTY_PARAMS = vl::MovableObject::DIRTY_CUSTOM << 0,
+		DIRTY_TRANSFORMS = vl::MovableObject::DIRTY_CUSTOM << 1,
+		DIRTY_SCALES = vl::MovableObject::DIRTY_CUSTOM << 2,
+		DIRTY_CUSTOM = vl::MovableObject::DIRTY_CUSTOM << 3,
+	};
+
+private :
+	virtual bool _doCreateNative(void);
+
+	virtual void doSerialize(vl::cluster::ByteStream &msg, const uint64_t dirtyBits) const;
+
+	virtual void doDeserialize(vl::cluster::ByteStream &msg, const uint64_t dirtyBits);
+
+	void _clear(void);
+
+	/// @brief create or destroy instances to match the number of transforms
+	void _updateInstances(void);
+
+	void _destroyInstances(void);
+
+	std::string _mesh_name;
+	std::string _material_name;
+
+	/// Master only
+	vl::EntityList _entities;
+
+	/// World transformations of the instances
+	std::vector<vl::Transform> _transforms;
+	/// Scales are separate because they rarely change
+	std::vector<Ogre::Vector3> _scales;
+
+	/// Renderer only
+	Ogre::InstanceManager *_instance_manager;
+	std::vector<Ogre::InstancedEntity *> _instances;
+
+	/// Fallback when the mesh can not be instanced
+	bool _use_entities;
+	std::vector<Ogre::Entity *> _ogre_entities;
+	std::vector<Ogre::SceneNode *> _ogre_nodes;
+
+};	// class InstanceGroup
+
+}	// namespace vl
+
+#endif	// HYDRA_INSTANCE_GROUP_HPP
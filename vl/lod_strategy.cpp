@@ -0,0 +1,176 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file lod_strategy.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/// Interface
+#include "lod_strategy.hpp"
+
+#include <OGRE/OgreLodStrategyManager.h>
+#include <OGRE/OgreEntity.h>
+#include <OGRE/OgreCamera.h>
+#include <OGRE/OgreViewport.h>
+#include <OGRE/OgreNode.h>
+#include <OGRE/OgreUserObjectBindings.h>
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace
+{
+
+struct LodUsageGreater
+{
+	bool operator()(Ogre::MeshLodUsage const &a, Ogre::MeshLodUsage const &b) const
+	{ return a.value > b.value; }
+};
+
+}	// unamed namespace
+
+std::string const vl::ScreenSizeLodStrategy::NAME = "ScreenSize";
+
+vl::ScreenSizeLodStrategy::ScreenSizeLodStrategy(void)
+	: Ogre::LodStrategy(NAME)
+	, _hysteresis(0.1)
+{}
+
+vl::ScreenSizeLodStrategy *
+vl::ScreenSizeLodStrategy::getSingletonPtr(void)
+{
+	// Manager owns the strategies
+	Ogre::LodStrategyManager &manager = Ogre::LodStrategyManager::getSingleton();
+	Ogre::LodStrategy *strategy = manager.getStrategy(NAME);
+	if(!strategy)
+	{
+		strategy = new ScreenSizeLodStrategy;
+		manager.addStrategy(strategy);
+	}
+
+	return static_cast<ScreenSizeLodStrategy *>(strategy);
+}
+
+Ogre::Real
+vl::ScreenSizeLodStrategy::getBaseValue(void) const
+{ return std::numeric_limits<Ogre::Real>::max(); }
+
+Ogre::Real
+vl::ScreenSizeLodStrategy::transformBias(Ogre::Real factor) const
+{
+	assert(factor > 0);
+	return factor;
+}
+
+Ogre::ushort
+vl::ScreenSizeLodStrategy::getIndex(Ogre::Real value, Ogre::Mesh::MeshLodUsageList const &meshLodUsageList) const
+{ return getIndexDescending(value, meshLodUsageList); }
+
+Ogre::ushort
+vl::ScreenSizeLodStrategy::getIndex(Ogre::Real value, Ogre::Material::LodValueList const &materialLodValueList) const
+{ return getIndexDescending(value, materialLodValueList); }
+
+void
+vl::ScreenSizeLodStrategy::sort(Ogre::Mesh::MeshLodUsageList &meshLodUsageList) const
+{ std::sort(meshLodUsageList.begin(), meshLodUsageList.end(), LodUsageGreater()); }
+
+bool
+vl::ScreenSizeLodStrategy::isSorted(Ogre::Mesh::LodValueList const &values) const
+{
+	for(size_t i = 1; i < values.size(); ++i)
+	{
+		if(values[i] > values[i-1])
+		{ return false; }
+	}
+	return true;
+}
+
+Ogre::Real
+vl::ScreenSizeLodStrategy::getValueImpl(Ogre::MovableObject const *movableObject, Ogre::Camera const *camera) const
+{
+	Ogre::Real value = _screen_size(movableObject, camera);
+
+	Ogre::Entity const *entity = dynamic_cast<Ogre::Entity const *>(movableObject);
+	if(!entity || entity->getMesh().isNull() || entity->getMesh()->getNumLodLevels() < 2)
+	{ return value; }
+
+	Ogre::MeshPtr const &mesh = entity->getMesh();
+	Ogre::ushort level = mesh->getLodIndex(value);
+
+	// Ogre's interface is const, the levels are state of the object
+	Ogre::UserObjectBindings &bindings = const_cast<Ogre::MovableObject *>(movableObject)->getUserObjectBindings();
+	if(bindings.getUserAny(NAME).isEmpty())
+	{ bindings.setUserAny(NAME, Ogre::Any(ViewportLevels())); }
+	ViewportLevels *levels = Ogre::any_cast<ViewportLevels>(const_cast<Ogre::Any *>(&bindings.getUserAny(NAME)));
+
+	// Only switch when the size has changed enough past the threshold,
+	// levels are in descending order of screen size.
+	ViewportLevels::iterator iter = levels->find(camera->getViewport());
+	if(iter != levels->end())
+	{
+		Ogre::ushort prev = iter->second;
+		Ogre::ushort lower_detail = mesh->getLodIndex(value*(1+_hysteresis));
+		Ogre::ushort higher_detail = mesh->getLodIndex(value*(1-_hysteresis));
+		if(lower_detail > prev)
+		{ level = lower_detail; }
+		else if(higher_detail < prev)
+		{ level = higher_detail; }
+		else
+		{ level = prev; }
+
+		iter->second = level;
+	}
+	else
+	{ (*levels)[camera->getViewport()] = level; }
+
+	if(level == mesh->getLodIndex(value))
+	{ return value; }
+
+	// Return a value that selects the level, level i is used for values
+	// in (value[i+1], value[i]]
+	Ogre::ushort last = mesh->getNumLodLevels()-1;
+	if(level == last)
+	{ return mesh->getLodLevel(level).value; }
+	else if(level == 0)
+	{ return mesh->getLodLevel(1).value*2; }
+	else
+	{ return (mesh->getLodLevel(level).value + mesh->getLodLevel(level+1).value)/2; }
+}
+
+Ogre::Real
+vl::ScreenSizeLodStrategy::_screen_size(Ogre::MovableObject const *movableObject, Ogre::Camera const *camera) const
+{
+	Ogre::Viewport *viewport = camera->getViewport();
+	Ogre::Node *node = movableObject->getParentNode();
+	if(!viewport || !node)
+	{ return getBaseValue(); }
+
+	// Bounding radius is in object space
+	Ogre::Vector3 const &scale = node->_getDerivedScale();
+	Ogre::Real radius = movableObject->getBoundingRadius()
+		*std::max(std::abs(scale.x), std::max(std::abs(scale.y), std::abs(scale.z)));
+	Ogre::Real area = Ogre::Math::PI*radius*radius;
+
+	// Normalized device coordinates cover an area of four
+	if(camera->getProjectionType() == Ogre::PT_ORTHOGRAPHIC)
+	{
+		Ogre::Real view_area = camera->getOrthoWindowWidth()*camera->getOrthoWindowHeight();
+		return (view_area > 0 ? area/view_area : getBaseValue());
+	}
+
+	Ogre::Real distance_sq = node->getSquaredViewDepth(camera);
+	if(distance_sq <= std::numeric_limits<Ogre::Real>::epsilon())
+	{ return getBaseValue(); }
+
+	// Off-axis projections used by the walls are handled by the matrix
+	Ogre::Matrix4 const &proj = camera->getProjectionMatrix();
+	return area*proj[0][0]*proj[1][1]/(4*distance_sq);
+}
@@ -0,0 +1,88 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file lod_strategy.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Mesh LOD selection based on projected screen size.
+ *
+ *	Ogre selects the LOD level of an Entity for every camera it's rendered
+ *	with, so every Channel gets it's own level. LOD value is the fraction of
+ *	the viewport covered by the bounding sphere of the object, which works
+ *	the same with the off-axis projections used by the walls.
+ *
+ *	Hysteresis is applied per object and viewport so that objects close to
+ *	a threshold don't flicker between levels when the user moves. Selected
+ *	levels are stored in the user any of the object so they are released
+ *	with it.
+ */
+
+#ifndef HYDRA_LOD_STRATEGY_HPP
+#define HYDRA_LOD_STRATEGY_HPP
+
+#include <OGRE/OgreLodStrategy.h>
+#include <OGRE/OgreMesh.h>
+#include <OGRE/OgreMaterial.h>
+
+#include <map>
+
+namespace vl
+{
+
+class ScreenSizeLodStrategy : public Ogre::LodStrategy
+{
+public :
+	/// Name used in mesh files and vl::MeshLodSettings
+	static std::string const NAME;
+
+	ScreenSizeLodStrategy(void);
+
+	/// @brief get the strategy, registers it to Ogre::LodStrategyManager if necessary
+	static ScreenSizeLodStrategy *getSingletonPtr(void);
+
+	/// @brief relative change in screen size needed to switch levels
+	void setHysteresis(Ogre::Real hysteresis)
+	{ _hysteresis = hysteresis; }
+
+	Ogre::Real getHysteresis(void) const
+	{ return _hysteresis; }
+
+	/// -------------------- Ogre::LodStrategy ---------------------
+	virtual Ogre::Real getBaseValue(void) const;
+
+	virtual Ogre::Real transformBias(Ogre::Real factor) const;
+
+	virtual Ogre::ushort getIndex(Ogre::Real value, Ogre::Mesh::MeshLodUsageList const &meshLodUsageList) const;
+
+	virtual Ogre::ushort getIndex(Ogre::Real value, Ogre::Material::LodValueList const &materialLodValueList) const;
+
+	virtual void sort(Ogre::Mesh::MeshLodUsageList &meshLodUsageList) const;
+
+	virtual bool isSorted(Ogre::Mesh::LodValueList const &values) const;
+
+protected :
+	virtual Ogre::Real getValueImpl(Ogre::MovableObject const *movableObject, Ogre::Camera const *camera) const;
+
+private :
+	/// @brief fraction of the viewport covered by the bounding sphere
+	Ogre::Real _screen_size(Ogre::MovableObject const *movableObject, Ogre::Camera const *camera) const;
+
+	/// Level selected the last time for every viewport the object is rendered to
+	typedef std::map<Ogre::Viewport const *, Ogre::ushort> ViewportLevels;
+
+	Ogre::Real _hysteresis;
+
+};	// class ScreenSizeLodStrategy
+
+}	// namespace vl
+
+#endif	// HYDRA_LOD_STRATEGY_HPP
@@ -196,6 +196,8 @@ vl::Logger::logMessage(std::string const &type, std::string const &message, LOG_
 		|| message == "Error prior to using GLSL Program Object : invalid value")
 	{ return; }
 
+	boost::recursive_mutex::scoped_lock lock(_mutex);
+
 	// @todo this does not take into account different types and levels
 	if(!_current_msg.empty())
 	{
@@ -218,6 +220,8 @@ vl::Logger::logMessage(std::string const &type, std::string const &message, LOG_
 void
 vl::Logger::logMessage(vl::LogMessage const &message)
 {
+	boost::recursive_mutex::scoped_lock lock(_mutex);
+
 	_messages.push_back(message);
 
 	// Print all the logs into same file
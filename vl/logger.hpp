@@ -24,6 +24,7 @@
 #include <boost/iostreams/categories.hpp>	// sink_tag
 #include <boost/iostreams/concepts.hpp>		// sink
 #include <boost/iostreams/stream.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 
 #include <vector>
 
@@ -172,6 +173,9 @@ private :
 	std::vector< io::stream_buffer<sink> *> _streams;
 
 	LogMessage _current_msg;
+
+	/// Python tasks print from worker threads
+	boost::recursive_mutex _mutex;
 };	// namespace Logger
 
 }	// namespace vl
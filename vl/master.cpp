@@ -48,6 +48,8 @@
 // Necessary for EnvSettings
 #include "base/envsettings.hpp"
 
+#include "base/frame_arena.hpp"
+
 #include "pipe.hpp"
 
 #include "remote_launcher_helper.hpp"
@@ -252,44 +254,68 @@ vl::Master::render(void)
 
 	// We need to start drawing before we process the next frame
 	// Get new event messages that are processed in GameManager::step
-	_server->poll();
-	_handleMessages();
+	{
+		vl::AllocationScope alloc_scope(vl::AS_NETWORK);
+		_server->poll();
+		_handleMessages();
+	}
 
 	// Process a time step in the game
 	_game_manager->step();
 
 	/// Provide the updates to slaves
-	_updateFrameMsgs();
-	_updateServer();
-	_updateRenderer();
+	{
+		vl::AllocationScope alloc_scope(vl::AS_NETWORK);
+		_updateFrameMsgs();
+		_updateServer();
+	}
 
 	/// Render the scene
-	timer.reset();
-	_server->start_draw(_frame, getSimulationTime());
-	// Rendering after the server has sent the command to slaves
-	if(_renderer)
 	{
-		_renderer->draw();
-	}
+		vl::AllocationScope alloc_scope(vl::AS_RENDERING);
+		_updateRenderer();
 
-	// @todo For some reason finish_draw takes the same time as local rendering.
-	_server->finish_draw(_frame, getSimulationTime());
+		timer.reset();
+		// Python tasks run while we are rendering
+		PythonTaskQueue &tasks = _game_manager->getPythonTasks();
+		tasks.releaseInterpreter();
+		_server->start_draw(_frame, getSimulationTime());
+		// Rendering after the server has sent the command to slaves
+		if(_renderer)
+		{
+			_renderer->draw();
+		}
 
-	// Finish local renderer
-	if(_renderer)
-	{
-		_renderer->swap();
-		_renderer->capture();
+		// @todo For some reason finish_draw takes the same time as local rendering.
+		_server->finish_draw(_frame, getSimulationTime());
+
+		// Finish local renderer
+		if(_renderer)
+		{ _renderer->swap(); }
+		tasks.acquireInterpreter();
+
+		if(_renderer)
+		{ _renderer->capture(); }
+		report[PT_RENDERING].push(timer.elapsed());
 	}
-	report[PT_RENDERING].push(timer.elapsed());
+
+	// Threaded physics are stepped while rendering,
+	// events and scripts in the next frame need the results.
+	_game_manager->finishPhysicsStep();
 
 	report[PT_FRAME].push(loop_timer.elapsed());
 
+	_game_manager->getAllocationTracker().finishFrame();
+	// Temporaries of this frame are no longer used
+	vl::FrameArena::frame().reset();
+
 	// Update statistics every second
 	// @todo time limit should be configurable
 	if( _stats_timer.elapsed() > vl::time(1) )
 	{
 		report.finish();
+		_game_manager->getPythonProfiler().getReport().finish();
+		_game_manager->getAllocationTracker().getReport().finish();
 		_stats_timer.reset();
 	}
 }
@@ -316,23 +342,33 @@ vl::Master::createMsgInit(void) const
 {
 	vl::cluster::Message msg(vl::cluster::MSG_SG_INIT, _frame, getSimulationTime());
 
-	std::vector<vl::Distributed *>::const_iterator iter;
-	for( iter = _registered_objects.begin(); iter != _registered_objects.end();
-		++iter )
-	{
-		assert( (*iter)->getID() != vl::ID_UNDEFINED );
-		vl::cluster::ObjectData data( (*iter)->getID() );
-		vl::cluster::ByteDataStream stream = data.getStream();
-		(*iter)->pack( stream, vl::Distributed::DIRTY_ALL );
-		data.copyToMessage(&msg);
-		/// Don't clear dirty because this is a special case
-	}
+	/// Don't clear dirty because this is a special case
+	packAllObjects(msg);
 
 	return msg;
 }
 
+void
+vl::Master::createInitChunks(std::vector<vl::cluster::Message> &chunks) const
+{
+	// Packed separately first so the header can have the number of chunks
+	std::vector<vl::cluster::Message> bodies;
+	packAllObjects(bodies, vl::cluster::INIT_CHUNK_SIZE);
+
+	for(size_t i = 0; i < bodies.size(); ++i)
+	{
+		vl::cluster::Message msg(vl::cluster::MSG_SG_INIT, _frame, getSimulationTime());
+		msg.write(uint32_t(i));
+		msg.write(uint32_t(bodies.size()));
+		if(bodies.at(i).size() > 0)
+		{ msg.write(&bodies.at(i)[0], bodies.at(i).size()); }
+		chunks.push_back(msg);
+	}
+}
+
 vl::cluster::Message
-vl::Master::createResourceMessage(vl::cluster::RESOURCE_TYPE type, std::string const &name) const
+vl::Master::createResourceMessage(vl::cluster::RESOURCE_TYPE type,
+		std::string const &name, uint64_t cached_hash) const
 {
 	std::clog << "vl::Master::createResourceMessage" << std::endl;
 
@@ -346,9 +382,16 @@ vl::Master::createResourceMessage(vl::cluster::RESOURCE_TYPE type, std::string c
 		}
 
 		vl::MeshRefPtr mesh = getGameManager()->getMeshManager()->getMesh(name);
-		
+
+		// Slaves keep the meshes they have received, only send the data
+		// if their version is different
+		uint64_t hash = vl::calculate_mesh_hash(*mesh);
+		bool send_data = (hash != cached_hash);
+
 		vl::cluster::MessageDataStream stream = msg.getStream();
-		stream << vl::cluster::RES_MESH << name << *mesh;
+		stream << vl::cluster::RES_MESH << name << hash << send_data;
+		if(send_data)
+		{ stream << *mesh; }
 	}
 	else
 	{
@@ -549,12 +592,14 @@ vl::Master::messageRequested(vl::cluster::RequestedMessage const &req_msg)
 		break;
 	case vl::cluster::MSG_SG_INIT :
 		{
-			_server->sendMessage(createMsgInit());
+			std::vector<vl::cluster::Message> chunks;
+			createInitChunks(chunks);
+			_server->sendInit(chunks);
 		}
 		break;
 	case vl::cluster::MSG_RESOURCE :
 		{
-			_server->sendMessage(createResourceMessage(req_msg.res_type, req_msg.name));
+			_server->sendMessage(createResourceMessage(req_msg.res_type, req_msg.name, req_msg.hash));
 		}
 		break;
 	}
@@ -684,7 +729,9 @@ vl::Master::_updateRenderer(void)
 		_renderer->createSceneObjects(vl::cluster::Message(_msg_create));
 	}
 
-	_renderer->updateScene(vl::cluster::Message(_msg_update));
+	// Renderer consumes the message, the copy keeps its memory between frames
+	_msg_render = _msg_update;
+	_renderer->updateScene(_msg_render);
 
 	// Send logs
 	if( _renderer->logEnabled() )
@@ -731,24 +778,10 @@ vl::Master::_createMsgCreate(void)
 void
 vl::Master::_createMsgUpdate(void)
 {
-	// Create SceneGraph updates
-	_msg_update = vl::cluster::Message(vl::cluster::MSG_SG_UPDATE, _frame, getSimulationTime());
+	// Create SceneGraph updates, reusing the memory of the last frame
+	_msg_update.reset(vl::cluster::MSG_SG_UPDATE, _frame, getSimulationTime());
 
-	std::vector<vl::Distributed *>::iterator iter;
-	for( iter = _registered_objects.begin(); iter != _registered_objects.end();
-		++iter )
-	{
-		if( (*iter)->isDirty() )
-		{
-			assert( (*iter)->getID() != vl::ID_UNDEFINED );
-			vl::cluster::ObjectData data( (*iter)->getID() );
-			vl::cluster::ByteDataStream stream = data.getStream();
-			(*iter)->pack(stream);
-			data.copyToMessage(&_msg_update);
-			/// Clear dirty because this update has been applied
-			(*iter)->clearDirty();
-		}
-	}
+	packDirtyObjects(_msg_update);
 }
 
 /// Event Handling
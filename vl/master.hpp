@@ -77,8 +77,14 @@ public:
 	/// @todo these can be moved to private as we are using requests now
 	vl::cluster::Message createMsgInit(void) const;
 
-	vl::cluster::Message createResourceMessage(
-			vl::cluster::RESOURCE_TYPE type, std::string const &name) const;
+	/// @brief scene graph snapshot for a remote client
+	/// Divided into chunks that can be applied and acked separately.
+	/// Each has [chunk index | number of chunks] before the object data.
+	void createInitChunks(std::vector<vl::cluster::Message> &chunks) const;
+
+	/// @param cached_hash hash of the slave's cached version, data is not sent if it matches
+	vl::cluster::Message createResourceMessage(vl::cluster::RESOURCE_TYPE type,
+			std::string const &name, uint64_t cached_hash = 0) const;
 
 	void messageRequested(vl::cluster::RequestedMessage const &);
 
@@ -162,6 +168,8 @@ protected :
 	// Update messages for this frame
 	vl::cluster::Message _msg_create;
 	vl::cluster::Message _msg_update;
+	/// Copy of the update for the local renderer
+	vl::cluster::Message _msg_render;
 
 	// callback provided messages
 	std::deque<vl::cluster::Message> _messages;
@@ -20,6 +20,8 @@
 /// Necessary for timing the serialisation
 #include "base/chrono.hpp"
 
+#include <cstring>
+
 /// ------------------------------- Global -----------------------------------
 void 
 vl::calculate_bounds(vl::VertexData const *vertexData, Ogre::AxisAlignedBox &box, Ogre::Real &sphere)
@@ -45,6 +47,75 @@ vl::calculate_bounds(vl::VertexData const *vertexData, Ogre::AxisAlignedBox &box
 	sphere = Ogre::Math::Sqrt(maxSquaredRadius);
 }
 
+namespace
+{
+
+/// FNV-1a on 64-bit words, bytewise is too slow for large meshes
+void hash_bytes(uint64_t &hash, void const *data, size_t size)
+{
+	uint8_t const *bytes = (uint8_t const *)data;
+	for(; size >= sizeof(uint64_t); size -= sizeof(uint64_t), bytes += sizeof(uint64_t))
+	{
+		uint64_t word;
+		::memcpy(&word, bytes, sizeof(word));
+		hash ^= word;
+		hash *= 0x100000001b3ULL;
+	}
+	for(; size > 0; --size, ++bytes)
+	{
+		hash ^= *bytes;
+		hash *= 0x100000001b3ULL;
+	}
+}
+
+void hash_vertex_data(uint64_t &hash, vl::VertexData const *data)
+{
+	if(!data)
+	{ return; }
+
+	std::vector<Ogre::VertexElement> const &elems = data->vertexDeclaration.getElements();
+	for(size_t i = 0; i < elems.size(); ++i)
+	{
+		uint32_t elem[4] = { elems.at(i).getSource(), elems.at(i).getOffset(),
+			elems.at(i).getType(), elems.at(i).getSemantic() };
+		hash_bytes(hash, elem, sizeof(elem));
+	}
+
+	std::map<size_t, vl::VertexBufferRefPtr>::const_iterator iter;
+	for(iter = data->_bindings.begin(); iter != data->_bindings.end(); ++iter)
+	{
+		uint64_t bind = iter->first;
+		hash_bytes(hash, &bind, sizeof(bind));
+		hash_bytes(hash, iter->second->_buffer, iter->second->size());
+	}
+}
+
+}	// unamed namespace
+
+uint64_t
+vl::calculate_mesh_hash(vl::Mesh const &mesh)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	hash_vertex_data(hash, mesh.sharedVertexData);
+
+	for(size_t i = 0; i < mesh.getNumSubMeshes(); ++i)
+	{
+		vl::SubMesh const *sm = mesh.getSubMesh(i);
+		std::string const &material = sm->getMaterial();
+		hash_bytes(hash, material.c_str(), material.size()+1);
+
+		uint32_t flags[2] = { sm->operationType, sm->useSharedGeometry };
+		hash_bytes(hash, flags, sizeof(flags));
+		if(!sm->useSharedGeometry)
+		{ hash_vertex_data(hash, sm->vertexData); }
+
+		if(sm->indexData.indexCount() > 0)
+		{ hash_bytes(hash, sm->indexData.getBuffer(), sm->indexData.indexCount()*sizeof(uint32_t)); }
+	}
+
+	return hash;
+}
+
 std::ostream &
 vl::operator<<( std::ostream &os, vl::Mesh const &m )
 {
@@ -332,6 +403,14 @@ vl::Mesh::nameSubMesh(std::string const &name, uint16_t index)
 {
 }
 
+void
+vl::Mesh::removeLodLevels(void)
+{
+	_lod_values.clear();
+	for(size_t i = 0; i < _sub_meshes.size(); ++i)
+	{ _sub_meshes.at(i)->lodIndexData.clear(); }
+}
+
 void
 vl::Mesh::calculateBounds(void)
 {
@@ -483,6 +562,10 @@ vl::cluster::operator<<(vl::cluster::ByteStream &msg, vl::SubMesh const &sm)
 {
 	msg << sm.getName() << sm.getMaterial() << sm.operationType << sm.indexData << sm.useSharedGeometry;
 
+	msg << sm.lodIndexData.size();
+	for(size_t i = 0; i < sm.lodIndexData.size(); ++i)
+	{ msg << sm.lodIndexData.at(i); }
+
 	if(sm.vertexData)
 	{ msg << *sm.vertexData; }
 
@@ -503,6 +586,12 @@ vl::cluster::operator>>(vl::cluster::ByteStream &msg, vl::SubMesh &sm)
 	sm.setName(name);
 	sm.setMaterial(material);
 
+	size_t n_lods;
+	msg >> n_lods;
+	sm.lodIndexData.resize(n_lods);
+	for(size_t i = 0; i < n_lods; ++i)
+	{ msg >> sm.lodIndexData.at(i); }
+
 	if(!sm.useSharedGeometry)
 	{
 		if(!sm.vertexData)
@@ -536,6 +625,8 @@ vl::cluster::operator<<(vl::cluster::ByteStream &msg, vl::Mesh const &mesh)
 	for(size_t i = 0; i < mesh.getSubMeshes().size(); ++i)
 	{ msg << *mesh.getSubMeshes().at(i); }
 
+	msg << mesh.getLodStrategy() << mesh.getLodValues();
+
 	// Serialisation doesn't take that long (deserialisation is the problem)
 	std::clog << "Mesh took : " << clock.elapsed() << std::endl;
 
@@ -581,6 +672,12 @@ vl::cluster::operator>>(vl::cluster::ByteStream &msg, vl::Mesh &mesh)
 		msg >> *sm;
 	}
 
+	std::string lod_strategy;
+	std::vector<Ogre::Real> lod_values;
+	msg >> lod_strategy >> lod_values;
+	mesh.setLodStrategy(lod_strategy);
+	mesh.setLodValues(lod_values);
+
 	std::clog << "Mesh took : " << clock.elapsed() << std::endl;
 
 	return msg;
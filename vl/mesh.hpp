@@ -129,6 +129,8 @@ struct VertexDeclaration
 			if(iter->getSemantic() == type)
 			{ return true; }
 		}
+
+		return false;
 	}
 
 	/// @todo not sure if these are correct
@@ -152,6 +154,9 @@ private :
 class VertexBuffer
 {
 public :
+	~VertexBuffer(void)
+	{ delete [] _buffer; }
+
 	void read(size_t offset, void *data, size_t size_) const
 	{
 		assert(offset + size_ <= this->size());
@@ -229,6 +234,10 @@ private :
 		}
 	}
 
+	// Non-copyable, owns the buffer
+	VertexBuffer(VertexBuffer const &);
+	VertexBuffer &operator=(VertexBuffer const &);
+
 	size_t _n_vertices;
 	size_t _vertex_size;
 };
@@ -495,6 +504,10 @@ public :
 
 	IndexBuffer indexData;
 
+	/// Index data for the LOD levels starting from level 1,
+	/// the full detail is in indexData. Uses the same vertex data.
+	std::vector<IndexBuffer> lodIndexData;
+
 private :
 	// Non-copyable
 	SubMesh(SubMesh const &);
@@ -528,6 +541,14 @@ public :
 	std::string const &getName(void) const
 	{ return _name; }
 
+	/// @brief path of the file the mesh was loaded from
+	/// Empty for generated meshes and meshes received from the master.
+	std::string const &getFilePath(void) const
+	{ return _file_path; }
+
+	void setFilePath(std::string const &path)
+	{ _file_path = path; }
+
 	SubMesh *createSubMesh(void);
 
 	void removeSubMesh(uint16_t index);
@@ -578,6 +599,29 @@ public :
 	void createSharedVertexData(void)
 	{ sharedVertexData = new VertexData; }
 
+	/// @brief number of LOD levels including the full detail
+	unsigned short getNumLodLevels(void) const
+	{ return _lod_values.size()+1; }
+
+	/// @brief values for switching to the LOD levels starting from level 1
+	/// Meaning of the values depends on the LOD strategy.
+	std::vector<Ogre::Real> const &getLodValues(void) const
+	{ return _lod_values; }
+
+	/// SubMeshes need the index data for the levels, see SubMesh::lodIndexData
+	void setLodValues(std::vector<Ogre::Real> const &values)
+	{ _lod_values = values; }
+
+	/// @brief name of the Ogre LOD strategy used to select the level
+	std::string const &getLodStrategy(void) const
+	{ return _lod_strategy; }
+
+	void setLodStrategy(std::string const &name)
+	{ _lod_strategy = name; }
+
+	/// @brief remove all LOD levels from the mesh and SubMeshes
+	void removeLodLevels(void);
+
 	/// ---------------------- Public Data ------------------------
 	VertexData *sharedVertexData;
 
@@ -588,17 +632,25 @@ private :
 
 	/// ---------------------- Private Data ------------------------
 	std::string _name;
+	std::string _file_path;
 
 	SubMeshList _sub_meshes;
 	Ogre::AxisAlignedBox _bounds;
 	Ogre::Real _bound_radius;
 
+	std::vector<Ogre::Real> _lod_values;
+	std::string _lod_strategy;
+
 };	// class Mesh
 
 Ogre::MeshPtr create_ogre_mesh(std::string const &name, vl::MeshRefPtr mesh);
 
 void calculate_bounds(vl::VertexData const *vertexData, Ogre::AxisAlignedBox &box, Ogre::Real &sphere);
 
+/// @brief hash of the vertex data, indices and materials
+/// Used as a key for data cached from the mesh, the name is not included.
+uint64_t calculate_mesh_hash(vl::Mesh const &mesh);
+
 std::ostream &operator<<( std::ostream &os, Mesh const &m );
 
 namespace cluster
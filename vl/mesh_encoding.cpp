@@ -0,0 +1,597 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file mesh_encoding.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/// Interface
+#include "mesh_encoding.hpp"
+
+#include "base/exceptions.hpp"
+
+#include <cstring>
+#include <cmath>
+#include <cassert>
+#include <limits>
+#include <algorithm>
+
+namespace
+{
+
+/// Version byte in the beginning of compressed streams
+uint8_t const VERTEX_CODEC_VERSION = 0;
+uint8_t const INDEX_CODEC_VERSION = 0;
+
+/// Values are bit packed in groups of this size
+size_t const GROUP_SIZE = 16;
+
+/// Bits per value for group modes
+size_t const GROUP_BITS[4] = { 0, 2, 4, 8 };
+
+inline uint8_t zigzag8(uint8_t d)
+{ return (uint8_t)((d << 1) ^ (uint8_t)((int8_t)d >> 7)); }
+
+inline uint8_t unzigzag8(uint8_t z)
+{ return (uint8_t)((z >> 1) ^ (uint8_t)(-(int8_t)(z & 1))); }
+
+inline uint32_t zigzag32(int32_t d)
+{ return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31); }
+
+inline int32_t unzigzag32(uint32_t z)
+{ return (int32_t)(z >> 1) ^ -(int32_t)(z & 1); }
+
+inline uint8_t group_mode(uint8_t const *values)
+{
+	uint8_t bits = 0;
+	for(size_t i = 0; i < GROUP_SIZE; ++i)
+	{ bits |= values[i]; }
+
+	if(bits == 0)
+	{ return 0; }
+	else if(bits < 4)
+	{ return 1; }
+	else if(bits < 16)
+	{ return 2; }
+	return 3;
+}
+
+void corrupted(char const *what)
+{
+	std::string msg = std::string("Corrupted ") + what + " stream in mesh file";
+	BOOST_THROW_EXCEPTION(vl::exception() << vl::desc(msg));
+}
+
+inline int16_t to_snorm16(float v)
+{
+	v = std::max(-1.0f, std::min(1.0f, v));
+	return (int16_t)std::floor(v*32767.0f + 0.5f);
+}
+
+inline float sign_not_zero(float v)
+{ return v >= 0 ? 1.0f : -1.0f; }
+
+}	// unamed namespace
+
+/// ------------------------------ VertexStream ------------------------------
+vl::VertexStream::VertexStream(uint16_t offset_, uint16_t size_, VERTEX_STREAM_ENCODING encoding_)
+	: offset(offset_)
+	, size(size_)
+	, encoding(encoding_)
+{
+	for(size_t i = 0; i < 3; ++i)
+	{
+		min[i] = 0;
+		extent[i] = 0;
+	}
+}
+
+uint16_t
+vl::VertexStream::getEncodedSize(void) const
+{
+	switch(encoding)
+	{
+	case VSE_POSITION_UNORM16 :
+		return 3*sizeof(uint16_t);
+	case VSE_NORMAL_OCT16 :
+		return 2*sizeof(int16_t);
+	case VSE_HALF :
+		return size/2;
+	default :
+		return size;
+	}
+}
+
+/// ------------------------------- Global -----------------------------------
+void
+vl::encode_vertex_stream(VertexStream &stream, uint8_t const *vertices,
+	size_t vertex_size, size_t n_vertices, std::vector<uint8_t> &out)
+{
+	assert(stream.offset + stream.size <= vertex_size);
+
+	size_t encoded_size = stream.getEncodedSize();
+	out.resize(encoded_size*n_vertices);
+	if(n_vertices == 0)
+	{ return; }
+
+	uint8_t const *src = vertices + stream.offset;
+	uint8_t *dst = &out[0];
+
+	switch(stream.encoding)
+	{
+	case VSE_POSITION_UNORM16 :
+	{
+		assert(stream.size == 3*sizeof(float));
+		float max[3];
+		for(size_t j = 0; j < 3; ++j)
+		{
+			stream.min[j] = std::numeric_limits<float>::max();
+			max[j] = -std::numeric_limits<float>::max();
+		}
+		for(size_t i = 0; i < n_vertices; ++i)
+		{
+			float p[3];
+			::memcpy(p, src + i*vertex_size, sizeof(p));
+			for(size_t j = 0; j < 3; ++j)
+			{
+				stream.min[j] = std::min(stream.min[j], p[j]);
+				max[j] = std::max(max[j], p[j]);
+			}
+		}
+		for(size_t j = 0; j < 3; ++j)
+		{ stream.extent[j] = max[j] - stream.min[j]; }
+
+		for(size_t i = 0; i < n_vertices; ++i)
+		{
+			float p[3];
+			::memcpy(p, src + i*vertex_size, sizeof(p));
+			uint16_t q[3];
+			for(size_t j = 0; j < 3; ++j)
+			{
+				float t = stream.extent[j] > 0 ? (p[j] - stream.min[j])/stream.extent[j] : 0;
+				q[j] = (uint16_t)std::floor(std::max(0.0f, std::min(1.0f, t))*65535.0f + 0.5f);
+			}
+			::memcpy(dst + i*encoded_size, q, sizeof(q));
+		}
+		break;
+	}
+
+	case VSE_NORMAL_OCT16 :
+	{
+		assert(stream.size == 3*sizeof(float));
+		for(size_t i = 0; i < n_vertices; ++i)
+		{
+			float n[3];
+			::memcpy(n, src + i*vertex_size, sizeof(n));
+			int16_t q[2];
+			encode_octahedral(n, q);
+			::memcpy(dst + i*encoded_size, q, sizeof(q));
+		}
+		break;
+	}
+
+	case VSE_HALF :
+	{
+		assert(stream.size%sizeof(float) == 0);
+		size_t n_comps = stream.size/sizeof(float);
+		for(size_t i = 0; i < n_vertices; ++i)
+		{
+			for(size_t j = 0; j < n_comps; ++j)
+			{
+				float f;
+				::memcpy(&f, src + i*vertex_size + j*sizeof(float), sizeof(f));
+				uint16_t h = float_to_half(f);
+				::memcpy(dst + i*encoded_size + j*sizeof(h), &h, sizeof(h));
+			}
+		}
+		break;
+	}
+
+	default :
+		for(size_t i = 0; i < n_vertices; ++i)
+		{ ::memcpy(dst + i*encoded_size, src + i*vertex_size, encoded_size); }
+		break;
+	}
+}
+
+void
+vl::decode_vertex_stream(VertexStream const &stream, uint8_t const *data,
+	uint8_t *vertices, size_t vertex_size, size_t n_vertices)
+{
+	if(stream.offset + stream.size > vertex_size)
+	{ corrupted("vertex"); }
+
+	size_t encoded_size = stream.getEncodedSize();
+	uint8_t *dst = vertices + stream.offset;
+
+	switch(stream.encoding)
+	{
+	case VSE_POSITION_UNORM16 :
+	{
+		if(stream.size != 3*sizeof(float))
+		{ corrupted("vertex"); }
+
+		float scale[3];
+		for(size_t j = 0; j < 3; ++j)
+		{ scale[j] = stream.extent[j]/65535.0f; }
+
+		for(size_t i = 0; i < n_vertices; ++i)
+		{
+			uint16_t q[3];
+			::memcpy(q, data + i*encoded_size, sizeof(q));
+			float p[3];
+			for(size_t j = 0; j < 3; ++j)
+			{ p[j] = stream.min[j] + q[j]*scale[j]; }
+			::memcpy(dst + i*vertex_size, p, sizeof(p));
+		}
+		break;
+	}
+
+	case VSE_NORMAL_OCT16 :
+	{
+		if(stream.size != 3*sizeof(float))
+		{ corrupted("vertex"); }
+
+		for(size_t i = 0; i < n_vertices; ++i)
+		{
+			int16_t q[2];
+			::memcpy(q, data + i*encoded_size, sizeof(q));
+			float n[3];
+			decode_octahedral(q, n);
+			::memcpy(dst + i*vertex_size, n, sizeof(n));
+		}
+		break;
+	}
+
+	case VSE_HALF :
+	{
+		if(stream.size%sizeof(float) != 0)
+		{ corrupted("vertex"); }
+
+		size_t n_comps = stream.size/sizeof(float);
+		for(size_t i = 0; i < n_vertices; ++i)
+		{
+			for(size_t j = 0; j < n_comps; ++j)
+			{
+				uint16_t h;
+				::memcpy(&h, data + i*encoded_size + j*sizeof(h), sizeof(h));
+				float f = half_to_float(h);
+				::memcpy(dst + i*vertex_size + j*sizeof(float), &f, sizeof(f));
+			}
+		}
+		break;
+	}
+
+	case VSE_RAW :
+		for(size_t i = 0; i < n_vertices; ++i)
+		{ ::memcpy(dst + i*vertex_size, data + i*encoded_size, encoded_size); }
+		break;
+
+	default :
+		corrupted("vertex");
+	}
+}
+
+void
+vl::compress_vertex_stream(uint8_t const *data, size_t n_vertices, size_t vertex_size,
+	std::vector<uint8_t> &out)
+{
+	out.clear();
+	out.push_back(VERTEX_CODEC_VERSION);
+
+	size_t n_groups = (n_vertices + GROUP_SIZE - 1)/GROUP_SIZE;
+	std::vector<uint8_t> values(n_groups*GROUP_SIZE, 0);
+	std::vector<uint8_t> modes(n_groups);
+
+	// Every byte of the vertex is coded separately as the bytes
+	// of the same attribute change similarly between vertices.
+	for(size_t k = 0; k < vertex_size; ++k)
+	{
+		uint8_t prev = 0;
+		for(size_t i = 0; i < n_vertices; ++i)
+		{
+			uint8_t v = data[i*vertex_size + k];
+			values[i] = zigzag8((uint8_t)(v - prev));
+			prev = v;
+		}
+
+		// Two bit mode for every group in the header
+		size_t header = out.size();
+		out.resize(header + (n_groups+3)/4, 0);
+		for(size_t g = 0; g < n_groups; ++g)
+		{
+			modes[g] = group_mode(&values[g*GROUP_SIZE]);
+			out[header + g/4] |= (uint8_t)(modes[g] << ((g%4)*2));
+		}
+
+		for(size_t g = 0; g < n_groups; ++g)
+		{
+			size_t bits = GROUP_BITS[modes[g]];
+			if(bits == 0)
+			{ continue; }
+
+			uint8_t const *group = &values[g*GROUP_SIZE];
+			size_t per_byte = 8/bits;
+			for(size_t i = 0; i < GROUP_SIZE; i += per_byte)
+			{
+				uint8_t b = 0;
+				for(size_t j = 0; j < per_byte; ++j)
+				{ b |= (uint8_t)(group[i+j] << (j*bits)); }
+				out.push_back(b);
+			}
+		}
+
+		// Padding needs to be zero for the next plane
+		std::fill(values.begin(), values.end(), 0);
+	}
+}
+
+void
+vl::decompress_vertex_stream(uint8_t const *data, size_t size, size_t n_vertices,
+	size_t vertex_size, uint8_t *out)
+{
+	if(size == 0 || data[0] != VERTEX_CODEC_VERSION)
+	{ corrupted("vertex"); }
+
+	uint8_t const *pos = data + 1;
+	uint8_t const *end = data + size;
+
+	size_t n_groups = (n_vertices + GROUP_SIZE - 1)/GROUP_SIZE;
+	size_t header_size = (n_groups+3)/4;
+
+	// Find the planes first so that the vertices can be decoded in order,
+	// writing every plane separately through the whole output is a lot slower.
+	std::vector<uint8_t const *> headers(vertex_size);
+	std::vector<uint8_t const *> payloads(vertex_size);
+	for(size_t k = 0; k < vertex_size; ++k)
+	{
+		if(size_t(end - pos) < header_size)
+		{ corrupted("vertex"); }
+		headers[k] = pos;
+		pos += header_size;
+		payloads[k] = pos;
+
+		size_t payload_size = 0;
+		for(size_t g = 0; g < n_groups; ++g)
+		{ payload_size += GROUP_SIZE*GROUP_BITS[(headers[k][g/4] >> ((g%4)*2)) & 3]/8; }
+		if(size_t(end - pos) < payload_size)
+		{ corrupted("vertex"); }
+		pos += payload_size;
+	}
+
+	if(pos != end)
+	{ corrupted("vertex"); }
+
+	std::vector<uint8_t> prev(vertex_size, 0);
+	uint8_t values[GROUP_SIZE];
+	for(size_t g = 0; g < n_groups; ++g)
+	{
+		size_t n = std::min(GROUP_SIZE, n_vertices - g*GROUP_SIZE);
+		uint8_t *group_out = out + g*GROUP_SIZE*vertex_size;
+		for(size_t k = 0; k < vertex_size; ++k)
+		{
+			size_t bits = GROUP_BITS[(headers[k][g/4] >> ((g%4)*2)) & 3];
+			uint8_t *dst = group_out + k;
+			uint8_t p = prev[k];
+			if(bits == 0)
+			{
+				for(size_t i = 0; i < n; ++i)
+				{ dst[i*vertex_size] = p; }
+				continue;
+			}
+
+			uint8_t const *src = payloads[k];
+			payloads[k] += GROUP_SIZE*bits/8;
+			if(bits == 8)
+			{ ::memcpy(values, src, GROUP_SIZE); }
+			else if(bits == 4)
+			{
+				for(size_t i = 0; i < GROUP_SIZE/2; ++i)
+				{
+					values[2*i] = src[i] & 0x0f;
+					values[2*i+1] = src[i] >> 4;
+				}
+			}
+			else
+			{
+				for(size_t i = 0; i < GROUP_SIZE/4; ++i)
+				{
+					values[4*i] = src[i] & 0x03;
+					values[4*i+1] = (src[i] >> 2) & 0x03;
+					values[4*i+2] = (src[i] >> 4) & 0x03;
+					values[4*i+3] = src[i] >> 6;
+				}
+			}
+
+			for(size_t i = 0; i < n; ++i)
+			{
+				p = (uint8_t)(p + unzigzag8(values[i]));
+				dst[i*vertex_size] = p;
+			}
+			prev[k] = p;
+		}
+	}
+}
+
+void
+vl::compress_index_stream(uint32_t const *indices, size_t count, std::vector<uint8_t> &out)
+{
+	out.clear();
+	out.reserve(count*2 + 1);
+	out.push_back(INDEX_CODEC_VERSION);
+
+	// Delta to the previous index as a variable length integer,
+	// seven bits per byte with the high bit set if more follow.
+	uint32_t prev = 0;
+	for(size_t i = 0; i < count; ++i)
+	{
+		uint32_t v = zigzag32((int32_t)(indices[i] - prev));
+		prev = indices[i];
+		while(v >= 0x80)
+		{
+			out.push_back((uint8_t)(v | 0x80));
+			v >>= 7;
+		}
+		out.push_back((uint8_t)v);
+	}
+}
+
+void
+vl::decompress_index_stream(uint8_t const *data, size_t size, size_t count, uint32_t *out)
+{
+	if(size == 0 || data[0] != INDEX_CODEC_VERSION)
+	{ corrupted("index"); }
+
+	uint8_t const *pos = data + 1;
+	uint8_t const *end = data + size;
+
+	uint32_t prev = 0;
+	for(size_t i = 0; i < count; ++i)
+	{
+		uint32_t v = 0;
+		for(size_t shift = 0; ; shift += 7)
+		{
+			if(pos == end || shift > 28)
+			{ corrupted("index"); }
+
+			uint8_t b = *pos++;
+			v |= (uint32_t)(b & 0x7f) << shift;
+			if(!(b & 0x80))
+			{ break; }
+		}
+		prev += (uint32_t)unzigzag32(v);
+		out[i] = prev;
+	}
+
+	if(pos != end)
+	{ corrupted("index"); }
+}
+
+uint16_t
+vl::float_to_half(float f)
+{
+	uint32_t x;
+	::memcpy(&x, &f, sizeof(x));
+
+	uint16_t sign = (uint16_t)((x >> 16) & 0x8000);
+	uint32_t mantissa = x & 0x007fffff;
+	uint32_t biased = (x >> 23) & 0xff;
+
+	// Infinity and NaN
+	if(biased == 0xff)
+	{ return (uint16_t)(sign | 0x7c00 | (mantissa ? 0x200 : 0)); }
+
+	int32_t exponent = (int32_t)biased - 127 + 15;
+	if(exponent >= 31)
+	{ return (uint16_t)(sign | 0x7c00); }
+
+	// Denormalized or zero, rounded to nearest even
+	if(exponent <= 0)
+	{
+		if(exponent < -10)
+		{ return sign; }
+
+		mantissa |= 0x00800000;
+		uint32_t shift = (uint32_t)(14 - exponent);
+		uint32_t h = mantissa >> shift;
+		uint32_t rem = mantissa & ((1u << shift) - 1);
+		uint32_t half = 1u << (shift - 1);
+		if(rem > half || (rem == half && (h & 1)))
+		{ ++h; }
+		return (uint16_t)(sign | h);
+	}
+
+	// Rounding overflow carries to the exponent which is correct
+	uint32_t h = ((uint32_t)exponent << 10) | (mantissa >> 13);
+	uint32_t rem = mantissa & 0x1fff;
+	if(rem > 0x1000 || (rem == 0x1000 && (h & 1)))
+	{ ++h; }
+	return (uint16_t)(sign | h);
+}
+
+float
+vl::half_to_float(uint16_t h)
+{
+	uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+	uint32_t exponent = (h >> 10) & 0x1f;
+	uint32_t mantissa = h & 0x3ff;
+
+	uint32_t x;
+	if(exponent == 0)
+	{
+		if(mantissa == 0)
+		{ x = sign; }
+		else
+		{
+			// Denormalized, normalize for float
+			exponent = 127 - 15 + 1;
+			while(!(mantissa & 0x400))
+			{
+				mantissa <<= 1;
+				--exponent;
+			}
+			mantissa &= 0x3ff;
+			x = sign | (exponent << 23) | (mantissa << 13);
+		}
+	}
+	else if(exponent == 31)
+	{ x = sign | 0x7f800000 | (mantissa << 13); }
+	else
+	{ x = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13); }
+
+	float f;
+	::memcpy(&f, &x, sizeof(f));
+	return f;
+}
+
+void
+vl::encode_octahedral(float const *n, int16_t *out)
+{
+	float l1 = std::abs(n[0]) + std::abs(n[1]) + std::abs(n[2]);
+	if(l1 <= 0)
+	{
+		out[0] = out[1] = 0;
+		return;
+	}
+
+	// Project to the octahedron and fold the lower half over
+	float x = n[0]/l1;
+	float y = n[1]/l1;
+	if(n[2] < 0)
+	{
+		float tx = (1 - std::abs(y))*sign_not_zero(x);
+		float ty = (1 - std::abs(x))*sign_not_zero(y);
+		x = tx;
+		y = ty;
+	}
+
+	out[0] = to_snorm16(x);
+	out[1] = to_snorm16(y);
+}
+
+void
+vl::decode_octahedral(int16_t const *in, float *n)
+{
+	float x = in[0]/32767.0f;
+	float y = in[1]/32767.0f;
+	float z = 1 - std::abs(x) - std::abs(y);
+	if(z < 0)
+	{
+		float tx = (1 - std::abs(y))*sign_not_zero(x);
+		float ty = (1 - std::abs(x))*sign_not_zero(y);
+		x = tx;
+		y = ty;
+	}
+
+	float len = std::sqrt(x*x + y*y + z*z);
+	n[0] = x/len;
+	n[1] = y/len;
+	n[2] = z/len;
+}
@@ -0,0 +1,149 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file mesh_encoding.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Compact vertex and index encodings for mesh files.
+ *
+ *	Quantization is lossy and optional per attribute:
+ *	positions as 16-bit normalized values against the bounds of the vertex
+ *	data, unit vectors (normals, tangents, binormals) as 16-bit octahedral
+ *	coordinates and texture coordinates as half floats.
+ *
+ *	Compression is lossless. Vertex streams are split into byte planes,
+ *	delta coded between consecutive vertices and bit packed in groups of
+ *	16 values. Indices are delta coded as variable length integers.
+ *	Both work best after the mesh has been optimized for vertex fetch
+ *	(see mesh_optimizer.hpp) and decode faster than the saved disk reads,
+ *	demos/mesh_encoding_benchmark.cpp measures the decode throughput.
+ *
+ *	Encodings only affect the file, meshes are always decoded to their
+ *	original vertex declaration when read.
+ *
+ *	No Ogre dependencies so that this can be used and tested separately.
+ */
+
+#ifndef HYDRA_MESH_ENCODING_HPP
+#define HYDRA_MESH_ENCODING_HPP
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace vl
+{
+
+struct MeshEncodingSettings
+{
+	MeshEncodingSettings(void)
+		: quantize_positions(false)
+		, quantize_normals(false)
+		, half_texcoords(false)
+		, compress(false)
+	{}
+
+	/// @brief settings for the smallest files
+	static MeshEncodingSettings compact(void)
+	{
+		MeshEncodingSettings settings;
+		settings.quantize_positions = true;
+		settings.quantize_normals = true;
+		settings.half_texcoords = true;
+		settings.compress = true;
+		return settings;
+	}
+
+	/// @brief is any encoding used, if not the file is a plain Ogre mesh
+	bool encoded(void) const
+	{ return quantize_positions || quantize_normals || half_texcoords || compress; }
+
+	/// Float3 positions to 16-bit, error is 1/131070 of the bounding box
+	bool quantize_positions;
+
+	/// Float3 normals, tangents and binormals to two 16-bit values
+	bool quantize_normals;
+
+	/// Float texture coordinates to half floats
+	bool half_texcoords;
+
+	/// Lossless compression of vertex and index streams
+	bool compress;
+
+};	// struct MeshEncodingSettings
+
+enum VERTEX_STREAM_ENCODING
+{
+	VSE_RAW = 0,
+	VSE_POSITION_UNORM16 = 1,
+	VSE_NORMAL_OCT16 = 2,
+	VSE_HALF = 3,
+};
+
+/// @brief one attribute of interleaved vertex data stored separately
+struct VertexStream
+{
+	VertexStream(uint16_t offset_ = 0, uint16_t size_ = 0, VERTEX_STREAM_ENCODING encoding_ = VSE_RAW);
+
+	/// @brief number of bytes per vertex in the encoded stream
+	uint16_t getEncodedSize(void) const;
+
+	/// Offset in the vertex
+	uint16_t offset;
+	/// Size of the attribute in the vertex in bytes
+	uint16_t size;
+	VERTEX_STREAM_ENCODING encoding;
+
+	/// Quantization bounds for positions
+	float min[3];
+	float extent[3];
+
+};	// struct VertexStream
+
+/// @brief encode an attribute from interleaved vertices
+/// Bounds for positions are calculated from the data.
+/// @param stream size and encoding need to be valid for the attribute
+void encode_vertex_stream(VertexStream &stream, uint8_t const *vertices,
+	size_t vertex_size, size_t n_vertices, std::vector<uint8_t> &out);
+
+/// @brief decode an attribute to interleaved vertices
+/// @param data needs n_vertices*stream.getEncodedSize() bytes
+void decode_vertex_stream(VertexStream const &stream, uint8_t const *data,
+	uint8_t *vertices, size_t vertex_size, size_t n_vertices);
+
+/// @brief lossless compression for arrays of fixed size elements
+void compress_vertex_stream(uint8_t const *data, size_t n_vertices, size_t vertex_size,
+	std::vector<uint8_t> &out);
+
+/// @throw vl::exception if the data is corrupted
+void decompress_vertex_stream(uint8_t const *data, size_t size, size_t n_vertices,
+	size_t vertex_size, uint8_t *out);
+
+/// @brief lossless compression for index lists
+void compress_index_stream(uint32_t const *indices, size_t count, std::vector<uint8_t> &out);
+
+/// @throw vl::exception if the data is corrupted
+void decompress_index_stream(uint8_t const *data, size_t size, size_t count, uint32_t *out);
+
+uint16_t float_to_half(float f);
+
+float half_to_float(uint16_t h);
+
+/// @param n unit vector
+void encode_octahedral(float const *n, int16_t *out);
+
+/// @return unit vector in n
+void decode_octahedral(int16_t const *in, float *n);
+
+}	// namespace vl
+
+#endif	// HYDRA_MESH_ENCODING_HPP
@@ -0,0 +1,519 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file mesh_lod.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/// Interface
+#include "mesh_lod.hpp"
+
+/// Necessary for reordering the levels for vertex cache
+#include "mesh_optimizer.hpp"
+
+#include "base/exceptions.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <queue>
+#include <cmath>
+
+namespace
+{
+
+/// Constraint planes for open borders are weighted more than the surface
+double const BOUNDARY_WEIGHT = 10.0;
+
+/// Collapses rotating a triangle normal more than this are rejected, cosine
+double const MIN_NORMAL_COS = 0.2;
+
+/// Quadric error of a set of planes, symmetric 4x4 matrix and the sum of
+/// the plane weights
+struct Quadric
+{
+	Quadric(void)
+		: w(0)
+	{ std::fill(a, a+10, 0.0); }
+
+	/// @brief quadric for plane n.p + d = 0
+	/// @param n unit normal
+	static Quadric plane(Ogre::Vector3 const &n, double d, double weight)
+	{
+		double x = n.x, y = n.y, z = n.z;
+
+		Quadric q;
+		q.a[0] = x*x; q.a[1] = x*y; q.a[2] = x*z; q.a[3] = x*d;
+		q.a[4] = y*y; q.a[5] = y*z; q.a[6] = y*d;
+		q.a[7] = z*z; q.a[8] = z*d;
+		q.a[9] = d*d;
+		for(size_t i = 0; i < 10; ++i)
+		{ q.a[i] *= weight; }
+		q.w = weight;
+
+		return q;
+	}
+
+	Quadric &operator+=(Quadric const &other)
+	{
+		for(size_t i = 0; i < 10; ++i)
+		{ a[i] += other.a[i]; }
+		w += other.w;
+		return *this;
+	}
+
+	Quadric operator+(Quadric const &other) const
+	{
+		Quadric q(*this);
+		q += other;
+		return q;
+	}
+
+	/// @return weighted average of the squared distances to the planes
+	double error(Ogre::Vector3 const &p) const
+	{
+		if(w <= 0)
+		{ return 0; }
+
+		double x = p.x, y = p.y, z = p.z;
+		double e = a[0]*x*x + 2*a[1]*x*y + 2*a[2]*x*z + 2*a[3]*x
+			+ a[4]*y*y + 2*a[5]*y*z + 2*a[6]*y
+			+ a[7]*z*z + 2*a[8]*z
+			+ a[9];
+
+		return std::fabs(e)/w;
+	}
+
+	double a[10];
+	double w;
+};
+
+struct Collapse
+{
+	double cost;
+	uint32_t from;
+	uint32_t to;
+	uint32_t from_version;
+	uint32_t to_version;
+
+	/// std::priority_queue is a max heap, cheapest first
+	bool operator<(Collapse const &other) const
+	{ return cost > other.cost; }
+};
+
+/// Lexicographic order for welding positions
+struct PositionLess
+{
+	bool operator()(Ogre::Vector3 const &a, Ogre::Vector3 const &b) const
+	{
+		if(a.x != b.x)
+		{ return a.x < b.x; }
+		if(a.y != b.y)
+		{ return a.y < b.y; }
+		return a.z < b.z;
+	}
+};
+
+/// Edge collapse simplification working on vertices welded by position.
+/// Triangles keep the original vertex indices so seams are preserved.
+class QuadricSimplifier
+{
+public :
+	QuadricSimplifier(std::vector<uint32_t> const &indices, std::vector<Ogre::Vector3> const &positions);
+
+	/// @brief collapse edges until there is at most target triangles left
+	/// Can be called multiple times with decreasing targets.
+	/// @param max_error negative for no limit
+	void simplify(size_t target_triangles, double max_error);
+
+	size_t getNTriangles(void) const
+	{ return _n_live; }
+
+	void getIndices(std::vector<uint32_t> &out) const;
+
+private :
+	void _push_edge(uint32_t a, uint32_t b);
+
+	bool _valid(uint32_t from, uint32_t to) const;
+
+	void _collapse(uint32_t from, uint32_t to);
+
+	bool _contains(uint32_t tri, uint32_t v) const
+	{
+		return _canon[_tris[3*tri]] == v || _canon[_tris[3*tri+1]] == v
+			|| _canon[_tris[3*tri+2]] == v;
+	}
+
+	/// Indexed by welded vertex
+	std::vector<Ogre::Vector3> _positions;
+	/// Any original vertex, used when the collapsed edge doesn't tell better
+	std::vector<uint32_t> _representative;
+	std::vector<Quadric> _quadrics;
+	std::vector<uint32_t> _versions;
+	std::vector<uint8_t> _alive_vertices;
+	/// Triangles using the vertex, can contain removed triangles
+	std::vector< std::vector<uint32_t> > _vertex_tris;
+
+	/// Welded vertex of every original vertex
+	std::vector<uint32_t> _canon;
+
+	/// Triangle corners are original vertices
+	std::vector<uint32_t> _tris;
+	std::vector<uint8_t> _alive_tris;
+	size_t _n_live;
+
+	std::priority_queue<Collapse> _heap;
+};
+
+QuadricSimplifier::QuadricSimplifier(std::vector<uint32_t> const &indices,
+	std::vector<Ogre::Vector3> const &positions)
+	: _canon(positions.size())
+	, _tris(indices.begin(), indices.begin() + indices.size()/3*3)
+	, _alive_tris(indices.size()/3, 1)
+	, _n_live(indices.size()/3)
+{
+	for(size_t i = 0; i < _tris.size(); ++i)
+	{
+		if(_tris[i] >= positions.size())
+		{ BOOST_THROW_EXCEPTION(vl::bad_index() << vl::desc("Triangle index out of range.")); }
+	}
+
+	std::map<Ogre::Vector3, uint32_t, PositionLess> welded;
+	for(size_t i = 0; i < positions.size(); ++i)
+	{
+		std::pair<std::map<Ogre::Vector3, uint32_t, PositionLess>::iterator, bool> res
+			= welded.insert(std::make_pair(positions[i], uint32_t(_positions.size())));
+		if(res.second)
+		{
+			_positions.push_back(positions[i]);
+			_representative.push_back(uint32_t(i));
+		}
+		_canon[i] = res.first->second;
+	}
+
+	size_t n = _positions.size();
+	_quadrics.resize(n);
+	_versions.resize(n, 0);
+	_alive_vertices.resize(n, 1);
+	_vertex_tris.resize(n);
+
+	// Undirected edge and the number of triangles using it
+	typedef std::map<std::pair<uint32_t, uint32_t>, std::pair<uint32_t, uint32_t> > EdgeMap;
+	EdgeMap edges;
+	for(size_t t = 0; t < _alive_tris.size(); ++t)
+	{
+		uint32_t v[3] = { _canon[_tris[3*t]], _canon[_tris[3*t+1]], _canon[_tris[3*t+2]] };
+		if(v[0] == v[1] || v[1] == v[2] || v[0] == v[2])
+		{
+			_alive_tris[t] = 0;
+			--_n_live;
+			continue;
+		}
+
+		Ogre::Vector3 normal = (_positions[v[1]] - _positions[v[0]]).crossProduct(_positions[v[2]] - _positions[v[0]]);
+		double area = normal.normalise()*0.5;
+		Quadric q = Quadric::plane(normal, -normal.dotProduct(_positions[v[0]]), area);
+		for(size_t k = 0; k < 3; ++k)
+		{
+			_quadrics[v[k]] += q;
+			_vertex_tris[v[k]].push_back(uint32_t(t));
+
+			uint32_t a = std::min(v[k], v[(k+1)%3]);
+			uint32_t b = std::max(v[k], v[(k+1)%3]);
+			std::pair<EdgeMap::iterator, bool> res = edges.insert(
+				std::make_pair(std::make_pair(a, b), std::make_pair(uint32_t(0), uint32_t(t))));
+			++res.first->second.first;
+		}
+	}
+
+	// Open borders get a plane perpendicular to the triangle through the edge
+	for(EdgeMap::const_iterator iter = edges.begin(); iter != edges.end(); ++iter)
+	{
+		if(iter->second.first != 1)
+		{ continue; }
+
+		uint32_t t = iter->second.second;
+		Ogre::Vector3 const &p0 = _positions[_canon[_tris[3*t]]];
+		Ogre::Vector3 const &p1 = _positions[_canon[_tris[3*t+1]]];
+		Ogre::Vector3 const &p2 = _positions[_canon[_tris[3*t+2]]];
+		Ogre::Vector3 tri_normal = (p1 - p0).crossProduct(p2 - p0);
+
+		Ogre::Vector3 const &a = _positions[iter->first.first];
+		Ogre::Vector3 const &b = _positions[iter->first.second];
+		Ogre::Vector3 normal = (b - a).crossProduct(tri_normal);
+		if(normal.normalise() <= 0)
+		{ continue; }
+
+		Quadric q = Quadric::plane(normal, -normal.dotProduct(a), (b - a).squaredLength()*BOUNDARY_WEIGHT);
+		_quadrics[iter->first.first] += q;
+		_quadrics[iter->first.second] += q;
+	}
+
+	for(EdgeMap::const_iterator iter = edges.begin(); iter != edges.end(); ++iter)
+	{ _push_edge(iter->first.first, iter->first.second); }
+}
+
+void
+QuadricSimplifier::simplify(size_t target_triangles, double max_error)
+{
+	double max_cost = (max_error < 0 ? std::numeric_limits<double>::max() : max_error*max_error);
+
+	while(_n_live > target_triangles && !_heap.empty())
+	{
+		Collapse c = _heap.top();
+		// Costs only grow so the rest are over the limit too
+		if(c.cost > max_cost)
+		{ break; }
+		_heap.pop();
+
+		if(!_alive_vertices[c.from] || !_alive_vertices[c.to]
+			|| _versions[c.from] != c.from_version || _versions[c.to] != c.to_version)
+		{ continue; }
+
+		if(!_valid(c.from, c.to))
+		{ continue; }
+
+		_collapse(c.from, c.to);
+	}
+}
+
+void
+QuadricSimplifier::getIndices(std::vector<uint32_t> &out) const
+{
+	out.clear();
+	out.reserve(_n_live*3);
+	for(size_t t = 0; t < _alive_tris.size(); ++t)
+	{
+		if(_alive_tris[t])
+		{ out.insert(out.end(), _tris.begin() + 3*t, _tris.begin() + 3*t + 3); }
+	}
+}
+
+void
+QuadricSimplifier::_push_edge(uint32_t a, uint32_t b)
+{
+	Quadric q = _quadrics[a] + _quadrics[b];
+	double cost_ab = q.error(_positions[b]);
+	double cost_ba = q.error(_positions[a]);
+
+	Collapse c;
+	c.cost = std::min(cost_ab, cost_ba);
+	c.from = (cost_ab <= cost_ba ? a : b);
+	c.to = (cost_ab <= cost_ba ? b : a);
+	c.from_version = _versions[c.from];
+	c.to_version = _versions[c.to];
+	_heap.push(c);
+}
+
+bool
+QuadricSimplifier::_valid(uint32_t from, uint32_t to) const
+{
+	std::vector<uint32_t> const &tris = _vertex_tris[from];
+	for(size_t i = 0; i < tris.size(); ++i)
+	{
+		uint32_t t = tris[i];
+		if(!_alive_tris[t] || _contains(t, to))
+		{ continue; }
+
+		Ogre::Vector3 p[3];
+		Ogre::Vector3 moved[3];
+		for(size_t k = 0; k < 3; ++k)
+		{
+			uint32_t v = _canon[_tris[3*t+k]];
+			p[k] = _positions[v];
+			moved[k] = (v == from ? _positions[to] : p[k]);
+		}
+
+		Ogre::Vector3 n0 = (p[1] - p[0]).crossProduct(p[2] - p[0]);
+		Ogre::Vector3 n1 = (moved[1] - moved[0]).crossProduct(moved[2] - moved[0]);
+		if(n1.dotProduct(n0) <= MIN_NORMAL_COS*n0.length()*n1.length())
+		{ return false; }
+	}
+
+	return true;
+}
+
+void
+QuadricSimplifier::_collapse(uint32_t from, uint32_t to)
+{
+	// Triangles on the collapsed edge tell which original vertices
+	// correspond to each other across attribute seams
+	std::vector< std::pair<uint32_t, uint32_t> > corners;
+	std::vector<uint32_t> &tris = _vertex_tris[from];
+	for(size_t i = 0; i < tris.size(); ++i)
+	{
+		uint32_t t = tris[i];
+		if(!_alive_tris[t] || !_contains(t, to))
+		{ continue; }
+
+		uint32_t from_corner = 0;
+		uint32_t to_corner = 0;
+		for(size_t k = 0; k < 3; ++k)
+		{
+			uint32_t v = _tris[3*t+k];
+			if(_canon[v] == from)
+			{ from_corner = v; }
+			else if(_canon[v] == to)
+			{ to_corner = v; }
+		}
+		corners.push_back(std::make_pair(from_corner, to_corner));
+
+		_alive_tris[t] = 0;
+		--_n_live;
+	}
+
+	for(size_t i = 0; i < tris.size(); ++i)
+	{
+		uint32_t t = tris[i];
+		if(!_alive_tris[t])
+		{ continue; }
+
+		for(size_t k = 0; k < 3; ++k)
+		{
+			uint32_t &v = _tris[3*t+k];
+			if(_canon[v] != from)
+			{ continue; }
+
+			uint32_t replacement = _representative[to];
+			for(size_t j = 0; j < corners.size(); ++j)
+			{
+				if(corners[j].first == v)
+				{
+					replacement = corners[j].second;
+					break;
+				}
+			}
+			v = replacement;
+		}
+		_vertex_tris[to].push_back(t);
+	}
+
+	_quadrics[to] += _quadrics[from];
+	_alive_vertices[from] = 0;
+	++_versions[from];
+	++_versions[to];
+	std::vector<uint32_t>().swap(tris);
+
+	// Remove dead triangles and update the costs of the remaining edges
+	std::vector<uint32_t> &to_tris = _vertex_tris[to];
+	std::vector<uint32_t> neighbours;
+	size_t n = 0;
+	for(size_t i = 0; i < to_tris.size(); ++i)
+	{
+		uint32_t t = to_tris[i];
+		if(!_alive_tris[t])
+		{ continue; }
+
+		to_tris[n++] = t;
+		for(size_t k = 0; k < 3; ++k)
+		{
+			uint32_t v = _canon[_tris[3*t+k]];
+			if(v != to)
+			{ neighbours.push_back(v); }
+		}
+	}
+	to_tris.resize(n);
+
+	std::sort(neighbours.begin(), neighbours.end());
+	neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+	for(size_t i = 0; i < neighbours.size(); ++i)
+	{ _push_edge(to, neighbours[i]); }
+}
+
+bool
+is_descending(std::vector<vl::scalar> const &values)
+{
+	for(size_t i = 1; i < values.size(); ++i)
+	{
+		if(values[i] > values[i-1])
+		{ return false; }
+	}
+	return true;
+}
+
+}	// unamed namespace
+
+void
+vl::generate_lod_levels(vl::Mesh &mesh, vl::MeshLodSettings const &settings)
+{
+	if(settings.reductions.size() != settings.screen_sizes.size())
+	{ BOOST_THROW_EXCEPTION(vl::invalid_param() << vl::desc("LOD reductions and screen sizes need to have the same size.")); }
+
+	if(!is_descending(settings.reductions) || !is_descending(settings.screen_sizes))
+	{ BOOST_THROW_EXCEPTION(vl::invalid_param() << vl::desc("LOD levels need to be in descending order.")); }
+
+	mesh.removeLodLevels();
+	if(settings.reductions.empty())
+	{ return; }
+
+	vl::scalar max_error = -1;
+	if(settings.max_error > 0)
+	{ max_error = settings.max_error*mesh.getBoundingSphereRadius(); }
+
+	// SubMeshes using shared geometry share the positions
+	std::map<vl::VertexData const *, std::vector<Ogre::Vector3> > positions;
+
+	vl::Mesh::SubMeshList &sub_meshes = mesh.getSubMeshes();
+	for(size_t i = 0; i < sub_meshes.size(); ++i)
+	{
+		vl::SubMesh *sm = sub_meshes.at(i);
+		vl::VertexData const *data = (sm->useSharedGeometry ? mesh.sharedVertexData : sm->vertexData);
+
+		std::vector<Ogre::Vector3> *pos = 0;
+		if(data && sm->operationType == Ogre::RenderOperation::OT_TRIANGLE_LIST)
+		{
+			std::map<vl::VertexData const *, std::vector<Ogre::Vector3> >::iterator iter = positions.find(data);
+			if(iter == positions.end())
+			{
+				iter = positions.insert(std::make_pair(data, std::vector<Ogre::Vector3>())).first;
+				read_positions(*data, iter->second);
+			}
+
+			if(!iter->second.empty())
+			{ pos = &iter->second; }
+		}
+
+		// Can't be simplified, use the full detail for all levels
+		if(!pos)
+		{
+			sm->lodIndexData.resize(settings.reductions.size(), sm->indexData);
+			continue;
+		}
+
+		size_t n_tris = sm->indexData.indexCount()/3;
+		QuadricSimplifier simplifier(sm->indexData.getVec(), *pos);
+		for(size_t l = 0; l < settings.reductions.size(); ++l)
+		{
+			simplifier.simplify(size_t(settings.reductions.at(l)*n_tris), max_error);
+
+			sm->lodIndexData.push_back(vl::IndexBuffer());
+			std::vector<uint32_t> &indices = sm->lodIndexData.back().getVec();
+			simplifier.getIndices(indices);
+			optimize_vertex_cache(indices, pos->size());
+		}
+	}
+
+	std::vector<Ogre::Real> values(settings.screen_sizes.begin(), settings.screen_sizes.end());
+	mesh.setLodValues(values);
+	mesh.setLodStrategy(settings.strategy);
+}
+
+std::vector<uint32_t>
+vl::simplify_triangles(std::vector<uint32_t> const &indices,
+	std::vector<Ogre::Vector3> const &positions, size_t target_index_count,
+	vl::scalar max_error)
+{
+	QuadricSimplifier simplifier(indices, positions);
+	simplifier.simplify(target_index_count/3, max_error);
+
+	std::vector<uint32_t> out;
+	simplifier.getIndices(out);
+	return out;
+}
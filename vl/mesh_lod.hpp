@@ -0,0 +1,86 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file mesh_lod.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Automatic LOD generation for vl::Mesh.
+ *
+ *	Triangle lists are simplified with quadric error metric edge collapses
+ *	(Garland and Heckbert). Vertices are only collapsed to other existing
+ *	vertices so every LOD level is an index buffer using the same vertex
+ *	data as the full detail, the same way Ogre stores generated LODs.
+ *
+ *	Vertices sharing a position are simplified together so that texture
+ *	and normal seams don't crack and open borders are kept in place with
+ *	constraint planes.
+ *
+ *	Levels are selected when rendering by ScreenSizeLodStrategy using the
+ *	screen sizes in the settings.
+ */
+
+#ifndef HYDRA_MESH_LOD_HPP
+#define HYDRA_MESH_LOD_HPP
+
+#include "mesh.hpp"
+
+namespace vl
+{
+
+struct MeshLodSettings
+{
+	MeshLodSettings(void)
+		: strategy("ScreenSize")
+		, max_error(0)
+	{
+		reductions.push_back(0.5);
+		screen_sizes.push_back(0.1);
+		reductions.push_back(0.25);
+		screen_sizes.push_back(0.02);
+		reductions.push_back(0.1);
+		screen_sizes.push_back(0.005);
+	}
+
+	/// Fraction of the original triangles to keep for every level,
+	/// descending order
+	std::vector<vl::scalar> reductions;
+
+	/// Fraction of the viewport covered by the mesh below which the level
+	/// is used, descending order and same size as reductions
+	std::vector<vl::scalar> screen_sizes;
+
+	/// Ogre LOD strategy the screen sizes are for
+	std::string strategy;
+
+	/// Maximum error relative to the bounding radius of the mesh,
+	/// levels stop simplifying when reached. Zero for no limit.
+	vl::scalar max_error;
+
+};	// struct MeshLodSettings
+
+/// @brief generate LOD levels for all SubMeshes replacing the old levels
+/// Bounds of the mesh need to be calculated before.
+/// Only triangle lists are simplified, other SubMeshes use the full detail
+/// for all levels.
+void generate_lod_levels(vl::Mesh &mesh, MeshLodSettings const &settings = MeshLodSettings());
+
+/// @brief simplify a triangle list with edge collapses
+/// @param target_index_count number of indices to simplify to
+/// @param max_error maximum distance error, negative for no limit
+/// @return indices of the simplified triangles
+std::vector<uint32_t> simplify_triangles(std::vector<uint32_t> const &indices,
+	std::vector<Ogre::Vector3> const &positions, size_t target_index_count,
+	vl::scalar max_error = -1);
+
+}	// namespace vl
+
+#endif	// HYDRA_MESH_LOD_HPP
@@ -18,6 +18,8 @@
 
 /// Necessary for writing and reading mesh files
 #include "mesh_serializer.hpp"
+/// Necessary for optimizing meshes before writing
+#include "mesh_optimizer.hpp"
 
 /// Necessary for not implemented exception
 #include "base/exceptions.hpp"
@@ -25,6 +27,8 @@
 #include "math/math.hpp"
 
 #include "resource_manager.hpp"
+/// Necessary for finding the mesh file
+#include "base/filesystem.hpp"
 
 // Necessary for comparing sub mesh materials
 #include "material.hpp"
@@ -134,6 +138,11 @@ vl::MasterMeshLoaderCallback::loadMesh(std::string const &fileName, vl::MeshLoad
 	MeshRefPtr mesh(new Mesh(fileName));
 	ser.readMesh(mesh, data);
 
+	// Needed for caching data next to the mesh file
+	std::string path;
+	if(manager->findResource(fs::path(fileName).extension() == ".mesh" ? fileName : fileName + ".mesh", path))
+	{ mesh->setFilePath(path); }
+
 	cb->meshLoaded(mesh);
 }
 
@@ -192,10 +201,20 @@ vl::MeshManager::loadMesh(std::string const &file_name,  MeshLoadedCallback *cb)
 }
 
 void
-vl::MeshManager::writeMesh(vl::MeshRefPtr, std::string const &file_name)
+vl::MeshManager::writeMesh(vl::MeshRefPtr mesh, std::string const &file_name, bool optimize)
 {
-	std::clog << "vl::MeshManager::writeMesh" << std::endl;
-	BOOST_THROW_EXCEPTION(vl::not_implemented());
+	std::clog << "vl::MeshManager::writeMesh : " << file_name << std::endl;
+	if(!mesh)
+	{ BOOST_THROW_EXCEPTION(vl::null_pointer()); }
+
+	if(optimize)
+	{
+		MeshOptimizerReport report = optimize_mesh(*mesh);
+		std::clog << "Optimized mesh " << mesh->getName() << " : " << report << std::endl;
+	}
+
+	MeshSerializer ser;
+	ser.writeMesh(mesh, file_name);
 }
 
 vl::MeshRefPtr
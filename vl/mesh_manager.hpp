@@ -99,8 +99,10 @@ public :
 	/// Master will need a threaded loader which is not supplied for now
 	virtual void loadMesh(std::string const &file_name, MeshLoadedCallback *cb);
 
-	/// @todo not implemented
-	virtual void writeMesh(vl::MeshRefPtr, std::string const &file_name);
+	/// @brief write the mesh to a file in Ogre binary format
+	/// @param optimize run the mesh optimizer with default settings before writing
+	/// the mesh is modified in place
+	virtual void writeMesh(vl::MeshRefPtr mesh, std::string const &file_name, bool optimize = false);
 
 	/// @brief creates a plane mesh
 	/// @param name name for the mesh, used for storing it and writing it into a file
@@ -19,10 +19,13 @@
 
 #include "mesh_ogre.hpp"
 
+#include "lod_strategy.hpp"
+
 #include <OGRE/OgreMesh.h>
 #include <OGRE/OgreSubMesh.h>
 #include <OGRE/OgreDefaultHardwareBufferManager.h>
 #include <OGRE/OgreMeshManager.h>
+#include <OGRE/OgreLodStrategyManager.h>
 
 /// ------------------------------- Global -----------------------------------
 Ogre::MeshPtr
@@ -46,6 +49,9 @@ vl::create_ogre_mesh(std::string const &name, vl::MeshRefPtr mesh)
 	// Convert submeshes
 	convert_ogre_submeshes(mesh.get(), og_mesh.get());
 
+	if(mesh->getNumLodLevels() > 1)
+	{ convert_ogre_lod(mesh.get(), og_mesh.get()); }
+
 	return og_mesh;
 }
 
@@ -107,6 +113,63 @@ vl::convert_ogre_submeshes(vl::Mesh const *mesh, Ogre::Mesh *og_mesh)
     }
 }
 
+void
+vl::convert_ogre_lod(vl::Mesh const *mesh, Ogre::Mesh *og_mesh)
+{
+	assert(mesh && og_mesh);
+	assert(og_mesh->getNumSubMeshes() == mesh->getNumSubMeshes());
+
+	Ogre::LodStrategy *strategy = 0;
+	if(mesh->getLodStrategy() == vl::ScreenSizeLodStrategy::NAME)
+	{ strategy = vl::ScreenSizeLodStrategy::getSingletonPtr(); }
+	else
+	{ strategy = Ogre::LodStrategyManager::getSingleton().getStrategy(mesh->getLodStrategy()); }
+
+	if(!strategy)
+	{
+		std::clog << "LOD strategy " << mesh->getLodStrategy() << " not found, using default." << std::endl;
+		strategy = Ogre::LodStrategyManager::getSingleton().getDefaultStrategy();
+	}
+
+	// Strategy needs to be set before the usages or they are resorted
+	og_mesh->setLodStrategy(strategy);
+
+	std::vector<Ogre::Real> const &values = mesh->getLodValues();
+	og_mesh->_setLodInfo(values.size()+1, false);
+	for(unsigned short l = 1; l < mesh->getNumLodLevels(); ++l)
+	{
+		Ogre::MeshLodUsage usage;
+		usage.userValue = values.at(l-1);
+		usage.value = strategy->transformUserValue(usage.userValue);
+		usage.edgeData = 0;
+		og_mesh->_setLodUsage(l, usage);
+	}
+
+	for(size_t i = 0; i < mesh->getNumSubMeshes(); ++i)
+	{
+		vl::SubMesh const *sm = mesh->getSubMesh(i);
+		for(unsigned short l = 1; l < mesh->getNumLodLevels(); ++l)
+		{
+			// Missing levels use the full detail
+			vl::IndexBuffer const &ib = (size_t(l-1) < sm->lodIndexData.size())
+				? sm->lodIndexData.at(l-1) : sm->indexData;
+
+			// Ogre owns the index data
+			Ogre::IndexData *og_ib = new Ogre::IndexData;
+			og_ib->indexCount = ib.indexCount();
+			if(og_ib->indexCount > 0)
+			{
+				og_ib->indexBuffer = Ogre::HardwareBufferManager::getSingleton().
+					createIndexBuffer(Ogre::HardwareIndexBuffer::IT_32BIT, 
+						og_ib->indexCount, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+				og_ib->indexBuffer->writeData(0, og_ib->indexBuffer->getSizeInBytes(), ib.getBuffer(), true);
+			}
+
+			og_mesh->_setSubMeshLodFaceList(i, l, og_ib);
+		}
+	}
+}
+
 void 
 vl::convert_ogre_submesh(vl::SubMesh const *sm, Ogre::SubMesh *og_sm)
 {
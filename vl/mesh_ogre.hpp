@@ -32,6 +32,9 @@ void convert_ogre_submeshes(vl::Mesh const *mesh, Ogre::Mesh *og_mesh);
 
 void convert_ogre_submesh(vl::SubMesh const *mesh, Ogre::SubMesh *og_sm);
 
+/// @brief copy generated LOD levels, SubMeshes need to be converted first
+void convert_ogre_lod(vl::Mesh const *mesh, Ogre::Mesh *og_mesh);
+
 }	// namespace vl
 
 #endif // HYDRA_MESH_OGRE_HPP
\ No newline at end of file
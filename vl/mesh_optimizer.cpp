@@ -0,0 +1,695 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file mesh_optimizer.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/// Interface
+#include "mesh_optimizer.hpp"
+
+#include "base/exceptions.hpp"
+
+#include <algorithm>
+#include <map>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+
+namespace
+{
+
+uint32_t const INVALID_INDEX = 0xFFFFFFFF;
+
+/// Vertex data and the SubMeshes indexing it
+struct GeometrySet
+{
+	vl::VertexData *data;
+	std::vector<vl::SubMesh *> sub_meshes;
+};
+
+void
+collect_geometry(vl::Mesh &mesh, std::vector<GeometrySet> &sets)
+{
+	GeometrySet shared;
+	shared.data = mesh.sharedVertexData;
+
+	vl::Mesh::SubMeshList &sub_meshes = mesh.getSubMeshes();
+	for(size_t i = 0; i < sub_meshes.size(); ++i)
+	{
+		vl::SubMesh *sm = sub_meshes.at(i);
+		if(sm->useSharedGeometry)
+		{ shared.sub_meshes.push_back(sm); }
+		else if(sm->vertexData)
+		{
+			GeometrySet set;
+			set.data = sm->vertexData;
+			set.sub_meshes.push_back(sm);
+			sets.push_back(set);
+		}
+	}
+
+	if(shared.data && !shared.sub_meshes.empty())
+	{ sets.push_back(shared); }
+
+	for(size_t i = 0; i < sets.size(); ++i)
+	{
+		size_t n_vertices = sets.at(i).data->getVertexCount();
+		for(size_t j = 0; j < sets.at(i).sub_meshes.size(); ++j)
+		{
+			std::vector<uint32_t> const &indices = sets.at(i).sub_meshes.at(j)->indexData.getVec();
+			for(size_t k = 0; k < indices.size(); ++k)
+			{
+				if(indices[k] >= n_vertices)
+				{ BOOST_THROW_EXCEPTION(vl::bad_index() << vl::desc("Mesh " + mesh.getName() + " index out of range.")); }
+			}
+		}
+	}
+}
+
+bool
+is_triangle_list(vl::SubMesh const *sm)
+{ return sm->operationType == Ogre::RenderOperation::OT_TRIANGLE_LIST; }
+
+/// Post transform cache simulation, a vertex is in the cache if it
+/// has been added during the last cache_size misses.
+class FifoCache
+{
+public :
+	FifoCache(size_t n_vertices, size_t cache_size)
+		: _stamps(n_vertices, 0)
+		, _time(cache_size+1)
+		, _cache_size(cache_size)
+	{}
+
+	/// @return true if the vertex was not in the cache
+	bool access(uint32_t v)
+	{
+		if(_time - _stamps[v] > _cache_size)
+		{
+			_stamps[v] = _time++;
+			return true;
+		}
+		return false;
+	}
+
+	/// @brief empty the cache
+	void flush(void)
+	{ _time += _cache_size+1; }
+
+private :
+	std::vector<size_t> _stamps;
+	size_t _time;
+	size_t _cache_size;
+};
+
+size_t
+count_cache_misses(std::vector<uint32_t> const &indices, size_t cache_size)
+{
+	if(indices.empty())
+	{ return 0; }
+
+	FifoCache cache(*std::max_element(indices.begin(), indices.end())+1, cache_size);
+	size_t misses = 0;
+	for(size_t i = 0; i < indices.size(); ++i)
+	{
+		if(cache.access(indices[i]))
+		{ ++misses; }
+	}
+	return misses;
+}
+
+size_t
+vertex_data_size(vl::VertexData const *data)
+{
+	size_t bytes = 0;
+	for(std::map<size_t, vl::VertexBufferRefPtr>::const_iterator iter = data->_bindings.begin();
+		iter != data->_bindings.end(); ++iter)
+	{ bytes += iter->second->size(); }
+	return bytes;
+}
+
+void
+gather_statistics(vl::Mesh const &mesh, size_t cache_size, size_t &vertices,
+	size_t &triangles, double &acmr, size_t &bytes)
+{
+	vertices = 0;
+	triangles = 0;
+	bytes = 0;
+	size_t misses = 0;
+
+	if(mesh.sharedVertexData)
+	{
+		vertices += mesh.sharedVertexData->getVertexCount();
+		bytes += vertex_data_size(mesh.sharedVertexData);
+	}
+
+	vl::Mesh::SubMeshList const &sub_meshes = mesh.getSubMeshes();
+	for(size_t i = 0; i < sub_meshes.size(); ++i)
+	{
+		vl::SubMesh const *sm = sub_meshes.at(i);
+		if(!sm->useSharedGeometry && sm->vertexData)
+		{
+			vertices += sm->vertexData->getVertexCount();
+			bytes += vertex_data_size(sm->vertexData);
+		}
+
+		bytes += sm->indexData.indexCount()*sizeof(uint32_t);
+		if(is_triangle_list(sm))
+		{
+			triangles += sm->indexData.indexCount()/3;
+			misses += count_cache_misses(sm->indexData.getVec(), cache_size);
+		}
+	}
+
+	acmr = (triangles > 0 ? double(misses)/triangles : 0);
+}
+
+/// @brief copy vertices to new buffers
+/// @param remap new index for every old vertex, INVALID_INDEX to remove
+/// if multiple vertices map to the same index the first one is used
+void
+remap_vertex_data(vl::VertexData &data, std::vector<uint32_t> const &remap, size_t n_vertices)
+{
+	std::vector<bool> written(n_vertices);
+	for(std::map<size_t, vl::VertexBufferRefPtr>::iterator iter = data._bindings.begin();
+		iter != data._bindings.end(); ++iter)
+	{
+		vl::VertexBufferRefPtr old_buf = iter->second;
+		size_t vertex_size = old_buf->getVertexSize();
+		vl::VertexBufferRefPtr buf = vl::VertexBuffer::create(vertex_size, n_vertices);
+
+		std::fill(written.begin(), written.end(), false);
+		for(size_t i = 0; i < old_buf->getNVertices(); ++i)
+		{
+			uint32_t r = remap[i];
+			if(r != INVALID_INDEX && !written[r])
+			{
+				::memcpy(buf->_buffer + r*vertex_size, old_buf->_buffer + i*vertex_size, vertex_size);
+				written[r] = true;
+			}
+		}
+
+		iter->second = buf;
+	}
+}
+
+/// @brief find duplicated vertices
+/// @param tolerance if larger than zero float3 positions are quantized to the
+/// tolerance before comparing
+/// @return number of unique vertices
+size_t
+generate_weld_remap(vl::VertexData const &data, vl::scalar tolerance, std::vector<uint32_t> &remap)
+{
+	size_t n = data.getVertexCount();
+	remap.assign(n, INVALID_INDEX);
+
+	bool quantize = false;
+	size_t pos_source = 0;
+	size_t pos_offset = 0;
+	if(tolerance > 0 && data.vertexDeclaration.hasSemantic(Ogre::VES_POSITION))
+	{
+		Ogre::VertexElement elem = data.vertexDeclaration.getVertexElement(Ogre::VES_POSITION);
+		if(elem.getType() == Ogre::VET_FLOAT3)
+		{
+			quantize = true;
+			pos_source = elem.getSource();
+			pos_offset = elem.getOffset();
+		}
+	}
+
+	// Key is the vertex from all bindings
+	std::map<std::string, uint32_t> unique;
+	std::string key;
+	for(size_t i = 0; i < n; ++i)
+	{
+		key.clear();
+		for(std::map<size_t, vl::VertexBufferRefPtr>::const_iterator iter = data._bindings.begin();
+			iter != data._bindings.end(); ++iter)
+		{
+			vl::VertexBuffer const &buf = *iter->second;
+			char const *vertex = buf._buffer + i*buf.getVertexSize();
+			if(quantize && iter->first == pos_source)
+			{
+				float pos[3];
+				::memcpy(pos, vertex + pos_offset, sizeof(pos));
+				key.append(vertex, pos_offset);
+				for(size_t k = 0; k < 3; ++k)
+				{
+					long q = long(std::floor(pos[k]/tolerance + 0.5));
+					key.append(reinterpret_cast<char const *>(&q), sizeof(q));
+				}
+				key.append(vertex + pos_offset + sizeof(pos), buf.getVertexSize() - pos_offset - sizeof(pos));
+			}
+			else
+			{ key.append(vertex, buf.getVertexSize()); }
+		}
+
+		std::pair<std::map<std::string, uint32_t>::iterator, bool> res
+			= unique.insert(std::make_pair(key, uint32_t(unique.size())));
+		remap[i] = res.first->second;
+	}
+
+	return unique.size();
+}
+
+void
+weld_vertices(GeometrySet &set, vl::scalar tolerance)
+{
+	std::vector<uint32_t> remap;
+	size_t n_unique = generate_weld_remap(*set.data, tolerance, remap);
+	// Degenerate triangles are removed even if there is nothing to weld
+	if(n_unique != set.data->getVertexCount())
+	{ remap_vertex_data(*set.data, remap, n_unique); }
+
+	for(size_t i = 0; i < set.sub_meshes.size(); ++i)
+	{
+		vl::SubMesh *sm = set.sub_meshes.at(i);
+		std::vector<uint32_t> &indices = sm->indexData.getVec();
+		for(size_t j = 0; j < indices.size(); ++j)
+		{ indices[j] = remap[indices[j]]; }
+
+		// Welding collapses triangles
+		if(is_triangle_list(sm))
+		{
+			size_t n = 0;
+			for(size_t j = 0; j+2 < indices.size(); j += 3)
+			{
+				uint32_t a = indices[j], b = indices[j+1], c = indices[j+2];
+				if(a != b && b != c && a != c)
+				{
+					indices[n++] = a;
+					indices[n++] = b;
+					indices[n++] = c;
+				}
+			}
+			indices.resize(n);
+		}
+	}
+}
+
+/// Forsyth, Linear-Speed Vertex Cache Optimisation
+/// The cache is modelled as LRU, which works well for the FIFO caches too.
+size_t const FORSYTH_CACHE_SIZE = 32;
+
+float
+forsyth_vertex_score(int cache_position, uint32_t remaining)
+{
+	// No triangles left, never chosen
+	if(remaining == 0)
+	{ return -1.0f; }
+
+	float score = 0;
+	if(cache_position >= 0)
+	{
+		// Vertices of the last triangle are penalized so that strips
+		// don't go back and forth
+		if(cache_position < 3)
+		{ score = 0.75f; }
+		else
+		{
+			float scaler = 1.0f/(FORSYTH_CACHE_SIZE-3);
+			score = std::pow(1.0f - (cache_position-3)*scaler, 1.5f);
+		}
+	}
+
+	// Prefer finishing vertices with few triangles left
+	score += 2.0f*std::pow(float(remaining), -0.5f);
+	return score;
+}
+
+struct ClusterOrder
+{
+	float sort_key;
+	uint32_t cluster;
+
+	/// Descending order
+	bool operator<(ClusterOrder const &other) const
+	{ return sort_key > other.sort_key; }
+};
+
+/// Sander et al. Fast Triangle Reordering for Vertex Locality and Reduced Overdraw
+/// Splits the cache optimized triangles into clusters and sorts the clusters
+/// so that the ones facing away from the center of the mesh are drawn first.
+void
+optimize_overdraw(std::vector<uint32_t> &indices, std::vector<Ogre::Vector3> const &positions,
+	size_t cache_size, double threshold)
+{
+	size_t n_tris = indices.size()/3;
+	if(n_tris < 2)
+	{ return; }
+
+	FifoCache cache(positions.size(), cache_size);
+
+	// Hard boundaries where the cache has nothing useful
+	std::vector<uint32_t> hard;
+	for(size_t t = 0; t < n_tris; ++t)
+	{
+		size_t misses = 0;
+		for(size_t k = 0; k < 3; ++k)
+		{
+			if(cache.access(indices[3*t+k]))
+			{ ++misses; }
+		}
+		if(t == 0 || misses == 3)
+		{ hard.push_back(uint32_t(t)); }
+	}
+	hard.push_back(uint32_t(n_tris));
+
+	// Split the clusters further as long as the ACMR of the pieces stays
+	// within the threshold of the whole cluster
+	std::vector<uint32_t> clusters;
+	for(size_t c = 0; c+1 < hard.size(); ++c)
+	{
+		size_t begin = hard[c];
+		size_t end = hard[c+1];
+
+		cache.flush();
+		size_t misses = 0;
+		for(size_t i = begin*3; i < end*3; ++i)
+		{
+			if(cache.access(indices[i]))
+			{ ++misses; }
+		}
+		double cluster_threshold = threshold*double(misses)/(end - begin);
+
+		cache.flush();
+		clusters.push_back(uint32_t(begin));
+		size_t start = begin;
+		misses = 0;
+		for(size_t t = begin; t < end; ++t)
+		{
+			for(size_t k = 0; k < 3; ++k)
+			{
+				if(cache.access(indices[3*t+k]))
+				{ ++misses; }
+			}
+
+			if(t+1 < end && double(misses)/(t - start + 1) <= cluster_threshold)
+			{
+				clusters.push_back(uint32_t(t+1));
+				start = t+1;
+				misses = 0;
+				cache.flush();
+			}
+		}
+	}
+	clusters.push_back(uint32_t(n_tris));
+
+	// Area weighted centroids and normals
+	std::vector<Ogre::Vector3> centroids(clusters.size()-1, Ogre::Vector3::ZERO);
+	std::vector<Ogre::Vector3> normals(clusters.size()-1, Ogre::Vector3::ZERO);
+	std::vector<float> areas(clusters.size()-1, 0);
+	Ogre::Vector3 mesh_centroid(Ogre::Vector3::ZERO);
+	float mesh_area = 0;
+	for(size_t c = 0; c+1 < clusters.size(); ++c)
+	{
+		for(size_t t = clusters[c]; t < clusters[c+1]; ++t)
+		{
+			Ogre::Vector3 const &p0 = positions[indices[3*t]];
+			Ogre::Vector3 const &p1 = positions[indices[3*t+1]];
+			Ogre::Vector3 const &p2 = positions[indices[3*t+2]];
+			Ogre::Vector3 n = (p1 - p0).crossProduct(p2 - p0);
+			float area = n.length();
+
+			centroids[c] += (p0 + p1 + p2)*(area/3);
+			normals[c] += n;
+			areas[c] += area;
+		}
+
+		mesh_centroid += centroids[c];
+		mesh_area += areas[c];
+	}
+
+	if(mesh_area > 0)
+	{ mesh_centroid /= mesh_area; }
+
+	std::vector<ClusterOrder> order(clusters.size()-1);
+	for(size_t c = 0; c < order.size(); ++c)
+	{
+		Ogre::Vector3 centroid = (areas[c] > 0 ? centroids[c]/areas[c] : Ogre::Vector3::ZERO);
+		order[c].sort_key = (centroid - mesh_centroid).dotProduct(normals[c].normalisedCopy());
+		order[c].cluster = uint32_t(c);
+	}
+	std::stable_sort(order.begin(), order.end());
+
+	std::vector<uint32_t> out;
+	out.reserve(n_tris*3);
+	for(size_t i = 0; i < order.size(); ++i)
+	{
+		uint32_t c = order[i].cluster;
+		out.insert(out.end(), indices.begin() + clusters[c]*3, indices.begin() + clusters[c+1]*3);
+	}
+
+	indices.swap(out);
+}
+
+/// @brief reorder vertices in the order they are first used and remove
+/// unused vertices
+void
+optimize_vertex_fetch(GeometrySet &set)
+{
+	size_t n = set.data->getVertexCount();
+	std::vector<uint32_t> remap(n, INVALID_INDEX);
+	uint32_t next = 0;
+	bool identity = true;
+	for(size_t i = 0; i < set.sub_meshes.size(); ++i)
+	{
+		std::vector<uint32_t> &indices = set.sub_meshes.at(i)->indexData.getVec();
+		for(size_t j = 0; j < indices.size(); ++j)
+		{
+			uint32_t &r = remap[indices[j]];
+			if(r == INVALID_INDEX)
+			{
+				if(next != indices[j])
+				{ identity = false; }
+				r = next++;
+			}
+			indices[j] = r;
+		}
+	}
+
+	if(!identity || next != n)
+	{ remap_vertex_data(*set.data, remap, next); }
+}
+
+}	// unamed namespace
+
+std::ostream &
+vl::operator<<(std::ostream &os, vl::MeshOptimizerReport const &report)
+{
+	os << "vertices " << report.vertices_before << " -> " << report.vertices_after
+		<< " : triangles " << report.triangles_before << " -> " << report.triangles_after
+		<< " : ACMR " << report.acmr_before << " -> " << report.acmr_after
+		<< " : bytes " << report.bytes_before << " -> " << report.bytes_after;
+
+	return os;
+}
+
+vl::MeshOptimizerReport
+vl::optimize_mesh(vl::Mesh &mesh, vl::MeshOptimizerSettings const &settings)
+{
+	MeshOptimizerReport report;
+	gather_statistics(mesh, settings.cache_size, report.vertices_before,
+		report.triangles_before, report.acmr_before, report.bytes_before);
+
+	// Levels would reference the old vertices, generate them after optimizing
+	if(mesh.getNumLodLevels() > 1)
+	{
+		std::clog << "vl::optimize_mesh : removing LOD levels from " << mesh.getName() << std::endl;
+		mesh.removeLodLevels();
+	}
+
+	std::vector<GeometrySet> sets;
+	collect_geometry(mesh, sets);
+
+	std::vector<Ogre::Vector3> positions;
+	for(size_t i = 0; i < sets.size(); ++i)
+	{
+		GeometrySet &set = sets.at(i);
+
+		if(settings.weld_vertices)
+		{ weld_vertices(set, settings.weld_tolerance); }
+
+		bool has_positions = settings.optimize_overdraw && read_positions(*set.data, positions);
+		for(size_t j = 0; j < set.sub_meshes.size(); ++j)
+		{
+			SubMesh *sm = set.sub_meshes.at(j);
+			if(!is_triangle_list(sm))
+			{ continue; }
+
+			if(settings.optimize_vertex_cache)
+			{ optimize_vertex_cache(sm->indexData.getVec(), set.data->getVertexCount()); }
+
+			if(has_positions)
+			{
+				optimize_overdraw(sm->indexData.getVec(), positions,
+					settings.cache_size, settings.overdraw_threshold);
+			}
+		}
+
+		if(settings.optimize_vertex_fetch)
+		{ optimize_vertex_fetch(set); }
+	}
+
+	gather_statistics(mesh, settings.cache_size, report.vertices_after,
+		report.triangles_after, report.acmr_after, report.bytes_after);
+
+	return report;
+}
+
+double
+vl::calculate_acmr(std::vector<uint32_t> const &indices, size_t cache_size)
+{
+	if(indices.size() < 3)
+	{ return 0; }
+
+	return double(count_cache_misses(indices, cache_size))/(indices.size()/3);
+}
+
+double
+vl::calculate_acmr(vl::Mesh const &mesh, size_t cache_size)
+{
+	size_t vertices, triangles, bytes;
+	double acmr;
+	gather_statistics(mesh, cache_size, vertices, triangles, acmr, bytes);
+	return acmr;
+}
+
+void
+vl::optimize_vertex_cache(std::vector<uint32_t> &indices, size_t n_vertices)
+{
+	size_t n_tris = indices.size()/3;
+	if(n_tris < 2)
+	{ return; }
+
+	// Triangles of every vertex, active ones are in the front
+	std::vector<uint32_t> remaining(n_vertices, 0);
+	for(size_t i = 0; i < n_tris*3; ++i)
+	{ ++remaining[indices[i]]; }
+
+	std::vector<uint32_t> offsets(n_vertices+1, 0);
+	for(size_t v = 0; v < n_vertices; ++v)
+	{ offsets[v+1] = offsets[v] + remaining[v]; }
+
+	std::vector<uint32_t> adjacency(n_tris*3);
+	std::vector<uint32_t> fill(offsets.begin(), offsets.end()-1);
+	for(size_t i = 0; i < n_tris*3; ++i)
+	{ adjacency[fill[indices[i]]++] = uint32_t(i/3); }
+
+	std::vector<int> cache_position(n_vertices, -1);
+	std::vector<float> vertex_score(n_vertices);
+	for(size_t v = 0; v < n_vertices; ++v)
+	{ vertex_score[v] = forsyth_vertex_score(-1, remaining[v]); }
+
+	std::vector<float> tri_score(n_tris);
+	std::vector<uint8_t> emitted(n_tris, 0);
+	int best = 0;
+	for(size_t t = 0; t < n_tris; ++t)
+	{
+		tri_score[t] = vertex_score[indices[3*t]] + vertex_score[indices[3*t+1]]
+			+ vertex_score[indices[3*t+2]];
+		if(tri_score[t] > tri_score[best])
+		{ best = int(t); }
+	}
+
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> new_cache;
+	std::vector<uint32_t> out;
+	out.reserve(n_tris*3);
+	size_t cursor = 0;
+	for(size_t i = 0; i < n_tris; ++i)
+	{
+		// Nothing in the cache has triangles left, take the next one in order
+		if(best < 0)
+		{
+			while(emitted[cursor])
+			{ ++cursor; }
+			best = int(cursor);
+		}
+
+		emitted[best] = 1;
+		new_cache.clear();
+		for(size_t k = 0; k < 3; ++k)
+		{
+			uint32_t v = indices[3*best+k];
+			out.push_back(v);
+
+			if(std::find(new_cache.begin(), new_cache.end(), v) == new_cache.end())
+			{ new_cache.push_back(v); }
+
+			// Move the triangle out of the active range
+			uint32_t *begin = &adjacency[offsets[v]];
+			uint32_t *end = begin + remaining[v];
+			std::swap(*std::find(begin, end, uint32_t(best)), *(end-1));
+			--remaining[v];
+		}
+
+		for(size_t j = 0; j < cache.size(); ++j)
+		{
+			if(std::find(new_cache.begin(), new_cache.end(), cache[j]) == new_cache.end())
+			{ new_cache.push_back(cache[j]); }
+		}
+
+		// Vertices pushed out of the cache are updated too
+		for(size_t j = 0; j < new_cache.size(); ++j)
+		{
+			uint32_t v = new_cache[j];
+			cache_position[v] = (j < FORSYTH_CACHE_SIZE ? int(j) : -1);
+			vertex_score[v] = forsyth_vertex_score(cache_position[v], remaining[v]);
+		}
+
+		best = -1;
+		float best_score = -1;
+		for(size_t j = 0; j < new_cache.size(); ++j)
+		{
+			uint32_t v = new_cache[j];
+			for(size_t a = offsets[v]; a < offsets[v] + remaining[v]; ++a)
+			{
+				uint32_t t = adjacency[a];
+				tri_score[t] = vertex_score[indices[3*t]] + vertex_score[indices[3*t+1]]
+					+ vertex_score[indices[3*t+2]];
+				if(tri_score[t] > best_score)
+				{
+					best_score = tri_score[t];
+					best = int(t);
+				}
+			}
+		}
+
+		if(new_cache.size() > FORSYTH_CACHE_SIZE)
+		{ new_cache.resize(FORSYTH_CACHE_SIZE); }
+		cache.swap(new_cache);
+	}
+
+	indices.swap(out);
+}
+
+bool
+vl::read_positions(vl::VertexData const &data, std::vector<Ogre::Vector3> &positions)
+{
+	if(!data.vertexDeclaration.hasSemantic(Ogre::VES_POSITION))
+	{ return false; }
+
+	Ogre::VertexElement elem = data.vertexDeclaration.getVertexElement(Ogre::VES_POSITION);
+	VertexBufferConstRefPtr buf = data.getBuffer(elem.getSource());
+	if(elem.getType() != Ogre::VET_FLOAT3 || !buf)
+	{ return false; }
+
+	positions.resize(buf->getNVertices());
+	for(size_t i = 0; i < positions.size(); ++i)
+	{
+		float pos[3];
+		buf->read(i*buf->getVertexSize() + elem.getOffset(), pos, sizeof(pos));
+		positions[i] = Ogre::Vector3(pos[0], pos[1], pos[2]);
+	}
+
+	return true;
+}
@@ -0,0 +1,127 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file mesh_optimizer.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Optimization passes for vl::Mesh.
+ *
+ *	Meshes from CAD exporters have duplicated vertices and triangles in
+ *	whatever order the tool wrote them, which wastes memory and the post
+ *	transform vertex cache. Passes are run in order on every vertex data
+ *	and the SubMeshes using it:
+ *	- welding, removes duplicated vertices and degenerate triangles
+ *	- vertex cache, reorders triangles for the post transform cache
+ *	  (Forsyth's linear speed algorithm)
+ *	- overdraw, reorders clusters of triangles so that the outermost are
+ *	  drawn first without losing much of the cache efficiency
+ *	- vertex fetch, reorders vertices in the order they are used and
+ *	  removes unused vertices
+ *
+ *	Cache and overdraw passes only handle triangle lists, other operation
+ *	types are welded and remapped.
+ */
+
+#ifndef HYDRA_MESH_OPTIMIZER_HPP
+#define HYDRA_MESH_OPTIMIZER_HPP
+
+#include "mesh.hpp"
+
+#include <iosfwd>
+
+namespace vl
+{
+
+struct MeshOptimizerSettings
+{
+	MeshOptimizerSettings(void)
+		: weld_vertices(true)
+		, weld_tolerance(0)
+		, optimize_vertex_cache(true)
+		, optimize_overdraw(true)
+		, overdraw_threshold(1.05)
+		, optimize_vertex_fetch(true)
+		, cache_size(16)
+	{}
+
+	bool weld_vertices;
+
+	/// Positions closer than this are welded, zero welds only exact duplicates.
+	/// All other attributes need to be identical.
+	vl::scalar weld_tolerance;
+
+	bool optimize_vertex_cache;
+
+	bool optimize_overdraw;
+
+	/// How much the ACMR is allowed to grow when splitting clusters for
+	/// overdraw sorting, 1.05 allows 5% more cache misses
+	double overdraw_threshold;
+
+	bool optimize_vertex_fetch;
+
+	/// FIFO cache size used for the ACMR and overdraw clusters
+	size_t cache_size;
+
+};	// struct MeshOptimizerSettings
+
+struct MeshOptimizerReport
+{
+	MeshOptimizerReport(void)
+		: vertices_before(0), vertices_after(0)
+		, triangles_before(0), triangles_after(0)
+		, acmr_before(0), acmr_after(0)
+		, bytes_before(0), bytes_after(0)
+	{}
+
+	size_t vertices_before;
+	size_t vertices_after;
+
+	size_t triangles_before;
+	size_t triangles_after;
+
+	/// Average cache miss ratio, transformed vertices per triangle
+	double acmr_before;
+	double acmr_after;
+
+	/// Size of vertex and index buffers
+	size_t bytes_before;
+	size_t bytes_after;
+
+};	// struct MeshOptimizerReport
+
+std::ostream &operator<<(std::ostream &os, MeshOptimizerReport const &report);
+
+/// @brief optimize the mesh in place
+/// Bounds are not affected, welding only removes vertices.
+/// LOD levels are removed, generate them after optimizing.
+/// @return statistics before and after the optimization
+MeshOptimizerReport optimize_mesh(vl::Mesh &mesh,
+	MeshOptimizerSettings const &settings = MeshOptimizerSettings());
+
+/// @brief average cache miss ratio of a triangle list with a FIFO cache
+double calculate_acmr(std::vector<uint32_t> const &indices, size_t cache_size);
+
+/// @brief average cache miss ratio of all triangle lists in the mesh
+double calculate_acmr(vl::Mesh const &mesh, size_t cache_size);
+
+/// @brief reorder a triangle list for the post transform vertex cache
+/// @param n_vertices number of vertices in the vertex data indexed
+void optimize_vertex_cache(std::vector<uint32_t> &indices, size_t n_vertices);
+
+/// @brief copy float3 positions from vertex data
+/// @return false if there is no float3 position element
+bool read_positions(vl::VertexData const &data, std::vector<Ogre::Vector3> &positions);
+
+}	// namespace vl
+
+#endif	// HYDRA_MESH_OPTIMIZER_HPP
@@ -16,6 +16,8 @@
 
 #include "mesh_serializer.hpp"
 
+#include <fstream>
+
 const unsigned short HEADER_CHUNK_ID = 0x1000;
 
 vl::MeshSerializer::MeshSerializer(void)
@@ -41,9 +43,28 @@ vl::MeshSerializer::createMesh(void)
 void 
 vl::MeshSerializer::writeMesh(vl::MeshRefPtr mesh, std::string const &filename)
 {
-	Ogre::MeshPtr og_mesh = vl::create_ogre_mesh("conversion", mesh);
-	Ogre::MeshSerializer ser;
-	ser.exportMesh(og_mesh.get(), filename);
+	if(!_encoding.encoded())
+	{
+		Ogre::MeshPtr og_mesh = vl::create_ogre_mesh("conversion", mesh);
+		Ogre::MeshSerializer ser;
+		ser.exportMesh(og_mesh.get(), filename);
+		return;
+	}
+
+	vl::Resource res(filename);
+	ResourceStream stream = res.getStream();
+	MeshSerializerImpl impl;
+	impl.setEncoding(_encoding);
+	impl.exportMesh(mesh.get(), stream);
+
+	// Resources are NULL terminated
+	std::ofstream ofs(filename.c_str(), std::ios::binary);
+	if(!ofs)
+	{
+		std::string msg("Couldn't open " + filename + " for writing.");
+		BOOST_THROW_EXCEPTION(vl::exception() << vl::desc(msg));
+	}
+	ofs.write(res.get(), res.size()-1);
 }
 
 void
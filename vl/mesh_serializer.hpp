@@ -55,10 +55,20 @@ public :
 
 	vl::MeshRefPtr createMesh(void);
 
+	/// @brief write the mesh to a file
+	/// Plain meshes are written with Ogre so that they can be used by Ogre tools,
+	/// encoded meshes are written with MeshSerializerImpl.
 	void writeMesh(vl::MeshRefPtr mesh, std::string const &filename);
 
 	void readMesh(vl::MeshRefPtr mesh, vl::Resource &res);
 
+	/// @brief vertex and index encodings used when writing
+	void setEncoding(MeshEncodingSettings const &settings)
+	{ _encoding = settings; }
+
+	MeshEncodingSettings const &getEncoding(void) const
+	{ return _encoding; }
+
 private :
 	/// Wrapper around Ogre Managers, created if Ogre is not initialised
 	struct OgreManagers {
@@ -78,6 +88,8 @@ private :
 
 	OgreManagers *_ogre_mgr;
 
+	MeshEncodingSettings _encoding;
+
 };	// class MeshWriter
 
 }	// namespace vl
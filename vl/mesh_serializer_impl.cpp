@@ -42,6 +42,8 @@ THE SOFTWARE.
 
 #include "base/exceptions.hpp"
 
+#include <algorithm>
+
 
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
 // Disable conversion warnings, we do a lot of them, intentionally
@@ -51,6 +53,8 @@ THE SOFTWARE.
 /// stream overhead = ID + size
 const long STREAM_OVERHEAD_SIZE = sizeof(uint16_t) + sizeof(uint32_t);
 
+std::string const vl::MESH_ENCODED_VERSION = "[MeshSerializer_v1.8_hydra_encoded]";
+
 /// ----------------------- MeshSerializerImpl -------------------------------
 vl::MeshSerializerImpl::MeshSerializerImpl()
 {
@@ -71,6 +75,9 @@ vl::MeshSerializerImpl::exportMesh(vl::Mesh const *pMesh, vl::ResourceStream &st
 	// Decide on endian mode
 	determineEndianness(endianMode);
 
+	// Ogre can't read encoded files so they need a different version
+	mVersion = mEncoding.encoded() ? MESH_ENCODED_VERSION : "[MeshSerializer_v1.8]";
+
     // Check that the mesh has it's bounds set
     if (pMesh->getBounds().isNull() || pMesh->getBoundingSphereRadius() == 0.0f)
     {
@@ -128,193 +135,107 @@ vl::MeshSerializerImpl::importMesh(vl::ResourceStream &stream, vl::Mesh *pMesh)
 void 
 vl::MeshSerializerImpl::writeMesh(vl::Mesh const *pMesh)
 {
-	std::clog << "vl::MeshSerializerImpl::writeMesh" << std::endl;
-    // Header
-    writeChunkHeader(Ogre::M_MESH, calcMeshSize(pMesh));
+	// Header
+	size_t chunk = beginChunk(Ogre::M_MESH);
 
 	// bool skeletallyAnimated
-	bool skelAnim = false; //pMesh->hasSkeleton();
+	bool skelAnim = false;
 	writeBools(&skelAnim, 1);
 
-    // Write shared geometry
+	// Write shared geometry
 	if(pMesh->sharedVertexData && pMesh->sharedVertexData->getVertexCount())
-		writeGeometry(pMesh, pMesh->sharedVertexData);
+	{ writeGeometry(pMesh, pMesh->sharedVertexData); }
 
-    // Write Submeshes
-    for (unsigned short i = 0; i < pMesh->getNumSubMeshes(); ++i)
-    {
-        std::cout << "Writing submesh..." << std::endl;
-        writeSubMesh(pMesh->getSubMesh(i));
-        std::cout << "Submesh exported." << std::endl;
-    }
+	// Write Submeshes
+	for(unsigned short i = 0; i < pMesh->getNumSubMeshes(); ++i)
+	{ writeSubMesh(pMesh->getSubMesh(i)); }
 
-    // Write skeleton info if required
-	/*	Skeletons are not supported
-    if (pMesh->hasSkeleton())
-    {
-        LogManager::getSingleton().logMessage("Exporting skeleton link...");
-        // Write skeleton link
-        writeSkeletonLink(pMesh->getSkeletonName());
-        LogManager::getSingleton().logMessage("Skeleton link exported.");
+	// Skeletons, edge lists, animations and extremes are not supported
 
-        // Write bone assignments
-        if (!pMesh->mBoneAssignments.empty())
-        {
-            LogManager::getSingleton().logMessage("Exporting shared geometry bone assignments...");
+	// Write LOD data if any
+	if(pMesh->getNumLodLevels() > 1)
+	{ writeLodInfo(pMesh); }
 
-            Mesh::VertexBoneAssignmentList::const_iterator vi;
-            for (vi = pMesh->mBoneAssignments.begin();
-            vi != pMesh->mBoneAssignments.end(); ++vi)
-            {
-                writeMeshBoneAssignment(vi->second);
-            }
-
-            LogManager::getSingleton().logMessage("Shared geometry bone assignments exported.");
-        }
-    }
-
-    // Write LOD data if any
-	/*	LOD not supported
-    if (pMesh->getNumLodLevels() > 1)
-    {
-        std::cout << "Exporting LOD information...." << std::endl;
-        writeLodInfo(pMesh);
-        std::cout << "LOD information exported." << std::endl;
-
-    }
-	*/
-    // Write bounds information
-    std::cout << "Exporting bounds information...." << std::endl;
-    writeBoundsInfo(pMesh);
-    std::cout << "Bounds information exported." << std::endl;
+	// Write bounds information
+	writeBoundsInfo(pMesh);
 
 	// Write submesh name table
-	std::cout << "Exporting submesh name table..." << std::endl;
 	writeSubMeshNameTable(pMesh);
-	std::cout << "Submesh name table exported." << std::endl;
-
-	// Write edge lists
-	/*	Not supported
-	if (pMesh->isEdgeListBuilt())
-	{
-		std::cout << "Exporting edge lists..." << std::endl;;
-		writeEdgeList(pMesh);
-		std::cout << "Edge lists exported" << std::endl;
-	}
-	*/
-
-	// Write morph animation
-	/* Not supported
-	writePoses(pMesh);
-	if (pMesh->hasVertexAnimation())
-	{
-		writeAnimations(pMesh);
-    }
-	*/
 
-    // Write submesh extremes
-    writeExtremes(pMesh);
+	endChunk(chunk);
 }
 //---------------------------------------------------------------------
 // Added by DrEvil
 void 
 vl::MeshSerializerImpl::writeSubMeshNameTable(vl::Mesh const *pMesh)
 {
-	std::clog << "vl::MeshSerializerImpl::writeSubMeshNameTable" << std::endl;
-	BOOST_THROW_EXCEPTION(vl::not_implemented());
-	/*
+	bool has_names = false;
+	for(unsigned short i = 0; i < pMesh->getNumSubMeshes(); ++i)
+	{
+		if(!pMesh->getSubMesh(i)->getName().empty())
+		{ has_names = true; }
+	}
+	if(!has_names)
+	{ return; }
+
 	// Header
-	writeChunkHeader(Ogre::M_SUBMESH_NAME_TABLE, calcSubMeshNameTableSize(pMesh));
+	size_t chunk = beginChunk(Ogre::M_SUBMESH_NAME_TABLE);
 
 	// Loop through and save out the index and names.
-	Mesh::SubMeshNameMap::const_iterator it = pMesh->mSubMeshNameMap.begin();
-
-	while(it != pMesh->mSubMeshNameMap.end())
+	for(unsigned short i = 0; i < pMesh->getNumSubMeshes(); ++i)
 	{
+		std::string const &name = pMesh->getSubMesh(i)->getName();
+		if(name.empty())
+		{ continue; }
+
 		// Header
 		writeChunkHeader(Ogre::M_SUBMESH_NAME_TABLE_ELEMENT, STREAM_OVERHEAD_SIZE +
-			sizeof(unsigned short) + (unsigned long)it->first.length() + 1);
+			sizeof(unsigned short) + name.length() + 1);
 
 		// write the index
-		writeShorts(&it->second, 1);
+		writeShorts(&i, 1);
 		// name
-	    writeString(it->first);
-
-		++it;
+		writeString(name);
 	}
-	*/
+
+	endChunk(chunk);
 }
 //---------------------------------------------------------------------
 void 
 vl::MeshSerializerImpl::writeSubMesh(vl::SubMesh const *s)
 {
-	std::clog << "vl::MeshSerializerImpl::writeSubMesh" << std::endl;
-	BOOST_THROW_EXCEPTION(vl::not_implemented());
-	/*
-    // Header
-    writeChunkHeader(Ogre::M_SUBMESH, calcSubMeshSize(s));
+	// Header
+	size_t chunk = beginChunk(Ogre::M_SUBMESH);
+
+	// char* materialName
+	writeString(s->getMaterial());
 
-    // char* materialName
-    writeString(s->getMaterialName());
+	// bool useSharedVertices
+	writeBools(&s->useSharedGeometry, 1);
 
-    // bool useSharedVertices
-    writeBools(&s->useSharedVertices, 1);
+	uint32_t indexCount = s->indexData.indexCount();
+	writeInts(&indexCount, 1);
 
-	unsigned int indexCount = s->indexData->indexCount;
-    writeInts(&indexCount, 1);
+	// bool indexes32Bit, we always use 32-bit indices
+	bool idx32bit = true;
+	writeBools(&idx32bit, 1);
 
-    // bool indexes32Bit
-    bool idx32bit = (!s->indexData->indexBuffer.isNull() &&
-		s->indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_32BIT);
-    writeBools(&idx32bit, 1);
+	writeIndices(s->indexData);
 
-	if (indexCount > 0)
+	// M_GEOMETRY stream (Optional: present only if useSharedVertices = false)
+	if(!s->useSharedGeometry)
 	{
-		// unsigned short* faceVertexIndices ((indexCount)
-		HardwareIndexBufferSharedPtr ibuf = s->indexData->indexBuffer;
-		void* pIdx = ibuf->lock(HardwareBuffer::HBL_READ_ONLY);
-		if (idx32bit)
-		{
-			unsigned int* pIdx32 = static_cast<unsigned int*>(pIdx);
-			writeInts(pIdx32, s->indexData->indexCount);
-		}
-		else
-		{
-			unsigned short* pIdx16 = static_cast<unsigned short*>(pIdx);
-			writeShorts(pIdx16, s->indexData->indexCount);
-		}
-		ibuf->unlock();
+		assert(s->vertexData);
+		writeGeometry(0, s->vertexData);
 	}
 
-    // M_GEOMETRY stream (Optional: present only if useSharedVertices = false)
-    if (!s->useSharedVertices)
-    {
-        writeGeometry(s->vertexData);
-    }
-
-    // end of sub mesh chunk
-
-    // write out texture alias chunks
-    writeSubMeshTextureAliases(s);
+	// Texture aliases and bone assignments are not supported
 
-    // Operation type
-    writeSubMeshOperation(s);
+	// Operation type
+	writeSubMeshOperation(s);
 
-    // Bone assignments
-    if (!s->mBoneAssignments.empty())
-    {
-        LogManager::getSingleton().logMessage("Exporting dedicated geometry bone assignments...");
-
-        SubMesh::VertexBoneAssignmentList::const_iterator vi;
-        for (vi = s->mBoneAssignments.begin();
-        vi != s->mBoneAssignments.end(); ++vi)
-        {
-            writeSubMeshBoneAssignment(vi->second);
-        }
-
-        LogManager::getSingleton().logMessage("Dedicated geometry bone assignments exported.");
-    }
-	*/
+	// end of sub mesh chunk
+	endChunk(chunk);
 }
 
 //---------------------------------------------------------------------
@@ -401,100 +322,79 @@ vl::MeshSerializerImpl::writeSubMeshTextureAliases(vl::SubMesh const *s)
 void 
 vl::MeshSerializerImpl::writeSubMeshOperation(vl::SubMesh const *sm)
 {
-	std::clog << "vl::MeshSerializerImpl::writeSubMeshOperation" << std::endl;
-	BOOST_THROW_EXCEPTION(vl::not_implemented());
-	/*
-    // Header
-    writeChunkHeader(Ogre::M_SUBMESH_OPERATION, calcSubMeshOperationSize(sm));
+	// Header
+	writeChunkHeader(Ogre::M_SUBMESH_OPERATION, STREAM_OVERHEAD_SIZE + sizeof(uint16_t));
 
-    // unsigned short operationType
-    unsigned short opType = static_cast<unsigned short>(sm->operationType);
-    writeShorts(&opType, 1);
-	*/
+	// unsigned short operationType
+	uint16_t opType = static_cast<uint16_t>(sm->operationType);
+	writeShorts(&opType, 1);
 }
 //---------------------------------------------------------------------
 void 
 vl::MeshSerializerImpl::writeGeometry(Mesh const *pMesh, VertexData const *pSrc)
 {
-	std::clog << "vl::MeshSerializerImpl::writeGeometry" << std::endl;
-	BOOST_THROW_EXCEPTION(vl::not_implemented());
-	/*
-	// calc size
-    const VertexDeclaration::VertexElementList& elemList =
-        vertexData->vertexDeclaration->getElements();
-    const VertexBufferBinding::VertexBufferBindingMap& bindings =
-        vertexData->vertexBufferBinding->getBindings();
-    VertexBufferBinding::VertexBufferBindingMap::const_iterator vbi, vbiend;
-
-	size_t size = STREAM_OVERHEAD_SIZE + sizeof(unsigned int) + // base
-		(STREAM_OVERHEAD_SIZE + elemList.size() * (STREAM_OVERHEAD_SIZE + sizeof(unsigned short) * 5)); // elements
-    vbiend = bindings.end();
-	for (vbi = bindings.begin(); vbi != vbiend; ++vbi)
-	{
-		const HardwareVertexBufferSharedPtr& vbuf = vbi->second;
-		size += (STREAM_OVERHEAD_SIZE * 2) + (sizeof(unsigned short) * 2) + vbuf->getSizeInBytes();
-	}
+	assert(pSrc);
 
 	// Header
-    writeChunkHeader(Ogre::M_GEOMETRY, size);
+	size_t chunk = beginChunk(Ogre::M_GEOMETRY);
 
-    unsigned int vertexCount = vertexData->vertexCount;
-    writeInts(&vertexCount, 1);
+	uint32_t vertexCount = pSrc->getVertexCount();
+	writeInts(&vertexCount, 1);
 
 	// Vertex declaration
-	size = STREAM_OVERHEAD_SIZE + elemList.size() * (STREAM_OVERHEAD_SIZE + sizeof(unsigned short) * 5);
-	writeChunkHeader(Ogre::M_GEOMETRY_VERTEX_DECLARATION, size);
-
-    VertexDeclaration::VertexElementList::const_iterator vei, veiend;
-	veiend = elemList.end();
-	unsigned short tmp;
-	size = STREAM_OVERHEAD_SIZE + sizeof(unsigned short) * 5;
-	for (vei = elemList.begin(); vei != veiend; ++vei)
+	std::vector<Ogre::VertexElement> const &elements = pSrc->vertexDeclaration.getElements();
+	size_t size = STREAM_OVERHEAD_SIZE + sizeof(uint16_t)*5;
+	writeChunkHeader(Ogre::M_GEOMETRY_VERTEX_DECLARATION, STREAM_OVERHEAD_SIZE + elements.size()*size);
+	for(size_t i = 0; i < elements.size(); ++i)
 	{
-		const VertexElement& elem = *vei;
+		Ogre::VertexElement const &elem = elements.at(i);
 		writeChunkHeader(Ogre::M_GEOMETRY_VERTEX_ELEMENT, size);
 		// unsigned short source;  	// buffer bind source
-		tmp = elem.getSource();
+		uint16_t tmp = elem.getSource();
 		writeShorts(&tmp, 1);
 		// unsigned short type;    	// VertexElementType
-		tmp = static_cast<unsigned short>(elem.getType());
+		tmp = static_cast<uint16_t>(elem.getType());
 		writeShorts(&tmp, 1);
 		// unsigned short semantic; // VertexElementSemantic
-		tmp = static_cast<unsigned short>(elem.getSemantic());
+		tmp = static_cast<uint16_t>(elem.getSemantic());
 		writeShorts(&tmp, 1);
 		// unsigned short offset;	// start offset in buffer in bytes
-		tmp = static_cast<unsigned short>(elem.getOffset());
+		tmp = static_cast<uint16_t>(elem.getOffset());
 		writeShorts(&tmp, 1);
 		// unsigned short index;	// index of the semantic (for colours and texture coords)
 		tmp = elem.getIndex();
 		writeShorts(&tmp, 1);
-
 	}
 
 	// Buffers and bindings
-	vbiend = bindings.end();
-	for (vbi = bindings.begin(); vbi != vbiend; ++vbi)
+	std::map<size_t, VertexBufferRefPtr>::const_iterator iter;
+	for(iter = pSrc->_bindings.begin(); iter != pSrc->_bindings.end(); ++iter)
 	{
-		const HardwareVertexBufferSharedPtr& vbuf = vbi->second;
-		size = (STREAM_OVERHEAD_SIZE * 2) + (sizeof(unsigned short) * 2) + vbuf->getSizeInBytes();
-		writeChunkHeader(Ogre::M_GEOMETRY_VERTEX_BUFFER,  size);
+		VertexBufferRefPtr vbuf = iter->second;
+		size_t buffer_chunk = beginChunk(Ogre::M_GEOMETRY_VERTEX_BUFFER);
 		// unsigned short bindIndex;	// Index to bind this buffer to
-		tmp = vbi->first;
+		uint16_t tmp = iter->first;
 		writeShorts(&tmp, 1);
 		// unsigned short vertexSize;	// Per-vertex size, must agree with declaration at this index
-		tmp = (unsigned short)vbuf->getVertexSize();
+		tmp = static_cast<uint16_t>(vbuf->getVertexSize());
 		writeShorts(&tmp, 1);
 
 		// Data
-		size = STREAM_OVERHEAD_SIZE + vbuf->getSizeInBytes();
-		writeChunkHeader(Ogre::M_GEOMETRY_VERTEX_BUFFER_DATA, size);
-		void* pBuf = vbuf->lock(HardwareBuffer::HBL_READ_ONLY);
-
-		writeData(pBuf, vbuf->getVertexSize(), vertexData->vertexCount);
+		if(mEncoding.encoded())
+		{
+			writeGeometryVertexBufferEncoded(pSrc, iter->first);
+		}
+		else
+		{
+			writeChunkHeader(Ogre::M_GEOMETRY_VERTEX_BUFFER_DATA, STREAM_OVERHEAD_SIZE + vbuf->size());
+			// No endian conversion, same as reading
+			writeData(vbuf->_buffer, vbuf->getVertexSize(), vbuf->getNVertices());
+		}
 
-        vbuf->unlock();
+		endChunk(buffer_chunk);
 	}
-	*/
+
+	endChunk(chunk);
 }
 //---------------------------------------------------------------------
 size_t 
@@ -797,7 +697,7 @@ vl::MeshSerializerImpl::readGeometryVertexBuffer(vl::ResourceStream &stream,
 	// Check for vertex data header
 	unsigned short headerID;
 	headerID = readChunk(stream);
-	if (headerID != Ogre::M_GEOMETRY_VERTEX_BUFFER_DATA)
+	if(headerID != Ogre::M_GEOMETRY_VERTEX_BUFFER_DATA && headerID != M_GEOMETRY_VERTEX_BUFFER_ENCODED)
 	{
 		std::string msg("Can't find vertex buffer data area");
 		std::clog << msg << std::endl;
@@ -819,8 +719,13 @@ vl::MeshSerializerImpl::readGeometryVertexBuffer(vl::ResourceStream &stream,
 	// Create the vertex buffer
 	VertexBufferRefPtr vbuf = vl::VertexBuffer::create(vertexSize, vertexCount);
 
-	// No endian conversion, we don't support Mac OSX
-	stream.read(vbuf->_buffer, vbuf->size());
+	if(headerID == M_GEOMETRY_VERTEX_BUFFER_ENCODED)
+	{ readGeometryVertexBufferEncoded(stream, vbuf.get()); }
+	else
+	{
+		// No endian conversion, we don't support Mac OSX
+		stream.read(vbuf->_buffer, vbuf->size());
+	}
 
 	// @todo Set binding
 	pDest->setBinding(bindIndex, vbuf);
@@ -998,30 +903,7 @@ vl::MeshSerializerImpl::readSubMesh(vl::ResourceStream &stream, vl::Mesh *pMesh)
 	// We need to check the 32-bit flag so we can use the correct read function
 	bool idx32bit;
 	readBools(stream, &idx32bit, 1);
-	if (indexCount > 0)
-	{
-		sm->indexData.setIndexCount(indexCount);
-
-		if (idx32bit)
-		{
-			readInts(stream, sm->indexData.getBuffer(), indexCount);
-		}
-		else // 16-bit
-		{
-			/// Get the half count of indexes, if it's odd it will be increased
-			/// by one half, if it's even then the odd one is out in the division
-			/// We use the half size to resize the container, but the read is
-			/// of course done with the correct number of indices.
-			sm->indexData.setIndexCount(indexCount);
-			std::vector<uint16_t> temp_buf(indexCount);
-			readShorts(stream, &temp_buf[0], indexCount);
-			// conversion to 32-bit buffer
-			for(size_t i = 0; i < indexCount; ++i)
-			{
-				sm->indexData[i] = temp_buf[i];
-			}
-		}
-	}
+	readIndices(stream, sm->indexData, indexCount, idx32bit);
 
     // M_GEOMETRY stream (Optional: present only if useSharedVertices = false)
     if(!sm->useSharedGeometry)
@@ -1200,168 +1082,47 @@ vl::MeshSerializerImpl::calcBoneAssignmentSize(void)
 }
 
 //---------------------------------------------------------------------
-/*	LOD not suported
-void MeshSerializerImpl::writeLodInfo(const Mesh* pMesh)
-{
-    const LodStrategy *strategy = pMesh->getLodStrategy();
-    unsigned short numLods = pMesh->getNumLodLevels();
-    bool manual = pMesh->isLodManual();
-    writeLodSummary(numLods, manual, strategy);
-
-	// Loop from LOD 1 (not 0, this is full detail)
-    for (unsigned short i = 1; i < numLods; ++i)
-    {
-		const MeshLodUsage& usage = pMesh->getLodLevel(i);
-		if (manual)
-		{
-			writeLodUsageManual(usage);
-		}
-		else
-		{
-			writeLodUsageGenerated(pMesh, usage, i);
-		}
-
-    }
-
-
-}
-//---------------------------------------------------------------------
-void MeshSerializerImpl::writeLodSummary(unsigned short numLevels, bool manual, const LodStrategy *strategy)
-{
-    // Header
-    size_t size = STREAM_OVERHEAD_SIZE;
-    // unsigned short numLevels;
-    size += sizeof(unsigned short);
-    // bool manual;  (true for manual alternate meshes, false for generated)
-    size += sizeof(bool);
-    writeChunkHeader(M_MESH_LOD, size);
-
-    // Details
-    // string strategyName;
-    writeString(strategy->getName());
-    // unsigned short numLevels;
-    writeShorts(&numLevels, 1);
-    // bool manual;  (true for manual alternate meshes, false for generated)
-    writeBools(&manual, 1);
-
-
-}
-//---------------------------------------------------------------------
-void MeshSerializerImpl::writeLodUsageManual(const MeshLodUsage& usage)
-{
-    // Header
-    size_t size = STREAM_OVERHEAD_SIZE;
-    size_t manualSize = STREAM_OVERHEAD_SIZE;
-    // float lodValue;
-    size += sizeof(float);
-    // Manual part size
-
-    // String manualMeshName;
-    manualSize += usage.manualName.length() + 1;
-
-    size += manualSize;
-
-    writeChunkHeader(M_MESH_LOD_USAGE, size);
-    writeFloats(&(usage.userValue), 1);
-
-    writeChunkHeader(M_MESH_LOD_MANUAL, manualSize);
-    writeString(usage.manualName);
-
-
-}
-//---------------------------------------------------------------------
-void MeshSerializerImpl::writeLodUsageGenerated(const Mesh* pMesh, const MeshLodUsage& usage,
-	unsigned short lodNum)
+void
+vl::MeshSerializerImpl::writeLodInfo(vl::Mesh const *pMesh)
 {
-	// Usage Header
-    size_t size = STREAM_OVERHEAD_SIZE;
-	unsigned short subidx;
+	size_t chunk = beginChunk(Ogre::M_MESH_LOD);
 
-    // float fromDepthSquared;
-    size += sizeof(float);
-
-    // Calc generated SubMesh sections size
-	for(subidx = 0; subidx < pMesh->getNumSubMeshes(); ++subidx)
-	{
-		// header
-		size += STREAM_OVERHEAD_SIZE;
-		// unsigned int numFaces;
-		size += sizeof(unsigned int);
-		SubMesh* sm = pMesh->getSubMesh(subidx);
-        const IndexData* indexData = sm->mLodFaceList[lodNum - 1];
-
-        // bool indexes32Bit
-		size += sizeof(bool);
-		// int* faceIndexes;
-        if (!indexData->indexBuffer.isNull() &&
-			indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_32BIT)
-        {
-			size += static_cast<unsigned long>(
-                sizeof(unsigned int) * indexData->indexCount);
-        }
-        else
-        {
-			size += static_cast<unsigned long>(
-                sizeof(unsigned short) * indexData->indexCount);
-        }
+	writeString(pMesh->getLodStrategy());
+	// unsigned short numLevels;
+	uint16_t numLods = pMesh->getNumLodLevels();
+	writeShorts(&numLods, 1);
+	// bool manual;
+	bool manual = false;
+	writeBools(&manual, 1);
 
-	}
-
-    writeChunkHeader(M_MESH_LOD_USAGE, size);
-    writeFloats(&(usage.userValue), 1);
-
-	// Now write sections
-    // Calc generated SubMesh sections size
-	for(subidx = 0; subidx < pMesh->getNumSubMeshes(); ++subidx)
+	// Loop from LOD 1 (not 0, this is full detail)
+	for(unsigned short i = 1; i < numLods; ++i)
 	{
-		size = STREAM_OVERHEAD_SIZE;
-		// unsigned int numFaces;
-		size += sizeof(unsigned int);
-		SubMesh* sm = pMesh->getSubMesh(subidx);
-        const IndexData* indexData = sm->mLodFaceList[lodNum - 1];
-        // bool indexes32Bit
-		size += sizeof(bool);
-		// Lock index buffer to write
-		HardwareIndexBufferSharedPtr ibuf = indexData->indexBuffer;
-		// bool indexes32bit
-		bool idx32 = (!ibuf.isNull() && ibuf->getType() == HardwareIndexBuffer::IT_32BIT);
-		// int* faceIndexes;
-        if (idx32)
-        {
-			size += static_cast<unsigned long>(
-                sizeof(unsigned int) * indexData->indexCount);
-        }
-        else
-        {
-			size += static_cast<unsigned long>(
-                sizeof(unsigned short) * indexData->indexCount);
-        }
+		size_t usage_chunk = beginChunk(Ogre::M_MESH_LOD_USAGE);
+		float value = pMesh->getLodValues().at(i-1);
+		writeFloats(&value, 1);
 
-		writeChunkHeader(Ogre::M_MESH_LOD_GENERATED, size);
-		unsigned int idxCount = static_cast<unsigned int>(indexData->indexCount);
-		writeInts(&idxCount, 1);
-		writeBools(&idx32, 1);
-
-		if (idxCount > 0)
+		for(unsigned short j = 0; j < pMesh->getNumSubMeshes(); ++j)
 		{
-			if (idx32)
-			{
-				unsigned int* pIdx = static_cast<unsigned int*>(
-					ibuf->lock(HardwareBuffer::HBL_READ_ONLY));
-				writeInts(pIdx, indexData->indexCount);
-				ibuf->unlock();
-			}
-			else
-			{
-				unsigned short* pIdx = static_cast<unsigned short*>(
-					ibuf->lock(HardwareBuffer::HBL_READ_ONLY));
-				writeShorts(pIdx, indexData->indexCount);
-				ibuf->unlock();
-			}
+			vl::SubMesh const *sm = pMesh->getSubMesh(j);
+			// Missing levels use the full detail
+			IndexBuffer const &indices = (size_t(i-1) < sm->lodIndexData.size())
+				? sm->lodIndexData.at(i-1) : sm->indexData;
+
+			size_t generated_chunk = beginChunk(Ogre::M_MESH_LOD_GENERATED);
+			uint32_t indexCount = indices.indexCount();
+			writeInts(&indexCount, 1);
+			bool idx32bit = true;
+			writeBools(&idx32bit, 1);
+			writeIndices(indices);
+			endChunk(generated_chunk);
 		}
+
+		endChunk(usage_chunk);
 	}
+
+	endChunk(chunk);
 }
-*/
 
 //---------------------------------------------------------------------
 void 
@@ -1414,148 +1175,328 @@ vl::MeshSerializerImpl::readBoundsInfo(vl::ResourceStream &stream, vl::Mesh *pMe
 void
 vl::MeshSerializerImpl::readMeshLodInfo(vl::ResourceStream &stream, vl::Mesh* pMesh)
 {
-	BOOST_THROW_EXCEPTION(vl::not_implemented());
-	/*
-	unsigned short streamID, i;
+	// Read the strategy to be used for this mesh
+	std::string strategyName = readString(stream);
 
-    // Read the strategy to be used for this mesh
-    String strategyName = readString(stream);
-    LodStrategy *strategy = LodStrategyManager::getSingleton().getStrategy(strategyName);
-    pMesh->setLodStrategy(strategy);
-
-    // unsigned short numLevels;
-	readShorts(stream, &(pMesh->mNumLods), 1);
-    // bool manual;  (true for manual alternate meshes, false for generated)
-	readBools(stream, &(pMesh->mIsLodManual), 1);
+	// unsigned short numLevels;
+	unsigned short numLods;
+	readShorts(stream, &numLods, 1);
+	// bool manual;  (true for manual alternate meshes, false for generated)
+	bool manual;
+	readBools(stream, &manual, 1);
 
 	// Preallocate submesh lod face data if not manual
-	if (!pMesh->mIsLodManual)
+	if(!manual)
 	{
-		unsigned short numsubs = pMesh->getNumSubMeshes();
-		for (i = 0; i < numsubs; ++i)
+		for(size_t i = 0; i < pMesh->getNumSubMeshes(); ++i)
 		{
-			SubMesh* sm = pMesh->getSubMesh(i);
-			sm->mLodFaceList.resize(pMesh->mNumLods-1);
+			pMesh->getSubMesh(i)->lodIndexData.clear();
+			pMesh->getSubMesh(i)->lodIndexData.resize(numLods-1);
 		}
 	}
 
 	// Loop from 1 rather than 0 (full detail index is not in file)
-	for (i = 1; i < pMesh->mNumLods; ++i)
+	std::vector<Ogre::Real> values;
+	for(unsigned short i = 1; i < numLods; ++i)
 	{
-		streamID = readChunk(stream);
-		if (streamID != M_MESH_LOD_USAGE)
+		unsigned short streamID = readChunk(stream);
+		if(streamID != Ogre::M_MESH_LOD_USAGE)
 		{
-			OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND,
-				"Missing M_MESH_LOD_USAGE stream in " + pMesh->getName(),
-				"MeshSerializerImpl::readMeshLodInfo");
+			std::string msg("Missing M_MESH_LOD_USAGE stream in mesh file");
+			std::clog << msg << std::endl;
+			BOOST_THROW_EXCEPTION(vl::exception() << vl::desc(msg));
 		}
-		// Read depth
-		MeshLodUsage usage;
-		readFloats(stream, &(usage.userValue), 1);
+		// Read user value
+		float value;
+		readFloats(stream, &value, 1);
+		values.push_back(value);
 
-		if (pMesh->isLodManual())
-		{
-			readMeshLodUsageManual(stream, pMesh, i, usage);
-		}
-		else //(!pMesh->isLodManual)
-		{
-			readMeshLodUsageGenerated(stream, pMesh, i, usage);
-		}
-        usage.edgeData = NULL;
+		if(manual)
+		{ readMeshLodUsageManual(stream, pMesh, i); }
+		else
+		{ readMeshLodUsageGenerated(stream, pMesh, i); }
+	}
 
-		// Save usage
-		pMesh->mMeshLodUsageList.push_back(usage);
+	if(!manual)
+	{
+		pMesh->setLodStrategy(strategyName);
+		pMesh->setLodValues(values);
 	}
-	*/
 }
 //---------------------------------------------------------------------
 void
 vl::MeshSerializerImpl::readMeshLodUsageManual(vl::ResourceStream &stream,
     vl::Mesh* pMesh, unsigned short lodNum)
 {
-	BOOST_THROW_EXCEPTION(vl::not_implemented());
-	/*
-	unsigned long streamID;
 	// Read detail stream
-	streamID = readChunk(stream);
-	if (streamID != M_MESH_LOD_MANUAL)
+	unsigned short streamID = readChunk(stream);
+	if(streamID != Ogre::M_MESH_LOD_MANUAL)
 	{
-		OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND,
-			"Missing M_MESH_LOD_MANUAL stream in " + pMesh->getName(),
-			"MeshSerializerImpl::readMeshLodUsageManual");
+		std::string msg("Missing M_MESH_LOD_MANUAL stream in mesh file");
+		std::clog << msg << std::endl;
+		BOOST_THROW_EXCEPTION(vl::exception() << vl::desc(msg));
 	}
 
-	usage.manualName = readString(stream);
-	usage.manualMesh.setNull(); // will trigger load later
-	*/
+	// Manual LOD meshes are not supported, the full detail is used
+	std::string manualName = readString(stream);
+	std::clog << "vl::MeshSerializerImpl::readMeshLodUsageManual : "
+		<< "manual LOD " << manualName << " not supported." << std::endl;
 }
 //---------------------------------------------------------------------
 void
 vl::MeshSerializerImpl::readMeshLodUsageGenerated(vl::ResourceStream &stream,
     vl::Mesh* pMesh, unsigned short lodNum)
 {
-	/*
-	usage.manualName = "";
-	usage.manualMesh.setNull();
+	assert(lodNum > 0);
 
 	// Get one set of detail per SubMesh
-	unsigned short numSubs, i;
-	unsigned long streamID;
-	numSubs = pMesh->getNumSubMeshes();
-	for (i = 0; i < numSubs; ++i)
+	for(size_t i = 0; i < pMesh->getNumSubMeshes(); ++i)
 	{
-		streamID = readChunk(stream);
-		if (streamID != M_MESH_LOD_GENERATED)
+		unsigned short streamID = readChunk(stream);
+		if(streamID != Ogre::M_MESH_LOD_GENERATED)
 		{
-			OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND,
-				"Missing M_MESH_LOD_GENERATED stream in " + pMesh->getName(),
-				"MeshSerializerImpl::readMeshLodUsageGenerated");
+			std::string msg("Missing M_MESH_LOD_GENERATED stream in mesh file");
+			std::clog << msg << std::endl;
+			BOOST_THROW_EXCEPTION(vl::exception() << vl::desc(msg));
 		}
 
-		SubMesh* sm = pMesh->getSubMesh(i);
 		// lodNum - 1 because SubMesh doesn't store full detail LOD
-        sm->mLodFaceList[lodNum - 1] = OGRE_NEW IndexData();
-		IndexData* indexData = sm->mLodFaceList[lodNum - 1];
-        // unsigned int numIndexes
-        unsigned int numIndexes;
-		readInts(stream, &numIndexes, 1);
-        indexData->indexCount = static_cast<size_t>(numIndexes);
-        // bool indexes32Bit
-        bool idx32Bit;
-        readBools(stream, &idx32Bit, 1);
-        // int* faceIndexes;  ((v1, v2, v3) * numFaces)
-        if (idx32Bit)
-        {
-            indexData->indexBuffer = HardwareBufferManager::getSingleton().
-                createIndexBuffer(HardwareIndexBuffer::IT_32BIT, indexData->indexCount,
-                pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-            unsigned int* pIdx = static_cast<unsigned int*>(
-                indexData->indexBuffer->lock(
-                    0,
-                    indexData->indexBuffer->getSizeInBytes(),
-                    HardwareBuffer::HBL_DISCARD) );
-
-			readInts(stream, pIdx, indexData->indexCount);
-            indexData->indexBuffer->unlock();
+		vl::SubMesh *sm = pMesh->getSubMesh(i);
+		if(sm->lodIndexData.size() < lodNum)
+		{ sm->lodIndexData.resize(lodNum); }
+		vl::IndexBuffer &indexData = sm->lodIndexData.at(lodNum-1);
+
+		// unsigned int numIndexes
+		uint32_t indexCount;
+		readInts(stream, &indexCount, 1);
+		// bool indexes32Bit
+		bool idx32bit;
+		readBools(stream, &idx32bit, 1);
+
+		readIndices(stream, indexData, indexCount, idx32bit);
+	}
+}
+//---------------------------------------------------------------------
+bool
+vl::MeshSerializerImpl::isEncoded(void) const
+{ return mFileVersion == MESH_ENCODED_VERSION; }
+//---------------------------------------------------------------------
+void
+vl::MeshSerializerImpl::writeIndices(vl::IndexBuffer const &indices)
+{
+	if(indices.indexCount() == 0)
+	{ return; }
 
-        }
-        else
-        {
-            indexData->indexBuffer = HardwareBufferManager::getSingleton().
-                createIndexBuffer(HardwareIndexBuffer::IT_16BIT, indexData->indexCount,
-                pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-            unsigned short* pIdx = static_cast<unsigned short*>(
-                indexData->indexBuffer->lock(
-                    0,
-                    indexData->indexBuffer->getSizeInBytes(),
-                    HardwareBuffer::HBL_DISCARD) );
-			readShorts(stream, pIdx, indexData->indexCount);
-            indexData->indexBuffer->unlock();
+	if(mEncoding.encoded())
+	{
+		// bool compressed
+		writeBools(&mEncoding.compress, 1);
+		if(mEncoding.compress)
+		{
+			std::vector<uint8_t> data;
+			compress_index_stream(indices.getBuffer(), indices.indexCount(), data);
+			uint32_t size = data.size();
+			writeInts(&size, 1);
+			writeData(&data[0], 1, data.size());
+			return;
+		}
+	}
 
-        }
+	writeInts(indices.getBuffer(), indices.indexCount());
+}
+//---------------------------------------------------------------------
+void
+vl::MeshSerializerImpl::readIndices(vl::ResourceStream &stream, vl::IndexBuffer &indices,
+	size_t indexCount, bool idx32bit)
+{
+	indices.setIndexCount(indexCount);
+	if(indexCount == 0)
+	{ return; }
+
+	bool compressed = false;
+	if(isEncoded())
+	{ readBools(stream, &compressed, 1); }
 
+	if(compressed)
+	{
+		uint32_t size;
+		readInts(stream, &size, 1);
+		std::vector<uint8_t> data(size);
+		if(size == 0 || stream.read(&data[0], size) != size)
+		{
+			std::string msg("Index data missing in mesh file");
+			std::clog << msg << std::endl;
+			BOOST_THROW_EXCEPTION(vl::exception() << vl::desc(msg));
+		}
+		decompress_index_stream(&data[0], data.size(), indexCount, indices.getBuffer());
+	}
+	else if(idx32bit)
+	{
+		readInts(stream, indices.getBuffer(), indexCount);
+	}
+	else // 16-bit
+	{
+		std::vector<uint16_t> temp_buf(indexCount);
+		readShorts(stream, &temp_buf[0], indexCount);
+		// conversion to 32-bit buffer
+		for(size_t i = 0; i < indexCount; ++i)
+		{ indices[i] = temp_buf[i]; }
+	}
+}
+//---------------------------------------------------------------------
+void
+vl::MeshSerializerImpl::writeGeometryVertexBufferEncoded(vl::VertexData const *pSrc, size_t bindIndex)
+{
+	VertexBufferConstRefPtr vbuf = pSrc->getBuffer(bindIndex);
+	assert(vbuf);
+	size_t vertexSize = vbuf->getVertexSize();
+	size_t vertexCount = vbuf->getNVertices();
+
+	// Every element in the buffer is a separate stream
+	std::vector<vl::VertexStream> streams;
+	std::vector<bool> covered(vertexSize, false);
+	bool valid = true;
+	std::vector<Ogre::VertexElement> const &elements = pSrc->vertexDeclaration.getElements();
+	for(size_t i = 0; i < elements.size(); ++i)
+	{
+		Ogre::VertexElement const &elem = elements.at(i);
+		if(elem.getSource() != bindIndex)
+		{ continue; }
+
+		size_t size = VertexDeclaration::getTypeSize(elem.getType());
+		if(elem.getOffset() + size > vertexSize)
+		{
+			valid = false;
+			break;
+		}
+
+		for(size_t j = elem.getOffset(); j < elem.getOffset() + size; ++j)
+		{
+			if(covered[j])
+			{ valid = false; }
+			covered[j] = true;
+		}
+
+		vl::VERTEX_STREAM_ENCODING encoding = VSE_RAW;
+		Ogre::VertexElementSemantic semantic = elem.getSemantic();
+		if(elem.getType() == Ogre::VET_FLOAT3 && semantic == Ogre::VES_POSITION
+			&& mEncoding.quantize_positions)
+		{ encoding = VSE_POSITION_UNORM16; }
+		else if(elem.getType() == Ogre::VET_FLOAT3 && mEncoding.quantize_normals
+			&& (semantic == Ogre::VES_NORMAL || semantic == Ogre::VES_TANGENT || semantic == Ogre::VES_BINORMAL))
+		{ encoding = VSE_NORMAL_OCT16; }
+		else if(semantic == Ogre::VES_TEXTURE_COORDINATES && mEncoding.half_texcoords
+			&& (elem.getType() == Ogre::VET_FLOAT1 || elem.getType() == Ogre::VET_FLOAT2
+				|| elem.getType() == Ogre::VET_FLOAT3 || elem.getType() == Ogre::VET_FLOAT4))
+		{ encoding = VSE_HALF; }
+
+		streams.push_back(vl::VertexStream(elem.getOffset(), size, encoding));
+	}
+
+	// Data that isn't described by the declaration is stored as is
+	if(!valid || std::find(covered.begin(), covered.end(), false) != covered.end())
+	{
+		streams.clear();
+		streams.push_back(vl::VertexStream(0, vertexSize, VSE_RAW));
+	}
+
+	size_t chunk = beginChunk(M_GEOMETRY_VERTEX_BUFFER_ENCODED);
+
+	uint16_t n_streams = streams.size();
+	writeShorts(&n_streams, 1);
+
+	std::vector<uint8_t> encoded;
+	std::vector<uint8_t> compressed;
+	uint8_t const *vertices = reinterpret_cast<uint8_t const *>(vbuf->_buffer);
+	for(size_t i = 0; i < streams.size(); ++i)
+	{
+		vl::VertexStream &stream = streams.at(i);
+		encode_vertex_stream(stream, vertices, vertexSize, vertexCount, encoded);
+
+		// unsigned short offset, size, encoding
+		writeShorts(&stream.offset, 1);
+		writeShorts(&stream.size, 1);
+		uint16_t tmp = stream.encoding;
+		writeShorts(&tmp, 1);
+		if(stream.encoding == VSE_POSITION_UNORM16)
+		{
+			writeFloats(stream.min, 3);
+			writeFloats(stream.extent, 3);
+		}
+
+		// bool compressed, unsigned int size, data
+		writeBools(&mEncoding.compress, 1);
+		std::vector<uint8_t> const *data = &encoded;
+		if(mEncoding.compress)
+		{
+			compress_vertex_stream(encoded.empty() ? 0 : &encoded[0], vertexCount,
+				stream.getEncodedSize(), compressed);
+			data = &compressed;
+		}
+		uint32_t size = data->size();
+		writeInts(&size, 1);
+		if(size > 0)
+		{ writeData(&data->at(0), 1, size); }
+	}
+
+	endChunk(chunk);
+}
+//---------------------------------------------------------------------
+void
+vl::MeshSerializerImpl::readGeometryVertexBufferEncoded(vl::ResourceStream &stream, vl::VertexBuffer *buf)
+{
+	uint16_t n_streams;
+	readShorts(stream, &n_streams, 1);
+
+	std::vector<uint8_t> data;
+	std::vector<uint8_t> decompressed;
+	uint8_t *vertices = reinterpret_cast<uint8_t *>(buf->_buffer);
+	for(size_t i = 0; i < n_streams; ++i)
+	{
+		vl::VertexStream vs;
+		uint16_t tmp;
+		readShorts(stream, &vs.offset, 1);
+		readShorts(stream, &vs.size, 1);
+		readShorts(stream, &tmp, 1);
+		vs.encoding = static_cast<vl::VERTEX_STREAM_ENCODING>(tmp);
+		if(vs.encoding == VSE_POSITION_UNORM16)
+		{
+			readFloats(stream, vs.min, 3);
+			readFloats(stream, vs.extent, 3);
+		}
+
+		bool compressed;
+		readBools(stream, &compressed, 1);
+		uint32_t size;
+		readInts(stream, &size, 1);
+		data.resize(size);
+		if(size > 0 && stream.read(&data[0], size) != size)
+		{
+			std::string msg("Vertex data missing in mesh file");
+			std::clog << msg << std::endl;
+			BOOST_THROW_EXCEPTION(vl::exception() << vl::desc(msg));
+		}
+
+		size_t encoded_size = buf->getNVertices()*vs.getEncodedSize();
+		std::vector<uint8_t> *encoded = &data;
+		if(compressed)
+		{
+			decompressed.resize(encoded_size);
+			decompress_vertex_stream(data.empty() ? 0 : &data[0], data.size(), buf->getNVertices(),
+				vs.getEncodedSize(), decompressed.empty() ? 0 : &decompressed[0]);
+			encoded = &decompressed;
+		}
+
+		if(encoded->size() != encoded_size)
+		{
+			std::string msg("Vertex data size does not agree with the vertex count");
+			std::clog << msg << std::endl;
+			BOOST_THROW_EXCEPTION(vl::exception() << vl::desc(msg));
+		}
+
+		if(encoded_size > 0)
+		{ decode_vertex_stream(vs, &encoded->at(0), vertices, buf->getVertexSize(), buf->getNVertices()); }
 	}
-	*/
 }
 //---------------------------------------------------------------------
 
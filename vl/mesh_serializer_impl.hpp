@@ -59,8 +59,17 @@ THE SOFTWARE.
 /// Base class
 #include "serializer.hpp"
 
+#include "mesh_encoding.hpp"
+
 namespace vl {
 
+/// Version of files written with MeshEncodingSettings
+extern std::string const MESH_ENCODED_VERSION;
+
+/// Vertex buffer data with vl::VertexStream encodings,
+/// replaces Ogre::M_GEOMETRY_VERTEX_BUFFER_DATA in encoded files.
+uint16_t const M_GEOMETRY_VERTEX_BUFFER_ENCODED = 0x5220;
+
 /** Internal implementation of Mesh reading / writing for the latest version of the
 .mesh format.
 @remarks
@@ -101,10 +110,22 @@ public:
     */
     void importMesh(vl::ResourceStream &stream, vl::Mesh *pDest);
 
+	/** Sets the vertex and index encodings used by exportMesh.
+	@remarks
+	Files with any encodings are written with a different version and
+	can't be read by Ogre. They are decoded when read so the Mesh is
+	identical to a plain file except for the quantization errors.
+	*/
+	void setEncoding(MeshEncodingSettings const &settings)
+	{ mEncoding = settings; }
+
+	MeshEncodingSettings const &getEncoding(void) const
+	{ return mEncoding; }
+
 protected:
 
 	// Internal methods
-	/// @todo Writing meshes is not yet supported
+	/// Writing is used for encoded files, plain files are written with Ogre
 	virtual void writeSubMeshNameTable(Mesh const *pMesh);
 	virtual void writeMesh(Mesh const *pMesh);
 	virtual void writeSubMesh(SubMesh const *s);
@@ -116,12 +137,8 @@ protected:
 	virtual void writeMeshBoneAssignment(VertexBoneAssignment const &assign);
 	virtual void writeSubMeshBoneAssignment(VertexBoneAssignment const &assign);
 
-	/* LOD not supported
-	virtual void writeLodInfo(const Mesh* pMesh);
-	virtual void writeLodSummary(unsigned short numLevels, bool manual, const LodStrategy *strategy);
-	virtual void writeLodUsageManual(const MeshLodUsage& usage);
-	virtual void writeLodUsageGenerated(const Mesh* pMesh, const MeshLodUsage& usage, unsigned short lodNum);
-	*/
+	/// Only generated LOD levels are supported
+	virtual void writeLodInfo(Mesh const *pMesh);
 	virtual void writeBoundsInfo(Mesh const *pMesh);
 	// Edge list not supported
 	//virtual void writeEdgeList(const Mesh* pMesh);
@@ -182,7 +199,8 @@ protected:
 	virtual void readSubMeshBoneAssignment(vl::ResourceStream &stream, Mesh* pMesh, 
 		SubMesh* sub);
 
-	// LOD not supported, only stubs
+	/// Generated LOD levels are stored in SubMesh::lodIndexData
+	/// manual LOD is not supported
 	virtual void readMeshLodInfo(vl::ResourceStream &stream, Mesh* pMesh);
 	virtual void readMeshLodUsageManual(vl::ResourceStream &stream, Mesh* pMesh, 
 		unsigned short lodNum);
@@ -204,8 +222,20 @@ protected:
 	//virtual void readPoseKeyFrame(vl::ResourceStream &stream, VertexAnimationTrack* track);
 
 	virtual void readExtremes(vl::ResourceStream &stream, Mesh *pMesh);
-	
-	std::string mVersion;
+
+	/// Index data, compressed when the file is encoded
+	virtual void writeIndices(IndexBuffer const &indices);
+	virtual void readIndices(vl::ResourceStream &stream, IndexBuffer &indices,
+		size_t indexCount, bool idx32bit);
+
+	/// @brief write vertex buffer data with quantization and compression
+	virtual void writeGeometryVertexBufferEncoded(VertexData const *pSrc, size_t bindIndex);
+	virtual void readGeometryVertexBufferEncoded(vl::ResourceStream &stream, VertexBuffer *buf);
+
+	/// @brief is the stream being read an encoded file
+	bool isEncoded(void) const;
+
+	MeshEncodingSettings mEncoding;
 
 };	// class MeshSerializerImpl
 
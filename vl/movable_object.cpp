@@ -54,6 +54,9 @@ vl::MovableObject::setParent(vl::SceneNodePtr parent)
 		{
 			_parent->getNative()->attachObject(getNative());
 		}
+
+		// Might have been hidden by static geometry in the old parent
+		getNative()->setVisible(_visible);
 	}
 }
 
@@ -188,4 +191,8 @@ vl::MovableObject::deserialize( vl::cluster::ByteStream &msg, const uint64_t dir
 
 		_transformation_updated();
 	}
+
+	// Static geometry needs to be rebuild if this is part of it
+	if(_parent)
+	{ _parent->_notifyStaticChanged(); }
 }
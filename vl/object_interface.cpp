@@ -17,6 +17,31 @@
 #include "math/math.hpp"
 #include "base/exceptions.hpp"
 
+#include "transform_group.hpp"
+
+#include <algorithm>
+
+vl::ObjectInterface::~ObjectInterface(void)
+{
+	for(size_t i = 0; i < _transform_groups.size(); ++i)
+	{ _transform_groups.at(i)->_objectDestroyed(this); }
+}
+
+void
+vl::ObjectInterface::_addTransformGroup(vl::TransformGroup *group)
+{
+	_transform_groups.push_back(group);
+}
+
+void
+vl::ObjectInterface::_removeTransformGroup(vl::TransformGroup *group)
+{
+	std::vector<TransformGroup *>::iterator iter
+		= std::find(_transform_groups.begin(), _transform_groups.end(), group);
+	if(iter != _transform_groups.end())
+	{ _transform_groups.erase(iter); }
+}
+
 void 
 vl::ObjectInterface::transform(Ogre::Matrix4 const &m)
 {
@@ -27,11 +27,15 @@
 #include "defines.hpp"
 
 // Used for user callbacks
-#include <boost/signal.hpp>
+#include "base/signal.hpp"
+
+#include <vector>
 
 namespace vl
 {
 
+class TransformGroup;
+
 enum TransformSpace
 {
 	TS_LOCAL,
@@ -44,9 +48,18 @@ enum TransformSpace
 class HYDRA_API ObjectInterface
 {
 protected :
-	typedef boost::signal<void (vl::Transform const &)> TransformedCB;
+	typedef vl::Signal<void (vl::Transform const &)> TransformedCB;
 public :
-	virtual ~ObjectInterface(void) {}
+	ObjectInterface(void) {}
+
+	/// TransformGroups are not copied
+	ObjectInterface(ObjectInterface const &) {}
+
+	ObjectInterface &operator=(ObjectInterface const &)
+	{ return *this; }
+
+	/// Removes the object from the TransformGroups it's in
+	virtual ~ObjectInterface(void);
 
 	virtual std::string const &getName(void) const = 0;
 
@@ -202,6 +215,14 @@ public :
 	/// Dynamic objects are also ignored when saving the scene.
 	virtual bool isDynamic(void) const = 0;
 
+	/// @internal
+	/// @brief called from TransformGroup when the object is added or removed
+	void _addTransformGroup(TransformGroup *group);
+	void _removeTransformGroup(TransformGroup *group);
+
+private :
+	std::vector<TransformGroup *> _transform_groups;
+
 };	// class ObjectInterface
 
 }	// namespace vl
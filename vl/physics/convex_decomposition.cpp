@@ -0,0 +1,907 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file physics/convex_decomposition.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/// Interface
+#include "convex_decomposition.hpp"
+
+/// Reading vertex positions
+#include "mesh_optimizer.hpp"
+
+#include "base/filesystem.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <map>
+
+namespace
+{
+
+char const CACHE_MAGIC[] = "HYDRA_HULLS";
+uint32_t const CACHE_VERSION = 2;
+
+/// Number of directions used for the approximate hulls when decomposing,
+/// less are needed for comparing split planes than for the concavity
+size_t const N_SPLIT_DIRECTIONS = 64;
+size_t const N_DIRECTIONS = 256;
+
+template<typename T>
+void hash_value(uint64_t &hash, T const &value)
+{
+	// FNV-1a
+	uint8_t const *bytes = (uint8_t const *)&value;
+	for(size_t i = 0; i < sizeof(value); ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+}
+
+/// -------------------------- Convex hull ---------------------------------
+/// Planes are in double precision because the hulls have a lot of thin
+/// triangles which have inaccurate normals with floats.
+struct HullFace
+{
+	uint32_t v[3];
+	/// Neighbour across edge v[i] -> v[i+1]
+	size_t n[3];
+	double normal[3];
+	double offset;
+	std::vector<uint32_t> outside;
+	bool deleted;
+	bool visible;
+
+	double distance(Ogre::Vector3 const &p) const
+	{ return normal[0]*p.x + normal[1]*p.y + normal[2]*p.z - offset; }
+};
+
+HullFace create_face(std::vector<Ogre::Vector3> const &points, uint32_t a, uint32_t b, uint32_t c)
+{
+	HullFace f;
+	f.v[0] = a;
+	f.v[1] = b;
+	f.v[2] = c;
+	f.n[0] = f.n[1] = f.n[2] = 0;
+
+	double e1[3], e2[3];
+	for(size_t i = 0; i < 3; ++i)
+	{
+		e1[i] = double(points[b][i]) - points[a][i];
+		e2[i] = double(points[c][i]) - points[a][i];
+	}
+	f.normal[0] = e1[1]*e2[2] - e1[2]*e2[1];
+	f.normal[1] = e1[2]*e2[0] - e1[0]*e2[2];
+	f.normal[2] = e1[0]*e2[1] - e1[1]*e2[0];
+	double len = std::sqrt(f.normal[0]*f.normal[0] + f.normal[1]*f.normal[1] + f.normal[2]*f.normal[2]);
+	if(len > 0)
+	{
+		for(size_t i = 0; i < 3; ++i)
+		{ f.normal[i] /= len; }
+	}
+	f.offset = f.normal[0]*points[a].x + f.normal[1]*points[a].y + f.normal[2]*points[a].z;
+	f.deleted = false;
+	f.visible = false;
+	return f;
+}
+
+/// @brief index of the edge a -> b in the face
+size_t find_edge(HullFace const &f, uint32_t a, uint32_t b)
+{
+	for(size_t i = 0; i < 3; ++i)
+	{
+		if(f.v[i] == a && f.v[(i+1)%3] == b)
+		{ return i; }
+	}
+	return 3;
+}
+
+/// @brief assign the point to the face it's furthest outside of
+void assign_point(std::vector<HullFace> &faces, std::vector<size_t> const &candidates,
+	std::vector<Ogre::Vector3> const &points, uint32_t p, Ogre::Real eps)
+{
+	size_t best = faces.size();
+	double best_dist = eps;
+	for(size_t i = 0; i < candidates.size(); ++i)
+	{
+		double d = faces[candidates[i]].distance(points[p]);
+		if(d > best_dist)
+		{
+			best_dist = d;
+			best = candidates[i];
+		}
+	}
+
+	if(best != faces.size())
+	{
+		HullFace &f = faces[best];
+		// Keep the furthest point first
+		f.outside.push_back(p);
+		if(f.distance(points[f.outside.front()]) < best_dist)
+		{ std::swap(f.outside.front(), f.outside.back()); }
+	}
+}
+
+Ogre::Real hull_volume(std::vector<Ogre::Vector3> const &points, std::vector<uint32_t> const &triangles)
+{
+	if(triangles.empty())
+	{ return 0; }
+
+	Ogre::Vector3 const &o = points[triangles[0]];
+	Ogre::Real volume = 0;
+	for(size_t i = 0; i+2 < triangles.size(); i += 3)
+	{
+		Ogre::Vector3 a = points[triangles[i]] - o;
+		Ogre::Vector3 b = points[triangles[i+1]] - o;
+		Ogre::Vector3 c = points[triangles[i+2]] - o;
+		volume += a.dotProduct(b.crossProduct(c));
+	}
+	return volume/6;
+}
+
+/// ------------------------- Decomposition --------------------------------
+/// @brief evenly distributed unit vectors
+std::vector<Ogre::Vector3> create_directions(size_t n)
+{
+	std::vector<Ogre::Vector3> dirs;
+	dirs.reserve(n);
+	Ogre::Real const golden_angle = Ogre::Math::PI*(3 - std::sqrt(Ogre::Real(5)));
+	for(size_t i = 0; i < n; ++i)
+	{
+		Ogre::Real z = 1 - (2*Ogre::Real(i) + 1)/n;
+		Ogre::Real r = std::sqrt(std::max(Ogre::Real(0), 1 - z*z));
+		Ogre::Real phi = golden_angle*i;
+		dirs.push_back(Ogre::Vector3(r*std::cos(phi), r*std::sin(phi), z));
+	}
+	return dirs;
+}
+
+/// @brief points that are extreme in any of the directions
+void extreme_points(std::vector<Ogre::Vector3> const &points, std::vector<uint32_t> const &subset,
+	std::vector<Ogre::Vector3> const &dirs, std::vector<Ogre::Vector3> &out)
+{
+	std::vector<uint32_t> best(dirs.size(), subset.front());
+	std::vector<Ogre::Real> best_dist(dirs.size(), -std::numeric_limits<Ogre::Real>::max());
+	for(size_t i = 0; i < subset.size(); ++i)
+	{
+		Ogre::Vector3 const &p = points[subset[i]];
+		for(size_t j = 0; j < dirs.size(); ++j)
+		{
+			Ogre::Real d = dirs[j].dotProduct(p);
+			if(d > best_dist[j])
+			{
+				best_dist[j] = d;
+				best[j] = subset[i];
+			}
+		}
+	}
+
+	std::sort(best.begin(), best.end());
+	best.erase(std::unique(best.begin(), best.end()), best.end());
+
+	out.clear();
+	for(size_t i = 0; i < best.size(); ++i)
+	{ out.push_back(points[best[i]]); }
+}
+
+/// Triangles of a piece of the mesh
+struct Piece
+{
+	Piece(void) : concavity(0), volume(0), split_axis(0), split_position(0) {}
+
+	std::vector<uint32_t> triangles;
+	/// Unique vertices used by the triangles
+	std::vector<uint32_t> vertices;
+
+	Ogre::Real concavity;
+	Ogre::Real volume;
+
+	/// Position of the deepest triangle, used as a split candidate
+	size_t split_axis;
+	Ogre::Real split_position;
+};
+
+void collect_vertices(Piece &piece)
+{
+	piece.vertices = piece.triangles;
+	std::sort(piece.vertices.begin(), piece.vertices.end());
+	piece.vertices.erase(std::unique(piece.vertices.begin(), piece.vertices.end()), piece.vertices.end());
+}
+
+/// @brief approximate hull volume of a set of vertices
+Ogre::Real approximate_volume(std::vector<Ogre::Vector3> const &points, std::vector<uint32_t> const &subset,
+	std::vector<Ogre::Vector3> const &dirs)
+{
+	if(subset.size() < 4)
+	{ return 0; }
+
+	std::vector<Ogre::Vector3> hull_points;
+	extreme_points(points, subset, dirs, hull_points);
+	std::vector<uint32_t> triangles;
+	if(!vl::physics::compute_convex_hull(hull_points, triangles))
+	{ return 0; }
+	return hull_volume(hull_points, triangles);
+}
+
+/// @brief calculate the concavity and volume of the piece
+void evaluate_piece(std::vector<Ogre::Vector3> const &points, Piece &piece,
+	std::vector<Ogre::Vector3> const &dirs)
+{
+	piece.concavity = 0;
+	piece.volume = 0;
+	if(piece.vertices.size() < 4)
+	{ return; }
+
+	std::vector<Ogre::Vector3> hull_points;
+	extreme_points(points, piece.vertices, dirs, hull_points);
+	std::vector<uint32_t> triangles;
+	// Flat pieces are convex
+	if(!vl::physics::compute_convex_hull(hull_points, triangles))
+	{ return; }
+
+	piece.volume = hull_volume(hull_points, triangles);
+
+	std::vector<Ogre::Vector3> normals;
+	std::vector<Ogre::Real> offsets;
+	for(size_t i = 0; i+2 < triangles.size(); i += 3)
+	{
+		Ogre::Vector3 const &a = hull_points[triangles[i]];
+		Ogre::Vector3 n = (hull_points[triangles[i+1]] - a).crossProduct(hull_points[triangles[i+2]] - a);
+		Ogre::Real len = n.length();
+		if(len <= 0)
+		{ continue; }
+		n /= len;
+		normals.push_back(n);
+		offsets.push_back(n.dotProduct(a));
+	}
+
+	// Split through the deepest point along the longest axis of the piece
+	Ogre::Vector3 min(std::numeric_limits<Ogre::Real>::max());
+	Ogre::Vector3 max(-std::numeric_limits<Ogre::Real>::max());
+	for(size_t i = 0; i < hull_points.size(); ++i)
+	{
+		min.makeFloor(hull_points[i]);
+		max.makeCeil(hull_points[i]);
+	}
+	Ogre::Vector3 size = max - min;
+	piece.split_axis = (size.x >= size.y && size.x >= size.z) ? 0 : (size.y >= size.z ? 1 : 2);
+
+	// Distance from the triangle centroids to the hull along the outward
+	// triangle normal. Vertices are not enough because in extruded shapes
+	// all of them are on the caps of the hull.
+	for(size_t i = 0; i+2 < piece.triangles.size(); i += 3)
+	{
+		Ogre::Vector3 const &a = points[piece.triangles[i]];
+		Ogre::Vector3 const &b = points[piece.triangles[i+1]];
+		Ogre::Vector3 const &c = points[piece.triangles[i+2]];
+		Ogre::Vector3 n = (b - a).crossProduct(c - a);
+		Ogre::Real len = n.length();
+		if(len <= 0)
+		{ continue; }
+		n /= len;
+		Ogre::Vector3 p = (a + b + c)/3;
+
+		Ogre::Real depth = std::numeric_limits<Ogre::Real>::max();
+		for(size_t j = 0; j < normals.size() && depth > piece.concavity; ++j)
+		{
+			Ogre::Real cos_angle = normals[j].dotProduct(n);
+			if(cos_angle > 1e-6)
+			{ depth = std::min(depth, (offsets[j] - normals[j].dotProduct(p))/cos_angle); }
+		}
+
+		if(depth > piece.concavity && depth < std::numeric_limits<Ogre::Real>::max())
+		{
+			piece.concavity = depth;
+			piece.split_position = p[piece.split_axis];
+		}
+	}
+}
+
+/// @brief point where the edge a -> b crosses the plane, shared by the triangles of the edge
+uint32_t cut_edge(std::vector<Ogre::Vector3> &points, std::map<std::pair<uint32_t, uint32_t>, uint32_t> &cuts,
+	size_t axis, Ogre::Real position, uint32_t a, uint32_t b)
+{
+	std::pair<uint32_t, uint32_t> key(std::min(a, b), std::max(a, b));
+	std::map<std::pair<uint32_t, uint32_t>, uint32_t>::iterator iter = cuts.find(key);
+	if(iter != cuts.end())
+	{ return iter->second; }
+
+	Ogre::Vector3 const &p0 = points[key.first];
+	Ogre::Vector3 const &p1 = points[key.second];
+	Ogre::Real t = (position - p0[axis])/(p1[axis] - p0[axis]);
+	Ogre::Vector3 p = p0 + (p1 - p0)*t;
+	// Exactly on the plane, floating point error can move it off
+	p[axis] = position;
+	points.push_back(p);
+	cuts[key] = points.size()-1;
+	return points.size()-1;
+}
+
+/// @brief clip the triangles of the piece with an axis aligned plane
+/// New vertices are added to the end of points, winding is preserved.
+void clip_piece(std::vector<Ogre::Vector3> &points, Piece const &piece,
+	size_t axis, Ogre::Real position, Piece &front, Piece &back)
+{
+	front.triangles.clear();
+	back.triangles.clear();
+	std::map<std::pair<uint32_t, uint32_t>, uint32_t> cuts;
+	for(size_t i = 0; i+2 < piece.triangles.size(); i += 3)
+	{
+		uint32_t const *tri = &piece.triangles[i];
+		bool in_front[3];
+		bool has_front = false, has_back = false;
+		for(size_t k = 0; k < 3; ++k)
+		{
+			Ogre::Real d = points[tri[k]][axis] - position;
+			in_front[k] = d > 0;
+			has_front = has_front || d > 0;
+			has_back = has_back || d < 0;
+		}
+
+		// Triangles touching the plane are not clipped and triangles
+		// on the plane go to the side behind them
+		if(!has_front || !has_back)
+		{
+			bool to_front = has_front;
+			if(!has_front && !has_back)
+			{
+				Ogre::Vector3 const &a = points[tri[0]];
+				Ogre::Vector3 n = (points[tri[1]] - a).crossProduct(points[tri[2]] - a);
+				to_front = n[axis] < 0;
+			}
+			Piece &side = to_front ? front : back;
+			side.triangles.insert(side.triangles.end(), tri, tri+3);
+			continue;
+		}
+
+		// The vertex alone on it's side and the next two in winding order
+		size_t k = (in_front[0] == in_front[1]) ? 2 : (in_front[0] == in_front[2] ? 1 : 0);
+		uint32_t v0 = tri[k];
+		uint32_t v1 = tri[(k+1)%3];
+		uint32_t v2 = tri[(k+2)%3];
+		uint32_t c01 = cut_edge(points, cuts, axis, position, v0, v1);
+		uint32_t c20 = cut_edge(points, cuts, axis, position, v2, v0);
+
+		Piece &single = in_front[k] ? front : back;
+		Piece &other = in_front[k] ? back : front;
+		uint32_t const single_tri[3] = { v0, c01, c20 };
+		uint32_t const other_tris[6] = { c01, v1, v2, c01, v2, c20 };
+		single.triangles.insert(single.triangles.end(), single_tri, single_tri+3);
+		other.triangles.insert(other.triangles.end(), other_tris, other_tris+6);
+	}
+
+	collect_vertices(front);
+	collect_vertices(back);
+}
+
+/// @brief split the piece with an axis aligned plane that minimises the hull volumes
+/// Vertices on the split plane are added to points.
+/// @return false if no plane splits the piece
+bool split_piece(std::vector<Ogre::Vector3> &points, Piece const &piece,
+	std::vector<Ogre::Vector3> const &dirs, Piece &front, Piece &back)
+{
+	Ogre::Vector3 min(std::numeric_limits<Ogre::Real>::max());
+	Ogre::Vector3 max(-std::numeric_limits<Ogre::Real>::max());
+	for(size_t i = 0; i < piece.vertices.size(); ++i)
+	{
+		min.makeFloor(points[piece.vertices[i]]);
+		max.makeCeil(points[piece.vertices[i]]);
+	}
+
+	std::vector<std::pair<size_t, Ogre::Real> > candidates;
+	candidates.push_back(std::make_pair(piece.split_axis, piece.split_position));
+	for(size_t axis = 0; axis < 3; ++axis)
+	{
+		for(size_t i = 1; i < 4; ++i)
+		{ candidates.push_back(std::make_pair(axis, min[axis] + (max[axis] - min[axis])*i/4)); }
+	}
+
+	Ogre::Real best_cost = std::numeric_limits<Ogre::Real>::max();
+	size_t best = candidates.size();
+	size_t n_points = points.size();
+	Piece f, b;
+	for(size_t c = 0; c < candidates.size(); ++c)
+	{
+		clip_piece(points, piece, candidates[c].first, candidates[c].second, f, b);
+
+		// Split vertices are only kept for the selected plane
+		if(!f.triangles.empty() && !b.triangles.empty())
+		{
+			Ogre::Real cost = approximate_volume(points, f.vertices, dirs) + approximate_volume(points, b.vertices, dirs);
+			if(cost < best_cost)
+			{
+				best_cost = cost;
+				best = c;
+			}
+		}
+		points.resize(n_points);
+	}
+
+	if(best == candidates.size())
+	{ return false; }
+
+	clip_piece(points, piece, candidates[best].first, candidates[best].second, front, back);
+	return true;
+}
+
+/// @brief read triangles from all the SubMeshes with vertices clustered to a grid
+void read_triangles(vl::Mesh const &mesh, uint32_t resolution,
+	std::vector<Ogre::Vector3> &points, std::vector<uint32_t> &triangles)
+{
+	std::vector<Ogre::Vector3> positions;
+	std::vector<uint32_t> indices;
+	for(size_t i = 0; i < mesh.getNumSubMeshes(); ++i)
+	{
+		vl::SubMesh const *sm = mesh.getSubMesh(i);
+		if(sm->operationType != Ogre::RenderOperation::OT_TRIANGLE_LIST)
+		{ continue; }
+
+		vl::VertexData const *data = sm->useSharedGeometry ? mesh.sharedVertexData : sm->vertexData;
+		std::vector<Ogre::Vector3> sm_positions;
+		if(!data || !vl::read_positions(*data, sm_positions))
+		{ continue; }
+
+		uint32_t base = positions.size();
+		positions.insert(positions.end(), sm_positions.begin(), sm_positions.end());
+		for(size_t j = 0; j+2 < sm->indexData.indexCount(); j += 3)
+		{
+			for(size_t k = 0; k < 3; ++k)
+			{
+				uint32_t index = sm->indexData[j+k];
+				if(index >= sm_positions.size())
+				{ break; }
+				indices.push_back(base + index);
+			}
+			// Remove incomplete triangle
+			indices.resize(indices.size() - indices.size()%3);
+		}
+	}
+
+	points.clear();
+	triangles.clear();
+	if(positions.empty() || indices.empty())
+	{ return; }
+
+	Ogre::Vector3 min(std::numeric_limits<Ogre::Real>::max());
+	Ogre::Vector3 max(-std::numeric_limits<Ogre::Real>::max());
+	for(size_t i = 0; i < indices.size(); ++i)
+	{
+		min.makeFloor(positions[indices[i]]);
+		max.makeCeil(positions[indices[i]]);
+	}
+	Ogre::Vector3 size = max - min;
+	Ogre::Real cell = std::max(size.x, std::max(size.y, size.z))/std::max(resolution, uint32_t(1));
+	if(cell <= 0)
+	{ return; }
+
+	// Cluster vertices to the average of the vertices in the cell
+	typedef std::map<uint64_t, uint32_t> CellMap;
+	CellMap cells;
+	std::vector<uint32_t> remap(positions.size(), std::numeric_limits<uint32_t>::max());
+	std::vector<uint32_t> counts;
+	for(size_t i = 0; i < indices.size(); ++i)
+	{
+		uint32_t index = indices[i];
+		if(remap[index] != std::numeric_limits<uint32_t>::max())
+		{ continue; }
+
+		Ogre::Vector3 c = (positions[index] - min)/cell;
+		uint64_t key = (uint64_t(c.x) << 42) | (uint64_t(c.y) << 21) | uint64_t(c.z);
+		std::pair<CellMap::iterator, bool> res = cells.insert(std::make_pair(key, (uint32_t)points.size()));
+		if(res.second)
+		{
+			points.push_back(Ogre::Vector3::ZERO);
+			counts.push_back(0);
+		}
+		remap[index] = res.first->second;
+		points[remap[index]] += positions[index];
+		++counts[remap[index]];
+	}
+
+	for(size_t i = 0; i < points.size(); ++i)
+	{ points[i] /= counts[i]; }
+
+	for(size_t i = 0; i+2 < indices.size(); i += 3)
+	{
+		uint32_t a = remap[indices[i]];
+		uint32_t b = remap[indices[i+1]];
+		uint32_t c = remap[indices[i+2]];
+		if(a == b || b == c || a == c)
+		{ continue; }
+		triangles.push_back(a);
+		triangles.push_back(b);
+		triangles.push_back(c);
+	}
+}
+
+}	// unamed namespace
+
+/// ----------------------------- Public -------------------------------------
+uint64_t
+vl::physics::hash_convex_decomposition(vl::Mesh const &mesh, ConvexDecompositionSettings const &settings)
+{
+	uint64_t hash = vl::calculate_mesh_hash(mesh);
+	hash_value(hash, CACHE_VERSION);
+	hash_value(hash, settings.max_concavity);
+	hash_value(hash, settings.max_hulls);
+	hash_value(hash, settings.max_hull_vertices);
+	hash_value(hash, settings.resolution);
+	return hash;
+}
+
+void
+vl::physics::decompose_convex(vl::Mesh const &mesh, ConvexDecompositionSettings const &settings,
+	ConvexDecomposition &decomposition)
+{
+	decomposition.hash = hash_convex_decomposition(mesh, settings);
+	decomposition.hulls.clear();
+
+	std::vector<Ogre::Vector3> points;
+	Piece root;
+	read_triangles(mesh, settings.resolution, points, root.triangles);
+	if(root.triangles.empty())
+	{ return; }
+
+	collect_vertices(root);
+
+	Ogre::Vector3 min(std::numeric_limits<Ogre::Real>::max());
+	Ogre::Vector3 max(-std::numeric_limits<Ogre::Real>::max());
+	for(size_t i = 0; i < points.size(); ++i)
+	{
+		min.makeFloor(points[i]);
+		max.makeCeil(points[i]);
+	}
+	Ogre::Real max_concavity = settings.max_concavity*(max - min).length();
+
+	std::vector<Ogre::Vector3> dirs = create_directions(N_DIRECTIONS);
+	std::vector<Ogre::Vector3> split_dirs = create_directions(N_SPLIT_DIRECTIONS);
+
+	std::vector<Piece> pieces;
+	evaluate_piece(points, root, dirs);
+	pieces.push_back(root);
+
+	// Split the most concave piece till all are convex enough
+	while(pieces.size() < std::max(settings.max_hulls, uint32_t(1)))
+	{
+		size_t worst = 0;
+		for(size_t i = 1; i < pieces.size(); ++i)
+		{
+			if(pieces[i].concavity > pieces[worst].concavity)
+			{ worst = i; }
+		}
+
+		if(pieces[worst].concavity <= max_concavity)
+		{ break; }
+
+		Piece front, back;
+		if(!split_piece(points, pieces[worst], split_dirs, front, back))
+		{
+			// Can't be split so stop trying
+			pieces[worst].concavity = 0;
+			continue;
+		}
+
+		evaluate_piece(points, front, dirs);
+		evaluate_piece(points, back, dirs);
+		pieces[worst] = front;
+		pieces.push_back(back);
+	}
+
+	// Simplified hulls for the pieces
+	std::vector<Ogre::Vector3> hull_dirs = create_directions(std::max(settings.max_hull_vertices, uint32_t(4)));
+	for(size_t i = 0; i < pieces.size(); ++i)
+	{
+		std::vector<Ogre::Vector3> hull;
+		extreme_points(points, pieces[i].vertices, hull_dirs, hull);
+		if(!hull.empty())
+		{ decomposition.hulls.push_back(hull); }
+	}
+}
+
+void
+vl::physics::load_convex_decomposition(vl::Mesh const &mesh, ConvexDecompositionSettings const &settings,
+	ConvexDecomposition &decomposition)
+{
+	std::string cache;
+	if(!mesh.getFilePath().empty())
+	{ cache = get_convex_decomposition_cache(mesh.getFilePath()); }
+
+	if(!cache.empty() && read_convex_decomposition(cache, decomposition)
+		&& decomposition.hash == hash_convex_decomposition(mesh, settings))
+	{ return; }
+
+	std::clog << "Decomposing mesh " << mesh.getName() << " to convex hulls." << std::endl;
+	decompose_convex(mesh, settings, decomposition);
+	std::clog << "Mesh " << mesh.getName() << " decomposed to " << decomposition.hulls.size()
+		<< " hulls." << std::endl;
+
+	if(!cache.empty() && !write_convex_decomposition(cache, decomposition))
+	{ std::clog << "Couldn't write convex decomposition cache " << cache << std::endl; }
+}
+
+std::string
+vl::physics::get_convex_decomposition_cache(std::string const &mesh_file)
+{
+	fs::path path(mesh_file);
+	path.replace_extension(".hulls");
+	return path.string();
+}
+
+bool
+vl::physics::read_convex_decomposition(std::string const &file, ConvexDecomposition &decomposition)
+{
+	std::ifstream ifs(file.c_str(), std::ios::binary);
+	if(!ifs)
+	{ return false; }
+
+	char magic[sizeof(CACHE_MAGIC)];
+	uint32_t version = 0;
+	ifs.read(magic, sizeof(magic));
+	ifs.read((char *)&version, sizeof(version));
+	if(!ifs || std::string(magic, sizeof(magic)) != std::string(CACHE_MAGIC, sizeof(CACHE_MAGIC))
+		|| version != CACHE_VERSION)
+	{ return false; }
+
+	ConvexDecomposition res;
+	uint32_t n_hulls = 0;
+	ifs.read((char *)&res.hash, sizeof(res.hash));
+	ifs.read((char *)&n_hulls, sizeof(n_hulls));
+	for(uint32_t i = 0; i < n_hulls && ifs; ++i)
+	{
+		uint32_t n_vertices = 0;
+		ifs.read((char *)&n_vertices, sizeof(n_vertices));
+		// Sanity check against corrupted files
+		if(!ifs || n_vertices > (1 << 16))
+		{ return false; }
+
+		std::vector<Ogre::Vector3> hull(n_vertices);
+		for(uint32_t j = 0; j < n_vertices; ++j)
+		{ ifs.read((char *)hull[j].ptr(), 3*sizeof(Ogre::Real)); }
+		res.hulls.push_back(hull);
+	}
+
+	if(!ifs)
+	{ return false; }
+
+	decomposition = res;
+	return true;
+}
+
+bool
+vl::physics::write_convex_decomposition(std::string const &file, ConvexDecomposition const &decomposition)
+{
+	std::ofstream ofs(file.c_str(), std::ios::binary);
+	if(!ofs)
+	{ return false; }
+
+	ofs.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	ofs.write((char const *)&CACHE_VERSION, sizeof(CACHE_VERSION));
+	ofs.write((char const *)&decomposition.hash, sizeof(decomposition.hash));
+	uint32_t n_hulls = decomposition.hulls.size();
+	ofs.write((char const *)&n_hulls, sizeof(n_hulls));
+	for(size_t i = 0; i < decomposition.hulls.size(); ++i)
+	{
+		std::vector<Ogre::Vector3> const &hull = decomposition.hulls[i];
+		uint32_t n_vertices = hull.size();
+		ofs.write((char const *)&n_vertices, sizeof(n_vertices));
+		for(size_t j = 0; j < hull.size(); ++j)
+		{ ofs.write((char const *)hull[j].ptr(), 3*sizeof(Ogre::Real)); }
+	}
+
+	return ofs.good();
+}
+
+bool
+vl::physics::compute_convex_hull(std::vector<Ogre::Vector3> const &points, std::vector<uint32_t> &triangles)
+{
+	triangles.clear();
+	if(points.size() < 4)
+	{ return false; }
+
+	// Initial tetrahedron from the extreme points
+	uint32_t extremes[6] = { 0, 0, 0, 0, 0, 0 };
+	for(uint32_t i = 0; i < points.size(); ++i)
+	{
+		for(size_t axis = 0; axis < 3; ++axis)
+		{
+			if(points[i][axis] < points[extremes[2*axis]][axis])
+			{ extremes[2*axis] = i; }
+			if(points[i][axis] > points[extremes[2*axis+1]][axis])
+			{ extremes[2*axis+1] = i; }
+		}
+	}
+
+	uint32_t v0 = 0, v1 = 0;
+	Ogre::Real max_dist = 0;
+	for(size_t i = 0; i < 6; ++i)
+	{
+		for(size_t j = i+1; j < 6; ++j)
+		{
+			Ogre::Real d = points[extremes[i]].squaredDistance(points[extremes[j]]);
+			if(d > max_dist)
+			{
+				max_dist = d;
+				v0 = extremes[i];
+				v1 = extremes[j];
+			}
+		}
+	}
+
+	Ogre::Real const eps = std::sqrt(max_dist)*1e-5;
+	if(max_dist <= 0)
+	{ return false; }
+
+	// Furthest from the line
+	uint32_t v2 = v0;
+	max_dist = 0;
+	Ogre::Vector3 line = (points[v1] - points[v0]).normalisedCopy();
+	for(uint32_t i = 0; i < points.size(); ++i)
+	{
+		Ogre::Real d = line.crossProduct(points[i] - points[v0]).length();
+		if(d > max_dist)
+		{
+			max_dist = d;
+			v2 = i;
+		}
+	}
+	if(max_dist <= eps)
+	{ return false; }
+
+	// Furthest from the plane
+	uint32_t v3 = v0;
+	max_dist = 0;
+	Ogre::Vector3 normal = (points[v1] - points[v0]).crossProduct(points[v2] - points[v0]).normalisedCopy();
+	for(uint32_t i = 0; i < points.size(); ++i)
+	{
+		Ogre::Real d = std::abs(normal.dotProduct(points[i] - points[v0]));
+		if(d > max_dist)
+		{
+			max_dist = d;
+			v3 = i;
+		}
+	}
+	if(max_dist <= eps)
+	{ return false; }
+
+	if(normal.dotProduct(points[v3] - points[v0]) > 0)
+	{ std::swap(v1, v2); }
+
+	std::vector<HullFace> faces;
+	faces.push_back(create_face(points, v0, v1, v2));
+	faces.push_back(create_face(points, v0, v3, v1));
+	faces.push_back(create_face(points, v1, v3, v2));
+	faces.push_back(create_face(points, v2, v3, v0));
+	for(size_t i = 0; i < 4; ++i)
+	{
+		for(size_t e = 0; e < 3; ++e)
+		{
+			for(size_t j = 0; j < 4; ++j)
+			{
+				if(find_edge(faces[j], faces[i].v[(e+1)%3], faces[i].v[e]) < 3)
+				{ faces[i].n[e] = j; }
+			}
+		}
+	}
+
+	std::vector<size_t> candidates;
+	for(size_t i = 0; i < 4; ++i)
+	{ candidates.push_back(i); }
+	for(uint32_t i = 0; i < points.size(); ++i)
+	{
+		if(i != v0 && i != v1 && i != v2 && i != v3)
+		{ assign_point(faces, candidates, points, i, eps); }
+	}
+
+	std::vector<size_t> visible;
+	std::vector<size_t> stack;
+	std::vector<std::pair<uint32_t, uint32_t> > horizon;
+	std::vector<size_t> horizon_faces;
+	std::map<uint32_t, size_t> by_start;
+	// Current face is always removed and the new faces are added to the end
+	for(size_t current = 0; current < faces.size(); ++current)
+	{
+		if(faces[current].deleted || faces[current].outside.empty())
+		{ continue; }
+
+		uint32_t eye = faces[current].outside.front();
+		Ogre::Vector3 const &p = points[eye];
+
+		// Faces visible from the eye point and the horizon edges around them
+		visible.clear();
+		horizon.clear();
+		horizon_faces.clear();
+		stack.assign(1, current);
+		faces[current].visible = true;
+		while(!stack.empty())
+		{
+			size_t f = stack.back();
+			stack.pop_back();
+			visible.push_back(f);
+			for(size_t e = 0; e < 3; ++e)
+			{
+				size_t n = faces[f].n[e];
+				if(faces[n].visible)
+				{ continue; }
+
+				// Only faces the point is strictly in front of are visible,
+				// coplanar neighbours stay and become part of the horizon.
+				// Points within eps are never assigned as outside so the
+				// point is always clearly in front of the current face.
+				if(faces[n].distance(p) > 0)
+				{
+					faces[n].visible = true;
+					stack.push_back(n);
+				}
+				else
+				{
+					horizon.push_back(std::make_pair(faces[f].v[e], faces[f].v[(e+1)%3]));
+					horizon_faces.push_back(n);
+				}
+			}
+		}
+
+		// New faces connecting the horizon to the eye
+		size_t first_new = faces.size();
+		by_start.clear();
+		for(size_t i = 0; i < horizon.size(); ++i)
+		{
+			size_t index = faces.size();
+			faces.push_back(create_face(points, horizon[i].first, horizon[i].second, eye));
+			HullFace &nf = faces.back();
+			nf.n[0] = horizon_faces[i];
+
+			HullFace &other = faces[horizon_faces[i]];
+			size_t e = find_edge(other, horizon[i].second, horizon[i].first);
+			if(e > 2 || !by_start.insert(std::make_pair(horizon[i].first, index)).second)
+			{ return false; }
+			other.n[e] = index;
+		}
+
+		for(size_t i = first_new; i < faces.size(); ++i)
+		{
+			// Edge b -> eye borders the face starting from b and eye -> a
+			// the face ending in a
+			std::map<uint32_t, size_t>::iterator next = by_start.find(faces[i].v[1]);
+			if(next == by_start.end())
+			{ return false; }
+			faces[i].n[1] = next->second;
+			faces[next->second].n[2] = i;
+		}
+
+		// Reassign the outside points of the removed faces
+		candidates.clear();
+		for(size_t i = first_new; i < faces.size(); ++i)
+		{ candidates.push_back(i); }
+		for(size_t i = 0; i < visible.size(); ++i)
+		{
+			HullFace &f = faces[visible[i]];
+			f.deleted = true;
+			for(size_t j = 0; j < f.outside.size(); ++j)
+			{
+				if(f.outside[j] != eye)
+				{ assign_point(faces, candidates, points, f.outside[j], eps); }
+			}
+			std::vector<uint32_t>().swap(f.outside);
+		}
+	}
+
+	for(size_t i = 0; i < faces.size(); ++i)
+	{
+		if(!faces[i].deleted)
+		{ triangles.insert(triangles.end(), faces[i].v, faces[i].v+3); }
+	}
+
+	return true;
+}
@@ -0,0 +1,117 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file physics/convex_decomposition.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Approximate convex decomposition of triangle meshes for dynamic bodies.
+ *
+ *	Concave meshes are split recursively with axis aligned planes, always
+ *	splitting the piece that is furthest from being convex, until every
+ *	piece is within the concavity limit or the maximum number of hulls is
+ *	reached. Concavity of a piece is the longest distance from it's
+ *	triangles to it's convex hull along the triangle normals, so triangles
+ *	need to be counter clockwise from outside. Split planes are selected by
+ *	the smallest total hull volume.
+ *	Triangles are clipped by the split planes so the pieces don't overlap.
+ *
+ *	Decomposing is slow so the results are cached in a file next to the
+ *	mesh file. Cache is keyed by a hash of the geometry and settings so
+ *	modified meshes are decomposed again.
+ *
+ *	No Bullet dependencies, ConcaveHullShape converts the hulls.
+ */
+
+#ifndef HYDRA_PHYSICS_CONVEX_DECOMPOSITION_HPP
+#define HYDRA_PHYSICS_CONVEX_DECOMPOSITION_HPP
+
+#include "mesh.hpp"
+
+#include <vector>
+#include <string>
+
+namespace vl
+{
+
+namespace physics
+{
+
+struct ConvexDecompositionSettings
+{
+	ConvexDecompositionSettings(void)
+		: max_concavity(0.02)
+		, max_hulls(16)
+		, max_hull_vertices(32)
+		, resolution(64)
+	{}
+
+	/// Maximum concavity of a piece relative to the bounding box diagonal
+	vl::scalar max_concavity;
+
+	/// Maximum number of convex pieces
+	uint32_t max_hulls;
+
+	/// Hulls with more vertices are simplified
+	uint32_t max_hull_vertices;
+
+	/// Vertices are clustered to a grid with this many cells along the
+	/// longest axis before decomposing
+	uint32_t resolution;
+
+};	// struct ConvexDecompositionSettings
+
+struct ConvexDecomposition
+{
+	ConvexDecomposition(void)
+		: hash(0)
+	{}
+
+	/// Hash of the geometry and settings used
+	uint64_t hash;
+
+	/// Vertices of the convex pieces in mesh coordinates
+	std::vector< std::vector<Ogre::Vector3> > hulls;
+
+};	// struct ConvexDecomposition
+
+/// @brief hash of the mesh positions, indices and settings
+uint64_t hash_convex_decomposition(vl::Mesh const &mesh, ConvexDecompositionSettings const &settings);
+
+/// @brief decompose a triangle list mesh to convex hulls
+/// Uses all SubMeshes, meshes without triangles produce no hulls.
+void decompose_convex(vl::Mesh const &mesh, ConvexDecompositionSettings const &settings,
+	ConvexDecomposition &decomposition);
+
+/// @brief decompose using the cache file next to the mesh file if it's valid
+/// Mesh files are found with Mesh::getFilePath, generated meshes are not cached.
+void load_convex_decomposition(vl::Mesh const &mesh, ConvexDecompositionSettings const &settings,
+	ConvexDecomposition &decomposition);
+
+/// @brief name of the cache file for a mesh file
+std::string get_convex_decomposition_cache(std::string const &mesh_file);
+
+/// @return false if the file doesn't exist or is not a valid cache
+bool read_convex_decomposition(std::string const &file, ConvexDecomposition &decomposition);
+
+/// @return false if the file could not be written
+bool write_convex_decomposition(std::string const &file, ConvexDecomposition const &decomposition);
+
+/// @brief convex hull of a point set
+/// @param triangles indices to points for the hull faces, counter clockwise from outside
+/// @return false if the points are degenerate (less than four or coplanar)
+bool compute_convex_hull(std::vector<Ogre::Vector3> const &points, std::vector<uint32_t> &triangles);
+
+}	// namespace physics
+
+}	// namespace vl
+
+#endif	// HYDRA_PHYSICS_CONVEX_DECOMPOSITION_HPP
@@ -16,6 +16,49 @@
 
 #include "math/conversion.hpp"
 
+#include "base/filesystem.hpp"
+
+#include <fstream>
+#include <cstring>
+
+namespace
+{
+
+char const BVH_MAGIC[] = "HYDRA_BVH";
+uint32_t const BVH_VERSION = 1;
+
+/// Trees are stored as in memory so they depend on the Bullet version
+/// and the platform
+struct BvhHeader
+{
+	BvhHeader(void)
+		: version(BVH_VERSION)
+		, bullet_version(BT_BULLET_VERSION)
+		, pointer_size(sizeof(void *))
+		, scalar_size(sizeof(btScalar))
+		, hash(0)
+		, size(0)
+	{ ::memcpy(magic, BVH_MAGIC, sizeof(BVH_MAGIC)); }
+
+	bool valid(void) const
+	{
+		BvhHeader ref;
+		return ::memcmp(magic, ref.magic, sizeof(magic)) == 0 && version == ref.version
+			&& bullet_version == ref.bullet_version && pointer_size == ref.pointer_size
+			&& scalar_size == ref.scalar_size;
+	}
+
+	char magic[sizeof(BVH_MAGIC)];
+	uint32_t version;
+	uint32_t bullet_version;
+	uint32_t pointer_size;
+	uint32_t scalar_size;
+	uint64_t hash;
+	uint64_t size;
+};
+
+}	// unamed namespace
+
 void 
 vl::convert_bullet_geometry(vl::Mesh const *mesh, btTriangleIndexVertexArray *bt_mesh)
 {
@@ -81,3 +124,66 @@ vl::convert_bullet_geometry(vl::Mesh const *mesh, btTriangleIndexVertexArray *bt
 	btVector3 aabb_max = math::convert_bt_vec(mesh->getBounds().getMaximum());
 	bt_mesh->setPremadeAabb(aabb_min, aabb_max);
 }
+
+std::string
+vl::get_bullet_bvh_cache(std::string const &mesh_file)
+{
+	fs::path path(mesh_file);
+	path.replace_extension(".bvh");
+	return path.string();
+}
+
+/// -------------------------- BulletBvhCache --------------------------------
+vl::BulletBvhCache::BulletBvhCache(void)
+	: _buffer(0)
+{}
+
+vl::BulletBvhCache::~BulletBvhCache(void)
+{
+	btAlignedFree(_buffer);
+}
+
+btOptimizedBvh *
+vl::BulletBvhCache::read(std::string const &file, uint64_t hash)
+{
+	std::ifstream ifs(file.c_str(), std::ios::binary);
+	if(!ifs)
+	{ return 0; }
+
+	BvhHeader header;
+	ifs.read((char *)&header, sizeof(header));
+	if(!ifs || !header.valid() || header.hash != hash || header.size == 0)
+	{ return 0; }
+
+	// Deserialized in place so the buffer needs the alignment of the tree
+	btAlignedFree(_buffer);
+	_buffer = btAlignedAlloc(header.size, 16);
+	ifs.read((char *)_buffer, header.size);
+	if(!ifs)
+	{ return 0; }
+
+	return btOptimizedBvh::deSerializeInPlace(_buffer, header.size, false);
+}
+
+bool
+vl::BulletBvhCache::write(std::string const &file, uint64_t hash, btOptimizedBvh const *bvh)
+{
+	assert(bvh);
+
+	BvhHeader header;
+	header.hash = hash;
+	header.size = bvh->calculateSerializeBufferSize();
+
+	void *buffer = btAlignedAlloc(header.size, 16);
+	bool ok = bvh->serializeInPlace(buffer, header.size, false);
+	if(ok)
+	{
+		std::ofstream ofs(file.c_str(), std::ios::binary);
+		ofs.write((char const *)&header, sizeof(header));
+		ofs.write((char const *)buffer, header.size);
+		ok = ofs.good();
+	}
+	btAlignedFree(buffer);
+
+	return ok;
+}
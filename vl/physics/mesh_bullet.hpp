@@ -29,6 +29,36 @@ namespace vl
 
 void convert_bullet_geometry(vl::Mesh const *mesh, btTriangleIndexVertexArray *bt_mesh);
 
+/// @brief name of the BVH cache file for a mesh file
+std::string get_bullet_bvh_cache(std::string const &mesh_file);
+
+/// @brief BVH tree serialized to a file
+/// Building the tree for large static meshes takes seconds so it's saved
+/// after the first build. Trees are deserialized in place so the cache owns
+/// the memory of the loaded tree and needs to be kept as long as the tree.
+class BulletBvhCache
+{
+public :
+	BulletBvhCache(void);
+
+	~BulletBvhCache(void);
+
+	/// @brief load a tree from a file
+	/// @param hash mesh hash the tree needs to be built from
+	/// @return the tree or NULL if the file doesn't exist or is for different geometry
+	btOptimizedBvh *read(std::string const &file, uint64_t hash);
+
+	/// @return false if the file could not be written
+	static bool write(std::string const &file, uint64_t hash, btOptimizedBvh const *bvh);
+
+private :
+	BulletBvhCache(BulletBvhCache const &);
+	BulletBvhCache &operator=(BulletBvhCache const &);
+
+	void *_buffer;
+
+};	// class BulletBvhCache
+
 }	// namespace vl
 
 #endif // HYDRA_MESH_BULLET_HPP
\ No newline at end of file
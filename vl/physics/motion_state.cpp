@@ -16,9 +16,22 @@
 
 /// Concrete implementation
 #include "motion_state_bullet.hpp"
+/// Necessary for waiting for the threaded step
+#include "physics_world.hpp"
+
+#include "base/thread_check.hpp"
 
 vl::physics::MotionState *
 vl::physics::MotionState::create(vl::Transform const &t, vl::ObjectInterface *node)
 {
 	return new BulletMotionState(t, node);
 }
+
+void
+vl::physics::MotionState::_finishStep(void)
+{
+	vl::checkFrameThread("Physics objects");
+
+	if(_world)
+	{ _world->finishStep(); }
+}
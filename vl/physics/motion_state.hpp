@@ -19,6 +19,8 @@
 #include "math/transform.hpp"
 // Necessary for HYDRA_API
 #include "defines.hpp"
+// Necessary for WorldPtr
+#include "typedefs.hpp"
 
 #include "object_interface.hpp"
 
@@ -37,6 +39,7 @@ public:
 	MotionState(Transform const &t, vl::ObjectInterface *node = 0)
 		: _visibleobj(node)
 		, _trans(t)
+		, _world(0)
 	{
 		// set the object transform especially useful for static objects
 		if(_visibleobj)
@@ -67,13 +70,13 @@ public:
 	{ return _trans.position; }
 
 	void setPosition(Ogre::Vector3 const &v)
-	{ _trans.position = v; }
+	{ _finishStep(); _trans.position = v; }
 
 	Ogre::Quaternion const &getOrientation(void) const
 	{ return _trans.quaternion; }
 
 	void setOrientation(Ogre::Quaternion const &q)
-	{ _trans.quaternion = q; }
+	{ _finishStep(); _trans.quaternion = q; }
 
 	Transform const &getWorldTransform(void) const
 	{
@@ -82,6 +85,7 @@ public:
 
 	void setWorldTransform(vl::Transform const &worldTrans)
 	{
+		_finishStep();
 		_trans = worldTrans;
 
 		// silently return before we set a node
@@ -89,10 +93,20 @@ public:
 		{ _visibleobj->setWorldTransform(_trans); }
 	}
 
+	/// @internal set by the RigidBody using the state
+	void _setWorld(WorldPtr world)
+	{ _world = world; }
+
 protected:
+	/// @brief wait for a threaded step of the world to finish
+	/// Kinematic bodies read the state while stepping.
+	void _finishStep(void);
+
 	vl::ObjectInterface *_visibleobj;
 	vl::Transform _trans;
 
+	WorldPtr _world;
+
 };	// class MotionState
 
 inline std::ostream &
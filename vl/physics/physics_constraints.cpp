@@ -18,6 +18,10 @@
 /// Concrete implementation
 #include "physics_constraints_bullet.hpp"
 
+/// Necessary for waiting for the step
+#include "physics_world.hpp"
+#include "base/thread_check.hpp"
+
 std::ostream &
 vl::physics::operator<<(std::ostream &os, vl::physics::Constraint const &c)
 {
@@ -94,6 +98,8 @@ void
 vl::physics::Constraint::reset(RigidBodyRefPtr rbA, RigidBodyRefPtr rbB, 
 	Transform const &frameInA, Transform const &frameInB)
 {
+	_finishStep();
+
 	_bodyA = rbA;
 	_bodyB = rbB;
 	_frameA = frameInA;
@@ -102,6 +108,15 @@ vl::physics::Constraint::reset(RigidBodyRefPtr rbA, RigidBodyRefPtr rbB,
 	_reseted();
 }
 
+void
+vl::physics::Constraint::_finishStep(void) const
+{
+	vl::checkFrameThread("Physics objects");
+
+	if(_world)
+	{ _world->finishStep(); }
+}
+
 
 vl::physics::SixDofConstraintRefPtr
 vl::physics::SixDofConstraint::create(vl::physics::RigidBodyRefPtr rbA, vl::physics::RigidBodyRefPtr rbB, 
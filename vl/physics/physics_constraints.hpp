@@ -116,6 +116,16 @@ public :
 	bool isDynamic(void) const
 	{ return _is_dynamic; }
 
+	/// @internal set by the World the constraint is added to
+	void _setWorld(WorldPtr world)
+	{ _world = world; }
+
+	/// @internal
+	/// @brief check the calling thread and wait for a threaded step of the world to finish
+	/// Called before modifying the constraint or reading the simulated state
+	/// because the physics thread uses them while stepping.
+	void _finishStep(void) const;
+
 	virtual ~Constraint(void) {}
 
 protected :
@@ -126,6 +136,7 @@ protected :
 		, _frameA(frameInA)
 		, _frameB(frameInB)
 		, _is_dynamic(dynamic)
+		, _world(0)
 	{}
 
 private :
@@ -147,6 +158,8 @@ private :
 	std::string _name;
 
 	bool _is_dynamic;
+
+	WorldPtr _world;
 };
 
 /// @class SixDofConstraint
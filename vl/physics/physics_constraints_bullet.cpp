@@ -25,6 +25,8 @@ namespace {
 void
 vl::physics::Motor3DofTranslational::setTargetVelocity(Ogre::Vector3 const& vel)
 {
+	_finishStep();
+
 	_mot->m_targetVelocity = convert_bt_vec(vel);
 	
 	if(_lock_hack)
@@ -74,6 +76,8 @@ vl::physics::Motor3DofTranslational::setTargetVelocity(Ogre::Vector3 const& vel)
 void
 vl::physics::Motor3DofRotational::setTargetVelocity(Ogre::Vector3 const& vel) 
 {
+	_finishStep();
+
 	_mot.at(0)->m_targetVelocity = vel.x;
 	_mot.at(1)->m_targetVelocity = vel.y;
 	_mot.at(2)->m_targetVelocity = vel.z;
@@ -127,6 +131,14 @@ vl::physics::Motor3DofRotational::setTargetVelocity(Ogre::Vector3 const& vel)
 	
 }
 
+void
+vl::physics::Motor3DofTranslational::_finishStep(void)
+{ _constraint->_finishStep(); }
+
+void
+vl::physics::Motor3DofRotational::_finishStep(void)
+{ _constraint->_finishStep(); }
+
 /// ------------------------------ BulletSixDofConstraint --------------------
 vl::physics::BulletSixDofConstraint::BulletSixDofConstraint(RigidBodyRefPtr rbA, 
 	RigidBodyRefPtr rbB, Transform const &frameInA, Transform const &frameInB, 
@@ -52,6 +52,7 @@ public:
 
 	//Constraint lowerlimit:
 	virtual void			setLowerLimit(Ogre::Vector3 const& limit) {
+		_finishStep();
 		_mot->m_lowerLimit = convert_bt_vec(limit);
 	}
     virtual Ogre::Vector3	getLowerLimit(void) {
@@ -60,6 +61,7 @@ public:
 	
 	//Constraint upper limits:
 	virtual void			setUpperLimit(Ogre::Vector3 const& limit) {
+		_finishStep();
 		_mot->m_upperLimit = convert_bt_vec(limit);
 	}
     virtual Ogre::Vector3	getUpperLimit(void) {
@@ -85,6 +87,7 @@ public:
 
 	//Restitution parameter (0 = totally inelastic collision, 1 = totally elastic collision):
 	virtual void			setRestitution(vl::scalar const& restitution) {
+		_finishStep();
 		_mot->m_restitution = restitution;
 	}
 	
@@ -94,6 +97,7 @@ public:
 	
 	//Normal constraint force mixing factor:
 	virtual void			setNormalCFM(Ogre::Vector3 const& ncfm) {
+		_finishStep();
 		_mot->m_normalCFM = convert_bt_vec(ncfm);
 	}
     
@@ -103,6 +107,7 @@ public:
 	
 	//Error tolerance factor when joint is at limit:
 	virtual void			setStopERP(Ogre::Vector3 const& serp) {
+		_finishStep();
 		_mot->m_stopERP = convert_bt_vec(serp);
 	}
 	
@@ -112,6 +117,7 @@ public:
 	
 	//Constraint force mixing factor when joint is at limit:
 	virtual void			setStopCFM(Ogre::Vector3 const& scfm) {
+		_finishStep();
 		_mot->m_stopCFM = convert_bt_vec(scfm);
 	}
 	
@@ -128,6 +134,7 @@ public:
 	
     //Maximum force on motor, eg. maximum force used to achieve needed velocity:
 	virtual void			setMaxMotorForce(Ogre::Vector3 const& force) {
+		_finishStep();
 		_mot->m_maxMotorForce = convert_bt_vec(force);
 	}
 
@@ -137,6 +144,7 @@ public:
 
 	//Maximum returning torque when limit is violated (this is applied with rotational motors only):
 	virtual void			setMaxLimitTorque(Ogre::Vector3 const& torq) {
+		_finishStep();
 		
 	}
 
@@ -146,6 +154,7 @@ public:
 
 	virtual void enableLocking(bool enable)
 	{
+		_finishStep();
 		_lock_hack = enable;
 	}
 
@@ -156,6 +165,7 @@ public:
 
 	//Is one of 3 dof's enabled:
 	virtual void			enableMotor(int const index) {
+		_finishStep();
 		if(index == 0 || index == 1 || index == 2) {
 			_mot->m_enableMotor[index] = true;
 		}
@@ -164,6 +174,7 @@ public:
 		}
 	}
 	virtual void			disableMotor(int const index) {
+		_finishStep();
 		if(index == 0 || index == 1 || index == 2) {
 			_mot->m_enableMotor[index] = false;
 		}
@@ -174,18 +185,23 @@ public:
 	}
 	
 	virtual void			enableAllMotors(void) {
+		_finishStep();
 		_mot->m_enableMotor[0] = true;
 		_mot->m_enableMotor[1] = true;
 		_mot->m_enableMotor[2] = true;
 	}
 
 	virtual void			disableAllMotors(void) {
+		_finishStep();
 		_mot->m_enableMotor[0] = false;
 		_mot->m_enableMotor[1] = false;
 		_mot->m_enableMotor[2] = false;
 	}
 
 private:
+	/// @brief wait for the step of the constraint's world before modifying
+	void _finishStep(void);
+
 	btTranslationalLimitMotor *_mot;
 	BulletSixDofConstraint *_constraint;
 
@@ -210,6 +226,7 @@ public:
 
 	//Constraint lowerlimit:
 	virtual void			setLowerLimit(Ogre::Vector3 const& limit) {
+		_finishStep();
 		_mot.at(0)->m_loLimit = limit.x;
 		_mot.at(1)->m_loLimit = limit.y;
 		_mot.at(2)->m_loLimit = limit.z;
@@ -221,6 +238,7 @@ public:
 	
 	//Constraint upper limits:
 	virtual void			setUpperLimit(Ogre::Vector3 const& limit) {
+		_finishStep();
 		_mot.at(0)->m_hiLimit = (convert_bt_vec(limit)).getX();
 		_mot.at(1)->m_hiLimit = (convert_bt_vec(limit)).getY();
 		_mot.at(2)->m_hiLimit = (convert_bt_vec(limit)).getZ();
@@ -254,6 +272,7 @@ public:
 	//Restitution parameter (0 = totally inelastic collision, 1 = totally elastic collision),
 	//it's scalar on bullet documentation:
 	virtual void			setRestitution(vl::scalar const& restitution) {
+		_finishStep();
 		_mot.at(0)->m_bounce = restitution;
 		_mot.at(1)->m_bounce = restitution;
 		_mot.at(2)->m_bounce = restitution;
@@ -265,6 +284,7 @@ public:
 	
 	//Normal constraint force mixing factor:
 	virtual void			setNormalCFM(Ogre::Vector3 const& ncfm) {
+		_finishStep();
 		_mot.at(0)->m_normalCFM = ncfm.x;
 		_mot.at(1)->m_normalCFM = ncfm.y;
 		_mot.at(2)->m_normalCFM = ncfm.z;
@@ -276,6 +296,7 @@ public:
 	
 	//Error tolerance factor when joint is at limit:
 	virtual void			setStopERP(Ogre::Vector3 const& serp) {
+		_finishStep();
 		_mot.at(0)->m_stopERP = serp.x;
 		_mot.at(1)->m_stopERP = serp.y;
 		_mot.at(2)->m_stopERP = serp.z;
@@ -287,6 +308,7 @@ public:
 	
 	//Constraint force mixing factor when joint is at limit:
 	virtual void			setStopCFM(Ogre::Vector3 const& scfm) {
+		_finishStep();
 		_mot.at(0)->m_stopCFM = scfm.x;
 		_mot.at(1)->m_stopCFM = scfm.y;
 		_mot.at(2)->m_stopCFM = scfm.z;
@@ -305,6 +327,7 @@ public:
 	
     //Maximum force on motor, eg. maximum force used to achieve needed velocity:
 	virtual void			setMaxMotorForce(Ogre::Vector3 const& force) {
+		_finishStep();
 		_mot.at(0)->m_maxMotorForce = force.x;
 		_mot.at(1)->m_maxMotorForce = force.y;
 		_mot.at(2)->m_maxMotorForce = force.z;
@@ -318,6 +341,7 @@ public:
 
 	//Maximum returning torque when limit is violated (this is applied with rotational motors only):
 	virtual void			setMaxLimitTorque(Ogre::Vector3 const& torq) {
+		_finishStep();
 		_mot.at(0)->m_maxMotorForce = torq.x;
 		_mot.at(1)->m_maxMotorForce = torq.y;
 		_mot.at(2)->m_maxMotorForce = torq.z;
@@ -331,6 +355,7 @@ public:
 
 	virtual void enableLocking(bool enable)
 	{
+		_finishStep();
 		_lock_hack = enable;
 	}
 
@@ -341,6 +366,7 @@ public:
 
 	//Disabling and enabling motors:
 	virtual void			enableMotor(int const index) {		
+		_finishStep();
 		if(index == 0 || index == 1 || index == 2) {
 			_mot[index]->m_enableMotor = true;
 		}
@@ -350,6 +376,7 @@ public:
 	}
 
 	virtual void			disableMotor(int const index) {
+		_finishStep();
 		if(index == 0 || index == 1 || index == 2) {
 			_mot[index]->m_enableMotor = false;
 		}
@@ -360,18 +387,23 @@ public:
 	}
 
 	virtual void			enableAllMotors(void) {
+		_finishStep();
 		_mot.at(0)->m_enableMotor = true;
 		_mot.at(1)->m_enableMotor = true;
 		_mot.at(2)->m_enableMotor = true;
 	}
 
 	virtual void			disableAllMotors(void) {
+		_finishStep();
 		_mot.at(0)->m_enableMotor = false;
 		_mot.at(1)->m_enableMotor = false;
 		_mot.at(2)->m_enableMotor = false;
 	}
 
 private: 
+	/// @brief wait for the step of the constraint's world before modifying
+	void _finishStep(void);
+
 	std::vector<btRotationalLimitMotor*> _mot;
 	BulletSixDofConstraint *_constraint;
 
@@ -410,13 +442,19 @@ public :
 	{ return convert_vec(_bt_constraint->getTranslationalLimitMotor()->m_lowerLimit); }
 
 	void setLinearLowerLimit(Ogre::Vector3 const &linearLower)
-	{ _bt_constraint->setLinearLowerLimit(convert_bt_vec(linearLower)); }
+	{
+		_finishStep();
+		_bt_constraint->setLinearLowerLimit(convert_bt_vec(linearLower));
+	}
 
 	virtual Ogre::Vector3 getLinearUpperLimit(void) const
 	{ return convert_vec(_bt_constraint->getTranslationalLimitMotor()->m_upperLimit); }
 
 	void setLinearUpperLimit(Ogre::Vector3 const &linearUpper)
-	{ _bt_constraint->setLinearUpperLimit(convert_bt_vec(linearUpper)); }
+	{
+		_finishStep();
+		_bt_constraint->setLinearUpperLimit(convert_bt_vec(linearUpper));
+	}
 
 	virtual Ogre::Vector3 getAngularLowerLimit(void) const
 	{
@@ -427,7 +465,10 @@ public :
 	}
 
 	void setAngularLowerLimit(Ogre::Vector3 const &angularLower)
-	{ _bt_constraint->setAngularLowerLimit(convert_bt_vec(angularLower)); }
+	{
+		_finishStep();
+		_bt_constraint->setAngularLowerLimit(convert_bt_vec(angularLower));
+	}
 
 	virtual Ogre::Vector3 getAngularUpperLimit(void) const
 	{
@@ -438,11 +479,16 @@ public :
 	}
 
 	void setAngularUpperLimit(Ogre::Vector3 const &angularUpper)
-	{ _bt_constraint->setAngularUpperLimit(convert_bt_vec(angularUpper)); }
+	{
+		_finishStep();
+		_bt_constraint->setAngularUpperLimit(convert_bt_vec(angularUpper));
+	}
 
 	/// @brief Get the current position of the constraint relative to starting position
 	Ogre::Vector3 getCurrentPosition(void) const
 	{
+		_finishStep();
+
 		vl::scalar x = _bt_constraint->getRelativePivotPosition(0);
 		vl::scalar y = _bt_constraint->getRelativePivotPosition(1);
 		vl::scalar z = _bt_constraint->getRelativePivotPosition(2);
@@ -453,6 +499,8 @@ public :
 	/// @brief Get the current angle of the constraint relative to starting angle
 	Ogre::Vector3 getCurrentAngle(void) const
 	{
+		_finishStep();
+
 		vl::scalar x = _bt_constraint->getAngle(0);
 		vl::scalar y = _bt_constraint->getAngle(1);
 		vl::scalar z = _bt_constraint->getAngle(2);
@@ -472,34 +520,52 @@ public :
 	
 	void setFrameOffsetA(Transform const &trans)
 	{
+		_finishStep();
 		btTransform tr = convert_bt_transform(trans);
 		_bt_constraint->getFrameOffsetA() = tr;
 	}
 	
 	void setFrameOffsetB(Transform const &trans )
 	{
+		_finishStep();
 		btTransform tr = convert_bt_transform(trans);
 		_bt_constraint->getFrameOffsetB() = tr;
 	}
 
 
 	void enableSpring(int index, bool onOff)
-	{ _bt_constraint->enableSpring(index, onOff); }
+	{
+		_finishStep();
+		_bt_constraint->enableSpring(index, onOff);
+	}
 
 	void setStiffness(int index, vl::scalar stiffness)
-	{ _bt_constraint->setStiffness(index, stiffness); }
+	{
+		_finishStep();
+		_bt_constraint->setStiffness(index, stiffness);
+	}
 
 	void setDamping(int index, vl::scalar damping)
-	{ _bt_constraint->setDamping(index, damping); }
+	{
+		_finishStep();
+		_bt_constraint->setDamping(index, damping);
+	}
 
 	void setEquilibriumPoint(void)
-	{ _bt_constraint->setEquilibriumPoint(); }
+	{
+		_finishStep();
+		_bt_constraint->setEquilibriumPoint();
+	}
 
 	void setEquilibriumPoint(int index)
-	{ _bt_constraint->setEquilibriumPoint(index); }
+	{
+		_finishStep();
+		_bt_constraint->setEquilibriumPoint(index);
+	}
 
 	virtual void setNormalCFM(vl::scalar cfm)
 	{
+		_finishStep();
 		for(size_t i = 0; i < 6; ++i)
 		{
 			_bt_constraint->setParam(BT_6DOF_FLAGS_CFM_NORM, cfm, i);
@@ -508,6 +574,7 @@ public :
 
 	virtual void setStopCFM(vl::scalar cfm)
 	{
+		_finishStep();
 		for(size_t i = 0; i < 6; ++i)
 		{
 			_bt_constraint->setParam(BT_CONSTRAINT_STOP_CFM, cfm, i);
@@ -516,6 +583,7 @@ public :
 
 	virtual void setStopERP(vl::scalar erp)
 	{
+		_finishStep();
 		for(size_t i = 0; i < 6; ++i)
 		{
 			_bt_constraint->setParam(BT_6DOF_FLAGS_ERP_STOP, erp, i);
@@ -570,25 +638,37 @@ public :
 	{ return _bt_constraint->getLowerLinLimit(); }
 
 	void setLowerLinLimit(vl::scalar lowerLimit)
-	{ _bt_constraint->setLowerLinLimit(lowerLimit); }
+	{
+		_finishStep();
+		_bt_constraint->setLowerLinLimit(lowerLimit);
+	}
 
 	virtual vl::scalar getUpperLinLimit(void) const
 	{ return _bt_constraint->getUpperLinLimit(); }
 
 	void setUpperLinLimit(vl::scalar upperLimit)
-	{ _bt_constraint->setUpperLinLimit(upperLimit); }
+	{
+		_finishStep();
+		_bt_constraint->setUpperLinLimit(upperLimit);
+	}
 
 	vl::scalar getLowerAngLimit(void)
 	{ return _bt_constraint->getLowerAngLimit(); }
 	
 	void setLowerAngLimit(vl::scalar lowerLimit)
-	{ _bt_constraint->setLowerAngLimit(lowerLimit); }
+	{
+		_finishStep();
+		_bt_constraint->setLowerAngLimit(lowerLimit);
+	}
 
 	vl::scalar getUpperAngLimit(void)
 	{ return _bt_constraint->getUpperAngLimit(); }
 
 	void setUpperAngLimit(vl::scalar upperLimit)
-	{ _bt_constraint->setUpperAngLimit(upperLimit); }
+	{
+		_finishStep();
+		_bt_constraint->setUpperAngLimit(upperLimit);
+	}
 
 	bool getUseLinearReferenceFrameA(void)
 	{ return _bt_constraint->getUseLinearReferenceFrameA(); }
@@ -649,91 +729,163 @@ public :
 	{ return _bt_constraint->getDampingOrthoAng(); }
 
 	void setSoftnessDirLin(vl::scalar softnessDirLin)
-	{ _bt_constraint->setSoftnessDirLin(softnessDirLin); }
+	{
+		_finishStep();
+		_bt_constraint->setSoftnessDirLin(softnessDirLin);
+	}
 
 	void setRestitutionDirLin(vl::scalar restitutionDirLin)
-	{ _bt_constraint->setRestitutionDirLin(restitutionDirLin); }
+	{
+		_finishStep();
+		_bt_constraint->setRestitutionDirLin(restitutionDirLin);
+	}
 	
 	void setDampingDirLin(vl::scalar dampingDirLin)
-	{ _bt_constraint->setDampingDirLin(dampingDirLin); }
+	{
+		_finishStep();
+		_bt_constraint->setDampingDirLin(dampingDirLin);
+	}
 	
 	void setSoftnessDirAng(vl::scalar softnessDirAng)
-	{ _bt_constraint->setSoftnessDirAng(softnessDirAng); }
+	{
+		_finishStep();
+		_bt_constraint->setSoftnessDirAng(softnessDirAng);
+	}
 	
 	void setRestitutionDirAng(vl::scalar restitutionDirAng)
-	{ _bt_constraint->setRestitutionDirAng(restitutionDirAng); }
+	{
+		_finishStep();
+		_bt_constraint->setRestitutionDirAng(restitutionDirAng);
+	}
 	
 	void setDampingDirAng(vl::scalar dampingDirAng)
-	{ _bt_constraint->setDampingDirAng(dampingDirAng); }
+	{
+		_finishStep();
+		_bt_constraint->setDampingDirAng(dampingDirAng);
+	}
 	
 	void setSoftnessLimLin(vl::scalar softnessLimLin)
-	{ _bt_constraint->setSoftnessLimLin(softnessLimLin); }
+	{
+		_finishStep();
+		_bt_constraint->setSoftnessLimLin(softnessLimLin);
+	}
 
 	void setRestitutionLimLin(vl::scalar restitutionLimLin)
-	{ _bt_constraint->setRestitutionLimLin(restitutionLimLin); }
+	{
+		_finishStep();
+		_bt_constraint->setRestitutionLimLin(restitutionLimLin);
+	}
 
 	void setTargetLinMotorVelocity(vl::scalar targetLinMotorVelocity)
-	{ _bt_constraint->setTargetLinMotorVelocity(targetLinMotorVelocity); }
+	{
+		_finishStep();
+		_bt_constraint->setTargetLinMotorVelocity(targetLinMotorVelocity);
+	}
 	
 	vl::scalar getTargetLinMotorVelocity(void)
 	{ return _bt_constraint->getTargetLinMotorVelocity(); }
 
 	void setMaxLinMotorForce(vl::scalar maxLinMotorForce)
-	{ _bt_constraint->setMaxLinMotorForce(maxLinMotorForce); }
+	{
+		_finishStep();
+		_bt_constraint->setMaxLinMotorForce(maxLinMotorForce);
+	}
 
 	virtual vl::scalar getMaxLinMotorForce(void)
 	{ return _bt_constraint->getMaxLinMotorForce(); }
 
 	void setPoweredAngMotor(bool onOff)
-	{ _bt_constraint->setPoweredAngMotor(onOff); }
+	{
+		_finishStep();
+		_bt_constraint->setPoweredAngMotor(onOff);
+	}
 
 	bool getPoweredAngMotor(void)
 	{ return _bt_constraint->getPoweredAngMotor(); }
 
 	void setTargetAngMotorVelocity(vl::scalar targetAngMotorVelocity)
-	{ _bt_constraint->setTargetAngMotorVelocity(targetAngMotorVelocity); }
+	{
+		_finishStep();
+		_bt_constraint->setTargetAngMotorVelocity(targetAngMotorVelocity);
+	}
 	
 	vl::scalar getTargetAngMotorVelocity(void)
 	{ return _bt_constraint->getTargetAngMotorVelocity(); }
 
 	void setMaxAngMotorForce(vl::scalar maxAngMotorForce)
-	{ _bt_constraint->setMaxAngMotorForce(maxAngMotorForce); }
+	{
+		_finishStep();
+		_bt_constraint->setMaxAngMotorForce(maxAngMotorForce);
+	}
 
 	vl::scalar getMaxAngMotorForce(void)
 	{ return _bt_constraint->getMaxAngMotorForce(); }
 
 	void setDampingLimLin(vl::scalar dampingLimLin)
-	{ _bt_constraint->setDampingLimLin(dampingLimLin); }
+	{
+		_finishStep();
+		_bt_constraint->setDampingLimLin(dampingLimLin);
+	}
 
 	void setSoftnessLimAng(vl::scalar softnessLimAng)
-	{ _bt_constraint->setSoftnessLimAng(softnessLimAng); }
+	{
+		_finishStep();
+		_bt_constraint->setSoftnessLimAng(softnessLimAng);
+	}
 
 	void setRestitutionLimAng(vl::scalar restitutionLimAng)
-	{ _bt_constraint->setRestitutionLimAng(restitutionLimAng); }
+	{
+		_finishStep();
+		_bt_constraint->setRestitutionLimAng(restitutionLimAng);
+	}
 
 	void setDampingLimAng(vl::scalar dampingLimAng)
-	{ _bt_constraint->setDampingLimAng(dampingLimAng); }
+	{
+		_finishStep();
+		_bt_constraint->setDampingLimAng(dampingLimAng);
+	}
 
 	void setSoftnessOrthoLin(vl::scalar softnessOrthoLin)
-	{ _bt_constraint->setSoftnessOrthoLin(softnessOrthoLin); }
+	{
+		_finishStep();
+		_bt_constraint->setSoftnessOrthoLin(softnessOrthoLin);
+	}
 
 	void setRestitutionOrthoLin(vl::scalar restitutionOrthoLin)
-	{ _bt_constraint->setRestitutionOrthoLin(restitutionOrthoLin); }
+	{
+		_finishStep();
+		_bt_constraint->setRestitutionOrthoLin(restitutionOrthoLin);
+	}
 
 	void setDampingOrthoLin(vl::scalar dampingOrthoLin)
-	{ _bt_constraint->setDampingOrthoLin(dampingOrthoLin); }
+	{
+		_finishStep();
+		_bt_constraint->setDampingOrthoLin(dampingOrthoLin);
+	}
 
 	void setSoftnessOrthoAng(vl::scalar softnessOrthoAng)
-	{ _bt_constraint->setSoftnessOrthoAng(softnessOrthoAng); }
+	{
+		_finishStep();
+		_bt_constraint->setSoftnessOrthoAng(softnessOrthoAng);
+	}
 
 	void setRestitutionOrthoAng(vl::scalar restitutionOrthoAng)
-	{ _bt_constraint->setRestitutionOrthoAng(restitutionOrthoAng); }
+	{
+		_finishStep();
+		_bt_constraint->setRestitutionOrthoAng(restitutionOrthoAng);
+	}
 
 	void setDampingOrthoAng(vl::scalar dampingOrthoAng)
-	{ _bt_constraint->setDampingOrthoAng(dampingOrthoAng); }
+	{
+		_finishStep();
+		_bt_constraint->setDampingOrthoAng(dampingOrthoAng);
+	}
 
 	void setPoweredLinMotor(bool onOff)
-	{ _bt_constraint->setPoweredLinMotor(onOff); }
+	{
+		_finishStep();
+		_bt_constraint->setPoweredLinMotor(onOff);
+	}
 	bool getPoweredLinMotor(void)
 	{ return _bt_constraint->getPoweredLinMotor(); }
 
@@ -768,24 +920,43 @@ public :
 	virtual ~BulletHingeConstraint(void) {}
 
 	void setAngularOnly(bool angularOnly)
-	{ _bt_constraint->setAngularOnly(angularOnly); }
+	{
+		_finishStep();
+		_bt_constraint->setAngularOnly(angularOnly);
+	}
 
 	void enableAngularMotor(bool enableMotor, vl::scalar targetVelocity, vl::scalar maxMotorImpulse)
-	{ _bt_constraint->enableAngularMotor(enableMotor, targetVelocity, maxMotorImpulse); }
+	{
+		_finishStep();
+		_bt_constraint->enableAngularMotor(enableMotor, targetVelocity, maxMotorImpulse);
+	}
 
 	virtual void enableMotor(bool enableMotor)
-	{ _bt_constraint->enableMotor(enableMotor); }
+	{
+		_finishStep();
+		_bt_constraint->enableMotor(enableMotor);
+	}
 	
 	void setMaxMotorImpulse(vl::scalar maxMotorImpulse)
-	{ _bt_constraint->setMaxMotorImpulse(maxMotorImpulse); }
+	{
+		_finishStep();
+		_bt_constraint->setMaxMotorImpulse(maxMotorImpulse);
+	}
 
 	void setMotorTarget(vl::scalar targetAngle, vl::scalar dt)
-	{ _bt_constraint->setMotorTarget(targetAngle, dt); }
+	{
+		_finishStep();
+		_bt_constraint->setMotorTarget(targetAngle, dt);
+	}
 	void setLimit(Ogre::Radian const &low, Ogre::Radian const &high, vl::scalar softness=0.9f, vl::scalar biasFactor=0.3f, vl::scalar relaxationFactor=1.0f)
-	{ _bt_constraint->setLimit(low.valueRadians(), high.valueRadians(), softness, biasFactor, relaxationFactor); }
+	{
+		_finishStep();
+		_bt_constraint->setLimit(low.valueRadians(), high.valueRadians(), softness, biasFactor, relaxationFactor);
+	}
 
 	void setAxis(Ogre::Vector3 &axisInA)
 	{
+		_finishStep();
 		_bt_constraint->setAxis(convert_bt_vec(axisInA));
 	}
 
@@ -796,7 +967,10 @@ public :
 	{ return _bt_constraint->getUpperLimit(); }
 
 	vl::scalar getHingeAngle(void)
-	{ return _bt_constraint->getHingeAngle(); }
+	{
+		_finishStep();
+		return _bt_constraint->getHingeAngle();
+	}
 
 	virtual btTypedConstraint *getNative(void)
 	{ return _bt_constraint; }
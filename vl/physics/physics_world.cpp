@@ -20,6 +20,7 @@
 #include "tube.hpp"
 
 #include "base/exceptions.hpp"
+#include "base/thread_check.hpp"
 
 // Necessary for creating tubes
 #include "game_manager.hpp"
@@ -161,6 +162,8 @@ vl::physics::World::destroyDynamicObjects(void)
 vl::physics::RigidBodyRefPtr
 vl::physics::World::createRigidBodyEx(RigidBody::ConstructionInfo const &info)
 {
+	vl::checkFrameThread("Physics objects");
+
 	if(hasRigidBody(info.name))
 	{
 		std::string err( "RigidBody with that name is already in the scene." );
@@ -169,6 +172,7 @@ vl::physics::World::createRigidBodyEx(RigidBody::ConstructionInfo const &info)
 
 	RigidBodyRefPtr body = RigidBody::create(info);
 	assert(body);
+	body->_setWorld(this);
 
 	_rigid_bodies.push_back(body);
 	assert(body->getMotionState() == info.state);
@@ -228,10 +232,13 @@ vl::physics::World::removeRigidBody( const std::string& name )
 void
 vl::physics::World::removeRigidBody(vl::physics::RigidBodyRefPtr body)
 {
+	vl::checkFrameThread("Physics objects");
+
 	if(!body)
 	{ return; }
 
 	_removeBody(body);
+	body->_setWorld(0);
 
 	RigidBodyList::iterator iter = std::find(_rigid_bodies.begin(), _rigid_bodies.end(), body);
 	if(iter != _rigid_bodies.end())
@@ -259,23 +266,29 @@ vl::physics::World::destroyMotionState( vl::physics::MotionState *state )
 void 
 vl::physics::World::addConstraint(vl::physics::ConstraintRefPtr constraint, bool disableCollisionBetweenLinked)
 {
+	vl::checkFrameThread("Physics objects");
+
 	ConstraintList::iterator iter = std::find(_constraints.begin(), _constraints.end(), constraint);
 	
 	if(iter == _constraints.end())
 	{
 		_constraints.push_back(constraint);
 		_addConstraint(constraint, disableCollisionBetweenLinked);
+		constraint->_setWorld(this);
 	}
 }
 
 void 
 vl::physics::World::removeConstraint(vl::physics::ConstraintRefPtr constraint)
 {
+	vl::checkFrameThread("Physics objects");
+
 	ConstraintList::iterator iter = std::find(_constraints.begin(), _constraints.end(), constraint);
 	
 	if(iter != _constraints.end())
 	{
 		_removeConstraint(*iter);
+		(*iter)->_setWorld(0);
 		_constraints.erase(iter);
 	}
 }
@@ -311,7 +324,11 @@ vl::physics::World::getConstraint(std::string const &name) const
 vl::physics::TubeRefPtr
 vl::physics::World::createTubeEx(vl::physics::Tube::ConstructionInfo const &info)
 {
-	TubeRefPtr tube(new Tube(this, _game->getSceneManager(), info));
+	// Physics thread iterates the tubes while stepping
+	finishStep();
+
+	// Tubes can be simulated without graphics
+	TubeRefPtr tube(new Tube(this, _game ? _game->getSceneManager() : 0, info));
 	_tubes.push_back(tube);
 	return tube;
 }
@@ -339,6 +356,9 @@ vl::physics::World::hasTube(vl::physics::TubeConstRefPtr tube) const
 void
 vl::physics::World::removeTube(vl::physics::TubeRefPtr tube)
 {
+	// Physics thread iterates the tubes while stepping
+	finishStep();
+
 	if(!tube)
 	{ return; }
 
@@ -385,3 +405,17 @@ vl::physics::World::_findRigidBody(const std::string& name) const
 
 	return RigidBodyRefPtr();
 }
+
+void
+vl::physics::World::_step_tubes(vl::time const &time_step)
+{
+	for(TubeList::iterator iter = _tubes.begin(); iter != _tubes.end(); ++iter)
+	{ (*iter)->_step(time_step); }
+}
+
+void
+vl::physics::World::_publish_tubes(void)
+{
+	for(TubeList::iterator iter = _tubes.begin(); iter != _tubes.end(); ++iter)
+	{ (*iter)->_publish(); }
+}
@@ -61,6 +61,8 @@ struct SolverParameters
 		, max_error_reduction(20)
 		, internal_time_step(1./60.0)
 		, max_sub_steps(10)
+		, threaded(false)
+		, solver_threads(1)
 	{}
 
 	vl::scalar erp;
@@ -70,6 +72,16 @@ struct SolverParameters
 	vl::scalar max_error_reduction;
 	vl::scalar internal_time_step;
 	int max_sub_steps;
+
+	/// Step in a separate thread while the frame is rendered.
+	/// Transformations are published at the end of the frame
+	/// so the rendering lags one physics step behind.
+	bool threaded;
+
+	/// Number of threads used for solving simulation islands,
+	/// zero for the number of hardware threads.
+	/// Needs Bullet built with BT_NO_PROFILE (BULLET_NO_PROFILE in CMake).
+	size_t solver_threads;
 };
 
 
@@ -134,8 +146,18 @@ public :
 
 	virtual ~World(void);
 
+	/// @brief advance the simulation with fixed internal time steps
+	/// Returns immediately if the world is threaded, use finishStep to wait.
 	virtual void step(vl::time const &time_step) = 0;
 
+	/// @brief wait for a threaded step and publish the interpolated transformations
+	/// Modifying the world, its bodies or their motion states waits
+	/// automatically. NOP if there is no step running.
+	virtual void finishStep(void) = 0;
+
+	/// @brief simulation time of the last finished step
+	virtual vl::time getStepTime(void) const = 0;
+
 	virtual Ogre::Vector3 getGravity(void) const = 0;
 
 	virtual void setGravity(Ogre::Vector3 const &gravity) = 0;
@@ -217,6 +239,13 @@ public :
 
 	virtual RayHitResultList castAllHitRay(Ogre::Vector3 const &rayfrom, Ogre::Vector3 const &rayto) const = 0;
 	virtual RayHitResultList castFirstHitRay(Ogre::Vector3 const &rayfrom, Ogre::Vector3 const &rayto) const = 0;
+
+	/// @brief first hit of a sphere moving from one position to another
+	/// Bodies with collisions disabled are ignored.
+	/// hit_object is not set so this can be used for thousands of sweeps.
+	/// @return false if nothing was hit
+	virtual bool sweepSphere(Ogre::Vector3 const &from, Ogre::Vector3 const &to,
+		vl::scalar radius, RayHitResult &hit) const = 0;
 	
 	RigidBodyList const &getBodies(void) const
 	{ return _rigid_bodies; }
@@ -251,6 +280,13 @@ protected :
 
 	RigidBodyRefPtr _findRigidBody( std::string const &name ) const;
 
+	/// @brief step tubes that are not simulated with rigid bodies
+	void _step_tubes(vl::time const &time_step);
+
+	/// @brief update tube graphics from the simulation
+	/// Needs to be called from the frame thread.
+	void _publish_tubes(void);
+
 	/// Rigid bodies
 	/// World owns all of them
 	RigidBodyList _rigid_bodies;
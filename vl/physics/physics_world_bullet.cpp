@@ -26,17 +26,293 @@
 // Necessary for updating kinematic bodies with collision detection
 #include "animation/kinematic_body.hpp"
 
+#include "base/chrono.hpp"
+#include "base/thread_check.hpp"
+
+#include <boost/bind.hpp>
+
+namespace
+{
+
+/// Same as Bullet uses for merging small islands
+size_t const MIN_SOLVER_BATCH_SIZE = 128;
+
+/// Constraints are sorted by island so they can be divided to the islands
+int get_constraint_island_id(btTypedConstraint const *c)
+{
+	btCollisionObject const &a = c->getRigidBodyA();
+	btCollisionObject const &b = c->getRigidBodyB();
+	return a.getIslandTag() >= 0 ? a.getIslandTag() : b.getIslandTag();
+}
+
+struct ConstraintIslandPredicate
+{
+	bool operator()(btTypedConstraint const *lhs, btTypedConstraint const *rhs) const
+	{ return get_constraint_island_id(lhs) < get_constraint_island_id(rhs); }
+};
+
+/// One or more simulation islands solved as a single group.
+/// Bodies are copied because the island manager reuses the array.
+struct IslandBatch
+{
+	IslandBatch(void)
+		: serial(false)
+	{}
+
+	size_t size(void) const
+	{ return bodies.size() + manifolds.size() + constraints.size(); }
+
+	btAlignedObjectArray<btCollisionObject *> bodies;
+	btAlignedObjectArray<btPersistentManifold *> manifolds;
+	btAlignedObjectArray<btTypedConstraint *> constraints;
+
+	/// Kinematic bodies are shared between islands and the solver
+	/// writes to them so these can not be solved in parallel.
+	/// Same for the whole world when islands are not split.
+	bool serial;
+};
+
+/// Collects the islands to batches instead of solving them
+class IslandCollector : public btSimulationIslandManager::IslandCallback
+{
+public :
+	IslandCollector(btTypedConstraint **constraints, int n_constraints,
+			std::vector<IslandBatch> &batches, size_t min_batch_size)
+		: _constraints(constraints)
+		, _n_constraints(n_constraints)
+		, _batches(batches)
+		, _min_batch_size(min_batch_size)
+	{}
+
+	virtual void processIsland(btCollisionObject **bodies, int n_bodies,
+		btPersistentManifold **manifolds, int n_manifolds, int island_id)
+	{
+		// Islands are not split, everything is passed at once with all the constraints
+		if(island_id < 0)
+		{
+			_batches.push_back(IslandBatch());
+			IslandBatch &batch = _batches.back();
+			batch.serial = true;
+			for(int i = 0; i < n_bodies; ++i)
+			{ batch.bodies.push_back(bodies[i]); }
+			for(int i = 0; i < n_manifolds; ++i)
+			{ batch.manifolds.push_back(manifolds[i]); }
+			for(int i = 0; i < _n_constraints; ++i)
+			{ batch.constraints.push_back(_constraints[i]); }
+			return;
+		}
+
+		// Small islands are merged so the tasks are not too fine grained
+		if(_batches.empty() || _batches.back().size() >= _min_batch_size)
+		{ _batches.push_back(IslandBatch()); }
+		IslandBatch &batch = _batches.back();
+
+		for(int i = 0; i < n_bodies; ++i)
+		{ batch.bodies.push_back(bodies[i]); }
+
+		for(int i = 0; i < n_manifolds; ++i)
+		{
+			btCollisionObject const *a = static_cast<btCollisionObject const *>(manifolds[i]->getBody0());
+			btCollisionObject const *b = static_cast<btCollisionObject const *>(manifolds[i]->getBody1());
+			if(a->isKinematicObject() || b->isKinematicObject())
+			{ batch.serial = true; }
+			batch.manifolds.push_back(manifolds[i]);
+		}
+
+		int i = 0;
+		while(i < _n_constraints && get_constraint_island_id(_constraints[i]) != island_id)
+		{ ++i; }
+		for(; i < _n_constraints && get_constraint_island_id(_constraints[i]) == island_id; ++i)
+		{
+			btTypedConstraint *c = _constraints[i];
+			if(c->getRigidBodyA().isKinematicObject() || c->getRigidBodyB().isKinematicObject())
+			{ batch.serial = true; }
+			batch.constraints.push_back(c);
+		}
+	}
+
+private :
+	btTypedConstraint **_constraints;
+	int _n_constraints;
+	std::vector<IslandBatch> &_batches;
+	size_t _min_batch_size;
+
+};	// class IslandCollector
+
+/// Sweep test that skips bodies with collisions disabled
+struct SweepCallback : public btCollisionWorld::ClosestConvexResultCallback
+{
+	SweepCallback(btVector3 const &from, btVector3 const &to)
+		: btCollisionWorld::ClosestConvexResultCallback(from, to)
+	{}
+
+	virtual bool needsCollision(btBroadphaseProxy *proxy) const
+	{
+		btCollisionObject const *obj = static_cast<btCollisionObject const *>(proxy->m_clientObject);
+		if(obj->getCollisionFlags() & btCollisionObject::CF_NO_CONTACT_RESPONSE)
+		{ return false; }
+
+		return btCollisionWorld::ClosestConvexResultCallback::needsCollision(proxy);
+	}
+};
+
+}	// unamed namespace
+
+namespace vl
+{
+
+namespace physics
+{
+
+/** @class BulletDynamicsWorld
+ *	Bullet world that can defer the motion state updates to the frame thread
+ *	and solves islands with a thread pool.
+ */
+class BulletDynamicsWorld : public btDiscreteDynamicsWorld
+{
+public :
+	BulletDynamicsWorld(btDispatcher *dispatcher, btBroadphaseInterface *broadphase,
+			btConstraintSolver *solver, btCollisionConfiguration *config)
+		: btDiscreteDynamicsWorld(dispatcher, broadphase, solver, config)
+		, _defer_motion_states(false)
+		, _pool(0)
+	{}
+
+	virtual ~BulletDynamicsWorld(void)
+	{
+		for(int i = 0; i < _solvers.size(); ++i)
+		{ delete _solvers[i]; }
+	}
+
+	/// @brief don't update the motion states when stepping
+	/// MotionStates update the SceneNodes so this is necessary
+	/// when stepping outside the frame thread.
+	void setDeferMotionStates(bool defer)
+	{ _defer_motion_states = defer; }
+
+	/// @brief update motion states with interpolated transformations
+	void publishMotionStates(void)
+	{ btDiscreteDynamicsWorld::synchronizeMotionStates(); }
+
+	virtual void synchronizeMotionStates(void)
+	{
+		if(!_defer_motion_states)
+		{ btDiscreteDynamicsWorld::synchronizeMotionStates(); }
+	}
+
+	/// @param pool NULL to solve in the calling thread
+	void setThreadPool(vl::ThreadPool *pool)
+	{ _pool = pool; }
+
+protected :
+	virtual void solveConstraints(btContactSolverInfo &info);
+
+private :
+	void _solve_batch(IslandBatch const *batch, btContactSolverInfo const *info);
+
+	btConstraintSolver *_acquire_solver(void);
+
+	void _release_solver(btConstraintSolver *solver);
+
+	bool _defer_motion_states;
+
+	vl::ThreadPool *_pool;
+
+	/// Solvers are not thread safe, every batch uses it's own
+	boost::mutex _solver_mutex;
+	btAlignedObjectArray<btConstraintSolver *> _solvers;
+	btAlignedObjectArray<btConstraintSolver *> _free_solvers;
+
+};	// class BulletDynamicsWorld
+
+}	// namespace physics
+
+}	// namespace vl
+
+void
+vl::physics::BulletDynamicsWorld::solveConstraints(btContactSolverInfo &info)
+{
+	if(!_pool || _pool->getNThreads() < 2)
+	{
+		btDiscreteDynamicsWorld::solveConstraints(info);
+		return;
+	}
+
+	m_sortedConstraints.resize(m_constraints.size());
+	for(int i = 0; i < m_constraints.size(); ++i)
+	{ m_sortedConstraints[i] = m_constraints[i]; }
+	m_sortedConstraints.quickSort(ConstraintIslandPredicate());
+
+	std::vector<IslandBatch> batches;
+	IslandCollector collector(m_sortedConstraints.size() ? &m_sortedConstraints[0] : 0,
+		m_sortedConstraints.size(), batches, MIN_SOLVER_BATCH_SIZE);
+	m_islandManager->buildAndProcessIslands(getCollisionWorld()->getDispatcher(),
+		getCollisionWorld(), &collector);
+
+	std::vector<vl::ThreadPool::Task> tasks;
+	for(size_t i = 0; i < batches.size(); ++i)
+	{
+		if(!batches[i].serial)
+		{ tasks.push_back(boost::bind(&BulletDynamicsWorld::_solve_batch, this, &batches[i], &info)); }
+	}
+	_pool->run(tasks);
+
+	for(size_t i = 0; i < batches.size(); ++i)
+	{
+		if(batches[i].serial)
+		{ _solve_batch(&batches[i], &info); }
+	}
+}
+
+void
+vl::physics::BulletDynamicsWorld::_solve_batch(IslandBatch const *batch, btContactSolverInfo const *info)
+{
+	btConstraintSolver *solver = _acquire_solver();
+	// Solver takes non const arrays but doesn't modify them
+	// Stack allocator is not thread safe, sequential impulse solver doesn't use it.
+	IslandBatch &b = const_cast<IslandBatch &>(*batch);
+	solver->solveGroup(b.bodies.size() ? &b.bodies[0] : 0, b.bodies.size(),
+		b.manifolds.size() ? &b.manifolds[0] : 0, b.manifolds.size(),
+		b.constraints.size() ? &b.constraints[0] : 0, b.constraints.size(),
+		*info, 0, 0, getCollisionWorld()->getDispatcher());
+	_release_solver(solver);
+}
+
+btConstraintSolver *
+vl::physics::BulletDynamicsWorld::_acquire_solver(void)
+{
+	boost::mutex::scoped_lock lock(_solver_mutex);
+	if(_free_solvers.size() == 0)
+	{
+		btConstraintSolver *solver = new btSequentialImpulseConstraintSolver;
+		_solvers.push_back(solver);
+		return solver;
+	}
+
+	btConstraintSolver *solver = _free_solvers[_free_solvers.size()-1];
+	_free_solvers.pop_back();
+	return solver;
+}
+
+void
+vl::physics::BulletDynamicsWorld::_release_solver(btConstraintSolver *solver)
+{
+	boost::mutex::scoped_lock lock(_solver_mutex);
+	_free_solvers.push_back(solver);
+}
+
+/// -------------------------------- BulletWorld -----------------------------
 
 vl::physics::BulletWorld::BulletWorld(void)
 	: _broadphase( new btDbvtBroadphase() ),
 	  _collision_config( new btDefaultCollisionConfiguration() ),
 	  _dispatcher( new btCollisionDispatcher(_collision_config) ),
-	  _solver( new btSequentialImpulseConstraintSolver )
+	  _solver( new btSequentialImpulseConstraintSolver ),
+	  _stepping(false),
+	  _quit(false),
+	  _step_running(false)
 {
-	// @warning: needed for checking collisions on concave rigid bodies (GImpactShapes)! Remove if we don't need GImpactShapes, it's very inefficient compared to compoundshapes. 
-	btGImpactCollisionAlgorithm::registerAlgorithm(_dispatcher);
-
-	_dynamicsWorld = new btDiscreteDynamicsWorld(_dispatcher,_broadphase,_solver,_collision_config);
+	_dynamicsWorld = new BulletDynamicsWorld(_dispatcher,_broadphase,_solver,_collision_config);
 	
 	
 	// @todo for some reason normal gravity will break the constraints
@@ -57,6 +333,14 @@ vl::physics::BulletWorld::BulletWorld(void)
 
 vl::physics::BulletWorld::~BulletWorld(void)
 {
+	{
+		boost::mutex::scoped_lock lock(_step_mutex);
+		_quit = true;
+	}
+	_step_cond.notify_all();
+	if(_thread.joinable())
+	{ _thread.join(); }
+
 	// cleanup the world
 	delete _dynamicsWorld;
 	delete _solver;
@@ -68,7 +352,31 @@ vl::physics::BulletWorld::~BulletWorld(void)
 void
 vl::physics::BulletWorld::step(vl::time const &time_step)
 {
-	_dynamicsWorld->stepSimulation((double)time_step, _solver_params.max_sub_steps, _solver_params.internal_time_step);
+	finishStep();
+
+	// Kinematic collision feedback needs the results in the same frame
+	if(_solver_params.threaded && !_needs_collision_feedback())
+	{
+		_dynamicsWorld->setDeferMotionStates(true);
+		if(!_thread.joinable())
+		{ _thread = boost::thread(boost::bind(&BulletWorld::_thread_main, this)); }
+
+		{
+			boost::mutex::scoped_lock lock(_step_mutex);
+			_time_step = time_step;
+			_stepping = true;
+		}
+		_step_running = true;
+		_step_cond.notify_all();
+		return;
+	}
+
+	_dynamicsWorld->setDeferMotionStates(false);
+	_time_step = time_step;
+	vl::chrono t;
+	_simulate();
+	_step_time = t.elapsed();
+	_publish_tubes();
 
 	// Check for collisions
 	// here instead of a tick callback because we only store the transformations
@@ -78,21 +386,75 @@ vl::physics::BulletWorld::step(vl::time const &time_step)
 	_collision_feedback();
 }
 
+void
+vl::physics::BulletWorld::finishStep(void)
+{
+	// Bodies are also accessed from the step itself, e.g. by Tubes
+	if(boost::this_thread::get_id() == _thread.get_id())
+	{ return; }
+
+	// Every access to the bodies passes through here
+	vl::checkFrameThread("Physics objects");
+
+	if(!_step_running)
+	{ return; }
+
+	boost::exception_ptr error;
+	{
+		boost::mutex::scoped_lock lock(_step_mutex);
+		while(_stepping)
+		{ _step_cond.wait(lock); }
+		error = _step_error;
+		_step_error = boost::exception_ptr();
+		_step_time = _thread_step_time;
+	}
+	_step_running = false;
+
+	if(error)
+	{ boost::rethrow_exception(error); }
+
+	// Scene nodes can only be modified from the frame thread
+	_dynamicsWorld->publishMotionStates();
+	_publish_tubes();
+}
+
 Ogre::Vector3
 vl::physics::BulletWorld::getGravity(void) const
 {
+	_waitStep();
 	return vl::math::convert_vec(_dynamicsWorld->getGravity());
 }
 
 void
 vl::physics::BulletWorld::setGravity(Ogre::Vector3 const &gravity)
 {
+	finishStep();
 	_dynamicsWorld->setGravity( vl::math::convert_bt_vec(gravity) );
 }
 
 void
 vl::physics::BulletWorld::setSolverParameters(vl::physics::SolverParameters const &p)
 {
+	finishStep();
+
+#ifdef BT_NO_PROFILE
+	size_t solver_threads = p.solver_threads;
+#else
+	// Solvers use the global Bullet profiler which is not thread safe
+	if(p.solver_threads != 1)
+	{
+		std::clog << "vl::physics::BulletWorld::setSolverParameters : "
+			<< "Bullet profiler is enabled, solving islands in one thread." << std::endl;
+	}
+	size_t solver_threads = 1;
+#endif
+
+	if(solver_threads != 1 && (!_solver_pool || solver_threads != _solver_params.solver_threads))
+	{ _solver_pool.reset(new vl::ThreadPool(solver_threads)); }
+	else if(solver_threads == 1)
+	{ _solver_pool.reset(); }
+	_dynamicsWorld->setThreadPool(_solver_pool.get());
+
 	_solver_params = p;
 	// set global parameters
 	_dynamicsWorld->getSolverInfo().m_restitution = p.restitution;
@@ -111,6 +473,8 @@ vl::physics::BulletWorld::setSolverParameters(vl::physics::SolverParameters cons
 vl::physics::RayHitResultList
 vl::physics::BulletWorld::castAllHitRay(Ogre::Vector3 const &rayfrom, Ogre::Vector3 const &rayto) const
 {
+	_waitStep();
+
 	btVector3 from = math::convert_bt_vec(rayfrom);
 	btVector3 to = math::convert_bt_vec(rayto);
 		
@@ -161,6 +525,8 @@ vl::physics::BulletWorld::castAllHitRay(Ogre::Vector3 const &rayfrom, Ogre::Vect
 vl::physics::RayHitResultList
 vl::physics::BulletWorld::castFirstHitRay(Ogre::Vector3 const &rayfrom, Ogre::Vector3 const &rayto) const
 {
+	_waitStep();
+
 	btVector3 from = math::convert_bt_vec(rayfrom);
 	btVector3 to = math::convert_bt_vec(rayto);
 		
@@ -198,10 +564,43 @@ vl::physics::BulletWorld::castFirstHitRay(Ogre::Vector3 const &rayfrom, Ogre::Ve
 	return hitlist;
 }
 
+bool
+vl::physics::BulletWorld::sweepSphere(Ogre::Vector3 const &from, Ogre::Vector3 const &to,
+		vl::scalar radius, RayHitResult &hit) const
+{
+	_waitStep();
+
+	btTransform bt_from(btQuaternion::getIdentity(), math::convert_bt_vec(from));
+	btTransform bt_to(btQuaternion::getIdentity(), math::convert_bt_vec(to));
+
+	SweepCallback callback(bt_from.getOrigin(), bt_to.getOrigin());
+	btSphereShape sphere(radius);
+	_dynamicsWorld->convexSweepTest(&sphere, bt_from, bt_to, callback);
+	if(!callback.hasHit())
+	{ return false; }
+
+	hit.ray_start = from;
+	hit.ray_end = to;
+	hit.hit_point_world = math::convert_vec(callback.m_hitPointWorld);
+	hit.hit_normal_world = math::convert_vec(callback.m_hitNormalWorld);
+	hit.hit_fraction = callback.m_closestHitFraction;
+	hit.hit_object.reset();
+
+	return true;
+}
+
+void
+vl::physics::BulletWorld::_waitStep(void) const
+{
+	// Queries don't modify the world but the step does
+	const_cast<BulletWorld *>(this)->finishStep();
+}
 
 void
 vl::physics::BulletWorld::_addRigidBody( std::string const &name, vl::physics::RigidBodyRefPtr body, bool kinematic)
 {
+	finishStep();
+
 	// for some reason we can not do static_pointer_cast here
 	
 	BulletRigidBodyRefPtr b = boost::dynamic_pointer_cast<BulletRigidBody>(body);
@@ -234,6 +633,8 @@ vl::physics::BulletWorld::_addRigidBody( std::string const &name, vl::physics::R
 void
 vl::physics::BulletWorld::_addConstraint(vl::physics::ConstraintRefPtr constraint, bool disableCollisionBetweenLinked)
 {
+	finishStep();
+
 	// for some reason we can not do static_pointer_cast here
 	BulletConstraintRefPtr c = boost::dynamic_pointer_cast<BulletConstraint>(constraint);
 
@@ -244,6 +645,8 @@ vl::physics::BulletWorld::_addConstraint(vl::physics::ConstraintRefPtr constrain
 void
 vl::physics::BulletWorld::_removeConstraint(vl::physics::ConstraintRefPtr constraint)
 {
+	finishStep();
+
 	// for some reason we can not do static_pointer_cast here
 	BulletConstraintRefPtr c = boost::dynamic_pointer_cast<BulletConstraint>(constraint);
 
@@ -255,6 +658,8 @@ vl::physics::BulletWorld::_removeConstraint(vl::physics::ConstraintRefPtr constr
 void
 vl::physics::BulletWorld::_removeBody(vl::physics::RigidBodyRefPtr body)
 {
+	finishStep();
+
 	BulletRigidBodyRefPtr b = boost::dynamic_pointer_cast<BulletRigidBody>(body);
 
 	// @todo replace asserts with real checking
@@ -350,6 +755,56 @@ vl::physics::BulletWorld::_collision_feedback(void)
 	}
 }
 
+bool
+vl::physics::BulletWorld::_needs_collision_feedback(void) const
+{
+	if(!_collision_detection_enabled)
+	{ return false; }
+
+	for(RigidBodyList::const_iterator iter = _rigid_bodies.begin();
+		iter != _rigid_bodies.end(); ++iter)
+	{
+		if((*iter)->isKinematicObject())
+		{ return true; }
+	}
+
+	return false;
+}
+
+void
+vl::physics::BulletWorld::_simulate(void)
+{
+	_dynamicsWorld->stepSimulation((double)_time_step, _solver_params.max_sub_steps, _solver_params.internal_time_step);
+	_step_tubes(_time_step);
+}
+
+void
+vl::physics::BulletWorld::_thread_main(void)
+{
+	boost::unique_lock<boost::mutex> lock(_step_mutex);
+	while(true)
+	{
+		while(!_stepping && !_quit)
+		{ _step_cond.wait(lock); }
+		if(_quit)
+		{ return; }
+
+		lock.unlock();
+		vl::chrono t;
+		boost::exception_ptr error;
+		try
+		{ _simulate(); }
+		catch(...)
+		{ error = boost::current_exception(); }
+		lock.lock();
+
+		_thread_step_time = t.elapsed();
+		_step_error = error;
+		_stepping = false;
+		_step_cond.notify_all();
+	}
+}
+
 vl::physics::RigidBodyRefPtr vl::physics::BulletWorld::_findRigidBody(btRigidBody *body) const
 {
 	
@@ -15,6 +15,11 @@
 /**
  *	Bullet implementation of the physics world
  *
+ *	@update 2014-06
+ *	Threaded stepping: the simulation runs in a physics thread while the
+ *	frame is rendered and the interpolated transformations are published
+ *	to MotionStates from the frame thread when the step is finished.
+ *	Independent simulation islands are solved in parallel.
  */
 
 #ifndef HYDRA_PHYSICS_WORLD_BULLET_HPP
@@ -26,9 +31,9 @@
 // This class initialises Bullet physics so they are necessary
 #include <bullet/btBulletDynamicsCommon.h>
 
-// @warning: Needed for dynamic concave raycasting:
-#include <bullet/BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
+#include "base/thread_pool.hpp"
 
+#include <boost/scoped_ptr.hpp>
 
 
 namespace vl
@@ -37,6 +42,8 @@ namespace vl
 namespace physics
 {
 
+class BulletDynamicsWorld;
+
 class BulletWorld : public vl::physics::World
 {
 public :
@@ -50,6 +57,11 @@ public :
 	/// Virtual overrides
 	virtual void step(vl::time const &time_step);
 
+	virtual void finishStep(void);
+
+	virtual vl::time getStepTime(void) const
+	{ return _step_time; }
+
 	virtual Ogre::Vector3 getGravity(void) const;
 
 	virtual void setGravity(Ogre::Vector3 const &gravity);
@@ -61,6 +73,9 @@ public :
 
 	virtual RayHitResultList castAllHitRay(Ogre::Vector3 const &rayfrom, Ogre::Vector3 const &rayto) const;
 	virtual RayHitResultList castFirstHitRay(Ogre::Vector3 const &rayfrom, Ogre::Vector3 const &rayto) const;
+
+	virtual bool sweepSphere(Ogre::Vector3 const &from, Ogre::Vector3 const &to,
+		vl::scalar radius, RayHitResult &hit) const;
 protected :
 	/// Virtual overrides
 	virtual void _addRigidBody( std::string const &name, vl::physics::RigidBodyRefPtr body, bool kinematic);
@@ -72,9 +87,35 @@ protected :
 
 	vl::physics::RigidBodyRefPtr _findRigidBody(btRigidBody *body) const;
 private :
-	
+	/// @brief finishStep for queries
+	/// Publishing the results is part of the step not a modification.
+	void _waitStep(void) const;
+
+	/// @brief are there kinematic bodies that need collision feedback
+	bool _needs_collision_feedback(void) const;
+
+	void _simulate(void);
+
+	void _thread_main(void);
+
 	SolverParameters _solver_params;
 
+	/// Physics thread, started when threaded stepping is first used
+	boost::thread _thread;
+	boost::mutex _step_mutex;
+	boost::condition_variable _step_cond;
+	/// Step requested from the thread, protected by the mutex
+	bool _stepping;
+	bool _quit;
+	/// Frame thread needs to publish the results
+	bool _step_running;
+	vl::time _time_step;
+	vl::time _step_time;
+	vl::time _thread_step_time;
+	boost::exception_ptr _step_error;
+
+	boost::scoped_ptr<vl::ThreadPool> _solver_pool;
+
 	/// Bullet physics world objects
 	/// The order of them is important don't change it.
 	/// @todo move to using scoped ptrs if possible
@@ -82,7 +123,7 @@ private :
 	btCollisionConfiguration *_collision_config;
 	btCollisionDispatcher *_dispatcher;
 	btSequentialImpulseConstraintSolver *_solver;
-	btDiscreteDynamicsWorld *_dynamicsWorld;
+	BulletDynamicsWorld *_dynamicsWorld;
 	
 };	// class BulletWorld
 
@@ -19,6 +19,10 @@
 
 /// Concrete implementation
 #include "rigid_body_bullet.hpp"
+/// Necessary for waiting for the threaded step
+#include "physics_world.hpp"
+
+#include "base/thread_check.hpp"
 
 /// --------------------------------- Global ---------------------------------
 std::ostream &
@@ -115,9 +119,27 @@ vl::physics::RigidBody::positionToLocal(Ogre::Vector3 const &v) const
 	return from_world*v;
 }
 
+void
+vl::physics::RigidBody::_setWorld(vl::physics::WorldPtr world)
+{
+	_world = world;
+	if(getMotionState())
+	{ getMotionState()->_setWorld(world); }
+}
+
 /// --------------------------------- Protected ------------------------------
 vl::physics::RigidBody::RigidBody(vl::physics::RigidBody::ConstructionInfo const &info)
 	: _name(info.name)
 	, _shape(info.shape)
 	, _is_dynamic(info.dynamic)
+	, _world(0)
 {}
+
+void
+vl::physics::RigidBody::_finishStep(void) const
+{
+	vl::checkFrameThread("Physics objects");
+
+	if(_world)
+	{ _world->finishStep(); }
+}
@@ -196,6 +196,9 @@ public :
 	CollisionShapeRefPtr getShape(void)
 	{ return _shape; }
 
+	/// @internal set by the World the body is added to
+	void _setWorld(WorldPtr world);
+
 	//Ville added anisotropic and normal friction here:
 	virtual Ogre::Vector3 getAnisotropicFriction(void) const = 0;
 	virtual void setAnisotropicFriction(Ogre::Vector3 const&) = 0;
@@ -207,11 +210,18 @@ public :
 protected :
 	RigidBody(ConstructionInfo const &info);
 
+	/// @brief wait for a threaded step of the world to finish
+	/// Called before accessing the simulated state because the physics
+	/// thread writes it while stepping.
+	void _finishStep(void) const;
+
 	std::string _name;
 
 	CollisionShapeRefPtr _shape;
 
 	bool _is_dynamic;
+
+	WorldPtr _world;
 	
 	// need to store the world transform because some methods return const refs
 	mutable Transform _wt;
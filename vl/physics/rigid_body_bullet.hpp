@@ -96,42 +96,42 @@ public :
 	}
 
 	virtual Ogre::Vector3 getTotalForce(void) const
-	{ return convert_vec(_bt_body->getTotalForce()); }
+	{ _finishStep(); return convert_vec(_bt_body->getTotalForce()); }
 	virtual Ogre::Vector3 getTotalTorque(void) const
-	{ return convert_vec(_bt_body->getTotalTorque()); }
+	{ _finishStep(); return convert_vec(_bt_body->getTotalTorque()); }
 
 	void applyForce(Ogre::Vector3 const &force, Ogre::Vector3 const &rel_pos)
-	{ _bt_body->applyForce(convert_bt_vec(force), convert_bt_vec(rel_pos)); }
+	{ _finishStep(); _bt_body->applyForce(convert_bt_vec(force), convert_bt_vec(rel_pos)); }
 
 	void applyTorque(Ogre::Vector3 const &v)
-	{ _bt_body->applyTorque(vl::math::convert_bt_vec(v)); }
+	{ _finishStep(); _bt_body->applyTorque(vl::math::convert_bt_vec(v)); }
 
 	void applyTorqueImpulse(Ogre::Vector3 const &v)
-	{ _bt_body->applyTorqueImpulse(vl::math::convert_bt_vec(v)); }
+	{ _finishStep(); _bt_body->applyTorqueImpulse(vl::math::convert_bt_vec(v)); }
 
 	void applyCentralImpulse(Ogre::Vector3 const &v)
-	{ _bt_body->applyCentralImpulse(vl::math::convert_bt_vec(v)); }
+	{ _finishStep(); _bt_body->applyCentralImpulse(vl::math::convert_bt_vec(v)); }
 
 	void setLinearVelocity(Ogre::Vector3 const &v)
-	{ _bt_body->setLinearVelocity(convert_bt_vec(v)); }
+	{ _finishStep(); _bt_body->setLinearVelocity(convert_bt_vec(v)); }
 
 	Ogre::Vector3 getLinearVelocity(void) const
-	{ return convert_vec(_bt_body->getLinearVelocity()); }
+	{ _finishStep(); return convert_vec(_bt_body->getLinearVelocity()); }
 
 	void setAngularVelocity(Ogre::Vector3 const &v)
-	{ _bt_body->setAngularVelocity(convert_bt_vec(v)); }
+	{ _finishStep(); _bt_body->setAngularVelocity(convert_bt_vec(v)); }
 
 	Ogre::Vector3 getAngularVelocity(void) const
-	{ return convert_vec(_bt_body->getAngularVelocity()); }
+	{ _finishStep(); return convert_vec(_bt_body->getAngularVelocity()); }
 
 	void setDamping(Ogre::Real linear, Ogre::Real angular)
-	{ _bt_body->setDamping(linear, angular); }
+	{ _finishStep(); _bt_body->setDamping(linear, angular); }
 
 	Ogre::Real getInvMass(void)
 	{ return _bt_body->getInvMass(); }
 
 	void clearForces(void)
-	{ _bt_body->clearForces(); }
+	{ _finishStep(); _bt_body->clearForces(); }
 
 	Ogre::Real getLinearDamping(void) const
 	{ return _bt_body->getLinearDamping(); }
@@ -141,6 +141,7 @@ public :
 
 	void setMass(Ogre::Real mass)
 	{
+		_finishStep();
 		if(!_bt_body->getInvInertiaDiagLocal().isZero())
 		{
 			btVector3 inv = _bt_body->getInvInertiaDiagLocal();
@@ -174,16 +175,17 @@ public :
 	{ setMassProps( 1/getInvMass(), inertia ); }
 
 	void setMassProps(Ogre::Real mass, Ogre::Vector3 const &inertia)
-	{ _bt_body->setMassProps(mass, convert_bt_vec(inertia)); }
+	{ _finishStep(); _bt_body->setMassProps(mass, convert_bt_vec(inertia)); }
 
 	void setCenterOfMassTransform(vl::Transform const &xform)
-	{ _bt_body->setCenterOfMassTransform(convert_bt_transform(xform)); }
+	{ _finishStep(); _bt_body->setCenterOfMassTransform(convert_bt_transform(xform)); }
 
 	vl::Transform getCenterOfMassTransform(void) const
-	{ return convert_transform(_bt_body->getCenterOfMassTransform()); }
+	{ _finishStep(); return convert_transform(_bt_body->getCenterOfMassTransform()); }
 
 	virtual void setUserControlled(bool enabled)
 	{
+		_finishStep();
 		if(enabled)
 		{ _bt_body->setActivationState(DISABLE_DEACTIVATION); }
 		else
@@ -191,10 +193,10 @@ public :
 	}
 
 	virtual bool isUserControlled(void) const
-	{ return _bt_body->getActivationState() == DISABLE_DEACTIVATION; }
+	{ _finishStep(); return _bt_body->getActivationState() == DISABLE_DEACTIVATION; }
 
 	virtual void setActivationState(int state)
-	{ _bt_body->setActivationState(state); }
+	{ _finishStep(); _bt_body->setActivationState(state); }
 
 	virtual MotionState *getMotionState(void)
 	{
@@ -209,16 +211,24 @@ public :
 	}
 
 	virtual void setMotionState(MotionState *motionState)
-	{ _bt_body->setMotionState((BulletMotionState *)motionState); }
+	{
+		_finishStep();
+		if(getMotionState())
+		{ getMotionState()->_setWorld(0); }
+		if(motionState)
+		{ motionState->_setWorld(_world); }
+		_bt_body->setMotionState((BulletMotionState *)motionState);
+	}
 
 	virtual vl::Transform getWorldTransform(void) const
-	{ return convert_transform(_bt_body->getWorldTransform()); }
+	{ _finishStep(); return convert_transform(_bt_body->getWorldTransform()); }
 
 	virtual void setWorldTransform(Transform const &worldTrans)
-	{ _bt_body->setWorldTransform(convert_bt_transform(worldTrans)); }
+	{ _finishStep(); _bt_body->setWorldTransform(convert_bt_transform(worldTrans)); }
 
 	virtual void enableKinematicObject(bool enable)
 	{
+		_finishStep();
 		if(enable)
 		{
 			_bt_body->setCollisionFlags(_bt_body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
@@ -233,6 +243,7 @@ public :
 
 	virtual void disableCollisions(bool disable)
 	{
+		_finishStep();
 		if(disable)
 		{
 			_bt_body->setCollisionFlags(_bt_body->getCollisionFlags() | btCollisionObject::CF_NO_CONTACT_RESPONSE);
@@ -264,15 +275,18 @@ public :
 		return math::convert_vec(_bt_body->getAnisotropicFriction());
 	}
 	virtual void setAnisotropicFriction(const Ogre::Vector3 &anisotropicFriction) {
+		_finishStep();
 		_bt_body->setAnisotropicFriction(math::convert_bt_vec(anisotropicFriction));
 	}
 	virtual vl::scalar getFriction(void) const {
 		return _bt_body->getFriction();
 	}
 	virtual void setFriction(vl::scalar const &friction) {
+		_finishStep();
 		_bt_body->setFriction(friction);
 	}
 	virtual void setSleepingThresholds(vl::scalar const &linear,vl::scalar const &angular) {
+		_finishStep();
 		_bt_body->setSleepingThresholds(linear,angular);
 	}
 private :
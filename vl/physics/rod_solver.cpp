@@ -0,0 +1,352 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file physics/rod_solver.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+#include "rod_solver.hpp"
+
+#include "base/exceptions.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+
+/// Particles are kept this far from the contact surfaces so that
+/// the next sweep doesn't start inside the surface
+vl::scalar const CONTACT_SLOP = 0.01;
+
+}	// unamed namespace
+
+vl::physics::RodSolver::RodSolver(std::vector<Ogre::Vector3> const &positions,
+		vl::scalar particle_mass, vl::scalar radius)
+	: _gravity(0, -9.81, 0)
+	, _radius(radius)
+	, _collider(0)
+	, _x(positions)
+	, _prev(positions)
+	, _p(positions)
+	, _v(positions.size(), Ogre::Vector3::ZERO)
+	, _particle_inv_mass(0)
+	, _contact_point(positions.size(), Ogre::Vector3::ZERO)
+	, _contact_normal(positions.size(), Ogre::Vector3::ZERO)
+	, _in_contact(positions.size(), 0)
+{
+	if(positions.size() < 2)
+	{ BOOST_THROW_EXCEPTION(vl::invalid_param() << vl::desc("Rod needs at least two particles.")); }
+	if(particle_mass <= 0)
+	{ BOOST_THROW_EXCEPTION(vl::invalid_param() << vl::desc("Rod particle mass needs to be positive.")); }
+
+	_particle_inv_mass = 1/particle_mass;
+	_inv_mass.resize(_x.size(), _particle_inv_mass);
+
+	_rest.resize(_x.size()-1);
+	_dir.resize(_rest.size());
+	_diag.resize(_rest.size());
+	_upper.resize(_rest.size());
+	_rhs.resize(_rest.size());
+	_arc_length.resize(_x.size(), 0);
+	for(size_t i = 0; i < _rest.size(); ++i)
+	{
+		_rest[i] = _x[i].distance(_x[i+1]);
+		_arc_length[i+1] = _arc_length[i] + _rest[i];
+	}
+
+	// Straight rod is the rest shape
+	_bend_rest.resize(_x.size()-2);
+	_bend_lambda.resize(_bend_rest.size(), 0);
+	for(size_t i = 0; i < _bend_rest.size(); ++i)
+	{ _bend_rest[i] = _rest[i] + _rest[i+1]; }
+
+	_update_attachments();
+}
+
+void
+vl::physics::RodSolver::pin(size_t index, Ogre::Vector3 const &position)
+{
+	_inv_mass.at(index) = 0;
+	_x[index] = position;
+	_prev[index] = position;
+	_p[index] = position;
+	_v[index] = Ogre::Vector3::ZERO;
+	_update_attachments();
+}
+
+void
+vl::physics::RodSolver::unpin(size_t index)
+{
+	_inv_mass.at(index) = _particle_inv_mass;
+	_update_attachments();
+}
+
+void
+vl::physics::RodSolver::setPinPosition(size_t index, Ogre::Vector3 const &position)
+{
+	assert(isPinned(index));
+	_p.at(index) = position;
+}
+
+void
+vl::physics::RodSolver::setBendingRestShape(void)
+{
+	for(size_t i = 0; i < _bend_rest.size(); ++i)
+	{ _bend_rest[i] = _x[i].distance(_x[i+2]); }
+}
+
+void
+vl::physics::RodSolver::step(vl::scalar dt)
+{
+	if(dt <= 0)
+	{ return; }
+
+	_prev = _x;
+
+	vl::scalar damping = std::max(vl::scalar(0), 1 - _params.damping*dt);
+	for(size_t i = 0; i < _x.size(); ++i)
+	{
+		// Pinned particles already have their target in _p
+		if(_inv_mass[i] == 0)
+		{ continue; }
+
+		_v[i] = (_v[i] + _gravity*dt)*damping;
+		_p[i] = _x[i] + _v[i]*dt;
+	}
+
+	_collide();
+
+	std::fill(_bend_lambda.begin(), _bend_lambda.end(), 0);
+	for(uint32_t iter = 0; iter < _params.iterations; ++iter)
+	{
+		_solve_stretch();
+		_solve_bending(dt);
+		_solve_attachments();
+		_solve_contacts();
+	}
+
+	for(size_t i = 0; i < _x.size(); ++i)
+	{
+		_v[i] = (_p[i] - _x[i])/dt;
+		_x[i] = _p[i];
+	}
+}
+
+vl::scalar
+vl::physics::RodSolver::getRestLength(void) const
+{
+	return _arc_length.back();
+}
+
+vl::scalar
+vl::physics::RodSolver::getStretch(void) const
+{
+	vl::scalar length = 0;
+	for(size_t i = 0; i+1 < _x.size(); ++i)
+	{ length += _x[i].distance(_x[i+1]); }
+
+	return length/getRestLength() - 1;
+}
+
+size_t
+vl::physics::RodSolver::getNContacts(void) const
+{
+	return std::count(_in_contact.begin(), _in_contact.end(), 1);
+}
+
+/// --------------------------------- Private --------------------------------
+void
+vl::physics::RodSolver::_update_attachments(void)
+{
+	_pin_before.resize(_x.size());
+	_pin_after.resize(_x.size());
+
+	int pin = -1;
+	for(size_t i = 0; i < _x.size(); ++i)
+	{
+		if(_inv_mass[i] == 0)
+		{ pin = i; }
+		_pin_before[i] = pin;
+	}
+
+	pin = -1;
+	for(size_t i = _x.size(); i > 0; --i)
+	{
+		if(_inv_mass[i-1] == 0)
+		{ pin = i-1; }
+		_pin_after[i-1] = pin;
+	}
+}
+
+void
+vl::physics::RodSolver::_collide(void)
+{
+	std::fill(_in_contact.begin(), _in_contact.end(), 0);
+	if(!_collider)
+	{ return; }
+
+	for(size_t i = 0; i < _x.size(); ++i)
+	{
+		if(_inv_mass[i] == 0 || _p[i].squaredDistance(_x[i]) == 0)
+		{ continue; }
+
+		RodContact contact;
+		if(!_collider->sweepSphere(_x[i], _p[i], _radius, contact))
+		{ continue; }
+
+		Ogre::Vector3 const &n = contact.normal;
+		Ogre::Vector3 center = contact.point + n*_radius*(1 + CONTACT_SLOP);
+		_contact_point[i] = center;
+		_contact_normal[i] = n;
+		_in_contact[i] = 1;
+
+		// Slide along the surface with friction
+		Ogre::Vector3 motion = _p[i] - center;
+		motion -= n*std::min(vl::scalar(0), motion.dotProduct(n));
+		Ogre::Vector3 normal_motion = n*motion.dotProduct(n);
+		_p[i] = center + normal_motion + (motion - normal_motion)*(1 - _params.friction);
+	}
+}
+
+void
+vl::physics::RodSolver::_solve_stretch(void)
+{
+	// Segments only couple to their neighbours so the system for all
+	// of them (J M^-1 J^T dl = -C) is tridiagonal and is solved directly,
+	// Gauss-Seidel would need hundreds of iterations for long rods.
+	size_t n = _rest.size();
+	for(size_t i = 0; i < n; ++i)
+	{
+		Ogre::Vector3 d = _p[i+1] - _p[i];
+		vl::scalar len = d.length();
+		_dir[i] = len > 0 ? d/len : Ogre::Vector3::ZERO;
+		_rhs[i] = _rest[i] - len;
+		_diag[i] = _inv_mass[i] + _inv_mass[i+1];
+		// Segments between two pins can't be corrected
+		if(_diag[i] == 0 || len == 0)
+		{
+			_diag[i] = 1;
+			_rhs[i] = 0;
+		}
+	}
+
+	// Forward elimination (Thomas algorithm)
+	// upper[i] couples segments i and i+1
+	for(size_t i = 0; i < n; ++i)
+	{
+		_upper[i] = i+1 < n ? -_inv_mass[i+1]*_dir[i].dotProduct(_dir[i+1]) : 0;
+		if(i > 0)
+		{
+			vl::scalar m = _upper[i-1]/_diag[i-1];
+			_diag[i] -= m*_upper[i-1];
+			_rhs[i] -= m*_rhs[i-1];
+		}
+	}
+
+	// Back substitution, rhs becomes the lambda
+	for(size_t i = n; i > 0; --i)
+	{
+		if(i < n)
+		{ _rhs[i-1] -= _upper[i-1]*_rhs[i]; }
+		_rhs[i-1] /= _diag[i-1];
+	}
+
+	for(size_t i = 0; i < n; ++i)
+	{
+		_p[i] -= _dir[i]*(_inv_mass[i]*_rhs[i]);
+		_p[i+1] += _dir[i]*(_inv_mass[i+1]*_rhs[i]);
+	}
+}
+
+void
+vl::physics::RodSolver::_solve_bending(vl::scalar dt)
+{
+	bool stiff = _params.bending_compliance >= 0;
+	bool limited = _params.max_bending_angle >= 0;
+	if(!stiff && !limited)
+	{ return; }
+
+	vl::scalar alpha = _params.bending_compliance/(dt*dt);
+	vl::scalar cos_limit = std::cos(_params.max_bending_angle);
+
+	for(size_t i = 0; i < _bend_rest.size(); ++i)
+	{
+		vl::scalar w = _inv_mass[i] + _inv_mass[i+2];
+		if(w == 0)
+		{ continue; }
+
+		Ogre::Vector3 d = _p[i+2] - _p[i];
+		vl::scalar len = d.length();
+		if(len == 0)
+		{ continue; }
+		Ogre::Vector3 n = d/len;
+
+		vl::scalar dlambda = 0;
+		if(stiff)
+		{
+			vl::scalar C = len - _bend_rest[i];
+			dlambda = (-C - alpha*_bend_lambda[i])/(w + alpha);
+			_bend_lambda[i] += dlambda;
+			len += w*dlambda;
+		}
+
+		if(limited)
+		{
+			// Minimum distance for the angle between the segments from
+			// the law of cosines, angle is zero for a straight rod
+			vl::scalar a = _rest[i];
+			vl::scalar b = _rest[i+1];
+			vl::scalar min_len = std::sqrt(a*a + b*b + 2*a*b*cos_limit);
+			if(len < min_len)
+			{ dlambda += (min_len - len)/w; }
+		}
+
+		_p[i] -= n*(_inv_mass[i]*dlambda);
+		_p[i+2] += n*(_inv_mass[i+2]*dlambda);
+	}
+}
+
+void
+vl::physics::RodSolver::_solve_attachments(void)
+{
+	for(size_t i = 0; i < _x.size(); ++i)
+	{
+		if(_inv_mass[i] == 0)
+		{ continue; }
+
+		int pins[2] = { _pin_before[i], _pin_after[i] };
+		for(size_t j = 0; j < 2; ++j)
+		{
+			if(pins[j] < 0)
+			{ continue; }
+
+			vl::scalar max_dist = std::abs(_arc_length[i] - _arc_length[pins[j]]);
+			Ogre::Vector3 d = _p[i] - _p[pins[j]];
+			vl::scalar len = d.length();
+			if(len > max_dist)
+			{ _p[i] -= d*((len - max_dist)/len); }
+		}
+	}
+}
+
+void
+vl::physics::RodSolver::_solve_contacts(void)
+{
+	for(size_t i = 0; i < _x.size(); ++i)
+	{
+		if(!_in_contact[i])
+		{ continue; }
+
+		vl::scalar depth = (_p[i] - _contact_point[i]).dotProduct(_contact_normal[i]);
+		if(depth < 0)
+		{ _p[i] -= _contact_normal[i]*depth; }
+	}
+}
@@ -0,0 +1,223 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file physics/rod_solver.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Position based solver for tubes and cables.
+ *
+ *	The rod is a chain of particles stored in contiguous arrays.
+ *	Every step predicts the positions, collides them with the environment
+ *	and then iterates over the constraints:
+ *	- inextensible segments, solved directly for the whole rod
+ *	  as a tridiagonal system
+ *	- bending stiffness as a compliant (XPBD) distance between every
+ *	  second particle, so it's independent of the iteration count
+ *	- maximum bending angle as a minimum distance of every second particle
+ *	- long range attachments to the pinned particles, a particle can not
+ *	  be further away from a pin than it's distance along the rod,
+ *	  which removes the stretching of long rods
+ *	- contact planes found by the collision sweeps
+ *
+ *	Twisting is not simulated.
+ *
+ *	No Bullet dependencies, collisions are done through RodCollider.
+ */
+
+#ifndef HYDRA_PHYSICS_ROD_SOLVER_HPP
+#define HYDRA_PHYSICS_ROD_SOLVER_HPP
+
+// Necessary for vl::scalar and Ogre::Vector3
+#include "math/types.hpp"
+
+#include <vector>
+#include <stdint.h>
+
+namespace vl
+{
+
+namespace physics
+{
+
+struct RodContact
+{
+	RodContact(void)
+		: point(Ogre::Vector3::ZERO)
+		, normal(Ogre::Vector3::UNIT_Y)
+		, fraction(1)
+	{}
+
+	/// Contact point on the surface that was hit
+	Ogre::Vector3 point;
+	Ogre::Vector3 normal;
+	/// Fraction of the sweep before the hit
+	vl::scalar fraction;
+};
+
+/// @brief interface for colliding rods with the environment
+class RodCollider
+{
+public :
+	virtual ~RodCollider(void) {}
+
+	/// @brief sweep a sphere from a position to another
+	/// @return true if something was hit, contact is the first hit
+	virtual bool sweepSphere(Ogre::Vector3 const &from, Ogre::Vector3 const &to,
+		vl::scalar radius, RodContact &contact) = 0;
+
+};	// class RodCollider
+
+struct RodParameters
+{
+	RodParameters(void)
+		: bending_compliance(-1)
+		, max_bending_angle(-1)
+		, damping(0)
+		, friction(0.5)
+		, iterations(8)
+	{}
+
+	/// Inverse of bending stiffness, negative for no bending resistance
+	vl::scalar bending_compliance;
+
+	/// Maximum angle between two segments in radians, negative for no limit
+	vl::scalar max_bending_angle;
+
+	/// Velocity damping per second
+	vl::scalar damping;
+
+	/// Fraction of the tangential motion removed on contacts
+	vl::scalar friction;
+
+	uint32_t iterations;
+
+};	// struct RodParameters
+
+class RodSolver
+{
+public :
+	/// @param positions initial positions of the particles, at least two
+	/// Segment rest lengths are the distances between them.
+	/// @param particle_mass mass of every particle
+	/// @param radius used for collisions
+	RodSolver(std::vector<Ogre::Vector3> const &positions, vl::scalar particle_mass, vl::scalar radius);
+
+	void setParameters(RodParameters const &params)
+	{ _params = params; }
+
+	RodParameters const &getParameters(void) const
+	{ return _params; }
+
+	void setGravity(Ogre::Vector3 const &gravity)
+	{ _gravity = gravity; }
+
+	/// @param collider NULL for no collisions, not owned
+	void setCollider(RodCollider *collider)
+	{ _collider = collider; }
+
+	/// @brief fix a particle to a position
+	/// Pinned particles are not simulated, they are moved with setPinPosition.
+	void pin(size_t index, Ogre::Vector3 const &position);
+
+	void unpin(size_t index);
+
+	bool isPinned(size_t index) const
+	{ return _inv_mass.at(index) == 0; }
+
+	/// @brief move a pinned particle, used by the next step
+	void setPinPosition(size_t index, Ogre::Vector3 const &position);
+
+	/// @brief use the current shape as the rest shape for bending
+	void setBendingRestShape(void);
+
+	/// @brief advance the simulation with one time step
+	void step(vl::scalar dt);
+
+	size_t getNParticles(void) const
+	{ return _x.size(); }
+
+	std::vector<Ogre::Vector3> const &getPositions(void) const
+	{ return _x; }
+
+	/// @brief positions before the last step, for interpolation
+	std::vector<Ogre::Vector3> const &getPreviousPositions(void) const
+	{ return _prev; }
+
+	Ogre::Vector3 getInterpolatedPosition(size_t index, vl::scalar alpha) const
+	{ return _prev[index] + (_x[index] - _prev[index])*alpha; }
+
+	vl::scalar getRestLength(void) const;
+
+	/// @brief relative elongation of the rod, 0 when it's not stretched
+	vl::scalar getStretch(void) const;
+
+	/// @brief number of particles in contact after the last step
+	size_t getNContacts(void) const;
+
+private :
+	void _update_attachments(void);
+
+	void _collide(void);
+
+	void _solve_stretch(void);
+
+	void _solve_bending(vl::scalar dt);
+
+	void _solve_attachments(void);
+
+	void _solve_contacts(void);
+
+	RodParameters _params;
+
+	Ogre::Vector3 _gravity;
+
+	vl::scalar _radius;
+
+	RodCollider *_collider;
+
+	/// Particles
+	std::vector<Ogre::Vector3> _x;
+	std::vector<Ogre::Vector3> _prev;
+	std::vector<Ogre::Vector3> _p;
+	std::vector<Ogre::Vector3> _v;
+	std::vector<vl::scalar> _inv_mass;
+	vl::scalar _particle_inv_mass;
+
+	/// Segments i, i+1
+	std::vector<vl::scalar> _rest;
+	/// Work arrays for the stretch solve
+	std::vector<Ogre::Vector3> _dir;
+	std::vector<vl::scalar> _diag;
+	std::vector<vl::scalar> _upper;
+	std::vector<vl::scalar> _rhs;
+	/// Bending i, i+2
+	std::vector<vl::scalar> _bend_rest;
+	std::vector<vl::scalar> _bend_lambda;
+
+	/// Nearest pinned particles on both sides, -1 if none
+	std::vector<int> _pin_before;
+	std::vector<int> _pin_after;
+	/// Distance along the rod from the start
+	std::vector<vl::scalar> _arc_length;
+
+	/// Contact planes, sphere center at contact
+	std::vector<Ogre::Vector3> _contact_point;
+	std::vector<Ogre::Vector3> _contact_normal;
+	std::vector<char> _in_contact;
+
+};	// class RodSolver
+
+}	// namespace physics
+
+}	// namespace vl
+
+#endif	// HYDRA_PHYSICS_ROD_SOLVER_HPP
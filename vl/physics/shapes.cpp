@@ -18,6 +18,8 @@
 /// Concrete implementation
 #include "shapes_bullet.hpp"
 
+#include "base/exceptions.hpp"
+
 vl::physics::BoxShapeRefPtr
 vl::physics::BoxShape::create(Ogre::Vector3 const &bounds)
 {
@@ -47,6 +49,13 @@ vl::physics::StaticTriangleMeshShape::create(vl::MeshRefPtr mesh)
 	return shape;
 }
 
+vl::physics::BvhStatistics &
+vl::physics::StaticTriangleMeshShape::getBvhStatistics(void)
+{
+	static BvhStatistics stats;
+	return stats;
+}
+
 vl::physics::ConvexHullShapeRefPtr
 vl::physics::ConvexHullShape::create(vl::MeshRefPtr mesh)
 {
@@ -57,7 +66,19 @@ vl::physics::ConvexHullShape::create(vl::MeshRefPtr mesh)
 vl::physics::ConcaveHullShapeRefPtr
 vl::physics::ConcaveHullShape::create(vl::MeshRefPtr mesh)
 {
-	ConcaveHullShapeRefPtr shape(new BulletConcaveHullShape(mesh));
+	return create(mesh, ConvexDecompositionSettings());
+}
+
+vl::physics::ConcaveHullShapeRefPtr
+vl::physics::ConcaveHullShape::create(vl::MeshRefPtr mesh, ConvexDecompositionSettings const &settings)
+{
+	if(!mesh)
+	{ BOOST_THROW_EXCEPTION(vl::null_pointer()); }
+
+	ConvexDecomposition decomposition;
+	load_convex_decomposition(*mesh, settings, decomposition);
+
+	ConcaveHullShapeRefPtr shape(new BulletConcaveHullShape(mesh, decomposition));
 	return shape;
 }
 
@@ -20,6 +20,10 @@
 #include "math/math.hpp"
 #include "math/conversion.hpp"
 
+#include "convex_decomposition.hpp"
+
+#include "base/time.hpp"
+
 namespace vl
 {
 
@@ -97,6 +101,25 @@ private :
 
 };	// class ConvexHullShape
 
+/// @brief time used for BVH trees of StaticTriangleMeshShapes
+/// Reported in the init report when a project is loaded.
+struct BvhStatistics
+{
+	BvhStatistics(void)
+		: n_built(0)
+		, n_loaded(0)
+	{}
+
+	size_t n_built;
+	size_t n_loaded;
+	vl::time build_time;
+	vl::time load_time;
+
+};	// struct BvhStatistics
+
+/// @brief static concave mesh
+/// BVH tree is cached next to the mesh file keyed by mesh hash,
+/// so it's only built when the mesh changes.
 class HYDRA_API StaticTriangleMeshShape : public CollisionShape
 {
 public :
@@ -104,6 +127,9 @@ public :
 
 	virtual ~StaticTriangleMeshShape(void) {}
 
+	/// @brief statistics for all shapes created since the last reset
+	static BvhStatistics &getBvhStatistics(void);
+
 protected :
 	StaticTriangleMeshShape(void) {}
 
@@ -146,16 +172,24 @@ private :
 
 };	// class ConvexHullShape
 
+/// @brief concave mesh for dynamic bodies
+/// Mesh is decomposed to a compound of convex hulls, the decomposition is
+/// cached next to the mesh file, see convex_decomposition.hpp.
 class HYDRA_API ConcaveHullShape : public CollisionShape
 {
 public :
 	static ConcaveHullShapeRefPtr create(vl::MeshRefPtr mesh);
 
+	static ConcaveHullShapeRefPtr create(vl::MeshRefPtr mesh, ConvexDecompositionSettings const &settings);
+
 	virtual ~ConcaveHullShape(void) {}
 
 	vl::MeshRefPtr getMesh(void) const
 	{ return _mesh; }
 
+	/// @brief number of convex hulls in the compound
+	virtual size_t getNumHulls(void) const = 0;
+
 protected :
 	ConcaveHullShape(vl::MeshRefPtr mesh)
 		: _mesh(mesh)
@@ -25,12 +25,17 @@
 /// Necesary for loading from mesh
 #include "mesh.hpp"
 #include "mesh_bullet.hpp"
+/// Necessary for the fallback hull of a concave shape
+#include "mesh_optimizer.hpp"
+#include "base/exceptions.hpp"
 
 // Concrete physics engine implementation
 #include "bullet/btBulletCollisionCommon.h"
-#include "bullet/BulletCollision/Gimpact/btGImpactShape.h"
 #include "math/conversion.hpp"
 
+/// Necessary for BVH timing
+#include "base/chrono.hpp"
+
 namespace vl
 {
 
@@ -145,7 +150,34 @@ public :
 		btTriangleIndexVertexArray *bt_mesh = new btTriangleIndexVertexArray;
 		vl::convert_bullet_geometry(mesh.get(), bt_mesh);
 
-		_bt_shape = new btBvhTriangleMeshShape(bt_mesh, false);
+		vl::chrono t;
+		BvhStatistics &stats = getBvhStatistics();
+
+		// Generated meshes don't have a file to cache with
+		std::string cache;
+		uint64_t hash = 0;
+		if(!mesh->getFilePath().empty())
+		{
+			cache = vl::get_bullet_bvh_cache(mesh->getFilePath());
+			hash = vl::calculate_mesh_hash(*mesh);
+		}
+
+		btOptimizedBvh *bvh = cache.empty() ? 0 : _bvh_cache.read(cache, hash);
+		if(bvh)
+		{
+			_bt_shape = new btBvhTriangleMeshShape(bt_mesh, true, false);
+			_bt_shape->setOptimizedBvh(bvh);
+			stats.load_time += t.elapsed();
+			++stats.n_loaded;
+		}
+		else
+		{
+			_bt_shape = new btBvhTriangleMeshShape(bt_mesh, true);
+			if(!cache.empty() && !vl::BulletBvhCache::write(cache, hash, _bt_shape->getOptimizedBvh()))
+			{ std::clog << "Couldn't write BVH cache " << cache << std::endl; }
+			stats.build_time += t.elapsed();
+			++stats.n_built;
+		}
 	}
 
 	virtual ~BulletStaticTriangleMeshShape(void) {}
@@ -164,6 +196,9 @@ public :
 
 private :
 	btBvhTriangleMeshShape *_bt_shape;
+
+	/// Owns the memory of a loaded tree
+	vl::BulletBvhCache _bvh_cache;
 };
 
 class BulletConvexHullShape : public BulletCollisionShape, public vl::physics::ConvexHullShape
@@ -201,21 +236,44 @@ private :
 };
 
 
+/// Compound of convex hulls instead of btGImpactMeshShape which is orders
+/// of magnitude slower for dynamic bodies.
 class BulletConcaveHullShape : public BulletCollisionShape, public vl::physics::ConcaveHullShape
 {
 public :
-	BulletConcaveHullShape(vl::MeshRefPtr mesh)
+	BulletConcaveHullShape(vl::MeshRefPtr mesh, vl::physics::ConvexDecomposition const &decomposition)
 		: ConcaveHullShape(mesh), _bt_shape(0)
 	{
-		btTriangleIndexVertexArray *bt_mesh = new btTriangleIndexVertexArray;
-		vl::convert_bullet_geometry(mesh.get(), bt_mesh);
+		_bt_shape = new btCompoundShape(decomposition.hulls.size() > 1);
+		for(size_t i = 0; i < decomposition.hulls.size(); ++i)
+		{
+			std::vector<Ogre::Vector3> const &hull = decomposition.hulls.at(i);
+			btConvexHullShape *child = new btConvexHullShape;
+			for(size_t j = 0; j < hull.size(); ++j)
+			{ child->addPoint(vl::math::convert_bt_vec(hull.at(j))); }
+			_bt_shape->addChildShape(btTransform::getIdentity(), child);
+		}
+
+		// Decomposition failed, e.g. a flat mesh, use a single hull
+		// of all the vertices so the shape still collides
+		if(decomposition.hulls.empty())
+		{ _addMeshHull(*mesh); }
+	}
 
-		_bt_shape = new btGImpactMeshShape(bt_mesh);
-		
-		_bt_shape->updateBound();
+	/// Hulls are owned by the shape, they are not shared
+	virtual ~BulletConcaveHullShape(void)
+	{
+		for(int i = _bt_shape->getNumChildShapes() - 1; i >= 0; --i)
+		{
+			btCollisionShape *child = _bt_shape->getChildShape(i);
+			_bt_shape->removeChildShapeByIndex(i);
+			delete child;
+		}
+		delete _bt_shape;
 	}
 
-	virtual ~BulletConcaveHullShape(void) {}
+	virtual size_t getNumHulls(void) const
+	{ return _bt_shape->getNumChildShapes(); }
 
 	virtual void setMargin(vl::scalar margin)
 	{ _bt_shape->setMargin(margin); }
@@ -230,7 +288,34 @@ public :
 	{ return _bt_shape; }
 
 private :
-	btGImpactMeshShape *_bt_shape;
+	void _addMeshHull(vl::Mesh const &mesh)
+	{
+		std::vector<Ogre::Vector3> points;
+		std::vector<Ogre::Vector3> positions;
+		if(mesh.sharedVertexData && vl::read_positions(*mesh.sharedVertexData, positions))
+		{ points.insert(points.end(), positions.begin(), positions.end()); }
+		for(unsigned int i = 0; i < mesh.getNumSubMeshes(); ++i)
+		{
+			vl::SubMesh const *sm = mesh.getSubMesh(i);
+			if(sm->vertexData && vl::read_positions(*sm->vertexData, positions))
+			{ points.insert(points.end(), positions.begin(), positions.end()); }
+		}
+
+		if(points.empty())
+		{
+			// Called from the constructor so the destructor is not
+			delete _bt_shape;
+			std::string msg("Mesh " + mesh.getName() + " has no vertices for a collision shape.");
+			BOOST_THROW_EXCEPTION(vl::exception() << vl::desc(msg));
+		}
+
+		btConvexHullShape *child = new btConvexHullShape;
+		for(size_t i = 0; i < points.size(); ++i)
+		{ child->addPoint(vl::math::convert_bt_vec(points.at(i))); }
+		_bt_shape->addChildShape(btTransform::getIdentity(), child);
+	}
+
+	btCompoundShape *_bt_shape;
 };
 
 class BulletCompoundShape : public BulletCollisionShape, public vl::physics::CompoundShape
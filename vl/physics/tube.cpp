@@ -24,17 +24,49 @@
 #include "physics/motion_state.hpp"
 /// Necessary for creating collision shapes
 #include "physics/shapes.hpp"
+/// Necessary for the rod solver backend
+#include "physics/rod_solver.hpp"
 
-/// Necessary for generating the mesh
-#include "mesh_manager.hpp"
-/// Necessary for attaching the generated mesh/meshes to the SceneGraph
+/// Necessary for drawing the tube
+#include "tube_mesh.hpp"
+/// Necessary for attaching the generated mesh to the SceneGraph
 #include "scene_node.hpp"
-// Necessary for creating SceneNodes and retriving mesh manager
+// Necessary for creating SceneNodes and the mesh
 #include "scene_manager.hpp"
-#include "entity.hpp"
 
 size_t vl::physics::Tube::n_tubes = 0;
 
+namespace
+{
+
+/// Collides the rod particles with the physics world
+class WorldRodCollider : public vl::physics::RodCollider
+{
+public :
+	WorldRodCollider(vl::physics::WorldPtr world)
+		: _world(world)
+	{}
+
+	virtual bool sweepSphere(Ogre::Vector3 const &from, Ogre::Vector3 const &to,
+		vl::scalar radius, vl::physics::RodContact &contact)
+	{
+		vl::physics::RayHitResult hit;
+		if(!_world->sweepSphere(from, to, radius, hit))
+		{ return false; }
+
+		contact.point = hit.hit_point_world;
+		contact.normal = hit.hit_normal_world;
+		contact.fraction = hit.hit_fraction;
+		return true;
+	}
+
+private :
+	vl::physics::WorldPtr _world;
+
+};	// class WorldRodCollider
+
+}	// unamed namespace
+
 std::ostream &
 vl::physics::operator<<(std::ostream &os, vl::physics::Tube const &tube)
 {
@@ -69,7 +101,6 @@ vl::physics::Tube::Tube(WorldPtr world, SceneManagerPtr sm, Tube::ConstructionIn
 	, _spring(info.spring)
 	, _disable_collisions(info.disable_collisions)
 	, _disable_internal_collisions(info.disable_internal_collisions)
-	, _use_instancing(info.use_instancing)
 	, _inertia(Vector3(0, 0, 0))
 	, _lower_lim(info.lower_lim)
 	, _upper_lim(info.upper_lim)
@@ -78,6 +109,11 @@ vl::physics::Tube::Tube(WorldPtr world, SceneManagerPtr sm, Tube::ConstructionIn
 	, _material_name(info.material_name)
 	, _start_body_frame(info.start_body_frame)
 	, _end_body_frame(info.end_body_frame)
+	, _node(0)
+	, _tube_mesh(0)
+	, _solver(info.solver)
+	, _solver_iterations(info.solver_iterations)
+	, _rod_time(0)
 	, _world(world)
 	, _scene(sm)
 {
@@ -155,22 +191,11 @@ vl::physics::Tube::~Tube(void)
 	_constraints.clear();
 	_bodies.clear();
 
-	/// @todo should remove and destroy all used SceneNodes
-	/// and MovableObjects
-	/// We need to keep a list of them for easy removal.
-	for(EntityList::iterator iter = _entities.begin(); 
-		iter != _entities.end(); ++iter)
-	{
-		_scene->destroyMovableObject(*iter);
-	}
-	_entities.clear();
+	if(_tube_mesh)
+	{ _scene->destroyMovableObject(_tube_mesh); }
 
-	for(SceneNodeList::iterator iter = _nodes.begin(); 
-		iter != _nodes.end(); ++iter)
-	{
-		_scene->destroySceneNode(*iter);
-	}
-	_nodes.clear();
+	if(_node)
+	{ _scene->destroySceneNode(_node); }
 }
 
 void
@@ -217,6 +242,16 @@ vl::physics::Tube::isInWorld(void) const
 void
 vl::physics::Tube::setSpringStiffness(vl::scalar stiffness)
 {
+	// Rod and the constraints are modified by the physics thread while stepping
+	_world->finishStep();
+
+	if(_rod)
+	{
+		_stiffness = stiffness;
+		_updateRodParameters();
+		return;
+	}
+
 	if(_spring && _stiffness != stiffness)
 	{
 		for(ConstraintList::iterator iter = _constraints.begin()+1;
@@ -235,7 +270,10 @@ vl::physics::Tube::setSpringStiffness(vl::scalar stiffness)
 void
 vl::physics::Tube::setSpringDamping(vl::scalar damping)
 {
-	if(_spring && _damping != damping)
+	_world->finishStep();
+
+	// Rod bending is critically damped by the solver
+	if(_spring && !_rod && _damping != damping)
 	{
 		for(ConstraintList::iterator iter = _constraints.begin()+1;
 			iter != _constraints.end()-1; ++iter)
@@ -253,6 +291,8 @@ vl::physics::Tube::setSpringDamping(vl::scalar damping)
 void
 vl::physics::Tube::setDamping(vl::scalar damping)
 {
+	_world->finishStep();
+
 	if(_body_damping != damping)
 	{
 		for(RigidBodyList::iterator iter = _bodies.begin();
@@ -262,6 +302,7 @@ vl::physics::Tube::setDamping(vl::scalar damping)
 		}
 
 		_body_damping = damping;
+		_updateRodParameters();
 	}
 }
 
@@ -282,10 +323,18 @@ vl::physics::Tube::setMaterial(std::string const &material)
 void
 vl::physics::Tube::setLowerLim(Ogre::Vector3 const &lim)
 {
+	_world->finishStep();
+
 	if(_lower_lim != lim)
 	{
 		_lower_lim = lim;
 
+		if(_rod)
+		{
+			_updateRodParameters();
+			return;
+		}
+
 		for(ConstraintList::iterator iter = _constraints.begin()+1;
 			iter != _constraints.end()-1; ++iter)
 		{
@@ -298,10 +347,18 @@ vl::physics::Tube::setLowerLim(Ogre::Vector3 const &lim)
 void
 vl::physics::Tube::setUpperLim(Ogre::Vector3 const &lim)
 {
+	_world->finishStep();
+
 	if(_upper_lim != lim)
 	{
 		_upper_lim = lim;
 
+		if(_rod)
+		{
+			_updateRodParameters();
+			return;
+		}
+
 		for(ConstraintList::iterator iter = _constraints.begin()+1;
 			iter != _constraints.end()-1; ++iter)
 		{
@@ -314,41 +371,29 @@ vl::physics::Tube::setUpperLim(Ogre::Vector3 const &lim)
 void
 vl::physics::Tube::hide(void)
 {
-	for(RigidBodyList::const_iterator iter = _bodies.begin(); iter != _bodies.end(); ++iter)
-	{
-		MotionState *ms = (*iter)->getMotionState();
-		assert(ms->getNode());
-		ms->getNode()->hide();
-	}
+	if(_node)
+	{ _node->hide(); }
 }
 
 void
 vl::physics::Tube::show(void)
 {
-	for(RigidBodyList::const_iterator iter = _bodies.begin(); iter != _bodies.end(); ++iter)
-	{
-		MotionState *ms = (*iter)->getMotionState();
-		assert(ms->getNode());
-		ms->getNode()->show();
-	}
+	if(_node)
+	{ _node->show(); }
 }
 
 void
 vl::physics::Tube::setShowBoundingBoxes(bool show)
 {
-	for(RigidBodyList::const_iterator iter = _bodies.begin(); iter != _bodies.end(); ++iter)
-	{
-		MotionState *ms = (*iter)->getMotionState();
-		assert(ms->getNode());
-		ms->getNode()->setShowBoundingBox(show);
-	}
+	if(_node)
+	{ _node->setShowBoundingBox(show); }
 }
 
 bool
 vl::physics::Tube::isShowBoundingBoxes(void) const
 {
-	if(_bodies.size() > 0 && _bodies.at(0)->getMotionState() && _bodies.at(0)->getMotionState()->getNode())
-	{ return _bodies.at(0)->getMotionState()->getNode()->getShowBoundingBox(); }
+	if(_node)
+	{ return _node->getShowBoundingBox(); }
 	
 	return false;
 }
@@ -356,9 +401,17 @@ vl::physics::Tube::isShowBoundingBoxes(void) const
 void
 vl::physics::Tube::setEquilibrium(void)
 {
+	_world->finishStep();
+
 	if(!_spring)
 	{ return; }
 
+	if(_rod)
+	{
+		_rod->setBendingRestShape();
+		return;
+	}
+
 	for(ConstraintList::iterator iter = _constraints.begin();
 		iter != _constraints.end(); ++iter)
 	{
@@ -382,11 +435,12 @@ vl::physics::Tube::addFixingPoint(RigidBodyRefPtr body, vl::scalar length)
 		BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Already has a fixing at the point."));
 	}
 
+	_world->finishStep();
 	_fixing_bodies[length] = body;
 
 
 	// Just record the fixing poinsts as the tube has not yet been created
-	if(!_bodies.empty())
+	if(!_bodies.empty() || _rod)
 	{
 		_add_fixing_point(body, length);
 	}
@@ -395,6 +449,19 @@ vl::physics::Tube::addFixingPoint(RigidBodyRefPtr body, vl::scalar length)
 void
 vl::physics::Tube::removeFixingPoint(RigidBodyRefPtr body)
 {
+	_world->finishStep();
+
+	// Start and end pins can't be removed
+	for(size_t i = 2; i < _rod_pins.size(); ++i)
+	{
+		if(_rod_pins.at(i).body == body)
+		{
+			_rod->unpin(_rod_pins.at(i).index);
+			_rod_pins.erase(_rod_pins.begin() + i);
+			return;
+		}
+	}
+
 	for(ConstraintList::iterator iter = _external_fixings.begin(); 
 		iter != _external_fixings.end(); ++iter)
 	{
@@ -412,11 +479,22 @@ vl::physics::Tube::removeFixingPoint(RigidBodyRefPtr body)
 void
 vl::physics::Tube::create(void)
 {
-	if(!_bodies.empty())
+	if(!_bodies.empty() || _rod)
 	{
 		BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Tube already created"));
 	}
 
+	if(_solver == TS_ROD)
+	{
+		_createRod();
+
+		if(_scene)
+		{ _createMesh(); }
+
+		++n_tubes;
+		return;
+	}
+
 	/// General parameters that stay constant for the whole tube
 	uint16_t n_elements = std::ceil(_length/_element_size);
 	vl::scalar elem_length = _length/n_elements;
@@ -543,9 +621,9 @@ vl::physics::Tube::create(void)
 		_add_fixing_point(iter->second, iter->first);
 	}
 
-	assert(_scene);
-	// Create the mesh
-	_createMesh(_scene->getMeshManager());
+	// Create the mesh, tubes can be simulated without graphics
+	if(_scene)
+	{ _createMesh(); }
 
 
 	// Increase the static counter
@@ -555,24 +633,36 @@ vl::physics::Tube::create(void)
 vl::physics::SixDofConstraintRefPtr
 vl::physics::Tube::getStartFixing(void)
 {
+	if(_rod)
+	{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Rod tubes don't have fixing constraints.")); }
+
 	return boost::dynamic_pointer_cast<SixDofConstraint>(*_constraints.begin());
 }
 
 vl::physics::SixDofConstraintRefPtr
 vl::physics::Tube::getEndFixing(void)
 {
+	if(_rod)
+	{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Rod tubes don't have fixing constraints.")); }
+
 	return boost::dynamic_pointer_cast<SixDofConstraint>(*(_constraints.end()-1));
 }
 
 vl::physics::SixDofConstraintRefPtr
 vl::physics::Tube::getFixing(size_t index)
 {
+	if(_rod)
+	{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Rod tubes don't have fixing constraints.")); }
+
 	return boost::dynamic_pointer_cast<SixDofConstraint>(_external_fixings.at(index));
 }
 
 size_t
 vl::physics::Tube::getNFixings(void) const
 {
+	if(_rod)
+	{ return _rod_pins.size() - 2; }
+
 	return _external_fixings.size();
 }
 
@@ -582,6 +672,32 @@ vl::physics::Tube::getFixings(void) const
 	return _external_fixings;
 }
 
+vl::scalar
+vl::physics::Tube::getStretch(void) const
+{
+	_world->finishStep();
+
+	if(_rod)
+	{ return _rod->getStretch(); }
+
+	if(_bodies.empty())
+	{ return 0; }
+
+	// Elements are connected from their ends so the path through
+	// the fixings and element centers is the tube length
+	Ogre::Vector3 pos = (_start_body->getWorldTransform()*_start_body_frame).position;
+	vl::scalar length = 0;
+	for(RigidBodyList::const_iterator iter = _bodies.begin(); iter != _bodies.end(); ++iter)
+	{
+		Ogre::Vector3 next = (*iter)->getWorldTransform().position;
+		length += pos.distance(next);
+		pos = next;
+	}
+	length += pos.distance((_end_body->getWorldTransform()*_end_body_frame).position);
+
+	return length/_length - 1;
+}
+
 /// ---------------------------------- Private -------------------------------
 void
 vl::physics::Tube::_createConstraints(vl::Transform const &start_frame, vl::Transform const &end_frame, vl::scalar elem_length)
@@ -651,57 +767,21 @@ vl::physics::Tube::_setConstraint(ConstraintRefPtr constraint,
 
 
 void
-vl::physics::Tube::_createMesh(MeshManagerRefPtr mesh_manager)
+vl::physics::Tube::_createMesh(void)
 {
 	std::clog << "vl::physics::Tube::_createMesh" << std::endl;
-	/// create the graphics objects
-	/// we need access to the MeshManager and SceneManager for this
-	/// for now using simple cubes for the graphics meshes, later
-	/// bones and a generated tube mesh.
-	
-	// Create the box element reused for all the bodies
-	std::stringstream mesh_name;
-	mesh_name << "tube_" << n_tubes << "_element";
-	std::clog << "Copying size from physics shape : size = " << _shape->getSize();
-	mesh_manager->createCube(mesh_name.str(), _shape->getSize());
-
-	/// Create the SceneNodes
-	if(!_start_body->getMotionState() || !_start_body->getMotionState()->getNode())
-	{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Invalid Motion state or node.")); }
-
-	size_t index = 0;
-	for(RigidBodyList::const_iterator iter = _bodies.begin(); iter != _bodies.end(); ++iter)
-	{
-		/// Create the SceneNode and Entity
-		std::stringstream name;
-		name << mesh_name.str() << "_" << index;
-
-		MotionState *ms = (*iter)->getMotionState();
-		// check that there the MotionState is still valid
-		assert(!ms->getNode());
-
-		// We need to use root node for the physics engine to work correctly
-		SceneNodePtr node = _scene->getRootSceneNode()->createChildSceneNode(name.str());
-		ms->setNode(node);
-		_nodes.push_back(node);
 
-		EntityPtr ent = _scene->createEntity(name.str(), mesh_name.str(), true);
-		ent->setInstanced(_use_instancing);
-		// Force instanced material
-		if(_use_instancing)
-		{ _material_name = "tube/instanced"; }
-		ent->setMaterialName(_material_name);
-		node->attachObject(ent);
-		_entities.push_back(ent);
-
-		++index;
-	}
-
-	std::clog << "Created " << index << " graphics objects for the tube." << std::endl;
-
-	/// Mesh and Scene managers can be accessed using the start and end bodies
-	/// they need to have a MotionState attached to them and a SceneNode
-	/// attached to that for this to work.
+	// Single mesh swept through the elements, so the tube is one draw call
+	// and one update independent of the number of elements.
+	// Frames are in world space so the node is under root.
+	std::stringstream name;
+	name << "tube_" << n_tubes;
+	_node = _scene->getRootSceneNode()->createChildSceneNode(name.str());
+	_tube_mesh = _scene->createDynamicTubeMesh(name.str(), _material_name);
+	_tube_mesh->setRadius(_tube_radius);
+	_node->attachObject(_tube_mesh);
+
+	_publish();
 }
 
 vl::physics::RigidBodyRefPtr
@@ -754,6 +834,31 @@ vl::physics::Tube::_findBodyByPosition(Ogre::Vector3 const &pos)
 void
 vl::physics::Tube::_add_fixing_point(RigidBodyRefPtr body, vl::scalar length)
 {
+	if(_rod)
+	{
+		size_t n_particles = _rod->getNParticles();
+		size_t index = 0;
+		if(length < 0)
+		{
+			// Closest particle
+			Ogre::Vector3 pos = body->getWorldTransform().position;
+			std::vector<Ogre::Vector3> const &x = _rod->getPositions();
+			for(size_t i = 1; i < n_particles; ++i)
+			{
+				if(x[i].squaredDistance(pos) < x[index].squaredDistance(pos))
+				{ index = i; }
+			}
+		}
+		else
+		{
+			index = (size_t)(length/_length*(n_particles-1) + 0.5);
+			index = std::min(index, n_particles-1);
+		}
+
+		_add_rod_pin(body, index, vl::Transform());
+		return;
+	}
+
 	// Find the closest body
 	RigidBodyRefPtr tube_body;
 	
@@ -785,3 +890,217 @@ vl::physics::Tube::_add_fixing_point(RigidBodyRefPtr body, vl::scalar length)
 
 	_external_fixings.push_back(constraint);
 }
+
+void
+vl::physics::Tube::_createRod(void)
+{
+	uint16_t n_elements = std::ceil(_length/_element_size);
+
+	Ogre::Vector3 start = (_start_body->getWorldTransform()*_start_body_frame).position;
+	Ogre::Vector3 end = (_end_body->getWorldTransform()*_end_body_frame).position;
+
+	// Start from a parabola of the tube length hanging between the ends
+	// so the rod is not stretched or coiled when the simulation starts.
+	// Arc length of a shallow parabola is d + 8h^2/3d.
+	Ogre::Vector3 chord = end - start;
+	vl::scalar d = chord.length();
+	vl::scalar sag = 0;
+	if(d < _length*1e-3)
+	{ sag = _length/2; }
+	else if(d < _length)
+	{ sag = std::sqrt(3*d*(_length - d)/8); }
+	else
+	{
+		std::clog << "Tube is shorter than the distance between the ends, "
+			<< "it will be created stretched." << std::endl;
+	}
+
+	// Sag towards gravity perpendicular to the chord
+	Ogre::Vector3 down = _world->getGravity();
+	if(d > 0)
+	{ down -= chord*(down.dotProduct(chord)/(d*d)); }
+	if(down.isZeroLength())
+	{ down = d > 0 ? chord.perpendicular() : Ogre::Vector3::NEGATIVE_UNIT_Y; }
+	down.normalise();
+
+	std::vector<Ogre::Vector3> positions(n_elements+1);
+	for(size_t i = 0; i < positions.size(); ++i)
+	{
+		vl::scalar s = vl::scalar(i)/n_elements;
+		positions.at(i) = start + chord*s + down*(4*sag*s*(1-s));
+	}
+
+	_rod.reset(new RodSolver(positions, _mass/positions.size(), _tube_radius));
+	_rod->setGravity(_world->getGravity());
+	if(!_disable_collisions)
+	{
+		_rod_collider.reset(new WorldRodCollider(_world));
+		_rod->setCollider(_rod_collider.get());
+	}
+	_updateRodParameters();
+
+	std::clog << "Creating a rod tube with " << n_elements << " elements." << std::endl
+		<< " and with " << _fixing_bodies.size() << " fixing points." << std::endl;
+
+	// Rod would collide with the bodies it's fixed to
+	_start_body->disableCollisions(true);
+	_end_body->disableCollisions(true);
+
+	_add_rod_pin(_start_body, 0, _start_body_frame);
+	_add_rod_pin(_end_body, n_elements, _end_body_frame);
+
+	for(std::map<vl::scalar, RigidBodyRefPtr>::iterator iter = _fixing_bodies.begin();
+		iter != _fixing_bodies.end(); ++iter)
+	{
+		_add_fixing_point(iter->second, iter->first);
+	}
+}
+
+void
+vl::physics::Tube::_updateRodParameters(void)
+{
+	if(!_rod)
+	{ return; }
+
+	RodParameters params = _rod->getParameters();
+	params.iterations = _solver_iterations;
+	params.damping = _body_damping;
+	params.bending_compliance = (_spring && _stiffness > 0) ? 1/_stiffness : -1;
+
+	// Limits around the tube axis are ignored as twisting is not simulated,
+	// lower limit greater than upper is a free axis like for constraints.
+	params.max_bending_angle = -1;
+	for(size_t i = 0; i < 2; ++i)
+	{
+		if(_lower_lim[i] <= _upper_lim[i])
+		{
+			vl::scalar angle = std::max(std::abs(_lower_lim[i]), std::abs(_upper_lim[i]));
+			params.max_bending_angle = std::max(params.max_bending_angle, angle);
+		}
+	}
+
+	_rod->setParameters(params);
+}
+
+void
+vl::physics::Tube::_add_rod_pin(RigidBodyRefPtr body, size_t index, vl::Transform const &frame)
+{
+	if(_rod->isPinned(index))
+	{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Already has a fixing at the point.")); }
+
+	RodPin pin;
+	pin.body = body;
+	pin.index = index;
+	pin.frame = frame;
+	pin.position = (body->getWorldTransform()*frame).position;
+	_rod->pin(index, pin.position);
+	_rod_pins.push_back(pin);
+}
+
+void
+vl::physics::Tube::_step(vl::time const &time_step)
+{
+	if(!_rod)
+	{ return; }
+
+	// Same fixed steps as the rigid bodies use
+	SolverParameters const &solver = _world->getSolverParameters();
+	vl::scalar dt = solver.internal_time_step;
+	size_t n_steps = 1;
+	if(solver.max_sub_steps > 0)
+	{
+		_rod_time += (double)time_step;
+		n_steps = (size_t)(_rod_time/dt);
+		_rod_time -= n_steps*dt;
+		n_steps = std::min(n_steps, (size_t)solver.max_sub_steps);
+	}
+	else
+	{ dt = (double)time_step; }
+
+	if(n_steps == 0)
+	{ return; }
+
+	_rod->setGravity(_world->getGravity());
+
+	// Bodies have already been stepped, so move the pins linearly
+	// from their last positions during the sub steps.
+	std::vector<Ogre::Vector3> targets(_rod_pins.size());
+	for(size_t i = 0; i < _rod_pins.size(); ++i)
+	{ targets.at(i) = (_rod_pins.at(i).body->getWorldTransform()*_rod_pins.at(i).frame).position; }
+
+	for(size_t step = 0; step < n_steps; ++step)
+	{
+		vl::scalar s = vl::scalar(step+1)/n_steps;
+		for(size_t i = 0; i < _rod_pins.size(); ++i)
+		{
+			RodPin const &pin = _rod_pins.at(i);
+			_rod->setPinPosition(pin.index, pin.position + (targets.at(i) - pin.position)*s);
+		}
+		_rod->step(dt);
+	}
+
+	for(size_t i = 0; i < _rod_pins.size(); ++i)
+	{ _rod_pins.at(i).position = targets.at(i); }
+}
+
+void
+vl::physics::Tube::_publish(void)
+{
+	if(!_tube_mesh)
+	{ return; }
+
+	if(_rod)
+	{
+		SolverParameters const &solver = _world->getSolverParameters();
+		vl::scalar alpha = 1;
+		if(solver.max_sub_steps > 0)
+		{ alpha = _rod_time/solver.internal_time_step; }
+
+		size_t n = _rod->getNParticles();
+		_frames.resize(n);
+		for(size_t i = 0; i < n; ++i)
+		{ _frames[i].position = _rod->getInterpolatedPosition(i, alpha); }
+
+		// Parallel transport the orientation along the rod so the
+		// mesh doesn't twist around the tube axis
+		Ogre::Vector3 dir = Ogre::Vector3::UNIT_Z;
+		Ogre::Quaternion q = Ogre::Quaternion::IDENTITY;
+		for(size_t i = 0; i < n; ++i)
+		{
+			Ogre::Vector3 tangent = _frames[std::min(i+1, n-1)].position
+				- _frames[i > 0 ? i-1 : 0].position;
+			if(!tangent.isZeroLength())
+			{
+				tangent.normalise();
+				q = dir.getRotationTo(tangent)*q;
+				q.normalise();
+				dir = tangent;
+			}
+			_frames[i].quaternion = q;
+		}
+	}
+	else if(!_bodies.empty())
+	{
+		// Joints are at the ends of the elements
+		Ogre::Vector3 offset(0, 0, _length/_bodies.size()/2);
+		_frames.resize(_bodies.size()+1);
+		for(size_t i = 0; i < _bodies.size(); ++i)
+		{
+			MotionState const *ms = _bodies.at(i)->getMotionState();
+			Ogre::Quaternion const &q = ms->getOrientation();
+			Ogre::Vector3 back = ms->getPosition() - q*offset;
+			if(i == 0)
+			{ _frames.at(0) = vl::Transform(back, q); }
+			else
+			{
+				// Joints are slightly apart when the constraints are not fully solved
+				vl::Transform &joint = _frames.at(i);
+				joint.position = (joint.position + back)/2;
+				joint.quaternion = Ogre::Quaternion::Slerp(0.5, joint.quaternion, q, true);
+			}
+			_frames.at(i+1) = vl::Transform(ms->getPosition() + q*offset, q);
+		}
+	}
+
+	_tube_mesh->setFrames(_frames);
+}
@@ -23,8 +23,11 @@
 #include "typedefs.hpp"
 // Necessary for HYDRA_API
 #include "defines.hpp"
+// Necessary for time step
+#include "base/time.hpp"
 
 #include <boost/enable_shared_from_this.hpp>
+#include <boost/scoped_ptr.hpp>
 
 namespace vl
 {
@@ -32,6 +35,18 @@ namespace vl
 namespace physics
 {
 
+class RodSolver;
+class RodCollider;
+
+enum TUBE_SOLVER
+{
+	/// Chain of rigid bodies and constraints in the physics world
+	TS_RIGID_BODIES,
+	/// Position based rod, fast and doesn't stretch but
+	/// the coupling to bodies is one way
+	TS_ROD
+};
+
 /**	@class Tube
  *	@brief Simulates a single hydraulic tube with two endpoints
  */
@@ -63,6 +78,8 @@ public :
 			, body_damping(0)
 			, bending_radius(-1)
 			, use_instancing(false)
+			, solver(TS_RIGID_BODIES)
+			, solver_iterations(8)
 		{}
 
 		RigidBodyRefPtr start_body;
@@ -100,8 +117,13 @@ public :
 		// discarding the predefined ones.
 		vl::scalar bending_radius;
 
-		// rendering optimisation, still experimental
+		// Not used anymore, tubes are drawn as a single mesh
 		bool use_instancing;
+
+		TUBE_SOLVER solver;
+
+		// Constraint iterations per step for the rod solver
+		uint32_t solver_iterations;
 	};
 
 	/**	@brief Constructor
@@ -197,6 +219,7 @@ public :
 
 	/// These are valid only after create has been called
 	/// will throw if they are called before the tube is created
+	/// Rod tubes have no constraints so the fixing getters throw for them.
 
 	SixDofConstraintRefPtr getStartFixing(void);
 
@@ -212,10 +235,41 @@ public :
 	/// @brief get all fixing points except the start and end point
 	ConstraintList const &getFixings(void) const;
 
+	/// @brief empty for tubes using the rod solver
 	RigidBodyList const &getBodies(void) const
 	{ return _bodies; }
 
+	TUBE_SOLVER getSolver(void) const
+	{ return _solver; }
+
+	/// @brief relative elongation of the tube, 0 when it's not stretched
+	vl::scalar getStretch(void) const;
+
 private :
+	friend class World;
+
+	/// A particle of the rod fixed to a body
+	struct RodPin
+	{
+		RigidBodyRefPtr body;
+		size_t index;
+		vl::Transform frame;
+		/// Position at the end of the last step
+		Ogre::Vector3 position;
+	};
+
+	/// @brief advance the rod simulation, does nothing for rigid bodies
+	void _step(vl::time const &time_step);
+
+	/// @brief update the tube mesh from the simulation
+	void _publish(void);
+
+	void _createRod(void);
+
+	void _updateRodParameters(void);
+
+	void _add_rod_pin(RigidBodyRefPtr body, size_t index, vl::Transform const &frame);
+
 	/// Used for naming purposes
 	static size_t n_tubes;
 
@@ -224,7 +278,7 @@ private :
 	/// Helper methods for Graphics engine so we don't need to pass 
 	/// all this information to the constructor, which would be pretty hard
 	/// as we would need to pass it also to the World.
-	void _createMesh(MeshManagerRefPtr mesh_manager);
+	void _createMesh(void);
 
 	void _setConstraint(ConstraintRefPtr constraint, Ogre::Vector3 const &lower, Ogre::Vector3 const &upper);
 
@@ -247,8 +301,10 @@ private :
 	std::map<vl::scalar, RigidBodyRefPtr> _fixing_bodies;
 	ConstraintList _external_fixings;
 
-	SceneNodeList _nodes;
-	EntityList _entities; 
+	SceneNodePtr _node;
+	TubeMeshPtr _tube_mesh;
+	/// Frames of the tube mesh, one at every joint or particle
+	std::vector<vl::Transform> _frames;
 
 	vl::scalar _length;
 	vl::scalar _stiffness;
@@ -260,7 +316,6 @@ private :
 	bool _spring;
 	bool _disable_internal_collisions;
 	bool _disable_collisions;
-	bool _use_instancing;
 
 	Ogre::Vector3 _inertia;
 
@@ -275,6 +330,16 @@ private :
 	vl::Transform _start_body_frame;
 	vl::Transform _end_body_frame;
 
+	TUBE_SOLVER _solver;
+	uint32_t _solver_iterations;
+
+	boost::scoped_ptr<RodSolver> _rod;
+	boost::scoped_ptr<RodCollider> _rod_collider;
+	/// Start and end first and then the extra fixings
+	std::vector<RodPin> _rod_pins;
+	/// Time not yet simulated, used for interpolating the rod
+	vl::scalar _rod_time;
+
 	WorldPtr _world;
 	SceneManagerPtr _scene;
 
@@ -21,7 +21,9 @@ vl::operator<<(std::ostream &os, vl::ProfilerReport const &report)
 		<< "PHYSICS : " << report._profiling.at(PT_PHYSICS).result() << "\n"
 		<< "COLLISIONS" << report._profiling.at(PT_COLLISIONS).result() << "\n"
 		<< "RENDERING : " << report._profiling.at(PT_RENDERING).result() << "\n"
-		<< "FRAME TOTAL : " << report._profiling.at(PT_FRAME).result() << "\n";
+		<< "FRAME TOTAL : " << report._profiling.at(PT_FRAME).result() << "\n"
+		<< "PHYSICS THREAD : " << report._profiling.at(PT_PHYSICS_THREAD).result() << "\n"
+		<< "PYTHON : " << report._profiling.at(PT_PYTHON).result() << "\n";
 
 	return os;
 }
@@ -40,6 +40,12 @@ enum PROFILER_TOTAL
 	PT_COLLISIONS,
 	PT_RENDERING,
 	PT_FRAME,
+	/// Simulation time in the physics thread, not part of the frame
+	/// when physics are threaded
+	PT_PHYSICS_THREAD,
+	/// Python scripts and callbacks, measured when the PythonProfiler
+	/// is enabled
+	PT_PYTHON,
 	PT_SIZE,	// Keep as a last element used to determine size
 };
 
@@ -33,6 +33,7 @@
 #include "revision_defines.hpp"
 
 #include "base/string_utils.hpp"
+#include "base/exceptions.hpp"
 
 namespace po = boost::program_options;
 
@@ -42,10 +43,14 @@ vl::ProgramOptions::ProgramOptions(std::string const &ini_file)
 	, display_n(0)
 	, n_processors(-1)
 	, start_processor(0)
+	, python_workers(1)
+	, kinematic_threads(1)
 	, _slave(false)
 	, _ini_file(ini_file)
 	, launcher_port(9556)
 	, oculus_rift(false)
+	, collada_generate_lods(false)
+	, _mesh_cache_dir_name("mesh_cache")
 {
 	/// Find search directories for the ini file
 	/// The executable path
@@ -109,6 +114,24 @@ vl::ProgramOptions::getLogFile(void) const
 	return log.string();
 }
 
+std::string
+vl::ProgramOptions::getMeshCacheDir(void) const
+{
+	if(_mesh_cache_dir_name.empty() || fs::path(_mesh_cache_dir_name).is_absolute())
+	{ return _mesh_cache_dir_name; }
+	else
+	{
+		fs::path exe_dir = vl::get_global_path(vl::GP_EXE);
+		exe_dir.remove_leaf();
+
+		// Virtual clusters share the exe dir, slaves need separate caches
+		// because they write to them at the same time
+		fs::path dir = exe_dir / fs::path(_mesh_cache_dir_name) / slave_name;
+
+		return dir.string();
+	}
+}
+
 std::string
 vl::ProgramOptions::getLogDir(void) const
 {
@@ -157,6 +180,7 @@ vl::ProgramOptions::parseOptions( int argc, char **argv )
 //				"name of a file of a configuration.")
 		("log_level,l", po::value<int>(), "how much detail is logged")
 		("log_dir", po::value<std::string>(&_log_dir_name), "where to write the log files")
+		("mesh_cache", po::value<std::string>(&_mesh_cache_dir_name), "where slaves cache the meshes, empty to disable")
 		("environment,e", po::value< std::string >(&environment_file), "environment file")
 		("project,p", po::value< std::string >(&project_file), "project file")
 		("global,g", po::value< std::string >(&global_file), "global file")
@@ -167,6 +191,11 @@ vl::ProgramOptions::parseOptions( int argc, char **argv )
 		("start_processor", po::value<int>(&start_processor), 
 			"First processor to use only has effect if processor is defined also.")
 		("debug_overlay", po::value<bool>(&debug.overlay), "Enable debug overlay.")
+		("python_profiler", po::value<bool>(&debug.python_profiler), "Enable Python profiler.")
+		("python_frame_budget", po::value<double>(&debug.python_frame_budget),
+			"Log Python zones if they take longer than this in a frame, in milliseconds.")
+		("allocation_tracking", po::value<bool>(&debug.allocation_tracking),
+			"Count heap allocations per frame.")
 	;
 
 	// Parse command line
@@ -262,17 +291,35 @@ vl::ProgramOptions::_parse_ini(void)
 	display_n = pt.get("display", 0);
 	log_level = pt.get("log.level", 0);
 	_log_dir_name = pt.get("log.dir", "");
+	_mesh_cache_dir_name = pt.get("cache.mesh_dir", _mesh_cache_dir_name);
 	n_processors = pt.get("multicore.processors", -1);
 	start_processor = pt.get("multicore.start_processor", 0);
+	python_workers = pt.get("multicore.python_workers", 1);
+	// Converted to an unsigned thread count
+	if(python_workers < 0)
+	{
+		BOOST_THROW_EXCEPTION(vl::invalid_settings() << vl::file_name(_ini_file_path.string())
+			<< vl::desc("multicore.python_workers can not be negative."));
+	}
+	kinematic_threads = pt.get("multicore.kinematic_threads", 1);
+	if(kinematic_threads < 0)
+	{
+		BOOST_THROW_EXCEPTION(vl::invalid_settings() << vl::file_name(_ini_file_path.string())
+			<< vl::desc("multicore.kinematic_threads can not be negative."));
+	}
 	auto_fork = pt.get("multicore.auto_fork", false);
 	debug.overlay = pt.get("debug.overlay", false);
 	debug.overlay_advanced = pt.get("debug.overlay_advanced", false);
 	show_system_console = pt.get("debug.show_system_console", false);
 	debug.axes = pt.get("debug.axes", false);
 	debug.display = pt.get("debug.display", false);
+	debug.python_profiler = pt.get("debug.python_profiler", false);
+	debug.python_frame_budget = pt.get("debug.python_frame_budget", 0.0);
+	debug.allocation_tracking = pt.get("debug.allocation_tracking", false);
 	launcher_port = pt.get("launcher.port", 9556);
 	cad_importer_enabled = pt.get("cad_importer.enabled", false);
 	cad_importer_exe = pt.get("cad_importer.exe", "batch_importer.exe");
+	collada_generate_lods = pt.get("collada.generate_lods", false);
 
 	if(pt.count("projects") > 0)
 	{
@@ -46,12 +46,22 @@ struct HYDRA_API DebugOptions
 		, overlay_advanced(false)
 		, axes(false)
 		, display(false)
+		, python_profiler(false)
+		, python_frame_budget(0)
+		, allocation_tracking(false)
 	{}
 
 	bool overlay;
 	bool overlay_advanced;
 	bool axes;
 	bool display;
+	/// Profile Python scripts and callbacks
+	bool python_profiler;
+	/// Milliseconds Python can use per frame before it's logged, zero disables
+	double python_frame_budget;
+	/// Count the heap allocations of the frame thread per subsystem,
+	/// needs a build with HYDRA_TRACK_ALLOCATIONS
+	bool allocation_tracking;
 };
 
 /// @class ProgramOptions
@@ -101,6 +111,11 @@ struct HYDRA_API ProgramOptions
 	/// if the user specified a relative path the path will be relative to exe dir.
 	std::string getLogDir(void) const;
 
+	/// @brief Get the directory where slaves cache the meshes
+	/// Relative paths are relative to exe dir same as with log dir.
+	/// Empty string if the cache is disabled.
+	std::string getMeshCacheDir(void) const;
+
 	/// Global options
 	bool verbose;
 	int log_level;
@@ -125,6 +140,10 @@ struct HYDRA_API ProgramOptions
 
 	int n_processors;
 	int start_processor;
+	/// Threads executing Python tasks submitted by scripts
+	int python_workers;
+	/// Threads solving independent kinematic chains, zero uses all hardware threads
+	int kinematic_threads;
 
 	uint16_t launcher_port;
 
@@ -161,6 +180,10 @@ struct HYDRA_API ProgramOptions
 	/// This setting is for the moment copied from env config.
 	bool oculus_rift;
 
+	/// Generate LOD levels for the meshes of Collada scenes
+	/// defaults to false
+	bool collada_generate_lods;
+
 private :
 	/// @brief Parse only ini file
 	void _parse_ini(void);
@@ -169,6 +192,8 @@ private :
 
 	std::string _log_dir_name;
 
+	std::string _mesh_cache_dir_name;
+
 	fs::path _ini_file_path;
 
 };	// class ProgramOptions
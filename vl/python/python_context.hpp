@@ -20,6 +20,9 @@
 namespace vl
 {
 
+class PythonProfiler;
+class PythonTaskQueue;
+
 struct Script
 {
 	Script(std::string const &nam, vl::TextResource const &res = vl::TextResource(), bool aut = false)
@@ -76,6 +79,10 @@ public :
 	/// Removes all objects created by the python scripts or commands.
 	virtual void reset(void) = 0;
 
+	virtual vl::PythonProfiler &getProfiler(void) = 0;
+
+	virtual vl::PythonTaskQueue &getTasks(void) = 0;
+
 };	// class PythonContex
 
 }	// namespace vl
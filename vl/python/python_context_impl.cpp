@@ -61,6 +61,8 @@ vl::PythonContextImpl::PythonContextImpl(vl::GameManagerPtr game_man)
 	, _game(game_man)
 {
 	_init();
+
+	_tasks.reset(new vl::PythonTaskQueue(_game->getOptions().python_workers));
 }
 
 vl::PythonContextImpl::~PythonContextImpl( void )
@@ -77,13 +79,24 @@ vl::PythonContextImpl::executeScript( vl::TextResource const &script )
 	if( !script.get() )
 	{ return; }
 
+	_profiler.beginZone(script.getName());
 	try
 	{
+		// Compiled with the script name so that the profiler and
+		// tracebacks can tell the scripts apart.
+		python::handle<> code(Py_CompileString(script.get(),
+			script.getName().c_str(), Py_file_input));
 		// Run a python script.
-		python::object result = python::exec(script.get(), _global, _global);
+#if PY_MAJOR_VERSION > 2
+		python::handle<> result(PyEval_EvalCode(code.get(), _global.ptr(), _global.ptr()));
+#else
+		python::handle<> result(PyEval_EvalCode((PyCodeObject *)code.get(),
+			_global.ptr(), _global.ptr()));
+#endif
 	}
 	// Some error handling so that we can continue the application
 	catch( ... ) {}
+	_profiler.endZone();
 	if( PyErr_Occurred() )
 	{
 		PyErr_Print();
@@ -93,6 +106,7 @@ vl::PythonContextImpl::executeScript( vl::TextResource const &script )
 void
 vl::PythonContextImpl::executeCommand(const std::string& cmd)
 {
+	_profiler.beginZone("Commands");
 	try
 	{
 		// Run a python script.
@@ -100,6 +114,7 @@ vl::PythonContextImpl::executeCommand(const std::string& cmd)
 	}
 	// Some error handling so that we can continue the application
 	catch( ... ) {}
+	_profiler.endZone();
 	if( PyErr_Occurred() )
 	{
 		PyErr_Print();
@@ -220,6 +235,12 @@ vl::PythonContextImpl::reset(void)
 
 	_scripts.clear();
 
+	// Releases the code objects of the old scripts
+	_profiler.clear();
+
+	// Results of the old scripts are not wanted
+	_tasks->clear();
+
 	// As of boost::python 1.51 Py_Finalize is still not working so we can't use
 	// the method that was designed for clearing the context and need to resort
 	// to hacks.
@@ -261,6 +282,10 @@ vl::PythonContextImpl::_init(void)
 
 		// Needs to be after any AppendInittab commads
 		Py_Initialize();
+#if PY_VERSION_HEX < 0x03070000
+		// Creates the GIL for the task workers
+		PyEval_InitThreads();
+#endif
 
 		// Retrieve the main module
 		python::object main = python::import("__main__");
@@ -40,6 +40,11 @@
 
 #include "typedefs.hpp"
 
+#include "python_profiler.hpp"
+#include "python_tasks.hpp"
+
+#include <boost/scoped_ptr.hpp>
+
 namespace python = boost::python;
 
 namespace vl
@@ -89,6 +94,12 @@ public :
 
 	void reset(void);
 
+	vl::PythonProfiler &getProfiler(void)
+	{ return _profiler; }
+
+	vl::PythonTaskQueue &getTasks(void)
+	{ return *_tasks; }
+
 	template<typename T>
 	void addVariableRef(std::string variable_name, T &var);
 
@@ -119,6 +130,11 @@ private :
 	python::object _main;
 
 	vl::GameManagerPtr _game;
+
+	vl::PythonProfiler _profiler;
+
+	/// Created after the interpreter
+	boost::scoped_ptr<vl::PythonTaskQueue> _tasks;
 };
 
 template<typename T>
@@ -33,6 +33,8 @@
 #include "input/pcan.hpp"
 #include "input/vrpn_analog_client.hpp"
 #include "input/razer_hydra.hpp"
+#include "input/recording.hpp"
+#include "input/recording_player.hpp"
 
 // Necessary for exposing vectors
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
@@ -42,6 +44,7 @@
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(createKeyTrigger_ov, createKeyTrigger, 1, 2)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(getKeyTrigger_ov, getKeyTrigger, 1, 2)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(hasKeyTrigger_ov, hasKeyTrigger, 1, 2)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(createJoystickTrigger_ov, createJoystickTrigger, 0, 2)
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(set_axis_constraint_ovs, set_axis_constraint, 2, 4)
 
@@ -81,17 +84,39 @@ void export_managers(void)
 		.def("createMouseTrigger", &vl::EventManager::createMouseTrigger,
 			python::return_value_policy<python::reference_existing_object>())
 		.def("createJoystickTrigger", &vl::EventManager::createJoystickTrigger,
-			python::return_value_policy<python::reference_existing_object>())
+			createJoystickTrigger_ov()[python::return_value_policy<python::reference_existing_object>()] )
 		.def("create_analog_client", &vl::EventManager::createAnalogClient)
+		.def("start_recording", &vl::EventManager::startRecording)
+		.def("stop_recording", &vl::EventManager::stopRecording)
+		.def("play_recording", &vl::EventManager::playRecording)
+		// CAN listener that works with replayed recordings without the device
+		.def("add_can_listener", toast::python::signal_connect<void (CANMsg const &)>(&vl::EventManager::addCANListener))
 
 		.add_property("frame_trigger", python::make_function(&vl::EventManager::getFrameTrigger, 
 			python::return_value_policy<python::reference_existing_object>()) )
 		.add_property("pcan", python::make_function(&vl::EventManager::getPCAN))
 		.add_property("tracker_clients", &vl::EventManager::getTrackerClients)
+		.add_property("recording", &vl::EventManager::isRecording)
+		.add_property("recording_player", &vl::EventManager::getRecordingPlayer)
 
 		.def(python::self_ns::str(python::self_ns::self))
 	;
 	
+	python::class_<vl::RecordingPlayer, RecordingPlayerRefPtr, boost::noncopyable>("RecordingPlayer", python::no_init)
+		.def("open", &vl::RecordingPlayer::open)
+		.def("close", &vl::RecordingPlayer::close)
+		.def("play", &vl::RecordingPlayer::play)
+		.def("pause", &vl::RecordingPlayer::pause)
+		.def("stop", &vl::RecordingPlayer::stop)
+		.def("seek", &vl::RecordingPlayer::seek)
+		.add_property("playing", &vl::RecordingPlayer::isPlaying)
+		.add_property("time", python::make_function(&vl::RecordingPlayer::getTime, python::return_value_policy<python::copy_const_reference>()))
+		.add_property("length", &vl::RecordingPlayer::getLength)
+		.add_property("looping", &vl::RecordingPlayer::isLooping, &vl::RecordingPlayer::setLooping)
+		.add_property("fixed_step", python::make_function(&vl::RecordingPlayer::getFixedStep, python::return_value_policy<python::copy_const_reference>()), &vl::RecordingPlayer::setFixedStep)
+		.add_property("n_injected", &vl::RecordingPlayer::getNInjected)
+	;
+
 	python::class_<vl::TrackerSensor, boost::noncopyable>("TrackerSensor", python::no_init)
 		.add_property("trigger", python::make_function(&vl::TrackerSensor::getTrigger, python::return_value_policy<python::reference_existing_object>() ), &vl::TrackerSensor::setTrigger)
 		.add_property("transform", python::make_function(&vl::TrackerSensor::getCurrentTransform, python::return_value_policy<python::copy_const_reference>() ) )
@@ -326,6 +351,8 @@ void export_triggers(void)
 
 	python::class_<vl::JoystickTrigger, boost::noncopyable, python::bases<Trigger> >("JoystickTrigger", python::no_init )
 		.def("add_listener", toast::python::signal_connect<void(vl::JoystickEvent const &, int)>(&vl::JoystickTrigger::addListener))
+		.add_property("device", &vl::JoystickTrigger::getDevice)
+		.add_property("index", &vl::JoystickTrigger::getIndex)
 		.def("addButtonPressedListener", toast::python::signal_connect<void(vl::JoystickEvent const &, int)>(&vl::JoystickTrigger::addButtonPressedListener))
 		.def("addButtonReleasedListener", toast::python::signal_connect<void(vl::JoystickEvent const &, int)>(&vl::JoystickTrigger::addButtonReleasedListener))
 		.def("addAxisListener", toast::python::signal_connect<void(vl::JoystickEvent const &, int)>(&vl::JoystickTrigger::addAxisListener))
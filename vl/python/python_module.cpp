@@ -32,6 +32,9 @@
 #include "camera.hpp"
 #include "movable_text.hpp"
 #include "ray_object.hpp"
+#include "tube_mesh.hpp"
+#include "instance_group.hpp"
+#include "transform_group.hpp"
 
 #include "material.hpp"
 #include "material_manager.hpp"
@@ -93,8 +96,85 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(setDirection_ovs, setDirection, 1, 4)
 
 BOOST_PYTHON_FUNCTION_OVERLOADS(lookAt_ovs, lookAt, 3, 5)
 
+// PythonTaskQueue overloads
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(submit_ovs, submit, 1, 3)
+
 using namespace vl;
 
+namespace
+{
+
+/// Buffer protocol for TransformGroup, the rows are exposed as
+/// a writable (n, 7) float array
+int
+transform_group_get_buffer(PyObject *obj, Py_buffer *view, int flags)
+{
+	python::extract<vl::TransformGroup &> ex(obj);
+	if(!ex.check())
+	{
+		PyErr_SetString(PyExc_BufferError, "Object is not a TransformGroup.");
+		view->obj = 0;
+		return -1;
+	}
+
+	vl::TransformGroup &group = ex();
+
+	// Shape and strides are owned by the view
+	Py_ssize_t *shape = new Py_ssize_t[4];
+	shape[0] = group.getNObjects();
+	shape[1] = vl::TransformGroup::ROW_SIZE;
+	shape[2] = vl::TransformGroup::ROW_SIZE*sizeof(float);
+	shape[3] = sizeof(float);
+
+	// Empty buffer still needs a valid pointer
+	static float empty = 0;
+
+	view->obj = obj;
+	Py_INCREF(obj);
+	view->buf = group.getData() ? group.getData() : &empty;
+	view->len = shape[0]*shape[2];
+	view->readonly = 0;
+	view->itemsize = sizeof(float);
+	view->format = (flags & PyBUF_FORMAT) ? const_cast<char *>("f") : 0;
+	// Without PyBUF_ND the consumer sees a flat buffer of len bytes
+	view->ndim = (flags & PyBUF_ND) ? 2 : 1;
+	view->shape = (flags & PyBUF_ND) ? shape : 0;
+	view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? shape+2 : 0;
+	view->suboffsets = 0;
+	view->internal = shape;
+
+	group._addExport();
+
+	return 0;
+}
+
+void
+transform_group_release_buffer(PyObject *obj, Py_buffer *view)
+{
+	delete [] (Py_ssize_t *)view->internal;
+	view->internal = 0;
+
+	python::extract<vl::TransformGroup &> ex(obj);
+	if(ex.check())
+	{ ex()._removeExport(); }
+}
+
+/// Boost.Python classes are heap types so the buffer slots can be added
+/// after the class has been created.
+void
+enable_buffer_protocol(python::object const &cls, getbufferproc get, releasebufferproc release)
+{
+	PyHeapTypeObject *type = (PyHeapTypeObject *)cls.ptr();
+	type->as_buffer.bf_getbuffer = get;
+	type->as_buffer.bf_releasebuffer = release;
+	type->ht_type.tp_as_buffer = &type->as_buffer;
+#if PY_MAJOR_VERSION < 3
+	type->ht_type.tp_flags |= Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
+}
+
+}	// unamed namespace
+
 
 void export_math(void)
 {
@@ -211,6 +291,18 @@ void export_animation(void)
 		.def(python::self_ns::str(python::self_ns::self))
 	;
 
+	/// Bulk transformations for scripts updating a lot of objects,
+	/// use with numpy.asarray(group)
+	python::object transform_group = python::class_<vl::TransformGroup, boost::noncopyable>("TransformGroup", python::init<>())
+		.def("add", &vl::TransformGroup::addObject)
+		.def("remove", &vl::TransformGroup::removeObject)
+		.def("clear", &vl::TransformGroup::clear)
+		.def("read", &vl::TransformGroup::read)
+		.def("write", &vl::TransformGroup::write)
+		.def("__len__", &vl::TransformGroup::getNObjects)
+	;
+	enable_buffer_protocol(transform_group, &transform_group_get_buffer, &transform_group_release_buffer);
+
 	/// Shared pointer needs Proxies to be turned off
 	python::class_<std::vector<boost::shared_ptr<KinematicBody> > >("KinematicBodyList")
 		.def(python::vector_indexing_suite<std::vector<boost::shared_ptr<KinematicBody> >, true>())
@@ -421,6 +513,12 @@ void export_scene_graph(void)
 		.def("createRayObject", &SceneManager::createDynamicRayObject, python::return_value_policy<python::reference_existing_object>() )
 		.def("getRayObject", &SceneManager::getRayObject, python::return_value_policy<python::reference_existing_object>() )
 		.def("hasRayObject", &SceneManager::hasRayObject)
+		.def("createTubeMesh", &SceneManager::createDynamicTubeMesh, python::return_value_policy<python::reference_existing_object>() )
+		.def("getTubeMesh", &SceneManager::getTubeMesh, python::return_value_policy<python::reference_existing_object>() )
+		.def("hasTubeMesh", &SceneManager::hasTubeMesh)
+		.add_property("auto_instancing", &SceneManager::getAutoInstancing, &SceneManager::setAutoInstancing)
+		.add_property("instancing_threshold", &SceneManager::getInstancingThreshold, &SceneManager::setInstancingThreshold)
+		.def("updateInstanceGroups", &SceneManager::updateInstanceGroups)
 		.def("show_debug_displays", &SceneManager::showDebugDisplays)
 		.def("show_bounding_boxes", &SceneManager::showBoundingBoxes)
 		.def("show_axes", &SceneManager::showAxes)
@@ -493,6 +591,7 @@ void export_scene_graph(void)
 		.add_property("cast_shadows", &vl::Entity::getCastShadows, &vl::Entity::setCastShadows )
 		.add_property("mesh_name", python::make_function( &vl::Entity::getMeshName, python::return_value_policy<python::copy_const_reference>() ) )
 		.add_property("mesh", &vl::Entity::getMesh)
+		.add_property("instance_group", python::make_function( &vl::Entity::getInstanceGroup, python::return_value_policy<python::reference_existing_object>() ) )
 		.def(python::self_ns::str(python::self_ns::self))
 	;
 
@@ -517,6 +616,18 @@ void export_scene_graph(void)
 		.def("update", &vl::RayObject::update)
 	;
 
+	python::class_<vl::TubeMesh, boost::noncopyable, python::bases<vl::MovableObject> >("TubeMesh", python::no_init)
+		.add_property("material", python::make_function( &vl::TubeMesh::getMaterial, python::return_value_policy<python::copy_const_reference>() ), &vl::TubeMesh::setMaterial)
+		.add_property("radius", &vl::TubeMesh::getRadius, &vl::TubeMesh::setRadius)
+		.add_property("sides", &vl::TubeMesh::getSides, &vl::TubeMesh::setSides)
+	;
+
+	python::class_<vl::InstanceGroup, boost::noncopyable, python::bases<vl::MovableObject> >("InstanceGroup", python::no_init)
+		.add_property("mesh_name", python::make_function( &vl::InstanceGroup::getMeshName, python::return_value_policy<python::copy_const_reference>() ) )
+		.add_property("material_name", python::make_function( &vl::InstanceGroup::getMaterialName, python::return_value_policy<python::copy_const_reference>() ) )
+		.add_property("n_instances", &vl::InstanceGroup::getNInstances)
+	;
+
 	python::enum_<TransformSpace>("TS")
 		.value("LOCAL", TS_LOCAL)
 		.value("PARENT", TS_PARENT)
@@ -553,6 +664,7 @@ void export_scene_graph(void)
 		.add_property("objects", python::make_function(&vl::SceneNode::getObjects, python::return_value_policy<python::copy_const_reference>()))
 		.add_property("show_debug_display", &SceneNode::isShowDebugDisplay, &vl::SceneNode::setShowDebugDisplay)
 		.add_property("show_axes", &SceneNode::isShowAxes, &vl::SceneNode::setShowAxes)
+		.add_property("static", &SceneNode::isStatic, &vl::SceneNode::setStatic)
 		.add_property("axes_size", &SceneNode::getAxesSize, &vl::SceneNode::setAxesSize)
 
 		.def("attachObject", &vl::SceneNode::attachObject)
@@ -626,6 +738,28 @@ void export_game(void)
 		.def(python::self_ns::str(python::self_ns::self))
 	;
 
+	python::class_<vl::PythonProfiler, boost::noncopyable>("PythonProfiler", python::no_init)
+		.add_property("enabled", &vl::PythonProfiler::isEnabled, &vl::PythonProfiler::setEnabled)
+		.add_property("frame_budget", python::make_function(&vl::PythonProfiler::getFrameBudget, python::return_value_policy<python::copy_const_reference>()), &vl::PythonProfiler::setFrameBudget)
+		.add_property("report", python::make_function(&vl::PythonProfiler::getReport, python::return_value_policy<python::reference_existing_object>()))
+	;
+
+	python::class_<vl::Report<size_t>>("CountReport", python::init<>())
+		.def(python::self_ns::str(python::self_ns::self))
+	;
+
+	python::class_<vl::AllocationTracker, boost::noncopyable>("AllocationTracker", python::no_init)
+		.add_property("enabled", &vl::AllocationTracker::isEnabled, &vl::AllocationTracker::setEnabled)
+		.add_static_property("available", &vl::AllocationTracker::isAvailable)
+		.add_property("report", python::make_function(&vl::AllocationTracker::getReport, python::return_value_policy<python::reference_existing_object>()))
+	;
+
+	python::class_<vl::PythonTaskQueue, boost::noncopyable>("PythonTaskQueue", python::no_init)
+		.def("submit", &vl::PythonTaskQueue::submit, submit_ovs())
+		.add_property("pending", &vl::PythonTaskQueue::getNPending)
+		.add_property("n_threads", &vl::PythonTaskQueue::getNThreads)
+	;
+
 	void (vl::GameObject::*setCollisionModel_ov0)(physics::CollisionShapeRefPtr shape) = &vl::GameObject::setCollisionModel;
 
 	python::class_<vl::GameObject, vl::GameObjectRefPtr, boost::noncopyable, python::bases<vl::ObjectInterface> >("GameObject", python::no_init)
@@ -670,6 +804,9 @@ void export_game(void)
 		// @todo fix these to use const versions and copying, they of course shouldn't be modified from python
 		.add_property("rendering_report", python::make_function( &vl::GameManager::getRenderingReport, python::return_value_policy<python::reference_existing_object>() ) )
 		.add_property("init_report", python::make_function( &vl::GameManager::getInitReport, python::return_value_policy<python::reference_existing_object>() ) )
+		.add_property("python_profiler", python::make_function( &vl::GameManager::getPythonProfiler, python::return_value_policy<python::reference_existing_object>() ) )
+		.add_property("python_tasks", python::make_function( &vl::GameManager::getPythonTasks, python::return_value_policy<python::reference_existing_object>() ) )
+		.add_property("allocation_tracker", python::make_function( &vl::GameManager::getAllocationTracker, python::return_value_policy<python::reference_existing_object>() ) )
 		.add_property( "physics_world", &vl::GameManager::getPhysicsWorld)
 		.def( "enablePhysics", &vl::GameManager::enablePhysics )
 		.add_property("logger", python::make_function( &vl::GameManager::getLogger, python::return_value_policy<python::reference_existing_object>() ) )
@@ -76,9 +76,21 @@ void export_physics_objects(void)
 		.staticmethod("create")
 	;
 
+	python::class_<vl::physics::ConvexDecompositionSettings>("ConvexDecompositionSettings")
+		.def_readwrite("max_concavity", &vl::physics::ConvexDecompositionSettings::max_concavity)
+		.def_readwrite("max_hulls", &vl::physics::ConvexDecompositionSettings::max_hulls)
+		.def_readwrite("max_hull_vertices", &vl::physics::ConvexDecompositionSettings::max_hull_vertices)
+		.def_readwrite("resolution", &vl::physics::ConvexDecompositionSettings::resolution)
+	;
+
+	vl::physics::ConcaveHullShapeRefPtr (*concave_create_0)(vl::MeshRefPtr) = &vl::physics::ConcaveHullShape::create;
+	vl::physics::ConcaveHullShapeRefPtr (*concave_create_1)(vl::MeshRefPtr, vl::physics::ConvexDecompositionSettings const &) = &vl::physics::ConcaveHullShape::create;
+
 	python::class_<vl::physics::ConcaveHullShape, boost::noncopyable, vl::physics::ConcaveHullShapeRefPtr, python::bases<vl::physics::CollisionShape> >("ConcaveHullShape", python::no_init )
-		.def("create", &vl::physics::ConcaveHullShape::create)
+		.def("create", concave_create_0)
+		.def("create", concave_create_1)
 		.staticmethod("create")
+		.add_property("n_hulls", &vl::physics::ConcaveHullShape::getNumHulls)
 	;
 
 	python::class_<vl::physics::CompoundShape, boost::noncopyable, vl::physics::CompoundShapeRefPtr, python::bases<vl::physics::CollisionShape> >("CompoundShape", python::no_init )
@@ -303,6 +315,8 @@ void export_physics_objects(void)
 		.def_readwrite("max_error_reduction", &vl::physics::SolverParameters::max_error_reduction)
 		.def_readwrite("internal_time_step", &vl::physics::SolverParameters::internal_time_step)
 		.def_readwrite("max_sub_steps", &vl::physics::SolverParameters::max_sub_steps)
+		.def_readwrite("threaded", &vl::physics::SolverParameters::threaded)
+		.def_readwrite("solver_threads", &vl::physics::SolverParameters::solver_threads)
 	;
 
 	python::class_<std::vector<boost::shared_ptr<vl::physics::Constraint> > >("ConstraintList")
@@ -352,6 +366,11 @@ void export_physics_objects(void)
 		.def(python::self_ns::str(python::self_ns::self))
 		;
 
+	python::enum_<vl::physics::TUBE_SOLVER>("TUBE_SOLVER")
+		.value("RIGID_BODIES", vl::physics::TS_RIGID_BODIES)
+		.value("ROD", vl::physics::TS_ROD)
+	;
+
 	python::class_<vl::physics::Tube::ConstructionInfo>("TubeConstructionInfo", python::init<>())
 		.def_readwrite("start_body", &vl::physics::Tube::ConstructionInfo::start_body)
 		.def_readwrite("end_body", &vl::physics::Tube::ConstructionInfo::end_body)
@@ -375,6 +394,8 @@ void export_physics_objects(void)
 		.def_readwrite("body_damping", &vl::physics::Tube::ConstructionInfo::body_damping)
 		.def_readwrite("bending_radius", &vl::physics::Tube::ConstructionInfo::bending_radius)
 		.def_readwrite("use_instancing", &vl::physics::Tube::ConstructionInfo::use_instancing)
+		.def_readwrite("solver", &vl::physics::Tube::ConstructionInfo::solver)
+		.def_readwrite("solver_iterations", &vl::physics::Tube::ConstructionInfo::solver_iterations)
 	;
 
 
@@ -392,6 +413,8 @@ void export_physics_objects(void)
 		.add_property("radius", &vl::physics::Tube::getRadius)
 		// @todo: correct this parameter name, might have propagating effects on python code:
 		.add_property("leght", &vl::physics::Tube::getLength)
+		.add_property("solver", &vl::physics::Tube::getSolver)
+		.add_property("stretch", &vl::physics::Tube::getStretch)
 		.def("hide", &vl::physics::Tube::hide)
 		.def("show", &vl::physics::Tube::show)
 		.def("set_equilibrium", &vl::physics::Tube::setEquilibrium)
@@ -0,0 +1,272 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file python/python_profiler.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+// Interface
+#include "python_profiler.hpp"
+
+#include <boost/python.hpp>
+#include <frameobject.h>
+
+#include "logger.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace python = boost::python;
+
+namespace
+{
+
+/// Number of zones listed when the budget is exceeded
+size_t const N_LOGGED_ZONES = 5;
+
+PyObject *
+frame_code(PyFrameObject *frame)
+{
+#if PY_VERSION_HEX >= 0x030900B1
+	// The frame keeps the code alive
+	PyCodeObject *code = PyFrame_GetCode(frame);
+	Py_DECREF(code);
+	return (PyObject *)code;
+#else
+	return (PyObject *)frame->f_code;
+#endif
+}
+
+/// Only the frame events of Python functions are used, calls to C functions
+/// are timed as part of the Python function calling them.
+int
+profile_hook(PyObject *obj, PyFrameObject *frame, int what, PyObject *)
+{
+	vl::PythonProfiler *profiler = (vl::PythonProfiler *)PyCapsule_GetPointer(obj, 0);
+	if(what == PyTrace_CALL)
+	{ profiler->_call(frame_code(frame)); }
+	else if(what == PyTrace_RETURN)
+	{ profiler->_return(); }
+
+	return 0;
+}
+
+/// @brief name of the function and where it was defined
+std::string
+code_name(PyObject *code)
+{
+	try
+	{
+		python::object c(python::handle<>(python::borrowed(code)));
+		std::stringstream ss;
+		ss << python::extract<std::string>(c.attr("co_name"))()
+			<< " (" << python::extract<std::string>(c.attr("co_filename"))()
+			<< ":" << python::extract<int>(c.attr("co_firstlineno"))() << ")";
+		return ss.str();
+	}
+	catch(python::error_already_set const &)
+	{
+		PyErr_Clear();
+		return "unknown";
+	}
+}
+
+struct ZoneTimeGreater
+{
+	ZoneTimeGreater(std::vector<vl::time> const &t) : times(t) {}
+
+	bool operator()(size_t a, size_t b) const
+	{ return times[a] > times[b]; }
+
+	std::vector<vl::time> const &times;
+};
+
+}	// unamed namespace
+
+/// ------------------------------ Public ------------------------------------
+vl::PythonProfiler::PythonProfiler(void)
+	: _enabled(false)
+	, _depth(0)
+	, _current(0)
+	, _log_timer(vl::time(1))
+	, _frames_over_budget(0)
+{}
+
+vl::PythonProfiler::~PythonProfiler(void)
+{
+	// The interpreter is never finalised so it's still safe to use
+	setEnabled(false);
+	clear();
+}
+
+void
+vl::PythonProfiler::setEnabled(bool enable)
+{
+	if(_enabled == enable)
+	{ return; }
+
+	_enabled = enable;
+	_depth = 0;
+	if(_enabled)
+	{
+		python::handle<> self(PyCapsule_New(this, 0, 0));
+		PyEval_SetProfile(&profile_hook, self.get());
+	}
+	else
+	{ PyEval_SetProfile(0, 0); }
+}
+
+void
+vl::PythonProfiler::beginZone(std::string const &name)
+{
+	if(!_enabled)
+	{ return; }
+
+	if(_depth++ == 0)
+	{ _startZone(_getZone(name)); }
+}
+
+void
+vl::PythonProfiler::endZone(void)
+{
+	if(_depth > 0 && --_depth == 0)
+	{ _stopZone(); }
+}
+
+vl::time
+vl::PythonProfiler::finishFrame(void)
+{
+	vl::time total;
+	for(size_t i = 0; i < _zones.size(); ++i)
+	{
+		Zone &zone = _zones[i];
+		zone.number->push(zone.frame_time);
+		total += zone.frame_time;
+	}
+
+	if(_budget != vl::time() && total > _budget)
+	{
+		++_frames_over_budget;
+		if(_log_timer.elapsed() > vl::time(1))
+		{
+			_logOverBudget(total);
+			_log_timer.reset();
+			_frames_over_budget = 0;
+		}
+	}
+
+	for(size_t i = 0; i < _zones.size(); ++i)
+	{
+		_zones[i].frame_time = vl::time();
+		_zones[i].calls = 0;
+	}
+
+	return total;
+}
+
+void
+vl::PythonProfiler::clear(void)
+{
+	for(std::map<void *, size_t>::iterator iter = _code_zones.begin();
+		iter != _code_zones.end(); ++iter)
+	{ Py_DECREF((PyObject *)iter->first); }
+
+	_code_zones.clear();
+	_named_zones.clear();
+	_zones.clear();
+	_report = vl::Report<vl::time>();
+	_depth = 0;
+}
+
+void
+vl::PythonProfiler::_call(void *code)
+{
+	if(_depth++ == 0)
+	{ _startZone(_getCodeZone(code)); }
+}
+
+void
+vl::PythonProfiler::_return(void)
+{
+	// Returns from the frames that were running when the hook was installed
+	if(_depth > 0 && --_depth == 0)
+	{ _stopZone(); }
+}
+
+/// ------------------------------ Private -----------------------------------
+size_t
+vl::PythonProfiler::_getZone(std::string const &name)
+{
+	std::map<std::string, size_t>::iterator iter = _named_zones.find(name);
+	if(iter != _named_zones.end())
+	{ return iter->second; }
+
+	_zones.push_back(Zone(name, &_report[name]));
+	_named_zones[name] = _zones.size()-1;
+	return _zones.size()-1;
+}
+
+size_t
+vl::PythonProfiler::_getCodeZone(void *code)
+{
+	std::map<void *, size_t>::iterator iter = _code_zones.find(code);
+	if(iter != _code_zones.end())
+	{ return iter->second; }
+
+	// Functions with the same name and position share the zone,
+	// e.g. when a script is run again
+	size_t zone = _getZone(code_name((PyObject *)code));
+	Py_INCREF((PyObject *)code);
+	_code_zones[code] = zone;
+	return zone;
+}
+
+void
+vl::PythonProfiler::_startZone(size_t zone)
+{
+	_current = zone;
+	_timer.reset();
+}
+
+void
+vl::PythonProfiler::_stopZone(void)
+{
+	// Called from the profile hook so it can't throw
+	if(_current >= _zones.size())
+	{ return; }
+
+	Zone &zone = _zones[_current];
+	zone.frame_time += _timer.elapsed();
+	++zone.calls;
+}
+
+void
+vl::PythonProfiler::_logOverBudget(vl::time const &total)
+{
+	std::vector<vl::time> times(_zones.size());
+	std::vector<size_t> order;
+	for(size_t i = 0; i < _zones.size(); ++i)
+	{
+		times[i] = _zones[i].frame_time;
+		if(_zones[i].calls > 0)
+		{ order.push_back(i); }
+	}
+	std::sort(order.begin(), order.end(), ZoneTimeGreater(times));
+
+	std::cout << vl::CRITICAL << "Python frame budget " << _budget << " exceeded, frame took "
+		<< total << ". " << _frames_over_budget << " frames over budget during the last second."
+		<< std::endl;
+	for(size_t i = 0; i < order.size() && i < N_LOGGED_ZONES; ++i)
+	{
+		Zone const &zone = _zones[order[i]];
+		std::cout << vl::CRITICAL << "\t" << zone.name << " : " << zone.frame_time
+			<< " in " << zone.calls << " calls." << std::endl;
+	}
+}
@@ -0,0 +1,143 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file python/python_profiler.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Profiler for Python code executed from the engine.
+ *
+ *	Installs the interpreter profile hook and measures every outermost
+ *	Python call, i.e. callbacks called from triggers and signals.
+ *	Nested calls are attributed to the outermost one.
+ *	Scripts and commands run by the PythonContext are named zones.
+ *
+ *	Zone times are accumulated for a frame and pushed to a Report
+ *	at the end of it, the Report is shown in the performance overlay.
+ *	If the total Python time of a frame exceeds the frame budget
+ *	the most expensive zones are logged.
+ *
+ *	The hook is only installed on the thread that enables the profiler,
+ *	worker threads are not profiled.
+ */
+
+#ifndef HYDRA_PYTHON_PROFILER_HPP
+#define HYDRA_PYTHON_PROFILER_HPP
+
+// Necessary for HYDRA_API
+#include "defines.hpp"
+
+#include "base/report.hpp"
+#include "base/chrono.hpp"
+
+#include <vector>
+#include <string>
+#include <map>
+
+namespace vl
+{
+
+class HYDRA_API PythonProfiler
+{
+public :
+	PythonProfiler(void);
+
+	~PythonProfiler(void);
+
+	/// @brief install or remove the interpreter profile hook
+	void setEnabled(bool enable);
+
+	bool isEnabled(void) const
+	{ return _enabled; }
+
+	/// @brief maximum time Python can use in a frame before it's logged
+	/// zero disables the budget
+	void setFrameBudget(vl::time const &budget)
+	{ _budget = budget; }
+
+	vl::time const &getFrameBudget(void) const
+	{ return _budget; }
+
+	/// @brief measure code executed from C++ as a named zone
+	/// Nested zones and calls are attributed to the outermost zone.
+	void beginZone(std::string const &name);
+
+	void endZone(void);
+
+	/// @brief push the zone times of the frame to the report
+	/// @return total Python time in this frame
+	vl::time finishFrame(void);
+
+	/// Average time per frame for every zone, finished by the Master
+	vl::Report<vl::time> &getReport(void)
+	{ return _report; }
+
+	/// @brief remove all zones, needs to be called before the interpreter
+	/// is reset because the profiler holds references to code objects
+	void clear(void);
+
+	/// @internal called from the profile hook
+	void _call(void *code);
+
+	void _return(void);
+
+private :
+	PythonProfiler(PythonProfiler const &);
+	PythonProfiler &operator=(PythonProfiler const &);
+
+	struct Zone
+	{
+		Zone(std::string const &n, vl::Number<vl::time> *num)
+			: name(n), number(num), frame_time(), calls(0)
+		{}
+
+		std::string name;
+		vl::Number<vl::time> *number;
+		vl::time frame_time;
+		size_t calls;
+	};
+
+	size_t _getZone(std::string const &name);
+
+	size_t _getCodeZone(void *code);
+
+	void _startZone(size_t zone);
+
+	void _stopZone(void);
+
+	void _logOverBudget(vl::time const &total);
+
+	bool _enabled;
+
+	vl::time _budget;
+
+	std::vector<Zone> _zones;
+
+	/// Code objects are referenced so the addresses are not reused
+	std::map<void *, size_t> _code_zones;
+	std::map<std::string, size_t> _named_zones;
+
+	/// Depth of the Python calls and zones, only the outermost is timed
+	size_t _depth;
+	size_t _current;
+	vl::chrono _timer;
+
+	/// Limits the budget warnings to one per second
+	vl::chrono _log_timer;
+	size_t _frames_over_budget;
+
+	vl::Report<vl::time> _report;
+
+};	// class PythonProfiler
+
+}	// namespace vl
+
+#endif	// HYDRA_PYTHON_PROFILER_HPP
@@ -0,0 +1,274 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file python/python_tasks.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+// Interface
+#include "python_tasks.hpp"
+
+// Necessary for restricting the workers
+#include "base/thread_check.hpp"
+
+#include <boost/bind.hpp>
+
+#include <algorithm>
+
+namespace python = boost::python;
+
+namespace
+{
+
+/// Workers of all the task queues, only modified from the frame thread
+std::vector<boost::thread::id> worker_ids;
+
+bool
+not_python_worker(void)
+{
+	return std::find(worker_ids.begin(), worker_ids.end(), boost::this_thread::get_id())
+		== worker_ids.end();
+}
+
+python::object
+none_if_null(PyObject *obj)
+{
+	if(!obj)
+	{ return python::object(); }
+	return python::object(python::handle<>(obj));
+}
+
+/// @brief format the current Python exception and clear it
+std::string
+format_exception(void)
+{
+	PyObject *type = 0;
+	PyObject *value = 0;
+	PyObject *tb = 0;
+	PyErr_Fetch(&type, &value, &tb);
+	PyErr_NormalizeException(&type, &value, &tb);
+
+	// Takes the references
+	python::object t = none_if_null(type);
+	python::object v = none_if_null(value);
+	python::object b = none_if_null(tb);
+	try
+	{
+		python::object lines = python::import("traceback").attr("format_exception")(t, v, b);
+		return python::extract<std::string>(python::str("").join(lines));
+	}
+	catch(python::error_already_set const &)
+	{
+		PyErr_Clear();
+		return "Python task failed, the exception couldn't be formatted.\n";
+	}
+}
+
+/// @brief call a callback on the frame thread, errors are printed
+void
+call_callback(python::object const &callback, python::object const &arg)
+{
+	PyObject *res = PyObject_CallFunctionObjArgs(callback.ptr(), arg.ptr(), NULL);
+	if(!res)
+	{ PyErr_Print(); }
+	Py_XDECREF(res);
+}
+
+}	// unamed namespace
+
+/// ------------------------------ Public ------------------------------------
+vl::PythonTaskQueue::PythonTaskQueue(size_t n_threads)
+	: _running(0)
+	, _generation(0)
+	, _quit(false)
+	, _released(0)
+{
+	if(n_threads == 0)
+	{ n_threads = 1; }
+
+	for(size_t i = 0; i < n_threads; ++i)
+	{
+		_workers.push_back(new boost::thread(boost::bind(&PythonTaskQueue::_worker_main, this)));
+		worker_ids.push_back(_workers.back()->get_id());
+	}
+
+	vl::_frameThreadCheck() = &not_python_worker;
+}
+
+vl::PythonTaskQueue::~PythonTaskQueue(void)
+{
+	acquireInterpreter();
+
+	{
+		boost::lock_guard<boost::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_cond.notify_all();
+
+	// Ids are not valid after joining
+	std::vector<boost::thread::id> ids;
+	for(size_t i = 0; i < _workers.size(); ++i)
+	{ ids.push_back(_workers[i]->get_id()); }
+
+	// Running tasks need the GIL to finish
+	Py_BEGIN_ALLOW_THREADS
+	for(size_t i = 0; i < _workers.size(); ++i)
+	{
+		_workers[i]->join();
+		delete _workers[i];
+	}
+	Py_END_ALLOW_THREADS
+
+	for(size_t i = 0; i < ids.size(); ++i)
+	{ worker_ids.erase(std::find(worker_ids.begin(), worker_ids.end(), ids[i])); }
+	if(worker_ids.empty())
+	{ vl::_frameThreadCheck() = 0; }
+
+	// Python objects are released with the GIL held
+	for(size_t i = 0; i < _queue.size(); ++i)
+	{ delete _queue[i]; }
+	for(size_t i = 0; i < _completed.size(); ++i)
+	{ delete _completed[i]; }
+}
+
+void
+vl::PythonTaskQueue::submit(python::object task, python::object on_done, python::object on_error)
+{
+	Task *t = new Task;
+	t->callable = task;
+	t->on_done = on_done;
+	t->on_error = on_error;
+	t->failed = false;
+
+	{
+		boost::lock_guard<boost::mutex> lock(_mutex);
+		t->generation = _generation;
+		_queue.push_back(t);
+	}
+	_cond.notify_one();
+}
+
+void
+vl::PythonTaskQueue::processCompleted(void)
+{
+	std::deque<Task *> completed;
+	size_t generation;
+	{
+		boost::lock_guard<boost::mutex> lock(_mutex);
+		if(_completed.empty())
+		{ return; }
+		completed.swap(_completed);
+		generation = _generation;
+	}
+
+	for(size_t i = 0; i < completed.size(); ++i)
+	{
+		Task *t = completed[i];
+		// Callbacks from before a reset are dropped
+		if(t->generation == generation)
+		{
+			if(!t->failed)
+			{
+				if(!t->on_done.is_none())
+				{ call_callback(t->on_done, t->result); }
+			}
+			else if(!t->on_error.is_none())
+			{ call_callback(t->on_error, python::str(t->error)); }
+			else
+			{ python::import("sys").attr("stderr").attr("write")(t->error); }
+		}
+		delete t;
+	}
+}
+
+void
+vl::PythonTaskQueue::clear(void)
+{
+	std::deque<Task *> dropped;
+	{
+		boost::lock_guard<boost::mutex> lock(_mutex);
+		dropped.swap(_queue);
+		++_generation;
+	}
+
+	for(size_t i = 0; i < dropped.size(); ++i)
+	{ delete dropped[i]; }
+}
+
+size_t
+vl::PythonTaskQueue::getNPending(void) const
+{
+	boost::lock_guard<boost::mutex> lock(_mutex);
+	return _queue.size() + _running;
+}
+
+void
+vl::PythonTaskQueue::releaseInterpreter(void)
+{
+	if(_released || getNPending() == 0)
+	{ return; }
+
+	_released = PyEval_SaveThread();
+}
+
+void
+vl::PythonTaskQueue::acquireInterpreter(void)
+{
+	if(!_released)
+	{ return; }
+
+	PyEval_RestoreThread(_released);
+	_released = 0;
+}
+
+/// ------------------------------ Private -----------------------------------
+void
+vl::PythonTaskQueue::_worker_main(void)
+{
+	while(true)
+	{
+		Task *t = 0;
+		{
+			boost::unique_lock<boost::mutex> lock(_mutex);
+			while(!_quit && _queue.empty())
+			{ _cond.wait(lock); }
+
+			if(_quit)
+			{ return; }
+
+			t = _queue.front();
+			_queue.pop_front();
+			++_running;
+		}
+
+		PyGILState_STATE state = PyGILState_Ensure();
+		_execute(t);
+		PyGILState_Release(state);
+
+		{
+			boost::lock_guard<boost::mutex> lock(_mutex);
+			--_running;
+			_completed.push_back(t);
+		}
+	}
+}
+
+void
+vl::PythonTaskQueue::_execute(Task *task)
+{
+	PyObject *res = PyObject_CallObject(task->callable.ptr(), NULL);
+	if(res)
+	{ task->result = python::object(python::handle<>(res)); }
+	else
+	{
+		task->failed = true;
+		task->error = format_exception();
+	}
+}
@@ -0,0 +1,132 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file python/python_tasks.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Background workers for Python tasks that are not frame critical,
+ *	e.g. parsing data files or talking to simulators over sockets.
+ *
+ *	Scripts submit a callable with optional completion and error callbacks.
+ *	Workers share the interpreter with the frame thread and hold the GIL
+ *	while executing Python. The frame thread releases the GIL only while
+ *	it renders, so tasks run in parallel with rendering and whenever they
+ *	are blocked in IO or C code that releases the GIL.
+ *
+ *	Completion callbacks are called from the frame thread in
+ *	GameManager::step. Workers are not allowed to modify the scene,
+ *	physics or events, modifying them from a worker raises an exception
+ *	(see base/thread_check.hpp). Tasks should pass their results to the
+ *	completion callback instead.
+ */
+
+#ifndef HYDRA_PYTHON_TASKS_HPP
+#define HYDRA_PYTHON_TASKS_HPP
+
+// Necessary for HYDRA_API
+#include "defines.hpp"
+
+#include <boost/python.hpp>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <vector>
+#include <deque>
+#include <string>
+
+namespace vl
+{
+
+class HYDRA_API PythonTaskQueue : boost::noncopyable
+{
+public :
+	/// @param n_threads number of worker threads, at least one is created
+	/// Needs to be constructed from the frame thread after the interpreter
+	/// has been initialised.
+	PythonTaskQueue(size_t n_threads = 1);
+
+	/// @brief waits for the running tasks to finish, queued tasks are dropped
+	~PythonTaskQueue(void);
+
+	/// @brief queue a callable to be executed by a worker
+	/// @param task callable without arguments
+	/// @param on_done called with the return value of the task, can be None
+	/// @param on_error called with the formatted exception if the task raises,
+	/// if None the exception is printed.
+	void submit(boost::python::object task,
+		boost::python::object on_done = boost::python::object(),
+		boost::python::object on_error = boost::python::object());
+
+	/// @brief call the callbacks of the finished tasks, frame thread only
+	void processCompleted(void);
+
+	/// @brief drop the queued tasks and results of the running ones
+	/// Used when the Python context is reset.
+	void clear(void);
+
+	/// @brief tasks queued or running
+	size_t getNPending(void) const;
+
+	size_t getNThreads(void) const
+	{ return _workers.size(); }
+
+	/// @brief release the GIL so the workers can run
+	/// Called by the frame thread around code that doesn't use Python.
+	/// Does nothing if there are no pending tasks.
+	void releaseInterpreter(void);
+
+	/// @brief reacquire the GIL after releaseInterpreter
+	void acquireInterpreter(void);
+
+private :
+	struct Task
+	{
+		boost::python::object callable;
+		boost::python::object on_done;
+		boost::python::object on_error;
+
+		boost::python::object result;
+		std::string error;
+		bool failed;
+
+		/// Context reset counter when submitted
+		size_t generation;
+	};
+
+	void _worker_main(void);
+
+	/// @brief run the task, the calling thread needs to hold the GIL
+	static void _execute(Task *task);
+
+	mutable boost::mutex _mutex;
+	boost::condition_variable _cond;
+
+	std::deque<Task *> _queue;
+	std::deque<Task *> _completed;
+	size_t _running;
+
+	size_t _generation;
+	bool _quit;
+
+	std::vector<boost::thread *> _workers;
+
+	/// Frame thread state while the GIL is released
+	PyThreadState *_released;
+
+};	// class PythonTaskQueue
+
+}	// namespace vl
+
+#endif	// HYDRA_PYTHON_TASKS_HPP
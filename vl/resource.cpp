@@ -81,11 +81,15 @@ size_t
 vl::ResourceStream::write(char const *mem, size_t bytes)
 {
 	assert(_resource);
-	std::clog << "vl::ResourceStream::write" << std::endl;
-	BOOST_THROW_EXCEPTION(vl::not_implemented());
-	// @todo real implementation, needs to increase the Memory buffer
-	
-	return 0;
+
+	// Resources are NULL ended, keep the terminator after the data
+	if(_index + bytes + 1 > _resource->size())
+	{ _resource->resize(_index + bytes + 1); }
+
+	::memcpy(_resource->get()+_index, mem, bytes);
+	_index += bytes;
+
+	return bytes;
 }
 
 std::string
@@ -130,9 +134,7 @@ vl::ResourceStream::left(void) const
 bool
 vl::ResourceStream::isWriteable(void) const
 {
-	std::clog << "vl::ResourceStream::isWriteable" << std::endl;
-	BOOST_THROW_EXCEPTION(vl::not_implemented());
-	/// @todo real implementation
+	// Memory resources grow as needed
 	return true;
 }
 
@@ -21,6 +21,8 @@
 #include "light.hpp"
 #include "movable_text.hpp"
 #include "ray_object.hpp"
+#include "tube_mesh.hpp"
+#include "instance_group.hpp"
 
 /// Necessary for better shadow camera
 #include <OGRE/OgreShadowCameraSetupLiSPSM.h>
@@ -164,6 +166,9 @@ vl::ShadowInfo::setDirLightExtrusionDistance(vl::scalar const dist)
 /// Master constructor
 vl::SceneManager::SceneManager(vl::Session *session, vl::MeshManagerRefPtr mesh_man)
 	: _root(0)
+	, _auto_instancing(true)
+	, _instancing_threshold(16)
+	, _instancing_dirty(false)
 	, _scene_version(0)
 	, _ambient_light(0, 0, 0, 1)
 	, _session(session)
@@ -189,6 +194,9 @@ vl::SceneManager::SceneManager(vl::Session *session, vl::MeshManagerRefPtr mesh_
 /// Renderer constructor
 vl::SceneManager::SceneManager(vl::Session *session, uint64_t id, Ogre::SceneManager *native, vl::MeshManagerRefPtr mesh_man)
 	: _root(0)
+	, _auto_instancing(true)
+	, _instancing_threshold(16)
+	, _instancing_dirty(false)
 	, _scene_version(0)
 	, _ambient_light(0, 0, 0, 1)
 	, _session(session)
@@ -383,12 +391,10 @@ vl::SceneManager::getSceneNode(const std::string& name) const
 vl::SceneNodePtr
 vl::SceneManager::getSceneNodeID(uint64_t id) const
 {
-	for( size_t i = 0; i < _scene_nodes.size(); ++i )
-	{
-		SceneNode *node = _scene_nodes.at(i);
-		if( node->getID() == id )
-		{ return node; }
-	}
+	boost::unordered_map<uint64_t, SceneNodePtr>::const_iterator iter
+		= _scene_node_ids.find(id);
+	if( iter != _scene_node_ids.end() )
+	{ return iter->second; }
 
 	return 0;
 }
@@ -400,6 +406,9 @@ vl::SceneManager::destroySceneNode(SceneNodePtr node)
 	std::clog << "vl::SceneManager::destroySceneNode : " << node->getName() << std::endl;
 	
 	// @todo we need to remove MovableObjects
+	// Remove automatic mappings
+	_mapped_nodes.remove(node);
+
 	// Remove linking
 	node->removeAllChildren();
 	SceneNodePtr parent = node->getParent();
@@ -410,6 +419,7 @@ vl::SceneManager::destroySceneNode(SceneNodePtr node)
 	}
 	assert(!node->getParent());
 
+	_scene_node_ids.erase(node->getID());
 	_session->deregisterObject(node);
 	assert(node->getID() == vl::ID_UNDEFINED);
 
@@ -430,6 +440,14 @@ vl::SceneManager::destroyMovableObject(vl::MovableObjectPtr object)
 	// because unlike SceneNode we don't have a reference from
 	// MovableObject to it's parent.
 
+	// Entities remove themselves from their groups
+	InstanceGroupList::iterator group_iter
+		= std::find(_instance_groups.begin(), _instance_groups.end(), object);
+	if(group_iter != _instance_groups.end())
+	{ _instance_groups.erase(group_iter); }
+	_notifyInstancingChanged();
+
+	_object_ids.erase(object->getID());
 	_session->deregisterObject(object);
 	assert(object->getID() == vl::ID_UNDEFINED);
 
@@ -604,6 +622,128 @@ vl::SceneManager::getRayObject(std::string const &name) const
 	return static_cast<RayObjectPtr>(getMovableObject(OBJ_RAY_OBJECT, name));
 }
 
+vl::TubeMeshPtr
+vl::SceneManager::createTubeMesh(std::string const &name, std::string const &material_name)
+{
+	vl::TubeMeshPtr obj = static_cast<TubeMeshPtr>(createMovableObject(OBJ_TUBE_MESH, name));
+	obj->setMaterial(material_name);
+
+	return obj;
+}
+
+vl::TubeMeshPtr
+vl::SceneManager::createDynamicTubeMesh(std::string const &name, std::string const &material_name)
+{
+	vl::TubeMeshPtr obj = static_cast<TubeMeshPtr>(createMovableObject(OBJ_TUBE_MESH, name, true));
+	obj->setMaterial(material_name);
+
+	return obj;
+}
+
+bool
+vl::SceneManager::hasTubeMesh(std::string const &name) const
+{
+	return hasMovableObject(OBJ_TUBE_MESH, name);
+}
+
+vl::TubeMeshPtr
+vl::SceneManager::getTubeMesh(std::string const &name) const
+{
+	return static_cast<TubeMeshPtr>(getMovableObject(OBJ_TUBE_MESH, name));
+}
+
+/// --------------------- SceneManager Instancing ----------------------------
+void
+vl::SceneManager::setAutoInstancing(bool enable)
+{
+	if(_auto_instancing == enable)
+	{ return; }
+
+	_auto_instancing = enable;
+	if(_auto_instancing)
+	{ _instancing_dirty = true; }
+	else
+	{
+		// Copy because destroying modifies the list
+		InstanceGroupList groups(_instance_groups);
+		for(size_t i = 0; i < groups.size(); ++i)
+		{ destroyMovableObject(groups.at(i)); }
+	}
+}
+
+void
+vl::SceneManager::setInstancingThreshold(uint32_t n)
+{
+	if(n < 2)
+	{ BOOST_THROW_EXCEPTION(vl::invalid_param() << vl::desc("Instancing needs at least two entities.")); }
+
+	if(_instancing_threshold != n)
+	{
+		_instancing_threshold = n;
+		_instancing_dirty = true;
+	}
+}
+
+void
+vl::SceneManager::updateInstanceGroups(void)
+{
+	typedef std::map<std::pair<std::string, std::string>, EntityList> EntityMap;
+
+	// Attached entities that share a mesh and a material
+	// Entities using Ogre instancing already are left as they are
+	EntityMap candidates;
+	for(MovableObjectList::iterator iter = _objects.begin(); iter != _objects.end(); ++iter)
+	{
+		if((*iter)->getTypeName() != "Entity")
+		{ continue; }
+
+		EntityPtr ent = static_cast<EntityPtr>(*iter);
+		SceneNodePtr parent = ent->getParent();
+		// Static geometry is already batched
+		if(ent->isInstanced() || !parent || !parent->hasObject(ent)
+			|| parent->isInStaticSubtree())
+		{ continue; }
+
+		candidates[std::make_pair(ent->getMeshName(), ent->getMaterialName())].push_back(ent);
+	}
+
+	// Update the existing groups, groups that are too small are removed
+	InstanceGroupList groups;
+	InstanceGroupList old_groups(_instance_groups);
+	for(InstanceGroupList::iterator iter = old_groups.begin(); iter != old_groups.end(); ++iter)
+	{
+		EntityMap::iterator found = candidates.find(
+			std::make_pair((*iter)->getMeshName(), (*iter)->getMaterialName()));
+		if(found == candidates.end() || found->second.size() < _instancing_threshold)
+		{
+			destroyMovableObject(*iter);
+			continue;
+		}
+
+		(*iter)->setEntities(found->second);
+		groups.push_back(*iter);
+		candidates.erase(found);
+	}
+
+	for(EntityMap::iterator iter = candidates.begin(); iter != candidates.end(); ++iter)
+	{
+		if(iter->second.size() < _instancing_threshold)
+		{ continue; }
+
+		NamedParamList params;
+		params["mesh"] = iter->first.first;
+		params["material"] = iter->first.second;
+		// Dynamic so they are never saved, they are recreated when needed
+		InstanceGroupPtr group = static_cast<InstanceGroupPtr>(createMovableObject(OBJ_INSTANCE_GROUP,
+			"instance_group/" + iter->first.first + "/" + iter->first.second, true, params));
+		group->setEntities(iter->second);
+		groups.push_back(group);
+	}
+
+	_instance_groups = groups;
+	_instancing_dirty = false;
+}
+
 /// ------------------ SceneManager MovableObject ----------------------------
 vl::MovableObjectPtr 
 vl::SceneManager::createMovableObject(std::string const &type_name, std::string const &name, vl::NamedParamList const &params)
@@ -639,6 +779,12 @@ vl::SceneManager::createMovableObject(vl::OBJ_TYPE type, std::string const &name
 	case vl::OBJ_RAY_OBJECT:
 		obj = _createRayObject(name, params, dynamic);
 		break;
+	case vl::OBJ_TUBE_MESH:
+		obj = _createTubeMesh(name, params, dynamic);
+		break;
+	case vl::OBJ_INSTANCE_GROUP:
+		obj = _createInstanceGroup(name, params, dynamic);
+		break;
 	default:
 		std::cout << vl::CRITICAL << "Object type : " << type << " not a movable object." << std::endl;
 		break;
@@ -647,6 +793,10 @@ vl::SceneManager::createMovableObject(vl::OBJ_TYPE type, std::string const &name
 	_session->registerObject(obj, type, vl::ID_UNDEFINED);
 	assert( obj->getID() != vl::ID_UNDEFINED );
 	_objects.push_back(obj);
+	_object_ids[obj->getID()] = obj;
+
+	if(type == vl::OBJ_ENTITY)
+	{ _notifyInstancingChanged(); }
 
 	return obj;
 }
@@ -675,6 +825,12 @@ vl::SceneManager::_createMovableObject(vl::OBJ_TYPE type, uint64_t id)
 	case vl::OBJ_RAY_OBJECT:
 		obj = new RayObject(this);
 		break;
+	case vl::OBJ_TUBE_MESH:
+		obj = new TubeMesh(this);
+		break;
+	case vl::OBJ_INSTANCE_GROUP:
+		obj = new InstanceGroup(this);
+		break;
 	default :
 		std::cout << vl::CRITICAL << "MovableObject type not recognised." << std::endl;
 	}
@@ -687,6 +843,7 @@ vl::SceneManager::_createMovableObject(vl::OBJ_TYPE type, uint64_t id)
 	_session->registerObject(obj, type, id);
 	assert( obj->getID() != vl::ID_UNDEFINED );
 	_objects.push_back(obj);
+	_object_ids[obj->getID()] = obj;
 
 	return obj;
 }
@@ -700,12 +857,10 @@ vl::SceneManager::_createMovableObject(std::string const &type, uint64_t id)
 vl::MovableObjectPtr 
 vl::SceneManager::getMovableObjectID(uint64_t id) const
 {
-	for( size_t i = 0; i < _objects.size(); ++i )
-	{
-		MovableObjectPtr obj = _objects.at(i);
-		if( obj->getID() == id )
-		{ return obj; }
-	}
+	boost::unordered_map<uint64_t, MovableObjectPtr>::const_iterator iter
+		= _object_ids.find(id);
+	if( iter != _object_ids.end() )
+	{ return iter->second; }
 
 	return 0;
 }
@@ -751,6 +906,10 @@ vl::SceneManager::getMovableObjectType(std::string const &type) const
 		return OBJ_MOVABLE_TEXT;
 	else if( type_name == "ray_object" )
 		return OBJ_RAY_OBJECT;
+	else if( type_name == "tube_mesh" || type_name == "tubemesh" )
+		return OBJ_TUBE_MESH;
+	else if( type_name == "instance_group" || type_name == "instancegroup" )
+		return OBJ_INSTANCE_GROUP;
 	else
 		return OBJ_INVALID;
 }
@@ -770,6 +929,11 @@ vl::SceneManager::getMovableObjectTypeName(vl::OBJ_TYPE type) const
 		return "movable_text";
 	case OBJ_RAY_OBJECT:
 		return "ray_object";
+	// Needs to match the lower case getTypeName for getMovableObject
+	case OBJ_TUBE_MESH:
+		return "tubemesh";
+	case OBJ_INSTANCE_GROUP:
+		return "instancegroup";
 	default:
 		return "";
 	}
@@ -951,7 +1115,7 @@ vl::SceneManager::mapCollisionBarriers(void)
 		{
 			if((*iter)->getName() == name)
 			{
-				_mapped_nodes[cb_iter->second] = *iter;
+				_mapped_nodes.add(cb_iter->second, *iter);
 				found = true;
 				break;
 			}
@@ -969,11 +1133,29 @@ void
 vl::SceneManager::_step(vl::time const &t)
 {
 	// Copy transformations for automatically mapped objects
-	for(std::map<SceneNode *, SceneNode *>::iterator iter = _mapped_nodes.begin();
-		iter != _mapped_nodes.end(); ++iter)
-	{
-		iter->second->setWorldTransform(iter->first->getWorldTransform());
-	}
+	_mapped_nodes.update();
+
+	if(_auto_instancing && _instancing_dirty)
+	{ updateInstanceGroups(); }
+
+	for(InstanceGroupList::iterator iter = _instance_groups.begin();
+		iter != _instance_groups.end(); ++iter)
+	{ (*iter)->_update(); }
+}
+
+void
+vl::SceneManager::_addStaticNode(vl::SceneNodePtr node)
+{
+	if(std::find(_static_nodes.begin(), _static_nodes.end(), node) == _static_nodes.end())
+	{ _static_nodes.push_back(node); }
+}
+
+void
+vl::SceneManager::_removeStaticNode(vl::SceneNodePtr node)
+{
+	SceneNodeList::iterator iter = std::find(_static_nodes.begin(), _static_nodes.end(), node);
+	if(iter != _static_nodes.end())
+	{ _static_nodes.erase(iter); }
 }
 
 void
@@ -983,6 +1165,16 @@ vl::SceneManager::_notifyFrameStart(void)
 	{
 		(*iter)->_notifyFrameStart();
 	}
+
+	// Rebuild static geometry after all the updates for this frame
+	// have been received, nodes that are not static anymore are unbaked.
+	SceneNodeList static_nodes(_static_nodes);
+	for(SceneNodeList::iterator iter = static_nodes.begin(); iter != static_nodes.end(); ++iter)
+	{
+		(*iter)->_updateStaticGeometry();
+		if(!(*iter)->isStatic())
+		{ _removeStaticNode(*iter); }
+	}
 }
 
 void
@@ -1287,6 +1479,7 @@ vl::SceneManager::_createSceneNode(std::string const &name, uint64_t id, bool dy
 	_session->registerObject( node, OBJ_SCENE_NODE, id );
 	assert( node->getID() != vl::ID_UNDEFINED );
 	_scene_nodes.push_back( node );
+	_scene_node_ids[node->getID()] = node;
 
 	return node;
 }
@@ -1346,6 +1539,31 @@ vl::SceneManager::_createRayObject(std::string const &name, vl::NamedParamList c
 	return new RayObject(name, this, dynamic);
 }
 
+vl::MovableObjectPtr
+vl::SceneManager::_createTubeMesh(std::string const &name, vl::NamedParamList const &params, bool dynamic)
+{
+	// Does not accept any params for now
+	return new TubeMesh(name, this, dynamic);
+}
+
+vl::MovableObjectPtr
+vl::SceneManager::_createInstanceGroup(std::string const &name, vl::NamedParamList const &params, bool dynamic)
+{
+	std::string mesh_name;
+	std::string material_name;
+	NamedParamList::const_iterator iter = params.find("mesh");
+	if(iter != params.end())
+	{ mesh_name = iter->second; }
+	iter = params.find("material");
+	if(iter != params.end())
+	{ material_name = iter->second; }
+
+	if(mesh_name.empty())
+	{ BOOST_THROW_EXCEPTION(vl::invalid_param() << vl::desc("Mesh name can not be empty")); }
+
+	return new InstanceGroup(name, mesh_name, material_name, this, dynamic);
+}
+
 /// --------------------------------- Global ---------------------------------
 std::ostream &
 vl::operator<<(std::ostream &os, vl::SceneManager const &scene)
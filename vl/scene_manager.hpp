@@ -23,6 +23,8 @@
 #include <OGRE/OgreQuaternion.h>
 #include <OGRE/OgreColourValue.h>
 
+#include <boost/unordered_map.hpp>
+
 #include "cluster/distributed.hpp"
 #include "cluster/session.hpp"
 
@@ -30,6 +32,9 @@
 
 #include "math/transform.hpp"
 
+// Necessary for automatic mappings
+#include "scene_node_mapping.hpp"
+
 namespace vl
 {
 
@@ -458,6 +463,48 @@ public :
 
 	RayObjectPtr getRayObject(std::string const &name) const;
 
+	/// --------- TubeMesh -----------------
+	TubeMeshPtr createTubeMesh(std::string const &name, std::string const &material_name);
+
+	TubeMeshPtr createDynamicTubeMesh(std::string const &name, std::string const &material_name);
+
+	bool hasTubeMesh(std::string const &name) const;
+
+	TubeMeshPtr getTubeMesh(std::string const &name) const;
+
+	/// --------- Instancing ---------------
+	/// @brief draw Entities that share a mesh and a material as hardware instances
+	/// Groups are updated automatically when Entities are created, destroyed,
+	/// attached or their material is changed. Enabled by default.
+	void setAutoInstancing(bool enable);
+
+	bool getAutoInstancing(void) const
+	{ return _auto_instancing; }
+
+	/// @brief minimum number of identical Entities that are grouped
+	void setInstancingThreshold(uint32_t n);
+
+	uint32_t getInstancingThreshold(void) const
+	{ return _instancing_threshold; }
+
+	/// @brief group the identical Entities now
+	/// Called from _step when auto instancing is enabled and the scene has changed.
+	void updateInstanceGroups(void);
+
+	InstanceGroupList const &getInstanceGroups(void) const
+	{ return _instance_groups; }
+
+	/// @internal
+	/// @brief Entities need to be regrouped before the next step
+	void _notifyInstancingChanged(void)
+	{ _instancing_dirty = true; }
+
+	/// @internal
+	/// @brief slave methods for static SceneNodes which are updated on frame start
+	void _addStaticNode(SceneNodePtr node);
+
+	void _removeStaticNode(SceneNodePtr node);
+
 	/// --------- MovableObject ------------
 	/// @brief Common creator for all the movable objects, extra params are passed using a param list
 	MovableObjectPtr createMovableObject(std::string const &type_name, std::string const &name, vl::NamedParamList const &params = vl::NamedParamList());
@@ -620,6 +667,8 @@ private :
 	MovableObjectPtr _createCamera(std::string const &name, vl::NamedParamList const &params, bool dynamic);
 	MovableObjectPtr _createMovableText(std::string const &name, vl::NamedParamList const &params, bool dynamic);
 	MovableObjectPtr _createRayObject(std::string const &name, vl::NamedParamList const &params, bool dynamic);
+	MovableObjectPtr _createTubeMesh(std::string const &name, vl::NamedParamList const &params, bool dynamic);
+	MovableObjectPtr _createInstanceGroup(std::string const &name, vl::NamedParamList const &params, bool dynamic);
 
 	// @todo rename to avoid confusion
 	SceneNodePtr _createSceneNode(std::string const &name, uint64_t id, bool dynamic = false);
@@ -628,7 +677,20 @@ private :
 	SceneNodeList _scene_nodes;
 	MovableObjectList _objects;
 
-	std::map<SceneNode *, SceneNode *> _mapped_nodes;
+	/// ID lookup for the updates, the lists keep the creation order
+	boost::unordered_map<uint64_t, SceneNodePtr> _scene_node_ids;
+	boost::unordered_map<uint64_t, MovableObjectPtr> _object_ids;
+
+	SceneNodeMapping _mapped_nodes;
+
+	/// Master only, groups are distributed as normal MovableObjects
+	bool _auto_instancing;
+	uint32_t _instancing_threshold;
+	bool _instancing_dirty;
+	InstanceGroupList _instance_groups;
+
+	/// Slave only, nodes that have or had static geometry
+	SceneNodeList _static_nodes;
 
 	/// Selected SceneNodes
 	/// @remarks
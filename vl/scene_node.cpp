@@ -20,6 +20,76 @@
 #include "entity.hpp"
 
 #include "math/math.hpp"
+#include "base/string_utils.hpp"
+// Temporaries used when deserializing
+#include "base/frame_arena.hpp"
+
+#include <OGRE/OgreStaticGeometry.h>
+#include <OGRE/OgreEntity.h>
+
+#include <algorithm>
+
+namespace
+{
+
+/// Size of the spatial chunks static geometry is divided to, each of them
+/// is culled separately
+vl::scalar const STATIC_REGION_SIZE = 50;
+
+/// Deserialized every frame a node changes so allocated from the frame arena
+typedef std::vector<uint64_t, vl::ArenaAllocator<uint64_t> > FrameIDList;
+typedef std::vector<vl::SceneNodePtr, vl::ArenaAllocator<vl::SceneNodePtr> > FrameNodeList;
+typedef std::vector<vl::MovableObjectPtr, vl::ArenaAllocator<vl::MovableObjectPtr> > FrameObjectList;
+
+/// @brief write the changes to a child or object list
+/// The whole list is written for the initial state or when there are
+/// at least as many changes as elements.
+template<typename T>
+void
+write_list(vl::cluster::ByteStream &msg, std::vector<T> const &list,
+	boost::unordered_map<uint64_t, bool> const &changes, bool all)
+{
+	bool full = all || changes.size() >= list.size();
+	msg << full;
+	if(full)
+	{
+		msg << list.size();
+		for(typename std::vector<T>::const_iterator iter = list.begin();
+			iter != list.end(); ++iter)
+		{ msg << (*iter)->getID(); }
+	}
+	else
+	{
+		msg << changes.size();
+		for(boost::unordered_map<uint64_t, bool>::const_iterator iter = changes.begin();
+			iter != changes.end(); ++iter)
+		{ msg << iter->first << iter->second; }
+	}
+}
+
+void
+read_ids(vl::cluster::ByteStream &msg, FrameIDList &ids)
+{
+	std::vector<uint64_t>::size_type size;
+	msg >> size;
+	ids.resize(size);
+	for(size_t i = 0; i < ids.size(); ++i)
+	{ msg >> ids[i]; }
+}
+
+/// @brief sorted copy of the IDs for searching, keeps the original order
+void
+sort_ids(FrameIDList const &ids, FrameIDList &sorted)
+{
+	sorted = ids;
+	std::sort(sorted.begin(), sorted.end());
+}
+
+bool
+has_id(FrameIDList const &sorted, uint64_t id)
+{ return std::binary_search(sorted.begin(), sorted.end(), id); }
+
+}	// unamed namespace
 
 /// ---------------------------- Global --------------------------------------
 std::ostream &
@@ -74,8 +144,12 @@ vl::SceneNode::SceneNode(std::string const &name, vl::SceneManager *creator, boo
 	, _show_debug_display(false)
 	, _show_axes(false)
 	, _axes_size(3.0)
+	, _static(false)
 	, _parent(0)
 	, _ogre_node(0)
+	, _static_geometry(0)
+	, _static_dirty(false)
+	, _static_detached(false)
 	, _debug_axes(0)
 	, _creator(creator)
 	, _is_dynamic(is_dynamic)
@@ -98,6 +172,11 @@ vl::SceneNode::SceneNode(std::string const &name, vl::SceneManager *creator, boo
 
 vl::SceneNode::~SceneNode(void)
 {
+	if(_static_geometry)
+	{ _creator->getNative()->destroyStaticGeometry(_static_geometry); }
+	if(_ogre_node)
+	{ _creator->_removeStaticNode(this); }
+
 	if(_ogre_node && _name != "Root")
 	{
 		assert(_creator->getNative());
@@ -181,6 +260,63 @@ vl::SceneNode::setVisibility(bool visible, bool cascade)
 	{ (*iter)->setVisible(_visible); }
 }
 
+void
+vl::SceneNode::setStatic(bool s)
+{
+	if(_static != s)
+	{
+		setDirty(DIRTY_STATIC);
+		_static = s;
+		// Static entities are not instanced
+		_creator->_notifyInstancingChanged();
+	}
+}
+
+bool
+vl::SceneNode::isInStaticSubtree(void) const
+{
+	for(SceneNode const *node = this; node; node = node->getParent())
+	{
+		if(node->isStatic())
+		{ return true; }
+	}
+
+	return false;
+}
+
+void
+vl::SceneNode::_notifyStaticChanged(void)
+{
+	// Only the topmost static node is baked
+	SceneNodePtr root = 0;
+	for(SceneNodePtr node = this; node; node = node->getParent())
+	{
+		if(node->isStatic())
+		{ root = node; }
+	}
+
+	if(root)
+	{ root->_static_dirty = true; }
+}
+
+void
+vl::SceneNode::_updateStaticGeometry(void)
+{
+	assert(_ogre_node);
+
+	if(!_static || (_parent && _parent->isInStaticSubtree()))
+	{
+		_unbake();
+		return;
+	}
+
+	if(_static_dirty || !_static_geometry)
+	{
+		_unbake();
+		_bake();
+	}
+}
+
 void 
 vl::SceneNode::setShowBoundingBox(bool show)
 {
@@ -274,6 +410,7 @@ vl::SceneNode::_do_clone(std::string const &append_to_name, vl::SceneNodePtr par
 	node->setTransform(_transform);
 	node->setScale(_scale);
 	node->setVisibility(_visible);
+	node->setStatic(_static);
 
 	// Not adding to selection because it would be more confusing than useful
 
@@ -291,10 +428,15 @@ vl::SceneNode::attachObject(vl::MovableObjectPtr obj)
 	else
 	{
 		setDirty(DIRY_ATTACHED);
+		_recordChange(_object_changes, obj->getID(), true);
 		_objects.push_back(obj);
+		_object_set.insert(obj);
 
 		obj->setParent(this);
 		obj->setVisible(_visible);
+
+		if(_creator)
+		{ _creator->_notifyInstancingChanged(); }
 	}
 }
 
@@ -304,20 +446,19 @@ vl::SceneNode::detachObject(vl::MovableObjectPtr obj)
 	if(!obj)
 	{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Missing object to detach.")); }
 
-	std::vector<vl::MovableObjectPtr>::iterator iter;
-	for( iter = _objects.begin(); iter != _objects.end(); ++iter )
-	{
-		if( *iter == obj )
-		{
-			setDirty(DIRY_ATTACHED);
-			_objects.erase(iter);
+	if( !_object_set.erase(obj) )
+	{ return; }
 
-			if( _ogre_node )
-			{ _ogre_node->detachObject(obj->getNative()); }
-			
-			break;
-		}
-	}
+	setDirty(DIRY_ATTACHED);
+	_recordChange(_object_changes, obj->getID(), false);
+	_objects.erase(std::find(_objects.begin(), _objects.end(), obj));
+
+	// Objects drawn by an InstanceGroup have no native
+	if( _ogre_node && obj->getNative() )
+	{ _ogre_node->detachObject(obj->getNative()); }
+
+	if(_creator)
+	{ _creator->_notifyInstancingChanged(); }
 }
 
 bool 
@@ -326,14 +467,7 @@ vl::SceneNode::hasObject(vl::MovableObjectPtr obj) const
 	if(!obj)
 	{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Missing object to search for.")); }
 
-	std::vector<vl::MovableObjectPtr>::const_iterator iter;
-	for( iter = _objects.begin(); iter != _objects.end(); ++iter )
-	{
-		if( *iter == obj )
-		{ return true; }
-	}
-
-	return false;
+	return _object_set.count(obj) > 0;
 }
 
 vl::SceneNodePtr 
@@ -358,7 +492,9 @@ vl::SceneNode::addChild(vl::SceneNodePtr child)
 	if( !hasChild(child) )
 	{
 		setDirty(DIRTY_CHILDS);
+		_recordChange(_child_changes, child->getID(), true);
 		_childs.push_back(child);
+		_child_set.insert(child);
 
 		// Copy cascading parameters
 		child->setVisibility(_visible);
@@ -402,28 +538,23 @@ vl::SceneNode::removeChild(vl::SceneNodePtr child)
 	if( child == this )
 	{ BOOST_THROW_EXCEPTION( vl::this_pointer() ); }
 
-	std::vector<vl::SceneNodePtr>::iterator iter;
-	for( iter = _childs.begin(); iter != _childs.end(); ++iter )
-	{
-		if( *iter == child )
-		{
-			// Reset the position relative to world
-			vl::Transform child_world = child->getWorldTransform();
+	if( !_child_set.erase(child) )
+	{ return; }
 
-			assert(child->getParent() == this);
-			child->_parent = 0;
+	// Reset the position relative to world
+	vl::Transform child_world = child->getWorldTransform();
 
-			setDirty(DIRTY_CHILDS);
-			_childs.erase(iter);
+	assert(child->getParent() == this);
+	child->_parent = 0;
 
-			child->setWorldTransform(child_world);
+	setDirty(DIRTY_CHILDS);
+	_recordChange(_child_changes, child->getID(), false);
+	_childs.erase(std::find(_childs.begin(), _childs.end(), child));
 
-			if( _ogre_node && child->getNative() )
-			{ _ogre_node->removeChild(child->getNative()); }
-			
-			break;
-		}
-	}
+	child->setWorldTransform(child_world);
+
+	if( _ogre_node && child->getNative() )
+	{ _ogre_node->removeChild(child->getNative()); }
 }
 
 bool 
@@ -432,22 +563,16 @@ vl::SceneNode::hasChild(vl::SceneNodePtr child) const
 	if(!child)
 	{ BOOST_THROW_EXCEPTION(vl::exception() << vl::desc("Missing Child node to search for.")); }
 
-	std::vector<vl::SceneNodePtr>::const_iterator iter;
-	for( iter = _childs.begin(); iter != _childs.end(); ++iter )
-	{
-		if( *iter == child )
-		{ return true; }
-	}
-
-	return false;
+	return _child_set.count(child) > 0;
 }
 
 void
 vl::SceneNode::removeAllChildren(void)
 {
 	// Make a copy as removeChild will modify the original list
+	// Removed from the back so the list is not shifted
 	SceneNodeList childs = _childs;
-	for(SceneNodeList::iterator iter = childs.begin(); iter != childs.end(); ++iter)
+	for(SceneNodeList::reverse_iterator iter = childs.rbegin(); iter != childs.rend(); ++iter)
 	{
 		removeChild(*iter);
 	}
@@ -479,24 +604,15 @@ vl::SceneNode::serialize( vl::cluster::ByteStream &msg, const uint64_t dirtyBits
 		msg << _visible;
 	}
 
+	// Only the changes since the last update are sent, except for the initial state
 	if( dirtyBits & DIRTY_CHILDS )
 	{
-		msg << _childs.size();
-		vl::SceneNodeList::const_iterator iter;
-		for( iter = _childs.begin(); iter != _childs.end(); ++iter )
-		{
-			msg << (*iter)->getID();
-		}
+		write_list(msg, _childs, _child_changes, dirtyBits == DIRTY_ALL);
 	}
 
 	if( dirtyBits & DIRY_ATTACHED )
 	{
-		msg << _objects.size();
-		vl::MovableObjectList::const_iterator iter;
-		for( iter = _objects.begin(); iter != _objects.end(); ++iter )
-		{
-			msg << (*iter)->getID();
-		}
+		write_list(msg, _objects, _object_changes, dirtyBits == DIRTY_ALL);
 	}
 
 	if(dirtyBits & DIRTY_PARAMS)
@@ -505,6 +621,10 @@ vl::SceneNode::serialize( vl::cluster::ByteStream &msg, const uint64_t dirtyBits
 			<< _show_axes << _axes_size;
 	}
 
+	if(dirtyBits & DIRTY_STATIC)
+	{
+		msg << _static;
+	}
 }
 
 void
@@ -542,88 +662,117 @@ vl::SceneNode::deserialize( vl::cluster::ByteStream &msg, const uint64_t dirtyBi
 		{ _ogre_node->setVisible(_visible, false); }
 	}
 
+	// The changes are applied so that receiving them more than once, e.g. both
+	// in the initial state and in the next update, does nothing.
 	if( dirtyBits & DIRTY_CHILDS )
 	{
-		std::vector<uint64_t> child_ids;
-		msg >> child_ids;
-		
-		std::vector<SceneNodePtr> removed_childs;
-
-		// Compare the old and new
-		// Save the results to temporary arrays for later processing
-		// This is because otherwise we would screw up the iterator here
-		for( std::vector<SceneNodePtr>::const_iterator iter = _childs.begin(); 
-			iter != _childs.end(); ++iter )
+		bool full;
+		msg >> full;
+		if(full)
 		{
-			std::vector<uint64_t>::iterator id_iter 
-				= std::find( child_ids.begin(), child_ids.end(), (*iter)->getID() );
-			// Old id not found, we'll remove the child
-			if( id_iter == child_ids.end() )
+			FrameIDList child_ids;
+			read_ids(msg, child_ids);
+			FrameIDList sorted_ids;
+			sort_ids(child_ids, sorted_ids);
+
+			// Save the removed to a temporary array so the iterator stays valid
+			FrameNodeList removed_childs;
+			for( std::vector<SceneNodePtr>::const_iterator iter = _childs.begin(); 
+				iter != _childs.end(); ++iter )
 			{
-				removed_childs.push_back(*iter);
+				if( !has_id(sorted_ids, (*iter)->getID()) )
+				{ removed_childs.push_back(*iter); }
 			}
-			// Old found
-			else
+
+			for( FrameNodeList::iterator iter = removed_childs.begin();
+				 iter != removed_childs.end(); ++iter )
 			{
-				// remove from the list of ids
-				child_ids.erase(id_iter);
+				removeChild(*iter);
 			}
-		}
 
-		for( std::vector<SceneNodePtr>::iterator iter = removed_childs.begin();
-			 iter != removed_childs.end(); ++iter )
-		{
-			removeChild(*iter);
+			// Added in the original order, existing childs are skipped by addChild
+			FrameIDList::iterator id_iter;
+			for( id_iter = child_ids.begin(); id_iter != child_ids.end(); ++id_iter )
+			{
+				addChild(_creator->getSceneNodeID(*id_iter));
+			}
 		}
-
-		/// Check the list and add remaining childs
-		std::vector<uint64_t>::iterator id_iter;
-		for( id_iter = child_ids.begin(); id_iter != child_ids.end(); ++id_iter )
+		else
 		{
-			addChild(_creator->getSceneNodeID(*id_iter));
+			size_t size;
+			msg >> size;
+			for(size_t i = 0; i < size; ++i)
+			{
+				uint64_t id;
+				bool added;
+				msg >> id >> added;
+				if(added)
+				{ addChild(_creator->getSceneNodeID(id)); }
+				else
+				{
+					// Child has already been destroyed
+					SceneNodePtr child = _creator->getSceneNodeID(id);
+					if(child)
+					{ removeChild(child); }
+				}
+			}
 		}
 	}
 
 	if( dirtyBits & DIRY_ATTACHED )
 	{
-		std::vector<uint64_t> obj_ids;
-		msg >> obj_ids;
-		
-		MovableObjectList removed_ents;
-
-		// Compare the old and new
-		for( MovableObjectList::iterator iter = _objects.begin(); 
-			iter != _objects.end(); ++iter )
+		bool full;
+		msg >> full;
+		if(full)
 		{
-			std::vector<uint64_t>::iterator id_iter 
-				= std::find( obj_ids.begin(), obj_ids.end(), (*iter)->getID() );
-			// Old id not found, we'll remove the child
-			if( id_iter == obj_ids.end() )
+			FrameIDList obj_ids;
+			read_ids(msg, obj_ids);
+			FrameIDList sorted_ids;
+			sort_ids(obj_ids, sorted_ids);
+
+			FrameObjectList removed_ents;
+			for( MovableObjectList::iterator iter = _objects.begin(); 
+				iter != _objects.end(); ++iter )
 			{
-				removed_ents.push_back(*iter);
+				if( !has_id(sorted_ids, (*iter)->getID()) )
+				{ removed_ents.push_back(*iter); }
 			}
-			// Old found
-			else
+
+			for( FrameObjectList::iterator iter = removed_ents.begin();
+				 iter != removed_ents.end(); ++iter )
 			{
-				// remove from the list of ids
-				obj_ids.erase(id_iter);
+				detachObject(*iter);
 			}
-		}
 
-		for( MovableObjectList::iterator iter = removed_ents.begin();
-			 iter != removed_ents.end(); ++iter )
-		{
-			detachObject(*iter);
+			FrameIDList::iterator id_iter;
+			for( id_iter = obj_ids.begin(); id_iter != obj_ids.end(); ++id_iter )
+			{
+				attachObject(_creator->getMovableObjectID(*id_iter));
+			}
 		}
-
-		/// Check the list and add remaining childs
-		std::vector<uint64_t>::iterator id_iter;
-		for( id_iter = obj_ids.begin(); id_iter != obj_ids.end(); ++id_iter )
+		else
 		{
-			attachObject(_creator->getMovableObjectID(*id_iter));
+			size_t size;
+			msg >> size;
+			for(size_t i = 0; i < size; ++i)
+			{
+				uint64_t id;
+				bool added;
+				msg >> id >> added;
+				if(added)
+				{ attachObject(_creator->getMovableObjectID(id)); }
+				else
+				{
+					MovableObjectPtr obj = _creator->getMovableObjectID(id);
+					if(obj)
+					{ detachObject(obj); }
+				}
+			}
 		}
 	}
 
+	// Changes made by applying the update are not sent anywhere
+	dirtiesCleared();
 
 	if(dirtyBits & DIRTY_PARAMS)
 	{
@@ -652,4 +801,139 @@ vl::SceneNode::deserialize( vl::cluster::ByteStream &msg, const uint64_t dirtyBi
 			{ _debug_axes->setVisible(false); }
 		}
 	}
+
+	if(dirtyBits & DIRTY_STATIC)
+	{
+		msg >> _static;
+		// Baked on the next frame when the subtree has been received
+		_static_dirty = true;
+		_creator->_addStaticNode(this);
+	}
+
+	// Any change in a static subtree needs the geometry to be rebuild
+	_notifyStaticChanged();
+}
+
+/// ------------------------- Private ----------------------------------------
+void
+vl::SceneNode::dirtiesCleared(void)
+{
+	_child_changes.clear();
+	_object_changes.clear();
+}
+
+void
+vl::SceneNode::_recordChange(ListChanges &changes, uint64_t id, bool added)
+{
+	if(_creator->getNative())
+	{ return; }
+
+	changes[id] = added;
+}
+
+void
+vl::SceneNode::_bake(void)
+{
+	assert(_ogre_node && !_static_geometry);
+
+	Ogre::SceneManager *og_sm = _creator->getNative();
+	_static_geometry = og_sm->createStaticGeometry("static_geometry/" + vl::to_string(getID()));
+	_static_geometry->setRegionDimensions(Ogre::Vector3(STATIC_REGION_SIZE));
+	// Same as MovableObject, only the lights are in the second pass
+	_static_geometry->setVisibilityFlags(1);
+
+	// Derived transformations are used because they include the scale
+	_ogre_node->_update(true, false);
+
+	std::vector<Ogre::Entity *> baked;
+	bool only_entities = true;
+	bool cast_shadows = false;
+	SceneNodeList stack(1, this);
+	while(!stack.empty())
+	{
+		SceneNodePtr node = stack.back();
+		stack.pop_back();
+		stack.insert(stack.end(), node->getChilds().begin(), node->getChilds().end());
+
+		Ogre::SceneNode *og_node = node->getNative();
+		for(MovableObjectList::const_iterator iter = node->getObjects().begin();
+			iter != node->getObjects().end(); ++iter)
+		{
+			MovableObjectPtr obj = *iter;
+			// Objects that are not created yet rebake the subtree when they are
+			if(!obj->getNative())
+			{ continue; }
+
+			// Lights, cameras and Ogre instanced entities stay in the scene graph
+			if(obj->getTypeName() != "Entity" || static_cast<EntityPtr>(obj)->isInstanced())
+			{
+				only_entities = false;
+				continue;
+			}
+
+			if(!node->isVisible() || !obj->getVisible())
+			{ continue; }
+
+			Ogre::Entity *ent = static_cast<Ogre::Entity *>(obj->getNative());
+			_static_geometry->addEntity(ent, og_node->_getDerivedPosition(),
+				og_node->_getDerivedOrientation(), og_node->_getDerivedScale());
+			cast_shadows = cast_shadows || ent->getCastShadows();
+			baked.push_back(ent);
+		}
+	}
+
+	_static_geometry->setCastShadows(cast_shadows);
+	_static_geometry->build();
+
+	// Removing the whole subtree from the scene graph avoids culling the
+	// nodes separately, but other objects need to be kept in it.
+	if(only_entities)
+	{
+		if(_ogre_node->getParent())
+		{ _ogre_node->getParent()->removeChild(_ogre_node); }
+		_static_detached = true;
+	}
+	else
+	{
+		for(size_t i = 0; i < baked.size(); ++i)
+		{ baked.at(i)->setVisible(false); }
+	}
+
+	_static_dirty = false;
+}
+
+void
+vl::SceneNode::_unbake(void)
+{
+	if(!_static_geometry)
+	{ return; }
+
+	Ogre::SceneManager *og_sm = _creator->getNative();
+	og_sm->destroyStaticGeometry(_static_geometry);
+	_static_geometry = 0;
+
+	if(_static_detached)
+	{
+		Ogre::SceneNode *parent = _parent ? _parent->getNative() : og_sm->getRootSceneNode();
+		if(!_ogre_node->getParent())
+		{ parent->addChild(_ogre_node); }
+		_static_detached = false;
+	}
+	else
+	{
+		SceneNodeList stack(1, this);
+		while(!stack.empty())
+		{
+			SceneNodePtr node = stack.back();
+			stack.pop_back();
+			stack.insert(stack.end(), node->getChilds().begin(), node->getChilds().end());
+
+			for(MovableObjectList::const_iterator iter = node->getObjects().begin();
+				iter != node->getObjects().end(); ++iter)
+			{
+				if((*iter)->getTypeName() == "Entity" && (*iter)->getNative())
+				{ (*iter)->getNative()->setVisible((*iter)->getVisible()); }
+			}
+		}
+	}
 }
@@ -22,6 +22,8 @@
 #include <OGRE/OgreSceneNode.h>
 #include <OGRE/OgreSceneManager.h>
 
+#include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "base/exceptions.hpp"
 #include "typedefs.hpp"
@@ -137,6 +139,19 @@ public :
 	/// @brief set if the node inherits scale from it's parent
 	void setInheritScale(bool b);
 
+	/// @brief mark the subtree as static
+	/// Renderers bake the entities of a static subtree into merged spatially
+	/// chunked batches and remove the originals from the scene graph.
+	/// Editing anything in the subtree rebakes it on the next frame, so unset
+	/// static while editing to avoid rebuilding the batches every frame.
+	void setStatic(bool s);
+
+	bool isStatic(void) const
+	{ return _static; }
+
+	/// @brief true if this or any of it's ancestors is static
+	bool isInStaticSubtree(void) const;
+
 	/// @brief make a deep copy of the SceneNode
 	/// Shallow copies would not make much sense with SceneGraphs because you
 	/// can not have multiple parents unlike DAGs.
@@ -184,6 +199,15 @@ public :
 	virtual int addListener(TransformedCB::slot_type const &slot)
 	{ _transformed_cb.connect(slot); return 1; }
 
+	/// @internal
+	/// @brief renderer method for notifying that the subtree has changed
+	/// Static geometry containing this node is rebuild on the next frame.
+	void _notifyStaticChanged(void);
+
+	/// @internal
+	/// @brief renderer method for baking or unbaking the static geometry
+	void _updateStaticGeometry(void);
+
 	enum DirtyBits
 	{
 		DIRTY_NAME = vl::Distributed::DIRTY_CUSTOM << 0,
@@ -193,7 +217,8 @@ public :
 		DIRTY_CHILDS = vl::Distributed::DIRTY_CUSTOM << 5,
 		DIRY_ATTACHED = vl::Distributed::DIRTY_CUSTOM << 6,
 		DIRTY_PARAMS = vl::Distributed::DIRTY_CUSTOM << 7,
-		DIRTY_CUSTOM = vl::Distributed::DIRTY_CUSTOM << 8,
+		DIRTY_STATIC = vl::Distributed::DIRTY_CUSTOM << 8,
+		DIRTY_CUSTOM = vl::Distributed::DIRTY_CUSTOM << 9,
 	};
 
 	Ogre::SceneNode *getNative(void) const
@@ -209,10 +234,24 @@ protected :
 	vl::SceneNodePtr _do_clone(std::string const &append_to_name, vl::SceneNodePtr parent, bool dynamic) const;
 
 private :
+	typedef boost::unordered_map<uint64_t, bool> ListChanges;
+
 	// Disallow copying use clone instead
 	SceneNode(SceneNode const &);
 	SceneNode & operator=(SceneNode const &);
 
+	void _bake(void);
+
+	void _unbake(void);
+
+	virtual void dirtiesCleared(void);
+
+	/// @brief record a change to a list for the next update
+	/// Nothing is recorded on renderers, they never send updates and
+	/// applying an update also changes nodes that are not in it
+	/// (the old parent of a moved child).
+	void _recordChange(ListChanges &changes, uint64_t id, bool added);
+
 	std::string _name;
 
 	vl::Transform _transform;
@@ -228,16 +267,35 @@ private :
 	bool _show_axes;
 	vl::scalar _axes_size;
 
+	bool _static;
+
 	/// Keep track of the parent, so we can inform it when hierarchy is changed
 	vl::SceneNodePtr _parent;
 
 	std::vector<vl::SceneNodePtr> _childs;
 	std::vector<vl::MovableObjectPtr> _objects;
 
+	/// Hashed membership of the lists, the vectors keep the order
+	boost::unordered_set<vl::SceneNodePtr> _child_set;
+	boost::unordered_set<vl::MovableObjectPtr> _object_set;
+
+	/// Changes to the lists since the last update, ID and was it added.
+	/// Only the last change of an ID is kept so the slaves can apply
+	/// them in any order.
+	ListChanges _child_changes;
+	ListChanges _object_changes;
+
 	// Callbacks
 	TransformedCB _transformed_cb;
 
 	Ogre::SceneNode *_ogre_node;
+
+	/// Renderer only, valid when this is the topmost static node
+	Ogre::StaticGeometry *_static_geometry;
+	bool _static_dirty;
+	/// Originals were detached from the scene graph instead of hidden
+	bool _static_detached;
+
 	vl::ogre::Axes *_debug_axes;
 
 	vl::SceneManager *_creator;
@@ -0,0 +1,155 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file scene_node_mapping.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/// Interface
+#include "scene_node_mapping.hpp"
+
+#include "scene_node.hpp"
+
+#include "base/exceptions.hpp"
+
+vl::SceneNodeMapping::SceneNodeMapping(void)
+	: _dirty(false)
+{}
+
+void
+vl::SceneNodeMapping::add(vl::SceneNodePtr source, vl::SceneNodePtr target)
+{
+	if(!source || !target)
+	{ BOOST_THROW_EXCEPTION(vl::null_pointer()); }
+
+	if(source == target)
+	{ BOOST_THROW_EXCEPTION(vl::invalid_param() << vl::desc("Can't map a SceneNode to itself.")); }
+
+	_mappings[source] = target;
+	_dirty = true;
+}
+
+void
+vl::SceneNodeMapping::remove(vl::SceneNodePtr node)
+{
+	std::map<SceneNodePtr, SceneNodePtr>::iterator iter = _mappings.begin();
+	while(iter != _mappings.end())
+	{
+		if(iter->first == node || iter->second == node)
+		{ _mappings.erase(iter++); }
+		else
+		{ ++iter; }
+	}
+
+	// The node might be an ancestor of a mapped node so we always need
+	// to rebuild, otherwise we would keep a dangling pointer.
+	_dirty = true;
+}
+
+void
+vl::SceneNodeMapping::clear(void)
+{
+	_mappings.clear();
+	_nodes.clear();
+	_world.clear();
+	_dirty = false;
+}
+
+void
+vl::SceneNodeMapping::update(void)
+{
+	if(_mappings.empty())
+	{ return; }
+
+	if(_dirty || !_is_valid())
+	{ _build(); }
+
+	for(size_t i = 0; i < _nodes.size(); ++i)
+	{
+		CompiledNode const &n = _nodes[i];
+
+		vl::Transform world;
+		if(n.parent < 0)
+		{ world = n.node->getTransform(); }
+		else
+		{ world = _world[n.parent]*n.node->getTransform(); }
+
+		if(n.source >= 0)
+		{
+			// Source is normally before the target in the array, in which case
+			// it's world transformation is already calculated for this update.
+			// If the target was collected earlier as an ancestor of other
+			// mapped nodes we need to walk the parent chain.
+			if(size_t(n.source) < i)
+			{ world = _world[n.source]; }
+			else
+			{ world = _nodes[n.source].node->getWorldTransform(); }
+
+			if(n.parent < 0)
+			{ n.node->setTransform(world); }
+			else
+			{ n.node->setTransform(_world[n.parent].inverted()*world); }
+		}
+
+		_world[i] = world;
+	}
+}
+
+void
+vl::SceneNodeMapping::_build(void)
+{
+	_nodes.clear();
+
+	std::map<SceneNodePtr, int32_t> indices;
+	for(std::map<SceneNodePtr, SceneNodePtr>::iterator iter = _mappings.begin();
+		iter != _mappings.end(); ++iter)
+	{
+		// Source first so it's usually before the target
+		int32_t source = _collect(iter->first, indices);
+		int32_t target = _collect(iter->second, indices);
+		_nodes.at(target).source = source;
+	}
+
+	_world.resize(_nodes.size());
+	_dirty = false;
+}
+
+int32_t
+vl::SceneNodeMapping::_collect(vl::SceneNodePtr node, std::map<SceneNodePtr, int32_t> &indices)
+{
+	std::map<SceneNodePtr, int32_t>::iterator iter = indices.find(node);
+	if(iter != indices.end())
+	{ return iter->second; }
+
+	// Parents need to be in the array before the children
+	int32_t parent = -1;
+	if(node->getParent())
+	{ parent = _collect(node->getParent(), indices); }
+
+	int32_t index = int32_t(_nodes.size());
+	_nodes.push_back(CompiledNode(node, parent));
+	indices[node] = index;
+
+	return index;
+}
+
+bool
+vl::SceneNodeMapping::_is_valid(void) const
+{
+	for(size_t i = 0; i < _nodes.size(); ++i)
+	{
+		CompiledNode const &n = _nodes[i];
+		SceneNodePtr parent = n.parent < 0 ? 0 : _nodes[n.parent].node;
+		if(n.node->getParent() != parent)
+		{ return false; }
+	}
+
+	return true;
+}
@@ -0,0 +1,110 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file scene_node_mapping.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Automatic SceneNode to SceneNode transformation mappings.
+ *
+ *	Used for copying the world transformation of collision barriers to
+ *	the visual models every frame.
+ *
+ *	Mappings are compiled to a flat array that contains every mapped node
+ *	and all their ancestors in topological order (parents before children)
+ *	with precomputed parent indices. Updating all the mappings is a single
+ *	linear pass over the array that computes the world transformations
+ *	and writes the local transformations of the targets, instead of walking
+ *	the parent chains twice per mapping.
+ *
+ *	The array is rebuild when mappings are added or removed and when the
+ *	hierarchy of any node in the array has changed, which is checked on
+ *	every update.
+ */
+
+#ifndef HYDRA_SCENE_NODE_MAPPING_HPP
+#define HYDRA_SCENE_NODE_MAPPING_HPP
+
+#include "typedefs.hpp"
+
+#include "math/transform.hpp"
+
+#include <map>
+#include <vector>
+
+namespace vl
+{
+
+class HYDRA_API SceneNodeMapping
+{
+public :
+	SceneNodeMapping(void);
+
+	/// @brief map target to follow source in world space
+	/// A source can only have one target, previous mapping is replaced.
+	void add(SceneNodePtr source, SceneNodePtr target);
+
+	/// @brief remove all mappings where the node is either source or target
+	/// Needs to be called before the node is destroyed.
+	void remove(SceneNodePtr node);
+
+	void clear(void);
+
+	size_t size(void) const
+	{ return _mappings.size(); }
+
+	bool empty(void) const
+	{ return _mappings.empty(); }
+
+	/// @brief copy world transformations from sources to targets
+	void update(void);
+
+	/// @brief number of nodes in the compiled array, mapped nodes and their ancestors
+	size_t getNCompiledNodes(void) const
+	{ return _nodes.size(); }
+
+private :
+	/// @brief compile the mappings into the flat array
+	void _build(void);
+
+	/// @brief add node and all of it's ancestors to the flat array
+	/// @return index of the node
+	int32_t _collect(SceneNodePtr node, std::map<SceneNodePtr, int32_t> &indices);
+
+	/// @brief check that the hierarchy has not changed since the last build
+	bool _is_valid(void) const;
+
+	struct CompiledNode
+	{
+		CompiledNode(SceneNodePtr n, int32_t p)
+			: node(n), parent(p), source(-1)
+		{}
+
+		SceneNodePtr node;
+		/// index of the parent in the array, -1 if the node has no parent
+		int32_t parent;
+		/// index of the mapping source, -1 if the node is not a target
+		int32_t source;
+	};
+
+	/// source, target pairs
+	std::map<SceneNodePtr, SceneNodePtr> _mappings;
+
+	std::vector<CompiledNode> _nodes;
+	std::vector<vl::Transform> _world;
+
+	bool _dirty;
+
+};	// class SceneNodeMapping
+
+}	// namespace vl
+
+#endif	// HYDRA_SCENE_NODE_MAPPING_HPP
@@ -37,6 +37,7 @@ const uint16_t OTHER_ENDIAN_HEADER_STREAM_ID = 0x0010;
 //---------------------------------------------------------------------
 vl::Serializer::Serializer()
 	: mStream(0)
+	, mFlipEndian(false)
 {}
 
 //---------------------------------------------------------------------
@@ -127,6 +128,25 @@ vl::Serializer::writeChunkHeader(uint16_t id, size_t size)
     writeInts(&uint32size, 1);
 }
 //---------------------------------------------------------------------
+size_t
+vl::Serializer::beginChunk(uint16_t id)
+{
+	size_t pos = mStream->tell();
+	writeChunkHeader(id, 0);
+	return pos;
+}
+//---------------------------------------------------------------------
+void
+vl::Serializer::endChunk(size_t chunk_pos)
+{
+	// Size includes the header
+	size_t end = mStream->tell();
+	mStream->seek(chunk_pos + sizeof(uint16_t));
+	uint32_t size = static_cast<uint32_t>(end - chunk_pos);
+	writeInts(&size, 1);
+	mStream->seek(end);
+}
+//---------------------------------------------------------------------
 void 
 vl::Serializer::writeFloats(const float* const pFloat, size_t count)
 {
@@ -256,6 +276,7 @@ vl::Serializer::readFileHeader(vl::ResourceStream &stream)
     {
 		// Read version
 		std::string ver = readString(stream);
+		mFileVersion = ver;
 		/// @todo add checking that we support the version
 		/// for now does not matter as the basic stuff is identical in all the
 		/// versions
@@ -69,12 +69,20 @@ protected:
     uint32_t mCurrentstreamLen;
     vl::ResourceStream *mStream;
     std::string mVersion;
+	/// Version of the stream read by readFileHeader
+	std::string mFileVersion;
 	bool mFlipEndian; // default to native endian, derive from header
 
 	// Internal methods
 	virtual void writeFileHeader(void);
 	virtual void writeChunkHeader(uint16_t id, size_t size);
 
+	/// @brief write a chunk header with the size filled in by endChunk
+	/// For chunks whose size isn't known before writing them.
+	/// @return position of the chunk for endChunk
+	size_t beginChunk(uint16_t id);
+	void endChunk(size_t chunk_pos);
+
 	void writeFloats(const float * const pfloat, size_t count);
 	void writeFloats(const double * const pfloat, size_t count);
 	void writeShorts(const uint16_t * const pShort, size_t count);
@@ -20,6 +20,8 @@
 
 #include "base/exceptions.hpp"
 
+#include "base/frame_arena.hpp"
+
 // Necessary for creating Renderer for slave and master
 #include "renderer.hpp"
 
@@ -78,6 +80,9 @@ vl::Slave::_mainloop(bool sleep)
 	// run main loop
 	_slave_client->mainloop();
 
+	// Temporaries of the updates applied are no longer used
+	vl::FrameArena::frame().reset();
+
 	/// @todo test
 	/// Windows can have problems with context switching.
 	/// At least this is the case for Windows XP.
@@ -110,5 +115,5 @@ vl::Slave::_do_init(ProgramOptions const &opt)
 
 	std::string hostname = opt.server_hostname;
 	uint16_t port = opt.server_port;
-	_slave_client.reset(new vl::cluster::Client(hostname.c_str(), port, _renderer));
+	_slave_client.reset(new vl::cluster::Client(hostname.c_str(), port, _renderer, opt.getMeshCacheDir()));
 }
@@ -0,0 +1,186 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file transform_group.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+// Interface
+#include "transform_group.hpp"
+
+#include "object_interface.hpp"
+
+#include "base/exceptions.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+void
+write_row(float *row, vl::Transform const &t)
+{
+	row[0] = t.position.x;
+	row[1] = t.position.y;
+	row[2] = t.position.z;
+	row[3] = t.quaternion.w;
+	row[4] = t.quaternion.x;
+	row[5] = t.quaternion.y;
+	row[6] = t.quaternion.z;
+}
+
+vl::Transform
+read_row(float const *row)
+{
+	return vl::Transform(Ogre::Vector3(row[0], row[1], row[2]),
+		Ogre::Quaternion(row[3], row[4], row[5], row[6]));
+}
+
+}	// unamed namespace
+
+/// ------------------------------ Public ------------------------------------
+vl::TransformGroup::TransformGroup(void)
+	: _n_exports(0)
+{}
+
+vl::TransformGroup::~TransformGroup(void)
+{
+	for(size_t i = 0; i < _objects.size(); ++i)
+	{
+		if(_objects[i])
+		{ _objects[i]->_removeTransformGroup(this); }
+	}
+}
+
+void
+vl::TransformGroup::addObject(vl::ObjectInterfacePtr obj)
+{
+	if(!obj)
+	{ BOOST_THROW_EXCEPTION(vl::null_pointer()); }
+
+	_checkNotExported();
+	_eraseDestroyed();
+
+	obj->_addTransformGroup(this);
+	_objects.push_back(obj);
+	_data.resize(_objects.size()*ROW_SIZE);
+	_written.resize(_objects.size()*ROW_SIZE);
+
+	float *row = &_data[(_objects.size()-1)*ROW_SIZE];
+	write_row(row, obj->getTransform());
+	std::copy(row, row+ROW_SIZE, &_written[(_objects.size()-1)*ROW_SIZE]);
+}
+
+void
+vl::TransformGroup::removeObject(vl::ObjectInterfacePtr obj)
+{
+	std::vector<vl::ObjectInterfacePtr>::iterator iter
+		= std::find(_objects.begin(), _objects.end(), obj);
+	if(!obj || iter == _objects.end())
+	{ return; }
+
+	_checkNotExported();
+
+	obj->_removeTransformGroup(this);
+	_eraseRow(iter - _objects.begin());
+	_eraseDestroyed();
+}
+
+void
+vl::TransformGroup::clear(void)
+{
+	_checkNotExported();
+
+	for(size_t i = 0; i < _objects.size(); ++i)
+	{
+		if(_objects[i])
+		{ _objects[i]->_removeTransformGroup(this); }
+	}
+	_objects.clear();
+	_data.clear();
+	_written.clear();
+}
+
+void
+vl::TransformGroup::read(void)
+{
+	for(size_t i = 0; i < _objects.size(); ++i)
+	{
+		if(_objects[i])
+		{ write_row(&_data[i*ROW_SIZE], _objects[i]->getTransform()); }
+	}
+
+	_written = _data;
+}
+
+void
+vl::TransformGroup::write(void)
+{
+	for(size_t i = 0; i < _objects.size(); ++i)
+	{
+		if(!_objects[i])
+		{ continue; }
+
+		float const *row = &_data[i*ROW_SIZE];
+		float *written = &_written[i*ROW_SIZE];
+		// Setting the transformation marks the object dirty for distribution
+		if(std::memcmp(row, written, ROW_SIZE*sizeof(float)) != 0)
+		{
+			_objects[i]->setTransform(read_row(row));
+			std::copy(row, row+ROW_SIZE, written);
+		}
+	}
+}
+
+void
+vl::TransformGroup::_objectDestroyed(vl::ObjectInterfacePtr obj)
+{
+	for(size_t i = _objects.size(); i > 0; --i)
+	{
+		if(_objects[i-1] != obj)
+		{ continue; }
+
+		// Views keep pointing to the rows, so only the object is cleared
+		if(_n_exports > 0)
+		{ _objects[i-1] = 0; }
+		else
+		{ _eraseRow(i-1); }
+	}
+}
+
+/// ------------------------------ Private -----------------------------------
+void
+vl::TransformGroup::_checkNotExported(void) const
+{
+	if(_n_exports > 0)
+	{
+		BOOST_THROW_EXCEPTION(vl::exception()
+			<< vl::desc("TransformGroup can't be resized while its buffer is in use."));
+	}
+}
+
+void
+vl::TransformGroup::_eraseRow(size_t i)
+{
+	_objects.erase(_objects.begin() + i);
+	_data.erase(_data.begin() + i*ROW_SIZE, _data.begin() + (i+1)*ROW_SIZE);
+	_written.erase(_written.begin() + i*ROW_SIZE, _written.begin() + (i+1)*ROW_SIZE);
+}
+
+void
+vl::TransformGroup::_eraseDestroyed(void)
+{
+	for(size_t i = _objects.size(); i > 0; --i)
+	{
+		if(!_objects[i-1])
+		{ _eraseRow(i-1); }
+	}
+}
@@ -0,0 +1,115 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file transform_group.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Group of SceneNodes and KinematicBodies whose local transformations
+ *	are copied to and from a contiguous float array.
+ *
+ *	Every object is a row of seven floats, position followed by
+ *	the quaternion [x y z qw qx qy qz]. Python sees the group as
+ *	a writable (n, 7) buffer so scripts can update all the objects with
+ *	numpy and two calls per frame instead of one call per object.
+ *
+ *	Objects are not owned by the group, destroyed objects remove
+ *	themselves from their groups. If the buffer is in use the row is kept
+ *	but not read or written till the group is resized.
+ */
+
+#ifndef HYDRA_TRANSFORM_GROUP_HPP
+#define HYDRA_TRANSFORM_GROUP_HPP
+
+#include "typedefs.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <vector>
+
+namespace vl
+{
+
+class TransformGroup : boost::noncopyable
+{
+public :
+	/// Floats per object
+	static size_t const ROW_SIZE = 7;
+
+	TransformGroup(void);
+
+	~TransformGroup(void);
+
+	/// @brief add an object at the end of the group
+	/// @throw if the buffer is exported
+	void addObject(vl::ObjectInterfacePtr obj);
+
+	/// @brief remove an object, rows after it are moved up
+	/// @throw if the buffer is exported
+	void removeObject(vl::ObjectInterfacePtr obj);
+
+	/// @throw if the buffer is exported
+	void clear(void);
+
+	size_t getNObjects(void) const
+	{ return _objects.size(); }
+
+	/// @return the object of a row, zero if the object has been destroyed
+	vl::ObjectInterfacePtr getObject(size_t i) const
+	{ return _objects.at(i); }
+
+	/// @brief copy the transformations of the objects to the buffer
+	void read(void);
+
+	/// @brief set the transformations of the objects from the buffer
+	/// Only rows that have changed since the last read or write are set.
+	void write(void);
+
+	float *getData(void)
+	{ return _data.empty() ? 0 : &_data[0]; }
+
+	float const *getData(void) const
+	{ return _data.empty() ? 0 : &_data[0]; }
+
+	/// @internal buffer protocol export counting, the buffer can't be
+	/// resized while there are views to it
+	void _addExport(void)
+	{ ++_n_exports; }
+
+	void _removeExport(void)
+	{ --_n_exports; }
+
+	/// @internal
+	/// @brief called from the object's destructor, doesn't throw
+	void _objectDestroyed(vl::ObjectInterfacePtr obj);
+
+private :
+	void _checkNotExported(void) const;
+
+	void _eraseRow(size_t i);
+
+	/// @brief erase the rows kept for destroyed objects
+	void _eraseDestroyed(void);
+
+	std::vector<vl::ObjectInterfacePtr> _objects;
+
+	std::vector<float> _data;
+
+	/// Values from the last read or write for finding the changed rows
+	std::vector<float> _written;
+
+	size_t _n_exports;
+
+};	// class TransformGroup
+
+}	// namespace vl
+
+#endif	// HYDRA_TRANSFORM_GROUP_HPP
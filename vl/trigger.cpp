@@ -239,17 +239,14 @@ vl::MouseTrigger::addButtonReleasedListener(vl::MouseTrigger::Tripped_button::sl
 /// Time triggers
 
 void
-vl::TimeTrigger::update(vl::time const &elapsed_time)
+vl::TimeTrigger::_timeout(void)
 {
-	if(!_expired)
-	{
-		_time += elapsed_time;
-		if(_time >= _interval)
-		{
-			_signal();
-			if(!_continuous)
-			{ _expired = true; }
-			_time = vl::time();
-		}
-	}
+	// Next interval starts from the expiration same as the old accumulator
+	_start = _wheel->getTime();
+	if(_continuous)
+	{ _wheel->schedule(this, _start + to_microseconds(_interval)); }
+	else
+	{ _expired = true; }
+
+	_signal();
 }
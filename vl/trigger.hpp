@@ -17,18 +17,21 @@
  *	Event Handling Trigger class
  *	
  *	2011-07 Updated to use boost::signals
+ *	2014-06 Updated to use vl::Signal
  */
 
 #ifndef HYDRA_TRIGGER_HPP
 #define HYDRA_TRIGGER_HPP
 
-#include <boost/signal.hpp>
+#include "base/signal.hpp"
 
 #include "input/keycode.hpp"
 
 #include "math/transform.hpp"
 
 #include "base/time.hpp"
+#include "base/timer_wheel.hpp"
+#include "base/thread_check.hpp"
 
 #include "input/mouse_event.hpp"
 #include "input/joystick_event.hpp"
@@ -68,7 +71,7 @@ inline std::ostream &operator<<( std::ostream &os, vl::Trigger const &t )
 // for floating point updates
 class BasicActionTrigger : public vl::Trigger
 {
-	typedef boost::signal<void ()> Tripped;
+	typedef vl::Signal<void ()> Tripped;
 public :
 	BasicActionTrigger(void);
 
@@ -85,7 +88,7 @@ protected :
 
 class TransformActionTrigger : public vl::Trigger
 {
-	typedef boost::signal<void (Transform const &)> Tripped;
+	typedef vl::Signal<void (Transform const &)> Tripped;
 
 public :
 	TransformActionTrigger(void);
@@ -104,7 +107,7 @@ protected :
 
 class KeyTrigger : public Trigger
 {
-	typedef boost::signal<void ()> Tripped;
+	typedef vl::Signal<void ()> Tripped;
 
 public :
 	enum KEY_STATE
@@ -177,13 +180,28 @@ class JoystickTrigger : public BasicActionTrigger
 {
 public :
 	
-	typedef boost::signal< void( vl::JoystickEvent const&, int) > Joystick_signal_t;
+	typedef vl::Signal< void( vl::JoystickEvent const&, int) > Joystick_signal_t;
 
 	//typedef boost::signal< void(vl::JoystickInfo const &info, std::vector<vl::scalar> const&, int) > Axis_signal_t;
 	//typedef boost::signal< void(vl::JoystickInfo const &info, std::vector<vl::Vector3> const&, int) > Vector_signal_t;
 	//typedef boost::signal< void(std::vector<vl::Slider const &>, int) > Slider_signal_t;
 	//typedef boost::signal< void(std::vector<vl::POV const &>, int) > POV_signal_t;
 
+	/// Matches any device or index
+	static int const ANY = -1;
+
+	/// @param dev_id device the trigger listens to
+	/// @param index button, axis or pov index the trigger listens to
+	JoystickTrigger(int dev_id = ANY, int index = ANY)
+		: _dev_id(dev_id), _index(index)
+	{}
+
+	int getDevice(void) const
+	{ return _dev_id; }
+
+	int getIndex(void) const
+	{ return _index; }
+
 	virtual std::string getTypeName( void ) const
 	{ return "JoystickTrigger"; }
 
@@ -209,14 +227,17 @@ private:
 	Joystick_signal_t _vector_changed;
 	//Joystick_signal_t _slider_changed;
 	//Joystick_signal_t _pov_changed;
+
+	int _dev_id;
+	int _index;
 };
 
 
 // @warning added due mouse and raycast picking test purposes:
 class MouseTrigger : public Trigger
 {
-typedef boost::signal<void (vl::MouseEvent const &, vl::MouseEvent::BUTTON)> Tripped_button;
-typedef boost::signal<void (vl::MouseEvent const &)> Tripped_moved;
+typedef vl::Signal<void (vl::MouseEvent const &, vl::MouseEvent::BUTTON)> Tripped_button;
+typedef vl::Signal<void (vl::MouseEvent const &)> Tripped_moved;
 public:
 	enum MOUSE_STATE
 	{
@@ -260,7 +281,7 @@ private:
 // the actions this executes
 class FrameTrigger : public Trigger
 {
-	typedef boost::signal<void (vl::time const &)> Tripped;
+	typedef vl::Signal<void (vl::time const &)> Tripped;
 public :
 	FrameTrigger( void )
 	{}
@@ -294,15 +315,18 @@ private :
 
 };
 
-class TimeTrigger : public Trigger
+class TimeTrigger : public Trigger, public TimerWheelEntry
 {
-	typedef boost::signal<void (void)> Tripped;
+	typedef vl::Signal<void (void)> Tripped;
 public :
 	/// Initialises parameters so that the trigger is invalid till user
 	/// changes the parameters
-	TimeTrigger(void)
+	/// @param wheel where the trigger is scheduled, owned by the EventManager
+	TimeTrigger(vl::TimerWheel *wheel)
 		: _continuous(true)
 		, _expired(true)
+		, _wheel(wheel)
+		, _start(0)
 	{}
 
 	~TimeTrigger(void) {}
@@ -321,8 +345,10 @@ public :
 
 	void reset(void)
 	{
+		vl::checkFrameThread("Event triggers");
 		_expired = false;
-		_time = vl::time();
+		_start = _wheel->getTime();
+		_schedule();
 	}
 
 	vl::time const &getInterval(void) const
@@ -330,8 +356,10 @@ public :
 
 	void setInterval(vl::time const &t)
 	{
+		vl::checkFrameThread("Event triggers");
 		_initialise();
 		_interval = t;
+		_schedule();
 	}
 
 	bool isContinous(void) const
@@ -339,13 +367,15 @@ public :
 
 	void setContinous(bool cont)
 	{
+		vl::checkFrameThread("Event triggers");
 		_initialise();
 		_continuous = cont;
+		_schedule();
 	}
 
-	/// @brief progress function
-	/// @param elapsed_time time since last call to this function
-	void update(vl::time const &elapsed_time);
+protected :
+	/// @brief called from the wheel when the interval has passed
+	virtual void _timeout(void);
 
 private :
 	void _initialise(void)
@@ -353,19 +383,31 @@ private :
 		if((_expired && _continuous) || (_expired && _interval == vl::time()))
 		{
 			_expired = false;
+			_start = _wheel->getTime();
 		}
 	}
 
+	void _schedule(void)
+	{
+		if(_expired)
+		{ cancel(); }
+		else
+		{ _wheel->schedule(this, _start + to_microseconds(_interval)); }
+	}
+
 	Tripped _signal;
 
 	bool _continuous;
 
 	vl::time _interval;
 
-	vl::time _time;
-
 	bool _expired;
 
+	vl::TimerWheel *_wheel;
+
+	/// Wheel time when the interval was started
+	uint64_t _start;
+
 };
 
 }	// namespace vl
@@ -0,0 +1,205 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file tube_mesh.cpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+// Interface
+#include "tube_mesh.hpp"
+
+#include "scene_manager.hpp"
+
+#include "cluster/message.hpp"
+
+#include "base/exceptions.hpp"
+
+#include <OGRE/OgreSceneManager.h>
+
+/// ----------------------------- Public -------------------------------------
+vl::TubeMesh::TubeMesh(std::string const &name, vl::SceneManagerPtr creator, bool dynamic)
+	: MovableObject(name, creator, dynamic)
+{ _clear(); }
+
+vl::TubeMesh::TubeMesh(vl::SceneManagerPtr creator)
+	: MovableObject(creator)
+{ _clear(); }
+
+vl::TubeMesh::~TubeMesh(void)
+{
+	if(_ogre_object)
+	{ _creator->getNative()->destroyManualObject(_ogre_object); }
+}
+
+void
+vl::TubeMesh::setMaterial(std::string const &name)
+{
+	update_variable(_material, name, DIRTY_PARAMS);
+}
+
+void
+vl::TubeMesh::setRadius(vl::scalar radius)
+{
+	update_variable(_radius, radius, DIRTY_PARAMS);
+}
+
+void
+vl::TubeMesh::setSides(uint16_t sides)
+{
+	if(sides < 3)
+	{ BOOST_THROW_EXCEPTION(vl::invalid_param() << vl::desc("Tube needs at least three sides.")); }
+
+	update_variable(_sides, sides, DIRTY_PARAMS);
+}
+
+void
+vl::TubeMesh::setFrames(std::vector<vl::Transform> const &frames)
+{
+	// Resting tubes don't need to be sent
+	update_variable(_frames, frames, DIRTY_FRAMES);
+}
+
+/// ----------------------------- Private ------------------------------------
+bool
+vl::TubeMesh::_doCreateNative(void)
+{
+	assert(_creator);
+
+	if(!_ogre_object)
+	{
+		_ogre_object = _creator->getNative()->createManualObject(_name);
+		// Vertex buffer is rewritten every time the tube moves
+		_ogre_object->setDynamic(true);
+		_updateGeometry();
+	}
+
+	return true;
+}
+
+void
+vl::TubeMesh::doSerialize(vl::cluster::ByteStream &msg, const uint64_t dirtyBits) const
+{
+	if(dirtyBits & DIRTY_PARAMS)
+	{
+		msg << _material << _radius << _sides;
+	}
+
+	// Frames are written as a single block, this is sent every frame
+	// when the tube is moving
+	if(dirtyBits & DIRTY_FRAMES)
+	{
+		uint32_t size = _frames.size();
+		msg << size;
+		if(size > 0)
+		{ msg.write((char const *)&_frames[0], (vl::msg_size)(sizeof(vl::Transform)*size)); }
+	}
+}
+
+void
+vl::TubeMesh::doDeserialize(vl::cluster::ByteStream &msg, const uint64_t dirtyBits)
+{
+	bool dirty = false;
+	if(dirtyBits & DIRTY_PARAMS)
+	{
+		msg >> _material >> _radius >> _sides;
+		_params_changed = true;
+		dirty = true;
+	}
+
+	if(dirtyBits & DIRTY_FRAMES)
+	{
+		uint32_t size;
+		msg >> size;
+		_frames.resize(size);
+		if(size > 0)
+		{ msg.read((char *)&_frames[0], (vl::msg_size)(sizeof(vl::Transform)*size)); }
+		dirty = true;
+	}
+
+	if(dirty && _ogre_object)
+	{ _updateGeometry(); }
+}
+
+void
+vl::TubeMesh::_clear(void)
+{
+	_material = "BaseWhite";
+	_radius = 0.1;
+	_sides = 8;
+	_n_vertices = 0;
+	_params_changed = true;
+	_ogre_object = 0;
+}
+
+void
+vl::TubeMesh::_updateGeometry(void)
+{
+	assert(_ogre_object);
+
+	if(_frames.size() < 2)
+	{
+		_ogre_object->clear();
+		_n_vertices = 0;
+		return;
+	}
+
+	size_t n_rings = _frames.size();
+	size_t ring_size = _sides+1;
+	size_t n_vertices = n_rings*ring_size;
+
+	// Indices only depend on the number of vertices so when it stays the
+	// same the old buffers are overwritten instead of creating new ones.
+	if(n_vertices == _n_vertices && !_params_changed)
+	{ _ogre_object->beginUpdate(0); }
+	else
+	{
+		_ogre_object->clear();
+		_ogre_object->estimateVertexCount(n_vertices);
+		_ogre_object->estimateIndexCount((n_rings-1)*_sides*6);
+		_ogre_object->begin(_material, Ogre::RenderOperation::OT_TRIANGLE_LIST);
+	}
+
+	// Texture is wrapped once around the tube and repeated along it
+	// keeping the aspect ratio
+	vl::scalar circumference = 2*Ogre::Math::PI*_radius;
+	vl::scalar v = 0;
+	for(size_t i = 0; i < n_rings; ++i)
+	{
+		vl::Transform const &t = _frames[i];
+		if(i > 0)
+		{ v += t.position.distance(_frames[i-1].position)/circumference; }
+
+		for(uint16_t j = 0; j <= _sides; ++j)
+		{
+			vl::scalar angle = 2*Ogre::Math::PI*j/_sides;
+			Ogre::Vector3 normal = t.quaternion*Ogre::Vector3(std::cos(angle), std::sin(angle), 0);
+			_ogre_object->position(t.position + normal*_radius);
+			_ogre_object->normal(normal);
+			_ogre_object->textureCoord(vl::scalar(j)/_sides, v);
+		}
+	}
+
+	// Counter clockwise from outside
+	for(size_t i = 0; i+1 < n_rings; ++i)
+	{
+		for(uint16_t j = 0; j < _sides; ++j)
+		{
+			uint32_t a = i*ring_size + j;
+			uint32_t b = a + ring_size;
+			_ogre_object->triangle(a, a+1, b);
+			_ogre_object->triangle(a+1, b+1, b);
+		}
+	}
+
+	_ogre_object->end();
+
+	_n_vertices = n_vertices;
+	_params_changed = false;
+}
@@ -0,0 +1,127 @@
+/**
+ *	Copyright (c) 2014 Savant Simulators
+ *
+ *	@author Joonatan Kuosa <joonatan.kuosa@savantsimulators.com>
+ *	@date 2014-06
+ *	@file tube_mesh.hpp
+ *
+ *	This file is part of Hydra VR game engine.
+ *	Version 0.5
+ *
+ *	Licensed under commercial license.
+ *
+ */
+
+/**
+ *	Deforming tube drawn as a single mesh.
+ *
+ *	The tube is a generalized cylinder swept through a list of frames,
+ *	a ring of vertices is placed at every frame with the tube running
+ *	along the frame's z-axis. Only the frames are distributed, slaves
+ *	regenerate the vertex buffer in place when they change, so a tube
+ *	is one draw call and one compact update per frame independent of
+ *	the number of elements.
+ *
+ *	Frames are in the coordinates of the parent SceneNode.
+ */
+
+#ifndef HYDRA_TUBE_MESH_HPP
+#define HYDRA_TUBE_MESH_HPP
+
+/// Base class
+#include "movable_object.hpp"
+
+#include "math/types.hpp"
+#include "math/transform.hpp"
+
+#include <vector>
+
+// Ogre object
+#include <OGRE/OgreManualObject.h>
+
+namespace vl
+{
+
+class HYDRA_API TubeMesh : public vl::MovableObject
+{
+public :
+	/// @brief Master constructor
+	/// Should not be called from user code, use SceneManager to create these
+	TubeMesh(std::string const &name, vl::SceneManagerPtr creator, bool dynamic);
+
+	/// @brief Slave constructor
+	TubeMesh(vl::SceneManagerPtr creator);
+
+	virtual ~TubeMesh(void);
+
+	void setMaterial(std::string const &name);
+
+	std::string const &getMaterial(void) const
+	{ return _material; }
+
+	void setRadius(vl::scalar radius);
+
+	vl::scalar getRadius(void) const
+	{ return _radius; }
+
+	/// @brief number of vertices around the tube
+	void setSides(uint16_t sides);
+
+	uint16_t getSides(void) const
+	{ return _sides; }
+
+	/// @brief set the frames the tube is swept through
+	/// Only distributed if they changed, at least two are needed to draw anything.
+	void setFrames(std::vector<vl::Transform> const &frames);
+
+	std::vector<vl::Transform> const &getFrames(void) const
+	{ return _frames; }
+
+	/// Virtual overrides
+	virtual Ogre::MovableObject *getNative(void) const
+	{ return _ogre_object; }
+
+	virtual std::string getTypeName(void) const
+	{ return "TubeMesh"; }
+
+	/// @todo not implemented
+	virtual MovableObjectPtr clone(std::string const &append_to_name) const
+	{ return 0; }
+
+	enum DirtyBits
+	{
+		DIRTY_PARAMS = vl::MovableObject::DIRTY_CUSTOM << 0,
+		DIRTY_FRAMES = vl::MovableObject::DIRTY_CUSTOM << 1,
+		DIRTY_CUSTOM = vl::MovableObject::DIRTY_CUSTOM << 2,
+	};
+
+private :
+	virtual bool _doCreateNative(void);
+
+	virtual void doSerialize(vl::cluster::ByteStream &msg, const uint64_t dirtyBits) const;
+
+	virtual void doDeserialize(vl::cluster::ByteStream &msg, const uint64_t dirtyBits);
+
+	void _clear(void);
+
+	/// @brief write the vertices and indices for the current frames
+	/// Reuses the hardware buffers if the number of vertices has not changed.
+	void _updateGeometry(void);
+
+	std::string _material;
+	vl::scalar _radius;
+	uint16_t _sides;
+
+	std::vector<vl::Transform> _frames;
+
+	/// Size of the geometry in the hardware buffers, 0 if not created
+	size_t _n_vertices;
+	bool _params_changed;
+
+	Ogre::ManualObject *_ogre_object;
+
+};	// class TubeMesh
+
+}	// namespace vl
+
+#endif	// HYDRA_TUBE_MESH_HPP
@@ -81,6 +81,8 @@ namespace vl
 	class EventManager;
 	class ResourceManager;
 	class PythonContext;
+	class PythonProfiler;
+	class PythonTaskQueue;
 
 	typedef Player * PlayerPtr;
 	// Can not be scoped ptr as config owns it but PythonContext needs access to it
@@ -112,6 +114,8 @@ namespace vl
 	class Camera;
 	class MovableText;
 	class RayObject;
+	class TubeMesh;
+	class InstanceGroup;
 
 	typedef ObjectInterface *ObjectInterfacePtr;
 	typedef SceneManager * SceneManagerPtr;
@@ -122,6 +126,8 @@ namespace vl
 	typedef Camera * CameraPtr;
 	typedef MovableText * MovableTextPtr;
 	typedef RayObject * RayObjectPtr;
+	typedef TubeMesh * TubeMeshPtr;
+	typedef InstanceGroup * InstanceGroupPtr;
 
 	/// Resources
 	class VertexBuffer;
@@ -149,6 +155,7 @@ namespace vl
 	typedef std::vector<EntityPtr> EntityList;
 	typedef std::vector<MovableObjectPtr> MovableObjectList;
 	typedef std::vector<CameraPtr> CameraList;
+	typedef std::vector<InstanceGroupPtr> InstanceGroupList;
 	
 	struct null_deleter
 	{
@@ -195,6 +202,13 @@ namespace vl
 	typedef boost::shared_ptr<PCAN> PCANRefPtr;
 	typedef boost::shared_ptr<MouseHandler> MouseHandlerRefPtr;
 
+	/// Input recording
+	class RecordingWriter;
+	class RecordingReader;
+	class RecordingPlayer;
+	typedef boost::shared_ptr<RecordingWriter> RecordingWriterRefPtr;
+	typedef boost::shared_ptr<RecordingPlayer> RecordingPlayerRefPtr;
+
 namespace gui
 {
 	class GUI;